@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -67,6 +68,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -129,6 +137,78 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_cancel_date = false;
+    bool has_confirmation = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "cancel_date" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->cancel_date) )
+                                has_cancel_date = true;
+                        }
+                        else if ( response_key == "confirmation" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->confirmation) )
+                                has_confirmation = true;
+                        }
+                        else if ( response_key == "last_invoice" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->last_invoice = std::move(optarg);
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_cancel_date )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.cancel_date\"");
+    }
+
+    if ( ! has_confirmation )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.confirmation\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -173,6 +253,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
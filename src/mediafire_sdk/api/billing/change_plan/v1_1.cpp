@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -63,6 +64,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -162,6 +170,117 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_info_only = false;
+    bool has_new_pid = false;
+    bool has_amount = false;
+    bool has_interval = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "nextbilling" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->next_billing = std::move(optarg);
+                        }
+                        else if ( response_key == "info_only" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->info_only = InfoOnly::No;
+                                else if ( optval == "yes" )
+                                    response->info_only = InfoOnly::Yes;
+                                else
+                                    set_error(
+                                        mf::api::api_code::ContentInvalidData,
+                                        "invalid value in response.info_only");
+                                has_info_only = true;
+                            }
+                        }
+                        else if ( response_key == "newpid" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->new_pid) )
+                                has_new_pid = true;
+                        }
+                        else if ( response_key == "amount" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->amount) )
+                                has_amount = true;
+                        }
+                        else if ( response_key == "interval" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->interval) )
+                                has_interval = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_info_only )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.info_only");
+    }
+
+    if ( ! has_new_pid )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.newpid\"");
+    }
+
+    if ( ! has_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.amount\"");
+    }
+
+    if ( ! has_interval )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.interval\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -193,6 +312,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
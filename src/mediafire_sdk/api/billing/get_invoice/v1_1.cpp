@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -258,6 +259,276 @@ bool ProductFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool ProductFromJsonReader(
+        Response * response,
+        Response::Product * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->is_recurring = Recurring::NonRecurring;
+    value->recurring_units = 0;
+    value->free_months = 0;
+    value->trial = Trial::NonTrial;
+    value->active = Activity::Inactive;
+    value->frequency_text = "";
+    value->uses_credits = UsesCredits::No;
+    value->reseller_entitlement = ResellerEntitled::No;
+    value->interval = 0;
+    value->legacy = Legacy::No;
+    value->base_storage = 0;
+    bool has_product_id = false;
+    bool has_description = false;
+    bool has_short_description = false;
+    bool has_initial_amount = false;
+    bool has_initial_units = false;
+    bool has_recurring_amount = false;
+    bool has_payment_methods = false;
+    bool has_product_class = false;
+    bool has_product_family = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "product_id" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->product_id) )
+                    has_product_id = true;
+            }
+            else if ( key == "description" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->description) )
+                    has_description = true;
+            }
+            else if ( key == "short_description" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->short_description) )
+                    has_short_description = true;
+            }
+            else if ( key == "initial_amount" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->initial_amount) )
+                    has_initial_amount = true;
+            }
+            else if ( key == "initial_units" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->initial_units) )
+                    has_initial_units = true;
+            }
+            else if ( key == "is_recurring" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->is_recurring = Recurring::NonRecurring;
+                    else if ( optval == "1" )
+                        value->is_recurring = Recurring::Recurring;
+                }
+            }
+            else if ( key == "recurring_amount" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->recurring_amount) )
+                    has_recurring_amount = true;
+            }
+            else if ( key == "recurring_units" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->recurring_units);
+            }
+            else if ( key == "free_months" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->free_months);
+            }
+            else if ( key == "trial" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->trial = Trial::NonTrial;
+                    else if ( optval == "1" )
+                        value->trial = Trial::Trial;
+                }
+            }
+            else if ( key == "active" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->active = Activity::Inactive;
+                    else if ( optval == "1" )
+                        value->active = Activity::Active;
+                }
+            }
+            else if ( key == "frequency_text" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->frequency_text);
+            }
+            else if ( key == "uses_credits" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->uses_credits = UsesCredits::No;
+                    else if ( optval == "1" )
+                        value->uses_credits = UsesCredits::Yes;
+                }
+            }
+            else if ( key == "reseller_entitlement" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->reseller_entitlement = ResellerEntitled::No;
+                    else if ( optval == "1" )
+                        value->reseller_entitlement = ResellerEntitled::Yes;
+                }
+            }
+            else if ( key == "payment_methods" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->payment_methods) )
+                    has_payment_methods = true;
+            }
+            else if ( key == "interval" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->interval);
+            }
+            else if ( key == "legacy" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->legacy = Legacy::No;
+                    else if ( optval == "1" )
+                        value->legacy = Legacy::Yes;
+                }
+            }
+            else if ( key == "product_class" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->product_class) )
+                    has_product_class = true;
+            }
+            else if ( key == "product_family" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->product_family) )
+                    has_product_family = true;
+            }
+            else if ( key == "base_storage" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->base_storage);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_product_id )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"product_id\"");
+    }
+
+    if ( ! has_description )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"description\"");
+    }
+
+    if ( ! has_short_description )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"short_description\"");
+    }
+
+    if ( ! has_initial_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"initial_amount\"");
+    }
+
+    if ( ! has_initial_units )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"initial_units\"");
+    }
+
+    if ( ! has_recurring_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"recurring_amount\"");
+    }
+
+    if ( ! has_payment_methods )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"payment_methods\"");
+    }
+
+    if ( ! has_product_class )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"product_class\"");
+    }
+
+    if ( ! has_product_family )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"product_family\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -283,6 +554,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -533,6 +811,329 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->recurring_startdate = boost::posix_time::not_a_date_time;
+    response->recurring_enddate = boost::posix_time::not_a_date_time;
+    response->next_bandwidth = boost::posix_time::not_a_date_time;
+    bool has_invoice_id = false;
+    bool has_invoice_num = false;
+    bool has_payment_method = false;
+    bool has_recurring_status = false;
+    bool has_recurring_profile_id = false;
+    bool has_created_datetime = false;
+    bool has_product_id = false;
+    bool has_product_description = false;
+    bool has_country = false;
+    bool has_initial_amount = false;
+    bool has_initial_tax = false;
+    bool has_initial_total = false;
+    bool has_recurring_amount = false;
+    bool has_recurring_tax = false;
+    bool has_recurring_total = false;
+    bool has_promo_code = false;
+    bool has_product = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "invoice" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_invoice_key;
+                                while ( reader->NextMember(&response_invoice_key) )
+                                {
+                                    if ( response_invoice_key == "invoice_id" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->invoice_id) )
+                                            has_invoice_id = true;
+                                    }
+                                    else if ( response_invoice_key == "invoice_num" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->invoice_num) )
+                                            has_invoice_num = true;
+                                    }
+                                    else if ( response_invoice_key == "payment_method" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->payment_method) )
+                                            has_payment_method = true;
+                                    }
+                                    else if ( response_invoice_key == "recurring_status" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->recurring_status) )
+                                            has_recurring_status = true;
+                                    }
+                                    else if ( response_invoice_key == "recurring_profile_id" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->recurring_profile_id) )
+                                            has_recurring_profile_id = true;
+                                    }
+                                    else if ( response_invoice_key == "date_created" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->created_datetime) )
+                                            has_created_datetime = true;
+                                    }
+                                    else if ( response_invoice_key == "company_id" )
+                                    {
+                                        // create_content_read_single
+                                        uint32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->company_id = std::move(optarg);
+                                    }
+                                    else if ( response_invoice_key == "product_id" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->product_id) )
+                                            has_product_id = true;
+                                    }
+                                    else if ( response_invoice_key == "product_description" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->product_description) )
+                                            has_product_description = true;
+                                    }
+                                    else if ( response_invoice_key == "country" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->country) )
+                                            has_country = true;
+                                    }
+                                    else if ( response_invoice_key == "initial_amount" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->initial_amount) )
+                                            has_initial_amount = true;
+                                    }
+                                    else if ( response_invoice_key == "initial_tax" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->initial_tax) )
+                                            has_initial_tax = true;
+                                    }
+                                    else if ( response_invoice_key == "initial_total" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->initial_total) )
+                                            has_initial_total = true;
+                                    }
+                                    else if ( response_invoice_key == "recurring_amount" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->recurring_amount) )
+                                            has_recurring_amount = true;
+                                    }
+                                    else if ( response_invoice_key == "recurring_tax" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->recurring_tax) )
+                                            has_recurring_tax = true;
+                                    }
+                                    else if ( response_invoice_key == "recurring_total" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->recurring_total) )
+                                            has_recurring_total = true;
+                                    }
+                                    else if ( response_invoice_key == "recurring_startdate" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->recurring_startdate);
+                                    }
+                                    else if ( response_invoice_key == "recurring_enddate" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->recurring_enddate);
+                                    }
+                                    else if ( response_invoice_key == "next_bandwidth" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->next_bandwidth);
+                                    }
+                                    else if ( response_invoice_key == "previous_invoice" )
+                                    {
+                                        // create_content_read_single
+                                        uint32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->previous_invoice_id = std::move(optarg);
+                                    }
+                                    else if ( response_invoice_key == "promo_code" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->promo_code) )
+                                            has_promo_code = true;
+                                    }
+                                    else if ( response_invoice_key == "product" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::Product optarg;
+                                        if ( ProductFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->product = std::move(optarg);
+                                            has_product = true;
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_invoice_id )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.invoice_id\"");
+    }
+
+    if ( ! has_invoice_num )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.invoice_num\"");
+    }
+
+    if ( ! has_payment_method )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.payment_method\"");
+    }
+
+    if ( ! has_recurring_status )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.recurring_status\"");
+    }
+
+    if ( ! has_recurring_profile_id )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.recurring_profile_id\"");
+    }
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.date_created\"");
+    }
+
+    if ( ! has_product_id )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.product_id\"");
+    }
+
+    if ( ! has_product_description )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.product_description\"");
+    }
+
+    if ( ! has_country )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.country\"");
+    }
+
+    if ( ! has_initial_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.initial_amount\"");
+    }
+
+    if ( ! has_initial_tax )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.initial_tax\"");
+    }
+
+    if ( ! has_initial_total )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.initial_total\"");
+    }
+
+    if ( ! has_recurring_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.recurring_amount\"");
+    }
+
+    if ( ! has_recurring_tax )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.recurring_tax\"");
+    }
+
+    if ( ! has_recurring_total )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.recurring_total\"");
+    }
+
+    if ( ! has_promo_code )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.promo_code\"");
+    }
+
+    if ( ! has_product )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice.product\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -555,6 +1156,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -258,6 +258,15 @@ public:
     /** Requester/SessionMaintainer expected type. */
     void SetCallback( CallbackType callback_function );
 
+    /** Requester/SessionMaintainer optional method. */
+    void SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level );
+
+    /** Requester/SessionMaintainer optional method. */
+    void SetResponseParser( ResponseParser response_parser );
+
+    /** Requester optional method. */
+    void SetRequestTimings( const mf::http::RequestTimings & timings );
+
     /** Requester expected method. */
     void HandleContent(
             const std::string & url,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/tokenless_api_base.hpp"
@@ -151,6 +152,169 @@ bool PlanFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool PlanFromJsonReader(
+        Response * response,
+        Response::Plan * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->is_recurring = Recurring::NonRecurring;
+    value->recurring_units = 0;
+    value->frequency_text = "";
+    value->product_class = 0;
+    value->free_months = 0;
+    value->base_storage = 0;
+    bool has_product_id = false;
+    bool has_description = false;
+    bool has_short_description = false;
+    bool has_initial_amount = false;
+    bool has_initial_units = false;
+    bool has_recurring_amount = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "product_id" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->product_id) )
+                    has_product_id = true;
+            }
+            else if ( key == "description" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->description) )
+                    has_description = true;
+            }
+            else if ( key == "short_description" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->short_description) )
+                    has_short_description = true;
+            }
+            else if ( key == "initial_amount" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->initial_amount) )
+                    has_initial_amount = true;
+            }
+            else if ( key == "initial_units" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->initial_units) )
+                    has_initial_units = true;
+            }
+            else if ( key == "is_recurring" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->is_recurring = Recurring::NonRecurring;
+                    else if ( optval == "1" )
+                        value->is_recurring = Recurring::Recurring;
+                }
+            }
+            else if ( key == "recurring_amount" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->recurring_amount) )
+                    has_recurring_amount = true;
+            }
+            else if ( key == "recurring_units" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->recurring_units);
+            }
+            else if ( key == "frequency_text" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->frequency_text);
+            }
+            else if ( key == "product_class" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->product_class);
+            }
+            else if ( key == "free_months" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->free_months);
+            }
+            else if ( key == "base_storage" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->base_storage);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_product_id )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"product_id\"");
+    }
+
+    if ( ! has_description )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"description\"");
+    }
+
+    if ( ! has_short_description )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"short_description\"");
+    }
+
+    if ( ! has_initial_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"initial_amount\"");
+    }
+
+    if ( ! has_initial_units )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"initial_units\"");
+    }
+
+    if ( ! has_recurring_amount )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"recurring_amount\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -178,6 +342,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -235,6 +414,98 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_plans = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "products" )
+                        {
+                            // create_content_struct_read TArray
+                            has_plans = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    Response::Plan optarg;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( PlanFromJsonReader(response, &optarg, reader) )
+                                        response->plans.push_back(std::move(optarg));
+                                    else
+                                        skip_rest = true;  // error set already
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_plans )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.products\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.products",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.products
+        {
+            Response::Plan optarg;
+            if ( PlanFromJsonReader(response, &optarg, reader) )
+                response->plans.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -261,6 +532,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -294,6 +580,20 @@ void Request::SetFamily(uint32_t family)
     impl_->family_ = family;
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -83,6 +84,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -165,6 +173,111 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->created_datetime = boost::posix_time::not_a_date_time;
+    response->previous_invoice_datetime = boost::posix_time::not_a_date_time;
+    bool has_invoice = false;
+    bool has_total = false;
+    bool has_product_id = false;
+    bool has_premium = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "invoice" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->invoice) )
+                                has_invoice = true;
+                        }
+                        else if ( response_key == "total" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->total) )
+                                has_total = true;
+                        }
+                        else if ( response_key == "product" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->product_id) )
+                                has_product_id = true;
+                        }
+                        else if ( response_key == "premium" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->premium) )
+                                has_premium = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&response->created_datetime);
+            }
+            else if ( key == "lastpremium" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&response->previous_invoice_datetime);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_invoice )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.invoice\"");
+    }
+
+    if ( ! has_total )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.total\"");
+    }
+
+    if ( ! has_product_id )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.product\"");
+    }
+
+    if ( ! has_premium )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.premium\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -225,6 +338,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
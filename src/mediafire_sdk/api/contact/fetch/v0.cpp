@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -55,6 +56,56 @@ bool ContactFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool ContactFromJsonReader(
+        Response * response,
+        Response::Contact * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_contact_key = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "contact_key" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->contact_key) )
+                    has_contact_key = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_contact_key )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"contact_key\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -80,6 +131,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -131,6 +197,83 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "contacts" )
+                        {
+                            // create_content_struct_read TArray
+                            if ( reader->BeginArray() )
+                            {
+                                while ( reader->NextElement() )
+                                {
+                                    Response::Contact optarg;
+                                    if ( ContactFromJsonReader(response, &optarg, reader) )
+                                        response->contacts.push_back(std::move(optarg));
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.contacts",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.contacts
+        {
+            Response::Contact optarg;
+            if ( ContactFromJsonReader(response, &optarg, reader) )
+                response->contacts.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -153,6 +296,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -185,6 +343,20 @@ void Request::SetSessionToken(
     impl_->SetSessionToken(session_token, time, secret_key);
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
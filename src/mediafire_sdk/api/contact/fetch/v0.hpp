@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "mediafire_sdk/http/shared_buffer.hpp"
+#include "mediafire_sdk/api/detail/incremental_content_interface.hpp"
 #include "mediafire_sdk/http/headers.hpp"
 #include "mediafire_sdk/api/response_base.hpp"
 
@@ -56,6 +57,19 @@ public:
      */
     Request();
 
+    /**
+     * Deliver the elements of "response.contacts" in batches while the response
+     * is still arriving.  They are then left out of the response passed to the
+     * callback, which comes after the last batch.
+     *
+     * @param batch_callback Called with each batch.
+     * @param batch_size Most elements in one batch.
+     */
+    void SetBatchCallback(
+            std::function< void( const Response & batch)> batch_callback,
+            std::size_t batch_size
+        );
+
     // Remaining functions are for use by API library only. --------------------
 
     /** Requester/SessionMaintainer expected type. */
@@ -67,6 +81,15 @@ public:
     /** Requester/SessionMaintainer expected type. */
     void SetCallback( CallbackType callback_function );
 
+    /** Requester/SessionMaintainer optional method. */
+    void SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level );
+
+    /** Requester/SessionMaintainer optional method. */
+    void SetResponseParser( ResponseParser response_parser );
+
+    /** Requester optional method. */
+    void SetRequestTimings( const mf::http::RequestTimings & timings );
+
     /** Requester expected method. */
     void HandleContent(
             const std::string & url,
@@ -84,6 +107,10 @@ public:
     /** Requester expected method. */
     std::string Url(const std::string & hostname) const;
 
+    /** Requester optional method. */
+    std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+        BeginIncrementalContent();
+
     /** Requester optional method. */
     mf::http::SharedBuffer::Pointer GetPostData();
 
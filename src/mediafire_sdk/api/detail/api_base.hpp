@@ -9,10 +9,17 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "mediafire_sdk/api/detail/incremental_content_interface.hpp"
+#include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_array_splitter.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/response_base.hpp"
 #include "mediafire_sdk/api/types.hpp"
 #include "mediafire_sdk/http/headers.hpp"
@@ -46,12 +53,81 @@ public:
                 const ResponseType & data
             )> CallbackType;
 
+    ApiBase() :
+        diagnostics_level_(DiagnosticsLevel::Full),
+        response_parser_(ResponseParser::Streaming),
+        batch_size_(0)
+    {}
+
     /** Requester/SessionMaintainer expected typedef. */
     virtual void SetCallback( CallbackType callback_function )
     {
         callback_ = callback_function;
     };
 
+    /** Requester/SessionMaintainer optional method. */
+    virtual void SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+    {
+        diagnostics_level_ = diagnostics_level;
+    }
+
+    /** Requester/SessionMaintainer optional method. */
+    virtual void SetResponseParser( ResponseParser response_parser )
+    {
+        response_parser_ = response_parser;
+    }
+
+    /** Requester optional method. */
+    virtual void SetRequestTimings( const mf::http::RequestTimings & timings )
+    {
+        request_timings_ = timings;
+    }
+
+    /**
+     * @brief Deliver the elements of the response arrays in batches while the
+     * content is still arriving.
+     *
+     * Only APIs listing BatchedArrayPaths support this, and only with
+     * ResponseParser::Streaming.  The batches hold nothing but elements of
+     * those arrays, which are left empty in the response passed to the
+     * callback once all the batches were delivered.
+     *
+     * @param[in] batch_callback Called with each batch.
+     * @param[in] batch_size Most elements in one batch.
+     */
+    virtual void SetBatchCallback(
+            CallbackType batch_callback,
+            std::size_t batch_size
+        )
+    {
+        batch_callback_ = batch_callback;
+        batch_size_ = std::max<std::size_t>(1, batch_size);
+    }
+
+    /**
+     * Requester optional method.
+     *
+     * @return Reader of the content as it arrives, or nullptr if the content
+     *         is to be passed whole to HandleContent.
+     */
+    virtual std::shared_ptr<IncrementalContentInterface>
+        BeginIncrementalContent()
+    {
+        batch_error_code_ = std::error_code();
+        batch_error_string_ = boost::none;
+
+        if ( ! batch_callback_
+            || response_parser_ != ResponseParser::Streaming
+            || ! HasResponseReader() )
+            return nullptr;
+
+        std::vector<std::string> array_paths = BatchedArrayPaths();
+        if ( array_paths.empty() )
+            return nullptr;
+
+        return std::make_shared<BatchReader>(this, std::move(array_paths));
+    }
+
     /** Requester expected method. */
     virtual void HandleContent(
             const std::string & url,
@@ -61,7 +137,32 @@ public:
         assert( callback_ );
 
         ResponseType response;
-        response.InitializeWithContent(url, debug_text_, headers, content);
+        response.timings = request_timings_;
+
+        if ( response_parser_ == ResponseParser::Streaming
+            && HasResponseReader() )
+        {
+            response.InitializeWithReader(url, debug_text_, headers, content,
+                [this, &response](JsonReader * reader)
+                {
+                    ReadResponse(&response, reader);
+                }, diagnostics_level_);
+
+            // Errors in batched elements were only seen by the batches.
+            if ( ! response.error_code && batch_error_code_ )
+            {
+                response.error_code = batch_error_code_;
+                response.error_string = batch_error_string_;
+            }
+            batch_error_code_ = std::error_code();
+            batch_error_string_ = boost::none;
+
+            callback_(response);
+            return;
+        }
+
+        response.InitializeWithContent(url, debug_text_, headers, content,
+            diagnostics_level_);
 
 #       ifdef OUTPUT_DEBUG // Debug code
         std::cout << "Got content:\n" << content << std::endl;
@@ -76,8 +177,12 @@ public:
             ParseResponse(&response);
 
             // Record error if one ocurred during parsing
-            if ( response.error_code )
+            if ( response.error_code
+                && diagnostics_level_ != DiagnosticsLevel::Off )
             {
+                if ( diagnostics_level_ == DiagnosticsLevel::ErrorsOnly )
+                    response.CaptureDebugText(debug_text_, content);
+
                 response.debug += "Error: " + response.error_code.message()
                     + "\n";
                 if (response.error_string)
@@ -104,7 +209,9 @@ public:
 #       endif
 
         ResponseType response;
-        response.InitializeWithError(url, debug_text_, ec, error_string);
+        response.timings = request_timings_;
+        response.InitializeWithError(url, debug_text_, ec, error_string,
+            diagnostics_level_);
 
         if ( callback_ )
             callback_(response);
@@ -132,6 +239,58 @@ protected:
      */
     virtual void ParseResponse(ResponseType * response) = 0;
 
+    /**
+     * @brief True if ReadResponse is implemented.
+     *
+     * Responses are then read with ResponseParser::Streaming unless the
+     * property tree was asked for.
+     */
+    virtual bool HasResponseReader() const { return false; }
+
+    /**
+     * @brief Fill the response straight from the JSON.
+     *
+     * The counterpart of ParseResponse.  Must read the whole document, passing
+     * the members of "response" it does not know to
+     * ResponseType::ReadEnvelopeMember.
+     *
+     * @param[in,out] response Pointer to ResponseType to fill.
+     * @param[in] reader Positioned at the start of the document.
+     */
+    virtual void ReadResponse(
+            ResponseType * /* response */,
+            JsonReader * reader
+        )
+    {
+        reader->Skip();
+    }
+
+    /**
+     * @brief Paths of the arrays whose elements can be batched.
+     *
+     * @return Paths such as "response.folder_content.files".
+     */
+    virtual std::vector<std::string> BatchedArrayPaths() const
+    {
+        return std::vector<std::string>();
+    }
+
+    /**
+     * @brief Read one element of a batched array into a batch.
+     *
+     * @param[in] path_index Index in BatchedArrayPaths of the array.
+     * @param[in,out] response The batch.
+     * @param[in] reader Positioned at the start of the element.
+     */
+    virtual void ReadBatchedElement(
+            std::size_t /* path_index */,
+            ResponseType * /* response */,
+            JsonReader * reader
+        )
+    {
+        reader->Skip();
+    }
+
     /**
      * @brief Convenience function for creating a session token based URL.
      *
@@ -171,7 +330,106 @@ protected:
     }
 
 private:
+    /** Splits the batched arrays out of the content as it arrives. */
+    class BatchReader : public IncrementalContentInterface
+    {
+    public:
+        BatchReader(
+                ApiBase * api,
+                std::vector<std::string> array_paths
+            ) :
+            api_(api),
+            splitter_(std::move(array_paths),
+                [this](std::size_t path_index, const std::string & element)
+                {
+                    ReadElement(path_index, element);
+                }),
+            batch_(std::make_shared<ResponseType>()),
+            batch_elements_(0),
+            deliveries_(nullptr)
+        {}
+
+        virtual void Read(
+                const char * data,
+                std::size_t size,
+                Deliveries * deliveries
+            ) override
+        {
+            deliveries_ = deliveries;
+            splitter_.Append(data, size);
+            deliveries_ = nullptr;
+        }
+
+        virtual std::string Finish(
+                Deliveries * deliveries
+            ) override
+        {
+            Deliver(deliveries);
+            return splitter_.TakeRemainder();
+        }
+
+    private:
+        void ReadElement(
+                std::size_t path_index,
+                const std::string & element
+            )
+        {
+            JsonReader reader(element);
+            api_->ReadBatchedElement(path_index, batch_.get(), &reader);
+
+            if ( ! reader.Finish() && ! batch_->error_code )
+            {
+                batch_->error_code = make_error_code(
+                    api::api_code::ContentInvalidFormat );
+                batch_->error_string = reader.ErrorString();
+            }
+
+            if ( batch_->error_code && ! api_->batch_error_code_ )
+            {
+                api_->batch_error_code_ = batch_->error_code;
+                api_->batch_error_string_ = batch_->error_string;
+            }
+
+            if ( ++batch_elements_ >= api_->batch_size_ )
+                Deliver(deliveries_);
+        }
+
+        void Deliver(Deliveries * deliveries)
+        {
+            if ( batch_elements_ == 0 )
+                return;
+
+            std::shared_ptr<ResponseType> batch = std::move(batch_);
+            CallbackType batch_callback = api_->batch_callback_;
+            deliveries->push_back(
+                [batch_callback, batch]()
+                {
+                    batch_callback(*batch);
+                });
+
+            batch_ = std::make_shared<ResponseType>();
+            batch_elements_ = 0;
+        }
+
+        ApiBase * api_;
+        JsonArraySplitter splitter_;
+        std::shared_ptr<ResponseType> batch_;
+        std::size_t batch_elements_;
+        Deliveries * deliveries_;
+    };
+
     std::string debug_text_;
+
+    DiagnosticsLevel diagnostics_level_;
+
+    ResponseParser response_parser_;
+
+    mf::http::RequestTimings request_timings_;
+
+    CallbackType batch_callback_;
+    std::size_t batch_size_;
+    std::error_code batch_error_code_;
+    boost::optional<std::string> batch_error_string_;
 };
 
 }  // namespace detail
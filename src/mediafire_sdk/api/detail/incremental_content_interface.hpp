@@ -0,0 +1,63 @@
+/**
+ * @file incremental_content_interface.hpp
+ * @author Herbert Jones
+ * @brief Interface for reading API content as it arrives.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mf {
+namespace api {
+namespace detail {
+
+/**
+ * @interface IncrementalContentInterface
+ * @brief Reads the content of an API response while it is still arriving.
+ *
+ * Returned by the optional method BeginIncrementalContent of an API request.
+ * Read and Finish are called from the thread receiving the content.  The
+ * deliveries they return must be run in order in the callback thread, and
+ * before the content returned by Finish is passed to HandleContent.
+ */
+class IncrementalContentInterface
+{
+public:
+    /** Calls to make in the callback thread. */
+    typedef std::vector<std::function<void()>> Deliveries;
+
+    virtual ~IncrementalContentInterface() {}
+
+    /**
+     * @brief Read the next piece of the content.
+     *
+     * @param[in] data Start of the piece.
+     * @param[in] size Size of the piece.
+     * @param[out] deliveries Deliveries made ready by the piece are appended.
+     */
+    virtual void Read(
+            const char * data,
+            std::size_t size,
+            Deliveries * deliveries
+        ) = 0;
+
+    /**
+     * @brief End the content.
+     *
+     * @param[out] deliveries The remaining deliveries are appended.
+     *
+     * @return The content still to be passed to HandleContent.
+     */
+    virtual std::string Finish(
+            Deliveries * deliveries
+        ) = 0;
+};
+
+}  // namespace detail
+}  // namespace api
+}  // namespace mf
@@ -11,11 +11,14 @@
 #include <memory>
 #include <string>
 
+#include "mediafire_sdk/api/detail/incremental_content_interface.hpp"
 #include "mediafire_sdk/api/error.hpp"
 #include "mediafire_sdk/api/types.hpp"
+#include "mediafire_sdk/http/content_accumulator.hpp"
 #include "mediafire_sdk/http/headers.hpp"
 #include "mediafire_sdk/http/http_request.hpp"
 #include "mediafire_sdk/http/post_data_pipe_interface.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 
 namespace mf {
@@ -46,6 +49,15 @@ public:                                                                        \
 CREATE_HAS_MEMBER(GetPostData);
 /** HasGetPostDataPipe<T>::value is set if T has method GetPostDataPipe */
 CREATE_HAS_MEMBER(GetPostDataPipe);
+/** HasSetDiagnosticsLevel<T>::value is set if T has method SetDiagnosticsLevel */
+CREATE_HAS_MEMBER(SetDiagnosticsLevel);
+/** HasSetResponseParser<T>::value is set if T has method SetResponseParser */
+CREATE_HAS_MEMBER(SetResponseParser);
+/** HasBeginIncrementalContent<T>::value is set if T has method
+ * BeginIncrementalContent */
+CREATE_HAS_MEMBER(BeginIncrementalContent);
+/** HasSetRequestTimings<T>::value is set if T has method SetRequestTimings */
+CREATE_HAS_MEMBER(SetRequestTimings);
 #undef CREATE_HAS_MEMBER
 
 template<typename ApiFunctor>
@@ -86,6 +98,90 @@ SetupPossiblePostInput(
     // Do nothing.
 }
 
+template<typename ApiFunctor>
+typename std::enable_if<HasSetDiagnosticsLevel<ApiFunctor>::value, void>::type
+SetupPossibleDiagnosticsLevel(
+        ApiFunctor * api_functor,
+        DiagnosticsLevel diagnostics_level
+    )
+{
+    api_functor->SetDiagnosticsLevel(diagnostics_level);
+}
+
+template<typename ApiFunctor>
+typename std::enable_if< ! HasSetDiagnosticsLevel<ApiFunctor>::value,
+    void>::type
+SetupPossibleDiagnosticsLevel(
+        ApiFunctor * /* api_functor */,
+        DiagnosticsLevel /* diagnostics_level */
+    )
+{
+    // Do nothing.
+}
+
+template<typename ApiFunctor>
+typename std::enable_if<HasSetResponseParser<ApiFunctor>::value, void>::type
+SetupPossibleResponseParser(
+        ApiFunctor * api_functor,
+        ResponseParser response_parser
+    )
+{
+    api_functor->SetResponseParser(response_parser);
+}
+
+template<typename ApiFunctor>
+typename std::enable_if< ! HasSetResponseParser<ApiFunctor>::value,
+    void>::type
+SetupPossibleResponseParser(
+        ApiFunctor * /* api_functor */,
+        ResponseParser /* response_parser */
+    )
+{
+    // Do nothing.
+}
+
+template<typename ApiFunctor>
+typename std::enable_if<HasBeginIncrementalContent<ApiFunctor>::value,
+    std::shared_ptr<IncrementalContentInterface>>::type
+SetupPossibleIncrementalContent(
+        ApiFunctor * api_functor
+    )
+{
+    return api_functor->BeginIncrementalContent();
+}
+
+template<typename ApiFunctor>
+typename std::enable_if< ! HasBeginIncrementalContent<ApiFunctor>::value,
+    std::shared_ptr<IncrementalContentInterface>>::type
+SetupPossibleIncrementalContent(
+        ApiFunctor * /* api_functor */
+    )
+{
+    // Content is passed whole to HandleContent.
+    return nullptr;
+}
+
+template<typename ApiFunctor>
+typename std::enable_if<HasSetRequestTimings<ApiFunctor>::value, void>::type
+SetupPossibleRequestTimings(
+        ApiFunctor * api_functor,
+        const mf::http::RequestTimings & timings
+    )
+{
+    api_functor->SetRequestTimings(timings);
+}
+
+template<typename ApiFunctor>
+typename std::enable_if< ! HasSetRequestTimings<ApiFunctor>::value,
+    void>::type
+SetupPossibleRequestTimings(
+        ApiFunctor * /* api_functor */,
+        const mf::http::RequestTimings & /* timings */
+    )
+{
+    // Do nothing.
+}
+
 /**
  * Internal implementation for Requester.
  */
@@ -100,13 +196,17 @@ public:
             ApiFunctor api_functor,
             typename ApiFunctor::CallbackType cb,
             IoService * callback_ios,
-            const std::string & hostname
+            const std::string & hostname,
+            DiagnosticsLevel diagnostics_level = DiagnosticsLevel::Full,
+            ResponseParser response_parser = ResponseParser::Streaming
             ) :
         http_config_(http_config),
         api_functor_(std::move(api_functor)),
         cb_(std::move(cb)),
         callback_ios_(callback_ios),
-        hostname_(hostname)
+        hostname_(hostname),
+        diagnostics_level_(diagnostics_level),
+        response_parser_(response_parser)
     {
         assert(callback_ios_);
     }
@@ -125,6 +225,7 @@ public:
         ) override
     {
         headers_ = headers;
+        content_accumulator_.Start(headers);
     }
 
     virtual void ResponseContentReceived(
@@ -132,8 +233,26 @@ public:
             std::shared_ptr<mf::http::BufferInterface> buffer
         ) override
     {
-        content_.append( reinterpret_cast<const char*>(buffer->Data()),
-            buffer->Size() );
+        if (incremental_content_)
+        {
+            IncrementalContentInterface::Deliveries deliveries;
+            incremental_content_->Read(
+                reinterpret_cast<const char*>(buffer->Data()),
+                buffer->Size(), &deliveries );
+            for (auto & delivery : deliveries)
+                Dispatch( std::move(delivery) );
+        }
+        else
+        {
+            content_accumulator_.Append( std::move(buffer) );
+        }
+    }
+
+    virtual void RequestTimingsReceived(
+            const mf::http::RequestTimings & timings
+        ) override
+    {
+        timings_ = timings;
     }
 
     virtual void RequestResponseErrorEvent(
@@ -144,13 +263,15 @@ public:
         auto self = this->shared_from_this();
         auto action([this, self, error_code, error_text]()
             {
+                SetupPossibleRequestTimings<ApiFunctor>(&api_functor_,
+                    timings_);
                 self->api_functor_.HandleError(
                         url_,
                         std::move(error_code),
                         error_text
                     );
             });
-        callback_ios_->dispatch( action );
+        Dispatch( action );
 
         // This will delete this as well once self is gone.
         request_.reset();
@@ -169,14 +290,29 @@ public:
         }
         else
         {
+            if (incremental_content_)
+            {
+                // Batches still held go out before the response.
+                IncrementalContentInterface::Deliveries deliveries;
+                content_ = incremental_content_->Finish(&deliveries);
+                for (auto & delivery : deliveries)
+                    Dispatch( std::move(delivery) );
+            }
+            else
+            {
+                content_ = content_accumulator_.Take();
+            }
+
             auto action([this, self]()
                 {
+                    SetupPossibleRequestTimings<ApiFunctor>(&api_functor_,
+                        timings_);
                     self->api_functor_.HandleContent(
                         url_,
                         *headers_,
                         content_ );
                 });
-            callback_ios_->dispatch( action );
+            Dispatch( action );
         }
 
         // This will delete this as well once self is gone.
@@ -189,6 +325,18 @@ public:
     mf::http::HttpRequest::Pointer Init(RequestStarted start)
     {
         api_functor_.SetCallback(cb_);
+        SetupPossibleDiagnosticsLevel<ApiFunctor>(&api_functor_,
+            diagnostics_level_);
+        SetupPossibleResponseParser<ApiFunctor>(&api_functor_,
+            response_parser_);
+
+        incremental_content_ =
+            SetupPossibleIncrementalContent<ApiFunctor>(&api_functor_);
+        if (incremental_content_)
+        {
+            // Batches must reach the callback in order, before the response.
+            strand_.reset(new typename IoService::strand(*callback_ios_));
+        }
 
         // Session token may be included here if session token GET type.
         url_ = api_functor_.Url(hostname_);
@@ -237,6 +385,15 @@ public:
     }
 
 private:
+    template<typename Action>
+    void Dispatch(Action action)
+    {
+        if (strand_)
+            strand_->post( std::move(action) );
+        else
+            callback_ios_->dispatch( std::move(action) );
+    }
+
     mf::http::HttpConfig::ConstPointer http_config_;
 
     mf::http::HttpRequest::Pointer request_;
@@ -245,12 +402,22 @@ private:
     typename ApiFunctor::CallbackType cb_;
 
     IoService * callback_ios_;
+    std::unique_ptr<typename IoService::strand> strand_;
+
+    std::shared_ptr<IncrementalContentInterface> incremental_content_;
+
+    mf::http::ContentAccumulator content_accumulator_;
 
     std::string content_;
     std::string hostname_;
     std::string url_;
 
+    DiagnosticsLevel diagnostics_level_;
+    ResponseParser response_parser_;
+
     boost::optional<mf::http::Headers> headers_;
+
+    mf::http::RequestTimings timings_;
 };
 
 
@@ -355,12 +355,12 @@ api::ConnectionState SessionMaintainerLocker::GetConnectionState()
     return connection_state_;
 }
 
-void SessionMaintainerLocker::SetConnectionState(
+bool SessionMaintainerLocker::SetConnectionState(
         const api::ConnectionState & state
     )
 {
     mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
-    ChangeConnectionStateInternal(state);
+    return ChangeConnectionStateInternal(state);
 }
 
 bool SessionMaintainerLocker::SetSessionStateSafe(
@@ -463,7 +463,7 @@ void SessionMaintainerLocker::ChangeSessionStateInternal(
     }
 }
 
-void SessionMaintainerLocker::ChangeConnectionStateInternal(
+bool SessionMaintainerLocker::ChangeConnectionStateInternal(
         const api::ConnectionState & state
     )
 {
@@ -475,7 +475,9 @@ void SessionMaintainerLocker::ChangeConnectionStateInternal(
             callback_ios_->post( boost::bind(
                     connection_state_change_callback_,
                     connection_state_) );
+        return true;
     }
+    return false;
 }
 
 void SessionMaintainerLocker::HandleTimedOutRequest(STRequestWeak weak_request)
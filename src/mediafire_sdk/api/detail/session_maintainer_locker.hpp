@@ -78,7 +78,8 @@ public:
 
     api::ConnectionState GetConnectionState();
 
-    void SetConnectionState(
+    /** @return True if the connection state changed. */
+    bool SetConnectionState(
             const api::ConnectionState & state
         );
 
@@ -143,7 +144,7 @@ private:
             const mf::utils::unique_lock<mf::utils::mutex>& lock
         );
 
-    void ChangeConnectionStateInternal(
+    bool ChangeConnectionStateInternal(
             const api::ConnectionState & state
         );
 
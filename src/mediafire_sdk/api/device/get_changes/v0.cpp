@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -143,6 +144,160 @@ bool FolderFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool FileFromJsonReader(
+        Response * response,
+        Response::File * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->created_datetime = boost::posix_time::not_a_date_time;
+    bool has_quickkey = false;
+    bool has_revision = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "quickkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->quickkey) )
+                    has_quickkey = true;
+            }
+            else if ( key == "parent_folderkey" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->parent_folderkey = std::move(optarg);
+            }
+            else if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->created_datetime);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_quickkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"quickkey\"");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool FolderFromJsonReader(
+        Response * response,
+        Response::Folder * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->created_datetime = boost::posix_time::not_a_date_time;
+    bool has_folderkey = false;
+    bool has_revision = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "folderkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->folderkey) )
+                    has_folderkey = true;
+            }
+            else if ( key == "parent_folderkey" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->parent_folderkey = std::move(optarg);
+            }
+            else if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->created_datetime);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_folderkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"folderkey\"");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -171,6 +326,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -300,6 +470,199 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_device_revision = false;
+    bool has_changes_list_block = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "device_revision" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->device_revision) )
+                                has_device_revision = true;
+                        }
+                        else if ( response_key == "changes_list_block" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->changes_list_block) )
+                                has_changes_list_block = true;
+                        }
+                        else if ( response_key == "updated" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_updated_key;
+                                while ( reader->NextMember(&response_updated_key) )
+                                {
+                                    if ( response_updated_key == "files" )
+                                    {
+                                        // create_content_struct_read TArray
+                                        if ( reader->BeginArray() )
+                                        {
+                                            while ( reader->NextElement() )
+                                            {
+                                                Response::File optarg;
+                                                if ( FileFromJsonReader(response, &optarg, reader) )
+                                                    response->updated_files.push_back(std::move(optarg));
+                                            }
+                                        }
+                                    }
+                                    else if ( response_updated_key == "folders" )
+                                    {
+                                        // create_content_struct_read TArray
+                                        if ( reader->BeginArray() )
+                                        {
+                                            while ( reader->NextElement() )
+                                            {
+                                                Response::Folder optarg;
+                                                if ( FolderFromJsonReader(response, &optarg, reader) )
+                                                    response->updated_folders.push_back(std::move(optarg));
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else if ( response_key == "deleted" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_deleted_key;
+                                while ( reader->NextMember(&response_deleted_key) )
+                                {
+                                    if ( response_deleted_key == "files" )
+                                    {
+                                        // create_content_struct_read TArray
+                                        if ( reader->BeginArray() )
+                                        {
+                                            while ( reader->NextElement() )
+                                            {
+                                                Response::File optarg;
+                                                if ( FileFromJsonReader(response, &optarg, reader) )
+                                                    response->deleted_files.push_back(std::move(optarg));
+                                            }
+                                        }
+                                    }
+                                    else if ( response_deleted_key == "folders" )
+                                    {
+                                        // create_content_struct_read TArray
+                                        if ( reader->BeginArray() )
+                                        {
+                                            while ( reader->NextElement() )
+                                            {
+                                                Response::Folder optarg;
+                                                if ( FolderFromJsonReader(response, &optarg, reader) )
+                                                    response->deleted_folders.push_back(std::move(optarg));
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_device_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.device_revision\"");
+    }
+
+    if ( ! has_changes_list_block )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.changes_list_block\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.updated.files",
+            "response.deleted.files",
+            "response.updated.folders",
+            "response.deleted.folders",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.updated.files
+        {
+            Response::File optarg;
+            if ( FileFromJsonReader(response, &optarg, reader) )
+                response->updated_files.push_back(std::move(optarg));
+            break;
+        }
+        case 1:  // response.deleted.files
+        {
+            Response::File optarg;
+            if ( FileFromJsonReader(response, &optarg, reader) )
+                response->deleted_files.push_back(std::move(optarg));
+            break;
+        }
+        case 2:  // response.updated.folders
+        {
+            Response::Folder optarg;
+            if ( FolderFromJsonReader(response, &optarg, reader) )
+                response->updated_folders.push_back(std::move(optarg));
+            break;
+        }
+        case 3:  // response.deleted.folders
+        {
+            Response::Folder optarg;
+            if ( FolderFromJsonReader(response, &optarg, reader) )
+                response->deleted_folders.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -325,6 +688,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -357,6 +735,20 @@ void Request::SetSessionToken(
     impl_->SetSessionToken(session_token, time, secret_key);
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -358,6 +359,411 @@ bool FolderFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool FileFromJsonReader(
+        Response * response,
+        Response::File * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->mimetype = "";
+    value->share_link_enabled = ShareLinkEnabled::LinkDisabled;
+    bool has_attributes = false;
+    bool has_created_datetime = false;
+    bool has_shared_datetime = false;
+    bool has_filename = false;
+    bool has_filetype = false;
+    bool has_hash = false;
+    bool has_options = false;
+    bool has_quickkey = false;
+    bool has_revision = false;
+    bool has_sharer = false;
+    bool has_filesize = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "attributes" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->attributes) )
+                    has_attributes = true;
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->created_datetime) )
+                    has_created_datetime = true;
+            }
+            else if ( key == "date_shared" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->shared_datetime) )
+                    has_shared_datetime = true;
+            }
+            else if ( key == "desc" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->description = std::move(optarg);
+            }
+            else if ( key == "filename" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filename) )
+                    has_filename = true;
+            }
+            else if ( key == "filetype" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filetype) )
+                    has_filetype = true;
+            }
+            else if ( key == "md5" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->hash) )
+                    has_hash = true;
+            }
+            else if ( key == "mimetype" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->mimetype);
+            }
+            else if ( key == "options" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->options) )
+                    has_options = true;
+            }
+            else if ( key == "permissions" )
+            {
+                // create_content_read_single
+                uint32_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->permissions = std::move(optarg);
+            }
+            else if ( key == "quickkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->quickkey) )
+                    has_quickkey = true;
+            }
+            else if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "share_link_enabled" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->share_link_enabled = ShareLinkEnabled::LinkDisabled;
+                    else if ( optval == "1" )
+                        value->share_link_enabled = ShareLinkEnabled::LinkEnabled;
+                }
+            }
+            else if ( key == "sharer" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->sharer) )
+                    has_sharer = true;
+            }
+            else if ( key == "size" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filesize) )
+                    has_filesize = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_attributes )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"attributes\"");
+    }
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"created\"");
+    }
+
+    if ( ! has_shared_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"date_shared\"");
+    }
+
+    if ( ! has_filename )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"filename\"");
+    }
+
+    if ( ! has_filetype )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"filetype\"");
+    }
+
+    if ( ! has_hash )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"md5\"");
+    }
+
+    if ( ! has_options )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"options\"");
+    }
+
+    if ( ! has_quickkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"quickkey\"");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    if ( ! has_sharer )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"sharer\"");
+    }
+
+    if ( ! has_filesize )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"size\"");
+    }
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool FolderFromJsonReader(
+        Response * response,
+        Response::Folder * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->share_link_enabled = ShareLinkEnabled::LinkDisabled;
+    bool has_attributes = false;
+    bool has_created_datetime = false;
+    bool has_shared_datetime = false;
+    bool has_folderkey = false;
+    bool has_name = false;
+    bool has_options = false;
+    bool has_revision = false;
+    bool has_sharer = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "attributes" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->attributes) )
+                    has_attributes = true;
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->created_datetime) )
+                    has_created_datetime = true;
+            }
+            else if ( key == "date_shared" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->shared_datetime) )
+                    has_shared_datetime = true;
+            }
+            else if ( key == "desc" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->description = std::move(optarg);
+            }
+            else if ( key == "folderkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->folderkey) )
+                    has_folderkey = true;
+            }
+            else if ( key == "name" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->name) )
+                    has_name = true;
+            }
+            else if ( key == "options" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->options) )
+                    has_options = true;
+            }
+            else if ( key == "permissions" )
+            {
+                // create_content_read_single
+                uint32_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->permissions = std::move(optarg);
+            }
+            else if ( key == "resource_key" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->resource_key = std::move(optarg);
+            }
+            else if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "share_link_enabled" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->share_link_enabled = ShareLinkEnabled::LinkDisabled;
+                    else if ( optval == "1" )
+                        value->share_link_enabled = ShareLinkEnabled::LinkEnabled;
+                }
+            }
+            else if ( key == "sharer" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->sharer) )
+                    has_sharer = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_attributes )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"attributes\"");
+    }
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"created\"");
+    }
+
+    if ( ! has_shared_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"date_shared\"");
+    }
+
+    if ( ! has_folderkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"folderkey\"");
+    }
+
+    if ( ! has_name )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"name\"");
+    }
+
+    if ( ! has_options )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"options\"");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    if ( ! has_sharer )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"sharer\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -392,6 +798,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -472,6 +893,104 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "files" )
+                        {
+                            // create_content_struct_read TArray
+                            if ( reader->BeginArray() )
+                            {
+                                while ( reader->NextElement() )
+                                {
+                                    Response::File optarg;
+                                    if ( FileFromJsonReader(response, &optarg, reader) )
+                                        response->files.push_back(std::move(optarg));
+                                }
+                            }
+                        }
+                        else if ( response_key == "folders" )
+                        {
+                            // create_content_struct_read TArray
+                            if ( reader->BeginArray() )
+                            {
+                                while ( reader->NextElement() )
+                                {
+                                    Response::Folder optarg;
+                                    if ( FolderFromJsonReader(response, &optarg, reader) )
+                                        response->folders.push_back(std::move(optarg));
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.files",
+            "response.folders",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.files
+        {
+            Response::File optarg;
+            if ( FileFromJsonReader(response, &optarg, reader) )
+                response->files.push_back(std::move(optarg));
+            break;
+        }
+        case 1:  // response.folders
+        {
+            Response::Folder optarg;
+            if ( FolderFromJsonReader(response, &optarg, reader) )
+                response->folders.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -511,6 +1030,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -563,6 +1097,20 @@ void Request::SetSyncToDesktopFilter(SyncToDesktopFilter sync_to_desktop_filter)
     impl_->sync_to_desktop_filter_ = sync_to_desktop_filter;
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
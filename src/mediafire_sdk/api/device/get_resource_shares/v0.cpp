@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -119,6 +120,132 @@ bool ShareFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool ShareFromJsonReader(
+        Response * response,
+        Response::Share * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_contact_key = false;
+    bool has_contact_type = false;
+    bool has_contact_indirect = false;
+    bool has_display_name = false;
+    bool has_share_permissions = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "contact_key" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->contact_key) )
+                    has_contact_key = true;
+            }
+            else if ( key == "contact_type" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->contact_type) )
+                    has_contact_type = true;
+            }
+            else if ( key == "contact_indirect" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->contact_indirect) )
+                    has_contact_indirect = true;
+            }
+            else if ( key == "display_name" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->display_name) )
+                    has_display_name = true;
+            }
+            else if ( key == "avatar" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->avatar = std::move(optarg);
+            }
+            else if ( key == "permissions" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "1" )
+                        value->share_permissions = Permissions::Read;
+                    else if ( optval == "2" )
+                        value->share_permissions = Permissions::ReadWrite;
+                    else if ( optval == "4" )
+                        value->share_permissions = Permissions::Manage;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in permissions");
+                    has_share_permissions = true;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_contact_key )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"contact_key\"");
+    }
+
+    if ( ! has_contact_type )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"contact_type\"");
+    }
+
+    if ( ! has_contact_indirect )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"contact_indirect\"");
+    }
+
+    if ( ! has_display_name )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"display_name\"");
+    }
+
+    if ( ! has_share_permissions )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in permissions");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -151,6 +278,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -209,6 +351,83 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "shares" )
+                        {
+                            // create_content_struct_read TArray
+                            if ( reader->BeginArray() )
+                            {
+                                while ( reader->NextElement() )
+                                {
+                                    Response::Share optarg;
+                                    if ( ShareFromJsonReader(response, &optarg, reader) )
+                                        response->shares.push_back(std::move(optarg));
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.shares",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.shares
+        {
+            Response::Share optarg;
+            if ( ShareFromJsonReader(response, &optarg, reader) )
+                response->shares.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -238,6 +457,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -270,6 +504,20 @@ void Request::SetSessionToken(
     impl_->SetSessionToken(session_token, time, secret_key);
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -46,6 +47,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -110,6 +118,82 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_async_jobs_in_progress = false;
+    bool has_device_revision = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "async_jobs_in_progress" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->async_jobs_in_progress = AsyncJobs::Stopped;
+                                else if ( optval == "yes" )
+                                    response->async_jobs_in_progress = AsyncJobs::Running;
+                                else
+                                    set_error(
+                                        mf::api::api_code::ContentInvalidData,
+                                        "invalid value in response.async_jobs_in_progress");
+                                has_async_jobs_in_progress = true;
+                            }
+                        }
+                        else if ( response_key == "device_revision" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->device_revision) )
+                                has_device_revision = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_async_jobs_in_progress )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.async_jobs_in_progress");
+    }
+
+    if ( ! has_device_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.device_revision\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -134,6 +218,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -91,6 +92,112 @@ bool UpdateFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool UpdateFromJsonReader(
+        Response * response,
+        Response::Update * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_source_revision = false;
+    bool has_source_hash = false;
+    bool has_target_revision = false;
+    bool has_target_hash = false;
+    bool has_timestamp = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "source_revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->source_revision) )
+                    has_source_revision = true;
+            }
+            else if ( key == "source_hash" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->source_hash) )
+                    has_source_hash = true;
+            }
+            else if ( key == "target_revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->target_revision) )
+                    has_target_revision = true;
+            }
+            else if ( key == "target_hash" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->target_hash) )
+                    has_target_hash = true;
+            }
+            else if ( key == "timestamp" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->timestamp) )
+                    has_timestamp = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_source_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"source_revision\"");
+    }
+
+    if ( ! has_source_hash )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"source_hash\"");
+    }
+
+    if ( ! has_target_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"target_revision\"");
+    }
+
+    if ( ! has_target_hash )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"target_hash\"");
+    }
+
+    if ( ! has_timestamp )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"timestamp\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -122,6 +229,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -187,6 +309,98 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_current_revision = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "current_revision" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->current_revision) )
+                                has_current_revision = true;
+                        }
+                        else if ( response_key == "updates" )
+                        {
+                            // create_content_struct_read TArray
+                            if ( reader->BeginArray() )
+                            {
+                                while ( reader->NextElement() )
+                                {
+                                    Response::Update optarg;
+                                    if ( UpdateFromJsonReader(response, &optarg, reader) )
+                                        response->updates.push_back(std::move(optarg));
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_current_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.current_revision\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.updates",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.updates
+        {
+            Response::Update optarg;
+            if ( UpdateFromJsonReader(response, &optarg, reader) )
+                response->updates.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -216,6 +430,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -253,6 +482,20 @@ void Request::SetTargetRevision(uint64_t target_revision)
     impl_->target_revision_ = target_revision;
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -201,6 +202,137 @@ bool LinksFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool LinksFromJsonReader(
+        Response * response,
+        Response::Links * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "direct_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->direct_download = std::move(optarg);
+            }
+            else if ( key == "edit" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->edit = std::move(optarg);
+            }
+            else if ( key == "listen" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->listen = std::move(optarg);
+            }
+            else if ( key == "normal_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->normal_download = std::move(optarg);
+            }
+            else if ( key == "one_time" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string one_time_key;
+                    while ( reader->NextMember(&one_time_key) )
+                    {
+                        if ( one_time_key == "download" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                value->one_time_download = std::move(optarg);
+                        }
+                        else if ( one_time_key == "listen" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                value->one_time_listen = std::move(optarg);
+                        }
+                        else if ( one_time_key == "watch" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                value->one_time_watch = std::move(optarg);
+                        }
+                        else if ( one_time_key == "view" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                value->one_time_view = std::move(optarg);
+                        }
+                        else
+                            reader->Skip();
+                    }
+                }
+            }
+            else if ( key == "read" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->read = std::move(optarg);
+            }
+            else if ( key == "streaming" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->streaming = std::move(optarg);
+            }
+            else if ( key == "view" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->view = std::move(optarg);
+            }
+            else if ( key == "watch" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->watch = std::move(optarg);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -231,6 +363,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -442,6 +581,275 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->description = "";
+    response->mimetype = "";
+    bool has_created_datetime = false;
+    bool has_device_revision = false;
+    bool has_downloads = false;
+    bool has_filehash = false;
+    bool has_filename = false;
+    bool has_filesize = false;
+    bool has_filetype = false;
+    bool has_file_revision = false;
+    bool has_flag = false;
+    bool has_links = false;
+    bool has_password_protected = false;
+    bool has_privacy = false;
+    bool has_quickkey = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "fileinfo" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_fileinfo_key;
+                                while ( reader->NextMember(&response_fileinfo_key) )
+                                {
+                                    if ( response_fileinfo_key == "created" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->created_datetime) )
+                                            has_created_datetime = true;
+                                    }
+                                    else if ( response_fileinfo_key == "description" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->description);
+                                    }
+                                    else if ( response_fileinfo_key == "downloads" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->downloads) )
+                                            has_downloads = true;
+                                    }
+                                    else if ( response_fileinfo_key == "hash" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filehash) )
+                                            has_filehash = true;
+                                    }
+                                    else if ( response_fileinfo_key == "filename" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filename) )
+                                            has_filename = true;
+                                    }
+                                    else if ( response_fileinfo_key == "size" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filesize) )
+                                            has_filesize = true;
+                                    }
+                                    else if ( response_fileinfo_key == "filetype" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filetype) )
+                                            has_filetype = true;
+                                    }
+                                    else if ( response_fileinfo_key == "revision" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->file_revision) )
+                                            has_file_revision = true;
+                                    }
+                                    else if ( response_fileinfo_key == "flag" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->flag) )
+                                            has_flag = true;
+                                    }
+                                    else if ( response_fileinfo_key == "links" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::Links optarg;
+                                        if ( LinksFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->links = std::move(optarg);
+                                            has_links = true;
+                                        }
+                                    }
+                                    else if ( response_fileinfo_key == "mimetype" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->mimetype);
+                                    }
+                                    else if ( response_fileinfo_key == "password_protected" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->password_protected = PasswordProtected::Unprotected;
+                                            else if ( optval == "yes" )
+                                                response->password_protected = PasswordProtected::Protected;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.fileinfo.password_protected");
+                                            has_password_protected = true;
+                                        }
+                                    }
+                                    else if ( response_fileinfo_key == "privacy" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "public" )
+                                                response->privacy = Privacy::Public;
+                                            else if ( optval == "private" )
+                                                response->privacy = Privacy::Private;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.fileinfo.privacy");
+                                            has_privacy = true;
+                                        }
+                                    }
+                                    else if ( response_fileinfo_key == "quickkey" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->quickkey) )
+                                            has_quickkey = true;
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else if ( response_key == "device_revision" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->device_revision) )
+                                has_device_revision = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.created\"");
+    }
+
+    if ( ! has_device_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.device_revision\"");
+    }
+
+    if ( ! has_downloads )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.downloads\"");
+    }
+
+    if ( ! has_filehash )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.hash\"");
+    }
+
+    if ( ! has_filename )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.filename\"");
+    }
+
+    if ( ! has_filesize )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.size\"");
+    }
+
+    if ( ! has_filetype )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.filetype\"");
+    }
+
+    if ( ! has_file_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.revision\"");
+    }
+
+    if ( ! has_flag )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.flag\"");
+    }
+
+    if ( ! has_links )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.links\"");
+    }
+
+    if ( ! has_password_protected )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.fileinfo.password_protected");
+    }
+
+    if ( ! has_privacy )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.fileinfo.privacy");
+    }
+
+    if ( ! has_quickkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.fileinfo.quickkey\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -474,6 +882,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -124,6 +125,131 @@ bool PermissionsFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool PermissionsFromJsonReader(
+        Response * response,
+        Response::Permissions * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_value = false;
+    bool has_explicit_share = false;
+    bool has_read_permission = false;
+    bool has_write_permission = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "value" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->value) )
+                    has_value = true;
+            }
+            else if ( key == "explicit" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->explicit_share = ExplicitShare::No;
+                    else if ( optval == "1" )
+                        value->explicit_share = ExplicitShare::Yes;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in explicit");
+                    has_explicit_share = true;
+                }
+            }
+            else if ( key == "read" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "1" )
+                        value->read_permission = Permission::Allowed;
+                    else if ( optval == "0" )
+                        value->read_permission = Permission::Denied;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in read");
+                    has_read_permission = true;
+                }
+            }
+            else if ( key == "write" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "1" )
+                        value->write_permission = Permission::Allowed;
+                    else if ( optval == "0" )
+                        value->write_permission = Permission::Denied;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in write");
+                    has_write_permission = true;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_value )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"value\"");
+    }
+
+    if ( ! has_explicit_share )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in explicit");
+    }
+
+    if ( ! has_read_permission )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in read");
+    }
+
+    if ( ! has_write_permission )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in write");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -152,6 +278,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -385,6 +518,279 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->deleted_datetime = boost::posix_time::not_a_date_time;
+    response->mimetype = "";
+    response->shared_by_user = SharedByUser::Unshared;
+    bool has_quickkey = false;
+    bool has_filename = false;
+    bool has_created_datetime = false;
+    bool has_filesize = false;
+    bool has_privacy = false;
+    bool has_password_protected = false;
+    bool has_hash = false;
+    bool has_filetype = false;
+    bool has_owner_name = false;
+    bool has_revision = false;
+    bool has_flag = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "file_info" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_file_info_key;
+                                while ( reader->NextMember(&response_file_info_key) )
+                                {
+                                    if ( response_file_info_key == "quickkey" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->quickkey) )
+                                            has_quickkey = true;
+                                    }
+                                    else if ( response_file_info_key == "filename" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filename) )
+                                            has_filename = true;
+                                    }
+                                    else if ( response_file_info_key == "created" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->created_datetime) )
+                                            has_created_datetime = true;
+                                    }
+                                    else if ( response_file_info_key == "delete_date" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->deleted_datetime);
+                                    }
+                                    else if ( response_file_info_key == "downloads" )
+                                    {
+                                        // create_content_read_single
+                                        uint32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->download_count = std::move(optarg);
+                                    }
+                                    else if ( response_file_info_key == "size" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filesize) )
+                                            has_filesize = true;
+                                    }
+                                    else if ( response_file_info_key == "privacy" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "public" )
+                                                response->privacy = Privacy::Public;
+                                            else if ( optval == "private" )
+                                                response->privacy = Privacy::Private;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.file_info.privacy");
+                                            has_privacy = true;
+                                        }
+                                    }
+                                    else if ( response_file_info_key == "password_protected" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->password_protected = PasswordProtected::Unprotected;
+                                            else if ( optval == "yes" )
+                                                response->password_protected = PasswordProtected::Protected;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.file_info.password_protected");
+                                            has_password_protected = true;
+                                        }
+                                    }
+                                    else if ( response_file_info_key == "hash" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->hash) )
+                                            has_hash = true;
+                                    }
+                                    else if ( response_file_info_key == "filetype" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->filetype) )
+                                            has_filetype = true;
+                                    }
+                                    else if ( response_file_info_key == "mimetype" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->mimetype);
+                                    }
+                                    else if ( response_file_info_key == "owner_name" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->owner_name) )
+                                            has_owner_name = true;
+                                    }
+                                    else if ( response_file_info_key == "shared_by_user" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "" )
+                                                response->shared_by_user = SharedByUser::Unshared;
+                                            else if ( optval == "1" )
+                                                response->shared_by_user = SharedByUser::Shared;
+                                        }
+                                    }
+                                    else if ( response_file_info_key == "permissions" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::Permissions optarg;
+                                        if ( PermissionsFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->permissions = std::move(optarg);
+                                        }
+                                    }
+                                    else if ( response_file_info_key == "parent_folderkey" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->parent_folderkey = std::move(optarg);
+                                    }
+                                    else if ( response_file_info_key == "revision" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->revision) )
+                                            has_revision = true;
+                                    }
+                                    else if ( response_file_info_key == "flag" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->flag) )
+                                            has_flag = true;
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_quickkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.quickkey\"");
+    }
+
+    if ( ! has_filename )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.filename\"");
+    }
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.created\"");
+    }
+
+    if ( ! has_filesize )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.size\"");
+    }
+
+    if ( ! has_privacy )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.file_info.privacy");
+    }
+
+    if ( ! has_password_protected )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.file_info.password_protected");
+    }
+
+    if ( ! has_hash )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.hash\"");
+    }
+
+    if ( ! has_filetype )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.filetype\"");
+    }
+
+    if ( ! has_owner_name )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.owner_name\"");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.revision\"");
+    }
+
+    if ( ! has_flag )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.file_info.flag\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -410,6 +816,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
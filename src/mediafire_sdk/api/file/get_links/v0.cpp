@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -220,6 +221,140 @@ bool LinksFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool LinksFromJsonReader(
+        Response * response,
+        Response::Links * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_quickkey = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "direct_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->direct_download = std::move(optarg);
+            }
+            else if ( key == "direct_download_error_message" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->direct_download_error_message = std::move(optarg);
+            }
+            else if ( key == "direct_download_error" )
+            {
+                // create_content_read_single
+                int32_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->direct_download_error = std::move(optarg);
+            }
+            else if ( key == "edit" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->edit = std::move(optarg);
+            }
+            else if ( key == "edit_error_message" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->edit_error_message = std::move(optarg);
+            }
+            else if ( key == "listen" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->listen = std::move(optarg);
+            }
+            else if ( key == "normal_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->normal_download = std::move(optarg);
+            }
+            else if ( key == "one_time_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->one_time_download = std::move(optarg);
+            }
+            else if ( key == "one_time_download_error_message" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->one_time_download_error_message = std::move(optarg);
+            }
+            else if ( key == "quickkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->quickkey) )
+                    has_quickkey = true;
+            }
+            else if ( key == "view" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->view = std::move(optarg);
+            }
+            else if ( key == "watch" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->watch = std::move(optarg);
+            }
+            else if ( key == "error" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->error = std::move(optarg);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_quickkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"quickkey\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -249,6 +384,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -323,6 +473,110 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->one_time_download_request_count = 0;
+    response->direct_download_free_bandwidth = 0;
+    bool has_links = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "links" )
+                        {
+                            // create_content_struct_read TArray
+                            has_links = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    Response::Links optarg;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( LinksFromJsonReader(response, &optarg, reader) )
+                                        response->links.push_back(std::move(optarg));
+                                    else
+                                        skip_rest = true;  // error set already
+                                }
+                            }
+                        }
+                        else if ( response_key == "one_time_download_request_count" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->one_time_download_request_count);
+                        }
+                        else if ( response_key == "direct_download_free_bandwidth" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->direct_download_free_bandwidth);
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_links )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.links\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.links",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.links
+        {
+            Response::Links optarg;
+            if ( LinksFromJsonReader(response, &optarg, reader) )
+                response->links.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -350,6 +604,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -387,6 +656,20 @@ void Request::SetLinkTypes(std::set<LinkType> link_types)
     impl_->link_types_ = link_types;
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -80,6 +81,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -183,6 +191,109 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->one_time_key_request_count = 0;
+    response->one_time_key_request_max_count = 0;
+    bool has_token = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "one_time_key_request_count" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->one_time_key_request_count);
+                        }
+                        else if ( response_key == "one_time_key_request_max_count" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->one_time_key_request_max_count);
+                        }
+                        else if ( response_key == "token" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->token) )
+                                has_token = true;
+                        }
+                        else if ( response_key == "links" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_links_key;
+                                while ( reader->NextMember(&response_links_key) )
+                                {
+                                    if ( response_links_key == "download" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->download_link = std::move(optarg);
+                                    }
+                                    else if ( response_links_key == "view" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->view_link = std::move(optarg);
+                                    }
+                                    else if ( response_links_key == "watch" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->watch_link = std::move(optarg);
+                                    }
+                                    else if ( response_links_key == "listen" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->listen_link = std::move(optarg);
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_token )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.token\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -221,6 +332,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
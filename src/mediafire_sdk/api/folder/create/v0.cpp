@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -62,6 +63,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -165,6 +173,138 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_folderkey = false;
+    bool has_uploadkey = false;
+    bool has_name = false;
+    bool has_created_datetime = false;
+    bool has_privacy = false;
+    bool has_revision = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "folder_key" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->folderkey) )
+                                has_folderkey = true;
+                        }
+                        else if ( response_key == "upload_key" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->uploadkey) )
+                                has_uploadkey = true;
+                        }
+                        else if ( response_key == "name" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->name) )
+                                has_name = true;
+                        }
+                        else if ( response_key == "created" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->created_datetime) )
+                                has_created_datetime = true;
+                        }
+                        else if ( response_key == "privacy" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "public" )
+                                    response->privacy = Privacy::Public;
+                                else if ( optval == "private" )
+                                    response->privacy = Privacy::Private;
+                                else
+                                    set_error(
+                                        mf::api::api_code::ContentInvalidData,
+                                        "invalid value in response.privacy");
+                                has_privacy = true;
+                            }
+                        }
+                        else if ( response_key == "revision" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->revision) )
+                                has_revision = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_folderkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.folder_key\"");
+    }
+
+    if ( ! has_uploadkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.upload_key\"");
+    }
+
+    if ( ! has_name )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.name\"");
+    }
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.created\"");
+    }
+
+    if ( ! has_privacy )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.privacy");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.revision\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -196,6 +336,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -759,6 +760,759 @@ bool FolderFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool LinksFromJsonReader(
+        Response * response,
+        Response::Links * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "direct_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->direct_download = std::move(optarg);
+            }
+            else if ( key == "edit" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->edit = std::move(optarg);
+            }
+            else if ( key == "normal_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->normal_download = std::move(optarg);
+            }
+            else if ( key == "one_time_download" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->one_time_download = std::move(optarg);
+            }
+            else if ( key == "view" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->view = std::move(optarg);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool PermissionsFromJsonReader(
+        Response * response,
+        Response::Permissions * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_value = false;
+    bool has_explicit_share = false;
+    bool has_read_permission = false;
+    bool has_write_permission = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "value" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->value) )
+                    has_value = true;
+            }
+            else if ( key == "explicit" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->explicit_share = ExplicitShare::No;
+                    else if ( optval == "1" )
+                        value->explicit_share = ExplicitShare::Yes;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in explicit");
+                    has_explicit_share = true;
+                }
+            }
+            else if ( key == "read" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "1" )
+                        value->read_permission = Permission::Allowed;
+                    else if ( optval == "0" )
+                        value->read_permission = Permission::Denied;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in read");
+                    has_read_permission = true;
+                }
+            }
+            else if ( key == "write" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "1" )
+                        value->write_permission = Permission::Allowed;
+                    else if ( optval == "0" )
+                        value->write_permission = Permission::Denied;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in write");
+                    has_write_permission = true;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_value )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"value\"");
+    }
+
+    if ( ! has_explicit_share )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in explicit");
+    }
+
+    if ( ! has_read_permission )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in read");
+    }
+
+    if ( ! has_write_permission )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in write");
+    }
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool FileFromJsonReader(
+        Response * response,
+        Response::File * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->deleted_datetime = boost::posix_time::not_a_date_time;
+    value->mimetype = "";
+    value->shared_by_user = SharedByUser::Unshared;
+    value->shared_with_user = SharedWithUser::UserIsOwner;
+    bool has_created_datetime = false;
+    bool has_download_count = false;
+    bool has_filename = false;
+    bool has_filesize = false;
+    bool has_filetype = false;
+    bool has_flag = false;
+    bool has_hash = false;
+    bool has_links = false;
+    bool has_password_protected = false;
+    bool has_privacy = false;
+    bool has_quickkey = false;
+    bool has_revision = false;
+    bool has_views = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "created" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->created_datetime) )
+                    has_created_datetime = true;
+            }
+            else if ( key == "delete_date" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->deleted_datetime);
+            }
+            else if ( key == "description" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->description = std::move(optarg);
+            }
+            else if ( key == "downloads" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->download_count) )
+                    has_download_count = true;
+            }
+            else if ( key == "filename" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filename) )
+                    has_filename = true;
+            }
+            else if ( key == "size" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filesize) )
+                    has_filesize = true;
+            }
+            else if ( key == "filetype" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filetype) )
+                    has_filetype = true;
+            }
+            else if ( key == "flag" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->flag) )
+                    has_flag = true;
+            }
+            else if ( key == "hash" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->hash) )
+                    has_hash = true;
+            }
+            else if ( key == "links" )
+            {
+                // create_content_struct_read TSingle
+                Response::Links optarg;
+                if ( LinksFromJsonReader(response, &optarg, reader) )
+                {
+                    value->links = std::move(optarg);
+                    has_links = true;
+                }
+            }
+            else if ( key == "mimetype" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->mimetype);
+            }
+            else if ( key == "password_protected" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->password_protected = PasswordProtected::Unprotected;
+                    else if ( optval == "yes" )
+                        value->password_protected = PasswordProtected::Protected;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in password_protected");
+                    has_password_protected = true;
+                }
+            }
+            else if ( key == "permissions" )
+            {
+                // create_content_struct_read TSingle
+                Response::Permissions optarg;
+                if ( PermissionsFromJsonReader(response, &optarg, reader) )
+                {
+                    value->permissions = std::move(optarg);
+                }
+            }
+            else if ( key == "privacy" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "public" )
+                        value->privacy = Privacy::Public;
+                    else if ( optval == "private" )
+                        value->privacy = Privacy::Private;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in privacy");
+                    has_privacy = true;
+                }
+            }
+            else if ( key == "quickkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->quickkey) )
+                    has_quickkey = true;
+            }
+            else if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "shared_by_user" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "" )
+                        value->shared_by_user = SharedByUser::Unshared;
+                    else if ( optval == "1" )
+                        value->shared_by_user = SharedByUser::Shared;
+                }
+            }
+            else if ( key == "shared" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->shared_with_user = SharedWithUser::UserIsOwner;
+                    else if ( optval == "yes" )
+                        value->shared_with_user = SharedWithUser::SharedWithUser;
+                }
+            }
+            else if ( key == "views" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->views) )
+                    has_views = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"created\"");
+    }
+
+    if ( ! has_download_count )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"downloads\"");
+    }
+
+    if ( ! has_filename )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"filename\"");
+    }
+
+    if ( ! has_filesize )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"size\"");
+    }
+
+    if ( ! has_filetype )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"filetype\"");
+    }
+
+    if ( ! has_flag )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"flag\"");
+    }
+
+    if ( ! has_hash )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"hash\"");
+    }
+
+    if ( ! has_links )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"links\"");
+    }
+
+    if ( ! has_password_protected )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in password_protected");
+    }
+
+    if ( ! has_privacy )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in privacy");
+    }
+
+    if ( ! has_quickkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"quickkey\"");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    if ( ! has_views )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"views\"");
+    }
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool FolderFromJsonReader(
+        Response * response,
+        Response::Folder * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->deleted_datetime = boost::posix_time::not_a_date_time;
+    value->shared_by_user = SharedByUser::Unshared;
+    value->shared_with_user = SharedWithUser::UserIsOwner;
+    bool has_created_datetime = false;
+    bool has_file_count = false;
+    bool has_filedrop = false;
+    bool has_flag = false;
+    bool has_folder_count = false;
+    bool has_folderkey = false;
+    bool has_name = false;
+    bool has_privacy = false;
+    bool has_revision = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "created" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->created_datetime) )
+                    has_created_datetime = true;
+            }
+            else if ( key == "delete_date" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->deleted_datetime);
+            }
+            else if ( key == "description" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->description = std::move(optarg);
+            }
+            else if ( key == "file_count" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->file_count) )
+                    has_file_count = true;
+            }
+            else if ( key == "dropbox_enabled" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->filedrop = FileDrop::Disabled;
+                    else if ( optval == "yes" )
+                        value->filedrop = FileDrop::Enabled;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in dropbox_enabled");
+                    has_filedrop = true;
+                }
+            }
+            else if ( key == "flag" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->flag) )
+                    has_flag = true;
+            }
+            else if ( key == "folder_count" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->folder_count) )
+                    has_folder_count = true;
+            }
+            else if ( key == "folderkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->folderkey) )
+                    has_folderkey = true;
+            }
+            else if ( key == "name" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->name) )
+                    has_name = true;
+            }
+            else if ( key == "permissions" )
+            {
+                // create_content_struct_read TSingle
+                Response::Permissions optarg;
+                if ( PermissionsFromJsonReader(response, &optarg, reader) )
+                {
+                    value->permissions = std::move(optarg);
+                }
+            }
+            else if ( key == "privacy" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "public" )
+                        value->privacy = Privacy::Public;
+                    else if ( optval == "private" )
+                        value->privacy = Privacy::Private;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in privacy");
+                    has_privacy = true;
+                }
+            }
+            else if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "shared_by_user" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "" )
+                        value->shared_by_user = SharedByUser::Unshared;
+                    else if ( optval == "1" )
+                        value->shared_by_user = SharedByUser::Shared;
+                }
+            }
+            else if ( key == "shared" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->shared_with_user = SharedWithUser::UserIsOwner;
+                    else if ( optval == "yes" )
+                        value->shared_with_user = SharedWithUser::SharedWithUser;
+                }
+            }
+            else if ( key == "tags" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->tags = std::move(optarg);
+            }
+            else if ( key == "total_files" )
+            {
+                // create_content_read_single
+                uint32_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->total_files = std::move(optarg);
+            }
+            else if ( key == "total_folders" )
+            {
+                // create_content_read_single
+                uint32_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->total_folders = std::move(optarg);
+            }
+            else if ( key == "total_size" )
+            {
+                // create_content_read_single
+                uint64_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->total_size = std::move(optarg);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_created_datetime )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"created\"");
+    }
+
+    if ( ! has_file_count )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"file_count\"");
+    }
+
+    if ( ! has_filedrop )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in dropbox_enabled");
+    }
+
+    if ( ! has_flag )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"flag\"");
+    }
+
+    if ( ! has_folder_count )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"folder_count\"");
+    }
+
+    if ( ! has_folderkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"folderkey\"");
+    }
+
+    if ( ! has_name )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"name\"");
+    }
+
+    if ( ! has_privacy )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in privacy");
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -797,6 +1551,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -938,6 +1707,195 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_chunk_size = false;
+    bool has_content_type = false;
+    bool has_chunk_number = false;
+    bool has_chunks_remaining = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "folder_content" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_folder_content_key;
+                                while ( reader->NextMember(&response_folder_content_key) )
+                                {
+                                    if ( response_folder_content_key == "chunk_size" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->chunk_size) )
+                                            has_chunk_size = true;
+                                    }
+                                    else if ( response_folder_content_key == "content_type" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "folders" )
+                                                response->content_type = ContentType::Folders;
+                                            else if ( optval == "files" )
+                                                response->content_type = ContentType::Files;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.folder_content.content_type");
+                                            has_content_type = true;
+                                        }
+                                    }
+                                    else if ( response_folder_content_key == "chunk_number" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->chunk_number) )
+                                            has_chunk_number = true;
+                                    }
+                                    else if ( response_folder_content_key == "more_chunks" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "yes" )
+                                                response->chunks_remaining = ChunksRemaining::MoreChunks;
+                                            else if ( optval == "no" )
+                                                response->chunks_remaining = ChunksRemaining::LastChunk;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.folder_content.more_chunks");
+                                            has_chunks_remaining = true;
+                                        }
+                                    }
+                                    else if ( response_folder_content_key == "files" )
+                                    {
+                                        // create_content_struct_read TArray
+                                        if ( reader->BeginArray() )
+                                        {
+                                            while ( reader->NextElement() )
+                                            {
+                                                Response::File optarg;
+                                                if ( FileFromJsonReader(response, &optarg, reader) )
+                                                    response->files.push_back(std::move(optarg));
+                                            }
+                                        }
+                                    }
+                                    else if ( response_folder_content_key == "folders" )
+                                    {
+                                        // create_content_struct_read TArray
+                                        if ( reader->BeginArray() )
+                                        {
+                                            while ( reader->NextElement() )
+                                            {
+                                                Response::Folder optarg;
+                                                if ( FolderFromJsonReader(response, &optarg, reader) )
+                                                    response->folders.push_back(std::move(optarg));
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_chunk_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.folder_content.chunk_size\"");
+    }
+
+    if ( ! has_content_type )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.folder_content.content_type");
+    }
+
+    if ( ! has_chunk_number )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.folder_content.chunk_number\"");
+    }
+
+    if ( ! has_chunks_remaining )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.folder_content.more_chunks");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.folder_content.files",
+            "response.folder_content.folders",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.folder_content.files
+        {
+            Response::File optarg;
+            if ( FileFromJsonReader(response, &optarg, reader) )
+                response->files.push_back(std::move(optarg));
+            break;
+        }
+        case 1:  // response.folder_content.folders
+        {
+            Response::Folder optarg;
+            if ( FolderFromJsonReader(response, &optarg, reader) )
+                response->folders.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -979,6 +1937,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -1041,6 +2014,20 @@ void Request::SetChunkSize(uint32_t chunk_size)
     impl_->chunk_size_ = chunk_size;
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
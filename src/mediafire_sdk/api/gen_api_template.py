@@ -7,9 +7,14 @@ import os
 import re
 import sys
 import textwrap
+from collections import OrderedDict
 
 default_http_input_method = 'POST'
 
+# Members of "response" read by ResponseBase::ReadEnvelopeMember.
+response_envelope_members = ['action', 'error', 'message', 'new_key',
+                             'result']
+
 
 class TSingle(object):
     pass
@@ -1441,6 +1446,11 @@ def get_data_type_struct_extractors(api):
         ret.append(get_data_type_struct_extractor(api, struct_cpp_name,
                                                   struct_members))
 
+    for (struct_cpp_name, struct_members) \
+            in parse_return_struct(api['return_structs']):
+        ret.append(get_data_type_struct_reader(api, struct_cpp_name,
+                                               struct_members))
+
     if len(ret) > 0:
         return '''
 namespace {
@@ -1474,6 +1484,143 @@ def get_struct_names(api):
     return ret
 
 
+def get_batched_arrays(api):
+    '''Return parameters that are arrays of structs, whose elements can be
+    delivered in batches as they arrive.'''
+
+    struct_names = get_struct_names(api)
+    batched = []
+
+    if 'return_params' in api:
+        for ret_data in api['return_params']:
+            (cpp_type, cpp_name, api_path, json_type, optional, description) \
+                = get_return_parameters(ret_data)
+            if json_type is TArray and cpp_type in struct_names:
+                batched.append((cpp_type, cpp_name, api_path))
+
+    return batched
+
+
+def get_cpp_batch_impl_decl(api):
+    if len(get_batched_arrays(api)) == 0:
+        return ''
+
+    return '''
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+'''
+
+
+def get_cpp_batch_impl_def(api):
+    batched = get_batched_arrays(api)
+    if len(batched) == 0:
+        return ''
+
+    lines = []
+    lines.append(I(0) + 'std::vector<std::string> Impl::BatchedArrayPaths() '
+                 'const')
+    lines.append(I(0) + '{')
+    lines.append(I(1) + 'return {')
+    for (cpp_type, cpp_name, api_path) in batched:
+        lines.append(I(3) + '"' + api_path + '",')
+    lines.append(I(2) + '};')
+    lines.append(I(0) + '}')
+    lines.append('')
+    lines.append(I(0) + 'void Impl::ReadBatchedElement(')
+    lines.append(I(2) + 'std::size_t path_index,')
+    lines.append(I(2) + 'Response * response,')
+    lines.append(I(2) + 'mf::api::JsonReader * reader')
+    lines.append(I(1) + ')')
+    lines.append(I(0) + '{')
+    lines.append(I(1) + 'switch (path_index)')
+    lines.append(I(1) + '{')
+    for index, (cpp_type, cpp_name, api_path) in enumerate(batched):
+        lines.append(I(2) + 'case ' + str(index) + ':  // ' + api_path)
+        lines.append(I(2) + '{')
+        lines.append(I(3) + 'Response::' + cpp_type + ' optarg;')
+        lines.append(I(3) + 'if ( ' + cpp_type +
+                     'FromJsonReader(response, &optarg, reader) )')
+        lines.append(I(4) + 'response->' + cpp_name +
+                     '.push_back(std::move(optarg));')
+        lines.append(I(3) + 'break;')
+        lines.append(I(2) + '}')
+    lines.append(I(2) + 'default:')
+    lines.append(I(3) + 'reader->Skip();')
+    lines.append(I(3) + 'break;')
+    lines.append(I(1) + '}')
+    lines.append(I(0) + '}')
+
+    return '\n'.join(lines) + '\n\n'
+
+
+def get_hpp_batch_setter(api):
+    batched = get_batched_arrays(api)
+    if len(batched) == 0:
+        return ''
+
+    description = ('Deliver the elements of ' +
+                   ', '.join('"' + api_path + '"'
+                             for (t, n, api_path) in batched) +
+                   ' in batches while the response is still arriving.  '
+                   'They are then left out of the response passed to the '
+                   'callback, which comes after the last batch.')
+
+    lines = []
+    lines.append(I(1) + '/**')
+    for line in textwrap.wrap(description, 80 - len(I(1) + ' * ')):
+        lines.append(I(1) + ' * ' + line)
+    lines.append(I(1) + ' *')
+    lines.append(format_parameter_documentation(
+        1, 'batch_callback', 'Called with each batch.').rstrip('\n'))
+    lines.append(format_parameter_documentation(
+        1, 'batch_size', 'Most elements in one batch.').rstrip('\n'))
+    lines.append(I(1) + ' */')
+    lines.append(I(1) + 'void SetBatchCallback(')
+    lines.append(I(3) + 'std::function< void( const Response & batch)> '
+                 'batch_callback,')
+    lines.append(I(3) + 'std::size_t batch_size')
+    lines.append(I(2) + ');')
+
+    return '\n'.join(lines) + '\n\n'
+
+
+def get_hpp_batch_template(api):
+    if len(get_batched_arrays(api)) == 0:
+        return ''
+
+    return '''    /** Requester optional method. */
+    std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+        BeginIncrementalContent();
+
+'''
+
+
+def get_cpp_batch_template(api):
+    if len(get_batched_arrays(api)) == 0:
+        return ''
+
+    return '''void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
+'''
+
+
 def get_return_parameters(param):
     if 'cpp_type' not in param:
         raise RequiredParameter(param, 'cpp_type')
@@ -1566,6 +1713,357 @@ def get_content_parsing(api):
     return ret
 
 
+class ReadNode(object):
+    '''Node of the tree of JSON paths read by the streaming parser.'''
+
+    def __init__(self):
+        self.children = OrderedDict()
+        self.param = None
+
+
+def build_read_tree(return_param_list, envelope):
+    '''Group return parameters by the JSON objects containing them.'''
+
+    root = ReadNode()
+    if envelope:
+        root.children['response'] = ReadNode()
+
+    for ret_data in return_param_list:
+        (cpp_type, cpp_name, api_path, json_type, optional, description) \
+            = get_return_parameters(ret_data)
+
+        parts = api_path.split('.')
+        if envelope and len(parts) == 2 and parts[0] == 'response' \
+                and parts[1] in response_envelope_members:
+            raise UnimplementedError(
+                'Reading response envelope member "' + api_path + '"')
+
+        node = root
+        for part in parts:
+            if node.param is not None:
+                raise UnimplementedError(
+                    'Reading values inside of "' + api_path + '"')
+            node = node.children.setdefault(part, ReadNode())
+
+        if node.param is not None or len(node.children) > 0:
+            raise UnimplementedError('Reading "' + api_path + '" twice')
+        node.param = ret_data
+
+    return root
+
+
+def read_key_variable(parts):
+    '''Name of the variable holding the member names of an object.'''
+
+    if len(parts) == 0:
+        return 'key'
+    return re.sub('[^A-Za-z0-9_]', '_', '_'.join(parts)) + '_key'
+
+
+def create_content_read_value(api, ob, ret_data, level):
+    '''Read a return parameter from the value the reader is positioned at.'''
+
+    enum_names = get_enum_names(api)
+    struct_names = get_struct_names(api)
+
+    (t, n, r, dt, optional, description) = get_return_parameters(ret_data)
+
+    required = optional is Required
+    lines = []
+
+    if t in enum_names:
+        if dt is TArray:
+            raise UnimplementedError(
+                "Parsing enums in array is not implemented")
+        if dt is TArrayFront:
+            read = 'reader->ReadArrayFront(&optval)'
+        else:
+            read = 'reader->ReadValue(&optval)'
+        lines.append(I(0) + '// create_content_enum_read')
+        lines.append(I(0) + 'std::string optval;')
+        lines.append(I(0) + 'if ( ' + read + ' )')
+        lines.append(I(0) + '{')
+        cases = []
+        for (enum_cpp_name, enum_members) in parse_enum_params(api['enums']):
+            if enum_cpp_name == t:
+                for (enum_cpp_key, enum_api_value, additional_api_values) \
+                        in parse_enum_members(enum_members):
+                    for value in [enum_api_value] + additional_api_values:
+                        cases.append((value, enum_cpp_name + '::' +
+                                      enum_cpp_key))
+        for i, (value, cpp_value) in enumerate(cases):
+            lines.append(I(1) + ('else ' if i > 0 else '') +
+                         'if ( optval == "' + value + '" )')
+            lines.append(I(2) + ob + '->' + n + ' = ' + cpp_value + ';')
+        if required:
+            lines.append(I(1) + 'else')
+            lines.append(I(2) + 'set_error(')
+            lines.append(I(3) + 'mf::api::api_code::ContentInvalidData,')
+            lines.append(I(3) + '"invalid value in ' + r + '");')
+            lines.append(I(1) + 'has_' + n + ' = true;')
+        lines.append(I(0) + '}')
+
+    elif t in struct_names:
+        full_type_name = 'Response::' + t
+        read = t + 'FromJsonReader(response, &optarg, reader)'
+        if dt is TArray:
+            lines.append(I(0) + '// create_content_struct_read TArray')
+            if required:
+                lines.append(I(0) + 'has_' + n + ' = true;')
+            lines.append(I(0) + 'if ( reader->BeginArray() )')
+            lines.append(I(0) + '{')
+            if required:
+                lines.append(I(1) + 'bool skip_rest = false;')
+            lines.append(I(1) + 'while ( reader->NextElement() )')
+            lines.append(I(1) + '{')
+            lines.append(I(2) + full_type_name + ' optarg;')
+            if required:
+                lines.append(I(2) + 'if ( skip_rest )')
+                lines.append(I(3) + 'reader->Skip();')
+                lines.append(I(2) + 'else if ( ' + read + ' )')
+            else:
+                lines.append(I(2) + 'if ( ' + read + ' )')
+            lines.append(I(3) + ob + '->' + n +
+                         '.push_back(std::move(optarg));')
+            if required:
+                lines.append(I(2) + 'else')
+                lines.append(I(3) + 'skip_rest = true;  // error set already')
+            lines.append(I(1) + '}')
+            lines.append(I(0) + '}')
+        elif dt is TSingle:
+            lines.append(I(0) + '// create_content_struct_read TSingle')
+            lines.append(I(0) + full_type_name + ' optarg;')
+            lines.append(I(0) + 'if ( ' + read + ' )')
+            lines.append(I(0) + '{')
+            lines.append(I(1) + ob + '->' + n + ' = std::move(optarg);')
+            if required:
+                lines.append(I(1) + 'has_' + n + ' = true;')
+            lines.append(I(0) + '}')
+        else:
+            raise UnimplementedError(
+                "Parsing struct as array front not implemented")
+
+    elif dt is TArray:
+        lines.append(I(0) + '// create_content_read_array TArray')
+        if required:
+            lines.append(I(0) + 'has_' + n + ' = true;')
+        lines.append(I(0) + 'if ( reader->BeginArray() )')
+        lines.append(I(0) + '{')
+        lines.append(I(1) + 'bool skip_rest = false;')
+        lines.append(I(1) + 'while ( reader->NextElement() )')
+        lines.append(I(1) + '{')
+        lines.append(I(2) + t + ' result;')
+        lines.append(I(2) + 'if ( skip_rest )')
+        lines.append(I(3) + 'reader->Skip();')
+        lines.append(I(2) + 'else if ( reader->ReadValue(&result) )')
+        lines.append(I(3) + ob + '->' + n + '.push_back(std::move(result));')
+        lines.append(I(2) + 'else')
+        lines.append(I(2) + '{')
+        if required:
+            lines.append(I(3) + 'set_error(')
+            lines.append(I(4) + 'mf::api::api_code::ContentInvalidData,')
+            lines.append(I(4) + '"invalid value in ' + r + '");')
+        lines.append(I(3) + 'skip_rest = true;')
+        lines.append(I(2) + '}')
+        lines.append(I(1) + '}')
+        lines.append(I(0) + '}')
+
+    elif dt is TArrayFront or dt is TSingle:
+        if dt is TArrayFront:
+            lines.append(I(0) + '// create_content_read_array_front')
+            read = 'reader->ReadArrayFront'
+        else:
+            lines.append(I(0) + '// create_content_read_single')
+            read = 'reader->ReadValue'
+        if is_optional_with_default(optional):
+            lines.append(I(0) + read + '(&' + ob + '->' + n + ');')
+        elif is_optional_no_default(optional):
+            lines.append(I(0) + t + ' optarg;')
+            lines.append(I(0) + 'if ( ' + read + '(&optarg) )')
+            lines.append(I(1) + ob + '->' + n + ' = std::move(optarg);')
+        else:
+            lines.append(I(0) + 'if ( ' + read + '(&' + ob + '->' + n +
+                         ') )')
+            lines.append(I(1) + 'has_' + n + ' = true;')
+
+    else:
+        raise InvalidTType(dt)
+
+    return [I(level) + line for line in lines]
+
+
+def create_content_read_object(api, ob, node, parts, level, envelope,
+                               count_members):
+    '''Read the members of the object the reader is positioned at.'''
+
+    key = read_key_variable(parts)
+
+    lines = []
+    lines.append(I(level) + 'if ( reader->BeginObject() )')
+    lines.append(I(level) + '{')
+    lines.append(I(level + 1) + 'std::string ' + key + ';')
+    lines.append(I(level + 1) + 'while ( reader->NextMember(&' + key + ') )')
+    lines.append(I(level + 1) + '{')
+    if count_members:
+        lines.append(I(level + 2) + '++member_count;')
+
+    first = True
+    for (name, child) in node.children.items():
+        lines.append(I(level + 2) + ('' if first else 'else ') + 'if ( ' +
+                     key + ' == "' + name + '" )')
+        lines.append(I(level + 2) + '{')
+        if child.param is not None:
+            lines.extend(create_content_read_value(api, ob, child.param,
+                                                   level + 3))
+        else:
+            child_envelope = envelope and len(parts) == 0 \
+                and name == 'response'
+            lines.extend(create_content_read_object(
+                api, ob, child, parts + [name], level + 3, child_envelope,
+                False))
+        lines.append(I(level + 2) + '}')
+        first = False
+
+    if envelope and len(parts) > 0:
+        skip = 'response->ReadEnvelopeMember(' + key + ', reader);'
+    else:
+        skip = 'reader->Skip();'
+    if first:
+        lines.append(I(level + 2) + skip)
+    else:
+        lines.append(I(level + 2) + 'else')
+        lines.append(I(level + 3) + skip)
+
+    lines.append(I(level + 1) + '}')
+    lines.append(I(level) + '}')
+
+    return lines
+
+
+def content_read_branch(api, ob, return_param_list, envelope):
+    '''Create code to read return JSON with a JsonReader.'''
+
+    enum_names = get_enum_names(api)
+    struct_names = get_struct_names(api)
+    lines = []
+
+    for ret_data in return_param_list:
+        (cpp_type, cpp_name, api_path, json_type, optional, description) \
+            = get_return_parameters(ret_data)
+
+        if is_optional_with_default(optional):
+            if cpp_type in enum_names:
+                lines.append(I(1) + ob + '->' + cpp_name + ' = ' + cpp_type +
+                             '::' + optional.default_value + ';')
+            else:
+                lines.append(I(1) + ob + '->' + cpp_name + ' = ' +
+                             optional.default_value + ';')
+
+    for ret_data in return_param_list:
+        (cpp_type, cpp_name, api_path, json_type, optional, description) \
+            = get_return_parameters(ret_data)
+
+        if optional is Required:
+            lines.append(I(1) + 'bool has_' + cpp_name + ' = false;')
+
+    if len(lines) > 0:
+        lines.append('')
+
+    tree = build_read_tree(return_param_list, envelope)
+    lines.extend(create_content_read_object(api, ob, tree, [], 1, envelope,
+                                            not envelope))
+
+    if not envelope:
+        lines.append('')
+        lines.append(I(1) + 'if (member_count == 0)  // Stop if branch is '
+                     'empty')
+        lines.append(I(2) + 'return false;')
+
+    for ret_data in return_param_list:
+        (t, n, r, dt, optional, description) \
+            = get_return_parameters(ret_data)
+
+        if optional is not Required:
+            continue
+
+        if t in enum_names:
+            message = '"no value in ' + r + '"'
+        else:
+            message = '"missing \\"' + r + '\\""'
+
+        lines.append('')
+        lines.append(I(1) + 'if ( ! has_' + n + ' )')
+        lines.append(I(1) + '{')
+        lines.append(I(2) + 'set_error(')
+        lines.append(I(3) + 'mf::api::api_code::ContentInvalidData,')
+        lines.append(I(3) + message + ');')
+        lines.append(I(1) + '}')
+
+        if dt is TArray and t not in struct_names:
+            lines.append(I(1) + 'else if ( ' + ob + '->' + n + '.empty() )')
+            lines.append(I(1) + '{')
+            lines.append(I(2) + 'set_error(')
+            lines.append(I(3) + 'mf::api::api_code::ContentInvalidData,')
+            lines.append(I(3) + '"missing value in ' + r + '");')
+            lines.append(I(1) + '}')
+
+    return '\n'.join(lines)
+
+
+def get_content_reading(api):
+    '''Create code to read return JSON with a JsonReader.'''
+
+    return_param_list = []
+    if 'return_params' in api:
+        return_param_list = api['return_params']
+
+    return content_read_branch(api, 'response', return_param_list, True)
+
+
+def get_data_type_struct_reader(api, name, param_list):
+    lines = []
+    lines.append(I(0) + '// get_data_type_struct_reader begin')
+    lines.append(I(0) + 'bool ' + name + 'FromJsonReader(')
+    lines.append(I(2) + 'Response * response,')
+    lines.append(I(2) + 'Response::' + name + ' * value,')
+    lines.append(I(2) + 'mf::api::JsonReader * reader')
+    lines.append(I(1) + ')')
+    lines.append(I(0) + '{')
+    lines.append(I(0) + '#   define set_error(error_type, error_message)' +
+                 '                                \\')
+    lines.append(I(1) + '{                                                 ' +
+                 '                         \\')
+    lines.append(I(2) + 'if ( ! response->error_code )                     ' +
+                 '                     \\')
+    lines.append(I(2) + '{                                                 ' +
+                 '                     \\')
+    lines.append(I(3) + 'response->error_code = make_error_code( ' +
+                 'error_type );' +
+                 '              \\')
+    lines.append(I(3) + 'response->error_string = error_message;           ' +
+                 '                 \\')
+    lines.append(I(2) + '}                                                 ' +
+                 '                     \\')
+    lines.append(I(2) + 'valid = false;                                    ' +
+                 '                     \\')
+    lines.append(I(1) + '}')
+    lines.append(I(1) + 'bool valid = true;')
+    lines.append(I(1) + 'std::size_t member_count = 0;')
+
+    top = '\n'.join(lines) + '\n'
+
+    middle = content_read_branch(api, 'value', param_list, False) + '\n\n'
+
+    lines = []
+    lines.append(I(1) + 'return valid;')
+    lines.append(I(0) + '#   undef set_error')
+    lines.append(I(0) + '}')
+
+    bottom = '\n'.join(lines)
+
+    return top + middle + bottom
+
+
 def create_enum(enum_cpp_name, enum_members):
     '''Define an enum for the header.'''
 
@@ -1721,6 +2219,10 @@ def get_additional_hpp_local_includes(api):
         includes = (includes +
                     '#include "mediafire_sdk/http/shared_buffer.hpp"\n')
 
+    if len(get_batched_arrays(api)) > 0:
+        includes = (includes + '#include "mediafire_sdk/api/detail/'
+                    'incremental_content_interface.hpp"\n')
+
     return includes
 
 
@@ -1778,7 +2280,11 @@ def create_templates(api, target_path):
     replacements['__AS_STRING_FUNCS__'] = get_as_string_funcs(api)
     replacements['__CLASS_MEMBER_VARS__'] = get_class_member_vars(api)
     replacements['__CONTENT_PARSING__'] = get_content_parsing(api)
+    replacements['__CONTENT_READING__'] = get_content_reading(api)
     replacements['__CPPSAFE_NAME__'] = cppsafe_name
+    replacements['__CPP_BATCH_IMPL_DECL__'] = get_cpp_batch_impl_decl(api)
+    replacements['__CPP_BATCH_IMPL_DEF__'] = get_cpp_batch_impl_def(api)
+    replacements['__CPP_BATCH_TEMPLATE__'] = get_cpp_batch_template(api)
     replacements['__CPP_CTORS__'] = get_cpp_ctors(api)
     replacements['__CPP_CTOR_ARGS__'] = get_cpp_ctor_args(api)
     replacements['__CPP_FILENAME__'] = filename + '.cpp'
@@ -1798,6 +2304,8 @@ def create_templates(api, target_path):
         = get_data_type_struct_extractors(api)
     replacements['__ENUMS__'] = get_enums(api)
     replacements['__EXPLICIT__'] = get_explicit(api)
+    replacements['__HPP_BATCH_SETTER__'] = get_hpp_batch_setter(api)
+    replacements['__HPP_BATCH_TEMPLATE__'] = get_hpp_batch_template(api)
     replacements['__HPP_CTORS__'] = get_hpp_ctors(api)
     replacements['__HPP_CTOR_ARGS__'] = get_hpp_ctor_args(api)
     replacements['__HPP_FILENAME__'] = version_str + '.hpp'
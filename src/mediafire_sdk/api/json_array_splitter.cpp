@@ -0,0 +1,247 @@
+/**
+ * @file json_array_splitter.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "json_array_splitter.hpp"
+
+#include <utility>
+
+namespace api = mf::api;
+
+namespace {
+
+bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+}  // namespace
+
+api::JsonArraySplitter::JsonArraySplitter(
+        std::vector<std::string> array_paths,
+        ElementCallback element_callback
+    ) :
+    array_paths_(std::move(array_paths)),
+    element_callback_(std::move(element_callback)),
+    failed_(false),
+    in_string_(false),
+    escape_(false),
+    reading_key_(false),
+    split_level_(-1),
+    split_path_index_(0),
+    element_started_(false)
+{
+}
+
+void api::JsonArraySplitter::Append(
+        const char * data,
+        std::size_t size
+    )
+{
+    const char * const end = data + size;
+
+    for (const char * it = data; it != end; ++it)
+    {
+        const char c = *it;
+
+        if (failed_)
+        {
+            remainder_.append(it, end);
+            return;
+        }
+
+        // Inside an element everything but its end is passed through.
+        std::string & out = split_level_ < 0 ? remainder_ : element_;
+
+        if (in_string_)
+        {
+            if ( ! escape_ && c != '\\' && c != '"' )
+            {
+                // Copy the rest of the plain run at once.
+                const char * run_end = it + 1;
+                while (run_end != end && *run_end != '\\' && *run_end != '"')
+                    ++run_end;
+
+                out.append(it, run_end);
+                if (reading_key_)
+                    levels_.back().key.append(it, run_end);
+
+                it = run_end - 1;
+                continue;
+            }
+
+            out.push_back(c);
+
+            if (escape_)
+            {
+                escape_ = false;
+            }
+            else if (c == '\\')
+            {
+                escape_ = true;
+            }
+            else if (c == '"')
+            {
+                in_string_ = false;
+                reading_key_ = false;
+                continue;
+            }
+
+            // Keys are compared as written, escapes included.
+            if (reading_key_)
+                levels_.back().key.push_back(c);
+
+            continue;
+        }
+
+        const bool element_level = split_level_ >= 0
+            && levels_.size() == static_cast<std::size_t>(split_level_) + 1;
+
+        switch (c)
+        {
+            case '"':
+                in_string_ = true;
+                if ( split_level_ < 0 && ! levels_.empty()
+                    && levels_.back().object && levels_.back().expect_key )
+                {
+                    reading_key_ = true;
+                    levels_.back().key.clear();
+                }
+                out.push_back(c);
+                break;
+            case '{':
+            case '[':
+                out.push_back(c);
+                Open(c);
+                break;
+            case '}':
+            case ']':
+                if (element_level)
+                {
+                    // End of the array being split.
+                    EndElement();
+                    split_level_ = -1;
+                    remainder_.push_back(c);
+                }
+                else
+                {
+                    out.push_back(c);
+                }
+                Close(c);
+                break;
+            case ',':
+                if (element_level)
+                {
+                    EndElement();
+                }
+                else
+                {
+                    out.push_back(c);
+                    if ( ! levels_.empty() && levels_.back().object )
+                        levels_.back().expect_key = true;
+                }
+                break;
+            case ':':
+                out.push_back(c);
+                if ( ! levels_.empty() && levels_.back().object )
+                    levels_.back().expect_key = false;
+                break;
+            default:
+                out.push_back(c);
+                break;
+        }
+
+        if (element_level && ! IsWhitespace(c) && c != ',' && c != ']'
+            && c != '}')
+            element_started_ = true;
+    }
+}
+
+std::string api::JsonArraySplitter::TakeRemainder()
+{
+    std::string remainder;
+    remainder.swap(remainder_);
+    return remainder;
+}
+
+void api::JsonArraySplitter::Open(char c)
+{
+    int path_index = -1;
+    if (split_level_ < 0 && c == '[')
+        path_index = FindArrayPath();
+
+    Level level = {c == '{', c == '{', std::string()};
+    levels_.push_back(std::move(level));
+
+    if (path_index >= 0)
+    {
+        split_level_ = static_cast<int>(levels_.size()) - 1;
+        split_path_index_ = static_cast<std::size_t>(path_index);
+        element_.clear();
+        element_started_ = false;
+    }
+}
+
+void api::JsonArraySplitter::Close(char c)
+{
+    if ( levels_.empty() || levels_.back().object != (c == '}') )
+    {
+        failed_ = true;
+        return;
+    }
+
+    levels_.pop_back();
+}
+
+void api::JsonArraySplitter::EndElement()
+{
+    if (element_started_)
+        element_callback_(split_path_index_, element_);
+
+    element_.clear();
+    element_started_ = false;
+}
+
+int api::JsonArraySplitter::FindArrayPath() const
+{
+    // The array is the value of the last key read in each enclosing object.
+    for (std::size_t i = 0; i < array_paths_.size(); ++i)
+    {
+        const std::string & path = array_paths_[i];
+        std::size_t position = 0;
+        bool match = ! levels_.empty();
+
+        for (const auto & level : levels_)
+        {
+            if ( ! level.object
+                || path.compare(position, level.key.size(), level.key) != 0 )
+            {
+                match = false;
+                break;
+            }
+
+            position += level.key.size();
+
+            if (&level == &levels_.back())
+            {
+                match = (position == path.size());
+            }
+            else if (position < path.size() && path[position] == '.')
+            {
+                ++position;
+            }
+            else
+            {
+                match = false;
+                break;
+            }
+        }
+
+        if (match)
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file json_array_splitter.hpp
+ * @author Herbert Jones
+ * @brief Splits the elements of arrays out of JSON as it arrives.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mf {
+namespace api {
+
+/**
+ * @class JsonArraySplitter
+ * @brief Passes on the elements of selected arrays of a JSON document as soon
+ * as each is complete.
+ *
+ * The document is appended in pieces of any size.  Everything but the
+ * elements is kept as the remainder, so
+ * {"response":{"folder_content":{"files":[{...},{...}],"chunk_size":"2"}}}
+ * leaves {"response":{"folder_content":{"files":[],"chunk_size":"2"}}} once
+ * the elements of "response.folder_content.files" have been passed on.  Only
+ * the element being received and the remainder are held in memory.
+ *
+ * The document is not validated.  If it is found to be malformed, the rest of
+ * it is left in the remainder, where it fails to parse.
+ */
+class JsonArraySplitter
+{
+public:
+    /**
+     * Called with each complete element and the index in array_paths of the
+     * array it is from.
+     */
+    typedef std::function<
+        void(
+                std::size_t path_index,
+                const std::string & element
+            )> ElementCallback;
+
+    /**
+     * @brief CTOR
+     *
+     * @param[in] array_paths Paths of the arrays to split, such as
+     *                        "response.folder_content.files".  Arrays are only
+     *                        found through objects.
+     * @param[in] element_callback Called with each element.
+     */
+    JsonArraySplitter(
+            std::vector<std::string> array_paths,
+            ElementCallback element_callback
+        );
+
+    /**
+     * @brief Read the next piece of the document.
+     *
+     * @param[in] data Start of the piece.
+     * @param[in] size Size of the piece.
+     */
+    void Append(const char * data, std::size_t size);
+
+    /**
+     * @brief Take the document read so far without the split elements.
+     *
+     * @return The remainder.
+     */
+    std::string TakeRemainder();
+
+private:
+    struct Level
+    {
+        bool object;
+        bool expect_key;
+        std::string key;
+    };
+
+    void Open(char c);
+    void Close(char c);
+    void EndElement();
+    int FindArrayPath() const;
+
+    std::vector<std::string> array_paths_;
+    ElementCallback element_callback_;
+
+    std::vector<Level> levels_;
+
+    bool failed_;
+    bool in_string_;
+    bool escape_;
+    bool reading_key_;
+
+    /** Index in levels_ of the array being split, or -1. */
+    int split_level_;
+    std::size_t split_path_index_;
+
+    std::string element_;
+    bool element_started_;
+
+    std::string remainder_;
+};
+
+}  // namespace api
+}  // namespace mf
@@ -0,0 +1,587 @@
+/**
+ * @file json_reader.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "json_reader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "boost/date_time/local_time_adjustor.hpp"
+
+#include "mediafire_sdk/utils/string.hpp"
+
+namespace api = mf::api;
+
+namespace {
+
+/** Containers nested deeper than this are rejected. */
+const std::size_t kMaxDepth = 512;
+
+bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+void AppendUtf8(uint32_t code_point, std::string * text)
+{
+    if (code_point < 0x80)
+    {
+        text->push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800)
+    {
+        text->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        text->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000)
+    {
+        text->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        text->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else
+    {
+        text->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        text->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        text->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+}  // namespace
+
+api::JsonReader::JsonReader(const std::string & content) :
+    begin_(content.data()),
+    position_(begin_),
+    end_(begin_ + content.size()),
+    failed_(false)
+{
+}
+
+bool api::JsonReader::BeginObject()
+{
+    return BeginContainer('{', Container::Type::Object);
+}
+
+bool api::JsonReader::NextMember(std::string * key)
+{
+    assert( failed_ || ( ! containers_.empty()
+        && containers_.back().type == Container::Type::Object ) );
+
+    return NextEntry() && ReadKey(key);
+}
+
+bool api::JsonReader::BeginArray()
+{
+    return BeginContainer('[', Container::Type::Array);
+}
+
+bool api::JsonReader::NextElement()
+{
+    assert( failed_ || ( ! containers_.empty()
+        && containers_.back().type != Container::Type::Object ) );
+
+    if ( ! NextEntry() )
+        return false;
+
+    if (containers_.back().type == Container::Type::ObjectAsArray)
+        return ReadKey(nullptr);
+
+    return true;
+}
+
+bool api::JsonReader::ReadScalar(std::string * text)
+{
+    if (failed_)
+        return false;
+
+    SkipWhitespace();
+
+    if (position_ == end_)
+    {
+        SetError("expected value");
+        return false;
+    }
+
+    switch (*position_)
+    {
+        case '"':
+            return ReadString(text);
+        case '{':
+        case '[':
+            SkipValue();
+            return false;
+        default:
+            return ReadLiteral(text);
+    }
+}
+
+bool api::JsonReader::ReadValue(std::string * to_set)
+{
+    if ( ! ReadScalar(&scratch_) || scratch_.empty() )
+        return false;
+
+    // The string read is handed over rather than copied.
+    to_set->swap(scratch_);
+    return true;
+}
+
+void api::JsonReader::Skip()
+{
+    SkipValue();
+}
+
+bool api::JsonReader::Finish()
+{
+    if (failed_)
+        return false;
+
+    assert(containers_.empty());
+
+    SkipWhitespace();
+
+    if (position_ != end_)
+        SetError("unexpected data after the document");
+
+    return ! failed_;
+}
+
+void api::JsonReader::SkipWhitespace()
+{
+    while (position_ != end_ && IsWhitespace(*position_))
+        ++position_;
+}
+
+bool api::JsonReader::BeginContainer(
+        char open,
+        Container::Type type
+    )
+{
+    if (failed_)
+        return false;
+
+    SkipWhitespace();
+
+    if (position_ != end_ && *position_ == open)
+    {
+        // Fall through
+    }
+    else if (type == Container::Type::Array && position_ != end_
+        && *position_ == '{')
+    {
+        type = Container::Type::ObjectAsArray;
+    }
+    else
+    {
+        SkipValue();
+        return false;
+    }
+
+    if (containers_.size() >= kMaxDepth)
+    {
+        SetError("nesting too deep");
+        return false;
+    }
+
+    ++position_;
+
+    Container container;
+    container.type = type;
+    container.first = true;
+    containers_.push_back(container);
+
+    return true;
+}
+
+bool api::JsonReader::NextEntry()
+{
+    if (failed_)
+        return false;
+
+    Container & container = containers_.back();
+    const char close = (container.type == Container::Type::Array) ? ']' : '}';
+
+    SkipWhitespace();
+
+    if (position_ == end_)
+    {
+        SetError("unexpected end of data");
+        return false;
+    }
+
+    if (*position_ == close)
+    {
+        ++position_;
+        containers_.pop_back();
+        return false;
+    }
+
+    if (container.first)
+    {
+        container.first = false;
+    }
+    else if (*position_ == ',')
+    {
+        ++position_;
+    }
+    else
+    {
+        SetError("expected ',' or end of container");
+        return false;
+    }
+
+    return true;
+}
+
+bool api::JsonReader::ReadKey(std::string * key)
+{
+    SkipWhitespace();
+
+    if (position_ == end_ || *position_ != '"')
+    {
+        SetError("expected member name");
+        return false;
+    }
+
+    if ( ! ReadString(key) )
+        return false;
+
+    SkipWhitespace();
+
+    if (position_ == end_ || *position_ != ':')
+    {
+        SetError("expected ':'");
+        return false;
+    }
+
+    ++position_;
+    return true;
+}
+
+bool api::JsonReader::ReadString(std::string * text)
+{
+    assert(*position_ == '"');
+    ++position_;
+
+    if (text)
+        text->clear();
+
+    for (;;)
+    {
+        // Copy runs of plain characters at once.
+        const char * run = position_;
+        while (position_ != end_ && *position_ != '"' && *position_ != '\\'
+            && static_cast<unsigned char>(*position_) >= 0x20)
+            ++position_;
+
+        if (text)
+            text->append(run, position_);
+
+        if (position_ == end_)
+        {
+            SetError("unterminated string");
+            return false;
+        }
+
+        const char c = *position_++;
+
+        if (c == '"')
+            return true;
+
+        if (c != '\\')
+        {
+            SetError("control character in string");
+            return false;
+        }
+
+        if (position_ == end_)
+        {
+            SetError("unterminated string");
+            return false;
+        }
+
+        const char escape = *position_++;
+        char unescaped = 0;
+
+        switch (escape)
+        {
+            case '"':
+            case '\\':
+            case '/':
+                unescaped = escape;
+                break;
+            case 'b':
+                unescaped = '\b';
+                break;
+            case 'f':
+                unescaped = '\f';
+                break;
+            case 'n':
+                unescaped = '\n';
+                break;
+            case 'r':
+                unescaped = '\r';
+                break;
+            case 't':
+                unescaped = '\t';
+                break;
+            case 'u':
+            {
+                uint32_t code_point = 0;
+                if ( ! ReadHex4(&code_point) )
+                    return false;
+
+                // Join surrogate pairs.
+                if (code_point >= 0xD800 && code_point <= 0xDBFF
+                    && end_ - position_ >= 6
+                    && position_[0] == '\\' && position_[1] == 'u')
+                {
+                    const char * high_end = position_;
+                    position_ += 2;
+
+                    uint32_t low = 0;
+                    if ( ! ReadHex4(&low) )
+                        return false;
+
+                    if (low >= 0xDC00 && low <= 0xDFFF)
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10)
+                            + (low - 0xDC00);
+                    else
+                        position_ = high_end;
+                }
+
+                if (text)
+                    AppendUtf8(code_point, text);
+                continue;
+            }
+            default:
+                SetError("invalid escape in string");
+                return false;
+        }
+
+        if (text)
+            text->push_back(unescaped);
+    }
+}
+
+bool api::JsonReader::ReadHex4(uint32_t * code_point)
+{
+    if (end_ - position_ < 4)
+    {
+        SetError("invalid unicode escape");
+        return false;
+    }
+
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const char c = *position_++;
+        value <<= 4;
+
+        if (IsDigit(c))
+            value |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            value |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            value |= static_cast<uint32_t>(c - 'A' + 10);
+        else
+        {
+            SetError("invalid unicode escape");
+            return false;
+        }
+    }
+
+    *code_point = value;
+    return true;
+}
+
+bool api::JsonReader::ReadLiteral(std::string * text)
+{
+    const char * start = position_;
+
+    static const char * const words[] = {"true", "false", "null"};
+
+    bool matched_word = false;
+    for (const char * word : words)
+    {
+        const std::size_t length = std::strlen(word);
+        if (static_cast<std::size_t>(end_ - position_) >= length
+            && std::equal(word, word + length, position_))
+        {
+            position_ += length;
+            matched_word = true;
+            break;
+        }
+    }
+
+    if ( ! matched_word && ! ReadNumber() )
+        return false;
+
+    if (text)
+        text->assign(start, position_);
+
+    return true;
+}
+
+bool api::JsonReader::ReadNumber()
+{
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    if (position_ != end_ && *position_ == '-')
+        ++position_;
+
+    if (position_ == end_ || ! IsDigit(*position_))
+    {
+        SetError("expected value");
+        return false;
+    }
+
+    if (*position_ == '0')
+    {
+        ++position_;
+    }
+    else
+    {
+        while (position_ != end_ && IsDigit(*position_))
+            ++position_;
+    }
+
+    if (position_ != end_ && *position_ == '.')
+    {
+        ++position_;
+        if (position_ == end_ || ! IsDigit(*position_))
+        {
+            SetError("expected digits after decimal point");
+            return false;
+        }
+        while (position_ != end_ && IsDigit(*position_))
+            ++position_;
+    }
+
+    if (position_ != end_ && (*position_ == 'e' || *position_ == 'E'))
+    {
+        ++position_;
+        if (position_ != end_ && (*position_ == '+' || *position_ == '-'))
+            ++position_;
+        if (position_ == end_ || ! IsDigit(*position_))
+        {
+            SetError("expected digits in exponent");
+            return false;
+        }
+        while (position_ != end_ && IsDigit(*position_))
+            ++position_;
+    }
+
+    return true;
+}
+
+void api::JsonReader::SkipValue()
+{
+    if (failed_)
+        return;
+
+    SkipWhitespace();
+
+    if (position_ == end_)
+    {
+        SetError("expected value");
+        return;
+    }
+
+    switch (*position_)
+    {
+        case '{':
+            if ( BeginContainer('{', Container::Type::Object) )
+            {
+                while ( NextEntry() && ReadKey(nullptr) )
+                    SkipValue();
+            }
+            break;
+        case '[':
+            if ( BeginContainer('[', Container::Type::Array) )
+            {
+                while ( NextEntry() )
+                    SkipValue();
+            }
+            break;
+        case '"':
+            ReadString(nullptr);
+            break;
+        default:
+            ReadLiteral(nullptr);
+            break;
+    }
+}
+
+void api::JsonReader::SetError(const char * message)
+{
+    if (failed_)
+        return;
+
+    failed_ = true;
+
+    const auto line = std::count(begin_, position_, '\n') + 1;
+    error_string_ = "JSON line " + mf::utils::to_string(line) + ": " + message;
+}
+
+bool api::ConvertJsonValue(
+        const std::string & text,
+        std::string * to_set
+    )
+{
+    if (text.empty())
+        return false;
+
+    *to_set = text;
+    return true;
+}
+
+bool api::ConvertJsonValue(
+        const std::string & text,
+        boost::posix_time::ptime * to_set
+    )
+{
+    if ( ! text.empty() )
+    {
+        try {
+            *to_set = boost::posix_time::time_from_string(text);
+            if (*to_set != boost::date_time::not_a_date_time)
+            {
+                // Server returns time in CST - s23283
+                typedef boost::date_time::local_adjustor<
+                    boost::posix_time::ptime,
+                    -6,
+                    boost::posix_time::us_dst>
+                        us_central;
+
+                *to_set = us_central::local_to_utc(*to_set);
+
+                return true;
+            }
+            // else fallthrough
+        }
+        catch (std::out_of_range const& e) {}
+        catch (boost::bad_lexical_cast const& e) {}
+
+        // Server returns time in CST, but hopefully not forever
+        try {
+            *to_set = boost::posix_time::from_iso_string(text);
+            if (*to_set != boost::date_time::not_a_date_time)
+                return true;
+            // else fallthrough
+        }
+        catch (std::out_of_range const& e) {}
+        catch (boost::bad_lexical_cast const& e) {}
+    }
+
+    *to_set = boost::date_time::not_a_date_time;
+    return false;
+}
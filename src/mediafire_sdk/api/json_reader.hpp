@@ -0,0 +1,313 @@
+/**
+ * @file json_reader.hpp
+ * @author Herbert Jones
+ * @brief Streaming reader for API JSON responses.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "boost/date_time/posix_time/posix_time.hpp"
+
+namespace mf {
+namespace api {
+
+/**
+ * @brief Convert JSON value text to an integer.
+ *
+ * @param[in] text Text of the value.
+ * @param[out] to_set Only modified if text is an integer in range.
+ *
+ * @return True if to_set was set.
+ */
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, bool>::type
+ConvertJsonValue(
+        const std::string & text,
+        T * to_set
+    )
+{
+    auto it = text.begin();
+    auto end = text.end();
+
+    // Whitespace is allowed around the number, as when streamed.
+    while (it != end && (*it == ' ' || *it == '\t' || *it == '\n'
+        || *it == '\r'))
+        ++it;
+    while (it != end && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n'
+        || end[-1] == '\r'))
+        --end;
+
+    bool negative = false;
+    if (it != end && (*it == '-' || *it == '+'))
+    {
+        negative = (*it == '-');
+        ++it;
+    }
+
+    if (it == end || (negative && ! std::is_signed<T>::value))
+        return false;
+
+    // Accumulate the magnitude, which for the most negative value is one more
+    // than the maximum.
+    const uint64_t limit = static_cast<uint64_t>(
+        std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+
+    uint64_t magnitude = 0;
+    for (; it != end; ++it)
+    {
+        if (*it < '0' || *it > '9')
+            return false;
+
+        const uint64_t digit = static_cast<uint64_t>(*it - '0');
+        if (magnitude > (limit - digit) / 10)
+            return false;
+
+        magnitude = magnitude * 10 + digit;
+    }
+
+    if (negative)
+        *to_set = static_cast<T>(-static_cast<int64_t>(magnitude - 1) - 1);
+    else
+        *to_set = static_cast<T>(magnitude);
+
+    return true;
+}
+
+/**
+ * @brief Convert JSON value text to a string.
+ *
+ * @param[in] text Text of the value.
+ * @param[out] to_set Only modified if text is not empty.
+ *
+ * @return True if to_set was set.
+ */
+bool ConvertJsonValue(
+        const std::string & text,
+        std::string * to_set
+    );
+
+/**
+ * @brief Convert JSON value text to a time.
+ *
+ * The API sends times as "YYYY-MM-DD HH:MM:SS" in US central time, which is
+ * converted to UTC.  ISO formatted times are taken as is.
+ *
+ * @param[in] text Text of the value.
+ * @param[out] to_set Set to not_a_date_time if text is not a time.
+ *
+ * @return True if text was a time.
+ */
+bool ConvertJsonValue(
+        const std::string & text,
+        boost::posix_time::ptime * to_set
+    );
+
+/**
+ * @class JsonReader
+ * @brief Reads a JSON document value by value, straight from its UTF-8 bytes.
+ *
+ * Nothing is stored but the value being read, which makes it much cheaper than
+ * reading the document into a boost::property_tree::wptree.  The reader is
+ * positioned before a value.  Every value must be consumed by exactly one of
+ * BeginObject, BeginArray, ReadScalar, ReadValue or Skip.
+ *
+ * Example reading {"response":{"result":"Success"}}:
+ * @code
+ * JsonReader reader(content);
+ * std::string key, response_key, result;
+ * if ( reader.BeginObject() )
+ * {
+ *     while ( reader.NextMember(&key) )
+ *     {
+ *         if ( key != "response" || ! reader.BeginObject() )
+ *         {
+ *             reader.Skip();
+ *             continue;
+ *         }
+ *         while ( reader.NextMember(&response_key) )
+ *         {
+ *             if ( response_key == "result" )
+ *                 reader.ReadValue(&result);
+ *             else
+ *                 reader.Skip();
+ *         }
+ *     }
+ * }
+ * bool well_formed = reader.Finish();
+ * @endcode
+ *
+ * Once the document is found to be malformed every call fails, so loops end
+ * early and Finish returns false.
+ */
+class JsonReader
+{
+public:
+    /**
+     * @brief CTOR
+     *
+     * @param[in] content The JSON document.  Must outlive the reader.
+     */
+    explicit JsonReader(const std::string & content);
+
+    /**
+     * @brief Enter the next value if it is an object.
+     *
+     * Other values are skipped.
+     *
+     * @return True if an object was entered.  NextMember must then be called
+     *         until it returns false.
+     */
+    bool BeginObject();
+
+    /**
+     * @brief Move to the value of the next member of the current object.
+     *
+     * @param[out] key The member name.
+     *
+     * @return False once the object has ended, which also leaves it.
+     */
+    bool NextMember(std::string * key);
+
+    /**
+     * @brief Enter the next value if it is an array.
+     *
+     * Objects are entered too and their member values read as the elements,
+     * matching how a property tree iterates them.  Other values are skipped.
+     *
+     * @return True if a container was entered.  NextElement must then be
+     *         called until it returns false.
+     */
+    bool BeginArray();
+
+    /**
+     * @brief Move to the next element of the current array.
+     *
+     * @return False once the array has ended, which also leaves it.
+     */
+    bool NextElement();
+
+    /**
+     * @brief Read the next value as text if it is not an object or an array.
+     *
+     * Strings are unescaped.  Numbers and the literals true, false and null
+     * are returned as written, which is how a property tree stores them.
+     * Objects and arrays are skipped.
+     *
+     * @param[out] text The value.
+     *
+     * @return True if a value was read.
+     */
+    bool ReadScalar(std::string * text);
+
+    /**
+     * @brief Read the next value and convert it.
+     *
+     * The conversions match GetIfExists from ptree_helpers.hpp.  Strings must
+     * not be empty.
+     *
+     * @param[out] to_set Only modified if the value converted.
+     *
+     * @return True if to_set was set.
+     */
+    template<typename T>
+    bool ReadValue(T * to_set)
+    {
+        return ReadScalar(&scratch_) && ConvertJsonValue(scratch_, to_set);
+    }
+
+    /**
+     * @brief Read the next value if it is a non empty string.
+     *
+     * @param[out] to_set Only modified if the value is not empty.
+     *
+     * @return True if to_set was set.
+     */
+    bool ReadValue(std::string * to_set);
+
+    /**
+     * @brief Read the first element of the next value if it is an array.
+     *
+     * The counterpart of GetIfExistsArrayFront from ptree_helpers.hpp.  The
+     * rest of the value is skipped.
+     *
+     * @param[out] to_set Only modified if the first element converted.
+     *
+     * @return True if to_set was set.
+     */
+    template<typename T>
+    bool ReadArrayFront(T * to_set)
+    {
+        bool set = false;
+
+        if ( BeginArray() && NextElement() )
+        {
+            set = ReadValue(to_set);
+
+            while ( NextElement() )
+                Skip();
+        }
+
+        return set;
+    }
+
+    /** Skip the next value. */
+    void Skip();
+
+    /**
+     * @brief Check that nothing but whitespace follows the document.
+     *
+     * @return True if the whole document was well formed.
+     */
+    bool Finish();
+
+    /** True once the document was found to be malformed. */
+    bool Failed() const {return failed_;}
+
+    /** Description of why the document is malformed. */
+    const std::string & ErrorString() const {return error_string_;}
+
+private:
+    struct Container
+    {
+        enum class Type
+        {
+            Object,
+            Array,
+            ObjectAsArray
+        } type;
+
+        bool first;
+    };
+
+    void SkipWhitespace();
+    bool BeginContainer(char open, Container::Type type);
+    bool NextEntry();
+    bool ReadKey(std::string * key);
+    bool ReadString(std::string * text);
+    bool ReadHex4(uint32_t * code_point);
+    bool ReadLiteral(std::string * text);
+    bool ReadNumber();
+    void SkipValue();
+    void SetError(const char * message);
+
+    const char * const begin_;
+    const char * position_;
+    const char * const end_;
+
+    std::vector<Container> containers_;
+
+    bool failed_;
+    std::string error_string_;
+
+    std::string scratch_;
+};
+
+}  // namespace api
+}  // namespace mf
@@ -9,7 +9,8 @@
 #include <string>
 
 #include "boost/algorithm/string/predicate.hpp"  // iequals
-#include "boost/date_time/local_time_adjustor.hpp"
+
+#include "mediafire_sdk/api/json_reader.hpp"
 
 namespace api = mf::api;
 
@@ -59,41 +60,8 @@ bool api::GetIfExists(
 
     boost::optional<std::wstring> result =
         pt.get_optional<std::wstring>(property_path_w);
-    if ( result && ! result->empty() )
-    {
-        try {
-            *to_set = boost::posix_time::time_from_string(
-                mf::utils::wide_to_bytes(*result));
-            if (*to_set != boost::date_time::not_a_date_time)
-            {
-                // Server returns time in CST - s23283
-                typedef boost::date_time::local_adjustor<
-                    boost::posix_time::ptime,
-                    -6,
-                    boost::posix_time::us_dst>
-                        us_central;
-
-                *to_set = us_central::local_to_utc(*to_set);
-
-                return true;
-            }
-            // else fallthrough
-        }
-        catch (std::out_of_range const& e) {}
-        catch (boost::bad_lexical_cast const& e) {}
-
-        // Server returns time in CST, but hopefully not forever
-        try {
-            *to_set = boost::posix_time::from_iso_string(
-                mf::utils::wide_to_bytes(*result));
-            if (*to_set != boost::date_time::not_a_date_time)
-                return true;
-            // else fallthrough
-        }
-        catch (std::out_of_range const& e) {}
-        catch (boost::bad_lexical_cast const& e) {}
-
-    }
+    if ( result )
+        return ConvertJsonValue(mf::utils::wide_to_bytes(*result), to_set);
 
     *to_set = boost::date_time::not_a_date_time;
     return false;
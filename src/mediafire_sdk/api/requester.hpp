@@ -61,11 +61,62 @@ public:
             std::string hostname
             ) :
         http_config_(http_config),
-        hostname_(hostname)
+        hostname_(hostname),
+        diagnostics_level_(DiagnosticsLevel::Full),
+        response_parser_(ResponseParser::Streaming)
     {}
 
     virtual ~Requester() {}
 
+    /**
+     * @brief Set how much debug information responses collect.
+     *
+     * With DiagnosticsLevel::Full, the default, every response copies its
+     * content into ResponseBase::plaintext and builds ResponseBase::debug,
+     * including the JSON formatted again.  Large responses pay for that
+     * several times over.  With DiagnosticsLevel::ErrorsOnly, this is only
+     * done once a response is found to be an error, and with
+     * DiagnosticsLevel::Off it is never done.  Applies to requests made after
+     * this call.
+     *
+     * @param[in] diagnostics_level The new diagnostics level.
+     */
+    void SetDiagnosticsLevel(DiagnosticsLevel diagnostics_level)
+    {
+        diagnostics_level_ = diagnostics_level;
+    }
+
+    /**
+     * @brief Get how much debug information responses collect.
+     *
+     * @return The diagnostics level.
+     */
+    DiagnosticsLevel GetDiagnosticsLevel() const {return diagnostics_level_;}
+
+    /**
+     * @brief Set how responses are parsed.
+     *
+     * With ResponseParser::Streaming, the default, API requests that support
+     * it fill their response straight from the JSON, which needs a fraction of
+     * the time and memory of ResponseParser::PropertyTree.  Their
+     * ResponseBase::pt then only holds the response envelope.  The property
+     * tree parser remains for requests that need the whole tree and to verify
+     * the streaming parser against.  Applies to requests made after this call.
+     *
+     * @param[in] response_parser The new response parser.
+     */
+    void SetResponseParser(ResponseParser response_parser)
+    {
+        response_parser_ = response_parser;
+    }
+
+    /**
+     * @brief Get how responses are parsed.
+     *
+     * @return The response parser.
+     */
+    ResponseParser GetResponseParser() const {return response_parser_;}
+
     /**
      * @brief Request an API call to be performed.
      *
@@ -151,7 +202,9 @@ public:
                     response_promise.set_value(response);
                 },
                 http_config_->GetWorkIoService(),
-                hostname_));
+                hostname_,
+                diagnostics_level_,
+                response_parser_));
 
         wrapper->Init(RequestStarted::Yes);
 
@@ -185,7 +238,9 @@ public:
                 af,
                 cb,
                 callback_ios,
-                hostname_));
+                hostname_,
+                diagnostics_level_,
+                response_parser_));
 
         // Start the request.
         return wrapper;
@@ -195,6 +250,10 @@ private:
     mf::http::HttpConfig::ConstPointer http_config_;
 
     std::string hostname_;
+
+    DiagnosticsLevel diagnostics_level_;
+
+    ResponseParser response_parser_;
 };
 
 }  // namespace api
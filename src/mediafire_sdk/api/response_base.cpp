@@ -9,6 +9,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 
@@ -16,6 +17,21 @@
 
 namespace api = mf::api;
 
+namespace {
+void AppendFormattedJson(
+        const boost::property_tree::wptree & pt,
+        std::string * debug
+    )
+{
+    std::wostringstream ss;
+    boost::property_tree::write_json( ss, pt );
+    *debug += "Formatted JSON: ";
+    *debug += mf::utils::wide_to_bytes(ss.str());
+    if (debug->back() != '\n')
+        *debug += "\n";
+}
+}  // namespace
+
 api::ResponseBase::ResponseBase()
 {
 }
@@ -28,37 +44,28 @@ void api::ResponseBase::InitializeWithContent(
         const std::string & request_url,
         const std::string & debug_passthru,
         const mf::http::Headers & headers,
-        const std::string & content
+        const std::string & content,
+        DiagnosticsLevel diagnostics_level
     )
 {
     bool parsing_success = false;
 
     url = request_url;
-    plaintext = content;
 
-    debug += "Url: " + url + "\n";
-    debug += debug_passthru;
-    debug += "Plaintext: " + plaintext + "\n";
-
-    const std::wstring content_wstr = mf::utils::bytes_to_wide(content);
-
-    std::wistringstream istr(content_wstr);
+    if (diagnostics_level == DiagnosticsLevel::Full)
+        AppendRequestDebugText(debug_passthru, content);
 
     try {
+        std::wistringstream istr(mf::utils::bytes_to_wide(content));
+
         boost::property_tree::read_json(
                 istr,  // Input stream
                 pt  // Output object
             );
         parsing_success = true;
 
-        {
-            std::wostringstream ss;
-            boost::property_tree::write_json( ss, pt );
-            debug += "Formatted JSON: ";
-            debug += mf::utils::wide_to_bytes(ss.str());
-            if (debug.back() != '\n')
-                debug += "\n";
-        }
+        if (diagnostics_level == DiagnosticsLevel::Full)
+            AppendFormattedJson(pt, &debug);
     }
     catch ( boost::property_tree::json_parser_error & err )
     {
@@ -67,6 +74,123 @@ void api::ResponseBase::InitializeWithContent(
         error_string = err.what();
     }
 
+    SetErrorFromEnvelope(headers, parsing_success);
+
+    FinishDebugText(debug_passthru, content, diagnostics_level, true);
+}
+
+void api::ResponseBase::InitializeWithReader(
+        const std::string & request_url,
+        const std::string & debug_passthru,
+        const mf::http::Headers & headers,
+        const std::string & content,
+        const std::function<void(JsonReader*)> & read,
+        DiagnosticsLevel diagnostics_level
+    )
+{
+    url = request_url;
+
+    if (diagnostics_level == DiagnosticsLevel::Full)
+        AppendRequestDebugText(debug_passthru, content);
+
+    JsonReader reader(content);
+    read(&reader);
+
+    const bool parsing_success = reader.Finish();
+
+    // Errors in the data read only count if the API reported none.
+    const std::error_code data_error_code = error_code;
+    const boost::optional<std::string> data_error_string = error_string;
+
+    error_code = std::error_code();
+    error_string = boost::none;
+
+    if ( ! parsing_success )
+    {
+        error_code = make_error_code(
+                api::api_code::ContentInvalidFormat );
+        error_string = reader.ErrorString();
+    }
+
+    SetErrorFromEnvelope(headers, parsing_success);
+
+    if ( ! error_code && data_error_code )
+    {
+        error_code = data_error_code;
+        error_string = data_error_string;
+    }
+
+    // The property tree only holds the envelope, so it is not shown.
+    FinishDebugText(debug_passthru, content, diagnostics_level, false);
+}
+
+void api::ResponseBase::ReadEnvelopeMember(
+        const std::string & key,
+        JsonReader * reader
+    )
+{
+    static const char * const envelope_members[] = {
+        "action",
+        "error",
+        "message",
+        "new_key",
+        "result",
+    };
+
+    for (const char * member : envelope_members)
+    {
+        if (key == member)
+        {
+            std::string value;
+            if ( reader->ReadScalar(&value) )
+            {
+                pt.put(L"response." + mf::utils::bytes_to_wide(key),
+                    mf::utils::bytes_to_wide(value));
+            }
+            return;
+        }
+    }
+
+    reader->Skip();
+}
+
+void api::ResponseBase::CaptureDebugText(
+        const std::string & debug_passthru,
+        const std::string & content
+    )
+{
+    AppendRequestDebugText(debug_passthru, content);
+
+    if ( ! pt.empty() )
+        AppendFormattedJson(pt, &debug);
+}
+
+void api::ResponseBase::InitializeWithError(
+        const std::string & request_url,
+        const std::string & debug_passthru,
+        std::error_code ec,
+        const std::string & error_str,
+        DiagnosticsLevel diagnostics_level
+    )
+{
+    url = request_url;
+    error_code = ec;
+    error_string = error_str;
+
+    if (diagnostics_level == DiagnosticsLevel::Off)
+        return;
+
+    debug += "Url: " + url + "\n";
+    debug += debug_passthru;
+    debug += "Error: " + ec.message() + "\n";
+    debug += "Error text: " + error_str + "\n";
+}
+
+void api::ResponseBase::SetErrorFromEnvelope(
+        const mf::http::Headers & headers,
+        bool parsing_success
+    )
+{
     // Check for errors. According to Rabie, any API error will have a non 200
     // HTTP response code.
     if ( headers.status_code != 200 )
@@ -161,6 +285,28 @@ void api::ResponseBase::InitializeWithContent(
             }
         }
     }
+}
+
+void api::ResponseBase::FinishDebugText(
+        const std::string & debug_passthru,
+        const std::string & content,
+        DiagnosticsLevel diagnostics_level,
+        bool formatted_json
+    )
+{
+    if (diagnostics_level == DiagnosticsLevel::Off)
+        return;
+
+    if (diagnostics_level == DiagnosticsLevel::ErrorsOnly)
+    {
+        if ( ! error_code )
+            return;
+
+        if (formatted_json)
+            CaptureDebugText(debug_passthru, content);
+        else
+            AppendRequestDebugText(debug_passthru, content);
+    }
 
     if (error_code)
         debug += "Error: " + error_code.message() + "\n";
@@ -172,19 +318,14 @@ void api::ResponseBase::InitializeWithContent(
 #endif
 }
 
-void api::ResponseBase::InitializeWithError(
-        const std::string & request_url,
+void api::ResponseBase::AppendRequestDebugText(
         const std::string & debug_passthru,
-        std::error_code ec,
-        const std::string & error_str
+        const std::string & content
     )
 {
-    url = request_url;
-    error_code = ec;
-    error_string = error_str;
+    plaintext = content;
 
     debug += "Url: " + url + "\n";
     debug += debug_passthru;
-    debug += "Error: " + ec.message() + "\n";
-    debug += "Error text: " + error_str + "\n";
+    debug += "Plaintext: " + plaintext + "\n";
 }
@@ -7,17 +7,22 @@
  */
 #pragma once
 
+#include <functional>
 #include <string>
 #include <system_error>
 
 #include "boost/optional.hpp"
 #include "boost/property_tree/ptree.hpp"
 
+#include "mediafire_sdk/api/types.hpp"
 #include "mediafire_sdk/http/headers.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 
 namespace mf {
 namespace api {
 
+class JsonReader;
+
 /**
  * @interface ResponseBase
  * @brief Base class for API Response objects.
@@ -34,7 +39,10 @@ public:
     /** Set if API error occurred and had API error message. */
     boost::optional<std::string> api_error_string;
 
-    /** The HTTP content. For debugging. */
+    /**
+     * The HTTP content. For debugging.  Only set when the diagnostics level
+     * asks for it.
+     */
     std::string plaintext;
 
     /**
@@ -43,13 +51,25 @@ public:
      * @warning:  property_tree doesn't correctly parse unicode when using
      * std::string as a base.  Wstring used to be able to parse unicode
      * characters.
+     *
+     * When read with ResponseParser::Streaming, only holds the scalar members
+     * of the response envelope: action, error, message, new_key and result.
      */
     boost::property_tree::wptree pt;
 
     /** The url used to make the request. */
     std::string url;
 
-    /** Useful debug information */
+    /**
+     * When each phase of the HTTP request began and ended.  Only set for
+     * requests made through a Requester or SessionMaintainer.
+     */
+    mf::http::RequestTimings timings;
+
+    /**
+     * Useful debug information.  Only set when the diagnostics level asks for
+     * it.
+     */
     std::string debug;
 
     /**
@@ -60,6 +80,7 @@ public:
      * @param[in] debug Debug data to pass to debug member variable
      * @param[in] headers Http response headers
      * @param[in] content JSON encoded data from the remote server.
+     * @param[in] diagnostics_level When to fill plaintext and debug.
      *
      * The error_code will be set if an error occurred while parsing the
      * content.
@@ -68,7 +89,44 @@ public:
             const std::string & request_url,
             const std::string & debug,
             const mf::http::Headers & headers,
-            const std::string & content
+            const std::string & content,
+            DiagnosticsLevel diagnostics_level = DiagnosticsLevel::Full
+        );
+
+    /**
+     * @brief Initializer when content was received from the server with no
+     * errors, reading it with a JsonReader rather than into pt.
+     *
+     * @param[in] request_url Request url
+     * @param[in] debug Debug data to pass to debug member variable
+     * @param[in] headers Http response headers
+     * @param[in] content JSON encoded data from the remote server.
+     * @param[in] read Reads the whole document, filling the derived response
+     *                 and calling ReadEnvelopeMember for the members of
+     *                 "response" it does not know.
+     * @param[in] diagnostics_level When to fill plaintext and debug.
+     *
+     * Errors reported by the API take precedence over errors set by read.
+     */
+    void InitializeWithReader(
+            const std::string & request_url,
+            const std::string & debug,
+            const mf::http::Headers & headers,
+            const std::string & content,
+            const std::function<void(JsonReader*)> & read,
+            DiagnosticsLevel diagnostics_level = DiagnosticsLevel::Full
+        );
+
+    /**
+     * @brief Read a member of the "response" object into pt if the error
+     * handling needs it, else skip it.
+     *
+     * @param[in] key The member name.
+     * @param[in] reader Positioned at the member value.
+     */
+    void ReadEnvelopeMember(
+            const std::string & key,
+            JsonReader * reader
         );
 
     /**
@@ -78,12 +136,28 @@ public:
      * @param[in] debug Debug data to pass to debug member variable
      * @param[in] ec Error code passed from the HTTP request object.
      * @param[in] error_str Error text passed from the HTTP request object.
+     * @param[in] diagnostics_level When to fill debug.
      */
     void InitializeWithError(
             const std::string & request_url,
             const std::string & debug,
             std::error_code ec,
-            const std::string & error_str
+            const std::string & error_str,
+            DiagnosticsLevel diagnostics_level = DiagnosticsLevel::Full
+        );
+
+    /**
+     * @brief Fill plaintext and debug from the content of the response.
+     *
+     * For responses initialized with DiagnosticsLevel::ErrorsOnly that are
+     * found to be errors only after initialization.
+     *
+     * @param[in] debug Debug data to pass to debug member variable
+     * @param[in] content JSON encoded data from the remote server.
+     */
+    void CaptureDebugText(
+            const std::string & debug,
+            const std::string & content
         );
 
     /**
@@ -92,6 +166,24 @@ public:
     ResponseBase();
 
     virtual ~ResponseBase();
+
+private:
+    void AppendRequestDebugText(
+            const std::string & debug,
+            const std::string & content
+        );
+
+    void SetErrorFromEnvelope(
+            const mf::http::Headers & headers,
+            bool parsing_success
+        );
+
+    void FinishDebugText(
+            const std::string & debug,
+            const std::string & content,
+            DiagnosticsLevel diagnostics_level,
+            bool formatted_json
+        );
 };
 
 }  // namespace api
@@ -579,7 +579,10 @@ ConnectionState SessionMaintainer::GetConnectionState()
 
 void SessionMaintainer::SetConnectionState(const ConnectionState & state)
 {
-    return locker_->SetConnectionState(state);
+    // Addresses resolved, or failed to resolve, before the network changed
+    // can not be trusted.
+    if (locker_->SetConnectionState(state))
+        http_config_->FlushDnsCache();
 }
 
 void SessionMaintainer::SetSessionStateChangeCallback(
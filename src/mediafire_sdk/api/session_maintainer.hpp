@@ -205,6 +205,52 @@ public:
         timeout_seconds_ = timeout_seconds;
     }
 
+    /**
+     * @brief Set how much debug information responses collect.
+     *
+     * See Requester::SetDiagnosticsLevel.  The default is
+     * DiagnosticsLevel::Full.
+     *
+     * @param[in] diagnostics_level The new diagnostics level.
+     */
+    void SetDiagnosticsLevel(DiagnosticsLevel diagnostics_level)
+    {
+        requester_.SetDiagnosticsLevel(diagnostics_level);
+    }
+
+    /**
+     * @brief Get how much debug information responses collect.
+     *
+     * @return The diagnostics level.
+     */
+    DiagnosticsLevel GetDiagnosticsLevel() const
+    {
+        return requester_.GetDiagnosticsLevel();
+    }
+
+    /**
+     * @brief Set how responses are parsed.
+     *
+     * See Requester::SetResponseParser.  The default is
+     * ResponseParser::Streaming.
+     *
+     * @param[in] response_parser The new response parser.
+     */
+    void SetResponseParser(ResponseParser response_parser)
+    {
+        requester_.SetResponseParser(response_parser);
+    }
+
+    /**
+     * @brief Get how responses are parsed.
+     *
+     * @return The response parser.
+     */
+    ResponseParser GetResponseParser() const
+    {
+        return requester_.GetResponseParser();
+    }
+
     /**
      * @brief Stop all io_service timeouts so io_service::run can return as soon
      * as there is no longer any work to perform.
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/tokenless_api_base.hpp"
@@ -45,6 +46,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::api::RequestMethod GetRequestMethod() const
     {
         return mf::api::RequestMethod::Get;
@@ -112,6 +120,93 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_editable_extensions = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "editable" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_editable_key;
+                                while ( reader->NextMember(&response_editable_key) )
+                                {
+                                    if ( response_editable_key == "extensions" )
+                                    {
+                                        // create_content_read_array TArray
+                                        has_editable_extensions = true;
+                                        if ( reader->BeginArray() )
+                                        {
+                                            bool skip_rest = false;
+                                            while ( reader->NextElement() )
+                                            {
+                                                std::string result;
+                                                if ( skip_rest )
+                                                    reader->Skip();
+                                                else if ( reader->ReadValue(&result) )
+                                                    response->editable_extensions.push_back(std::move(result));
+                                                else
+                                                {
+                                                    set_error(
+                                                        mf::api::api_code::ContentInvalidData,
+                                                        "invalid value in response.editable.extensions");
+                                                    skip_rest = true;
+                                                }
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_editable_extensions )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.editable.extensions\"");
+    }
+    else if ( response->editable_extensions.empty() )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing value in response.editable.extensions");
+    }
+
+#   undef set_error
+}
+
 // Request ---------------------------------------------------------------------
 
 Request::Request() :
@@ -124,6 +219,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
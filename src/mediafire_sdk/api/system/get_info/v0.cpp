@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/tokenless_api_base.hpp"
@@ -123,6 +124,162 @@ bool TermsOfServiceFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool ImageSizeFromJsonReader(
+        Response * response,
+        Response::ImageSize * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_width = false;
+    bool has_height = false;
+    bool has_thumbnail_designation = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "width" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->width) )
+                    has_width = true;
+            }
+            else if ( key == "height" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->height) )
+                    has_height = true;
+            }
+            else if ( key == "thumbnail" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->thumbnail_designation) )
+                    has_thumbnail_designation = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_width )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"width\"");
+    }
+
+    if ( ! has_height )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"height\"");
+    }
+
+    if ( ! has_thumbnail_designation )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"thumbnail\"");
+    }
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool TermsOfServiceFromJsonReader(
+        Response * response,
+        Response::TermsOfService * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_revision = false;
+    bool has_terms = false;
+    bool has_date = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "revision" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->revision) )
+                    has_revision = true;
+            }
+            else if ( key == "terms" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->terms) )
+                    has_terms = true;
+            }
+            else if ( key == "date" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->date) )
+                    has_date = true;
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"revision\"");
+    }
+
+    if ( ! has_terms )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"terms\"");
+    }
+
+    if ( ! has_date )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"date\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -148,6 +305,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::api::RequestMethod GetRequestMethod() const
     {
         return mf::api::RequestMethod::Get;
@@ -360,6 +532,300 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_current_api_version = false;
+    bool has_timezone = false;
+    bool has_timezone_offset = false;
+    bool has_viewable_extensions = false;
+    bool has_editable_extensions = false;
+    bool has_image_sizes = false;
+    bool has_terms_of_service = false;
+    bool has_max_keys = false;
+    bool has_max_objects = false;
+    bool has_max_image_size = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "current_api_version" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->current_api_version) )
+                                has_current_api_version = true;
+                        }
+                        else if ( response_key == "timezone" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->timezone) )
+                                has_timezone = true;
+                        }
+                        else if ( response_key == "timezone_offset" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->timezone_offset) )
+                                has_timezone_offset = true;
+                        }
+                        else if ( response_key == "viewable" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_viewable_key;
+                                while ( reader->NextMember(&response_viewable_key) )
+                                {
+                                    if ( response_viewable_key == "extensions" )
+                                    {
+                                        // create_content_read_array TArray
+                                        has_viewable_extensions = true;
+                                        if ( reader->BeginArray() )
+                                        {
+                                            bool skip_rest = false;
+                                            while ( reader->NextElement() )
+                                            {
+                                                std::string result;
+                                                if ( skip_rest )
+                                                    reader->Skip();
+                                                else if ( reader->ReadValue(&result) )
+                                                    response->viewable_extensions.push_back(std::move(result));
+                                                else
+                                                {
+                                                    set_error(
+                                                        mf::api::api_code::ContentInvalidData,
+                                                        "invalid value in response.viewable.extensions");
+                                                    skip_rest = true;
+                                                }
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else if ( response_key == "editable" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_editable_key;
+                                while ( reader->NextMember(&response_editable_key) )
+                                {
+                                    if ( response_editable_key == "extensions" )
+                                    {
+                                        // create_content_read_array TArray
+                                        has_editable_extensions = true;
+                                        if ( reader->BeginArray() )
+                                        {
+                                            bool skip_rest = false;
+                                            while ( reader->NextElement() )
+                                            {
+                                                std::string result;
+                                                if ( skip_rest )
+                                                    reader->Skip();
+                                                else if ( reader->ReadValue(&result) )
+                                                    response->editable_extensions.push_back(std::move(result));
+                                                else
+                                                {
+                                                    set_error(
+                                                        mf::api::api_code::ContentInvalidData,
+                                                        "invalid value in response.editable.extensions");
+                                                    skip_rest = true;
+                                                }
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else if ( response_key == "image_sizes" )
+                        {
+                            // create_content_struct_read TArray
+                            has_image_sizes = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    Response::ImageSize optarg;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( ImageSizeFromJsonReader(response, &optarg, reader) )
+                                        response->image_sizes.push_back(std::move(optarg));
+                                    else
+                                        skip_rest = true;  // error set already
+                                }
+                            }
+                        }
+                        else if ( response_key == "terms_of_service" )
+                        {
+                            // create_content_struct_read TSingle
+                            Response::TermsOfService optarg;
+                            if ( TermsOfServiceFromJsonReader(response, &optarg, reader) )
+                            {
+                                response->terms_of_service = std::move(optarg);
+                                has_terms_of_service = true;
+                            }
+                        }
+                        else if ( response_key == "max_keys" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->max_keys) )
+                                has_max_keys = true;
+                        }
+                        else if ( response_key == "max_objects" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->max_objects) )
+                                has_max_objects = true;
+                        }
+                        else if ( response_key == "max_image_size" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->max_image_size) )
+                                has_max_image_size = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_current_api_version )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.current_api_version\"");
+    }
+
+    if ( ! has_timezone )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.timezone\"");
+    }
+
+    if ( ! has_timezone_offset )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.timezone_offset\"");
+    }
+
+    if ( ! has_viewable_extensions )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.viewable.extensions\"");
+    }
+    else if ( response->viewable_extensions.empty() )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing value in response.viewable.extensions");
+    }
+
+    if ( ! has_editable_extensions )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.editable.extensions\"");
+    }
+    else if ( response->editable_extensions.empty() )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing value in response.editable.extensions");
+    }
+
+    if ( ! has_image_sizes )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.image_sizes\"");
+    }
+
+    if ( ! has_terms_of_service )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.terms_of_service\"");
+    }
+
+    if ( ! has_max_keys )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.max_keys\"");
+    }
+
+    if ( ! has_max_objects )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.max_objects\"");
+    }
+
+    if ( ! has_max_image_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.max_image_size\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.image_sizes",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.image_sizes
+        {
+            Response::ImageSize optarg;
+            if ( ImageSizeFromJsonReader(response, &optarg, reader) )
+                response->image_sizes.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 // Request ---------------------------------------------------------------------
 
 Request::Request() :
@@ -372,6 +838,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -395,6 +876,20 @@ std::string Request::Url(const std::string & hostname) const
     return impl_->Url(hostname);
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 }  // namespace v0
 }  // namespace get_info
 }  // namespace system
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/tokenless_api_base.hpp"
@@ -45,6 +46,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::api::RequestMethod GetRequestMethod() const
     {
         return mf::api::RequestMethod::Get;
@@ -165,6 +173,195 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_max_objects = false;
+    bool has_max_keys = false;
+    bool has_max_image_size = false;
+    bool has_zip_max_filesize = false;
+    bool has_zip_max_total_filesize = false;
+    bool has_folder_content_chunk_size = false;
+    bool has_folder_depth_limit = false;
+    bool has_limit_search_results = false;
+    bool has_daily_shares_limit = false;
+    bool has_device_changes_list_limit = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "limits" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_limits_key;
+                                while ( reader->NextMember(&response_limits_key) )
+                                {
+                                    if ( response_limits_key == "max_objects" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->max_objects) )
+                                            has_max_objects = true;
+                                    }
+                                    else if ( response_limits_key == "max_keys" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->max_keys) )
+                                            has_max_keys = true;
+                                    }
+                                    else if ( response_limits_key == "max_image_size" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->max_image_size) )
+                                            has_max_image_size = true;
+                                    }
+                                    else if ( response_limits_key == "zip_max_filesize" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->zip_max_filesize) )
+                                            has_zip_max_filesize = true;
+                                    }
+                                    else if ( response_limits_key == "zip_max_total_filesize" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->zip_max_total_filesize) )
+                                            has_zip_max_total_filesize = true;
+                                    }
+                                    else if ( response_limits_key == "folder_content_chunk_size" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->folder_content_chunk_size) )
+                                            has_folder_content_chunk_size = true;
+                                    }
+                                    else if ( response_limits_key == "folder_depth_limit" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->folder_depth_limit) )
+                                            has_folder_depth_limit = true;
+                                    }
+                                    else if ( response_limits_key == "limit_search_results" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->limit_search_results) )
+                                            has_limit_search_results = true;
+                                    }
+                                    else if ( response_limits_key == "daily_shares_limit" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->daily_shares_limit) )
+                                            has_daily_shares_limit = true;
+                                    }
+                                    else if ( response_limits_key == "device_changes_list_limit" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->device_changes_list_limit) )
+                                            has_device_changes_list_limit = true;
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_max_objects )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.max_objects\"");
+    }
+
+    if ( ! has_max_keys )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.max_keys\"");
+    }
+
+    if ( ! has_max_image_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.max_image_size\"");
+    }
+
+    if ( ! has_zip_max_filesize )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.zip_max_filesize\"");
+    }
+
+    if ( ! has_zip_max_total_filesize )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.zip_max_total_filesize\"");
+    }
+
+    if ( ! has_folder_content_chunk_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.folder_content_chunk_size\"");
+    }
+
+    if ( ! has_folder_depth_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.folder_depth_limit\"");
+    }
+
+    if ( ! has_limit_search_results )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.limit_search_results\"");
+    }
+
+    if ( ! has_daily_shares_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.daily_shares_limit\"");
+    }
+
+    if ( ! has_device_changes_list_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.limits.device_changes_list_limit\"");
+    }
+
+#   undef set_error
+}
+
 // Request ---------------------------------------------------------------------
 
 Request::Request() :
@@ -177,6 +374,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
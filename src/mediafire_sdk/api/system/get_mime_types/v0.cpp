@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/tokenless_api_base.hpp"
@@ -133,6 +134,130 @@ bool MimeTypeFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool MimeTypeFromJsonReader(
+        Response * response,
+        Response::MimeType * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    bool has_mimetype = false;
+    bool has_extension = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "mimetype" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->mimetype) )
+                    has_mimetype = true;
+            }
+            else if ( key == "extension" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->extension) )
+                    has_extension = true;
+            }
+            else if ( key == "type" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "unknown" )
+                        value->category = Category::Unknown;
+                    else if ( optval == "image" )
+                        value->category = Category::Image;
+                    else if ( optval == "video" )
+                        value->category = Category::Video;
+                    else if ( optval == "audio" )
+                        value->category = Category::Audio;
+                    else if ( optval == "document" )
+                        value->category = Category::Document;
+                    else if ( optval == "application" )
+                        value->category = Category::Application;
+                    else if ( optval == "archive" )
+                        value->category = Category::Archive;
+                    else if ( optval == "data" )
+                        value->category = Category::Data;
+                    else if ( optval == "development" )
+                        value->category = Category::Development;
+                    else if ( optval == "spreadsheet" )
+                        value->category = Category::Spreadsheet;
+                    else if ( optval == "presentation" )
+                        value->category = Category::Presentation;
+                }
+            }
+            else if ( key == "view" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->view_system = ViewSystem::None;
+                    else if ( optval == "1" )
+                        value->view_system = ViewSystem::Pdf2html;
+                    else if ( optval == "2" )
+                        value->view_system = ViewSystem::Pdf_js;
+                    else if ( optval == "3" )
+                        value->view_system = ViewSystem::Zoho;
+                }
+            }
+            else if ( key == "edit" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "0" )
+                        value->edit_system = EditSystem::None;
+                    else if ( optval == "1" )
+                        value->edit_system = EditSystem::Ace;
+                    else if ( optval == "2" )
+                        value->edit_system = EditSystem::Zoho;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_mimetype )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"mimetype\"");
+    }
+
+    if ( ! has_extension )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"extension\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -158,6 +283,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::api::RequestMethod GetRequestMethod() const
     {
         return mf::api::RequestMethod::Get;
@@ -213,6 +353,98 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_mimetypes = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "mime_types" )
+                        {
+                            // create_content_struct_read TArray
+                            has_mimetypes = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    Response::MimeType optarg;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( MimeTypeFromJsonReader(response, &optarg, reader) )
+                                        response->mimetypes.push_back(std::move(optarg));
+                                    else
+                                        skip_rest = true;  // error set already
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_mimetypes )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.mime_types\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.mime_types",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.mime_types
+        {
+            Response::MimeType optarg;
+            if ( MimeTypeFromJsonReader(response, &optarg, reader) )
+                response->mimetypes.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 // Request ---------------------------------------------------------------------
 
 Request::Request() :
@@ -225,6 +457,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -248,6 +495,20 @@ std::string Request::Url(const std::string & hostname) const
     return impl_->Url(hostname);
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 }  // namespace v0
 }  // namespace get_mime_types
 }  // namespace system
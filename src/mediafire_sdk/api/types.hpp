@@ -32,6 +32,26 @@ enum class RequestStarted
     Yes,
 };
 
+/** How much debug information API responses collect. */
+enum class DiagnosticsLevel
+{
+    /** Collect no debug information. */
+    Off,
+    /** Collect debug information only for responses with errors. */
+    ErrorsOnly,
+    /** Collect debug information for every response. */
+    Full
+};
+
+/** How API responses are parsed. */
+enum class ResponseParser
+{
+    /** Read the whole document into a property tree, then extract from it. */
+    PropertyTree,
+    /** Fill the response straight from the JSON as it is read. */
+    Streaming
+};
+
 struct SessionTokenData
 {
     std::string session_token;
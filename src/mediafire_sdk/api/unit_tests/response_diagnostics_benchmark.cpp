@@ -0,0 +1,257 @@
+/**
+ * @file response_diagnostics_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Measures the time and peak memory taken to initialize an API response at
+ * each diagnostics level, for a large folder/get_content style listing and for
+ * an API error.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/api/response_base.hpp"
+#include "mediafire_sdk/api/types.hpp"
+
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+
+namespace {
+
+// Allocation tracking.  Each block carries its size in front of it so that
+// operator delete can account for it.
+std::atomic<int64_t> current_bytes(0);
+std::atomic<int64_t> peak_bytes(0);
+
+const std::size_t kHeaderSize = alignof(std::max_align_t);
+
+void * TrackedAllocate(std::size_t size)
+{
+    void * block = std::malloc(size + kHeaderSize);
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *static_cast<std::size_t*>(block) = size;
+
+    const int64_t now = current_bytes += static_cast<int64_t>(size);
+    int64_t peak = peak_bytes.load();
+    while (now > peak && ! peak_bytes.compare_exchange_weak(peak, now))
+        ;
+
+    return static_cast<char*>(block) + kHeaderSize;
+}
+
+void TrackedFree(void * memory)
+{
+    if (memory == nullptr)
+        return;
+
+    void * block = static_cast<char*>(memory) - kHeaderSize;
+    current_bytes -= static_cast<int64_t>(*static_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+}  // namespace
+
+void * operator new(std::size_t size) { return TrackedAllocate(size); }
+void * operator new[](std::size_t size) { return TrackedAllocate(size); }
+void operator delete(void * memory) noexcept { TrackedFree(memory); }
+void operator delete[](void * memory) noexcept { TrackedFree(memory); }
+void operator delete(void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+void operator delete[](void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+namespace {
+
+class Response : public mf::api::ResponseBase {};
+
+std::string CreateListing(uint32_t files)
+{
+    std::ostringstream ss;
+    ss << "{\"response\":{\"action\":\"folder/get_content\","
+        "\"folder_content\":{\"chunk_size\":\"" << files << "\","
+        "\"content_type\":\"files\",\"chunk_number\":\"1\","
+        "\"folderkey\":\"myfiles\",\"files\":[";
+
+    for (uint32_t i = 0; i < files; ++i)
+    {
+        if (i != 0)
+            ss << ",";
+        ss << "{\"quickkey\":\"q" << std::setw(14) << std::setfill('0') << i
+            << "\",\"hash\":\"" << std::string(64, 'a' + (i % 6)) << "\","
+            "\"filename\":\"file " << i << ".txt\","
+            "\"description\":\"\",\"size\":\"" << (i * 977) << "\","
+            "\"privacy\":\"private\",\"created\":\"2014-06-01 12:00:00\","
+            "\"password_protected\":\"no\",\"mimetype\":\"text\\/plain\","
+            "\"filetype\":\"document\",\"view\":\"0\",\"edit\":\"0\","
+            "\"revision\":\"" << i << "\",\"flag\":\"2\","
+            "\"permissions\":{\"value\":\"0\",\"explicit\":\"0\","
+            "\"read\":\"1\",\"write\":\"1\"}}";
+    }
+
+    ss << "],\"more_chunks\":\"no\",\"revision\":\"1\"},"
+        "\"result\":\"Success\",\"current_api_version\":\"1.1\"}}";
+
+    return ss.str();
+}
+
+std::string CreateError()
+{
+    return "{\"response\":{\"action\":\"folder/get_content\","
+        "\"message\":\"The supplied Session Token is expired or invalid\","
+        "\"error\":105,\"result\":\"Error\","
+        "\"current_api_version\":\"1.1\"}}";
+}
+
+struct Measurement
+{
+    double ms_per_response;
+    int64_t peak_bytes;
+    std::size_t debug_bytes;
+};
+
+Measurement Measure(
+        const std::string & content,
+        uint16_t status_code,
+        mf::api::DiagnosticsLevel level,
+        uint32_t repeat
+    )
+{
+    const std::string url = "https://www.mediafire.com/api/1.1/folder/"
+        "get_content.php";
+    const std::string passthru = "Headers: Content-Type: application/json\n";
+
+    mf::http::Headers headers;
+    headers.status_code = status_code;
+
+    Measurement measurement = {0, 0, 0};
+
+    const auto start = sclock::now();
+
+    for (uint32_t i = 0; i < repeat; ++i)
+    {
+        const int64_t base = current_bytes.load();
+        peak_bytes = base;
+
+        {
+            Response response;
+            response.InitializeWithContent(url, passthru, headers, content,
+                level);
+            measurement.debug_bytes = response.debug.size()
+                + response.plaintext.size();
+        }
+
+        measurement.peak_bytes = std::max(measurement.peak_bytes,
+            peak_bytes.load() - base);
+    }
+
+    measurement.ms_per_response = std::chrono::duration<double, std::milli>(
+        sclock::now() - start).count() / repeat;
+
+    return measurement;
+}
+
+void Report(
+        const std::string & name,
+        const std::string & content,
+        uint16_t status_code,
+        uint32_t repeat
+    )
+{
+    struct Level
+    {
+        const char * name;
+        mf::api::DiagnosticsLevel level;
+    };
+
+    const Level levels[] = {
+        {"Off", mf::api::DiagnosticsLevel::Off},
+        {"ErrorsOnly", mf::api::DiagnosticsLevel::ErrorsOnly},
+        {"Full", mf::api::DiagnosticsLevel::Full},
+    };
+
+    std::cout << "\n" << name << " (" << content.size() << " bytes)\n"
+        << std::left << std::setw(12) << "Level"
+        << std::right << std::setw(12) << "ms/resp"
+        << std::setw(14) << "peak KB"
+        << std::setw(14) << "debug KB"
+        << std::endl;
+
+    for (const auto & level : levels)
+    {
+        const auto measurement = Measure(content, status_code, level.level,
+            repeat);
+
+        std::cout << std::left << std::setw(12) << level.name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << measurement.ms_per_response
+            << std::setprecision(1)
+            << std::setw(14) << measurement.peak_bytes / 1024.0
+            << std::setw(14) << measurement.debug_bytes / 1024.0
+            << std::endl;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        uint32_t files = 1000;
+        uint32_t repeat = 20;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("files", po::value<uint32_t>(&files),
+                "Files in the generated listing. (1000)")
+            ("repeat", po::value<uint32_t>(&repeat),
+                "Responses initialized per level. (20)");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        repeat = std::max(1u, repeat);
+
+        Report("folder/get_content listing", CreateListing(files), 200,
+            repeat);
+        Report("API error", CreateError(), 403, repeat * 100);
+
+        return 0;
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "Uncaught exception: " << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        std::cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+}
@@ -0,0 +1,428 @@
+/**
+ * @file response_parser_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Measures the time and peak memory taken to parse folder/get_content and
+ * device/get_changes responses with the property tree parser, with the
+ * generated streaming parser and with the elements delivered in batches while
+ * the content arrives.  The content is received in pieces as from the network,
+ * and is held until complete unless read incrementally.  Payloads are
+ * generated unless captured ones are passed in.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/api/detail/incremental_content_interface.hpp"
+#include "mediafire_sdk/api/device/get_changes.hpp"
+#include "mediafire_sdk/api/folder/get_content.hpp"
+#include "mediafire_sdk/api/types.hpp"
+
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+
+namespace {
+
+// Allocation tracking.  Each block carries its size in front of it so that
+// operator delete can account for it.
+std::atomic<int64_t> current_bytes(0);
+std::atomic<int64_t> peak_bytes(0);
+
+const std::size_t kHeaderSize = alignof(std::max_align_t);
+
+void * TrackedAllocate(std::size_t size)
+{
+    void * block = std::malloc(size + kHeaderSize);
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *static_cast<std::size_t*>(block) = size;
+
+    const int64_t now = current_bytes += static_cast<int64_t>(size);
+    int64_t peak = peak_bytes.load();
+    while (now > peak && ! peak_bytes.compare_exchange_weak(peak, now))
+        ;
+
+    return static_cast<char*>(block) + kHeaderSize;
+}
+
+void TrackedFree(void * memory)
+{
+    if (memory == nullptr)
+        return;
+
+    void * block = static_cast<char*>(memory) - kHeaderSize;
+    current_bytes -= static_cast<int64_t>(*static_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+}  // namespace
+
+void * operator new(std::size_t size) { return TrackedAllocate(size); }
+void * operator new[](std::size_t size) { return TrackedAllocate(size); }
+void operator delete(void * memory) noexcept { TrackedFree(memory); }
+void operator delete[](void * memory) noexcept { TrackedFree(memory); }
+void operator delete(void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+void operator delete[](void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+namespace {
+
+namespace get_content = mf::api::folder::get_content::v1_2;
+namespace get_changes = mf::api::device::get_changes::v0;
+
+std::string CreateGetContent(uint32_t files)
+{
+    std::ostringstream ss;
+    ss << "{\"response\":{\"action\":\"folder\\/get_content\","
+        "\"asynchronous\":\"no\",\"folder_content\":{\"chunk_size\":\""
+        << files << "\",\"content_type\":\"files\",\"chunk_number\":\"1\","
+        "\"folderkey\":\"myfiles\",\"files\":[";
+
+    for (uint32_t i = 0; i < files; ++i)
+    {
+        if (i != 0)
+            ss << ",";
+        ss << "{\"quickkey\":\"q" << std::setw(14) << std::setfill('0') << i
+            << "\",\"hash\":\"" << std::string(64, 'a' + (i % 6)) << "\","
+            "\"filename\":\"file " << i << ".txt\","
+            "\"description\":\"\",\"size\":\"" << (i * 977) << "\","
+            "\"privacy\":\"private\",\"created\":\"2014-06-01 12:00:00\","
+            "\"downloads\":\"0\",\"views\":\"" << (i % 50) << "\","
+            "\"password_protected\":\"no\",\"mimetype\":\"text\\/plain\","
+            "\"filetype\":\"document\",\"view\":\"0\",\"edit\":\"0\","
+            "\"revision\":\"" << i << "\",\"flag\":\"2\","
+            "\"permissions\":{\"value\":\"0\",\"explicit\":\"0\","
+            "\"read\":\"1\",\"write\":\"1\"},"
+            "\"links\":{\"normal_download\":"
+            "\"http:\\/\\/www.mediafire.com\\/file\\/q" << i << "\"}}";
+    }
+
+    ss << "],\"more_chunks\":\"no\",\"revision\":\"1\"},"
+        "\"result\":\"Success\",\"current_api_version\":\"1.2\"}}";
+
+    return ss.str();
+}
+
+std::string CreateGetChanges(uint32_t changes)
+{
+    std::ostringstream ss;
+    ss << "{\"response\":{\"action\":\"device\\/get_changes\","
+        "\"device_revision\":\"" << changes << "\","
+        "\"changes_list_block\":\"500\",\"updated\":{\"files\":[";
+
+    for (uint32_t i = 0; i < changes; ++i)
+    {
+        if (i != 0)
+            ss << ",";
+        ss << "{\"quickkey\":\"q" << std::setw(14) << std::setfill('0') << i
+            << "\",\"parent_folderkey\":\"f" << std::setw(12)
+            << std::setfill('0') << (i / 20) << "\",\"revision\":\"" << i
+            << "\",\"created\":\"2014-06-01 12:00:00\"}";
+    }
+
+    ss << "],\"folders\":[";
+
+    for (uint32_t i = 0; i < changes / 20; ++i)
+    {
+        if (i != 0)
+            ss << ",";
+        ss << "{\"folderkey\":\"f" << std::setw(12) << std::setfill('0') << i
+            << "\",\"parent_folderkey\":\"myfiles\",\"revision\":\"" << i
+            << "\",\"created\":\"2014-06-01 12:00:00\"}";
+    }
+
+    ss << "]},\"deleted\":{\"files\":[],\"folders\":[]},"
+        "\"result\":\"Success\",\"current_api_version\":\"1.2\"}}";
+
+    return ss.str();
+}
+
+std::string ReadFile(const std::string & path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if ( ! in )
+        throw std::runtime_error("Unable to open " + path);
+
+    return std::string(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+}
+
+/** Size of the pieces the content is received in. */
+const std::size_t kPieceSize = 16 * 1024;
+
+struct Measurement
+{
+    double ms_per_response;
+    double ms_to_first_item;
+    int64_t peak_bytes;
+    std::size_t items;
+    bool failed;
+};
+
+template<typename Request, typename CountItems>
+Measurement Measure(
+        Request request,
+        const std::string & content,
+        mf::api::ResponseParser response_parser,
+        bool incremental,
+        uint32_t repeat,
+        CountItems count_items
+    )
+{
+    typedef mf::api::detail::IncrementalContentInterface::Deliveries
+        Deliveries;
+
+    mf::http::Headers headers;
+    headers.status_code = 200;
+
+    Measurement measurement = {0, 0, 0, 0, false};
+
+    sclock::time_point start;
+    bool first_item = false;
+    std::size_t items = 0;
+
+    auto count = [&](const typename Request::ResponseType & response)
+        {
+            const std::size_t response_items = count_items(response);
+            if (response_items > 0 && ! first_item)
+            {
+                first_item = true;
+                measurement.ms_to_first_item += std::chrono::duration<double,
+                    std::milli>(sclock::now() - start).count();
+            }
+            items += response_items;
+
+            if (response.error_code)
+            {
+                measurement.failed = true;
+                std::cerr << "Parse failed: "
+                    << response.error_string.value_or(
+                        response.error_code.message()) << std::endl;
+            }
+        };
+
+    request.SetDiagnosticsLevel(mf::api::DiagnosticsLevel::Off);
+    request.SetResponseParser(response_parser);
+    request.SetCallback(count);
+    if (incremental)
+        request.SetBatchCallback(count, 100);
+
+    for (uint32_t i = 0; i < repeat; ++i)
+    {
+        const int64_t base = current_bytes.load();
+        peak_bytes = base;
+
+        start = sclock::now();
+        first_item = false;
+        items = 0;
+
+        // As RequesterImpl receives it.
+        auto incremental_content = incremental
+            ? request.BeginIncrementalContent() : nullptr;
+        std::string received;
+
+        for (std::size_t pos = 0; pos < content.size(); pos += kPieceSize)
+        {
+            const std::size_t size = std::min(kPieceSize,
+                content.size() - pos);
+
+            if (incremental_content)
+            {
+                Deliveries deliveries;
+                incremental_content->Read(content.data() + pos, size,
+                    &deliveries);
+                for (const auto & delivery : deliveries)
+                    delivery();
+            }
+            else
+            {
+                received.append(content.data() + pos, size);
+            }
+        }
+
+        if (incremental_content)
+        {
+            Deliveries deliveries;
+            received = incremental_content->Finish(&deliveries);
+            for (const auto & delivery : deliveries)
+                delivery();
+        }
+
+        request.HandleContent("https://www.mediafire.com/api/1.2/test.php",
+            headers, received);
+
+        measurement.ms_per_response += std::chrono::duration<double,
+            std::milli>(sclock::now() - start).count();
+        measurement.items = items;
+
+        std::string().swap(received);
+        incremental_content.reset();
+
+        measurement.peak_bytes = std::max(measurement.peak_bytes,
+            peak_bytes.load() - base);
+    }
+
+    measurement.ms_per_response /= repeat;
+    measurement.ms_to_first_item /= repeat;
+
+    return measurement;
+}
+
+template<typename Request, typename CountItems>
+bool Report(
+        const std::string & name,
+        Request request,
+        const std::string & content,
+        uint32_t repeat,
+        CountItems count_items
+    )
+{
+    struct Parser
+    {
+        const char * name;
+        mf::api::ResponseParser response_parser;
+        bool incremental;
+    };
+
+    const Parser parsers[] = {
+        {"PropertyTree", mf::api::ResponseParser::PropertyTree, false},
+        {"Streaming", mf::api::ResponseParser::Streaming, false},
+        {"Incremental", mf::api::ResponseParser::Streaming, true},
+    };
+
+    std::cout << "\n" << name << " (" << content.size() << " bytes)\n"
+        << std::left << std::setw(14) << "Parser"
+        << std::right << std::setw(12) << "ms/resp"
+        << std::setw(12) << "ms/first"
+        << std::setw(14) << "peak KB"
+        << std::setw(10) << "items"
+        << std::endl;
+
+    bool success = true;
+    std::size_t first_items = 0;
+
+    for (const auto & parser : parsers)
+    {
+        const auto measurement = Measure(request, content,
+            parser.response_parser, parser.incremental, repeat, count_items);
+
+        std::cout << std::left << std::setw(14) << parser.name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << measurement.ms_per_response
+            << std::setw(12) << measurement.ms_to_first_item
+            << std::setprecision(1)
+            << std::setw(14) << measurement.peak_bytes / 1024.0
+            << std::setw(10) << measurement.items
+            << std::endl;
+
+        if (&parser == parsers)
+            first_items = measurement.items;
+        else if (measurement.items != first_items)
+            success = false;
+
+        if (measurement.failed)
+            success = false;
+    }
+
+    if ( ! success )
+        std::cerr << name << ": parsers disagree" << std::endl;
+
+    return success;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        uint32_t items = 1000;
+        uint32_t repeat = 20;
+        std::string get_content_path;
+        std::string get_changes_path;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("items", po::value<uint32_t>(&items),
+                "Files in the generated payloads. (1000)")
+            ("repeat", po::value<uint32_t>(&repeat),
+                "Responses parsed per parser. (20)")
+            ("get-content", po::value<std::string>(&get_content_path),
+                "Captured folder/get_content 1.2 response to parse instead.")
+            ("get-changes", po::value<std::string>(&get_changes_path),
+                "Captured device/get_changes response to parse instead.");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        repeat = std::max(1u, repeat);
+
+        const std::string get_content_payload = get_content_path.empty()
+            ? CreateGetContent(items) : ReadFile(get_content_path);
+        const std::string get_changes_payload = get_changes_path.empty()
+            ? CreateGetChanges(items) : ReadFile(get_changes_path);
+
+        bool success = true;
+
+        success &= Report("folder/get_content",
+            get_content::Request("myfiles", 1,
+                get_content::ContentType::Files),
+            get_content_payload, repeat,
+            [](const get_content::Response & response)
+            {
+                return response.files.size() + response.folders.size();
+            });
+
+        success &= Report("device/get_changes",
+            get_changes::Request(0),
+            get_changes_payload, repeat,
+            [](const get_changes::Response & response)
+            {
+                return response.updated_files.size()
+                    + response.deleted_files.size()
+                    + response.updated_folders.size()
+                    + response.deleted_folders.size();
+            });
+
+        return success ? 0 : 1;
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "Uncaught exception: " << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        std::cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+}
@@ -0,0 +1,696 @@
+/**
+ * @file ut_json_reader.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define BOOST_TEST_MODULE UtJsonReader
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/api/device/get_changes.hpp"
+#include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/folder/get_content.hpp"
+#include "mediafire_sdk/api/json_array_splitter.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
+#include "mediafire_sdk/api/ptree_helpers.hpp"
+#include "mediafire_sdk/api/types.hpp"
+
+namespace api = mf::api;
+
+namespace {
+
+namespace get_content = api::folder::get_content::v1_2;
+namespace get_changes = api::device::get_changes::v0;
+
+/** Pass content to a request as if it came from the server. */
+template<typename Request>
+typename Request::ResponseType Parse(
+        Request request,
+        api::ResponseParser response_parser,
+        const std::string & content,
+        uint16_t status_code = 200
+    )
+{
+    typename Request::ResponseType response;
+
+    request.SetResponseParser(response_parser);
+    request.SetCallback(
+        [&response](const typename Request::ResponseType & data)
+        {
+            response = data;
+        });
+
+    mf::http::Headers headers;
+    headers.status_code = status_code;
+
+    request.HandleContent("https://www.mediafire.com/api/test.php", headers,
+        content);
+
+    return response;
+}
+
+/**
+ * Pass content to a request piece by piece, as if it was still arriving, with
+ * the elements of its arrays delivered in batches.
+ */
+template<typename Request>
+typename Request::ResponseType ParseIncrementally(
+        Request request,
+        const std::string & content,
+        std::size_t piece_size,
+        std::size_t batch_size,
+        std::vector<typename Request::ResponseType> * batches
+    )
+{
+    typedef api::detail::IncrementalContentInterface::Deliveries Deliveries;
+
+    typename Request::ResponseType response;
+    bool responded = false;
+
+    request.SetResponseParser(api::ResponseParser::Streaming);
+    request.SetCallback(
+        [&response, &responded](const typename Request::ResponseType & data)
+        {
+            response = data;
+            responded = true;
+        });
+    request.SetBatchCallback(
+        [batches, &responded](const typename Request::ResponseType & batch)
+        {
+            BOOST_CHECK( ! responded );
+            batches->push_back(batch);
+        }, batch_size);
+
+    auto incremental_content = request.BeginIncrementalContent();
+    BOOST_REQUIRE(incremental_content);
+
+    for (std::size_t pos = 0; pos < content.size(); pos += piece_size)
+    {
+        Deliveries deliveries;
+        incremental_content->Read(content.data() + pos,
+            std::min(piece_size, content.size() - pos), &deliveries);
+        for (const auto & delivery : deliveries)
+            delivery();
+    }
+
+    Deliveries deliveries;
+    const std::string remainder = incremental_content->Finish(&deliveries);
+    for (const auto & delivery : deliveries)
+        delivery();
+
+    mf::http::Headers headers;
+    headers.status_code = 200;
+
+    request.HandleContent("https://www.mediafire.com/api/test.php", headers,
+        remainder);
+
+    BOOST_CHECK(responded);
+    return response;
+}
+
+std::string GetContentFile(int index)
+{
+    std::ostringstream ss;
+    ss << "{\"quickkey\":\"q" << index << "\",\"hash\":\"abc" << index
+        << "\",\"filename\":\"caf\\u00e9 \\ud83d\\ude00 " << index
+        << ".txt\",\"description\":\"\",\"size\":\"" << index * 1000
+        << "\",\"privacy\":\"" << (index % 2 ? "public" : "private")
+        << "\",\"created\":\"2014-06-0" << (index % 9) + 1 << " 12:00:00\","
+        "\"password_protected\":\"no\",\"mimetype\":\"text\\/plain\","
+        "\"filetype\":\"document\",\"view\":\"0\",\"edit\":\"0\","
+        "\"revision\":\"" << index << "\",\"flag\":\"2\","
+        "\"downloads\":\"0\",\"views\":\"" << index << "\","
+        "\"links\":{\"normal_download\":\"http:\\/\\/www.mediafire.com\\/q"
+        << index << "\"},"
+        "\"permissions\":{\"value\":\"0\",\"explicit\":\"0\","
+        "\"read\":\"1\",\"write\":\"" << index % 2 << "\"}}";
+    return ss.str();
+}
+
+std::string GetContentFolder(int index)
+{
+    std::ostringstream ss;
+    ss << "{\"folderkey\":\"f" << index << "\",\"name\":\"Folder " << index
+        << "\",\"description\":\"About " << index << "\",\"tags\":\"\","
+        "\"privacy\":\"private\",\"created\":\"2014-01-02 03:04:05\","
+        "\"revision\":\"" << index << "\",\"flag\":\"6\","
+        "\"file_count\":\"" << index << "\",\"folder_count\":\"1\","
+        "\"dropbox_enabled\":\"no\",\"total_size\":\"" << index * 5000000000LL
+        << "\"}";
+    return ss.str();
+}
+
+std::string GetContentListing(
+        const std::string & content_type,
+        const std::string & items
+    )
+{
+    return "{\n  \"response\": {\n    \"action\": \"folder/get_content\",\n"
+        "    \"asynchronous\": \"no\",\n    \"folder_content\": {\n"
+        "      \"chunk_size\": \"100\",\n      \"content_type\": \""
+        + content_type + "\",\n      \"chunk_number\": \"1\",\n"
+        "      \"folderkey\": \"myfiles\",\n      \"" + content_type
+        + "\": [" + items + "],\n      \"more_chunks\": \"yes\",\n"
+        "      \"revision\": \"44\"\n    },\n"
+        "    \"result\": \"Success\",\n"
+        "    \"current_api_version\": \"1.2\"\n  }\n}\n";
+}
+
+std::string GetChangesContent()
+{
+    return "{\"response\":{\"action\":\"device\\/get_changes\","
+        "\"device_revision\":\"203\",\"changes_list_block\":\"500\","
+        "\"updated\":{\"files\":[{\"quickkey\":\"q1\","
+        "\"parent_folderkey\":\"myfiles\",\"revision\":\"3\","
+        "\"created\":\"2014-11-02 01:30:00\"},{\"quickkey\":\"q2\","
+        "\"revision\":\"4\"}],\"folders\":[{\"folderkey\":\"f1\","
+        "\"parent_folderkey\":\"f0\",\"revision\":\"7\","
+        "\"created\":\"2014-03-09 02:30:00\"}]},"
+        "\"deleted\":{\"files\":[{\"quickkey\":\"q3\",\"revision\":\"9\"}],"
+        "\"folders\":[]},\"new_key\":\"yes\",\"result\":\"Success\"}}";
+}
+
+template<typename Response>
+void CheckSameError(const Response & tree, const Response & streamed)
+{
+    BOOST_CHECK_EQUAL(tree.error_code, streamed.error_code);
+    BOOST_CHECK_EQUAL(tree.error_string.value_or(""),
+        streamed.error_string.value_or(""));
+    BOOST_CHECK_EQUAL(tree.api_error_string.value_or(""),
+        streamed.api_error_string.value_or(""));
+}
+
+void CheckSamePermissions(
+        const boost::optional<get_content::Response::Permissions> & tree,
+        const boost::optional<get_content::Response::Permissions> & streamed
+    )
+{
+    BOOST_REQUIRE_EQUAL(static_cast<bool>(tree), static_cast<bool>(streamed));
+    if ( ! tree )
+        return;
+
+    BOOST_CHECK_EQUAL(tree->value, streamed->value);
+    BOOST_CHECK(tree->explicit_share == streamed->explicit_share);
+    BOOST_CHECK(tree->read_permission == streamed->read_permission);
+    BOOST_CHECK(tree->write_permission == streamed->write_permission);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ReaderReadsValues)
+{
+    const std::string content = " {\"a\": {\"b\": [1, -2.5e3, true, null]},"
+        " \"s\": \"x\\\"\\u00e9\\ud83d\\ude00\\n\", \"skip\": {\"c\": [[]]},"
+        " \"o\": {\"k1\": \"v1\", \"k2\": \"v2\"}} ";
+
+    api::JsonReader reader(content);
+
+    std::string key, a_key, value, text;
+    std::vector<std::string> elements;
+    std::vector<std::string> object_elements;
+
+    BOOST_REQUIRE(reader.BeginObject());
+    while (reader.NextMember(&key))
+    {
+        if (key == "a")
+        {
+            BOOST_REQUIRE(reader.BeginObject());
+            while (reader.NextMember(&a_key))
+            {
+                BOOST_CHECK_EQUAL(a_key, "b");
+                BOOST_REQUIRE(reader.BeginArray());
+                while (reader.NextElement())
+                {
+                    BOOST_REQUIRE(reader.ReadScalar(&value));
+                    elements.push_back(value);
+                }
+            }
+        }
+        else if (key == "s")
+        {
+            BOOST_CHECK(reader.ReadValue(&text));
+        }
+        else if (key == "o")
+        {
+            // Objects read as arrays give their member values.
+            BOOST_REQUIRE(reader.BeginArray());
+            while (reader.NextElement())
+            {
+                BOOST_REQUIRE(reader.ReadScalar(&value));
+                object_elements.push_back(value);
+            }
+        }
+        else
+        {
+            BOOST_CHECK_EQUAL(key, "skip");
+            reader.Skip();
+        }
+    }
+
+    BOOST_CHECK(reader.Finish());
+
+    const std::vector<std::string> expected_elements = {"1", "-2.5e3", "true",
+        "null"};
+    BOOST_CHECK(elements == expected_elements);
+
+    const std::vector<std::string> expected_object_elements = {"v1", "v2"};
+    BOOST_CHECK(object_elements == expected_object_elements);
+
+    BOOST_CHECK_EQUAL(text, "x\"\xc3\xa9\xf0\x9f\x98\x80\n");
+}
+
+BOOST_AUTO_TEST_CASE(ReaderRejectsMalformedDocuments)
+{
+    const std::vector<std::string> documents = {
+        "",
+        "{\"a\":1,}",
+        "{\"a\" 1}",
+        "{\"a\":\"unterminated}",
+        "{\"a\":01}",
+        "{\"a\":tru}",
+        "[1 2]",
+        "{\"a\":1}}",
+        "{\"a\":\"\\x\"}",
+    };
+
+    for (const auto & document : documents)
+    {
+        api::JsonReader reader(document);
+        reader.Skip();
+
+        BOOST_CHECK_MESSAGE( ! reader.Finish(), document);
+        BOOST_CHECK_MESSAGE(reader.ErrorString().find("JSON line 1: ") == 0,
+            reader.ErrorString());
+    }
+
+    // Deeply nested documents are rejected rather than overflowing the stack.
+    api::JsonReader reader(std::string(100000, '['));
+    reader.Skip();
+    BOOST_CHECK( ! reader.Finish());
+}
+
+BOOST_AUTO_TEST_CASE(ConvertIntegers)
+{
+    uint32_t u32 = 7;
+    BOOST_CHECK(api::ConvertJsonValue("4294967295", &u32));
+    BOOST_CHECK_EQUAL(u32, 4294967295u);
+    BOOST_CHECK( ! api::ConvertJsonValue("4294967296", &u32));
+    BOOST_CHECK( ! api::ConvertJsonValue("-1", &u32));
+    BOOST_CHECK( ! api::ConvertJsonValue("1.5", &u32));
+    BOOST_CHECK( ! api::ConvertJsonValue("", &u32));
+    BOOST_CHECK_EQUAL(u32, 4294967295u);
+
+    int64_t i64 = 0;
+    BOOST_CHECK(api::ConvertJsonValue("-9223372036854775808", &i64));
+    BOOST_CHECK_EQUAL(i64, std::numeric_limits<int64_t>::min());
+    BOOST_CHECK( ! api::ConvertJsonValue("9223372036854775808", &i64));
+
+    uint16_t u16 = 0;
+    BOOST_CHECK(api::ConvertJsonValue(" 65535 ", &u16));
+    BOOST_CHECK_EQUAL(u16, 65535);
+    BOOST_CHECK( ! api::ConvertJsonValue("65536", &u16));
+}
+
+BOOST_AUTO_TEST_CASE(GetContentFilesParsersAgree)
+{
+    std::string items;
+    for (int i = 0; i < 20; ++i)
+        items += (i ? "," : "") + GetContentFile(i);
+
+    const std::string content = GetContentListing("files", items);
+    const get_content::Request request("myfiles", 1,
+        get_content::ContentType::Files);
+
+    const auto tree = Parse(request, api::ResponseParser::PropertyTree,
+        content);
+    const auto streamed = Parse(request, api::ResponseParser::Streaming,
+        content);
+
+    BOOST_REQUIRE( ! tree.error_code );
+    CheckSameError(tree, streamed);
+
+    BOOST_CHECK_EQUAL(tree.chunk_size, streamed.chunk_size);
+    BOOST_CHECK_EQUAL(tree.chunk_number, streamed.chunk_number);
+    BOOST_CHECK(tree.content_type == streamed.content_type);
+    BOOST_CHECK(tree.chunks_remaining == streamed.chunks_remaining);
+
+    BOOST_REQUIRE_EQUAL(tree.files.size(), 20);
+    BOOST_REQUIRE_EQUAL(tree.files.size(), streamed.files.size());
+    BOOST_CHECK(streamed.folders.empty());
+
+    for (std::size_t i = 0; i < tree.files.size(); ++i)
+    {
+        const auto & a = tree.files[i];
+        const auto & b = streamed.files[i];
+
+        BOOST_CHECK_EQUAL(a.quickkey, b.quickkey);
+        BOOST_CHECK_EQUAL(a.filename, b.filename);
+        BOOST_CHECK_EQUAL(a.hash, b.hash);
+        BOOST_CHECK_EQUAL(a.filesize, b.filesize);
+        BOOST_CHECK_EQUAL(a.filetype, b.filetype);
+        BOOST_CHECK_EQUAL(a.mimetype, b.mimetype);
+        BOOST_CHECK_EQUAL(a.flag, b.flag);
+        BOOST_CHECK_EQUAL(a.revision, b.revision);
+        BOOST_CHECK_EQUAL(a.views, b.views);
+        BOOST_CHECK_EQUAL(a.download_count, b.download_count);
+        BOOST_CHECK_EQUAL(a.created_datetime, b.created_datetime);
+        BOOST_CHECK_EQUAL(a.deleted_datetime, b.deleted_datetime);
+        BOOST_CHECK_EQUAL(static_cast<bool>(a.description),
+            static_cast<bool>(b.description));
+        BOOST_CHECK(a.privacy == b.privacy);
+        BOOST_CHECK(a.password_protected == b.password_protected);
+        BOOST_CHECK(a.shared_by_user == b.shared_by_user);
+        BOOST_CHECK(a.shared_with_user == b.shared_with_user);
+        BOOST_CHECK_EQUAL(a.links.normal_download.value_or(""),
+            b.links.normal_download.value_or(""));
+        BOOST_CHECK_EQUAL(static_cast<bool>(a.links.view),
+            static_cast<bool>(b.links.view));
+        CheckSamePermissions(a.permissions, b.permissions);
+    }
+
+    // The envelope is kept for the error handling.
+    BOOST_CHECK(api::PropertyHasValue(streamed.pt, "response.result",
+        std::string("Success")));
+}
+
+BOOST_AUTO_TEST_CASE(GetContentFoldersParsersAgree)
+{
+    std::string items;
+    for (int i = 0; i < 20; ++i)
+        items += (i ? "," : "") + GetContentFolder(i);
+
+    const std::string content = GetContentListing("folders", items);
+    const get_content::Request request("myfiles", 1,
+        get_content::ContentType::Folders);
+
+    const auto tree = Parse(request, api::ResponseParser::PropertyTree,
+        content);
+    const auto streamed = Parse(request, api::ResponseParser::Streaming,
+        content);
+
+    BOOST_REQUIRE( ! tree.error_code );
+    CheckSameError(tree, streamed);
+
+    BOOST_REQUIRE_EQUAL(tree.folders.size(), 20);
+    BOOST_REQUIRE_EQUAL(tree.folders.size(), streamed.folders.size());
+
+    for (std::size_t i = 0; i < tree.folders.size(); ++i)
+    {
+        const auto & a = tree.folders[i];
+        const auto & b = streamed.folders[i];
+
+        BOOST_CHECK_EQUAL(a.folderkey, b.folderkey);
+        BOOST_CHECK_EQUAL(a.name, b.name);
+        BOOST_CHECK_EQUAL(a.description.value_or(""),
+            b.description.value_or(""));
+        BOOST_CHECK_EQUAL(static_cast<bool>(a.tags),
+            static_cast<bool>(b.tags));
+        BOOST_CHECK_EQUAL(a.revision, b.revision);
+        BOOST_CHECK_EQUAL(a.file_count, b.file_count);
+        BOOST_CHECK_EQUAL(a.folder_count, b.folder_count);
+        BOOST_CHECK_EQUAL(a.created_datetime, b.created_datetime);
+        BOOST_CHECK_EQUAL(a.total_size.value_or(0), b.total_size.value_or(0));
+        BOOST_CHECK_EQUAL(static_cast<bool>(a.total_files),
+            static_cast<bool>(b.total_files));
+        BOOST_CHECK(a.filedrop == b.filedrop);
+        BOOST_CHECK(a.privacy == b.privacy);
+        CheckSamePermissions(a.permissions, b.permissions);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GetChangesParsersAgree)
+{
+    const std::string content = GetChangesContent();
+    const get_changes::Request request(200);
+
+    const auto tree = Parse(request, api::ResponseParser::PropertyTree,
+        content);
+    const auto streamed = Parse(request, api::ResponseParser::Streaming,
+        content);
+
+    BOOST_REQUIRE( ! tree.error_code );
+    CheckSameError(tree, streamed);
+
+    BOOST_CHECK_EQUAL(tree.device_revision, streamed.device_revision);
+    BOOST_CHECK_EQUAL(tree.changes_list_block, streamed.changes_list_block);
+
+    BOOST_REQUIRE_EQUAL(tree.updated_files.size(), 2);
+    BOOST_REQUIRE_EQUAL(tree.updated_files.size(),
+        streamed.updated_files.size());
+    for (std::size_t i = 0; i < tree.updated_files.size(); ++i)
+    {
+        const auto & a = tree.updated_files[i];
+        const auto & b = streamed.updated_files[i];
+        BOOST_CHECK_EQUAL(a.quickkey, b.quickkey);
+        BOOST_CHECK_EQUAL(a.parent_folderkey.value_or(""),
+            b.parent_folderkey.value_or(""));
+        BOOST_CHECK_EQUAL(a.revision, b.revision);
+        BOOST_CHECK_EQUAL(a.created_datetime, b.created_datetime);
+    }
+
+    BOOST_REQUIRE_EQUAL(tree.deleted_files.size(),
+        streamed.deleted_files.size());
+    BOOST_CHECK_EQUAL(tree.deleted_files[0].quickkey,
+        streamed.deleted_files[0].quickkey);
+
+    BOOST_REQUIRE_EQUAL(tree.updated_folders.size(), 1);
+    BOOST_REQUIRE_EQUAL(tree.updated_folders.size(),
+        streamed.updated_folders.size());
+    BOOST_CHECK_EQUAL(tree.updated_folders[0].folderkey,
+        streamed.updated_folders[0].folderkey);
+    BOOST_CHECK_EQUAL(tree.updated_folders[0].created_datetime,
+        streamed.updated_folders[0].created_datetime);
+
+    BOOST_CHECK(streamed.deleted_folders.empty());
+
+    // SessionMaintainer looks for new_key in the property tree.
+    BOOST_CHECK(api::PropertyHasValue(tree.pt, "response.new_key",
+        std::string("yes")));
+    BOOST_CHECK(api::PropertyHasValue(streamed.pt, "response.new_key",
+        std::string("yes")));
+}
+
+BOOST_AUTO_TEST_CASE(ApiErrorParsersAgree)
+{
+    const std::string content = "{\"response\":{\"action\":"
+        "\"folder\\/get_content\",\"message\":\"The supplied Session Token is "
+        "expired or invalid\",\"error\":105,\"result\":\"Error\","
+        "\"current_api_version\":\"1.2\"}}";
+    const get_content::Request request("myfiles", 1,
+        get_content::ContentType::Files);
+
+    for (uint16_t status_code : {200, 403})
+    {
+        const auto tree = Parse(request, api::ResponseParser::PropertyTree,
+            content, status_code);
+        const auto streamed = Parse(request, api::ResponseParser::Streaming,
+            content, status_code);
+
+        BOOST_CHECK_EQUAL(tree.error_code.value(), 105);
+        CheckSameError(tree, streamed);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidContentParsersAgree)
+{
+    const get_content::Request request("myfiles", 1,
+        get_content::ContentType::Files);
+
+    // Missing a required value.
+    {
+        const std::string content = "{\"response\":{\"folder_content\":{"
+            "\"chunk_number\":\"1\",\"content_type\":\"files\","
+            "\"more_chunks\":\"no\"},\"result\":\"Success\"}}";
+
+        const auto tree = Parse(request, api::ResponseParser::PropertyTree,
+            content);
+        const auto streamed = Parse(request, api::ResponseParser::Streaming,
+            content);
+
+        BOOST_CHECK(tree.error_code == api::api_code::ContentInvalidData);
+        CheckSameError(tree, streamed);
+    }
+
+    // Not JSON.
+    {
+        const std::string content = "<html>Bad gateway</html>";
+
+        const auto tree = Parse(request, api::ResponseParser::PropertyTree,
+            content);
+        const auto streamed = Parse(request, api::ResponseParser::Streaming,
+            content);
+
+        BOOST_CHECK(tree.error_code == api::api_code::ContentInvalidFormat);
+        BOOST_CHECK(streamed.error_code == api::api_code::ContentInvalidFormat);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SplitterPassesElements)
+{
+    typedef std::pair<std::size_t, std::string> Element;
+
+    const std::string content = "{\"response\": {\"list\": {\"items\" : "
+        "[ {\"a\":\"[,]\",\"b\":[1,{\"c\":\"\\\"}\"}]} , \"two\",3 ,"
+        "[] ], \"other\":[4,5]}, \"items\":[6]}, \"x\\\"y\":[7]}";
+
+    const std::vector<Element> expected_elements = {
+        Element(1, " {\"a\":\"[,]\",\"b\":[1,{\"c\":\"\\\"}\"}]} "),
+        Element(1, " \"two\""),
+        Element(1, "3 "),
+        Element(1, "[] "),
+        Element(0, "6"),
+    };
+    const std::string expected_remainder = "{\"response\": {\"list\": "
+        "{\"items\" : [], \"other\":[4,5]}, \"items\":[]}, "
+        "\"x\\\"y\":[7]}";
+
+    for (std::size_t piece_size : {1, 2, 7, 1000})
+    {
+        std::vector<Element> elements;
+        api::JsonArraySplitter splitter(
+            {"response.items", "response.list.items", "x\\\"y.z"},
+            [&elements](std::size_t path_index, const std::string & element)
+            {
+                elements.push_back(Element(path_index, element));
+            });
+
+        for (std::size_t pos = 0; pos < content.size(); pos += piece_size)
+            splitter.Append(content.data() + pos,
+                std::min(piece_size, content.size() - pos));
+
+        BOOST_REQUIRE_EQUAL(elements.size(), expected_elements.size());
+        for (std::size_t i = 0; i < expected_elements.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(elements[i].first, expected_elements[i].first);
+            BOOST_CHECK_EQUAL(elements[i].second,
+                expected_elements[i].second);
+        }
+        BOOST_CHECK_EQUAL(splitter.TakeRemainder(), expected_remainder);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SplitterKeepsMalformedDocuments)
+{
+    const std::string content = "{\"response\":]{\"items\":[1,2]}}";
+
+    std::vector<std::string> elements;
+    api::JsonArraySplitter splitter({"response.items"},
+        [&elements](std::size_t, const std::string & element)
+        {
+            elements.push_back(element);
+        });
+    splitter.Append(content.data(), content.size());
+
+    BOOST_CHECK(elements.empty());
+    BOOST_CHECK_EQUAL(splitter.TakeRemainder(), content);
+}
+
+BOOST_AUTO_TEST_CASE(GetContentBatchesMatchWholeResponse)
+{
+    std::string items;
+    for (int i = 0; i < 20; ++i)
+        items += (i ? "," : "") + GetContentFile(i);
+
+    const std::string content = GetContentListing("files", items);
+    const get_content::Request request("myfiles", 1,
+        get_content::ContentType::Files);
+
+    const auto whole = Parse(request, api::ResponseParser::Streaming, content);
+    BOOST_REQUIRE( ! whole.error_code );
+    BOOST_REQUIRE_EQUAL(whole.files.size(), 20);
+
+    for (std::size_t piece_size : {1, 13, 4096})
+    {
+        std::vector<get_content::Response> batches;
+        const auto response = ParseIncrementally(request, content, piece_size,
+            7, &batches);
+
+        BOOST_REQUIRE( ! response.error_code );
+        BOOST_CHECK(response.files.empty());
+        BOOST_CHECK_EQUAL(response.chunk_size, whole.chunk_size);
+        BOOST_CHECK(response.chunks_remaining == whole.chunks_remaining);
+
+        BOOST_REQUIRE_EQUAL(batches.size(), 3);
+        BOOST_CHECK_EQUAL(batches[0].files.size(), 7);
+        BOOST_CHECK_EQUAL(batches[1].files.size(), 7);
+        BOOST_CHECK_EQUAL(batches[2].files.size(), 6);
+
+        std::size_t index = 0;
+        for (const auto & batch : batches)
+        {
+            BOOST_CHECK( ! batch.error_code );
+            for (const auto & file : batch.files)
+            {
+                const auto & expected = whole.files[index++];
+                BOOST_CHECK_EQUAL(file.quickkey, expected.quickkey);
+                BOOST_CHECK_EQUAL(file.filename, expected.filename);
+                BOOST_CHECK_EQUAL(file.created_datetime,
+                    expected.created_datetime);
+                CheckSamePermissions(file.permissions, expected.permissions);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GetChangesBatchesMatchWholeResponse)
+{
+    const std::string content = GetChangesContent();
+    const get_changes::Request request(200);
+
+    const auto whole = Parse(request, api::ResponseParser::Streaming, content);
+    BOOST_REQUIRE( ! whole.error_code );
+
+    std::vector<get_changes::Response> batches;
+    const auto response = ParseIncrementally(request, content, 5, 100,
+        &batches);
+
+    BOOST_REQUIRE( ! response.error_code );
+    BOOST_CHECK_EQUAL(response.device_revision, whole.device_revision);
+    BOOST_CHECK(response.updated_files.empty());
+    BOOST_CHECK(api::PropertyHasValue(response.pt, "response.new_key",
+        std::string("yes")));
+
+    // Batches fill up across the arrays.
+    BOOST_REQUIRE_EQUAL(batches.size(), 1);
+    BOOST_REQUIRE_EQUAL(batches[0].updated_files.size(), 2);
+    BOOST_CHECK_EQUAL(batches[0].updated_files[1].quickkey,
+        whole.updated_files[1].quickkey);
+    BOOST_REQUIRE_EQUAL(batches[0].updated_folders.size(), 1);
+    BOOST_CHECK_EQUAL(batches[0].updated_folders[0].created_datetime,
+        whole.updated_folders[0].created_datetime);
+    BOOST_REQUIRE_EQUAL(batches[0].deleted_files.size(), 1);
+    BOOST_CHECK(batches[0].deleted_folders.empty());
+}
+
+BOOST_AUTO_TEST_CASE(BatchedElementErrorReachesResponse)
+{
+    // The second file has no quickkey.
+    const std::string content = GetContentListing("files",
+        GetContentFile(0) + ",{\"filename\":\"a.txt\"}," + GetContentFile(2));
+    const get_content::Request request("myfiles", 1,
+        get_content::ContentType::Files);
+
+    const auto whole = Parse(request, api::ResponseParser::Streaming, content);
+    BOOST_REQUIRE(whole.error_code == api::api_code::ContentInvalidData);
+
+    std::vector<get_content::Response> batches;
+    const auto response = ParseIncrementally(request, content, 64, 1,
+        &batches);
+
+    BOOST_CHECK_EQUAL(response.error_code, whole.error_code);
+    BOOST_CHECK_EQUAL(response.error_string.value_or(""),
+        whole.error_string.value_or(""));
+
+    BOOST_REQUIRE_EQUAL(batches.size(), 3);
+    BOOST_CHECK( ! batches[0].error_code );
+    BOOST_CHECK(batches[1].error_code == api::api_code::ContentInvalidData);
+    BOOST_CHECK(batches[1].files.empty());
+    BOOST_CHECK_EQUAL(batches[2].files.size(), 1);
+}
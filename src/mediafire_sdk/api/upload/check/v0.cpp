@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -140,6 +141,140 @@ bool ResumableDataFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool ResumableDataFromJsonReader(
+        Response * response,
+        Response::ResumableData * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->all_units_ready = AllUnitsReady::No;
+    bool has_number_of_units = false;
+    bool has_unit_size = false;
+    bool has_words = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "number_of_units" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->number_of_units) )
+                    has_number_of_units = true;
+            }
+            else if ( key == "all_units_ready" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->all_units_ready = AllUnitsReady::No;
+                    else if ( optval == "yes" )
+                        value->all_units_ready = AllUnitsReady::Yes;
+                }
+            }
+            else if ( key == "unit_size" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->unit_size) )
+                    has_unit_size = true;
+            }
+            else if ( key == "bitmap" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string bitmap_key;
+                    while ( reader->NextMember(&bitmap_key) )
+                    {
+                        if ( bitmap_key == "count" )
+                        {
+                            // create_content_read_single
+                            uint32_t optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                value->bitmap_count = std::move(optarg);
+                        }
+                        else if ( bitmap_key == "words" )
+                        {
+                            // create_content_read_array TArray
+                            has_words = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    uint16_t result;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( reader->ReadValue(&result) )
+                                        value->words.push_back(std::move(result));
+                                    else
+                                    {
+                                        set_error(
+                                            mf::api::api_code::ContentInvalidData,
+                                            "invalid value in bitmap.words");
+                                        skip_rest = true;
+                                    }
+                                }
+                            }
+                        }
+                        else
+                            reader->Skip();
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_number_of_units )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"number_of_units\"");
+    }
+
+    if ( ! has_unit_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"unit_size\"");
+    }
+
+    if ( ! has_words )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"bitmap.words\"");
+    }
+    else if ( value->words.empty() )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing value in bitmap.words");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -174,6 +309,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -355,6 +497,155 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->hash_exists = HashAlreadyInSystem::No;
+    response->hash_in_account = HashAlreadyInAccount::HashNewToAccount;
+    response->hash_in_folder = HashAlreadyInFolder::HashNewToFolder;
+    response->file_exists = FilenameInFolder::No;
+    response->hash_different = FileExistsWithDifferentHash::No;
+    response->available_space = 0;
+    response->used_storage_size = 0;
+    response->storage_limit = 0;
+    response->storage_limit_exceeded = StorageLimitExceeded::No;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "hash_exists" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->hash_exists = HashAlreadyInSystem::No;
+                                else if ( optval == "yes" )
+                                    response->hash_exists = HashAlreadyInSystem::Yes;
+                            }
+                        }
+                        else if ( response_key == "in_account" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->hash_in_account = HashAlreadyInAccount::HashNewToAccount;
+                                else if ( optval == "yes" )
+                                    response->hash_in_account = HashAlreadyInAccount::HashExistsInAccount;
+                            }
+                        }
+                        else if ( response_key == "in_folder" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->hash_in_folder = HashAlreadyInFolder::HashNewToFolder;
+                                else if ( optval == "yes" )
+                                    response->hash_in_folder = HashAlreadyInFolder::HashExistsInFolder;
+                            }
+                        }
+                        else if ( response_key == "file_exists" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->file_exists = FilenameInFolder::No;
+                                else if ( optval == "yes" )
+                                    response->file_exists = FilenameInFolder::Yes;
+                            }
+                        }
+                        else if ( response_key == "different_hash" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->hash_different = FileExistsWithDifferentHash::No;
+                                else if ( optval == "yes" )
+                                    response->hash_different = FileExistsWithDifferentHash::Yes;
+                            }
+                        }
+                        else if ( response_key == "duplicate_quickkey" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->duplicate_quickkey = std::move(optarg);
+                        }
+                        else if ( response_key == "available_space" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->available_space);
+                        }
+                        else if ( response_key == "used_storage_size" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->used_storage_size);
+                        }
+                        else if ( response_key == "storage_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->storage_limit);
+                        }
+                        else if ( response_key == "storage_limit_exceeded" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->storage_limit_exceeded = StorageLimitExceeded::No;
+                                else if ( optval == "yes" )
+                                    response->storage_limit_exceeded = StorageLimitExceeded::Yes;
+                            }
+                        }
+                        else if ( response_key == "resumable_upload" )
+                        {
+                            // create_content_struct_read TSingle
+                            Response::ResumableData optarg;
+                            if ( ResumableDataFromJsonReader(response, &optarg, reader) )
+                            {
+                                response->resumable = std::move(optarg);
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -392,6 +683,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
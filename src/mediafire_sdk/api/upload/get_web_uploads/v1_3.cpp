@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -201,6 +202,187 @@ bool WebUploadFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool WebUploadFromJsonReader(
+        Response * response,
+        Response::WebUpload * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->status_code = Status::Unknown;
+    value->status_text = "";
+    value->error_code = 0;
+    value->percent_complete = 0;
+    bool has_uploadkey = false;
+    bool has_activity = false;
+    bool has_filename = false;
+    bool has_url = false;
+    bool has_eta = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "uploadkey" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->uploadkey) )
+                    has_uploadkey = true;
+            }
+            else if ( key == "active" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->activity = Activity::Inactive;
+                    else if ( optval == "yes" )
+                        value->activity = Activity::Active;
+                    else
+                        set_error(
+                            mf::api::api_code::ContentInvalidData,
+                            "invalid value in active");
+                    has_activity = true;
+                }
+            }
+            else if ( key == "quickkey" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->quickkey = std::move(optarg);
+            }
+            else if ( key == "filename" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->filename) )
+                    has_filename = true;
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                boost::posix_time::ptime optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->created_datetime = std::move(optarg);
+            }
+            else if ( key == "status_code" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "" )
+                        value->status_code = Status::Unknown;
+                    else if ( optval == "1" )
+                        value->status_code = Status::Entered;
+                    else if ( optval == "2" )
+                        value->status_code = Status::Started;
+                    else if ( optval == "3" )
+                        value->status_code = Status::Transferring;
+                    else if ( optval == "4" )
+                        value->status_code = Status::Downloaded;
+                    else if ( optval == "5" )
+                        value->status_code = Status::VerificationWaiting;
+                    else if ( optval == "6" )
+                        value->status_code = Status::Verifying;
+                    else if ( optval == "99" )
+                        value->status_code = Status::Complete;
+                }
+            }
+            else if ( key == "status" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->status_text);
+            }
+            else if ( key == "error_status" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->error_code);
+            }
+            else if ( key == "url" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->url) )
+                    has_url = true;
+            }
+            else if ( key == "eta" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->eta) )
+                    has_eta = true;
+            }
+            else if ( key == "size" )
+            {
+                // create_content_read_single
+                uint64_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->filesize = std::move(optarg);
+            }
+            else if ( key == "percentage" )
+            {
+                // create_content_read_single
+                reader->ReadValue(&value->percent_complete);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_uploadkey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"uploadkey\"");
+    }
+
+    if ( ! has_activity )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in active");
+    }
+
+    if ( ! has_filename )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"filename\"");
+    }
+
+    if ( ! has_url )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"url\"");
+    }
+
+    if ( ! has_eta )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"eta\"");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -228,6 +410,21 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
+    virtual std::vector<std::string> BatchedArrayPaths() const override;
+
+    virtual void ReadBatchedElement(
+            std::size_t path_index,
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -285,6 +482,98 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_web_uploads = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "web_uploads" )
+                        {
+                            // create_content_struct_read TArray
+                            has_web_uploads = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    Response::WebUpload optarg;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( WebUploadFromJsonReader(response, &optarg, reader) )
+                                        response->web_uploads.push_back(std::move(optarg));
+                                    else
+                                        skip_rest = true;  // error set already
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_web_uploads )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.web_uploads\"");
+    }
+
+#   undef set_error
+}
+
+std::vector<std::string> Impl::BatchedArrayPaths() const
+{
+    return {
+            "response.web_uploads",
+        };
+}
+
+void Impl::ReadBatchedElement(
+        std::size_t path_index,
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    switch (path_index)
+    {
+        case 0:  // response.web_uploads
+        {
+            Response::WebUpload optarg;
+            if ( WebUploadFromJsonReader(response, &optarg, reader) )
+                response->web_uploads.push_back(std::move(optarg));
+            break;
+        }
+        default:
+            reader->Skip();
+            break;
+    }
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -311,6 +600,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -353,6 +657,20 @@ void Request::SetUploadKey(std::string upload_key)
     impl_->upload_key_ = upload_key;
 }
 
+void Request::SetBatchCallback(
+        CallbackType batch_callback,
+        std::size_t batch_size
+    )
+{
+    impl_->SetBatchCallback(batch_callback, batch_size);
+}
+
+std::shared_ptr<mf::api::detail::IncrementalContentInterface>
+    Request::BeginIncrementalContent()
+{
+    return impl_->BeginIncrementalContent();
+}
+
 mf::http::SharedBuffer::Pointer Request::GetPostData()
 {
     return impl_->GetPostData();
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -48,6 +49,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -171,6 +179,117 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->fileerror = 0;
+    bool has_result = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "doupload" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_doupload_key;
+                                while ( reader->NextMember(&response_doupload_key) )
+                                {
+                                    if ( response_doupload_key == "result" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->result) )
+                                            has_result = true;
+                                    }
+                                    else if ( response_doupload_key == "status" )
+                                    {
+                                        // create_content_read_single
+                                        int32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->status = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "fileerror" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->fileerror);
+                                    }
+                                    else if ( response_doupload_key == "filename" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->filename = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "description" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->description = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "quickkey" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->quickkey = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "size" )
+                                    {
+                                        // create_content_read_single
+                                        uint64_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->filesize = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "revision" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->revision = std::move(optarg);
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_result )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.doupload.result\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -196,6 +315,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
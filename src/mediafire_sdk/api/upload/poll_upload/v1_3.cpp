@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -141,6 +142,147 @@ bool ResumableDataFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool ResumableDataFromJsonReader(
+        Response * response,
+        Response::ResumableData * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    value->all_units_ready = AllUnitsReady::No;
+    bool has_number_of_units = false;
+    bool has_unit_size = false;
+    bool has_words = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "number_of_units" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->number_of_units) )
+                    has_number_of_units = true;
+            }
+            else if ( key == "all_units_ready" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->all_units_ready = AllUnitsReady::No;
+                    else if ( optval == "yes" )
+                        value->all_units_ready = AllUnitsReady::Yes;
+                }
+            }
+            else if ( key == "unit_size" )
+            {
+                // create_content_read_single
+                if ( reader->ReadValue(&value->unit_size) )
+                    has_unit_size = true;
+            }
+            else if ( key == "bitmap" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string bitmap_key;
+                    while ( reader->NextMember(&bitmap_key) )
+                    {
+                        if ( bitmap_key == "count" )
+                        {
+                            // create_content_read_single
+                            uint32_t optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                value->bitmap_count = std::move(optarg);
+                        }
+                        else if ( bitmap_key == "words" )
+                        {
+                            // create_content_read_array TArray
+                            has_words = true;
+                            if ( reader->BeginArray() )
+                            {
+                                bool skip_rest = false;
+                                while ( reader->NextElement() )
+                                {
+                                    uint16_t result;
+                                    if ( skip_rest )
+                                        reader->Skip();
+                                    else if ( reader->ReadValue(&result) )
+                                        value->words.push_back(std::move(result));
+                                    else
+                                    {
+                                        set_error(
+                                            mf::api::api_code::ContentInvalidData,
+                                            "invalid value in bitmap.words");
+                                        skip_rest = true;
+                                    }
+                                }
+                            }
+                        }
+                        else
+                            reader->Skip();
+                    }
+                }
+            }
+            else if ( key == "upload_key" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->upload_key = std::move(optarg);
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    if ( ! has_number_of_units )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"number_of_units\"");
+    }
+
+    if ( ! has_unit_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"unit_size\"");
+    }
+
+    if ( ! has_words )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"bitmap.words\"");
+    }
+    else if ( value->words.empty() )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing value in bitmap.words");
+    }
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -169,6 +311,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -333,6 +482,140 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->fileerror = 0;
+    bool has_result = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "doupload" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_doupload_key;
+                                while ( reader->NextMember(&response_doupload_key) )
+                                {
+                                    if ( response_doupload_key == "result" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->result) )
+                                            has_result = true;
+                                    }
+                                    else if ( response_doupload_key == "fileerror" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->fileerror);
+                                    }
+                                    else if ( response_doupload_key == "created" )
+                                    {
+                                        // create_content_read_single
+                                        boost::posix_time::ptime optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->created = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "description" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->description = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "filename" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->filename = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "hash" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->hash = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "quickkey" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->quickkey = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "resumable_upload" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::ResumableData optarg;
+                                        if ( ResumableDataFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->resumable = std::move(optarg);
+                                        }
+                                    }
+                                    else if ( response_doupload_key == "revision" )
+                                    {
+                                        // create_content_read_single
+                                        uint32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->revision = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "size" )
+                                    {
+                                        // create_content_read_single
+                                        uint64_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->filesize = std::move(optarg);
+                                    }
+                                    else if ( response_doupload_key == "status" )
+                                    {
+                                        // create_content_read_single
+                                        int32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->status = std::move(optarg);
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_result )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.doupload.result\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -358,6 +641,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -75,6 +76,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -288,6 +296,190 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "storage_limit_exceeded" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->storage_limit_exceeded = StorageLimit::WithinBounds;
+                                else if ( optval == "yes" )
+                                    response->storage_limit_exceeded = StorageLimit::Exceeded;
+                            }
+                        }
+                        else if ( response_key == "storage_limit" )
+                        {
+                            // create_content_read_single
+                            uint64_t optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->storage_limit = std::move(optarg);
+                        }
+                        else if ( response_key == "used_storage_size" )
+                        {
+                            // create_content_read_single
+                            uint64_t optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->used_storage_size = std::move(optarg);
+                        }
+                        else if ( response_key == "new_hash" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->known_by_cloud = KnownByCloud::Known;
+                                else if ( optval == "yes" )
+                                    response->known_by_cloud = KnownByCloud::Unknown;
+                            }
+                        }
+                        else if ( response_key == "quickkey" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->quickkey = std::move(optarg);
+                        }
+                        else if ( response_key == "duplicate_quickkey" )
+                        {
+                            // create_content_read_single
+                            std::string optarg;
+                            if ( reader->ReadValue(&optarg) )
+                                response->duplicate_quickkey = std::move(optarg);
+                        }
+                        else if ( response_key == "duplicate_name" )
+                        {
+                            // create_content_enum_read
+                            std::string optval;
+                            if ( reader->ReadValue(&optval) )
+                            {
+                                if ( optval == "no" )
+                                    response->duplicate_name = DuplicateName::NoPreexistingName;
+                                else if ( optval == "yes" )
+                                    response->duplicate_name = DuplicateName::DuplicateNameExists;
+                            }
+                        }
+                        else if ( response_key == "resumable_upload" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_resumable_upload_key;
+                                while ( reader->NextMember(&response_resumable_upload_key) )
+                                {
+                                    if ( response_resumable_upload_key == "upload_key" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->upload_key = std::move(optarg);
+                                    }
+                                    else if ( response_resumable_upload_key == "all_units_ready" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->all_units_ready = UnitsReady::NotReady;
+                                            else if ( optval == "yes" )
+                                                response->all_units_ready = UnitsReady::AllUnitsReady;
+                                        }
+                                    }
+                                    else if ( response_resumable_upload_key == "number_of_units" )
+                                    {
+                                        // create_content_read_single
+                                        uint32_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->number_of_units = std::move(optarg);
+                                    }
+                                    else if ( response_resumable_upload_key == "unit_size" )
+                                    {
+                                        // create_content_read_single
+                                        uint64_t optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->unit_size = std::move(optarg);
+                                    }
+                                    else if ( response_resumable_upload_key == "bitmap" )
+                                    {
+                                        if ( reader->BeginObject() )
+                                        {
+                                            std::string response_resumable_upload_bitmap_key;
+                                            while ( reader->NextMember(&response_resumable_upload_bitmap_key) )
+                                            {
+                                                if ( response_resumable_upload_bitmap_key == "count" )
+                                                {
+                                                    // create_content_read_single
+                                                    uint32_t optarg;
+                                                    if ( reader->ReadValue(&optarg) )
+                                                        response->bitmap_count = std::move(optarg);
+                                                }
+                                                else if ( response_resumable_upload_bitmap_key == "words" )
+                                                {
+                                                    // create_content_read_array TArray
+                                                    if ( reader->BeginArray() )
+                                                    {
+                                                        bool skip_rest = false;
+                                                        while ( reader->NextElement() )
+                                                        {
+                                                            uint16_t result;
+                                                            if ( skip_rest )
+                                                                reader->Skip();
+                                                            else if ( reader->ReadValue(&result) )
+                                                                response->bitmap_words.push_back(std::move(result));
+                                                            else
+                                                            {
+                                                                skip_rest = true;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                                else
+                                                    reader->Skip();
+                                            }
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -328,6 +520,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
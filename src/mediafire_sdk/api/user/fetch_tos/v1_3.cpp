@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -45,6 +46,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -129,6 +137,124 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->user_accepted_terms = TOSAccepted::No;
+    bool has_revision = false;
+    bool has_terms = false;
+    bool has_date = false;
+    bool has_acceptance_token = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "terms_of_service" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_terms_of_service_key;
+                                while ( reader->NextMember(&response_terms_of_service_key) )
+                                {
+                                    if ( response_terms_of_service_key == "revision" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->revision) )
+                                            has_revision = true;
+                                    }
+                                    else if ( response_terms_of_service_key == "terms" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->terms) )
+                                            has_terms = true;
+                                    }
+                                    else if ( response_terms_of_service_key == "date" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->date) )
+                                            has_date = true;
+                                    }
+                                    else if ( response_terms_of_service_key == "user_accepted_terms" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->user_accepted_terms = TOSAccepted::No;
+                                            else if ( optval == "yes" )
+                                                response->user_accepted_terms = TOSAccepted::Yes;
+                                        }
+                                    }
+                                    else if ( response_terms_of_service_key == "acceptance_token" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->acceptance_token) )
+                                            has_acceptance_token = true;
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_revision )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.terms_of_service.revision\"");
+    }
+
+    if ( ! has_terms )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.terms_of_service.terms\"");
+    }
+
+    if ( ! has_date )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.terms_of_service.date\"");
+    }
+
+    if ( ! has_acceptance_token )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.terms_of_service.acceptance_token\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -151,6 +277,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -425,6 +426,315 @@ bool GmailFromPropertyBranch(
     return true;
 #   undef return_error
 }
+// get_data_type_struct_reader begin
+bool FacebookFromJsonReader(
+        Response * response,
+        Response::Facebook * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "facebook_id" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->id = std::move(optarg);
+            }
+            else if ( key == "date_created" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->date_created = std::move(optarg);
+            }
+            else if ( key == "facebook_url" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->url = std::move(optarg);
+            }
+            else if ( key == "name" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->name = std::move(optarg);
+            }
+            else if ( key == "firstname" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->firstname = std::move(optarg);
+            }
+            else if ( key == "lastname" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->lastname = std::move(optarg);
+            }
+            else if ( key == "hometown" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->hometown = std::move(optarg);
+            }
+            else if ( key == "location" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->location = std::move(optarg);
+            }
+            else if ( key == "i18n" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->i18n = std::move(optarg);
+            }
+            else if ( key == "timezone" )
+            {
+                // create_content_read_single
+                int32_t optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->timezone = std::move(optarg);
+            }
+            else if ( key == "linked" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->linked = Linked::No;
+                    else if ( optval == "yes" )
+                        value->linked = Linked::Yes;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool TwitterFromJsonReader(
+        Response * response,
+        Response::Twitter * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "twitter_id" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->id = std::move(optarg);
+            }
+            else if ( key == "date_created" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->date_created = std::move(optarg);
+            }
+            else if ( key == "screen_name" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->screen_name = std::move(optarg);
+            }
+            else if ( key == "name" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->name = std::move(optarg);
+            }
+            else if ( key == "i18n" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->i18n = std::move(optarg);
+            }
+            else if ( key == "linked" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->linked = Linked::No;
+                    else if ( optval == "yes" )
+                        value->linked = Linked::Yes;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    return valid;
+#   undef set_error
+}
+// get_data_type_struct_reader begin
+bool GmailFromJsonReader(
+        Response * response,
+        Response::Gmail * value,
+        mf::api::JsonReader * reader
+    )
+{
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+        {                                                                      \
+            response->error_code = make_error_code( error_type );              \
+            response->error_string = error_message;                            \
+        }                                                                      \
+        valid = false;                                                         \
+    }
+    bool valid = true;
+    std::size_t member_count = 0;
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            ++member_count;
+            if ( key == "gmail_id" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->id = std::move(optarg);
+            }
+            else if ( key == "created" )
+            {
+                // create_content_read_single
+                boost::posix_time::ptime optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->created = std::move(optarg);
+            }
+            else if ( key == "email" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->email = std::move(optarg);
+            }
+            else if ( key == "gmail_url" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->url = std::move(optarg);
+            }
+            else if ( key == "name" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->name = std::move(optarg);
+            }
+            else if ( key == "firstname" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->first_name = std::move(optarg);
+            }
+            else if ( key == "lastname" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->last_name = std::move(optarg);
+            }
+            else if ( key == "i18n" )
+            {
+                // create_content_read_single
+                std::string optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->i18n = std::move(optarg);
+            }
+            else if ( key == "synced" )
+            {
+                // create_content_read_single
+                boost::posix_time::ptime optarg;
+                if ( reader->ReadValue(&optarg) )
+                    value->synced = std::move(optarg);
+            }
+            else if ( key == "linked" )
+            {
+                // create_content_enum_read
+                std::string optval;
+                if ( reader->ReadValue(&optval) )
+                {
+                    if ( optval == "no" )
+                        value->linked = Linked::No;
+                    else if ( optval == "yes" )
+                        value->linked = Linked::Yes;
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if (member_count == 0)  // Stop if branch is empty
+        return false;
+
+    return valid;
+#   undef set_error
+}
 }  // namespace
 
 namespace mf {
@@ -450,6 +760,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -765,6 +1082,343 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->first_name = "";
+    response->last_name = "";
+    response->gender = Gender::Unknown;
+    response->birth_date = boost::posix_time::not_a_date_time;
+    response->created_datetime = boost::posix_time::not_a_date_time;
+    bool has_ekey = false;
+    bool has_email = false;
+    bool has_display_name = false;
+    bool has_account_type = false;
+    bool has_bandwidth = false;
+    bool has_validated = false;
+    bool has_used_storage_size = false;
+    bool has_base_storage = false;
+    bool has_bonus_storage = false;
+    bool has_storage_limit = false;
+    bool has_storage_limit_exceeded = false;
+    bool has_options = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "user_info" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_user_info_key;
+                                while ( reader->NextMember(&response_user_info_key) )
+                                {
+                                    if ( response_user_info_key == "ekey" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->ekey) )
+                                            has_ekey = true;
+                                    }
+                                    else if ( response_user_info_key == "email" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->email) )
+                                            has_email = true;
+                                    }
+                                    else if ( response_user_info_key == "first_name" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->first_name);
+                                    }
+                                    else if ( response_user_info_key == "last_name" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->last_name);
+                                    }
+                                    else if ( response_user_info_key == "display_name" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->display_name) )
+                                            has_display_name = true;
+                                    }
+                                    else if ( response_user_info_key == "gender" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "unknown" )
+                                                response->gender = Gender::Unknown;
+                                            else if ( optval == "male" )
+                                                response->gender = Gender::Male;
+                                            else if ( optval == "female" )
+                                                response->gender = Gender::Female;
+                                        }
+                                    }
+                                    else if ( response_user_info_key == "birth_date" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->birth_date);
+                                    }
+                                    else if ( response_user_info_key == "location" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->location = std::move(optarg);
+                                    }
+                                    else if ( response_user_info_key == "website" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->website = std::move(optarg);
+                                    }
+                                    else if ( response_user_info_key == "premium" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->account_type = AccountType::Basic;
+                                            else if ( optval == "yes" )
+                                                response->account_type = AccountType::Premium;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.user_info.premium");
+                                            has_account_type = true;
+                                        }
+                                    }
+                                    else if ( response_user_info_key == "bandwidth" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->bandwidth) )
+                                            has_bandwidth = true;
+                                    }
+                                    else if ( response_user_info_key == "created" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->created_datetime);
+                                    }
+                                    else if ( response_user_info_key == "validated" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->validated = Validated::NotValidated;
+                                            else if ( optval == "yes" )
+                                                response->validated = Validated::Validated;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.user_info.validated");
+                                            has_validated = true;
+                                        }
+                                    }
+                                    else if ( response_user_info_key == "tos_accepted" )
+                                    {
+                                        // create_content_read_single
+                                        std::string optarg;
+                                        if ( reader->ReadValue(&optarg) )
+                                            response->tos_accepted = std::move(optarg);
+                                    }
+                                    else if ( response_user_info_key == "used_storage_size" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->used_storage_size) )
+                                            has_used_storage_size = true;
+                                    }
+                                    else if ( response_user_info_key == "base_storage" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->base_storage) )
+                                            has_base_storage = true;
+                                    }
+                                    else if ( response_user_info_key == "bonus_storage" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->bonus_storage) )
+                                            has_bonus_storage = true;
+                                    }
+                                    else if ( response_user_info_key == "storage_limit" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->storage_limit) )
+                                            has_storage_limit = true;
+                                    }
+                                    else if ( response_user_info_key == "storage_limit_exceeded" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->storage_limit_exceeded = LimitExceeded::WithinBounds;
+                                            else if ( optval == "yes" )
+                                                response->storage_limit_exceeded = LimitExceeded::Exceeded;
+                                            else
+                                                set_error(
+                                                    mf::api::api_code::ContentInvalidData,
+                                                    "invalid value in response.user_info.storage_limit_exceeded");
+                                            has_storage_limit_exceeded = true;
+                                        }
+                                    }
+                                    else if ( response_user_info_key == "options" )
+                                    {
+                                        // create_content_read_single
+                                        if ( reader->ReadValue(&response->options) )
+                                            has_options = true;
+                                    }
+                                    else if ( response_user_info_key == "facebook" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::Facebook optarg;
+                                        if ( FacebookFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->facebook = std::move(optarg);
+                                        }
+                                    }
+                                    else if ( response_user_info_key == "twitter" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::Twitter optarg;
+                                        if ( TwitterFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->twitter = std::move(optarg);
+                                        }
+                                    }
+                                    else if ( response_user_info_key == "gmail" )
+                                    {
+                                        // create_content_struct_read TSingle
+                                        Response::Gmail optarg;
+                                        if ( GmailFromJsonReader(response, &optarg, reader) )
+                                        {
+                                            response->gmail = std::move(optarg);
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_ekey )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.ekey\"");
+    }
+
+    if ( ! has_email )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.email\"");
+    }
+
+    if ( ! has_display_name )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.display_name\"");
+    }
+
+    if ( ! has_account_type )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.user_info.premium");
+    }
+
+    if ( ! has_bandwidth )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.bandwidth\"");
+    }
+
+    if ( ! has_validated )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.user_info.validated");
+    }
+
+    if ( ! has_used_storage_size )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.used_storage_size\"");
+    }
+
+    if ( ! has_base_storage )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.base_storage\"");
+    }
+
+    if ( ! has_bonus_storage )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.bonus_storage\"");
+    }
+
+    if ( ! has_storage_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.storage_limit\"");
+    }
+
+    if ( ! has_storage_limit_exceeded )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "no value in response.user_info.storage_limit_exceeded");
+    }
+
+    if ( ! has_options )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.user_info.options\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -787,6 +1441,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -45,6 +46,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -194,6 +202,225 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    bool has_storage_base = false;
+    bool has_storage_bonus = false;
+    bool has_storage_limit = false;
+    bool has_storage_used = false;
+    bool has_bandwidth_limit = false;
+    bool has_bandwidth_used = false;
+    bool has_collaboration_limit = false;
+    bool has_collaboration_today = false;
+    bool has_one_time_downloads_limit = false;
+    bool has_one_time_downloads_today = false;
+    bool has_streaming_bandwidth_limit = false;
+    bool has_streaming_bandwidth_today = false;
+    bool has_upload_size_limit = false;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "storage_base" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->storage_base) )
+                                has_storage_base = true;
+                        }
+                        else if ( response_key == "storage_bonus" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->storage_bonus) )
+                                has_storage_bonus = true;
+                        }
+                        else if ( response_key == "storage_limit" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->storage_limit) )
+                                has_storage_limit = true;
+                        }
+                        else if ( response_key == "storage_used" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->storage_used) )
+                                has_storage_used = true;
+                        }
+                        else if ( response_key == "bandwidth_limit" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->bandwidth_limit) )
+                                has_bandwidth_limit = true;
+                        }
+                        else if ( response_key == "bandwidth_used" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->bandwidth_used) )
+                                has_bandwidth_used = true;
+                        }
+                        else if ( response_key == "collaboration_limit" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->collaboration_limit) )
+                                has_collaboration_limit = true;
+                        }
+                        else if ( response_key == "collaboration_today" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->collaboration_today) )
+                                has_collaboration_today = true;
+                        }
+                        else if ( response_key == "one_time_downloads_limit" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->one_time_downloads_limit) )
+                                has_one_time_downloads_limit = true;
+                        }
+                        else if ( response_key == "one_time_downloads_today" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->one_time_downloads_today) )
+                                has_one_time_downloads_today = true;
+                        }
+                        else if ( response_key == "streaming_bandwidth_limit" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->streaming_bandwidth_limit) )
+                                has_streaming_bandwidth_limit = true;
+                        }
+                        else if ( response_key == "streaming_bandwidth_today" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->streaming_bandwidth_today) )
+                                has_streaming_bandwidth_today = true;
+                        }
+                        else if ( response_key == "upload_size_limit" )
+                        {
+                            // create_content_read_single
+                            if ( reader->ReadValue(&response->upload_size_limit) )
+                                has_upload_size_limit = true;
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+    if ( ! has_storage_base )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.storage_base\"");
+    }
+
+    if ( ! has_storage_bonus )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.storage_bonus\"");
+    }
+
+    if ( ! has_storage_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.storage_limit\"");
+    }
+
+    if ( ! has_storage_used )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.storage_used\"");
+    }
+
+    if ( ! has_bandwidth_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.bandwidth_limit\"");
+    }
+
+    if ( ! has_bandwidth_used )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.bandwidth_used\"");
+    }
+
+    if ( ! has_collaboration_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.collaboration_limit\"");
+    }
+
+    if ( ! has_collaboration_today )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.collaboration_today\"");
+    }
+
+    if ( ! has_one_time_downloads_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.one_time_downloads_limit\"");
+    }
+
+    if ( ! has_one_time_downloads_today )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.one_time_downloads_today\"");
+    }
+
+    if ( ! has_streaming_bandwidth_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.streaming_bandwidth_limit\"");
+    }
+
+    if ( ! has_streaming_bandwidth_today )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.streaming_bandwidth_today\"");
+    }
+
+    if ( ! has_upload_size_limit )
+    {
+        set_error(
+            mf::api::api_code::ContentInvalidData,
+            "missing \"response.upload_size_limit\"");
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -216,6 +443,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
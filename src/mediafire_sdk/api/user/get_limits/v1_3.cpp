@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -45,6 +46,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -168,6 +176,121 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->storage_base = 0;
+    response->storage_bonus = 0;
+    response->storage_limit = 0;
+    response->storage_used = 0;
+    response->bandwidth_limit = 0;
+    response->bandwidth_used = 0;
+    response->collaboration_limit = 0;
+    response->collaboration_today = 0;
+    response->one_time_downloads_limit = 0;
+    response->one_time_downloads_today = 0;
+    response->streaming_bandwidth_limit = 0;
+    response->streaming_bandwidth_today = 0;
+    response->upload_size_limit = 0;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "storage_base" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->storage_base);
+                        }
+                        else if ( response_key == "storage_bonus" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->storage_bonus);
+                        }
+                        else if ( response_key == "storage_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->storage_limit);
+                        }
+                        else if ( response_key == "storage_used" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->storage_used);
+                        }
+                        else if ( response_key == "bandwidth_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->bandwidth_limit);
+                        }
+                        else if ( response_key == "bandwidth_used" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->bandwidth_used);
+                        }
+                        else if ( response_key == "collaboration_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->collaboration_limit);
+                        }
+                        else if ( response_key == "collaboration_today" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->collaboration_today);
+                        }
+                        else if ( response_key == "one_time_downloads_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->one_time_downloads_limit);
+                        }
+                        else if ( response_key == "one_time_downloads_today" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->one_time_downloads_today);
+                        }
+                        else if ( response_key == "streaming_bandwidth_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->streaming_bandwidth_limit);
+                        }
+                        else if ( response_key == "streaming_bandwidth_today" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->streaming_bandwidth_today);
+                        }
+                        else if ( response_key == "upload_size_limit" )
+                        {
+                            // create_content_read_single
+                            reader->ReadValue(&response->upload_size_limit);
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -190,6 +313,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/api/json_reader.hpp"
 #include "mediafire_sdk/api/ptree_helpers.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/api/session_token_api_base.hpp"
@@ -45,6 +46,13 @@ public:
 
     virtual void ParseResponse( Response * response ) override;
 
+    virtual bool HasResponseReader() const override { return true; }
+
+    virtual void ReadResponse(
+            Response * response,
+            mf::api::JsonReader * reader
+        ) override;
+
     mf::http::SharedBuffer::Pointer GetPostData();
 
     mf::api::RequestMethod GetRequestMethod() const
@@ -244,6 +252,216 @@ void Impl::ParseResponse( Response * response )
 #   undef return_error
 }
 
+void Impl::ReadResponse(
+        Response * response,
+        mf::api::JsonReader * reader
+    )
+{
+    // Errors are recorded, but the whole document must still be read.
+#   define set_error(error_type, error_message)                                \
+    {                                                                          \
+        if ( ! response->error_code )                                          \
+            SetError(response, error_type, error_message);                     \
+    }
+    response->email_address_validated = EmailValidation::NeedsValidation;
+    response->instant_uploads = InstantUploads::Disabled;
+    response->show_download_page_me_from_me = DownloadPage::NotSkipped;
+    response->show_download_page_me_from_others = DownloadPage::NotSkipped;
+    response->show_download_page_others_from_me = DownloadPage::NotSkipped;
+    response->auto_bandwidth = AutoBandwidth::NoAction;
+    response->used_storage_size = 0;
+    response->storage_limit = 0;
+    response->storage_limit_exceeded = StorageLimit::InBounds;
+    response->previous_file_versions = 0;
+    response->share_link_status = ShareLinkStatus::Inherit;
+    response->collect_metadata = CollectMetadata::No;
+
+    if ( reader->BeginObject() )
+    {
+        std::string key;
+        while ( reader->NextMember(&key) )
+        {
+            if ( key == "response" )
+            {
+                if ( reader->BeginObject() )
+                {
+                    std::string response_key;
+                    while ( reader->NextMember(&response_key) )
+                    {
+                        if ( response_key == "settings" )
+                        {
+                            if ( reader->BeginObject() )
+                            {
+                                std::string response_settings_key;
+                                while ( reader->NextMember(&response_settings_key) )
+                                {
+                                    if ( response_settings_key == "validated" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->email_address_validated = EmailValidation::NeedsValidation;
+                                            else if ( optval == "yes" )
+                                                response->email_address_validated = EmailValidation::Validated;
+                                        }
+                                    }
+                                    else if ( response_settings_key == "instant_uploads_enabled" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->instant_uploads = InstantUploads::Disabled;
+                                            else if ( optval == "yes" )
+                                                response->instant_uploads = InstantUploads::Enabled;
+                                        }
+                                    }
+                                    else if ( response_settings_key == "show_download_page" )
+                                    {
+                                        if ( reader->BeginObject() )
+                                        {
+                                            std::string response_settings_show_download_page_key;
+                                            while ( reader->NextMember(&response_settings_show_download_page_key) )
+                                            {
+                                                if ( response_settings_show_download_page_key == "me_from_me" )
+                                                {
+                                                    // create_content_enum_read
+                                                    std::string optval;
+                                                    if ( reader->ReadValue(&optval) )
+                                                    {
+                                                        if ( optval == "no" )
+                                                            response->show_download_page_me_from_me = DownloadPage::Skipped;
+                                                        else if ( optval == "yes" )
+                                                            response->show_download_page_me_from_me = DownloadPage::NotSkipped;
+                                                    }
+                                                }
+                                                else if ( response_settings_show_download_page_key == "me_from_others" )
+                                                {
+                                                    // create_content_enum_read
+                                                    std::string optval;
+                                                    if ( reader->ReadValue(&optval) )
+                                                    {
+                                                        if ( optval == "no" )
+                                                            response->show_download_page_me_from_others = DownloadPage::Skipped;
+                                                        else if ( optval == "yes" )
+                                                            response->show_download_page_me_from_others = DownloadPage::NotSkipped;
+                                                    }
+                                                }
+                                                else if ( response_settings_show_download_page_key == "others_from_me" )
+                                                {
+                                                    // create_content_enum_read
+                                                    std::string optval;
+                                                    if ( reader->ReadValue(&optval) )
+                                                    {
+                                                        if ( optval == "no" )
+                                                            response->show_download_page_others_from_me = DownloadPage::Skipped;
+                                                        else if ( optval == "yes" )
+                                                            response->show_download_page_others_from_me = DownloadPage::NotSkipped;
+                                                    }
+                                                }
+                                                else
+                                                    reader->Skip();
+                                            }
+                                        }
+                                    }
+                                    else if ( response_settings_key == "auto_bandwidth" )
+                                    {
+                                        if ( reader->BeginObject() )
+                                        {
+                                            std::string response_settings_auto_bandwidth_key;
+                                            while ( reader->NextMember(&response_settings_auto_bandwidth_key) )
+                                            {
+                                                if ( response_settings_auto_bandwidth_key == "enabled" )
+                                                {
+                                                    // create_content_enum_read
+                                                    std::string optval;
+                                                    if ( reader->ReadValue(&optval) )
+                                                    {
+                                                        if ( optval == "no" )
+                                                            response->auto_bandwidth = AutoBandwidth::NoAction;
+                                                        else if ( optval == "yes" )
+                                                            response->auto_bandwidth = AutoBandwidth::PurchaseMoreAutomatically;
+                                                    }
+                                                }
+                                                else
+                                                    reader->Skip();
+                                            }
+                                        }
+                                    }
+                                    else if ( response_settings_key == "used_storage_size" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->used_storage_size);
+                                    }
+                                    else if ( response_settings_key == "storage_limit" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->storage_limit);
+                                    }
+                                    else if ( response_settings_key == "storage_limit_exceeded" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->storage_limit_exceeded = StorageLimit::InBounds;
+                                            else if ( optval == "yes" )
+                                                response->storage_limit_exceeded = StorageLimit::Exceeded;
+                                        }
+                                    }
+                                    else if ( response_settings_key == "previous_file_versions" )
+                                    {
+                                        // create_content_read_single
+                                        reader->ReadValue(&response->previous_file_versions);
+                                    }
+                                    else if ( response_settings_key == "share_link_status" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "disabled" )
+                                                response->share_link_status = ShareLinkStatus::Disabled;
+                                            else if ( optval == "enabled" )
+                                                response->share_link_status = ShareLinkStatus::Enabled;
+                                            else if ( optval == "inherit" )
+                                                response->share_link_status = ShareLinkStatus::Inherit;
+                                        }
+                                    }
+                                    else if ( response_settings_key == "collect_metadata" )
+                                    {
+                                        // create_content_enum_read
+                                        std::string optval;
+                                        if ( reader->ReadValue(&optval) )
+                                        {
+                                            if ( optval == "no" )
+                                                response->collect_metadata = CollectMetadata::No;
+                                            else if ( optval == "yes" )
+                                                response->collect_metadata = CollectMetadata::Yes;
+                                        }
+                                    }
+                                    else
+                                        reader->Skip();
+                                }
+                            }
+                        }
+                        else
+                            response->ReadEnvelopeMember(response_key, reader);
+                    }
+                }
+            }
+            else
+                reader->Skip();
+        }
+    }
+
+#   undef set_error
+}
+
 mf::http::SharedBuffer::Pointer Impl::GetPostData()
 {
     std::map<std::string, std::string> parts;
@@ -266,6 +484,21 @@ void Request::SetCallback( CallbackType callback_function )
     impl_->SetCallback(callback_function);
 }
 
+void Request::SetDiagnosticsLevel( DiagnosticsLevel diagnostics_level )
+{
+    impl_->SetDiagnosticsLevel(diagnostics_level);
+}
+
+void Request::SetResponseParser( ResponseParser response_parser )
+{
+    impl_->SetResponseParser(response_parser);
+}
+
+void Request::SetRequestTimings( const mf::http::RequestTimings & timings )
+{
+    impl_->SetRequestTimings(timings);
+}
+
 void Request::HandleContent(
         const std::string & url,
         const mf::http::Headers & headers,
@@ -0,0 +1,339 @@
+/**
+ * @file download_manager_impl.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "download_manager_impl.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "boost/bind.hpp"
+#include "boost/variant/apply_visitor.hpp"
+
+#include "mediafire_sdk/api/session_maintainer.hpp"
+#include "mediafire_sdk/downloader/error.hpp"
+
+namespace {
+// Files smaller than a segment are downloaded with a single request.
+const uint64_t kDefaultSegmentSize = 8 * 1024 * 1024;
+const uint64_t kMinSegmentSize = 256 * 1024;
+
+mf::downloader::detail::DownloadHandle NextDownloadHandle()
+{
+    static mf::downloader::detail::DownloadHandle download_handle = {0};
+    static mf::utils::mutex mutex;
+
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex);
+    ++download_handle.id;
+    return download_handle;
+}
+}  // namespace
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+DownloadManagerImpl::DownloadManagerImpl(
+        ::mf::api::SessionMaintainer * session_maintainer
+    ) :
+    session_maintainer_(session_maintainer),
+    io_service_(session_maintainer->HttpConfig()->GetWorkIoService()),
+    max_concurrent_downloads_(2),
+    max_concurrent_segments_(8),
+    max_concurrent_segments_per_download_(4),
+    segment_size_(kDefaultSegmentSize),
+    current_segments_(0),
+    verify_work_(new boost::asio::io_service::work(verify_io_service_)),
+    disable_enqueue_(false)
+{
+    verify_thread_ = boost::thread(
+        [this]()
+        {
+            verify_io_service_.run();
+        });
+}
+
+DownloadManagerImpl::~DownloadManagerImpl()
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    disable_enqueue_ = true;
+
+    std::set<FileDownloadPointer> downloads;
+    std::swap(downloads, downloads_);
+
+    // Unlock before calling external
+    lock.unlock();
+
+    // Data written so far is kept, so adding the files again resumes them.
+    for (auto & download : downloads)
+    {
+        download->Disconnect();
+        download->Stop(make_error_code(mf::downloader::errc::Cancelled),
+            "Cancelled due to shutdown.", true);
+    }
+
+    verify_work_.reset();
+    verify_io_service_.stop();
+    verify_thread_.join();
+}
+
+DownloadHandle DownloadManagerImpl::Add(
+        const DownloadRequest & download_request,
+        StatusCallback callback
+    )
+{
+    auto download_handle = NextDownloadHandle();
+    DownloadConfig config;
+
+    config.download_handle = download_handle;
+    config.callback_interface =
+        static_cast<FileDownloadCallbackInterface*>(this);
+    config.session_maintainer = session_maintainer_;
+    config.quickkey = download_request.quickkey_;
+    config.filepath = download_request.local_file_path_;
+    config.status_callback = callback;
+    config.direct_download_url = download_request.direct_download_url_;
+    config.filesize = download_request.filesize_;
+    config.hash = download_request.hash_;
+    config.verify_io_service = &verify_io_service_;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        config.max_concurrent_segments =
+            download_request.max_concurrent_segments_
+            ? *download_request.max_concurrent_segments_
+            : max_concurrent_segments_per_download_;
+        config.segment_size = segment_size_;
+    }
+
+    auto download = std::make_shared<FileDownload>(std::move(config));
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        downloads_.insert(download);
+        to_start_.push_back(download);
+    }
+
+    download->Enqueue();
+
+    EnqueueTick();
+
+    return download_handle;
+}
+
+void DownloadManagerImpl::ModifyDownload(
+        DownloadHandle download_handle,
+        ::mf::downloader::DownloadModification download_modification
+    )
+{
+    class Visitor : public boost::static_visitor<>
+    {
+    public:
+        Visitor(
+                DownloadManagerImpl * dm,
+                DownloadHandle download_handle
+            ) :
+            this_(dm), download_handle_(download_handle)
+        {}
+
+        void operator()(modification::Cancel) const
+        {
+            if (auto download = Find())
+            {
+                download->Stop(
+                    make_error_code(mf::downloader::errc::Cancelled),
+                    "Cancellation requested", false);
+            }
+        }
+
+        void operator()(modification::Pause) const
+        {
+            if (auto download = Find())
+            {
+                download->Stop(
+                    make_error_code(mf::downloader::errc::Paused),
+                    "Pause requested.", true);
+            }
+        }
+
+    private:
+        FileDownloadPointer Find() const
+        {
+            mf::utils::lock_guard<mf::utils::mutex> lock(this_->mutex_);
+            for (auto & download : this_->downloads_)
+            {
+                if (download->Handle().id == download_handle_.id)
+                    return download;
+            }
+            return FileDownloadPointer();
+        }
+
+        DownloadManagerImpl * this_;
+        const DownloadHandle download_handle_;
+    };
+
+    boost::apply_visitor(Visitor(this, download_handle),
+        download_modification);
+}
+
+void DownloadManagerImpl::SetMaxConcurrentDownloads(uint32_t max_downloads)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        max_concurrent_downloads_ = std::max<uint32_t>(1, max_downloads);
+    }
+
+    EnqueueTick();
+}
+
+uint32_t DownloadManagerImpl::GetMaxConcurrentDownloads()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return max_concurrent_downloads_;
+}
+
+void DownloadManagerImpl::SetMaxConcurrentSegments(uint32_t max_segments)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        max_concurrent_segments_ = std::max<uint32_t>(1, max_segments);
+    }
+
+    EnqueueTick();
+}
+
+uint32_t DownloadManagerImpl::GetMaxConcurrentSegments()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return max_concurrent_segments_;
+}
+
+void DownloadManagerImpl::SetMaxConcurrentSegmentsPerDownload(
+        uint32_t max_segments
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    max_concurrent_segments_per_download_ = std::max<uint32_t>(1,
+        max_segments);
+}
+
+void DownloadManagerImpl::SetSegmentSize(uint64_t bytes)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    segment_size_ = std::max(bytes, kMinSegmentSize);
+}
+
+uint64_t DownloadManagerImpl::GetSegmentSize()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return segment_size_;
+}
+
+void DownloadManagerImpl::Tick()
+{
+    std::vector<FileDownloadPointer> to_start;
+    std::vector<FileDownloadPointer> active;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        for (auto it = to_start_.begin(); it != to_start_.end()
+            && active_.size() < max_concurrent_downloads_;)
+        {
+            auto download = *it;
+
+            // Two downloads to the same file would overwrite each other.
+            if (active_part_paths_.count(download->PartPath()))
+            {
+                ++it;
+                continue;
+            }
+
+            it = to_start_.erase(it);
+
+            active_part_paths_.insert(download->PartPath());
+            active_.push_back(download);
+            to_start.push_back(download);
+        }
+
+        // Each download gets the first pick of free slots in turn.
+        if (active_.size() > 1)
+            std::rotate(active_.begin(), active_.begin() + 1, active_.end());
+
+        active = active_;
+    }
+
+    // Unlocked, as downloads call back into the manager.
+    for (auto & download : to_start)
+    {
+        io_service_->post(
+            [download]()
+            {
+                download->Start();
+            });
+    }
+
+    for (auto & download : active)
+        download->StartSegments();
+}
+
+void DownloadManagerImpl::EnqueueTick()
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    if ( ! disable_enqueue_ )
+    {
+        io_service_->post( boost::bind( &DownloadManagerImpl::Tick,
+                shared_from_this()) );
+    }
+}
+
+bool DownloadManagerImpl::AcquireSegmentSlot()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (current_segments_ >= max_concurrent_segments_)
+        return false;
+
+    ++current_segments_;
+    return true;
+}
+
+void DownloadManagerImpl::ReleaseSegmentSlots(uint32_t count)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        assert(current_segments_ >= count);
+        current_segments_ -= count;
+    }
+
+    EnqueueTick();
+}
+
+void DownloadManagerImpl::HandleComplete(FileDownloadPointer download)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        downloads_.erase(download);
+
+        auto queued = std::find(to_start_.begin(), to_start_.end(), download);
+        if (queued != to_start_.end())
+            to_start_.erase(queued);
+
+        auto active = std::find(active_.begin(), active_.end(), download);
+        if (active != active_.end())
+        {
+            active_.erase(active);
+            active_part_paths_.erase(download->PartPath());
+        }
+    }
+
+    EnqueueTick();
+}
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
@@ -0,0 +1,112 @@
+/**
+ * @file download_manager_impl.hpp
+ * @author Herbert Jones
+ * @brief Private implementation for the download manager
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/thread/thread.hpp"
+
+#include "../download_modification.hpp"
+#include "../download_request.hpp"
+#include "../download_status.hpp"
+
+#include "file_download.hpp"
+
+#include "mediafire_sdk/utils/mutex.hpp"
+
+// Forward declarations
+namespace mf { namespace api { class SessionMaintainer; } }
+// END forward declarations
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+/**
+ * @class DownloadManagerImpl
+ * @brief Manage a set of downloads.
+ */
+class DownloadManagerImpl :
+    public FileDownloadCallbackInterface,
+    public std::enable_shared_from_this<DownloadManagerImpl>
+{
+public:
+    DownloadManagerImpl(
+            ::mf::api::SessionMaintainer * session_maintainer
+        );
+    virtual ~DownloadManagerImpl();
+
+    DownloadHandle Add(
+            const DownloadRequest & request,
+            StatusCallback callback
+        );
+    void ModifyDownload(
+            DownloadHandle download_handle,
+            ::mf::downloader::DownloadModification modification
+        );
+
+    void SetMaxConcurrentDownloads(uint32_t max_downloads);
+    uint32_t GetMaxConcurrentDownloads();
+
+    void SetMaxConcurrentSegments(uint32_t max_segments);
+    uint32_t GetMaxConcurrentSegments();
+
+    void SetMaxConcurrentSegmentsPerDownload(uint32_t max_segments);
+
+    void SetSegmentSize(uint64_t bytes);
+    uint64_t GetSegmentSize();
+
+private:
+    ::mf::api::SessionMaintainer * session_maintainer_;
+    boost::asio::io_service * io_service_;
+
+    /** All downloads not yet complete. */
+    std::set<FileDownloadPointer> downloads_;
+
+    std::deque<FileDownloadPointer> to_start_;
+
+    /** Started downloads, in the order they get segment slots. */
+    std::vector<FileDownloadPointer> active_;
+
+    /** Partial files of started downloads, which must not be shared. */
+    std::set<boost::filesystem::path> active_part_paths_;
+
+    uint32_t max_concurrent_downloads_;
+    uint32_t max_concurrent_segments_;
+    uint32_t max_concurrent_segments_per_download_;
+    uint64_t segment_size_;
+
+    uint32_t current_segments_;
+
+    // Hashing of completed downloads is kept off the io_service.
+    boost::asio::io_service verify_io_service_;
+    std::unique_ptr<boost::asio::io_service::work> verify_work_;
+    boost::thread verify_thread_;
+
+    bool disable_enqueue_;
+
+    mf::utils::mutex mutex_;
+
+    void Tick();
+    void EnqueueTick();
+
+    // -- FileDownloadCallbackInterface ----------------------------------------
+    virtual bool AcquireSegmentSlot() override;
+    virtual void ReleaseSegmentSlots(uint32_t count) override;
+    virtual void HandleComplete(FileDownloadPointer) override;
+    // -- END FileDownloadCallbackInterface ------------------------------------
+};
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
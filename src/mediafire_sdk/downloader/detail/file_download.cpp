@@ -0,0 +1,807 @@
+/**
+ * @file file_download.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "file_download.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/filesystem.hpp"
+
+#include "mediafire_sdk/api/file/get_info.hpp"
+#include "mediafire_sdk/api/file/get_links.hpp"
+#include "mediafire_sdk/api/session_maintainer.hpp"
+#include "mediafire_sdk/downloader/error.hpp"
+#include "mediafire_sdk/http/request_response_interface.hpp"
+#include "mediafire_sdk/utils/error/codes/fileio.hpp"
+#include "mediafire_sdk/utils/sha256_hasher.hpp"
+#include "mediafire_sdk/utils/string.hpp"
+
+namespace get_info = mf::api::file::get_info;
+namespace get_links = mf::api::file::get_links;
+namespace ds = mf::downloader::download_state;
+using sclock = std::chrono::steady_clock;
+
+namespace {
+// A segment may be lost on a crash, so progress within segments is saved this
+// often as well.
+const std::chrono::seconds kJournalInterval(5);
+
+const std::size_t kVerifyReadSize = 1024 * 1024;
+
+using mf::downloader::detail::FileDownload;
+using mf::downloader::detail::FileDownloadPointer;
+
+/**
+ * @class SegmentResponse
+ * @brief Passes the response of a segment request to its download.
+ */
+class SegmentResponse : public mf::http::RequestResponseInterface
+{
+public:
+    SegmentResponse(
+            FileDownloadPointer download,
+            std::size_t index
+        ) :
+        download_(download),
+        index_(index)
+    {}
+
+    virtual void RedirectHeaderReceived(
+            const mf::http::Headers &,
+            const mf::http::Url &
+        ) override
+    {}
+
+    virtual void ResponseHeaderReceived(
+            const mf::http::Headers & headers
+        ) override
+    {
+        download_->HandleSegmentHeader(index_, headers);
+    }
+
+    virtual void ResponseContentReceived(
+            size_t start_pos,
+            std::shared_ptr<mf::http::BufferInterface> buffer
+        ) override
+    {
+        download_->HandleSegmentContent(index_, start_pos, buffer);
+    }
+
+    virtual void RequestResponseErrorEvent(
+            std::error_code error_code,
+            std::string error_text
+        ) override
+    {
+        download_->HandleSegmentError(index_, error_code, error_text);
+    }
+
+    virtual void RequestResponseCompleteEvent() override
+    {
+        download_->HandleSegmentComplete(index_);
+    }
+
+private:
+    FileDownloadPointer download_;
+    std::size_t index_;
+};
+
+/** Read the first byte position from "bytes 100-199/1000". */
+bool ParseContentRangeStart(
+        mf::http::HeaderValue value,
+        uint64_t * first
+    )
+{
+    const std::string content_range(value.begin(), value.end());
+    uint64_t last = 0;
+
+    return std::sscanf(content_range.c_str(),
+        "bytes %" SCNu64 "-%" SCNu64, first, &last) == 2 && *first <= last;
+}
+
+std::error_code ToErrorCode(const boost::system::error_code & bec)
+{
+    return std::error_code(bec.value(), std::system_category());
+}
+}  // namespace
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+FileDownload::FileDownload(DownloadConfig config) :
+    config_(std::move(config)),
+    io_service_(config_.session_maintainer->HttpConfig()->GetWorkIoService()),
+    part_path_(config_.filepath.string() + ".mfpart"),
+    journal_path_(config_.filepath.string() + ".mfpart.segments"),
+    state_(State::Created),
+    filename_(config_.filepath.filename().string()),
+    stopped_(false)
+{
+}
+
+FileDownload::~FileDownload()
+{
+}
+
+void FileDownload::Enqueue()
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (state_ != State::Created)
+            return;
+        state_ = State::Enqueued;
+    }
+
+    SendStatus(ds::EnqueuedForDownload{});
+}
+
+void FileDownload::Start()
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (state_ != State::Created && state_ != State::Enqueued)
+            return;
+        state_ = State::Preparing;
+    }
+
+    SendStatus(ds::Preparing{});
+
+    if (config_.direct_download_url)
+    {
+        HandleFileInfo(config_.filesize, config_.hash, filename_);
+        return;
+    }
+
+    auto self = shared_from_this();
+    config_.session_maintainer->Call(
+        get_info::Request(config_.quickkey),
+        [self](const get_info::Response & response)
+        {
+            if (response.error_code)
+            {
+                self->Stop(response.error_code,
+                    (response.error_string ? *response.error_string
+                        : "Unable to get file information"), true);
+            }
+            else
+            {
+                self->HandleFileInfo(response.filesize, response.hash,
+                    response.filename);
+            }
+        },
+        io_service_);
+}
+
+void FileDownload::HandleFileInfo(
+        uint64_t filesize,
+        std::string hash,
+        std::string filename
+    )
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (state_ != State::Preparing)
+            return;
+
+        config_.filesize = filesize;
+        config_.hash = hash;
+        filename_ = filename;
+    }
+
+    if (config_.direct_download_url)
+    {
+        HandleDirectDownload(*config_.direct_download_url);
+        return;
+    }
+
+    get_links::Request request({config_.quickkey});
+    request.SetLinkTypes({get_links::LinkType::DirectDownload});
+
+    auto self = shared_from_this();
+    config_.session_maintainer->Call(
+        request,
+        [self](const get_links::Response & response)
+        {
+            if (response.error_code)
+            {
+                self->Stop(response.error_code,
+                    (response.error_string ? *response.error_string
+                        : "Unable to get download link"), true);
+                return;
+            }
+
+            for (const auto & links : response.links)
+            {
+                if (links.quickkey != self->config_.quickkey)
+                    continue;
+
+                if (links.direct_download)
+                {
+                    self->HandleDirectDownload(*links.direct_download);
+                    return;
+                }
+
+                if (links.direct_download_error_message)
+                {
+                    self->Stop(
+                        make_error_code(errc::DirectDownloadUnavailable),
+                        *links.direct_download_error_message, true);
+                    return;
+                }
+            }
+
+            self->Stop(make_error_code(errc::DirectDownloadUnavailable),
+                "No direct download link returned", true);
+        },
+        io_service_);
+}
+
+void FileDownload::HandleDirectDownload(std::string url)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (state_ != State::Preparing)
+            return;
+
+        url_ = url;
+    }
+
+    BeginDownload();
+}
+
+void FileDownload::BeginDownload()
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    if (state_ != State::Preparing)
+        return;
+
+    const std::error_code error = OpenPartFile();
+    if (error)
+    {
+        lock.unlock();
+        Stop(make_error_code(errc::FileError),
+            "Unable to open partial file: " + error.message(), true);
+        return;
+    }
+
+    state_ = State::Downloading;
+
+    const ds::Downloading downloading{segments_->BytesReceived(),
+        segments_->Filesize()};
+    const bool complete = segments_->Complete();
+
+    lock.unlock();
+
+    SendStatus(downloading);
+
+    if (complete)
+        Verify();
+    else
+        StartSegments();
+}
+
+std::error_code FileDownload::OpenPartFile()
+{
+    // Must be called with the mutex held.
+    std::error_code error;
+    boost::system::error_code bec;
+
+    // Resume if what is on disk is for this version of the file.
+    if (boost::filesystem::exists(journal_path_, bec)
+        && boost::filesystem::exists(part_path_, bec))
+    {
+        auto journal = mf::utils::FileIO::Open(journal_path_, "rb", &error);
+        if (journal)
+        {
+            auto segments = SegmentMap::Parse(
+                journal->ReadString(mf::utils::FileIO::skDefaultReadSize,
+                    nullptr),
+                config_.filesize, config_.hash);
+
+            if (segments)
+            {
+                file_ = mf::utils::FileIO::Open(part_path_, "r+b", &error);
+                if (file_)
+                    segments_.reset(new SegmentMap(*segments));
+            }
+        }
+    }
+
+    if ( ! file_ )
+    {
+        file_ = mf::utils::FileIO::Open(part_path_, "w+b", &error);
+        if ( ! file_ )
+            return error;
+
+        segments_.reset(new SegmentMap(config_.filesize,
+            config_.segment_size));
+    }
+
+    return SaveJournal();
+}
+
+std::error_code FileDownload::SaveJournal()
+{
+    // Must be called with the mutex held.  The data must be on disk before
+    // the journal claims it is.
+    std::error_code error;
+    if (file_)
+    {
+        file_->Flush(&error);
+        if (error)
+            return error;
+    }
+
+    const boost::filesystem::path temporary_path =
+        journal_path_.string() + ".tmp";
+
+    {
+        auto journal = mf::utils::FileIO::Open(temporary_path, "wb", &error);
+        if ( ! journal )
+            return error;
+
+        const std::string text = segments_->Serialize(config_.hash);
+        if (journal->WriteString(text, &error) != text.size())
+            return error ? error : make_error_code(errc::FileError);
+    }
+
+    // Replace at once so a crash never leaves half a journal.
+    boost::system::error_code bec;
+    boost::filesystem::rename(temporary_path, journal_path_, bec);
+    if (bec)
+        return ToErrorCode(bec);
+
+    journal_saved_ = sclock::now();
+
+    return std::error_code();
+}
+
+void FileDownload::RemovePartialFiles()
+{
+    boost::system::error_code bec;
+    boost::filesystem::remove(part_path_, bec);
+    boost::filesystem::remove(journal_path_, bec);
+}
+
+void FileDownload::StartSegments()
+{
+    std::vector<mf::http::HttpRequest::Pointer> to_start;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        if (state_ != State::Downloading || ! config_.callback_interface)
+            return;
+
+        while (requests_.size() < config_.max_concurrent_segments)
+        {
+            if ( ! config_.callback_interface->AcquireSegmentSlot() )
+                break;
+
+            const auto index = segments_->StartNext();
+            if ( ! index )
+            {
+                config_.callback_interface->ReleaseSegmentSlots(1);
+                break;
+            }
+
+            const auto & segment = segments_->GetSegment(*index);
+            const uint64_t first = segment.offset + segment.received;
+            const uint64_t last = segment.offset + segment.size - 1;
+
+            auto request = mf::http::HttpRequest::Create(
+                config_.session_maintainer->HttpConfig(),
+                std::make_shared<SegmentResponse>(shared_from_this(),
+                    *index),
+                io_service_,
+                url_);
+
+            request->SetHeader("Range", "bytes=" + mf::utils::to_string(first)
+                + "-" + mf::utils::to_string(last));
+
+            // Ranges are positions in the file as stored, so it must not be
+            // encoded.
+            request->SetHeader("Accept-Encoding", "identity");
+
+            requests_[*index] = SegmentRequest{request, segment.received};
+            to_start.push_back(request);
+        }
+    }
+
+    for (auto & request : to_start)
+        request->Start();
+}
+
+void FileDownload::HandleSegmentHeader(
+        std::size_t index,
+        const mf::http::Headers & headers
+    )
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    auto it = requests_.find(index);
+    if (state_ != State::Downloading || it == requests_.end())
+        return;
+
+    const auto & segment = segments_->GetSegment(index);
+    const uint64_t expected_first = segment.offset + it->second.base;
+
+    std::error_code error;
+    std::string description;
+
+    if (headers.status_code == 206)
+    {
+        uint64_t first = 0;
+        auto content_range = headers.Find("Content-Range");
+        if ( ! content_range
+            || ! ParseContentRangeStart(*content_range, &first)
+            || first != expected_first )
+        {
+            error = make_error_code(errc::BadDownloadResponse);
+            description = "Content-Range does not match the request.";
+        }
+    }
+    else if (headers.status_code == 200)
+    {
+        error = make_error_code(errc::RangeNotSupported);
+        description = "Server ignored the range request.";
+    }
+    else
+    {
+        error = make_error_code(errc::BadDownloadResponse);
+        description = "Unexpected HTTP status: "
+            + mf::utils::to_string(headers.status_code) + " "
+            + headers.status_message;
+    }
+
+    if (error)
+    {
+        lock.unlock();
+
+        // The request is still parsing headers and can't be cancelled from
+        // within this callback.
+        auto self = shared_from_this();
+        io_service_->post(
+            [self, error, description]()
+            {
+                self->Stop(error, description, true);
+            });
+    }
+}
+
+void FileDownload::HandleSegmentContent(
+        std::size_t index,
+        std::size_t start_pos,
+        std::shared_ptr<mf::http::BufferInterface> buffer
+    )
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    auto it = requests_.find(index);
+    if (state_ != State::Downloading || it == requests_.end())
+        return;
+
+    const auto & segment = segments_->GetSegment(index);
+    const uint64_t segment_pos = it->second.base + start_pos;
+
+    std::error_code error;
+    std::string description;
+
+    if (segment_pos + buffer->Size() > segment.size
+        || buffer->Size() > segment.size - segment.received)
+    {
+        error = make_error_code(errc::BadDownloadResponse);
+        description = "Received more data than requested.";
+    }
+    else
+    {
+        // Write at the position given rather than after the last write, in
+        // case callbacks run out of order.
+        std::error_code file_error;
+        file_->Seek(mf::utils::SeekAnchor::Beginning,
+            segment.offset + segment_pos, &file_error);
+        if ( ! file_error )
+            file_->Write(buffer->Data(), buffer->Size(), &file_error);
+
+        // Only counted once written, so a journal saved after a failed write
+        // never claims bytes the partial file lacks.
+        if ( ! file_error )
+            segments_->AddReceived(index, buffer->Size());
+
+        if ( ! file_error && sclock::now() - journal_saved_ > kJournalInterval)
+            file_error = SaveJournal();
+
+        if (file_error)
+        {
+            error = make_error_code(errc::FileError);
+            description = "Unable to write partial file: "
+                + file_error.message();
+        }
+    }
+
+    if (error)
+    {
+        lock.unlock();
+        Stop(error, description, true);
+    }
+}
+
+void FileDownload::HandleSegmentError(
+        std::size_t index,
+        std::error_code error_code,
+        std::string description
+    )
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        // Requests cancelled by Stop end here as well.
+        if (state_ != State::Downloading
+            || requests_.find(index) == requests_.end())
+            return;
+    }
+
+    Stop(error_code, description, true);
+}
+
+void FileDownload::HandleSegmentComplete(std::size_t index)
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    auto it = requests_.find(index);
+    if (state_ != State::Downloading || it == requests_.end())
+        return;
+
+    // Stop only gives back the slots of requests still in requests_, so the
+    // slot of this one is released here on every path.
+    requests_.erase(it);
+    segments_->Stop(index);
+
+    auto callback_interface = config_.callback_interface;
+
+    const auto & segment = segments_->GetSegment(index);
+    if (segment.received != segment.size)
+    {
+        lock.unlock();
+        if (callback_interface)
+            callback_interface->ReleaseSegmentSlots(1);
+        Stop(make_error_code(errc::IncompleteDownload),
+            "Segment response ended early.", true);
+        return;
+    }
+
+    const std::error_code file_error = SaveJournal();
+    if (file_error)
+    {
+        lock.unlock();
+        if (callback_interface)
+            callback_interface->ReleaseSegmentSlots(1);
+        Stop(make_error_code(errc::FileError),
+            "Unable to save download progress: " + file_error.message(), true);
+        return;
+    }
+
+    const ds::Downloading downloading{segments_->BytesReceived(),
+        segments_->Filesize()};
+    const bool complete = segments_->Complete();
+
+    lock.unlock();
+
+    if (callback_interface)
+        callback_interface->ReleaseSegmentSlots(1);
+
+    SendStatus(downloading);
+
+    if (complete)
+        Verify();
+    else
+        StartSegments();
+}
+
+void FileDownload::Verify()
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        if (state_ != State::Downloading)
+            return;
+
+        state_ = State::Verifying;
+
+        // Nothing more is written.
+        file_->Flush();
+        file_.reset();
+    }
+
+    SendStatus(ds::Verifying{});
+
+    auto self = shared_from_this();
+    auto verify = [self]()
+    {
+        std::error_code error;
+        std::string description;
+
+        // Without a hash there is nothing to compare with.
+        if ( ! self->config_.hash.empty() )
+        {
+            auto file = mf::utils::FileIO::Open(self->part_path_, "rb",
+                &error);
+            if (file)
+            {
+                mf::utils::Sha256Hasher hasher;
+                std::vector<char> buffer(kVerifyReadSize);
+
+                while ( ! self->stopped_ )
+                {
+                    std::error_code read_error;
+                    const uint64_t size = file->Read(buffer.data(),
+                        buffer.size(), &read_error);
+                    hasher.Update(size, buffer.data());
+
+                    if (read_error)
+                    {
+                        if (read_error != mf::utils::file_io_error::EndOfFile)
+                            error = read_error;
+                        break;
+                    }
+                }
+
+                if (error)
+                {
+                    description = "Unable to read partial file: "
+                        + error.message();
+                    error = make_error_code(errc::FileError);
+                }
+                else if ( ! boost::iequals(hasher.Digest(),
+                        self->config_.hash) )
+                {
+                    error = make_error_code(errc::HashIncorrect);
+                    description = "Downloaded file does not match hash "
+                        + self->config_.hash;
+                }
+            }
+            else
+            {
+                description = "Unable to open partial file: "
+                    + error.message();
+                error = make_error_code(errc::FileError);
+            }
+        }
+
+        self->io_service_->post(
+            [self, error, description]()
+            {
+                self->HandleVerified(error, description);
+            });
+    };
+
+    if (config_.verify_io_service)
+        config_.verify_io_service->post(verify);
+    else
+        io_service_->post(verify);
+}
+
+void FileDownload::HandleVerified(
+        std::error_code error_code,
+        std::string description
+    )
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    if (state_ != State::Verifying)
+        return;
+
+    if (error_code)
+    {
+        lock.unlock();
+
+        // A file that does not match is not worth resuming.
+        Stop(error_code, description,
+            error_code != errc::HashIncorrect);
+        return;
+    }
+
+    boost::system::error_code bec;
+    boost::filesystem::rename(part_path_, config_.filepath, bec);
+    if (bec)
+    {
+        lock.unlock();
+        Stop(make_error_code(errc::FileError),
+            "Unable to move downloaded file into place: " + bec.message(),
+            true);
+        return;
+    }
+
+    boost::filesystem::remove(journal_path_, bec);
+
+    state_ = State::Done;
+
+    const ds::Complete complete{filename_, config_.hash, config_.filesize};
+    auto callback_interface = config_.callback_interface;
+
+    lock.unlock();
+
+    SendStatus(complete);
+
+    if (callback_interface)
+        callback_interface->HandleComplete(shared_from_this());
+}
+
+void FileDownload::Stop(
+        std::error_code error_code,
+        std::string description,
+        bool keep_partial
+    )
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    if (state_ == State::Done)
+        return;
+
+    state_ = State::Done;
+    stopped_ = true;
+
+    std::map<std::size_t, SegmentRequest> requests;
+    std::swap(requests, requests_);
+
+    for (const auto & pair : requests)
+        segments_->Stop(pair.first);
+
+    if (keep_partial)
+    {
+        if (segments_)
+            SaveJournal();
+    }
+    else
+    {
+        file_.reset();
+        RemovePartialFiles();
+    }
+
+    file_.reset();
+
+    auto callback_interface = config_.callback_interface;
+
+    // Unlock before calling external
+    lock.unlock();
+
+    // Responses to these are ignored, as they are no longer in requests_.
+    for (auto & pair : requests)
+        pair.second.request->Cancel();
+
+    if (callback_interface && ! requests.empty())
+    {
+        callback_interface->ReleaseSegmentSlots(
+            static_cast<uint32_t>(requests.size()));
+    }
+
+    SendStatus(ds::Error{error_code, description});
+
+    if (callback_interface)
+        callback_interface->HandleComplete(shared_from_this());
+}
+
+void FileDownload::Disconnect()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    config_.callback_interface = nullptr;
+}
+
+void FileDownload::SendStatus(DownloadState state)
+{
+    if (config_.status_callback)
+    {
+        config_.status_callback(DownloadStatus{config_.download_handle,
+            config_.filepath, std::move(state)});
+    }
+}
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
@@ -0,0 +1,211 @@
+/**
+ * @file file_download.hpp
+ * @author Herbert Jones
+ * @brief Download of a single file in segments.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
+
+#include "mediafire_sdk/downloader/download_status.hpp"
+#include "mediafire_sdk/downloader/detail/segment_map.hpp"
+#include "mediafire_sdk/downloader/detail/types.hpp"
+#include "mediafire_sdk/http/buffer_interface.hpp"
+#include "mediafire_sdk/http/headers.hpp"
+#include "mediafire_sdk/http/http_request.hpp"
+#include "mediafire_sdk/utils/fileio.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+// Forward declarations
+namespace mf { namespace api { class SessionMaintainer; } }
+// END forward declarations
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+class FileDownload;
+using FileDownloadPointer = std::shared_ptr<FileDownload>;
+
+typedef std::function<void(::mf::downloader::DownloadStatus)> StatusCallback;
+
+/**
+ * @class FileDownloadCallbackInterface
+ * @brief How a download gets its share of the segment requests of the
+ * manager.
+ */
+class FileDownloadCallbackInterface
+{
+public:
+    virtual ~FileDownloadCallbackInterface() {}
+
+    /** Take a segment request slot.  Returns false if none are free. */
+    virtual bool AcquireSegmentSlot() = 0;
+
+    /** Return segment request slots. */
+    virtual void ReleaseSegmentSlots(uint32_t count) = 0;
+
+    /** The download completed or stopped. */
+    virtual void HandleComplete(FileDownloadPointer) = 0;
+};
+
+struct DownloadConfig
+{
+    DownloadHandle download_handle;
+    FileDownloadCallbackInterface * callback_interface;
+    ::mf::api::SessionMaintainer * session_maintainer;
+    std::string quickkey;
+    boost::filesystem::path filepath;
+    StatusCallback status_callback;
+
+    /** Known link, skipping the API lookup. */
+    boost::optional<std::string> direct_download_url;
+    uint64_t filesize;
+    std::string hash;
+
+    uint32_t max_concurrent_segments;
+    uint64_t segment_size;
+
+    /** Where the download is hashed, or null to hash on the work io_service. */
+    boost::asio::io_service * verify_io_service;
+};
+
+/**
+ * @class FileDownload
+ * @brief Downloads a file with parallel range requests.
+ *
+ * Data is written to a partial file next to the target, and the progress of
+ * each segment is saved beside it, so a download that is paused or fails is
+ * resumed when it is added again.  Once all segments are written the file is
+ * hashed, and renamed to the target if the hash matches.
+ */
+class FileDownload :
+    public std::enable_shared_from_this<FileDownload>
+{
+public:
+    explicit FileDownload(DownloadConfig config);
+    ~FileDownload();
+
+    DownloadHandle Handle() const {return config_.download_handle;}
+
+    const boost::filesystem::path & Path() const {return config_.filepath;}
+
+    /** Partial file the download is written to. */
+    const boost::filesystem::path & PartPath() const {return part_path_;}
+
+    /** Report the download as waiting for its turn. */
+    void Enqueue();
+
+    /** Look up the file if needed, then start downloading. */
+    void Start();
+
+    /** Start segment requests while slots are free. */
+    void StartSegments();
+
+    /**
+     * @brief Stop the download.
+     *
+     * @param[in] error_code Reported in the Error state.
+     * @param[in] description Reported in the Error state.
+     * @param[in] keep_partial Keep the data written so far to resume later.
+     */
+    void Stop(
+            std::error_code error_code,
+            std::string description,
+            bool keep_partial
+        );
+
+    /** Stop calling the manager. */
+    void Disconnect();
+
+    // -- From segment requests ------------------------------------------------
+    void HandleSegmentHeader(
+            std::size_t index,
+            const mf::http::Headers & headers
+        );
+    void HandleSegmentContent(
+            std::size_t index,
+            std::size_t start_pos,
+            std::shared_ptr<mf::http::BufferInterface> buffer
+        );
+    void HandleSegmentError(
+            std::size_t index,
+            std::error_code error_code,
+            std::string description
+        );
+    void HandleSegmentComplete(std::size_t index);
+    // -- END From segment requests --------------------------------------------
+
+private:
+    enum class State
+    {
+        Created,
+        Enqueued,
+        Preparing,
+        Downloading,
+        Verifying,
+        Done
+    };
+
+    DownloadConfig config_;
+    boost::asio::io_service * io_service_;
+
+    boost::filesystem::path part_path_;
+    boost::filesystem::path journal_path_;
+
+    State state_;
+    std::string url_;
+    std::string filename_;
+    mf::utils::FileIO::Pointer file_;
+    std::unique_ptr<SegmentMap> segments_;
+
+    /** Requests of active segments, and where in the segment each began. */
+    struct SegmentRequest
+    {
+        mf::http::HttpRequest::Pointer request;
+        uint64_t base;
+    };
+    std::map<std::size_t, SegmentRequest> requests_;
+
+    std::chrono::steady_clock::time_point journal_saved_;
+
+    /** Read by the verifying thread to give up early. */
+    std::atomic<bool> stopped_;
+
+    mf::utils::mutex mutex_;
+
+    void HandleFileInfo(
+            uint64_t filesize,
+            std::string hash,
+            std::string filename
+        );
+    void HandleDirectDownload(std::string url);
+
+    void BeginDownload();
+    std::error_code OpenPartFile();
+    std::error_code SaveJournal();
+    void RemovePartialFiles();
+
+    void Verify();
+    void HandleVerified(
+            std::error_code error_code,
+            std::string description
+        );
+
+    void SendStatus(DownloadState state);
+};
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
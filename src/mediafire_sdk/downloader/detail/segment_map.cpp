@@ -0,0 +1,171 @@
+/**
+ * @file segment_map.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "segment_map.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+namespace {
+const char kJournalHeader[] = "mf_download_segments";
+const int kJournalVersion = 1;
+
+// Hashes are hex, so this stands in for none.
+const char kNoHash[] = "-";
+}  // namespace
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+SegmentMap::SegmentMap(
+        uint64_t filesize,
+        uint64_t segment_size
+    ) :
+    filesize_(filesize),
+    segment_size_(std::max<uint64_t>(1, segment_size))
+{
+    for (uint64_t offset = 0; offset < filesize_; offset += segment_size_)
+    {
+        Segment segment = {
+            offset,
+            std::min(segment_size_, filesize_ - offset),
+            0,
+            false
+        };
+        segments_.push_back(segment);
+    }
+}
+
+boost::optional<SegmentMap> SegmentMap::Parse(
+        const std::string & journal,
+        uint64_t filesize,
+        const std::string & hash
+    )
+{
+    std::istringstream is(journal);
+
+    std::string header;
+    int version = 0;
+    std::string field;
+    uint64_t saved_filesize = 0;
+    std::string saved_hash;
+    uint64_t segment_size = 0;
+    std::size_t segment_count = 0;
+
+    if ( ! (is >> header >> version) || header != kJournalHeader
+        || version != kJournalVersion )
+        return boost::none;
+
+    if ( ! (is >> field >> saved_filesize) || field != "filesize"
+        || saved_filesize != filesize )
+        return boost::none;
+
+    if ( ! (is >> field >> saved_hash) || field != "hash"
+        || saved_hash != (hash.empty() ? kNoHash : hash) )
+        return boost::none;
+
+    if ( ! (is >> field >> segment_size) || field != "segment_size"
+        || segment_size == 0 )
+        return boost::none;
+
+    SegmentMap map(filesize, segment_size);
+
+    if ( ! (is >> field >> segment_count) || field != "received"
+        || segment_count != map.segments_.size() )
+        return boost::none;
+
+    for (auto & segment : map.segments_)
+    {
+        if ( ! (is >> segment.received) || segment.received > segment.size )
+            return boost::none;
+    }
+
+    return map;
+}
+
+std::string SegmentMap::Serialize(const std::string & hash) const
+{
+    std::ostringstream os;
+
+    os << kJournalHeader << ' ' << kJournalVersion << '\n';
+    os << "filesize " << filesize_ << '\n';
+    os << "hash " << (hash.empty() ? kNoHash : hash) << '\n';
+    os << "segment_size " << segment_size_ << '\n';
+    os << "received " << segments_.size();
+    for (const auto & segment : segments_)
+        os << ' ' << segment.received;
+    os << '\n';
+
+    return os.str();
+}
+
+uint64_t SegmentMap::BytesReceived() const
+{
+    uint64_t received = 0;
+    for (const auto & segment : segments_)
+        received += segment.received;
+    return received;
+}
+
+bool SegmentMap::Complete() const
+{
+    return std::all_of(segments_.begin(), segments_.end(),
+        [](const Segment & segment)
+        {
+            return segment.received == segment.size;
+        });
+}
+
+std::size_t SegmentMap::ActiveCount() const
+{
+    return std::count_if(segments_.begin(), segments_.end(),
+        [](const Segment & segment)
+        {
+            return segment.active;
+        });
+}
+
+boost::optional<std::size_t> SegmentMap::StartNext()
+{
+    for (std::size_t i = 0; i < segments_.size(); ++i)
+    {
+        Segment & segment = segments_[i];
+        if ( ! segment.active && segment.received < segment.size )
+        {
+            segment.active = true;
+            return i;
+        }
+    }
+
+    return boost::none;
+}
+
+bool SegmentMap::AddReceived(
+        std::size_t index,
+        uint64_t bytes
+    )
+{
+    assert( index < segments_.size() );
+
+    Segment & segment = segments_[index];
+    if ( bytes > segment.size - segment.received )
+        return false;
+
+    segment.received += bytes;
+    return true;
+}
+
+void SegmentMap::Stop(std::size_t index)
+{
+    assert( index < segments_.size() );
+
+    segments_[index].active = false;
+}
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
@@ -0,0 +1,129 @@
+/**
+ * @file segment_map.hpp
+ * @author Herbert Jones
+ * @brief Progress of the segments of a download.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "boost/optional.hpp"
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+/**
+ * @class SegmentMap
+ * @brief Splits a file into segments downloaded with separate range requests,
+ * and tracks how much of each is on disk.
+ *
+ * Each segment is written from its start, so its progress is a single count.
+ * The map can be saved next to the partial file and read back to resume.
+ */
+class SegmentMap
+{
+public:
+    struct Segment
+    {
+        /** Position of the segment in the file. */
+        uint64_t offset;
+
+        uint64_t size;
+
+        /** Bytes written, from offset. */
+        uint64_t received;
+
+        /** A request is downloading the segment. */
+        bool active;
+    };
+
+    /**
+     * @param[in] filesize Size of the file.
+     * @param[in] segment_size Size of each segment but the last, at least 1.
+     */
+    SegmentMap(
+            uint64_t filesize,
+            uint64_t segment_size
+        );
+
+    /**
+     * @brief Read a map saved with Serialize.
+     *
+     * @param[in] journal The saved map.
+     * @param[in] filesize Size the file must have.
+     * @param[in] hash Hash the file must have.
+     *
+     * @return The map, or none if the journal is invalid or for another
+     *         version of the file.
+     */
+    static boost::optional<SegmentMap> Parse(
+            const std::string & journal,
+            uint64_t filesize,
+            const std::string & hash
+        );
+
+    /**
+     * @brief Save the progress of the segments.
+     *
+     * @param[in] hash Hash of the file, to tell versions of it apart.
+     *
+     * @return Text to pass to Parse.
+     */
+    std::string Serialize(const std::string & hash) const;
+
+    uint64_t Filesize() const {return filesize_;}
+
+    /** Bytes written over all segments. */
+    uint64_t BytesReceived() const;
+
+    /** All segments are written. */
+    bool Complete() const;
+
+    std::size_t SegmentCount() const {return segments_.size();}
+
+    const Segment & GetSegment(std::size_t index) const
+    {
+        return segments_[index];
+    }
+
+    /** Number of segments being downloaded. */
+    std::size_t ActiveCount() const;
+
+    /**
+     * @brief Pick the first segment neither written nor being downloaded, and
+     * mark it active.
+     *
+     * @return Index of the segment, or none if there is none left.
+     */
+    boost::optional<std::size_t> StartNext();
+
+    /**
+     * @brief Record data written to a segment.
+     *
+     * @param[in] index Index of the segment.
+     * @param[in] bytes Bytes written after those already received.
+     *
+     * @return False if that would be more than the segment holds.  Nothing
+     *         is recorded then.
+     */
+    bool AddReceived(
+            std::size_t index,
+            uint64_t bytes
+        );
+
+    /** Mark a segment as no longer being downloaded. */
+    void Stop(std::size_t index);
+
+private:
+    uint64_t filesize_;
+    uint64_t segment_size_;
+    std::vector<Segment> segments_;
+};
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
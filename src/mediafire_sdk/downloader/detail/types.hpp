@@ -0,0 +1,22 @@
+/**
+ * @file types.hpp
+ * @author Herbert Jones
+ * @brief Types shared in download classes.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace mf {
+namespace downloader {
+namespace detail {
+
+struct DownloadHandle
+{
+    uint32_t id;
+};
+
+}  // namespace detail
+}  // namespace downloader
+}  // namespace mf
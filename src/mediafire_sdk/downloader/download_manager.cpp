@@ -0,0 +1,78 @@
+/**
+ * @file download_manager.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "download_manager.hpp"
+
+#include "./detail/download_manager_impl.hpp"
+
+namespace mf {
+namespace downloader {
+
+DownloadManager::DownloadManager(
+        ::mf::api::SessionMaintainer * session_maintainer
+    ) :
+    impl_(std::make_shared<detail::DownloadManagerImpl>(session_maintainer))
+{
+}
+
+DownloadManager::~DownloadManager()
+{
+}
+
+DownloadManager::DownloadHandle DownloadManager::Add(
+        const DownloadRequest & request,
+        StatusCallback callback
+    )
+{
+    return impl_->Add(request, callback);
+}
+
+void DownloadManager::ModifyDownload(
+        DownloadHandle download_handle,
+        DownloadModification modification
+    )
+{
+    impl_->ModifyDownload(download_handle, modification);
+}
+
+void DownloadManager::SetMaxConcurrentDownloads(uint32_t max_downloads)
+{
+    impl_->SetMaxConcurrentDownloads(max_downloads);
+}
+
+uint32_t DownloadManager::GetMaxConcurrentDownloads() const
+{
+    return impl_->GetMaxConcurrentDownloads();
+}
+
+void DownloadManager::SetMaxConcurrentSegments(uint32_t max_segments)
+{
+    impl_->SetMaxConcurrentSegments(max_segments);
+}
+
+uint32_t DownloadManager::GetMaxConcurrentSegments() const
+{
+    return impl_->GetMaxConcurrentSegments();
+}
+
+void DownloadManager::SetMaxConcurrentSegmentsPerDownload(
+        uint32_t max_segments
+    )
+{
+    impl_->SetMaxConcurrentSegmentsPerDownload(max_segments);
+}
+
+void DownloadManager::SetSegmentSize(uint64_t bytes)
+{
+    impl_->SetSegmentSize(bytes);
+}
+
+uint64_t DownloadManager::GetSegmentSize() const
+{
+    return impl_->GetSegmentSize();
+}
+
+}  // namespace downloader
+}  // namespace mf
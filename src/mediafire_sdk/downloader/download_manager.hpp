@@ -0,0 +1,153 @@
+/**
+ * @file download_manager.hpp
+ * @author Herbert Jones
+ * @brief Download manager to permit easy downloading
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "detail/types.hpp"
+#include "download_modification.hpp"
+#include "download_request.hpp"
+#include "download_status.hpp"
+
+// Forward declarations
+namespace mf {
+namespace api { class SessionMaintainer; }
+namespace downloader { namespace detail { class DownloadManagerImpl; } }
+}  // namespace mf
+// END forward declarations
+
+namespace mf {
+namespace downloader {
+
+/**
+ * @class DownloadManager
+ * @brief Manage a set of downloads.
+ *
+ * Files are downloaded from their direct download links in segments, several
+ * at a time, each requested with an HTTP range and written to its place in a
+ * partial file next to the target.  A download that is paused, fails or is
+ * interrupted by shutdown keeps its partial file, and continues where it left
+ * off when the same file is added again.  Complete files are checked against
+ * the hash of the cloud file before they replace the target.
+ */
+class DownloadManager
+{
+public:
+    using StatusCallback = std::function<void(DownloadStatus)>;
+    using DownloadHandle = detail::DownloadHandle;
+
+    /**
+     * @brief DownloadManager constructor
+     *
+     * @param[in] session_maintainer Pointer to API SessionMaintainer object
+     * which will be used to look up the files and to download them.
+     */
+    DownloadManager(
+            ::mf::api::SessionMaintainer * session_maintainer
+        );
+    ~DownloadManager();
+
+    /**
+     * @brief Request a file download.
+     *
+     * @param[in] request Data on the download to perform.
+     * @param[in] callback A callback function that will receive updates on the
+     * progress of the download.
+     *
+     * @return Handle for download that can be used to modify the download.
+     */
+    DownloadHandle Add(
+            const DownloadRequest & request,
+            StatusCallback callback
+        );
+
+    /**
+     * @brief Modify an ongoing download.
+     *
+     * Pausing keeps the partial file so the download can be resumed by adding
+     * it again, while cancelling removes it.
+     *
+     * @param[in] download_handle Handle to the file given from Add.
+     * @param[in] modification How to modify the download.
+     */
+    void ModifyDownload(
+            DownloadHandle download_handle,
+            DownloadModification modification
+        );
+
+    /**
+     * @brief Set how many files may be downloaded at the same time.
+     *
+     * Takes effect immediately.  The default is 2.
+     *
+     * @param[in] max_downloads Maximum concurrent downloads, at least 1.
+     */
+    void SetMaxConcurrentDownloads(uint32_t max_downloads);
+
+    /**
+     * @brief Get how many files may be downloaded at the same time.
+     *
+     * @return Maximum concurrent downloads.
+     */
+    uint32_t GetMaxConcurrentDownloads() const;
+
+    /**
+     * @brief Set how many segment requests may run at the same time over all
+     * downloads.
+     *
+     * Takes effect immediately.  The default is 8.
+     *
+     * @param[in] max_segments Maximum concurrent segment requests, at least 1.
+     */
+    void SetMaxConcurrentSegments(uint32_t max_segments);
+
+    /**
+     * @brief Get how many segment requests may run at the same time over all
+     * downloads.
+     *
+     * @return Maximum concurrent segment requests.
+     */
+    uint32_t GetMaxConcurrentSegments() const;
+
+    /**
+     * @brief Set how many segments of a single file are downloaded at the same
+     * time.
+     *
+     * Applies to downloads added after this call that do not set their own
+     * limit with DownloadRequest::SetMaxConcurrentSegments.  The default is 4.
+     *
+     * @param[in] max_segments Maximum segments in flight per download, at
+     * least 1.
+     */
+    void SetMaxConcurrentSegmentsPerDownload(uint32_t max_segments);
+
+    /**
+     * @brief Set the size of the segments files are split into.
+     *
+     * Files no larger than this are downloaded with a single request.
+     * Applies to downloads started after this call, except those resumed,
+     * which keep the segments they were started with.  The default is 8 MB.
+     *
+     * @param[in] bytes Segment size, at least 256 KB.
+     */
+    void SetSegmentSize(uint64_t bytes);
+
+    /**
+     * @brief Get the size of the segments files are split into.
+     *
+     * @return Segment size in bytes.
+     */
+    uint64_t GetSegmentSize() const;
+
+private:
+    std::shared_ptr<detail::DownloadManagerImpl> impl_;
+};
+
+}  // namespace downloader
+}  // namespace mf
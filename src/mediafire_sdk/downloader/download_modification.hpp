@@ -0,0 +1,25 @@
+/**
+ * @file download_modification.hpp
+ * @author Herbert Jones
+ * @brief Download modification request types
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include "boost/variant/variant.hpp"
+
+namespace mf {
+namespace downloader {
+
+namespace modification {
+struct Cancel {};
+struct Pause {};
+}  // namespace modification
+
+using DownloadModification = boost::variant
+    < modification::Cancel
+    , modification::Pause
+    >;
+
+}  // namespace downloader
+}  // namespace mf
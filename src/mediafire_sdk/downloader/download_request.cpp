@@ -0,0 +1,60 @@
+/**
+ * @file download_request.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "download_request.hpp"
+
+#include <algorithm>
+
+namespace mf {
+namespace downloader {
+
+DownloadRequest::DownloadRequest(
+        std::string quickkey,
+        std::string local_filepath
+    ) :
+    quickkey_(quickkey),
+    local_file_path_(local_filepath),
+    filesize_(0)
+{
+}
+
+DownloadRequest::DownloadRequest(
+        std::string quickkey,
+        std::wstring local_filepath
+    ) :
+    quickkey_(quickkey),
+    local_file_path_(local_filepath),
+    filesize_(0)
+{
+}
+
+DownloadRequest::DownloadRequest(
+        std::string quickkey,
+        boost::filesystem::path local_filepath
+    ) :
+    quickkey_(quickkey),
+    local_file_path_(local_filepath),
+    filesize_(0)
+{
+}
+
+void DownloadRequest::SetDirectDownload(
+        std::string url,
+        uint64_t filesize,
+        std::string hash
+    )
+{
+    direct_download_url_ = url;
+    filesize_ = filesize;
+    hash_ = hash;
+}
+
+void DownloadRequest::SetMaxConcurrentSegments( uint32_t max_segments )
+{
+    max_concurrent_segments_ = std::max<uint32_t>(1, max_segments);
+}
+
+}  // namespace downloader
+}  // namespace mf
@@ -0,0 +1,106 @@
+/**
+ * @file download_request.hpp
+ * @author Herbert Jones
+ * @brief Container for download requests
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
+
+namespace mf {
+namespace downloader {
+
+// Forward declaration
+namespace detail { class DownloadManagerImpl; }
+
+/**
+ * @class DownloadRequest
+ * @brief Request and configuration for a file download.
+ */
+class DownloadRequest
+{
+public:
+    /**
+     * @brief Create a file download.
+     *
+     * @param[in] quickkey The id of the file in the cloud.
+     * @param[in] local_filepath Where to save the file on the local system.
+     */
+    DownloadRequest( std::string quickkey, std::string local_filepath );
+
+    /**
+     * @brief Create a file download.
+     *
+     * @param[in] quickkey The id of the file in the cloud.
+     * @param[in] local_filepath Where to save the file on the local system.
+     */
+    DownloadRequest( std::string quickkey, std::wstring local_filepath );
+
+    /**
+     * @brief Create a file download.
+     *
+     * @param[in] quickkey The id of the file in the cloud.
+     * @param[in] local_filepath Where to save the file on the local system.
+     */
+    DownloadRequest(
+            std::string quickkey,
+            boost::filesystem::path local_filepath
+        );
+
+    /**
+     * @brief Download from a known direct download link.
+     *
+     * Skips looking up the file information and link through the API, such
+     * as when file/get_links was already called for many files at once.
+     *
+     * @param[in] url The direct download link of the file.
+     * @param[in] filesize The size of the file.
+     * @param[in] hash The SHA256 hash of the file, or empty to not verify the
+     * download.
+     */
+    void SetDirectDownload(
+            std::string url,
+            uint64_t filesize,
+            std::string hash
+        );
+
+    /**
+     * @brief Set how many segments of the file are downloaded at the same
+     * time.
+     *
+     * Overrides the download manager default set with
+     * DownloadManager::SetMaxConcurrentSegmentsPerDownload.
+     *
+     * @param[in] max_segments Maximum segments in flight, at least 1.
+     */
+    void SetMaxConcurrentSegments( uint32_t max_segments );
+
+private:
+    friend class detail::DownloadManagerImpl;
+
+    /** Id of the file in the cloud */
+    const std::string quickkey_;
+
+    /** Path to the file on the local system */
+    const boost::filesystem::path local_file_path_;
+
+    /** Link to download from, if not to be looked up. */
+    boost::optional<std::string> direct_download_url_;
+
+    /** Size of the file, if the link is given. */
+    uint64_t filesize_;
+
+    /** Hash of the file, if the link is given. */
+    std::string hash_;
+
+    /** Segments to download at once if different from the manager default. */
+    boost::optional<uint32_t> max_concurrent_segments_;
+};
+
+}  // namespace downloader
+}  // namespace mf
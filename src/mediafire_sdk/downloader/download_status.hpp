@@ -0,0 +1,61 @@
+/**
+ * @file download_status.hpp
+ * @author Herbert Jones
+ * @brief Status message from DownloadManager
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include "boost/filesystem/path.hpp"
+#include "boost/variant/variant.hpp"
+
+#include "detail/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+namespace mf {
+namespace downloader {
+
+namespace download_state {
+struct EnqueuedForDownload {};
+struct Preparing {};
+struct Downloading
+{
+    /** Bytes of the file on disk, including those from earlier attempts. */
+    uint64_t bytes_downloaded;
+    uint64_t filesize;
+};
+struct Verifying {};
+struct Error
+{
+    std::error_code error_code;
+    std::string description;
+};
+struct Complete
+{
+    std::string filename;
+    std::string hash;
+    uint64_t filesize;
+};
+}  // namespace download_state
+
+using DownloadState = boost::variant<
+        download_state::EnqueuedForDownload,
+        download_state::Preparing,
+        download_state::Downloading,
+        download_state::Verifying,
+        download_state::Error,
+        download_state::Complete
+    >;
+
+struct DownloadStatus
+{
+    detail::DownloadHandle download_handle;
+    boost::filesystem::path path;
+    DownloadState state;
+};
+
+}  // namespace downloader
+}  // namespace mf
@@ -0,0 +1,10 @@
+/**
+ * @file error.hpp
+ * @author Herbert Jones
+ * @brief Error codes for the downloader module.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include "mediafire_sdk/downloader/error/conditions/generic.hpp"
@@ -0,0 +1,121 @@
+/**
+ * @file generic.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "generic.hpp"
+
+#include <cassert>
+#include <sstream>
+#include <string>
+
+#include "mediafire_sdk/utils/noexcept.hpp"
+
+namespace {
+/**
+ * @class DownloadConditionImpl
+ * @brief std::error_category implementation for downloader namespace
+ */
+class DownloadConditionImpl : public std::error_category
+{
+public:
+    /// The name of this error category.
+    virtual const char* name() const NOEXCEPT;
+
+    /// The message belonging to the error code.
+    virtual std::string message(int ev) const;
+
+    /**
+     * @brief Compare other error codes to your error conditions/values, or
+     *        pass them to other comparers.
+     *
+     * Any of your error codes that correspond to std::errc types should be
+     * matched up here, and return true if so.
+     *
+     * See: http://en.cppreference.com/w/cpp/error/errc
+     */
+    virtual bool equivalent(
+        const std::error_code& code,
+        int condition
+    ) const NOEXCEPT;
+};
+
+const char* DownloadConditionImpl::name() const NOEXCEPT
+{
+    return "mediafire downloader";
+}
+
+std::string DownloadConditionImpl::message(int ev) const
+{
+    using mf::downloader::errc;
+
+    switch (static_cast<errc>(ev))
+    {
+        case errc::BadDownloadResponse:
+            return "bad download response";
+        case errc::Cancelled:
+            return "cancelled";
+        case errc::DirectDownloadUnavailable:
+            return "direct download unavailable";
+        case errc::FileError:
+            return "file error";
+        case errc::HashIncorrect:
+            return "hash incorrect";
+        case errc::IncompleteDownload:
+            return "incomplete download";
+        case errc::Paused:
+            return "paused";
+        case errc::RangeNotSupported:
+            return "range not supported";
+        default:
+            {
+                assert(!"Unimplemented condition");
+                std::stringstream ss;
+                ss << "Unknown downloader category: " << ev;
+                return ss.str();
+            }
+    }
+}
+
+bool DownloadConditionImpl::equivalent(
+        const std::error_code& ec,
+        int condition_code
+    ) const NOEXCEPT
+{
+    using mf::downloader::errc;
+
+    switch (static_cast<errc>(condition_code))
+    {
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+namespace mf {
+namespace downloader {
+
+std::error_condition make_error_condition(errc e)
+{
+    return std::error_condition(
+            static_cast<int>(e),
+            generic_download_category()
+            );
+}
+
+std::error_code make_error_code(errc e)
+{
+    return std::error_code(
+            static_cast<int>(e),
+            generic_download_category()
+            );
+}
+
+const std::error_category& generic_download_category()
+{
+    static DownloadConditionImpl instance;
+    return instance;
+}
+
+}  // namespace downloader
+}  // namespace mf
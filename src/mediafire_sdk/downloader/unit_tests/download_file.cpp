@@ -0,0 +1,250 @@
+/**
+ * @file download_file.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <cstdlib>
+#include <iostream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#ifdef BOOST_ASIO_SEPARATE_COMPILATION
+#include "boost/asio/impl/src.hpp"      // Define once in program
+#include "boost/asio/ssl/impl/src.hpp"  // Define once in program
+#endif
+#include "boost/filesystem.hpp"
+#include "boost/program_options.hpp"
+#include "boost/variant/apply_visitor.hpp"
+#include "boost/variant/get.hpp"
+
+#include "mediafire_sdk/api/file/get_info.hpp"
+#include "mediafire_sdk/api/session_maintainer.hpp"
+#include "mediafire_sdk/downloader/download_manager.hpp"
+
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+namespace ds = mf::downloader::download_state;
+
+class StatusVisitor : public boost::static_visitor<>
+{
+public:
+    StatusVisitor(asio::io_service & io_service,
+                  std::string quickkey,
+                  const int files_expected,
+                  int * files_complete)
+            : io_service_(io_service),
+              quickkey_(quickkey),
+              files_expected_(files_expected),
+              files_complete_(files_complete)
+    {
+    }
+
+    void operator()(ds::EnqueuedForDownload &) const {}
+
+    void operator()(ds::Preparing &) const
+    {
+        std::cout << "[" << quickkey_ << "] Getting download link."
+                  << std::endl;
+    }
+
+    void operator()(ds::Downloading & status) const
+    {
+        std::cout << "[" << quickkey_ << "] Downloaded "
+                  << status.bytes_downloaded << " of " << status.filesize
+                  << " bytes." << std::endl;
+    }
+
+    void operator()(ds::Verifying &) const
+    {
+        std::cout << "[" << quickkey_ << "] Verifying hash." << std::endl;
+    }
+
+    void operator()(ds::Error & status) const
+    {
+        const auto & ec = status.error_code;
+        std::cout << "[" << quickkey_ << "] Error: " << ec.message()
+                  << std::endl;
+        std::cout << "[" << quickkey_ << "] Error type: "
+                  << ec.category().name() << std::endl;
+        std::cout << "[" << quickkey_ << "] Description: "
+                  << status.description << std::endl;
+
+        Done();
+    }
+
+    void operator()(ds::Complete & status) const
+    {
+        std::cout << "[" << quickkey_ << "] Download complete: "
+                  << status.filename << std::endl;
+
+        Done();
+    }
+
+private:
+    void Done() const
+    {
+        *files_complete_ += 1;
+        if (*files_complete_ == files_expected_)
+            io_service_.stop();
+    }
+
+    asio::io_service & io_service_;
+    std::string quickkey_;
+    const int files_expected_;
+    int * files_complete_;
+};
+
+void ShowUsage(const char * filename, const po::options_description & visible)
+{
+    std::cout << "Usage: " << filename << " [options]"
+                                          " -u USERNAME"
+                                          " -p PASSWORD"
+                                          " QUICKKEYS\n";
+    std::cout << visible << "\n";
+}
+
+int main(int argc, char * argv[])
+{
+    try
+    {
+        std::string output_directory = ".";
+        std::string password;
+        std::vector<std::string> quickkeys;
+        std::string username;
+        uint32_t segments = 0;
+
+        po::options_description visible("Allowed options");
+        /* clang-format off */
+        visible.add_options()
+            ("help,h"        ,                                             "Show this message.")
+            ("output,o"      , po::value<std::string>(&output_directory) , "Directory where to save the files.")
+            ("password,p"    , po::value<std::string>(&password)         , "Password for login")
+            ("segments,s"    , po::value<uint32_t>(&segments)            , "Segments to download at once per file.")
+            ("username,u"    , po::value<std::string>(&username)         , "Username for login")
+            ;
+        /* clang-format on */
+
+        po::options_description hidden("Hidden options");
+        hidden.add_options()(
+                "quickkey",
+                po::value<std::vector<std::string>>(&quickkeys),
+                "quickkey");
+
+        po::positional_options_description p;
+        p.add("quickkey", -1);
+
+        po::options_description cmdline_options;
+        cmdline_options.add(visible).add(hidden);
+
+        po::variables_map vm;
+        try
+        {
+            po::store(po::command_line_parser(argc, argv)
+                              .options(cmdline_options)
+                              .positional(p)
+                              .run(),
+                      vm);
+            po::notify(vm);
+        }
+        catch (boost::program_options::error & err)
+        {
+            std::cout << "Error: " << err.what() << std::endl;
+            ShowUsage(argv[0], visible);
+            return 1;
+        }
+
+        if (vm.count("help") || !vm.count("quickkey")
+            || !vm.count("username") || !vm.count("password"))
+        {
+            ShowUsage(argv[0], visible);
+            return 0;
+        }
+
+        asio::io_service io_service;
+
+        {
+            auto http_config = mf::http::HttpConfig::Create();
+            http_config->SetWorkIoService(&io_service);
+
+            mf::api::SessionMaintainer stm(http_config);
+
+            // Handle session token failures.
+            stm.SetSessionStateChangeCallback(
+                    [&io_service](mf::api::SessionState state)
+                    {
+                        if (boost::get<mf::api::session_state::
+                                               CredentialsFailure>(&state))
+                        {
+                            std::cout << "Username or password incorrect."
+                                      << std::endl;
+                            io_service.stop();
+                        }
+                    });
+
+            stm.SetLoginCredentials(
+                    mf::api::credentials::Email{username, password});
+
+            mf::downloader::DownloadManager dm(&stm);
+
+            const int files_to_download = quickkeys.size();
+            int files_downloaded = 0;
+
+            for (const auto & quickkey : quickkeys)
+            {
+                // The files are saved under their names in the cloud.
+                stm.Call(
+                    mf::api::file::get_info::Request(quickkey),
+                    [&](const mf::api::file::get_info::Response & response)
+                    {
+                        if (response.error_code)
+                        {
+                            std::cout << "[" << quickkey
+                                      << "] Unable to get file information: "
+                                      << response.error_code.message()
+                                      << std::endl;
+                            if (++files_downloaded == files_to_download)
+                                io_service.stop();
+                            return;
+                        }
+
+                        mf::downloader::DownloadRequest request(quickkey,
+                            boost::filesystem::path(output_directory)
+                                / response.filename);
+
+                        if (vm.count("segments"))
+                            request.SetMaxConcurrentSegments(segments);
+
+                        dm.Add(request,
+                            [&io_service, quickkey, files_to_download,
+                             &files_downloaded](
+                                mf::downloader::DownloadStatus status)
+                            {
+                                boost::apply_visitor(
+                                        StatusVisitor(io_service, quickkey,
+                                                      files_to_download,
+                                                      &files_downloaded),
+                                        status.state);
+                            });
+                    });
+            }
+
+            io_service.run();
+        }
+    }
+    catch (std::exception & e)
+    {
+        std::cerr << "Uncaught exception: " << e.what() << "\n";
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+
+    return 0;
+}
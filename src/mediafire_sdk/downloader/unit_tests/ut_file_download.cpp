@@ -0,0 +1,378 @@
+/**
+ * @file ut_file_download.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#ifdef BOOST_ASIO_SEPARATE_COMPILATION
+#  include "boost/asio/impl/src.hpp"  // Define once in program
+#  include "boost/asio/ssl/impl/src.hpp"  // Define once in program
+#endif
+#include "boost/filesystem.hpp"
+#include "boost/optional.hpp"
+#include "boost/variant/get.hpp"
+
+#define BOOST_TEST_MODULE UtFileDownload
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/api/session_maintainer.hpp"
+#include "mediafire_sdk/downloader/detail/file_download.hpp"
+#include "mediafire_sdk/downloader/detail/segment_map.hpp"
+#include "mediafire_sdk/downloader/error.hpp"
+#include "mediafire_sdk/http/http_config.hpp"
+#include "mediafire_sdk/http/unit_tests/expect_server.hpp"
+#include "mediafire_sdk/utils/fileio.hpp"
+#include "mediafire_sdk/utils/sha256_hasher.hpp"
+#include "mediafire_sdk/utils/string.hpp"
+
+namespace asio = boost::asio;
+namespace ds = mf::downloader::download_state;
+namespace fs = boost::filesystem;
+
+using mf::downloader::detail::DownloadConfig;
+using mf::downloader::detail::FileDownload;
+using mf::downloader::detail::FileDownloadPointer;
+using mf::downloader::detail::SegmentMap;
+using mf::downloader::errc;
+
+namespace {
+
+const uint16_t kPort = 49997;
+const uint16_t kResumePort = 49998;
+const uint64_t kFilesize = 1000;
+
+std::string FileContent()
+{
+    std::string content;
+    for (uint64_t i = 0; i < kFilesize; ++i)
+        content.push_back(static_cast<char>('a' + i % 26));
+    return content;
+}
+
+std::string Sha256(const std::string & data)
+{
+    mf::utils::Sha256Hasher hasher;
+    hasher.Update(data.size(), data.data());
+    return hasher.Digest();
+}
+
+std::string ReadFile(const fs::path & path)
+{
+    auto file = mf::utils::FileIO::Open(path, "rb", nullptr);
+    if ( ! file )
+        return std::string();
+    return file->ReadString(mf::utils::FileIO::skDefaultReadSize, nullptr);
+}
+
+/** Response to a range request for part of the file. */
+std::string RangeResponse(
+        uint64_t first,
+        uint64_t last,
+        std::string body
+    )
+{
+    return "HTTP/1.1 206 Partial Content\r\n"
+        "Connection: close\r\n"
+        "Content-Range: bytes " + mf::utils::to_string(first) + "-"
+            + mf::utils::to_string(last) + "/"
+            + mf::utils::to_string(kFilesize) + "\r\n"
+        "Content-Length: " + mf::utils::to_string(body.size()) + "\r\n"
+        "\r\n" + body;
+}
+
+/** Stands in for the download manager, counting segment slots. */
+class SlotCounter : public mf::downloader::detail::FileDownloadCallbackInterface
+{
+public:
+    SlotCounter() : acquired(0), released(0), completed(0) {}
+
+    virtual bool AcquireSegmentSlot() override
+    {
+        ++acquired;
+        return true;
+    }
+
+    virtual void ReleaseSegmentSlots(uint32_t count) override
+    {
+        released += count;
+    }
+
+    virtual void HandleComplete(FileDownloadPointer) override
+    {
+        ++completed;
+    }
+
+    uint32_t acquired;
+    uint32_t released;
+    uint32_t completed;
+};
+
+/** Downloads one file from the expect server into a temporary directory. */
+class DownloadFixture
+{
+public:
+    DownloadFixture() :
+        directory_(fs::temp_directory_path() / fs::unique_path()),
+        filepath_(directory_ / "file.bin"),
+        content_(FileContent())
+    {
+        fs::create_directories(directory_);
+
+        server_ = ExpectServer::Create(&io_service_,
+            std::make_shared<asio::io_service::work>(io_service_), kPort);
+    }
+
+    ~DownloadFixture()
+    {
+        boost::system::error_code ec;
+        fs::remove_all(directory_, ec);
+    }
+
+    /** Run until the download completes or stops. */
+    void Download(
+            const std::string & hash,
+            uint16_t port = kPort
+        )
+    {
+        auto http_config = mf::http::HttpConfig::Create();
+        http_config->SetWorkIoService(&io_service_);
+
+        mf::api::SessionMaintainer session_maintainer(http_config);
+
+        DownloadConfig config;
+        config.download_handle.id = 1;
+        config.callback_interface = &slots_;
+        config.session_maintainer = &session_maintainer;
+        config.filepath = filepath_;
+        config.status_callback =
+            [this](mf::downloader::DownloadStatus status)
+            {
+                if (auto error = boost::get<ds::Error>(&status.state))
+                {
+                    error_ = error->error_code;
+                    io_service_.stop();
+                }
+                else if (boost::get<ds::Complete>(&status.state))
+                {
+                    complete_ = true;
+                    io_service_.stop();
+                }
+            };
+        config.direct_download_url = "http://127.0.0.1:"
+            + mf::utils::to_string(port) + "/file.bin";
+        config.filesize = kFilesize;
+        config.hash = hash;
+        config.max_concurrent_segments = 1;
+        config.segment_size = kFilesize;
+        config.verify_io_service = nullptr;
+
+        auto download = std::make_shared<FileDownload>(config);
+        download->Start();
+
+        io_service_.reset();
+        io_service_.run();
+
+        download->Disconnect();
+    }
+
+    /** Write a partial file and journal with part of the file received. */
+    void WritePartial(uint64_t received)
+    {
+        SegmentMap segments(kFilesize, kFilesize);
+        BOOST_REQUIRE( segments.StartNext() );
+        BOOST_REQUIRE( segments.AddReceived(0, received) );
+        segments.Stop(0);
+
+        auto part = mf::utils::FileIO::Open(
+            filepath_.string() + ".mfpart", "wb", nullptr);
+        BOOST_REQUIRE( part );
+        part->WriteString(content_.substr(0, received), nullptr);
+
+        auto journal = mf::utils::FileIO::Open(
+            filepath_.string() + ".mfpart.segments", "wb", nullptr);
+        BOOST_REQUIRE( journal );
+        journal->WriteString(segments.Serialize(Sha256(content_)), nullptr);
+    }
+
+    bool PartialFilesExist() const
+    {
+        return fs::exists(filepath_.string() + ".mfpart")
+            || fs::exists(filepath_.string() + ".mfpart.segments");
+    }
+
+protected:
+    asio::io_service io_service_;
+    std::shared_ptr<ExpectServer> server_;
+    SlotCounter slots_;
+
+    fs::path directory_;
+    fs::path filepath_;
+    std::string content_;
+
+    bool complete_ = false;
+    std::error_code error_;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(RangeRequest, DownloadFixture)
+{
+    server_->Push( ExpectRegex{ boost::regex(
+            "GET /file.bin .*"
+            "Range: bytes=0-999\r\n"
+            "(.*\r\n)?\r\n"
+        )});
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(0, kFilesize - 1, content_)) );
+
+    Download(Sha256(content_));
+
+    BOOST_CHECK( complete_ );
+    BOOST_CHECK( ! error_ );
+    BOOST_CHECK( ReadFile(filepath_) == content_ );
+    BOOST_CHECK( ! PartialFilesExist() );
+    BOOST_CHECK_EQUAL( slots_.acquired, slots_.released );
+}
+
+BOOST_FIXTURE_TEST_CASE(RangeIgnored, DownloadFixture)
+{
+    server_->Push( ExpectRegex{ boost::regex("GET.*\r\n\r\n") });
+    server_->Push( expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Connection: close\r\n"
+            "Content-Length: " + mf::utils::to_string(kFilesize) + "\r\n"
+            "\r\n" + content_) );
+
+    Download(Sha256(content_));
+
+    BOOST_CHECK( ! complete_ );
+    BOOST_CHECK( error_ == errc::RangeNotSupported );
+    BOOST_CHECK( ! fs::exists(filepath_) );
+    BOOST_CHECK_EQUAL( slots_.acquired, slots_.released );
+}
+
+BOOST_FIXTURE_TEST_CASE(ContentRangeMismatch, DownloadFixture)
+{
+    server_->Push( ExpectRegex{ boost::regex("GET.*\r\n\r\n") });
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(100, kFilesize - 1, content_.substr(100))) );
+
+    Download(Sha256(content_));
+
+    BOOST_CHECK( ! complete_ );
+    BOOST_CHECK( error_ == errc::BadDownloadResponse );
+    BOOST_CHECK_EQUAL( slots_.acquired, slots_.released );
+}
+
+BOOST_FIXTURE_TEST_CASE(ResumeFromJournal, DownloadFixture)
+{
+    WritePartial(400);
+
+    // Only the rest of the file is requested.
+    server_->Push( ExpectRegex{ boost::regex(
+            "GET /file.bin .*"
+            "Range: bytes=400-999\r\n"
+            "(.*\r\n)?\r\n"
+        )});
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(400, kFilesize - 1, content_.substr(400))) );
+
+    Download(Sha256(content_));
+
+    BOOST_CHECK( complete_ );
+    BOOST_CHECK( ! error_ );
+    BOOST_CHECK( ReadFile(filepath_) == content_ );
+    BOOST_CHECK( ! PartialFilesExist() );
+}
+
+BOOST_FIXTURE_TEST_CASE(HashIncorrect, DownloadFixture)
+{
+    server_->Push( ExpectRegex{ boost::regex("GET.*\r\n\r\n") });
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(0, kFilesize - 1, content_)) );
+
+    Download(Sha256("something else"));
+
+    BOOST_CHECK( ! complete_ );
+    BOOST_CHECK( error_ == errc::HashIncorrect );
+
+    // Not worth resuming.
+    BOOST_CHECK( ! fs::exists(filepath_) );
+    BOOST_CHECK( ! PartialFilesExist() );
+}
+
+BOOST_FIXTURE_TEST_CASE(SegmentEndsEarly, DownloadFixture)
+{
+    // The response is complete, but holds less than the range requested.
+    server_->Push( ExpectRegex{ boost::regex("GET.*\r\n\r\n") });
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(0, kFilesize - 1, content_.substr(0, 600))) );
+
+    Download(Sha256(content_));
+
+    BOOST_CHECK( ! complete_ );
+    BOOST_CHECK( error_ == errc::IncompleteDownload );
+
+    // The slot of the finished request is given back.
+    BOOST_CHECK_EQUAL( slots_.acquired, 1u );
+    BOOST_CHECK_EQUAL( slots_.released, 1u );
+
+    // What was received is kept to resume from.
+    BOOST_CHECK( PartialFilesExist() );
+}
+
+#if defined(__linux__)
+BOOST_FIXTURE_TEST_CASE(WriteFailsThenResumes, DownloadFixture)
+{
+    const std::string part_path = filepath_.string() + ".mfpart";
+    const std::string journal_path = part_path + ".segments";
+
+    // Every write to /dev/full fails, as on a full disk.
+    fs::create_symlink("/dev/full", part_path);
+
+    server_->Push( ExpectRegex{ boost::regex("GET.*\r\n\r\n") });
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(0, kFilesize - 1, content_)) );
+
+    Download(Sha256(content_));
+
+    BOOST_CHECK( ! complete_ );
+    BOOST_CHECK( error_ == errc::FileError );
+
+    // Nothing reached the disk, so no journal may claim any of it.
+    if (fs::exists(journal_path))
+    {
+        auto segments = SegmentMap::Parse(ReadFile(journal_path), kFilesize,
+            Sha256(content_));
+        BOOST_REQUIRE( segments );
+        BOOST_CHECK_EQUAL( segments->BytesReceived(), 0u );
+    }
+
+    // Space is freed, leaving the partial file as the failure did.
+    fs::remove(part_path);
+    BOOST_REQUIRE( mf::utils::FileIO::Open(part_path, "wb", nullptr) );
+
+    error_ = std::error_code();
+    server_ = ExpectServer::Create(&io_service_,
+        std::make_shared<asio::io_service::work>(io_service_), kResumePort);
+    server_->Push( ExpectRegex{ boost::regex(
+            "GET /file.bin .*"
+            "Range: bytes=0-999\r\n"
+            "(.*\r\n)?\r\n"
+        )});
+    server_->Push( expect_server_test::SendMessage(
+            RangeResponse(0, kFilesize - 1, content_)) );
+
+    Download(Sha256(content_), kResumePort);
+
+    BOOST_CHECK( complete_ );
+    BOOST_CHECK( ! error_ );
+    BOOST_CHECK( ReadFile(filepath_) == content_ );
+    BOOST_CHECK( ! PartialFilesExist() );
+}
+#endif
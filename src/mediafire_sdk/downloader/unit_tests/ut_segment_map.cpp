@@ -0,0 +1,137 @@
+/**
+ * @file ut_segment_map.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <string>
+
+#define BOOST_TEST_MODULE UtSegmentMap
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/downloader/detail/segment_map.hpp"
+
+using mf::downloader::detail::SegmentMap;
+
+namespace {
+const std::string kHash(64, 'a');
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(SplitsFileIntoSegments)
+{
+    SegmentMap map(2500, 1000);
+
+    BOOST_REQUIRE_EQUAL( map.SegmentCount(), 3u );
+    BOOST_CHECK_EQUAL( map.GetSegment(0).offset, 0u );
+    BOOST_CHECK_EQUAL( map.GetSegment(1).offset, 1000u );
+    BOOST_CHECK_EQUAL( map.GetSegment(2).offset, 2000u );
+    BOOST_CHECK_EQUAL( map.GetSegment(2).size, 500u );
+    BOOST_CHECK_EQUAL( map.BytesReceived(), 0u );
+    BOOST_CHECK( ! map.Complete() );
+
+    // A file no larger than a segment is a single request.
+    BOOST_CHECK_EQUAL( SegmentMap(1000, 1000).SegmentCount(), 1u );
+
+    // Nothing to download.
+    SegmentMap empty(0, 1000);
+    BOOST_CHECK_EQUAL( empty.SegmentCount(), 0u );
+    BOOST_CHECK( empty.Complete() );
+    BOOST_CHECK( ! empty.StartNext() );
+}
+
+BOOST_AUTO_TEST_CASE(HandsOutEachSegmentOnce)
+{
+    SegmentMap map(2500, 1000);
+
+    BOOST_CHECK( map.StartNext() == std::size_t(0) );
+    BOOST_CHECK( map.StartNext() == std::size_t(1) );
+    BOOST_CHECK_EQUAL( map.ActiveCount(), 2u );
+
+    // A stopped segment with data left is handed out again.
+    BOOST_CHECK( map.AddReceived(0, 400) );
+    map.Stop(0);
+    BOOST_CHECK( map.StartNext() == std::size_t(0) );
+
+    BOOST_CHECK( map.StartNext() == std::size_t(2) );
+    BOOST_CHECK( ! map.StartNext() );
+
+    BOOST_CHECK( map.AddReceived(0, 600) );
+    BOOST_CHECK( map.AddReceived(1, 1000) );
+    BOOST_CHECK( map.AddReceived(2, 500) );
+    map.Stop(0);
+    map.Stop(1);
+    map.Stop(2);
+
+    BOOST_CHECK( map.Complete() );
+    BOOST_CHECK_EQUAL( map.BytesReceived(), 2500u );
+    BOOST_CHECK_EQUAL( map.ActiveCount(), 0u );
+    BOOST_CHECK( ! map.StartNext() );
+}
+
+BOOST_AUTO_TEST_CASE(RejectsMoreThanSegmentHolds)
+{
+    SegmentMap map(2500, 1000);
+
+    BOOST_CHECK( map.AddReceived(2, 300) );
+    BOOST_CHECK( ! map.AddReceived(2, 201) );
+    BOOST_CHECK_EQUAL( map.GetSegment(2).received, 300u );
+    BOOST_CHECK( map.AddReceived(2, 200) );
+}
+
+BOOST_AUTO_TEST_CASE(ResumesFromJournal)
+{
+    SegmentMap map(2500, 1000);
+    map.StartNext();
+    map.AddReceived(0, 1000);
+    map.AddReceived(1, 123);
+
+    const std::string journal = map.Serialize(kHash);
+
+    auto resumed = SegmentMap::Parse(journal, 2500, kHash);
+    BOOST_REQUIRE( resumed );
+    BOOST_CHECK_EQUAL( resumed->SegmentCount(), 3u );
+    BOOST_CHECK_EQUAL( resumed->GetSegment(0).received, 1000u );
+    BOOST_CHECK_EQUAL( resumed->GetSegment(1).received, 123u );
+    BOOST_CHECK_EQUAL( resumed->GetSegment(2).received, 0u );
+    BOOST_CHECK_EQUAL( resumed->BytesReceived(), 1123u );
+
+    // Nothing is active after resuming, and finished segments are skipped.
+    BOOST_CHECK_EQUAL( resumed->ActiveCount(), 0u );
+    BOOST_CHECK( resumed->StartNext() == std::size_t(1) );
+
+    // Files without a hash can still be resumed.
+    auto unhashed = SegmentMap::Parse(map.Serialize(""), 2500, "");
+    BOOST_REQUIRE( unhashed );
+    BOOST_CHECK_EQUAL( unhashed->BytesReceived(), 1123u );
+}
+
+BOOST_AUTO_TEST_CASE(KeepsSegmentSizeOfJournal)
+{
+    SegmentMap map(2500, 1000);
+    map.AddReceived(1, 1000);
+
+    auto resumed = SegmentMap::Parse(map.Serialize(kHash), 2500, kHash);
+    BOOST_REQUIRE( resumed );
+    BOOST_CHECK_EQUAL( resumed->GetSegment(1).offset, 1000u );
+    BOOST_CHECK_EQUAL( resumed->GetSegment(1).received, 1000u );
+}
+
+BOOST_AUTO_TEST_CASE(IgnoresJournalOfOtherFile)
+{
+    SegmentMap map(2500, 1000);
+    map.AddReceived(0, 1000);
+    const std::string journal = map.Serialize(kHash);
+
+    // The cloud file changed.
+    BOOST_CHECK( ! SegmentMap::Parse(journal, 2501, kHash) );
+    BOOST_CHECK( ! SegmentMap::Parse(journal, 2500, std::string(64, 'b')) );
+    BOOST_CHECK( ! SegmentMap::Parse(journal, 2500, "") );
+
+    // Damaged journals.
+    BOOST_CHECK( ! SegmentMap::Parse("", 2500, kHash) );
+    BOOST_CHECK( ! SegmentMap::Parse(journal.substr(0, journal.size() - 4),
+            2500, kHash) );
+
+    std::string overfull = journal;
+    overfull.replace(overfull.rfind(" 1000 0 0"), 9, " 1001 0 0");
+    BOOST_CHECK( ! SegmentMap::Parse(overfull, 2500, kHash) );
+}
@@ -0,0 +1,253 @@
+/**
+ * @file bandwidth_analyser.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "bandwidth_analyser.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace {
+
+/** Low bits of a slot hold the byte count, the rest the period tag. */
+const int kCountBits = 40;
+const uint64_t kCountMask = (uint64_t(1) << kCountBits) - 1;
+const uint64_t kTagMask = (uint64_t(1) << (64 - kCountBits)) - 1;
+
+/** Seconds each window covers. */
+const int64_t kCurrentSeconds = 5;
+const int64_t kOneMinuteSeconds = 60;
+const int64_t kFifteenMinutesSeconds = 15 * 60;
+
+uint64_t Tag(int64_t period)
+{
+    return static_cast<uint64_t>(period) & kTagMask;
+}
+
+uint64_t Rate(uint64_t bytes, double seconds)
+{
+    // Less than a second is too short to say much.
+    return static_cast<uint64_t>(bytes / std::max(seconds, 1.0));
+}
+
+}  // namespace
+
+namespace mf {
+namespace http {
+
+const int64_t BandwidthAnalyser::kCoarseSeconds;
+const std::size_t BandwidthAnalyser::kFineSlots;
+const std::size_t BandwidthAnalyser::kCoarseSlots;
+const std::size_t BandwidthAnalyser::kShards;
+
+BandwidthAnalyser::Pointer BandwidthAnalyser::Create()
+{
+    return Pointer(new BandwidthAnalyser);
+}
+
+BandwidthAnalyser::BandwidthAnalyser() :
+    created_(std::chrono::steady_clock::now())
+{
+    for (Counts * counts : {&incoming_, &outgoing_})
+    {
+        for (auto & shard : counts->shards)
+        {
+            for (auto & slot : shard.fine)
+                slot.store(0, std::memory_order_relaxed);
+            for (auto & slot : shard.coarse)
+                slot.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void BandwidthAnalyser::RecordIncomingBytes(
+        size_t bytes,
+        std::chrono::steady_clock::time_point /* start_time */,
+        std::chrono::steady_clock::time_point end_time
+    )
+{
+    Record(&incoming_, bytes, end_time);
+}
+
+void BandwidthAnalyser::RecordOutgoingBytes(
+        size_t bytes,
+        std::chrono::steady_clock::time_point /* start_time */,
+        std::chrono::steady_clock::time_point end_time
+    )
+{
+    Record(&outgoing_, bytes, end_time);
+}
+
+BandwidthAnalyser::Throughput BandwidthAnalyser::GetIncoming() const
+{
+    return Measure(incoming_, std::chrono::steady_clock::now());
+}
+
+BandwidthAnalyser::Throughput BandwidthAnalyser::GetOutgoing() const
+{
+    return Measure(outgoing_, std::chrono::steady_clock::now());
+}
+
+BandwidthAnalyser::Throughput BandwidthAnalyser::GetIncoming(
+        TimePoint now
+    ) const
+{
+    return Measure(incoming_, now);
+}
+
+BandwidthAnalyser::Throughput BandwidthAnalyser::GetOutgoing(
+        TimePoint now
+    ) const
+{
+    return Measure(outgoing_, now);
+}
+
+void BandwidthAnalyser::Record(
+        Counts * counts,
+        size_t bytes,
+        TimePoint end_time
+    )
+{
+    if (bytes == 0 || end_time < created_)
+        return;
+
+    const int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+        end_time - created_).count();
+
+    // Threads usually land in different shards and so do not contend.
+    const std::size_t shard_index =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) % kShards;
+    auto & shard = counts->shards[shard_index];
+
+    AddToSlot(&shard.fine[second % kFineSlots], second, bytes);
+
+    const int64_t coarse = second / kCoarseSeconds;
+    AddToSlot(&shard.coarse[coarse % kCoarseSlots], coarse, bytes);
+}
+
+BandwidthAnalyser::Throughput BandwidthAnalyser::Measure(
+        const Counts & counts,
+        TimePoint now
+    ) const
+{
+    Throughput throughput = {0, 0, 0, 0};
+
+    if (now < created_)
+        return throughput;
+
+    const double elapsed =
+        std::chrono::duration<double>(now - created_).count();
+
+    const int64_t second = static_cast<int64_t>(elapsed);
+    const int64_t coarse = second / kCoarseSeconds;
+
+    // Bytes per period, summed over the shards.
+    auto fine_bytes = [&](int64_t period) -> uint64_t
+    {
+        uint64_t bytes = 0;
+        for (const auto & shard : counts.shards)
+            bytes += SlotBytes(shard.fine[period % kFineSlots], period);
+        return bytes;
+    };
+    auto coarse_bytes = [&](int64_t period) -> uint64_t
+    {
+        uint64_t bytes = 0;
+        for (const auto & shard : counts.shards)
+            bytes += SlotBytes(shard.coarse[period % kCoarseSlots], period);
+        return bytes;
+    };
+
+    // The window ends now, partway through the latest period.
+    const int64_t current_first =
+        std::max<int64_t>(0, second - kCurrentSeconds + 1);
+    const int64_t minute_first =
+        std::max<int64_t>(0, second - kOneMinuteSeconds + 1);
+    const int64_t fifteen_first = std::max<int64_t>(0,
+        coarse - kFifteenMinutesSeconds / kCoarseSeconds + 1);
+
+    uint64_t current = 0;
+    uint64_t minute = 0;
+    for (int64_t period = minute_first; period <= second; ++period)
+    {
+        const uint64_t bytes = fine_bytes(period);
+        minute += bytes;
+        if (period >= current_first)
+            current += bytes;
+    }
+
+    uint64_t fifteen = 0;
+    uint64_t busiest = 0;
+    for (int64_t period = fifteen_first; period <= coarse; ++period)
+    {
+        const uint64_t bytes = coarse_bytes(period);
+        fifteen += bytes;
+
+        // Only whole periods count towards the peak.
+        if (period < coarse)
+            busiest = std::max(busiest, bytes);
+    }
+
+    throughput.current = Rate(current, elapsed - current_first);
+    throughput.one_minute = Rate(minute, elapsed - minute_first);
+    throughput.fifteen_minutes = Rate(fifteen,
+        elapsed - fifteen_first * kCoarseSeconds);
+    throughput.peak = std::max(throughput.current,
+        busiest / static_cast<uint64_t>(kCoarseSeconds));
+
+    return throughput;
+}
+
+uint64_t BandwidthAnalyser::SlotBytes(
+        const std::atomic<uint64_t> & slot,
+        int64_t period
+    )
+{
+    const uint64_t word = slot.load(std::memory_order_relaxed);
+
+    if ((word >> kCountBits) != Tag(period))
+        return 0;
+
+    return word & kCountMask;
+}
+
+void BandwidthAnalyser::AddToSlot(
+        std::atomic<uint64_t> * slot,
+        int64_t period,
+        uint64_t bytes
+    )
+{
+    const uint64_t tag = Tag(period);
+
+    uint64_t word = slot->load(std::memory_order_relaxed);
+    for (;;)
+    {
+        const uint64_t slot_tag = word >> kCountBits;
+
+        uint64_t count;
+        if (slot_tag == tag)
+        {
+            count = std::min(kCountMask, (word & kCountMask) + bytes);
+        }
+        else if (((tag - slot_tag) & kTagMask) <= kTagMask / 2)
+        {
+            // The slot held an earlier period, which has now left the ring.
+            count = std::min(kCountMask, bytes);
+        }
+        else
+        {
+            // Recorded too late, the slot has moved on to a later period.
+            return;
+        }
+
+        if (slot->compare_exchange_weak(word, (tag << kCountBits) | count,
+                std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+}
+
+}  // namespace http
+}  // namespace mf
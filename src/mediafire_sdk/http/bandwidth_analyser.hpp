@@ -0,0 +1,156 @@
+/**
+ * @file bandwidth_analyser.hpp
+ * @author Herbert Jones
+ * @brief Measures throughput over sliding windows.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "mediafire_sdk/http/bandwidth_analyser_interface.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @class BandwidthAnalyser
+ * @brief Keeps recent incoming and outgoing byte counts and reports
+ * throughput from them.
+ *
+ * Bytes are counted in the second, and the ten seconds, in which a range
+ * ended.  Counts are kept in buckets picked by the recording thread and
+ * updated without locking, so many requests may record at once.
+ *
+ * Safe to use from several threads.
+ */
+class BandwidthAnalyser : public BandwidthAnalyserInterface
+{
+public:
+    /** Shared pointer acts as handle. */
+    using Pointer = std::shared_ptr<BandwidthAnalyser>;
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    /**
+     * @brief Throughput in bytes per second.
+     */
+    struct Throughput
+    {
+        /** Over the last five seconds. */
+        uint64_t current;
+
+        /** Over the last minute. */
+        uint64_t one_minute;
+
+        /** Over the last fifteen minutes. */
+        uint64_t fifteen_minutes;
+
+        /**
+         * Highest rate over any ten seconds in the last fifteen minutes, or
+         * the current rate if higher.  An estimate of what the link can
+         * carry.
+         */
+        uint64_t peak;
+    };
+
+    /**
+     * @brief Create an analyser with nothing recorded.
+     *
+     * @return BandwidthAnalyser handle
+     */
+    static Pointer Create();
+
+    virtual void RecordIncomingBytes(
+            size_t bytes,
+            std::chrono::steady_clock::time_point start_time,
+            std::chrono::steady_clock::time_point end_time
+        ) override;
+
+    virtual void RecordOutgoingBytes(
+            size_t bytes,
+            std::chrono::steady_clock::time_point start_time,
+            std::chrono::steady_clock::time_point end_time
+        ) override;
+
+    /**
+     * @brief Get the throughput of received bytes.
+     */
+    Throughput GetIncoming() const;
+
+    /**
+     * @brief Get the throughput of sent bytes.
+     */
+    Throughput GetOutgoing() const;
+
+    /**
+     * @brief Get the throughput of received bytes as of a time.
+     *
+     * @param[in] now Time to measure back from.
+     */
+    Throughput GetIncoming(TimePoint now) const;
+
+    /**
+     * @brief Get the throughput of sent bytes as of a time.
+     *
+     * @param[in] now Time to measure back from.
+     */
+    Throughput GetOutgoing(TimePoint now) const;
+
+private:
+    BandwidthAnalyser();
+
+    /** Seconds covered by each slot of the coarse ring. */
+    static const int64_t kCoarseSeconds = 10;
+
+    /** Slots per ring.  Each holds a tag for its period and a byte count. */
+    static const std::size_t kFineSlots = 64;
+    static const std::size_t kCoarseSlots = 96;
+
+    /** Buckets picked between by recording thread. */
+    static const std::size_t kShards = 8;
+
+    /**
+     * Byte counts for one shard.  The tag and count of a slot share one
+     * word so both are replaced together.
+     */
+    struct Shard
+    {
+        std::array<std::atomic<uint64_t>, kFineSlots> fine;
+        std::array<std::atomic<uint64_t>, kCoarseSlots> coarse;
+    };
+
+    struct Counts
+    {
+        std::array<Shard, kShards> shards;
+    };
+
+    void Record(Counts * counts, size_t bytes, TimePoint end_time);
+
+    Throughput Measure(const Counts & counts, TimePoint now) const;
+
+    /** Bytes counted in a ring for a period, or 0 if the slot moved on. */
+    static uint64_t SlotBytes(
+            const std::atomic<uint64_t> & slot,
+            int64_t period
+        );
+
+    static void AddToSlot(
+            std::atomic<uint64_t> * slot,
+            int64_t period,
+            uint64_t bytes
+        );
+
+    const TimePoint created_;
+
+    Counts incoming_;
+    Counts outgoing_;
+};
+
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,249 @@
+/**
+ * @file bandwidth_limiter.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "bandwidth_limiter.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace mf {
+namespace http {
+
+BandwidthLimiter::Transfer::Transfer(
+        BandwidthLimiter::Pointer limiter,
+        Direction direction,
+        uint64_t id
+    ) :
+    limiter_(std::move(limiter)),
+    direction_(direction),
+    id_(id)
+{
+}
+
+BandwidthLimiter::Transfer::~Transfer()
+{
+    limiter_->EndTransfer(direction_, id_);
+}
+
+BandwidthLimiter::TimePoint BandwidthLimiter::Transfer::Consume(
+        uint64_t bytes
+    )
+{
+    return limiter_->Consume(direction_, id_, bytes);
+}
+
+BandwidthLimiter::Bucket::Bucket() :
+    rate(0),
+    burst(0),
+    virtual_time(0),
+    updated(std::chrono::steady_clock::now()),
+    total_weight(0)
+{
+}
+
+BandwidthLimiter::Pointer BandwidthLimiter::Create()
+{
+    return Pointer(new BandwidthLimiter);
+}
+
+BandwidthLimiter::BandwidthLimiter() :
+    next_id_(0)
+{
+}
+
+void BandwidthLimiter::SetLimit(
+        Direction direction,
+        uint64_t bytes_per_second,
+        uint64_t burst_bytes
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto & bucket = GetBucket(direction);
+
+    // Time so far passes at the old rate.
+    Advance(&bucket, std::chrono::steady_clock::now());
+
+    bucket.rate = bytes_per_second;
+    bucket.burst = burst_bytes;
+}
+
+uint64_t BandwidthLimiter::GetLimit(Direction direction) const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return GetBucket(direction).rate;
+}
+
+uint64_t BandwidthLimiter::GetBurst(Direction direction) const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return GetBucket(direction).burst;
+}
+
+bool BandwidthLimiter::Limited(Direction direction) const
+{
+    return GetLimit(direction) > 0;
+}
+
+BandwidthLimiter::Transfer::Pointer BandwidthLimiter::StartTransfer(
+        Direction direction,
+        uint32_t weight
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto & bucket = GetBucket(direction);
+
+    Advance(&bucket, std::chrono::steady_clock::now());
+
+    Flow flow;
+    flow.weight = std::max<uint32_t>(1, weight);
+
+    bucket.total_weight += flow.weight;
+
+    // A new request may use the burst straight away.
+    flow.finish = bucket.virtual_time
+        - static_cast<double>(bucket.burst) / bucket.total_weight;
+
+    const uint64_t id = ++next_id_;
+    bucket.flows[id] = flow;
+
+    return Transfer::Pointer(new Transfer(shared_from_this(), direction, id));
+}
+
+BandwidthLimiter::TimePoint BandwidthLimiter::Consume(
+        Direction direction,
+        uint64_t id,
+        uint64_t bytes
+    )
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto & bucket = GetBucket(direction);
+
+    if (bucket.rate == 0)
+        return now;
+
+    Advance(&bucket, now);
+
+    auto it = bucket.flows.find(id);
+    if (it == bucket.flows.end())
+        return now;
+
+    auto & flow = it->second;
+
+    // Credit saved up while quiet is capped at the burst size.
+    const double credit =
+        static_cast<double>(bucket.burst) / bucket.total_weight;
+    const double start = std::max(flow.finish,
+        bucket.virtual_time - credit);
+
+    flow.finish = start + static_cast<double>(bytes) / flow.weight;
+
+    if (flow.finish <= bucket.virtual_time)
+        return now;
+
+    // Wait until the busy flows have been allowed as much as this one used,
+    // assuming they stay busy.
+    uint64_t busy_weight = 0;
+    for (const auto & pair : bucket.flows)
+    {
+        if (pair.second.finish > bucket.virtual_time)
+            busy_weight += pair.second.weight;
+    }
+
+    const double wait_seconds = (flow.finish - bucket.virtual_time)
+        * busy_weight / bucket.rate;
+
+    using std::chrono::duration_cast;
+    return now + duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(wait_seconds));
+}
+
+void BandwidthLimiter::EndTransfer(Direction direction, uint64_t id)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto & bucket = GetBucket(direction);
+
+    Advance(&bucket, std::chrono::steady_clock::now());
+
+    auto it = bucket.flows.find(id);
+    if (it != bucket.flows.end())
+    {
+        bucket.total_weight -= it->second.weight;
+        bucket.flows.erase(it);
+    }
+}
+
+void BandwidthLimiter::Advance(Bucket * bucket, TimePoint now)
+{
+    double elapsed = std::chrono::duration<double>(
+        now - bucket->updated).count();
+    bucket->updated = now;
+
+    if (bucket->rate == 0 || elapsed <= 0)
+        return;
+
+    // Virtual time runs at the rate divided among the busy flows, so each
+    // busy flow is allowed bytes in proportion to its weight.  As flows
+    // catch up they stop being busy and the rest go faster.
+    while (elapsed > 0)
+    {
+        uint64_t busy_weight = 0;
+        double next_finish = std::numeric_limits<double>::max();
+        for (const auto & pair : bucket->flows)
+        {
+            const auto & flow = pair.second;
+            if (flow.finish > bucket->virtual_time)
+            {
+                busy_weight += flow.weight;
+                next_finish = std::min(next_finish, flow.finish);
+            }
+        }
+
+        if (busy_weight == 0)
+        {
+            // Quiet time turns into credit.
+            if (bucket->total_weight > 0)
+            {
+                bucket->virtual_time +=
+                    elapsed * bucket->rate / bucket->total_weight;
+            }
+            return;
+        }
+
+        const double needed = (next_finish - bucket->virtual_time)
+            * busy_weight / bucket->rate;
+
+        if (needed >= elapsed)
+        {
+            bucket->virtual_time += elapsed * bucket->rate / busy_weight;
+            return;
+        }
+
+        bucket->virtual_time = next_finish;
+        elapsed -= needed;
+    }
+}
+
+BandwidthLimiter::Bucket & BandwidthLimiter::GetBucket(Direction direction)
+{
+    return direction == Direction::Upload ? upload_ : download_;
+}
+
+const BandwidthLimiter::Bucket & BandwidthLimiter::GetBucket(
+        Direction direction
+    ) const
+{
+    return direction == Direction::Upload ? upload_ : download_;
+}
+
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,184 @@
+/**
+ * @file bandwidth_limiter.hpp
+ * @author Herbert Jones
+ * @brief Caps the combined transfer rate of requests.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @class BandwidthLimiter
+ * @brief Token bucket shared by requests, with one bucket for uploads and one
+ * for downloads.
+ *
+ * Requests report what they transferred and are told when they may transfer
+ * again.  The rate is shared fairly between the requests transferring at the
+ * time, in proportion to their weights, and a request only waits while it
+ * has used more than its share.  Bandwidth left unused by some requests goes
+ * to the others.  Up to the burst size may be transferred without waiting
+ * after a quiet period.
+ *
+ * Safe to use from several threads.
+ */
+class BandwidthLimiter :
+    public std::enable_shared_from_this<BandwidthLimiter>
+{
+public:
+    /** Shared pointer acts as handle. */
+    using Pointer = std::shared_ptr<BandwidthLimiter>;
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    enum class Direction
+    {
+        Upload,
+        Download
+    };
+
+    /**
+     * @class Transfer
+     * @brief One request's use of a bucket.
+     *
+     * The request stops counting towards the share of the others once this
+     * is released.
+     */
+    class Transfer
+    {
+    public:
+        using Pointer = std::shared_ptr<Transfer>;
+
+        ~Transfer();
+
+        /**
+         * @brief Record bytes transferred.
+         *
+         * @param[in] bytes Bytes just sent or received.
+         *
+         * @return When the request may transfer more.
+         */
+        TimePoint Consume(uint64_t bytes);
+
+    private:
+        friend class BandwidthLimiter;
+
+        Transfer(
+                BandwidthLimiter::Pointer limiter,
+                Direction direction,
+                uint64_t id
+            );
+
+        BandwidthLimiter::Pointer limiter_;
+        const Direction direction_;
+        const uint64_t id_;
+    };
+
+    /**
+     * @brief Create a limiter that does not limit until a rate is set.
+     *
+     * @return BandwidthLimiter handle
+     */
+    static Pointer Create();
+
+    /**
+     * @brief Set the most bytes per second transferred in a direction.
+     *
+     * @param[in] direction Uploads or downloads.
+     * @param[in] bytes_per_second Combined rate, or 0 for no limit.
+     * @param[in] burst_bytes Bytes that may be transferred without waiting
+     *                        after a quiet period.
+     */
+    void SetLimit(
+            Direction direction,
+            uint64_t bytes_per_second,
+            uint64_t burst_bytes
+        );
+
+    /**
+     * @brief Get the most bytes per second transferred in a direction.
+     *
+     * @return The rate, or 0 if not limited.
+     */
+    uint64_t GetLimit(Direction direction) const;
+
+    /**
+     * @brief Get the bytes that may be transferred without waiting.
+     *
+     * @return The burst size in bytes.
+     */
+    uint64_t GetBurst(Direction direction) const;
+
+    /**
+     * @brief Check if transfers in a direction are limited.
+     */
+    bool Limited(Direction direction) const;
+
+    /**
+     * @brief Begin counting a request towards a bucket.
+     *
+     * @param[in] direction Uploads or downloads.
+     * @param[in] weight Share of the rate relative to other requests, at
+     *                   least 1.
+     *
+     * @return Handle to report transfers with.
+     */
+    Transfer::Pointer StartTransfer(Direction direction, uint32_t weight);
+
+private:
+    BandwidthLimiter();
+
+    struct Flow
+    {
+        uint32_t weight;
+
+        /** Virtual time at which the flow has used its share. */
+        double finish;
+    };
+
+    struct Bucket
+    {
+        Bucket();
+
+        uint64_t rate;
+        uint64_t burst;
+
+        /** Bytes per unit of weight each busy flow was allowed so far. */
+        double virtual_time;
+        TimePoint updated;
+
+        std::map<uint64_t, Flow> flows;
+        uint64_t total_weight;
+    };
+
+    /** Move virtual time forward to now. */
+    void Advance(Bucket * bucket, TimePoint now);
+
+    TimePoint Consume(
+            Direction direction,
+            uint64_t id,
+            uint64_t bytes
+        );
+    void EndTransfer(Direction direction, uint64_t id);
+
+    Bucket & GetBucket(Direction direction);
+    const Bucket & GetBucket(Direction direction) const;
+
+    mutable mf::utils::mutex mutex_;
+
+    Bucket upload_;
+    Bucket download_;
+    uint64_t next_id_;
+};
+
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,168 @@
+/**
+ * @file content_accumulator.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "content_accumulator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "boost/lexical_cast.hpp"
+
+namespace hl = mf::http;
+
+namespace {
+// Same as the storage of pooled receive buffers.
+const uint64_t kBlockSize = 1024 * 64;
+const uint64_t kMinBlockSize = 256;
+
+// Pieces at least this large waste little of the storage behind them, so are
+// kept rather than copied.
+const uint64_t kKeepSize = kBlockSize / 4 * 3;
+}  // namespace
+
+hl::ContentAccumulator::ContentAccumulator() :
+    reserved_(false),
+    size_(0)
+{
+}
+
+void hl::ContentAccumulator::Start(const Headers & headers)
+{
+    content_.clear();
+    reserved_ = false;
+    blocks_.clear();
+    size_ = 0;
+
+    // Decoded content has a length of its own.
+    if ( headers.Find("content-encoding") )
+        return;
+
+    auto content_length = headers.Find("content-length");
+    if ( ! content_length )
+        return;
+
+    uint64_t length = 0;
+    try {
+        length = boost::lexical_cast<uint64_t>(std::string(
+            content_length->begin(), content_length->end()));
+    }
+    catch (const boost::bad_lexical_cast &)
+    {
+        return;
+    }
+
+    if ( length > MaxReserve() )
+        return;
+
+    content_.reserve(length);
+    reserved_ = true;
+}
+
+void hl::ContentAccumulator::Append(std::shared_ptr<BufferInterface> buffer)
+{
+    size_ += buffer->Size();
+
+    if (reserved_)
+    {
+        content_.append(reinterpret_cast<const char*>(buffer->Data()),
+            buffer->Size());
+    }
+    else if (buffer->Size() >= kKeepSize)
+    {
+        blocks_.push_back(Block{std::move(buffer), std::string()});
+    }
+    else
+    {
+        const char * data = reinterpret_cast<const char*>(buffer->Data());
+        uint64_t remaining = buffer->Size();
+        while (remaining > 0)
+        {
+            if (blocks_.empty() || blocks_.back().buffer
+                || blocks_.back().copied.size() == kBlockSize)
+            {
+                blocks_.push_back(Block());
+            }
+
+            // Grown in powers of two, so never past a full block.
+            std::string & copied = blocks_.back().copied;
+            const uint64_t count = std::min(remaining,
+                kBlockSize - copied.size());
+            if (copied.size() + count > copied.capacity())
+            {
+                uint64_t capacity = kMinBlockSize;
+                while (capacity < copied.size() + count)
+                    capacity *= 2;
+                copied.reserve(capacity);
+            }
+
+            copied.append(data, count);
+            data += count;
+            remaining -= count;
+        }
+    }
+}
+
+uint64_t hl::ContentAccumulator::Held() const
+{
+    if (reserved_)
+        return content_.capacity();
+
+    uint64_t held = 0;
+    for (const auto & block : blocks_)
+    {
+        if (block.buffer)
+            held += block.buffer->Size();
+        else
+            held += block.copied.capacity();
+    }
+    return held;
+}
+
+std::string hl::ContentAccumulator::Take()
+{
+    std::string content;
+
+    if (reserved_)
+    {
+        content.swap(content_);
+    }
+    else if (blocks_.size() == 1 && ! blocks_.front().buffer)
+    {
+        content.swap(blocks_.front().copied);
+    }
+    else if ( ! blocks_.empty() )
+    {
+        content.resize(size_);
+
+        char * pos = &content[0];
+        for (const auto & block : blocks_)
+        {
+            if (block.buffer)
+            {
+                std::memcpy(pos, block.buffer->Data(), block.buffer->Size());
+                pos += block.buffer->Size();
+            }
+            else
+            {
+                std::memcpy(pos, block.copied.data(), block.copied.size());
+                pos += block.copied.size();
+            }
+        }
+    }
+
+    content_.clear();
+    reserved_ = false;
+    blocks_.clear();
+    size_ = 0;
+
+    return content;
+}
+
+uint64_t hl::ContentAccumulator::MaxReserve()
+{
+    return 1024 * 1024 * 64;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file content_accumulator.hpp
+ * @author Herbert Jones
+ * @brief Collects response content into a single string.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mediafire_sdk/http/buffer_interface.hpp"
+#include "mediafire_sdk/http/headers.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @class ContentAccumulator
+ * @brief Collects the content of a response as it arrives, for callers that
+ * want it whole.
+ *
+ * When the headers give the length of the content, the string is sized for it
+ * up front and each buffer is copied in once.  Otherwise buffers that are
+ * mostly full are held as they are, and smaller pieces are copied together
+ * into blocks, so a pooled buffer is not kept for every few bytes of content.
+ * All of it is copied into a string of the right size when the content is
+ * taken, rather than growing a string piece by piece.
+ */
+class ContentAccumulator
+{
+public:
+    ContentAccumulator();
+
+    /**
+     * @brief Prepare for the content of a response.
+     *
+     * Discards any content collected so far.
+     *
+     * @param[in] headers Headers of the response.
+     */
+    void Start(const Headers & headers);
+
+    /**
+     * @brief Add the next piece of the content.
+     *
+     * @param[in] buffer The piece.  Kept until Take() when it is large,
+     *                   otherwise copied.
+     */
+    void Append(std::shared_ptr<BufferInterface> buffer);
+
+    /**
+     * @return Bytes of content collected so far.
+     */
+    uint64_t Size() const { return size_; }
+
+    /**
+     * @return Bytes of memory held for the content collected so far, counting
+     *         buffers kept as they are by their size.
+     */
+    uint64_t Held() const;
+
+    /**
+     * @brief Get the content collected and start over.
+     *
+     * @return The content.
+     */
+    std::string Take();
+
+    /**
+     * @brief Largest Content-Length that is reserved up front.
+     *
+     * Larger content is collected as if its length were unknown, so that a
+     * bad header can not reserve an arbitrary amount of memory.
+     *
+     * @return Size in bytes.
+     */
+    static uint64_t MaxReserve();
+
+private:
+    /** Content copied so far, when the length was known. */
+    std::string content_;
+    bool reserved_;
+
+    /** A buffer kept as it is, or small pieces copied together. */
+    struct Block
+    {
+        std::shared_ptr<BufferInterface> buffer;
+        std::string copied;
+    };
+
+    /** Content held so far, when the length was not known. */
+    std::vector<Block> blocks_;
+
+    uint64_t size_;
+};
+
+}  // namespace http
+}  // namespace mf
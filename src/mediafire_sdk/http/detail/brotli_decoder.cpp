@@ -0,0 +1,125 @@
+/**
+ * @file brotli_decoder.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "brotli_decoder.hpp"
+
+#include <sstream>
+#include <utility>
+
+#include "brotli/decode.h"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+struct BrotliDecoder::State
+{
+    State() : decoder(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr))
+    {}
+
+    ~State()
+    {
+        if ( decoder )
+            BrotliDecoderDestroyInstance(decoder);
+    }
+
+    BrotliDecoderState * decoder;
+};
+
+BrotliDecoder::BrotliDecoder(SharedBufferPool::Pointer buffer_pool) :
+    state_(new State()),
+    output_(std::move(buffer_pool)),
+    stream_end_(false),
+    failed_(false)
+{
+    if ( ! state_->decoder )
+    {
+        failed_ = true;
+        error_string_ = "Unable to initialize brotli.";
+    }
+}
+
+BrotliDecoder::~BrotliDecoder()
+{
+}
+
+bool BrotliDecoder::Decode(
+        const uint8_t * data,
+        uint64_t size,
+        const OutputCallback & output
+    )
+{
+    if ( ! failed_ && stream_end_ && size > 0 )
+    {
+        failed_ = true;
+        error_string_ = "Content continues after the end of the brotli"
+            " stream.";
+    }
+
+    std::size_t available_in = static_cast<std::size_t>(size);
+    const uint8_t * next_in = data;
+
+    while ( ! failed_ && ! stream_end_ )
+    {
+        uint8_t * const out = output_.Space();
+        std::size_t available_out = static_cast<std::size_t>(
+            output_.Available());
+        uint8_t * next_out = out;
+
+        const BrotliDecoderResult result = BrotliDecoderDecompressStream(
+            state_->decoder, &available_in, &next_in, &available_out,
+            &next_out, nullptr);
+
+        output_.Produced(next_out - out, output);
+
+        if ( result == BROTLI_DECODER_RESULT_SUCCESS )
+        {
+            stream_end_ = true;
+
+            if ( available_in > 0 )
+            {
+                failed_ = true;
+                error_string_ = "Content continues after the end of the"
+                    " brotli stream.";
+            }
+        }
+        else if ( result == BROTLI_DECODER_RESULT_ERROR )
+        {
+            const BrotliDecoderErrorCode code = BrotliDecoderGetErrorCode(
+                state_->decoder);
+
+            std::stringstream ss;
+            ss << "Brotli decode failed. Error: " << code << " ("
+                << BrotliDecoderErrorString(code) << ")";
+            error_string_ = ss.str();
+            failed_ = true;
+        }
+        else if ( result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT )
+        {
+            break;
+        }
+        // Otherwise the output buffer is full and decoding continues.
+    }
+
+    // Pass on what the piece produced without waiting for more.
+    output_.Flush(output);
+
+    return ! failed_;
+}
+
+bool BrotliDecoder::Finish()
+{
+    if ( ! failed_ && ! stream_end_ )
+    {
+        failed_ = true;
+        error_string_ = "Content ended before the end of the brotli stream.";
+    }
+
+    return ! failed_;
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
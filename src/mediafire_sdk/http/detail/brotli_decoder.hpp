@@ -0,0 +1,68 @@
+/**
+ * @file brotli_decoder.hpp
+ * @author Herbert Jones
+ * @brief Incremental brotli decompression of response content.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class BrotliDecoder
+ * @brief Decompresses "br" content piece by piece as it is read.
+ *
+ * Only built when HTTP_USE_BROTLI is defined.
+ */
+class BrotliDecoder : public ContentDecoderInterface
+{
+public:
+    /**
+     * @brief CTOR
+     *
+     * @param[in] buffer_pool Pool of the output buffers.
+     */
+    explicit BrotliDecoder(SharedBufferPool::Pointer buffer_pool);
+
+    virtual ~BrotliDecoder();
+
+    virtual bool Decode(
+            const uint8_t * data,
+            uint64_t size,
+            const OutputCallback & output
+        ) override;
+
+    virtual bool Finish() override;
+
+    virtual const std::string & ErrorString() const override
+    {
+        return error_string_;
+    }
+
+private:
+    BrotliDecoder(const BrotliDecoder &) = delete;
+    BrotliDecoder & operator=(const BrotliDecoder &) = delete;
+
+    struct State;
+    std::unique_ptr<State> state_;
+
+    DecoderOutput output_;
+
+    bool stream_end_;
+    bool failed_;
+    std::string error_string_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,391 @@
+/**
+ * @file connect_racer.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "connect_racer.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+#include "boost/asio.hpp"
+
+#include "mediafire_sdk/http/detail/types.hpp"
+
+namespace asio = boost::asio;
+
+namespace {
+// Recommended by RFC 8305 section 5.
+const std::chrono::milliseconds kDefaultAttemptDelay(250);
+
+// RFC 8305 section 4 advises against remembering for longer.
+const std::chrono::seconds kDefaultWinnerTimeout(600);
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+ConnectRace::Pointer ConnectRace::Create(
+        asio::ip::tcp::socket * socket,
+        Endpoints endpoints,
+        std::chrono::milliseconds attempt_delay,
+        WinnerHandler on_winner
+    )
+{
+    return std::shared_ptr<ConnectRace>(new ConnectRace(socket,
+            std::move(endpoints), attempt_delay, std::move(on_winner)));
+}
+
+ConnectRace::ConnectRace(
+        asio::ip::tcp::socket * socket,
+        Endpoints endpoints,
+        std::chrono::milliseconds attempt_delay,
+        WinnerHandler on_winner
+    ) :
+    socket_(socket),
+    endpoints_(std::move(endpoints)),
+    attempt_delay_(attempt_delay),
+    on_winner_(std::move(on_winner)),
+    pending_(0),
+    finished_(false),
+    last_error_(asio::error::not_found),
+    attempt_delay_timer_(socket->get_io_service()),
+    attempt_delay_generation_(0)
+{
+}
+
+void ConnectRace::Start(ConnectHandler handler)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    handler_ = std::move(handler);
+
+    StartNextAttempt();
+
+    // Nothing could be attempted.
+    if (pending_ == 0 && ! finished_)
+    {
+        finished_ = true;
+
+        ConnectHandler handler = std::move(handler_);
+        handler_ = nullptr;
+
+        const boost::system::error_code ec = last_error_;
+        socket_->get_io_service().post(
+            [handler, ec]()
+            {
+                handler(ec, asio::ip::tcp::endpoint());
+            });
+    }
+}
+
+void ConnectRace::Cancel()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    finished_ = true;
+    CloseAttempts();
+
+    // Release what the handlers hold.
+    handler_ = nullptr;
+    on_winner_ = nullptr;
+}
+
+void ConnectRace::StartNextAttempt()
+{
+    while (attempts_.size() < endpoints_.size())
+    {
+        const std::size_t index = attempts_.size();
+        const asio::ip::tcp::endpoint & endpoint = endpoints_[index];
+
+        auto attempt = std::make_shared<asio::ip::tcp::socket>(
+            socket_->get_io_service());
+        attempts_.push_back(attempt);
+
+        // The family may be unsupported here, so skip to the next address.
+        boost::system::error_code ec;
+        attempt->open(endpoint.protocol(), ec);
+        if (ec)
+        {
+            last_error_ = ec;
+            attempts_.back().reset();
+            continue;
+        }
+
+        ++pending_;
+
+        auto self = shared_from_this();
+        attempt->async_connect(endpoint,
+            [self, index](const boost::system::error_code & ec)
+            {
+                self->HandleAttempt(index, ec);
+            });
+
+        // Give this attempt a head start before starting the next.
+        if (attempts_.size() < endpoints_.size())
+        {
+            const uint64_t generation = ++attempt_delay_generation_;
+
+            attempt_delay_timer_.expires_from_now(attempt_delay_);
+            attempt_delay_timer_.async_wait(
+                [self, generation](const boost::system::error_code & ec)
+                {
+                    self->HandleAttemptDelay(generation, ec);
+                });
+        }
+
+        return;
+    }
+}
+
+void ConnectRace::CloseAttempts()
+{
+    ++attempt_delay_generation_;
+
+    boost::system::error_code ec;
+    attempt_delay_timer_.cancel(ec);
+
+    for (auto & attempt : attempts_)
+    {
+        if (attempt)
+        {
+            attempt->close(ec);
+            attempt.reset();
+        }
+    }
+}
+
+void ConnectRace::HandleAttempt(
+        std::size_t index,
+        const boost::system::error_code & ec
+    )
+{
+    asio::ip::tcp::endpoint endpoint;
+    ConnectHandler handler;
+    WinnerHandler on_winner;
+    boost::system::error_code result;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        --pending_;
+
+        if (finished_)
+            return;
+
+        if ( ! ec )
+        {
+            finished_ = true;
+
+            // Hand the connection over before closing the losers.
+            *socket_ = std::move(*attempts_[index]);
+            attempts_[index].reset();
+            CloseAttempts();
+
+            endpoint = endpoints_[index];
+            on_winner = std::move(on_winner_);
+        }
+        else
+        {
+            last_error_ = ec;
+
+            boost::system::error_code close_ec;
+            attempts_[index]->close(close_ec);
+            attempts_[index].reset();
+
+            // No reason to wait before trying the next address.
+            StartNextAttempt();
+
+            if (pending_ != 0)
+                return;
+
+            finished_ = true;
+            result = last_error_;
+        }
+
+        handler = std::move(handler_);
+        handler_ = nullptr;
+        on_winner_ = nullptr;
+    }
+
+    if (on_winner)
+        on_winner(endpoint);
+
+    handler(result, endpoint);
+}
+
+void ConnectRace::HandleAttemptDelay(
+        uint64_t generation,
+        const boost::system::error_code & ec
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (ec || finished_ || generation != attempt_delay_generation_)
+        return;
+
+    StartNextAttempt();
+}
+
+ConnectRacer::Pointer ConnectRacer::Create()
+{
+    return std::shared_ptr<ConnectRacer>(new ConnectRacer);
+}
+
+ConnectRacer::ConnectRacer() :
+    attempt_delay_(kDefaultAttemptDelay),
+    winner_timeout_(kDefaultWinnerTimeout)
+{
+}
+
+ConnectRace::Pointer ConnectRacer::AsyncConnect(
+        asio::ip::tcp::socket * socket,
+        asio::ip::tcp::resolver::iterator endpoint_iterator,
+        ConnectHandler handler
+    )
+{
+    std::string host;
+    std::string port;
+    Endpoints endpoints;
+    for ( ; endpoint_iterator != asio::ip::tcp::resolver::iterator();
+        ++endpoint_iterator )
+    {
+        host = endpoint_iterator->host_name();
+        port = endpoint_iterator->service_name();
+        endpoints.push_back(endpoint_iterator->endpoint());
+    }
+
+    endpoints = OrderEndpoints(host, port, std::move(endpoints));
+
+    std::weak_ptr<ConnectRacer> weak_self = shared_from_this();
+    const std::string key = host + ':' + port;
+
+    auto race = ConnectRace::Create(socket, std::move(endpoints),
+        GetAttemptDelay(),
+        [weak_self, key](const asio::ip::tcp::endpoint & endpoint)
+        {
+            if (auto self = weak_self.lock())
+                self->RememberWinner(key, endpoint);
+        });
+
+    race->Start(std::move(handler));
+
+    return race;
+}
+
+ConnectRacer::Endpoints ConnectRacer::OrderEndpoints(
+        const std::string & host,
+        const std::string & port,
+        Endpoints endpoints
+    ) const
+{
+    if (endpoints.empty())
+        return endpoints;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        auto it = winners_.find(host + ':' + port);
+        if (it != winners_.end() && it->second.expires > sclock::now())
+        {
+            auto winner = std::find(endpoints.begin(), endpoints.end(),
+                it->second.endpoint);
+            if (winner != endpoints.end())
+                std::rotate(endpoints.begin(), winner, winner + 1);
+        }
+    }
+
+    // Alternate families, starting with the family of the first endpoint.
+    const bool first_is_v6 = endpoints.front().address().is_v6();
+
+    std::deque<asio::ip::tcp::endpoint> first_family;
+    std::deque<asio::ip::tcp::endpoint> other_family;
+    for (const auto & endpoint : endpoints)
+    {
+        if (endpoint.address().is_v6() == first_is_v6)
+            first_family.push_back(endpoint);
+        else
+            other_family.push_back(endpoint);
+    }
+
+    Endpoints ordered;
+    ordered.reserve(endpoints.size());
+    while ( ! first_family.empty() || ! other_family.empty() )
+    {
+        if ( ! first_family.empty() )
+        {
+            ordered.push_back(first_family.front());
+            first_family.pop_front();
+        }
+        if ( ! other_family.empty() )
+        {
+            ordered.push_back(other_family.front());
+            other_family.pop_front();
+        }
+    }
+
+    return ordered;
+}
+
+void ConnectRacer::RememberWinner(
+        const std::string & key,
+        const asio::ip::tcp::endpoint & endpoint
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    const TimePoint now = sclock::now();
+
+    // Drop expired entries so hosts no longer used are not kept forever.
+    for (auto it = winners_.begin(); it != winners_.end(); )
+    {
+        if (it->second.expires <= now)
+            it = winners_.erase(it);
+        else
+            ++it;
+    }
+
+    if (winner_timeout_ > std::chrono::seconds(0))
+        winners_[key] = Winner{endpoint, now + winner_timeout_};
+}
+
+void ConnectRacer::Flush()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    winners_.clear();
+}
+
+void ConnectRacer::SetAttemptDelay(std::chrono::milliseconds delay)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    attempt_delay_ = delay;
+}
+
+std::chrono::milliseconds ConnectRacer::GetAttemptDelay() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return attempt_delay_;
+}
+
+void ConnectRacer::SetWinnerTimeout(std::chrono::seconds timeout)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    winner_timeout_ = timeout;
+}
+
+std::chrono::seconds ConnectRacer::GetWinnerTimeout() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return winner_timeout_;
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
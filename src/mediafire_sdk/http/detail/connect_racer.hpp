@@ -0,0 +1,203 @@
+/**
+ * @file connect_racer.hpp
+ * @author Herbert Jones
+ * @brief Staggered parallel connection attempts to the addresses of a host.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/asio/ip/tcp.hpp"
+#include "boost/asio/steady_timer.hpp"
+#include "boost/system/error_code.hpp"
+
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class ConnectRace
+ * @brief A connection to one host being raced over its addresses.
+ *
+ * Attempts start one after another, each a short delay after the previous,
+ * or as soon as the previous failed.  The first to connect wins and the
+ * others are closed.  Created by ConnectRacer::AsyncConnect.
+ */
+class ConnectRace :
+    public std::enable_shared_from_this<ConnectRace>
+{
+public:
+    using Pointer = std::shared_ptr<ConnectRace>;
+
+    using Endpoints = std::vector<boost::asio::ip::tcp::endpoint>;
+
+    using ConnectHandler = std::function<
+        void(
+            const boost::system::error_code &,
+            boost::asio::ip::tcp::endpoint
+        )>;
+
+    /** Called with the winning endpoint once a connection is made. */
+    using WinnerHandler = std::function<
+        void(const boost::asio::ip::tcp::endpoint &)>;
+
+    static Pointer Create(
+            boost::asio::ip::tcp::socket * socket,
+            Endpoints endpoints,
+            std::chrono::milliseconds attempt_delay,
+            WinnerHandler on_winner
+        );
+
+    /**
+     * @brief Begin connecting.
+     *
+     * @param[in] handler Called from the io_service of the socket once
+     *                    connected, or once every address failed.
+     */
+    void Start(ConnectHandler handler);
+
+    /**
+     * @brief Stop all attempts.  The handler will not be called.
+     */
+    void Cancel();
+
+private:
+    ConnectRace(
+            boost::asio::ip::tcp::socket * socket,
+            Endpoints endpoints,
+            std::chrono::milliseconds attempt_delay,
+            WinnerHandler on_winner
+        );
+
+    using SocketPointer = std::shared_ptr<boost::asio::ip::tcp::socket>;
+
+    // Must hold the mutex.
+    void StartNextAttempt();
+    void CloseAttempts();
+
+    void HandleAttempt(
+            std::size_t index,
+            const boost::system::error_code & ec
+        );
+
+    void HandleAttemptDelay(
+            uint64_t generation,
+            const boost::system::error_code & ec
+        );
+
+    mf::utils::mutex mutex_;
+
+    boost::asio::ip::tcp::socket * socket_;
+    Endpoints endpoints_;
+    std::chrono::milliseconds attempt_delay_;
+    WinnerHandler on_winner_;
+    ConnectHandler handler_;
+
+    // One per endpoint attempted, reset once the attempt fails.
+    std::vector<SocketPointer> attempts_;
+    std::size_t pending_;
+    bool finished_;
+    boost::system::error_code last_error_;
+
+    boost::asio::steady_timer attempt_delay_timer_;
+    uint64_t attempt_delay_generation_;
+};
+
+/**
+ * @class ConnectRacer
+ * @brief Connects to hosts with several addresses without waiting on
+ * unreachable ones, as described by RFC 8305 "Happy Eyeballs".
+ *
+ * Addresses are tried alternating between IPv6 and IPv4, starting with the
+ * family of the first address.  The address of each host that last won a race
+ * is tried first for a limited time, so later requests connect at once.
+ */
+class ConnectRacer :
+    public std::enable_shared_from_this<ConnectRacer>
+{
+public:
+    using Pointer = std::shared_ptr<ConnectRacer>;
+
+    using Endpoints = ConnectRace::Endpoints;
+    using ConnectHandler = ConnectRace::ConnectHandler;
+
+    static Pointer Create();
+
+    /**
+     * @brief Connect a socket to one of the resolved endpoints of a host.
+     *
+     * @param[in] socket Closed socket which receives the winning connection.
+     * @param[in] endpoint_iterator Resolved endpoints, with the host and port
+     *                              they were resolved from.
+     * @param[in] handler Called from the io_service of the socket with the
+     *                    result.
+     *
+     * @return The race, to cancel it with.
+     */
+    ConnectRace::Pointer AsyncConnect(
+            boost::asio::ip::tcp::socket * socket,
+            boost::asio::ip::tcp::resolver::iterator endpoint_iterator,
+            ConnectHandler handler
+        );
+
+    /**
+     * @brief Put endpoints in the order they would be attempted.
+     *
+     * @param[in] host Host name resolved.
+     * @param[in] port Port or service name resolved.
+     * @param[in] endpoints Endpoints in the order they were resolved.
+     *
+     * @return Endpoints in the order to attempt them.
+     */
+    Endpoints OrderEndpoints(
+            const std::string & host,
+            const std::string & port,
+            Endpoints endpoints
+        ) const;
+
+    /**
+     * @brief Forget which address of each host won.
+     */
+    void Flush();
+
+    void SetAttemptDelay(std::chrono::milliseconds delay);
+    std::chrono::milliseconds GetAttemptDelay() const;
+
+    void SetWinnerTimeout(std::chrono::seconds timeout);
+    std::chrono::seconds GetWinnerTimeout() const;
+
+private:
+    ConnectRacer();
+
+    struct Winner
+    {
+        boost::asio::ip::tcp::endpoint endpoint;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    void RememberWinner(
+            const std::string & key,
+            const boost::asio::ip::tcp::endpoint & endpoint
+        );
+
+    mutable mf::utils::mutex mutex_;
+
+    // Keyed by host and port.
+    std::map<std::string, Winner> winners_;
+
+    std::chrono::milliseconds attempt_delay_;
+    std::chrono::seconds winner_timeout_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
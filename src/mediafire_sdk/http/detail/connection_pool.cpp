@@ -0,0 +1,281 @@
+/**
+ * @file connection_pool.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "connection_pool.hpp"
+
+#include <cassert>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+
+#include "mediafire_sdk/http/detail/socket_wrapper.hpp"
+#include "mediafire_sdk/http/detail/types.hpp"
+
+namespace asio = boost::asio;
+
+namespace {
+const std::size_t kDefaultMaxIdlePerHost = 4;
+const std::chrono::seconds kDefaultIdleTimeout(15);
+
+/**
+ * An idle keep-alive connection should have nothing to read.  If the remote
+ * end has closed the connection, or sent something unexpected such as an SSL
+ * close notification, the connection can not be reused.
+ */
+bool IsIdleConnectionUsable(mf::http::detail::SocketWrapper * socket_wrapper)
+{
+    asio::ip::tcp::socket & socket = socket_wrapper->LowestLayer();
+
+    if ( ! socket.is_open() )
+        return false;
+
+    boost::system::error_code ec;
+    socket.non_blocking(true, ec);
+    if (ec)
+        return false;
+
+    char peek_byte;
+    socket.receive(asio::buffer(&peek_byte, 1),
+        asio::ip::tcp::socket::message_peek, ec);
+
+    const bool usable = (ec == asio::error::would_block);
+
+    socket.non_blocking(false, ec);
+
+    return usable && ! ec;
+}
+
+/**
+ * Lives in each io_service with pooled connections, and closes them as the
+ * io_service shuts down, as sockets must not outlive their io_service.
+ */
+class ConnectionPoolFlusher : public asio::io_service::service
+{
+public:
+    using PoolPointer = std::weak_ptr<mf::http::detail::ConnectionPool>;
+
+    static asio::io_service::id id;
+
+    explicit ConnectionPoolFlusher(asio::io_service & io_service) :
+        asio::io_service::service(io_service)
+    {
+    }
+
+    void Register(PoolPointer pool)
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        pools_.insert(pool);
+    }
+
+private:
+    virtual void shutdown_service() override
+    {
+        std::set<PoolPointer, std::owner_less<PoolPointer>> pools;
+        {
+            mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+            std::swap(pools, pools_);
+        }
+
+        for (const auto & weak_pool : pools)
+        {
+            if (auto pool = weak_pool.lock())
+                pool->Clear(&get_io_service());
+        }
+    }
+
+    mf::utils::mutex mutex_;
+    std::set<PoolPointer, std::owner_less<PoolPointer>> pools_;
+};
+
+asio::io_service::id ConnectionPoolFlusher::id;
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+bool ConnectionPoolKey::operator<(const ConnectionPoolKey & rhs) const
+{
+    return std::tie(scheme, host, port, proxy, io_service)
+        < std::tie(rhs.scheme, rhs.host, rhs.port, rhs.proxy, rhs.io_service);
+}
+
+ConnectionPool::Pointer ConnectionPool::Create()
+{
+    return std::shared_ptr<ConnectionPool>(new ConnectionPool);
+}
+
+ConnectionPool::ConnectionPool() :
+    max_idle_per_host_(kDefaultMaxIdlePerHost),
+    idle_timeout_(kDefaultIdleTimeout),
+    statistics_{0, 0}
+{
+}
+
+std::shared_ptr<SocketWrapper> ConnectionPool::Acquire(
+        const ConnectionPoolKey & key
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (max_idle_per_host_ == 0)
+        return nullptr;
+
+    RemoveExpired(sclock::now());
+
+    std::shared_ptr<SocketWrapper> socket_wrapper;
+
+    auto it = idle_.find(key);
+    if (it != idle_.end())
+    {
+        auto & connections = it->second;
+
+        // Most recently used connections are the most likely to still be
+        // open.
+        while ( ! connections.empty() && ! socket_wrapper )
+        {
+            auto candidate = connections.back().socket_wrapper;
+            connections.pop_back();
+
+            if (IsIdleConnectionUsable(candidate.get()))
+                socket_wrapper = candidate;
+        }
+
+        if (connections.empty())
+            idle_.erase(it);
+    }
+
+    if (socket_wrapper)
+        ++statistics_.hits;
+    else
+        ++statistics_.misses;
+
+    return socket_wrapper;
+}
+
+void ConnectionPool::Release(
+        const ConnectionPoolKey & key,
+        std::shared_ptr<SocketWrapper> socket_wrapper
+    )
+{
+    assert(socket_wrapper);
+
+    // Closed by the io_service as it shuts down, if still here.
+    if (key.io_service)
+    {
+        asio::use_service<ConnectionPoolFlusher>(*key.io_service).Register(
+            shared_from_this());
+    }
+
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (max_idle_per_host_ == 0)
+        return;
+
+    const TimePoint now = sclock::now();
+
+    RemoveExpired(now);
+
+    auto & connections = idle_[key];
+
+    while (connections.size() >= max_idle_per_host_)
+        connections.pop_front();
+
+    connections.push_back(IdleConnection{socket_wrapper, now});
+}
+
+void ConnectionPool::Clear()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    idle_.clear();
+}
+
+void ConnectionPool::Clear(asio::io_service * io_service)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    for (auto it = idle_.begin(); it != idle_.end(); )
+    {
+        if (it->first.io_service == io_service)
+            it = idle_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ConnectionPool::SetMaxIdlePerHost(std::size_t max_idle)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    max_idle_per_host_ = max_idle;
+
+    for (auto it = idle_.begin(); it != idle_.end(); )
+    {
+        while (it->second.size() > max_idle_per_host_)
+            it->second.pop_front();
+
+        if (it->second.empty())
+            it = idle_.erase(it);
+        else
+            ++it;
+    }
+}
+
+std::size_t ConnectionPool::GetMaxIdlePerHost() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return max_idle_per_host_;
+}
+
+void ConnectionPool::SetIdleTimeout(std::chrono::seconds idle_timeout)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    idle_timeout_ = idle_timeout;
+}
+
+std::chrono::seconds ConnectionPool::GetIdleTimeout() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return idle_timeout_;
+}
+
+ConnectionPoolStatistics ConnectionPool::GetStatistics() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return statistics_;
+}
+
+void ConnectionPool::RemoveExpired(TimePoint now)
+{
+    for (auto it = idle_.begin(); it != idle_.end(); )
+    {
+        auto & connections = it->second;
+
+        // Connections are ordered oldest first.
+        while ( ! connections.empty()
+            && connections.front().idle_since + idle_timeout_ <= now )
+        {
+            connections.pop_front();
+        }
+
+        if (connections.empty())
+            it = idle_.erase(it);
+        else
+            ++it;
+    }
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,145 @@
+/**
+ * @file connection_pool.hpp
+ * @author Herbert Jones
+ * @brief Pool of idle keep-alive connections.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/utils/forward_declarations/asio.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @struct ConnectionPoolStatistics
+ * @brief Counters describing connection pool reuse.
+ */
+struct ConnectionPoolStatistics
+{
+    /** Requests that were sent over an idle pooled connection. */
+    uint64_t hits;
+
+    /** Requests that had to open a new connection. */
+    uint64_t misses;
+};
+
+namespace detail {
+
+class SocketWrapper;
+
+/**
+ * @struct ConnectionPoolKey
+ * @brief Identifies connections that can be shared between requests.
+ */
+struct ConnectionPoolKey
+{
+    std::string scheme;
+    std::string host;
+    std::string port;
+
+    /** Proxy host, port and username, or empty if not proxied. */
+    std::string proxy;
+
+    /** Connections only work with the io_service they were made with. */
+    boost::asio::io_service * io_service = nullptr;
+
+    bool operator<(const ConnectionPoolKey & rhs) const;
+};
+
+/**
+ * @class ConnectionPool
+ * @brief Holds connected sockets between requests so they can be reused.
+ *
+ * Only sockets with no outstanding asynchronous operations may be released
+ * into the pool.  Expired connections are removed lazily when the pool is
+ * accessed, so the pool never keeps an io_service running.
+ *
+ * Connections are closed when the io_service they belong to is destroyed, so
+ * the pool may outlive it.
+ */
+class ConnectionPool :
+    public std::enable_shared_from_this<ConnectionPool>
+{
+public:
+    using Pointer = std::shared_ptr<ConnectionPool>;
+
+    static Pointer Create();
+
+    /**
+     * @brief Take an idle connection out of the pool.
+     *
+     * Connections the remote end has closed are discarded.
+     *
+     * @param[in] key Connection identity.
+     *
+     * @return Connected socket or nullptr if none available.
+     */
+    std::shared_ptr<SocketWrapper> Acquire(const ConnectionPoolKey & key);
+
+    /**
+     * @brief Return a connection to the pool.
+     *
+     * If the pool already holds the maximum number of idle connections for the
+     * key, the oldest is closed.
+     *
+     * @param[in] key Connection identity.
+     * @param[in] socket_wrapper Idle connected socket.
+     */
+    void Release(
+            const ConnectionPoolKey & key,
+            std::shared_ptr<SocketWrapper> socket_wrapper
+        );
+
+    /**
+     * @brief Close all idle connections.
+     */
+    void Clear();
+
+    /**
+     * @brief Close the idle connections of one io_service.
+     *
+     * @param[in] io_service The io_service of the connections.
+     */
+    void Clear(boost::asio::io_service * io_service);
+
+    void SetMaxIdlePerHost(std::size_t max_idle);
+    std::size_t GetMaxIdlePerHost() const;
+
+    void SetIdleTimeout(std::chrono::seconds idle_timeout);
+    std::chrono::seconds GetIdleTimeout() const;
+
+    ConnectionPoolStatistics GetStatistics() const;
+
+private:
+    ConnectionPool();
+
+    struct IdleConnection
+    {
+        std::shared_ptr<SocketWrapper> socket_wrapper;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+
+    void RemoveExpired(std::chrono::steady_clock::time_point now);
+
+    mutable mf::utils::mutex mutex_;
+
+    std::map<ConnectionPoolKey, std::deque<IdleConnection>> idle_;
+
+    std::size_t max_idle_per_host_;
+    std::chrono::seconds idle_timeout_;
+
+    ConnectionPoolStatistics statistics_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
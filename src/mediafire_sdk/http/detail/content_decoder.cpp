@@ -0,0 +1,134 @@
+/**
+ * @file content_decoder.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "content_decoder.hpp"
+
+#include <cassert>
+#include <utility>
+
+#include "mediafire_sdk/http/detail/encoding.hpp"
+#include "mediafire_sdk/http/detail/gzip_inflater.hpp"
+
+#if defined(HTTP_USE_BROTLI)
+#   include "mediafire_sdk/http/detail/brotli_decoder.hpp"
+#endif
+#if defined(HTTP_USE_ZSTD)
+#   include "mediafire_sdk/http/detail/zstd_decoder.hpp"
+#endif
+
+namespace {
+
+/** A piece of a pooled buffer holding output. */
+class OutputBuffer : public mf::http::BufferInterface
+{
+public:
+    OutputBuffer(mf::http::SharedBuffer::Pointer buffer, uint64_t size) :
+        buffer_(std::move(buffer)),
+        size_(size)
+    {}
+
+    virtual uint64_t Size() const override
+    {
+        return size_;
+    }
+
+    virtual const uint8_t * Data() const override
+    {
+        return buffer_->Data();
+    }
+
+private:
+    mf::http::SharedBuffer::Pointer buffer_;
+    uint64_t size_;
+};
+
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+DecoderOutput::DecoderOutput(SharedBufferPool::Pointer buffer_pool) :
+    buffer_pool_(std::move(buffer_pool)),
+    used_(0)
+{
+    assert(buffer_pool_);
+}
+
+uint8_t * DecoderOutput::Space()
+{
+    if ( ! buffer_ )
+    {
+        buffer_ = buffer_pool_->Acquire(buffer_pool_->BufferSize());
+        used_ = 0;
+    }
+
+    return buffer_->Data() + used_;
+}
+
+uint64_t DecoderOutput::Available() const
+{
+    return buffer_pool_->BufferSize() - used_;
+}
+
+void DecoderOutput::Produced(
+        uint64_t size,
+        const ContentDecoderInterface::OutputCallback & output
+    )
+{
+    assert( size <= Available() );
+
+    used_ += size;
+
+    if ( used_ == buffer_pool_->BufferSize() )
+        Flush(output);
+}
+
+void DecoderOutput::Flush(
+        const ContentDecoderInterface::OutputCallback & output
+    )
+{
+    if ( used_ == 0 )
+        return;
+
+    output(std::make_shared<OutputBuffer>(std::move(buffer_), used_));
+
+    buffer_.reset();
+    used_ = 0;
+}
+
+std::unique_ptr<ContentDecoderInterface> CreateContentDecoder(
+        int content_encoding,
+        SharedBufferPool::Pointer buffer_pool
+    )
+{
+    std::unique_ptr<ContentDecoderInterface> decoder;
+
+    // Only a single coding is decoded.
+    switch (content_encoding)
+    {
+        case CE_Gzip:
+            decoder.reset(new GzipInflater(std::move(buffer_pool)));
+            break;
+#if defined(HTTP_USE_BROTLI)
+        case CE_Brotli:
+            decoder.reset(new BrotliDecoder(std::move(buffer_pool)));
+            break;
+#endif
+#if defined(HTTP_USE_ZSTD)
+        case CE_Zstd:
+            decoder.reset(new ZstdDecoder(std::move(buffer_pool)));
+            break;
+#endif
+        default:
+            break;
+    }
+
+    return decoder;
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,133 @@
+/**
+ * @file content_decoder.hpp
+ * @author Herbert Jones
+ * @brief Decoders of compressed response content.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/http/buffer_interface.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+
+/**
+ * Content codings the library can decode, as sent in Accept-Encoding.  Brotli
+ * and zstd are only available when their libraries were found at build time.
+ */
+#if defined(HTTP_USE_ZSTD) && defined(HTTP_USE_BROTLI)
+#   define HTTP_ACCEPT_ENCODING "zstd, br, gzip"
+#elif defined(HTTP_USE_ZSTD)
+#   define HTTP_ACCEPT_ENCODING "zstd, gzip"
+#elif defined(HTTP_USE_BROTLI)
+#   define HTTP_ACCEPT_ENCODING "br, gzip"
+#else
+#   define HTTP_ACCEPT_ENCODING "gzip"
+#endif
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @interface ContentDecoderInterface
+ * @brief Decodes content piece by piece as it is read.
+ */
+class ContentDecoderInterface
+{
+public:
+    /** Receives decoded content. */
+    typedef std::function<
+        void(
+                std::shared_ptr<BufferInterface> buffer
+            )> OutputCallback;
+
+    virtual ~ContentDecoderInterface() {}
+
+    /**
+     * @brief Decode the next piece of the content.
+     *
+     * @param[in] data Start of the piece.
+     * @param[in] size Size of the piece.
+     * @param[in] output Called with each buffer of decoded content.
+     *
+     * @return False if the content is not valid.
+     */
+    virtual bool Decode(
+            const uint8_t * data,
+            uint64_t size,
+            const OutputCallback & output
+        ) = 0;
+
+    /**
+     * @brief Check that the content ended where the encoding says it should.
+     *
+     * @return False if the content was cut short.
+     */
+    virtual bool Finish() = 0;
+
+    /** Description of why decoding failed. */
+    virtual const std::string & ErrorString() const = 0;
+};
+
+/**
+ * @class DecoderOutput
+ * @brief Output buffers of a decoder.
+ *
+ * Decoded content is written into buffers from a SharedBufferPool which are
+ * passed on without copying, and reused once the receiver releases them.
+ */
+class DecoderOutput
+{
+public:
+    /**
+     * @brief CTOR
+     *
+     * @param[in] buffer_pool Pool of the output buffers.
+     */
+    explicit DecoderOutput(SharedBufferPool::Pointer buffer_pool);
+
+    /** Start of the unused part of the current buffer. */
+    uint8_t * Space();
+
+    /** Size of the unused part of the current buffer. */
+    uint64_t Available() const;
+
+    /**
+     * @brief Account for content written into Space().
+     *
+     * A buffer that became full is passed on at once.
+     */
+    void Produced(uint64_t size, const ContentDecoderInterface::OutputCallback
+        & output);
+
+    /** Pass on what is in the current buffer. */
+    void Flush(const ContentDecoderInterface::OutputCallback & output);
+
+private:
+    SharedBufferPool::Pointer buffer_pool_;
+
+    SharedBuffer::Pointer buffer_;
+    uint64_t used_;
+};
+
+/**
+ * @brief Create the decoder of a content coding.
+ *
+ * @param[in] content_encoding ContentEncoding flags of the content.
+ * @param[in] buffer_pool Pool of the output buffers.
+ *
+ * @return The decoder, or nullptr if the codings can not be decoded.
+ */
+std::unique_ptr<ContentDecoderInterface> CreateContentDecoder(
+        int content_encoding,
+        SharedBufferPool::Pointer buffer_pool
+    );
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
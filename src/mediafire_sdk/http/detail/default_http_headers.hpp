@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
+
 namespace mf {
 namespace http {
 
@@ -18,9 +20,9 @@ namespace http {
  */
 char const * const default_headers[][2] = {
     {"Accept", "*/*"},
-    {"Accept-Encoding", "gzip"},
+    {"Accept-Encoding", HTTP_ACCEPT_ENCODING},
     {"User-Agent", "HttpRequester"},
-    {"Connection", "close"},
+    {"Connection", "keep-alive"},
 };
 #endif
 
@@ -26,6 +26,8 @@ enum ContentEncoding
     CE_Unknown = (1<<0),
 
     CE_Gzip    = (1<<1),
+    CE_Brotli  = (1<<2),
+    CE_Zstd    = (1<<3),
 };
 
 }  // namespace detail
@@ -0,0 +1,124 @@
+/**
+ * @file gzip_inflater.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "gzip_inflater.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+#include "zlib.h"
+
+namespace {
+
+/** Largest window, accepting gzip and zlib headers. */
+const int kWindowBits = MAX_WBITS + 32;
+
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+struct GzipInflater::Stream
+{
+    z_stream z;
+};
+
+GzipInflater::GzipInflater(SharedBufferPool::Pointer buffer_pool) :
+    stream_(new Stream()),
+    output_(std::move(buffer_pool)),
+    stream_end_(false),
+    failed_(false)
+{
+    if ( inflateInit2(&stream_->z, kWindowBits) != Z_OK )
+    {
+        failed_ = true;
+        error_string_ = "Unable to initialize zlib.";
+    }
+}
+
+GzipInflater::~GzipInflater()
+{
+    inflateEnd(&stream_->z);
+}
+
+bool GzipInflater::Decode(
+        const uint8_t * data,
+        uint64_t size,
+        const OutputCallback & output
+    )
+{
+    z_stream & z = stream_->z;
+
+    while ( size > 0 && ! failed_ )
+    {
+        // Another gzip member follows the one that ended.
+        if ( stream_end_ )
+        {
+            inflateReset(&z);
+            stream_end_ = false;
+        }
+
+        const uInt piece = static_cast<uInt>(std::min<uint64_t>(size,
+            std::numeric_limits<uInt>::max()));
+
+        z.next_in = const_cast<Bytef*>(data);
+        z.avail_in = piece;
+
+        while ( z.avail_in > 0 )
+        {
+            uint8_t * const out = output_.Space();
+            z.next_out = out;
+            z.avail_out = static_cast<uInt>(output_.Available());
+
+            const int ret = inflate(&z, Z_NO_FLUSH);
+
+            output_.Produced(z.next_out - out, output);
+
+            if ( ret == Z_STREAM_END )
+            {
+                stream_end_ = true;
+                break;
+            }
+            else if ( ret != Z_OK
+                && ! (ret == Z_BUF_ERROR && z.avail_out == 0) )
+            {
+                std::stringstream ss;
+                ss << "Inflate failed. Zlib error: " << ret;
+                if ( z.msg )
+                    ss << " (" << z.msg << ")";
+                error_string_ = ss.str();
+                failed_ = true;
+                break;
+            }
+        }
+
+        const uint64_t used = piece - z.avail_in;
+        data += used;
+        size -= used;
+    }
+
+    // Pass on what the piece produced without waiting for more.
+    output_.Flush(output);
+
+    return ! failed_;
+}
+
+bool GzipInflater::Finish()
+{
+    if ( ! failed_ && ! stream_end_ )
+    {
+        failed_ = true;
+        error_string_ = "Content ended before the end of the gzip stream.";
+    }
+
+    return ! failed_;
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,71 @@
+/**
+ * @file gzip_inflater.hpp
+ * @author Herbert Jones
+ * @brief Incremental gzip decompression of response content.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class GzipInflater
+ * @brief Decompresses gzip content piece by piece as it is read.
+ *
+ * Output is passed on as soon as the input piece producing it is used up, so
+ * nothing but the zlib window and the buffers not yet released by the
+ * receiver is held.  zlib streams and concatenated gzip members are accepted
+ * too.
+ */
+class GzipInflater : public ContentDecoderInterface
+{
+public:
+    /**
+     * @brief CTOR
+     *
+     * @param[in] buffer_pool Pool of the output buffers.
+     */
+    explicit GzipInflater(SharedBufferPool::Pointer buffer_pool);
+
+    virtual ~GzipInflater();
+
+    virtual bool Decode(
+            const uint8_t * data,
+            uint64_t size,
+            const OutputCallback & output
+        ) override;
+
+    virtual bool Finish() override;
+
+    virtual const std::string & ErrorString() const override
+    {
+        return error_string_;
+    }
+
+private:
+    GzipInflater(const GzipInflater &) = delete;
+    GzipInflater & operator=(const GzipInflater &) = delete;
+
+    struct Stream;
+    std::unique_ptr<Stream> stream_;
+
+    DecoderOutput output_;
+
+    bool stream_end_;
+    bool failed_;
+    std::string error_string_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,814 @@
+/**
+ * @file http2_session.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "http2_session.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "boost/algorithm/string/case_conv.hpp"
+#include "boost/algorithm/string/predicate.hpp"
+
+#include "nghttp2/nghttp2.h"
+
+#include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/detail/types.hpp"
+#include "mediafire_sdk/utils/string.hpp"
+
+namespace asio = boost::asio;
+
+namespace {
+/** Content a stream may receive before its request passes any on. */
+const int32_t kStreamWindowSize = 1024 * 1024;
+
+/** Content all streams together may receive before any is read. */
+const int32_t kConnectionWindowSize = 16 * 1024 * 1024;
+
+/** Assumed until the server sends its settings. */
+const std::size_t kDefaultMaxConcurrentStreams = 100;
+
+/** Most frame data gathered into a single socket write. */
+const std::size_t kMaxWriteSize = 64 * 1024;
+
+const unsigned char kAlpnProtocols[] = "\x02h2\x08http/1.1";
+
+/** Headers that only apply to HTTP/1.1 connections. */
+bool IsConnectionHeader(const std::string & name)
+{
+    return name == "connection"
+        || name == "keep-alive"
+        || name == "proxy-connection"
+        || name == "transfer-encoding"
+        || name == "upgrade"
+        || name == "host"
+        || name == "te";
+}
+
+nghttp2_nv MakeNv(const std::string & name, const std::string & value)
+{
+    nghttp2_nv nv;
+    nv.name = reinterpret_cast<uint8_t*>(const_cast<char*>(name.data()));
+    nv.namelen = name.size();
+    nv.value = reinterpret_cast<uint8_t*>(const_cast<char*>(value.data()));
+    nv.valuelen = value.size();
+    nv.flags = NGHTTP2_NV_FLAG_NONE;
+    return nv;
+}
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+struct Http2Session::Stream
+{
+    Stream(
+            Http2StreamRequest request_,
+            std::shared_ptr<Http2StreamHandlerInterface> handler_
+        ) :
+        request(std::move(request_)),
+        handler(std::move(handler_)),
+        id(0),
+        status_code(0),
+        post_size(0),
+        post_sent(0),
+        chunk_pos(0),
+        cancelled(false),
+        ended(false)
+    {
+        if (request.post_data)
+            post_size = request.post_data->Size();
+        else if (request.post_interface)
+            post_size = request.post_interface->PostDataSize();
+    }
+
+    Http2StreamRequest request;
+
+    /** Reset once the stream is cancelled or has ended. */
+    std::shared_ptr<Http2StreamHandlerInterface> handler;
+
+    int32_t id;
+
+    // Response headers being received.
+    uint16_t status_code;
+    std::string raw_headers;
+
+    // POST data being sent.
+    uint64_t post_size;
+    uint64_t post_sent;
+    SharedBuffer::Pointer chunk;
+    uint64_t chunk_pos;
+
+    /** Set if sending the request failed on our side. */
+    std::error_code error_code;
+    std::string description;
+
+    bool cancelled;
+    bool ended;
+};
+
+class Http2Session::StreamHandle : public Http2StreamInterface
+{
+public:
+    StreamHandle(
+            std::weak_ptr<Http2Session> session,
+            StreamPointer stream
+        ) :
+        session_(std::move(session)),
+        stream_(std::move(stream))
+    {}
+
+    virtual void Cancel() override
+    {
+        if (auto session = session_.lock())
+        {
+            auto stream = stream_;
+            session->strand_.post(
+                [session, stream]()
+                {
+                    session->CancelStream(stream);
+                });
+        }
+    }
+
+    virtual void Consumed(std::size_t size) override
+    {
+        if (auto session = session_.lock())
+        {
+            auto stream = stream_;
+            session->strand_.post(
+                [session, stream, size]()
+                {
+                    session->ConsumeStream(stream, size);
+                });
+        }
+    }
+
+private:
+    std::weak_ptr<Http2Session> session_;
+    StreamPointer stream_;
+};
+
+struct Http2SessionCallbacks
+{
+    static int OnBeginHeaders(
+            nghttp2_session *,
+            const nghttp2_frame * frame,
+            void * user_data
+        )
+    {
+        auto self = static_cast<Http2Session*>(user_data);
+
+        auto it = self->streams_.find(frame->hd.stream_id);
+        if (it != self->streams_.end())
+        {
+            it->second->status_code = 0;
+            it->second->raw_headers.clear();
+        }
+
+        return 0;
+    }
+
+    static int OnHeader(
+            nghttp2_session *,
+            const nghttp2_frame * frame,
+            const uint8_t * name,
+            std::size_t namelen,
+            const uint8_t * value,
+            std::size_t valuelen,
+            uint8_t /* flags */,
+            void * user_data
+        )
+    {
+        auto self = static_cast<Http2Session*>(user_data);
+
+        if (frame->hd.type != NGHTTP2_HEADERS
+            || frame->headers.cat != NGHTTP2_HCAT_RESPONSE)
+            return 0;
+
+        auto it = self->streams_.find(frame->hd.stream_id);
+        if (it == self->streams_.end())
+            return 0;
+
+        auto & stream = *it->second;
+
+        if (namelen == 7 && std::memcmp(name, ":status", 7) == 0)
+        {
+            uint32_t code = 0;
+            for (std::size_t i = 0; i < valuelen; ++i)
+                code = code * 10 + static_cast<uint32_t>(value[i] - '0');
+            stream.status_code = static_cast<uint16_t>(code);
+        }
+        else if (namelen > 0 && name[0] != ':')
+        {
+            stream.raw_headers.append(reinterpret_cast<const char*>(name),
+                namelen);
+            stream.raw_headers += ": ";
+            stream.raw_headers.append(reinterpret_cast<const char*>(value),
+                valuelen);
+            stream.raw_headers += "\r\n";
+        }
+
+        return 0;
+    }
+
+    static int OnFrameReceived(
+            nghttp2_session * session,
+            const nghttp2_frame * frame,
+            void * user_data
+        )
+    {
+        auto self = static_cast<Http2Session*>(user_data);
+
+        switch (frame->hd.type)
+        {
+            case NGHTTP2_SETTINGS:
+                self->max_concurrent_streams_ =
+                    nghttp2_session_get_remote_settings(session,
+                        NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS);
+                break;
+            case NGHTTP2_GOAWAY:
+                // Streams the server will not process are closed by nghttp2.
+                self->usable_ = false;
+                break;
+            case NGHTTP2_HEADERS:
+            {
+                // Informational responses are followed by the real one, and
+                // trailers are not passed on.
+                auto it = self->streams_.find(frame->hd.stream_id);
+                if (frame->headers.cat != NGHTTP2_HCAT_RESPONSE
+                    || it == self->streams_.end())
+                    break;
+
+                auto & stream = *it->second;
+                if (stream.status_code >= 100 && stream.status_code < 200)
+                    break;
+
+                mf::http::Headers headers;
+                const std::string raw = "HTTP/2 "
+                    + mf::utils::to_string(stream.status_code) + "\r\n"
+                    + stream.raw_headers + "\r\n";
+                headers.Parse(raw, nullptr);
+
+                if (stream.handler)
+                    stream.handler->Http2HeadersReceived(std::move(headers));
+                break;
+            }
+            default:
+                break;
+        }
+
+        return 0;
+    }
+
+    static int OnDataChunkReceived(
+            nghttp2_session * session,
+            uint8_t /* flags */,
+            int32_t stream_id,
+            const uint8_t * data,
+            std::size_t len,
+            void * user_data
+        )
+    {
+        auto self = static_cast<Http2Session*>(user_data);
+
+        // The connection window is always opened again, so only the streams
+        // whose requests are slow to read are held back.
+        nghttp2_session_consume_connection(session, len);
+
+        auto it = self->streams_.find(stream_id);
+        if (it != self->streams_.end() && it->second->handler)
+            it->second->handler->Http2DataReceived(data, len);
+        else
+            nghttp2_session_consume_stream(session, stream_id, len);
+
+        return 0;
+    }
+
+    static int OnStreamClose(
+            nghttp2_session *,
+            int32_t stream_id,
+            uint32_t error_code,
+            void * user_data
+        )
+    {
+        auto self = static_cast<Http2Session*>(user_data);
+
+        auto it = self->streams_.find(stream_id);
+        if (it == self->streams_.end())
+            return 0;
+
+        auto stream = it->second;
+        self->streams_.erase(it);
+
+        if (stream->error_code)
+        {
+            self->CloseStream(stream, stream->error_code, stream->description);
+        }
+        else if (error_code != NGHTTP2_NO_ERROR)
+        {
+            std::string description = "HTTP/2 stream reset: ";
+            description += nghttp2_http2_strerror(error_code);
+            self->CloseStream(stream,
+                make_error_code(mf::http::http_error::ReadFailure),
+                description);
+        }
+        else
+        {
+            self->CloseStream(stream, std::error_code(), std::string());
+        }
+
+        return 0;
+    }
+
+    static ssize_t ReadPostData(
+            nghttp2_session *,
+            int32_t /* stream_id */,
+            uint8_t * buf,
+            std::size_t length,
+            uint32_t * data_flags,
+            nghttp2_data_source * source,
+            void *
+        )
+    {
+        auto & stream = *static_cast<Http2Session::Stream*>(source->ptr);
+
+        std::size_t copied = 0;
+
+        if (stream.request.post_data)
+        {
+            copied = std::min<uint64_t>(length,
+                stream.post_size - stream.post_sent);
+            std::memcpy(buf, stream.request.post_data->Data()
+                + stream.post_sent, copied);
+        }
+        else if (stream.post_sent < stream.post_size)
+        {
+            if ( ! stream.chunk || stream.chunk_pos == stream.chunk->Size() )
+            {
+                stream.chunk = stream.request.post_interface
+                    ->RetreivePostDataChunk();
+                stream.chunk_pos = 0;
+
+                if ( ! stream.chunk || stream.chunk->Size() == 0 )
+                {
+                    stream.error_code = make_error_code(
+                        mf::http::http_error::PostInterfaceReadFailure);
+                    stream.description = "Failed to read POST data.";
+                    return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+                }
+            }
+
+            copied = std::min<uint64_t>({
+                static_cast<uint64_t>(length),
+                stream.chunk->Size() - stream.chunk_pos,
+                stream.post_size - stream.post_sent});
+            std::memcpy(buf, stream.chunk->Data() + stream.chunk_pos, copied);
+            stream.chunk_pos += copied;
+        }
+
+        stream.post_sent += copied;
+
+        if (stream.post_sent == stream.post_size)
+        {
+            stream.chunk.reset();
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+        }
+
+        return static_cast<ssize_t>(copied);
+    }
+};
+
+Http2Session::Pointer Http2Session::Create(
+        std::shared_ptr<SocketWrapper> socket_wrapper
+    )
+{
+    std::shared_ptr<Http2Session> session(
+        new Http2Session(std::move(socket_wrapper)));
+
+    session->strand_.post(
+        [session]()
+        {
+            session->Start();
+        });
+
+    return session;
+}
+
+Http2Session::Http2Session(
+        std::shared_ptr<SocketWrapper> socket_wrapper
+    ) :
+    strand_(socket_wrapper->get_io_service()),
+    socket_wrapper_(std::move(socket_wrapper)),
+    session_(nullptr),
+    reading_(false),
+    writing_(false),
+    read_cancelled_(false),
+    closed_(false),
+    usable_(true),
+    active_streams_(0),
+    max_concurrent_streams_(kDefaultMaxConcurrentStreams),
+    idle_since_(sclock::now().time_since_epoch().count())
+{
+    nghttp2_session_callbacks * callbacks = nullptr;
+    nghttp2_session_callbacks_new(&callbacks);
+
+    nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks,
+        &Http2SessionCallbacks::OnBeginHeaders);
+    nghttp2_session_callbacks_set_on_header_callback(callbacks,
+        &Http2SessionCallbacks::OnHeader);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+        &Http2SessionCallbacks::OnFrameReceived);
+    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks,
+        &Http2SessionCallbacks::OnDataChunkReceived);
+    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks,
+        &Http2SessionCallbacks::OnStreamClose);
+
+    // Windows are opened as content is passed on rather than as received.
+    nghttp2_option * option = nullptr;
+    nghttp2_option_new(&option);
+    nghttp2_option_set_no_auto_window_update(option, 1);
+
+    nghttp2_session_client_new2(&session_, callbacks, this, option);
+
+    nghttp2_option_del(option);
+    nghttp2_session_callbacks_del(callbacks);
+}
+
+Http2Session::~Http2Session()
+{
+    nghttp2_session_del(session_);
+}
+
+bool Http2Session::Negotiated(SocketWrapper * socket_wrapper)
+{
+    const unsigned char * protocol = nullptr;
+    unsigned int length = 0;
+
+    SSL_get0_alpn_selected(socket_wrapper->SslSocket()->native_handle(),
+        &protocol, &length);
+
+    return length == 2 && std::memcmp(protocol, "h2", 2) == 0;
+}
+
+void Http2Session::OfferProtocols(SocketWrapper * socket_wrapper)
+{
+    SSL_set_alpn_protos(socket_wrapper->SslSocket()->native_handle(),
+        kAlpnProtocols, sizeof(kAlpnProtocols) - 1);
+}
+
+bool Http2Session::Usable() const
+{
+    return usable_;
+}
+
+std::size_t Http2Session::ActiveStreams() const
+{
+    return active_streams_;
+}
+
+bool Http2Session::HasCapacity() const
+{
+    return active_streams_ < max_concurrent_streams_;
+}
+
+std::chrono::steady_clock::time_point Http2Session::IdleSince() const
+{
+    return TimePoint(sclock::duration(idle_since_));
+}
+
+Http2StreamInterface::Pointer Http2Session::StartStream(
+        Http2StreamRequest request,
+        std::shared_ptr<Http2StreamHandlerInterface> handler
+    )
+{
+    auto stream = std::make_shared<Stream>(std::move(request),
+        std::move(handler));
+
+    ++active_streams_;
+
+    auto self = shared_from_this();
+    strand_.post(
+        [self, stream]()
+        {
+            self->Submit(stream);
+        });
+
+    return std::make_shared<StreamHandle>(self, stream);
+}
+
+void Http2Session::Close()
+{
+    auto self = shared_from_this();
+    strand_.post(
+        [self]()
+        {
+            self->Fail(make_error_code(mf::http::http_error::ReadFailure),
+                "HTTP/2 connection closed.");
+        });
+}
+
+void Http2Session::Start()
+{
+    nghttp2_settings_entry settings[] = {
+        {NGHTTP2_SETTINGS_ENABLE_PUSH, 0},
+        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+            static_cast<uint32_t>(kDefaultMaxConcurrentStreams)},
+        {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE,
+            static_cast<uint32_t>(kStreamWindowSize)},
+    };
+
+    nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, settings,
+        sizeof(settings) / sizeof(settings[0]));
+
+    nghttp2_session_set_local_window_size(session_, NGHTTP2_FLAG_NONE, 0,
+        kConnectionWindowSize);
+
+    Flush();
+}
+
+void Http2Session::Submit(StreamPointer stream)
+{
+    if (stream->cancelled)
+    {
+        StreamEnded();
+        return;
+    }
+
+    if (closed_)
+    {
+        CloseStream(stream, make_error_code(mf::http::http_error::ReadFailure),
+            "HTTP/2 connection closed.");
+        return;
+    }
+
+    const auto & request = stream->request;
+
+    std::vector<std::pair<std::string, std::string>> headers;
+    headers.reserve(request.headers.size());
+    for (const auto & pair : request.headers)
+    {
+        std::string name = boost::algorithm::to_lower_copy(pair.first);
+        if ( ! IsConnectionHeader(name) )
+            headers.emplace_back(std::move(name), pair.second);
+    }
+
+    const std::string method_name(":method");
+    const std::string scheme_name(":scheme");
+    const std::string authority_name(":authority");
+    const std::string path_name(":path");
+
+    std::vector<nghttp2_nv> nva;
+    nva.reserve(headers.size() + 4);
+    nva.push_back(MakeNv(method_name, request.method));
+    nva.push_back(MakeNv(scheme_name, request.scheme));
+    nva.push_back(MakeNv(authority_name, request.authority));
+    nva.push_back(MakeNv(path_name, request.path));
+    for (const auto & pair : headers)
+        nva.push_back(MakeNv(pair.first, pair.second));
+
+    nghttp2_data_provider post_provider;
+    post_provider.source.ptr = stream.get();
+    post_provider.read_callback = &Http2SessionCallbacks::ReadPostData;
+
+    const bool has_post = request.post_data || request.post_interface;
+
+    const int32_t stream_id = nghttp2_submit_request(session_, nullptr,
+        nva.data(), nva.size(), has_post ? &post_provider : nullptr, nullptr);
+
+    if (stream_id < 0)
+    {
+        std::string description = "Unable to start HTTP/2 request: ";
+        description += nghttp2_strerror(stream_id);
+        CloseStream(stream, make_error_code(mf::http::http_error::WriteFailure),
+            description);
+        return;
+    }
+
+    stream->id = stream_id;
+    streams_[stream_id] = stream;
+
+    Flush();
+    UpdateReading();
+}
+
+void Http2Session::CancelStream(StreamPointer stream)
+{
+    stream->cancelled = true;
+    stream->handler.reset();
+
+    if (stream->id != 0 && ! stream->ended && ! closed_)
+    {
+        nghttp2_submit_rst_stream(session_, NGHTTP2_FLAG_NONE, stream->id,
+            NGHTTP2_CANCEL);
+        Flush();
+    }
+}
+
+void Http2Session::ConsumeStream(StreamPointer stream, std::size_t size)
+{
+    if (stream->ended || closed_)
+        return;
+
+    nghttp2_session_consume_stream(session_, stream->id, size);
+    Flush();
+}
+
+void Http2Session::Flush()
+{
+    if (writing_ || closed_)
+        return;
+
+    write_buffer_.clear();
+
+    while (write_buffer_.size() < kMaxWriteSize)
+    {
+        const uint8_t * data = nullptr;
+        const ssize_t size = nghttp2_session_mem_send(session_, &data);
+
+        if (size < 0)
+        {
+            Fail(make_error_code(mf::http::http_error::WriteFailure),
+                std::string("HTTP/2 framing failure: ")
+                + nghttp2_strerror(static_cast<int>(size)));
+            return;
+        }
+        else if (size == 0)
+        {
+            break;
+        }
+
+        write_buffer_.append(reinterpret_cast<const char*>(data), size);
+    }
+
+    if (write_buffer_.empty())
+        return;
+
+    writing_ = true;
+
+    auto self = shared_from_this();
+    asio::async_write(*socket_wrapper_, asio::buffer(write_buffer_),
+        strand_.wrap(
+            [self](const boost::system::error_code & ec, std::size_t bytes)
+            {
+                self->HandleWrite(ec, bytes);
+            }));
+}
+
+void Http2Session::UpdateReading()
+{
+    if (closed_)
+        return;
+
+    if ( ! streams_.empty() )
+    {
+        if ( ! reading_ )
+        {
+            reading_ = true;
+
+            auto self = shared_from_this();
+            socket_wrapper_->async_read_some(asio::buffer(read_buffer_),
+                strand_.wrap(
+                    [self](const boost::system::error_code & ec,
+                        std::size_t bytes)
+                    {
+                        self->HandleRead(ec, bytes);
+                    }));
+        }
+    }
+    else if (reading_ && ! read_cancelled_ && ! writing_)
+    {
+        // Cancelling would also abort a write, so this waits for writes to
+        // finish.
+        read_cancelled_ = true;
+        socket_wrapper_->Cancel();
+    }
+}
+
+void Http2Session::HandleRead(
+        const boost::system::error_code & err,
+        std::size_t bytes_transferred
+    )
+{
+    reading_ = false;
+
+    if (closed_)
+        return;
+
+    if (err == asio::error::operation_aborted && read_cancelled_)
+    {
+        read_cancelled_ = false;
+        UpdateReading();
+        return;
+    }
+
+    read_cancelled_ = false;
+
+    if (err)
+    {
+        Fail(make_error_code(mf::http::http_error::ReadFailure),
+            "HTTP/2 connection read failure: " + err.message());
+        return;
+    }
+
+    const ssize_t processed = nghttp2_session_mem_recv(session_,
+        read_buffer_.data(), bytes_transferred);
+
+    if (processed < 0)
+    {
+        Fail(make_error_code(mf::http::http_error::ReadFailure),
+            std::string("HTTP/2 protocol failure: ")
+            + nghttp2_strerror(static_cast<int>(processed)));
+        return;
+    }
+
+    Flush();
+
+    if ( ! closed_ && ! nghttp2_session_want_read(session_)
+        && ! nghttp2_session_want_write(session_) )
+    {
+        Fail(make_error_code(mf::http::http_error::ReadFailure),
+            "HTTP/2 connection closed by server.");
+        return;
+    }
+
+    UpdateReading();
+}
+
+void Http2Session::HandleWrite(
+        const boost::system::error_code & err,
+        std::size_t /* bytes_transferred */
+    )
+{
+    writing_ = false;
+
+    if (closed_)
+        return;
+
+    if (err)
+    {
+        Fail(make_error_code(mf::http::http_error::WriteFailure),
+            "HTTP/2 connection write failure: " + err.message());
+        return;
+    }
+
+    Flush();
+    UpdateReading();
+}
+
+void Http2Session::Fail(std::error_code error_code, std::string description)
+{
+    if (closed_)
+        return;
+
+    closed_ = true;
+    usable_ = false;
+
+    std::map<int32_t, StreamPointer> streams;
+    std::swap(streams, streams_);
+
+    for (auto & pair : streams)
+        CloseStream(pair.second, error_code, description);
+
+    boost::system::error_code ec;
+    socket_wrapper_->LowestLayer().close(ec);
+}
+
+void Http2Session::CloseStream(
+        StreamPointer stream,
+        std::error_code error_code,
+        std::string description
+    )
+{
+    if (stream->ended)
+        return;
+
+    stream->ended = true;
+
+    if ( ! error_code && stream->status_code == 0 )
+    {
+        error_code = make_error_code(mf::http::http_error::ReadFailure);
+        description = "HTTP/2 stream closed without a response.";
+    }
+
+    if (auto handler = std::move(stream->handler))
+        handler->Http2StreamClosed(error_code, std::move(description));
+
+    StreamEnded();
+}
+
+void Http2Session::StreamEnded()
+{
+    assert(active_streams_ > 0);
+
+    if (--active_streams_ == 0)
+        idle_since_ = sclock::now().time_since_epoch().count();
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
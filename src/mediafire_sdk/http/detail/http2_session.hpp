@@ -0,0 +1,149 @@
+/**
+ * @file http2_session.hpp
+ * @author Herbert Jones
+ * @brief HTTP/2 connection using nghttp2.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+
+#include "mediafire_sdk/http/detail/http2_session_pool.hpp"
+#include "mediafire_sdk/http/detail/socket_wrapper.hpp"
+
+// Forward declarations
+struct nghttp2_session;
+// END forward declarations
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class Http2Session
+ * @brief Multiplexes requests over a TLS connection that negotiated "h2".
+ *
+ * Each stream has its own receive window, which is only opened again as its
+ * request passes the received content on, so a slow request does not hold up
+ * the others on the connection.  The socket is only read while requests are
+ * in progress, so an idle connection does not keep the io_service running.
+ */
+class Http2Session :
+    public Http2ConnectionInterface,
+    public std::enable_shared_from_this<Http2Session>
+{
+public:
+    using Pointer = std::shared_ptr<Http2Session>;
+
+    /**
+     * @brief Create the session and send the connection preface.
+     *
+     * @param[in] socket_wrapper SSL socket that completed the handshake.
+     *
+     * @return The session.
+     */
+    static Pointer Create(std::shared_ptr<SocketWrapper> socket_wrapper);
+
+    virtual ~Http2Session();
+
+    /**
+     * @brief Check if the handshake negotiated HTTP/2.
+     *
+     * @param[in] socket_wrapper SSL socket that completed the handshake.
+     */
+    static bool Negotiated(SocketWrapper * socket_wrapper);
+
+    /**
+     * @brief Offer HTTP/2 and HTTP/1.1 in the handshake.
+     *
+     * @param[in] socket_wrapper SSL socket before the handshake.
+     */
+    static void OfferProtocols(SocketWrapper * socket_wrapper);
+
+    // -- Http2ConnectionInterface ---------------------------------------------
+    virtual bool Usable() const override;
+    virtual std::size_t ActiveStreams() const override;
+    virtual bool HasCapacity() const override;
+    virtual std::chrono::steady_clock::time_point IdleSince() const override;
+    virtual Http2StreamInterface::Pointer StartStream(
+            Http2StreamRequest request,
+            std::shared_ptr<Http2StreamHandlerInterface> handler
+        ) override;
+    virtual void Close() override;
+    // -- END Http2ConnectionInterface -----------------------------------------
+
+private:
+    struct Stream;
+    class StreamHandle;
+    using StreamPointer = std::shared_ptr<Stream>;
+
+    explicit Http2Session(std::shared_ptr<SocketWrapper> socket_wrapper);
+
+    void Start();
+    void Submit(StreamPointer stream);
+    void CancelStream(StreamPointer stream);
+    void ConsumeStream(StreamPointer stream, std::size_t size);
+
+    /** Write the frames nghttp2 has queued. */
+    void Flush();
+
+    /** Read while requests are in progress, and only then. */
+    void UpdateReading();
+
+    void HandleRead(
+            const boost::system::error_code & err,
+            std::size_t bytes_transferred
+        );
+    void HandleWrite(
+            const boost::system::error_code & err,
+            std::size_t bytes_transferred
+        );
+
+    /** Close the connection, failing all streams. */
+    void Fail(std::error_code error_code, std::string description);
+
+    void CloseStream(
+            StreamPointer stream,
+            std::error_code error_code,
+            std::string description
+        );
+    void StreamEnded();
+
+    // Passed to nghttp2, which calls back with the session.
+    friend struct Http2SessionCallbacks;
+
+    boost::asio::io_service::strand strand_;
+
+    std::shared_ptr<SocketWrapper> socket_wrapper_;
+
+    nghttp2_session * session_;
+
+    std::map<int32_t, StreamPointer> streams_;
+
+    bool reading_;
+    bool writing_;
+    bool read_cancelled_;
+    bool closed_;
+
+    std::array<uint8_t, 16 * 1024> read_buffer_;
+    std::string write_buffer_;
+
+    // Read by the pool from other threads.
+    std::atomic<bool> usable_;
+    std::atomic<std::size_t> active_streams_;
+    std::atomic<std::size_t> max_concurrent_streams_;
+    std::atomic<std::chrono::steady_clock::rep> idle_since_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
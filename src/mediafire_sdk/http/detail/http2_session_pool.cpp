@@ -0,0 +1,226 @@
+/**
+ * @file http2_session_pool.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "http2_session_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "mediafire_sdk/http/detail/types.hpp"
+
+namespace {
+const std::size_t kDefaultMaxConnectionsPerHost = 1;
+const std::chrono::seconds kDefaultIdleTimeout(60);
+
+/** How long a host that did not offer HTTP/2 is not asked again. */
+const std::chrono::minutes kHttp1OnlyTimeout(5);
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+Http2SessionPool::Pointer Http2SessionPool::Create()
+{
+    return std::shared_ptr<Http2SessionPool>(new Http2SessionPool);
+}
+
+Http2SessionPool::Http2SessionPool() :
+    max_connections_per_host_(kDefaultMaxConnectionsPerHost),
+    idle_timeout_(kDefaultIdleTimeout),
+    statistics_{0, 0}
+{
+}
+
+Http2ConnectionInterface::Pointer Http2SessionPool::Acquire(
+        const ConnectionPoolKey & key
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    RemoveUnusable(sclock::now());
+
+    auto it = hosts_.find(key);
+    if (it == hosts_.end() || it->second.connections.empty())
+        return nullptr;
+
+    const auto & connections = it->second.connections;
+
+    auto least_busy = std::min_element(connections.begin(), connections.end(),
+        [](const Http2ConnectionInterface::Pointer & lhs,
+            const Http2ConnectionInterface::Pointer & rhs)
+        {
+            return lhs->ActiveStreams() < rhs->ActiveStreams();
+        });
+
+    // Open another connection if all are full and the limit allows it.
+    // Otherwise the request waits on the connection for a free stream.
+    if ( ! (*least_busy)->HasCapacity()
+        && connections.size() < max_connections_per_host_ )
+    {
+        return nullptr;
+    }
+
+    ++statistics_.streams_multiplexed;
+
+    return *least_busy;
+}
+
+bool Http2SessionPool::Http1Only(const ConnectionPoolKey & key)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto it = hosts_.find(key);
+    return it != hosts_.end() && sclock::now() < it->second.http1_only_until;
+}
+
+bool Http2SessionPool::BeginConnect(
+        const ConnectionPoolKey & key,
+        Waiter waiter
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto & host = hosts_[key];
+
+    if (host.connecting)
+    {
+        host.waiters.push_back(std::move(waiter));
+        return false;
+    }
+
+    host.connecting = true;
+    return true;
+}
+
+void Http2SessionPool::EndConnect(
+        const ConnectionPoolKey & key,
+        Http2ConnectionInterface::Pointer connection,
+        bool http1_only
+    )
+{
+    std::vector<Waiter> waiters;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        auto & host = hosts_[key];
+        assert(host.connecting);
+
+        host.connecting = false;
+        std::swap(waiters, host.waiters);
+
+        if (connection)
+        {
+            ++statistics_.sessions_opened;
+            host.connections.push_back(std::move(connection));
+        }
+
+        if (http1_only)
+            host.http1_only_until = sclock::now() + kHttp1OnlyTimeout;
+    }
+
+    // Unlocked, as waiters acquire connections.
+    for (auto & waiter : waiters)
+        waiter();
+}
+
+void Http2SessionPool::Clear()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    for (auto & pair : hosts_)
+    {
+        auto & connections = pair.second.connections;
+        for (auto it = connections.begin(); it != connections.end(); )
+        {
+            if ((*it)->ActiveStreams() == 0)
+            {
+                (*it)->Close();
+                it = connections.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        pair.second.http1_only_until = TimePoint();
+    }
+}
+
+void Http2SessionPool::SetMaxConnectionsPerHost(std::size_t max_connections)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    max_connections_per_host_ = std::max<std::size_t>(1, max_connections);
+}
+
+std::size_t Http2SessionPool::GetMaxConnectionsPerHost() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return max_connections_per_host_;
+}
+
+void Http2SessionPool::SetIdleTimeout(std::chrono::seconds idle_timeout)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    idle_timeout_ = idle_timeout;
+}
+
+std::chrono::seconds Http2SessionPool::GetIdleTimeout() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return idle_timeout_;
+}
+
+Http2SessionPoolStatistics Http2SessionPool::GetStatistics() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return statistics_;
+}
+
+void Http2SessionPool::RemoveUnusable(TimePoint now)
+{
+    for (auto it = hosts_.begin(); it != hosts_.end(); )
+    {
+        auto & host = it->second;
+        auto & connections = host.connections;
+
+        for (auto conn = connections.begin(); conn != connections.end(); )
+        {
+            const bool expired = (*conn)->ActiveStreams() == 0
+                && (*conn)->IdleSince() + idle_timeout_ <= now;
+
+            if ( ! (*conn)->Usable() || expired )
+            {
+                (*conn)->Close();
+                conn = connections.erase(conn);
+            }
+            else
+            {
+                ++conn;
+            }
+        }
+
+        if (connections.empty() && ! host.connecting
+            && host.http1_only_until <= now)
+        {
+            it = hosts_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
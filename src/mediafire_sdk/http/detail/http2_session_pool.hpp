@@ -0,0 +1,282 @@
+/**
+ * @file http2_session_pool.hpp
+ * @author Herbert Jones
+ * @brief Pool of HTTP/2 connections shared by concurrent requests.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "mediafire_sdk/http/detail/connection_pool.hpp"
+#include "mediafire_sdk/http/headers.hpp"
+#include "mediafire_sdk/http/post_data_pipe_interface.hpp"
+#include "mediafire_sdk/http/shared_buffer.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @struct Http2SessionPoolStatistics
+ * @brief Counters describing HTTP/2 connection sharing.
+ */
+struct Http2SessionPoolStatistics
+{
+    /** HTTP/2 connections opened. */
+    uint64_t sessions_opened;
+
+    /** Requests that were sent over an already open HTTP/2 connection. */
+    uint64_t streams_multiplexed;
+};
+
+namespace detail {
+
+/**
+ * @struct Http2StreamRequest
+ * @brief What is sent on a new stream.
+ */
+struct Http2StreamRequest
+{
+    std::string method;
+    std::string scheme;
+
+    /** Host, and port if not the default. */
+    std::string authority;
+
+    /** Path and query. */
+    std::string path;
+
+    /** Request headers.  Headers specific to HTTP/1.1 are left out. */
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    /** POST data, or null. */
+    SharedBuffer::Pointer post_data;
+
+    /** Source of POST data, or null. */
+    std::shared_ptr<PostDataPipeInterface> post_interface;
+};
+
+/**
+ * @class Http2StreamHandlerInterface
+ * @brief Receives the response of a stream.
+ *
+ * Called on the strand of the connection, so implementations should hand the
+ * work off rather than block.
+ */
+class Http2StreamHandlerInterface
+{
+public:
+    virtual ~Http2StreamHandlerInterface() {}
+
+    /**
+     * @brief The response headers were received.
+     *
+     * @param[in] headers Status line and headers, in HTTP/1.1 form.
+     */
+    virtual void Http2HeadersReceived(mf::http::Headers headers) = 0;
+
+    /**
+     * @brief Response content was received.
+     *
+     * The data is only valid during the call.  The stream window is not
+     * opened again until Http2StreamInterface::Consumed is called for it.
+     */
+    virtual void Http2DataReceived(const uint8_t * data, std::size_t size) = 0;
+
+    /**
+     * @brief The stream ended.
+     *
+     * @param[in] error_code Set if the response was not fully received.
+     * @param[in] description Why the stream failed.
+     */
+    virtual void Http2StreamClosed(
+            std::error_code error_code,
+            std::string description
+        ) = 0;
+};
+
+/**
+ * @class Http2StreamInterface
+ * @brief A request in progress on an HTTP/2 connection.
+ */
+class Http2StreamInterface
+{
+public:
+    using Pointer = std::shared_ptr<Http2StreamInterface>;
+
+    virtual ~Http2StreamInterface() {}
+
+    /**
+     * @brief Abandon the request.
+     *
+     * The handler is not called again.
+     */
+    virtual void Cancel() = 0;
+
+    /**
+     * @brief Let the server send more content on the stream.
+     *
+     * @param[in] size Bytes of received content that have been passed on.
+     */
+    virtual void Consumed(std::size_t size) = 0;
+};
+
+/**
+ * @class Http2ConnectionInterface
+ * @brief An HTTP/2 connection requests can be multiplexed over.
+ *
+ * May be called from any thread.
+ */
+class Http2ConnectionInterface
+{
+public:
+    using Pointer = std::shared_ptr<Http2ConnectionInterface>;
+
+    virtual ~Http2ConnectionInterface() {}
+
+    /** False once the connection failed or the server is going away. */
+    virtual bool Usable() const = 0;
+
+    /** Number of requests in progress. */
+    virtual std::size_t ActiveStreams() const = 0;
+
+    /** True if the server permits another concurrent request. */
+    virtual bool HasCapacity() const = 0;
+
+    /** When the last request ended. */
+    virtual std::chrono::steady_clock::time_point IdleSince() const = 0;
+
+    /**
+     * @brief Send a request.
+     *
+     * @param[in] request What to send.
+     * @param[in] handler Receives the response.
+     *
+     * @return Handle of the stream.
+     */
+    virtual Http2StreamInterface::Pointer StartStream(
+            Http2StreamRequest request,
+            std::shared_ptr<Http2StreamHandlerInterface> handler
+        ) = 0;
+
+    /** Close the connection, failing requests in progress. */
+    virtual void Close() = 0;
+};
+
+/**
+ * @class Http2SessionPool
+ * @brief Keeps HTTP/2 connections so concurrent requests to a host share them.
+ *
+ * Only one connection to a host is opened at a time.  Requests arriving while
+ * it is being opened wait for it, and hosts that turn out not to speak
+ * HTTP/2 are remembered so their requests use HTTP/1.1 straight away.
+ * Connections that are idle too long are removed lazily when the pool is
+ * accessed.
+ */
+class Http2SessionPool
+{
+public:
+    using Pointer = std::shared_ptr<Http2SessionPool>;
+
+    /** Called once a connection attempt that was waited on ended. */
+    using Waiter = std::function<void()>;
+
+    static Pointer Create();
+
+    /**
+     * @brief Get a connection to send a request over.
+     *
+     * @param[in] key Connection identity.
+     *
+     * @return The least busy connection, or nullptr if none is open or all
+     *         are busy and another may be opened.
+     */
+    Http2ConnectionInterface::Pointer Acquire(const ConnectionPoolKey & key);
+
+    /**
+     * @brief Check if the host is known to only speak HTTP/1.1.
+     *
+     * @param[in] key Connection identity.
+     */
+    bool Http1Only(const ConnectionPoolKey & key);
+
+    /**
+     * @brief Claim opening the next connection to a host.
+     *
+     * @param[in] key Connection identity.
+     * @param[in] waiter Called when the connection being opened is ready or
+     *                   failed, if one is already being opened.
+     *
+     * @return True if the caller should open the connection, and must call
+     *         EndConnect.  False if the waiter was queued.
+     */
+    bool BeginConnect(const ConnectionPoolKey & key, Waiter waiter);
+
+    /**
+     * @brief Finish opening a connection, waking those waiting for it.
+     *
+     * @param[in] key Connection identity.
+     * @param[in] connection The new connection, or nullptr if none was made.
+     * @param[in] http1_only True if the server did not offer HTTP/2.
+     */
+    void EndConnect(
+            const ConnectionPoolKey & key,
+            Http2ConnectionInterface::Pointer connection,
+            bool http1_only
+        );
+
+    /**
+     * @brief Close all connections that have no requests in progress.
+     *
+     * Also forgets which hosts only speak HTTP/1.1.
+     */
+    void Clear();
+
+    void SetMaxConnectionsPerHost(std::size_t max_connections);
+    std::size_t GetMaxConnectionsPerHost() const;
+
+    void SetIdleTimeout(std::chrono::seconds idle_timeout);
+    std::chrono::seconds GetIdleTimeout() const;
+
+    Http2SessionPoolStatistics GetStatistics() const;
+
+private:
+    Http2SessionPool();
+
+    struct Host
+    {
+        Host() : connecting(false) {}
+
+        std::vector<Http2ConnectionInterface::Pointer> connections;
+
+        bool connecting;
+        std::vector<Waiter> waiters;
+
+        /** Set while the host is known to not speak HTTP/2. */
+        std::chrono::steady_clock::time_point http1_only_until;
+    };
+
+    void RemoveUnusable(std::chrono::steady_clock::time_point now);
+
+    mutable mf::utils::mutex mutex_;
+
+    std::map<ConnectionPoolKey, Host> hosts_;
+
+    std::size_t max_connections_per_host_;
+    std::chrono::seconds idle_timeout_;
+
+    Http2SessionPoolStatistics statistics_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -7,12 +7,13 @@
  */
 #pragma once
 
-#include <map>
 #include <string>
+#include <system_error>
 
 #include "boost/asio.hpp"
 #include "boost/variant/variant.hpp"
 
+#include "../headers.hpp"
 #include "../shared_buffer.hpp"
 #include "types.hpp"
 
@@ -48,6 +49,10 @@ struct ConfigEvent
     {
         uint32_t timeout_seconds;
     };
+    struct ConfigBandwidthWeight
+    {
+        uint32_t weight;
+    };
 
     typedef boost::variant<
         ConfigRedirectPolicy,
@@ -55,7 +60,8 @@ struct ConfigEvent
         ConfigHeader,
         ConfigPostDataPipe,
         ConfigPostData,
-        ConfigTimeout
+        ConfigTimeout,
+        ConfigBandwidthWeight
             > ConfigVariant;
 
     ConfigVariant variant;
@@ -72,6 +78,7 @@ struct ErrorEvent
 // Internal events
 struct RestartEvent {};
 struct InitializedEvent {};
+struct ReusedConnectionEvent {};
 struct ResolvedEvent
 {
     boost::asio::ip::tcp::resolver::iterator endpoint_iterator;
@@ -82,21 +89,14 @@ struct HeadersWrittenEvent {};
 struct PostSent {};
 struct HeadersReadEvent
 {
-    HeadersReadEvent() : status_code(0), content_length(0) {}
-
-    std::string raw_headers;
+    HeadersReadEvent() : content_length(0) {}
 
     std::string http_version;
-    uint16_t status_code;
-    std::string status_message;
 
     uint64_t content_length;
 
-    /**
-     * HTTP header names are case insensitive, so the key value here is
-     * converted to lowercase for ease of use.
-     */
-    std::map<std::string, std::string> headers;
+    /** Status line and headers of the response. */
+    mf::http::Headers headers;
 
     SharedStreamBuf read_buffer;
 };
@@ -113,16 +113,44 @@ struct HeadersParsedEvent
 {
     uint64_t content_length;
 
-    /**
-     * HTTP header names are case insensitive, so the key value here is
-     * converted to lowercase for ease of use.
-     */
-    std::map<std::string, std::string> headers;
+    /** Status line and headers of the response. */
+    mf::http::Headers headers;
 
     SharedStreamBuf read_buffer;
+
+    uint16_t status_code;
+
+    /** True if the connection may be reused once the content is read. */
+    bool keep_alive;
 };
 struct ContentReadEvent {};
 
+// HTTP/2 events
+struct Http2SessionEvent {};
+struct Http2PoolReadyEvent
+{
+    /** Which wait for a connection this ends. */
+    uint32_t wait_id;
+};
+struct Http2HeadersEvent : public HeadersReadEvent
+{
+    Http2HeadersEvent() : stream_serial(0) {}
+
+    /** Events of streams the request abandoned are ignored. */
+    uint32_t stream_serial;
+};
+struct Http2DataEvent
+{
+    uint32_t stream_serial;
+    SharedBuffer::Pointer buffer;
+};
+struct Http2StreamClosedEvent
+{
+    uint32_t stream_serial;
+    std::error_code code;
+    std::string description;
+};
+
 }  // namespace detail
 }  // namespace http
 }  // namespace mf
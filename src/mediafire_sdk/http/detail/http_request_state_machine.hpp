@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <map>
 #include <memory>
@@ -27,10 +28,6 @@
 #include "boost/asio/ssl.hpp"
 #include "boost/asio/steady_timer.hpp"
 #include "boost/bind.hpp"
-#include "boost/iostreams/copy.hpp"
-#include "boost/iostreams/filter/gzip.hpp"
-#include "boost/iostreams/filtering_streambuf.hpp"
-#include "boost/iostreams/restrict.hpp"
 #include "boost/lexical_cast.hpp"
 #include "boost/variant/apply_visitor.hpp"
 
@@ -38,15 +35,25 @@
 #   include "boost/atomic.hpp"
 #endif
 
+#include "mediafire_sdk/http/detail/connect_racer.hpp"
+#include "mediafire_sdk/http/detail/connection_pool.hpp"
 #include "mediafire_sdk/http/detail/default_http_headers.hpp"
 #include "mediafire_sdk/http/detail/encoding.hpp"
+#include "mediafire_sdk/http/detail/http2_session_pool.hpp"
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
+#include "mediafire_sdk/http/detail/resolver_cache.hpp"
 #include "mediafire_sdk/http/detail/socket_wrapper.hpp"
 #include "mediafire_sdk/http/detail/timeouts.hpp"
+#include "mediafire_sdk/http/detail/tls_session_cache.hpp"
+
+#ifdef HTTP_USE_NGHTTP2
+#   include "mediafire_sdk/http/detail/http2_session.hpp"
+#endif
 
 #include "mediafire_sdk/http/detail/state_connect.hpp"
 #include "mediafire_sdk/http/detail/state_error.hpp"
+#include "mediafire_sdk/http/detail/state_http2.hpp"
 #include "mediafire_sdk/http/detail/state_initialize.hpp"
 #include "mediafire_sdk/http/detail/state_parse_headers.hpp"
 #include "mediafire_sdk/http/detail/state_proxy_connect.hpp"
@@ -62,7 +69,9 @@
 
 #include "mediafire_sdk/http/post_data_pipe_interface.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/shared_buffer.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
 
 #include "mediafire_sdk/utils/base64.hpp"
 #include "mediafire_sdk/utils/string.hpp"
@@ -175,6 +184,42 @@ struct HasPost
     }
 };
 
+struct IsHttp2
+{
+    template <class Fsm,class Evt,class SourceState,class TargetState>
+    bool operator()(Evt const&, Fsm& fsm, SourceState&,TargetState&)
+    {
+        return static_cast<bool>(fsm.get_http2_session());
+    }
+};
+struct IsCurrentHttp2Stream
+{
+    template <class Fsm,class Evt,class SourceState,class TargetState>
+    bool operator()(Evt const& evt, Fsm& fsm, SourceState&,TargetState&)
+    {
+        return evt.stream_serial == fsm.get_http2_stream_serial();
+    }
+};
+struct IsCurrentHttp2Wait
+{
+    template <class Fsm,class Evt,class SourceState,class TargetState>
+    bool operator()(Evt const& evt, Fsm& fsm, SourceState&,TargetState&)
+    {
+        return evt.wait_id == fsm.get_http2_wait_id();
+    }
+};
+
+// Actions
+struct Http2ResponseStarted
+{
+    template <class Fsm,class Evt,class SourceState,class TargetState>
+    void operator()(Evt const&, Fsm& fsm, SourceState&,TargetState&)
+    {
+        // A response was received, so the pooled connection was not stale.
+        fsm.set_connection_reused(false);
+    }
+};
+
 // front-end: define the FSM structure
 class HttpRequestMachine_ :
     public std::enable_shared_from_this<HttpRequestMachine_>,
@@ -192,6 +237,8 @@ public:
         request_creation_time_(sclock::now()),
         transmission_delay_timer_(*work_io_service_),
         transmission_delay_timer_enabled_(false),
+        bandwidth_limiter_(http_config_->GetBandwidthLimiter()),
+        bandwidth_weight_(1),
         timer_(*work_io_service_),
         timeout_seconds_(60),
         timeout_id_(0),
@@ -200,6 +247,13 @@ public:
         resolver_(*work_io_service_),
         redirect_policy_(http_config_->GetRedirectPolicy()),
         ssl_ctx_(http_config_->GetSslContext()),
+        connection_reused_(false),
+        request_sent_(false),
+        connection_reusable_(false),
+        allow_connection_reuse_(true),
+        http2_connecting_(false),
+        http2_stream_serial_(0),
+        http2_wait_id_(0),
         ssl_verify_mode_(CertAllowToVerifyMode(
                 http_config_->SelfSignedCertificatesAllowed())),
         request_method_("GET"),
@@ -301,16 +355,23 @@ public:
             // Close connection
             machine.Disconnect();
 
+            machine.EndBandwidthTransfers();
+
             if ( machine.transmission_delay_timer_enabled_ )
             {
                 machine.transmission_delay_timer_enabled_ = false;
                 machine.transmission_delay_timer_.cancel();
             }
 
+            machine.EndPhase(hl::RequestPhase::Total);
+
+            const hl::RequestTimings timings = machine.timings_;
+
             std::shared_ptr<hl::RequestResponseInterface> iface(
                     machine.callback_);
             machine.callback_io_service_->dispatch(
-                    [evt, iface](){
+                    [evt, iface, timings](){
+                        iface->RequestTimingsReceived(timings);
                         iface->RequestResponseErrorEvent(
                             evt.code, evt.description );
                     }
@@ -324,14 +385,28 @@ public:
         {
             assert( machine.event_strand_.running_in_this_thread() );
 
-            // Close connection
-            machine.Disconnect();
+            // Keep connection for reuse if possible, else close it.
+            machine.ReleaseConnection();
+
+            machine.EndBandwidthTransfers();
+
+            machine.EndPhase(hl::RequestPhase::Transfer);
+            machine.EndPhase(hl::RequestPhase::Total);
+
+            const hl::RequestTimings timings = machine.timings_;
+
+            if ( auto sink = hl::GetRequestTimingSink() )
+            {
+                sink->RecordRequestTimings(machine.parsed_url_->path(),
+                    timings);
+            }
 
             std::shared_ptr<hl::RequestResponseInterface> iface(
                     machine.callback_);
 
             machine.callback_io_service_->dispatch(
-                    [iface](){
+                    [iface, timings](){
+                        iface->RequestTimingsReceived(timings);
                         iface->RequestResponseCompleteEvent();
                     }
                 );
@@ -367,15 +442,20 @@ public:
     // Helper actions
     void SetTransactionDelayTimer(
             TimePoint last_write_start,
-            TimePoint last_write_end
+            TimePoint last_write_end,
+            hl::BandwidthLimiter::Direction direction,
+            uint64_t bytes_transferred
         )
     {
         const auto length = AsDuration(last_write_end - last_write_start);
-        SetTransactionDelayTimer( last_write_end, length );
+        SetTransactionDelayTimer( last_write_end, length, direction,
+            bytes_transferred );
     }
     void SetTransactionDelayTimer(
         TimePoint last_write_end,
-        Duration length
+        Duration length,
+        hl::BandwidthLimiter::Direction direction,
+        uint64_t bytes_transferred
         )
     {
         TimePoint expire_time = last_write_end;
@@ -395,9 +475,62 @@ public:
 
         expire_time += microseconds(mss);
 
+        // Also wait for the share of the limit other requests are owed.
+        if ( bytes_transferred > 0 )
+        {
+            const TimePoint release = BandwidthTransfer(direction)->Consume(
+                bytes_transferred);
+            expire_time = std::max(expire_time, release);
+        }
+
         transmission_delay_timer_enabled_ = true;
         transmission_delay_timer_.expires_at( expire_time );
     }
+    hl::BandwidthLimiter::Transfer::Pointer BandwidthTransfer(
+            hl::BandwidthLimiter::Direction direction
+        )
+    {
+        auto & transfer =
+            direction == hl::BandwidthLimiter::Direction::Upload
+            ? upload_transfer_ : download_transfer_;
+
+        if ( ! transfer )
+        {
+            transfer = bandwidth_limiter_->StartTransfer(direction,
+                bandwidth_weight_);
+        }
+
+        return transfer;
+    }
+    void EndBandwidthTransfers()
+    {
+        // Stop counting towards the shares of other requests.
+        upload_transfer_.reset();
+        download_transfer_.reset();
+    }
+    void BeginPhase(hl::RequestPhase phase)
+    {
+        auto & span = timings_.phases[static_cast<std::size_t>(phase)];
+        span.begin = sclock::now();
+        span.end = TimePoint();
+    }
+    void EndPhase(hl::RequestPhase phase)
+    {
+        // Only phases underway, as some states are reached several ways.
+        auto & span = timings_.phases[static_cast<std::size_t>(phase)];
+        if ( span.begin != TimePoint() && span.end == TimePoint() )
+            span.end = sclock::now();
+    }
+    void ResetPhases()
+    {
+        // Only the phases of the latest request made are kept, so a
+        // redirect starts over.
+        for (std::size_t i = 0; i < hl::kRequestPhaseCount; ++i)
+        {
+            if ( static_cast<hl::RequestPhase>(i) != hl::RequestPhase::Total )
+                timings_.phases[i] = hl::RequestTimings::Span();
+        }
+    }
     void SetTransactionDelayTimerWrapper(
             std::function<void()> bind_function,
             const boost::system::error_code& err
@@ -422,7 +555,10 @@ public:
     }
     RacePreventer SetAsyncTimeout(std::string reason, uint32_t timeout_seconds)
     {
-        RacePreventer race_preventer(socket_wrapper_.get());
+        // HTTP/2 requests do not own the socket they use.
+        RacePreventer race_preventer = socket_wrapper_
+            ? RacePreventer(socket_wrapper_.get())
+            : RacePreventer();
 
         // Change the id for when handler and timeout end up on stack
         // together.
@@ -453,6 +589,164 @@ public:
             socket_wrapper_->Cancel();
             socket_wrapper_.reset();
         }
+
+        // The HTTP/2 connection is shared, so only the stream is closed.
+        if (http2_stream_)
+        {
+            http2_stream_->Cancel();
+            http2_stream_.reset();
+        }
+        http2_session_.reset();
+
+        // Let requests waiting on the connection this request was opening
+        // try for themselves.
+        if (http2_connecting_)
+        {
+            http2_connecting_ = false;
+            get_http2_session_pool()->EndConnect(http2_connect_key_, nullptr,
+                false);
+        }
+    }
+    ConnectionPoolKey PoolKey() const
+    {
+        ConnectionPoolKey key;
+        key.scheme = parsed_url_->scheme();
+        key.host = parsed_url_->host();
+        key.port = parsed_url_->port();
+        key.io_service = work_io_service_;
+        if ( UsingProxy() )
+        {
+            const auto & proxy = CurrentProxy();
+            key.proxy = proxy.host + ':' + mf::utils::to_string(proxy.port)
+                + ':' + proxy.username;
+        }
+        return key;
+    }
+    std::shared_ptr<SocketWrapper> AcquirePooledConnection()
+    {
+        connection_reused_ = false;
+        request_sent_ = false;
+        connection_reusable_ = false;
+
+        // Post data pipes can not be rewound, so a request using one could not
+        // be retried if the pooled connection turns out to be stale.
+        if ( ! allow_connection_reuse_ || post_interface_ )
+            return nullptr;
+
+        auto socket_wrapper = http_config_->GetConnectionPool()->Acquire(
+            PoolKey());
+        connection_reused_ = static_cast<bool>(socket_wrapper);
+        return socket_wrapper;
+    }
+    bool Http2Allowed() const
+    {
+#ifdef HTTP_USE_NGHTTP2
+        return is_ssl_ && http_config_->GetHttp2Enabled();
+#else
+        return false;
+#endif
+    }
+    Http2ConnectionInterface::Pointer AcquireHttp2Session()
+    {
+        connection_reused_ = false;
+        request_sent_ = false;
+
+        // As with pooled connections, requests that can not be retried only
+        // use connections they open.
+        if ( ! allow_connection_reuse_ || post_interface_ )
+            return nullptr;
+
+        auto session = get_http2_session_pool()->Acquire(PoolKey());
+        connection_reused_ = static_cast<bool>(session);
+        return session;
+    }
+    bool Http1OnlyHost() const
+    {
+        return get_http2_session_pool()->Http1Only(PoolKey());
+    }
+    /**
+     * Returns true if this request should open the HTTP/2 connection, else
+     * the request waits for the connection being opened.
+     */
+    bool BeginHttp2Connect()
+    {
+        const uint32_t wait_id = ++http2_wait_id_;
+        auto weak_self = AsFrontWeak();
+
+        http2_connect_key_ = PoolKey();
+        http2_connecting_ = get_http2_session_pool()->BeginConnect(
+            http2_connect_key_,
+            [weak_self, wait_id]()
+            {
+                if (auto self = weak_self.lock())
+                    self->ProcessEvent(Http2PoolReadyEvent{wait_id});
+            });
+
+        return http2_connecting_;
+    }
+    void OfferHttp2()
+    {
+#ifdef HTTP_USE_NGHTTP2
+        if (http2_connecting_)
+            Http2Session::OfferProtocols(socket_wrapper_.get());
+#endif
+    }
+    void Http2HandshakeComplete()
+    {
+        if ( ! http2_connecting_ )
+            return;
+
+        http2_connecting_ = false;
+
+#ifdef HTTP_USE_NGHTTP2
+        if (Http2Session::Negotiated(socket_wrapper_.get()))
+        {
+            // The connection now belongs to the session.
+            http2_session_ = Http2Session::Create(std::move(socket_wrapper_));
+            socket_wrapper_.reset();
+
+            get_http2_session_pool()->EndConnect(http2_connect_key_,
+                http2_session_, false);
+            return;
+        }
+#endif
+
+        get_http2_session_pool()->EndConnect(http2_connect_key_, nullptr,
+            true);
+    }
+    std::string TlsSessionKey() const
+    {
+        // Sessions verified against a self signed certificate must not be
+        // resumed by a request that requires a trusted certificate.
+        std::string key = parsed_url_->host();
+        if (ssl_verify_mode_ == asio::ssl::verify_none)
+            key += ":unverified";
+        return key;
+    }
+    void ReleaseConnection()
+    {
+        // The stream has ended and the HTTP/2 connection stays in its pool.
+        http2_stream_.reset();
+        http2_session_.reset();
+
+        // TLS 1.3 session tickets arrive after the handshake, so keep the
+        // session again now that the response has been read.
+        if (socket_wrapper_ && is_ssl_)
+        {
+            get_tls_session_cache()->StoreSession(TlsSessionKey(),
+                socket_wrapper_->SslSocket()->native_handle());
+        }
+
+        if (socket_wrapper_ && connection_reusable_)
+        {
+            http_config_->GetConnectionPool()->Release(PoolKey(),
+                socket_wrapper_);
+            socket_wrapper_.reset();
+        }
+        else
+        {
+            Disconnect();
+        }
     }
     void SetHeader(const std::string & name, const std::string & value)
     {
@@ -485,6 +779,9 @@ public:
         Row < Unstarted     , StartEvent            , Initializing  , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
         Row < Initializing  , InitializedEvent      , Resolve       , none                , none                               >,  // NOLINT
+        Row < Initializing  , ReusedConnectionEvent , SendHeader    , none                , none                               >,  // NOLINT
+        Row < Initializing  , Http2SessionEvent     , Http2Exchange , none                , none                               >,  // NOLINT
+        Row < Initializing  , Http2PoolReadyEvent   , Initializing  , none                , IsCurrentHttp2Wait                 >,  // NOLINT
         Row < Initializing  , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
         Row < Resolve       , ResolvedEvent         , Connect       , none                , none                               >,  // NOLINT
@@ -501,7 +798,8 @@ public:
         Row < ProxyConnect  , ConnectedEvent        , SSLHandshake  , none                , IsSsl                              >,  // NOLINT
         Row < ProxyConnect  , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
-        Row < SSLHandshake  , HandshakeEvent        , SendHeader    , none                , none                               >,  // NOLINT
+        Row < SSLHandshake  , HandshakeEvent        , SendHeader    , none                , Not_<IsHttp2>                      >,  // NOLINT
+        Row < SSLHandshake  , HandshakeEvent        , Http2Exchange , none                , IsHttp2                            >,  // NOLINT
         Row < SSLHandshake  , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
         Row < SendHeader    , HeadersWrittenEvent   , SendPost      , none                , HasPost                            >,  // NOLINT
@@ -514,7 +812,8 @@ public:
         Row < ReadHeaders   , HeadersReadEvent      , ParseHeaders  , none                , none                               >,  // NOLINT
         Row < ReadHeaders   , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
-        Row < ParseHeaders  , HeadersParsedEvent    , ReadContent   , none                , none                               >,  // NOLINT
+        Row < ParseHeaders  , HeadersParsedEvent    , ReadContent   , none                , Not_<IsHttp2>                      >,  // NOLINT
+        Row < ParseHeaders  , HeadersParsedEvent    , Http2ReadContent, none              , IsHttp2                            >,  // NOLINT
         Row < ParseHeaders  , RedirectEvent         , Redirect      , none                , none                               >,  // NOLINT
         Row < ParseHeaders  , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
@@ -524,6 +823,15 @@ public:
         Row < ReadContent   , ContentReadEvent      , Complete      , none                , none                               >,  // NOLINT
         Row < ReadContent   , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
+        Row < Http2Exchange , Http2HeadersEvent     , ParseHeaders  , Http2ResponseStarted, IsCurrentHttp2Stream               >,  // NOLINT
+        Row < Http2Exchange , Http2StreamClosedEvent, none          , Http2StreamClosedAction, IsCurrentHttp2Stream            >,  // NOLINT
+        Row < Http2Exchange , ErrorEvent            , Error         , none                , none                               >,  // NOLINT
+        //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
+        Row < Http2ReadContent, Http2DataEvent      , none          , Http2DataAction     , IsCurrentHttp2Stream               >,  // NOLINT
+        Row < Http2ReadContent, Http2StreamClosedEvent, none        , Http2StreamClosedAction, IsCurrentHttp2Stream            >,  // NOLINT
+        Row < Http2ReadContent, ContentReadEvent    , Complete      , none                , none                               >,  // NOLINT
+        Row < Http2ReadContent, ErrorEvent          , Error         , none                , none                               >,  // NOLINT
+        //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
         Row < Error         , RestartEvent          , Initializing  , none                , none                               >,  // NOLINT
         Row < Error         , ErrorEvent            , FinalError    , none                , none                               >   // NOLINT
         //  +---------------+-----------------------+---------------+---------------------+------------------------------------+   // NOLINT
@@ -539,6 +847,17 @@ public:
         assert(!"improper transition in http state machine");
     }
 
+    // HTTP/2 streams and connections end on their own schedule, so their
+    // events can arrive after the request moved on.
+    template <typename FSM>
+    void no_transition(Http2PoolReadyEvent const&, FSM&, int) {}
+    template <typename FSM>
+    void no_transition(Http2HeadersEvent const&, FSM&, int) {}
+    template <typename FSM>
+    void no_transition(Http2DataEvent const&, FSM&, int) {}
+    template <typename FSM>
+    void no_transition(Http2StreamClosedEvent const&, FSM&, int) {}
+
     // Throw exception if machine being used incorrectly.
     template <typename FSM>
     void no_transition(ConfigEvent const& e, FSM&, int state)
@@ -554,6 +873,15 @@ public:
     std::string get_request_method() const {return request_method_;}
     void set_request_method(std::string v) {request_method_=v;}
 
+    /**
+     * Returns true if sending the request twice has the same effect as
+     * sending it once, so it may be sent again without asking.
+     */
+    bool RequestIdempotent() const
+    {
+        return request_method_ == "GET" || request_method_ == "HEAD";
+    }
+
     std::shared_ptr<hl::PostDataPipeInterface> get_post_interface() const {return post_interface_;}
     void SetPostInterface(
             std::shared_ptr<mf::http::PostDataPipeInterface> pipe_interface
@@ -619,9 +947,48 @@ public:
     std::shared_ptr<SocketWrapper> get_socket_wrapper() const {return socket_wrapper_;}
     void set_socket_wrapper(std::shared_ptr<SocketWrapper> v) {socket_wrapper_=v;}
 
+    bool get_connection_reused() const {return connection_reused_;}
+    void set_connection_reused(bool v) {connection_reused_=v;}
+
+    bool get_request_sent() const {return request_sent_;}
+    void set_request_sent(bool v) {request_sent_=v;}
+
+    void set_connection_reusable(bool v) {connection_reusable_=v;}
+
+    void set_allow_connection_reuse(bool v) {allow_connection_reuse_=v;}
+
+    TlsSessionCache::Pointer get_tls_session_cache() const
+    {return http_config_->GetTlsSessionCache();}
+
+    SharedBufferPool::Pointer get_receive_buffer_pool() const
+    {return http_config_->GetReceiveBufferPool();}
+
+    ResolverCache::Pointer get_resolver_cache() const
+    {return http_config_->GetResolverCache();}
+
+    ConnectRacer::Pointer get_connect_racer() const
+    {return http_config_->GetConnectRacer();}
+
+    Http2SessionPool::Pointer get_http2_session_pool() const
+    {return http_config_->GetHttp2SessionPool();}
+
+    Http2ConnectionInterface::Pointer get_http2_session() const {return http2_session_;}
+    void set_http2_session(Http2ConnectionInterface::Pointer v) {http2_session_=v;}
+
+    Http2StreamInterface::Pointer get_http2_stream() const {return http2_stream_;}
+    void set_http2_stream(Http2StreamInterface::Pointer v) {http2_stream_=v;}
+
+    uint32_t get_http2_stream_serial() const {return http2_stream_serial_;}
+    uint32_t NextHttp2StreamSerial() {return ++http2_stream_serial_;}
+
+    uint32_t get_http2_wait_id() const {return http2_wait_id_;}
+
     const hl::HttpRequest::HeaderContainer & get_headers() const {return send_headers_;}
 
     hl::BandwidthAnalyserInterface::Pointer get_bw_analyser() const {return bw_analyser_;}
+    bool BandwidthLimited(hl::BandwidthLimiter::Direction direction) const {return bandwidth_limiter_->Limited(direction);}
+    void set_bandwidth_weight(uint32_t v) {bandwidth_weight_=v;}
+    bool get_send_file_enabled() const {return http_config_->GetSendFileEnabled();}
 
     const asio::ssl::verify_mode get_ssl_verify_mode() const {return ssl_verify_mode_;}
 
@@ -656,10 +1023,19 @@ protected:
 
     const TimePoint request_creation_time_;
 
+    // When each phase of the request began and ended.
+    hl::RequestTimings timings_;
+
     // Use these to delay transmission of data for QOS.
     boost::asio::steady_timer transmission_delay_timer_;
     bool transmission_delay_timer_enabled_;
 
+    // Shared limit on the combined rate of requests.
+    hl::BandwidthLimiter::Pointer bandwidth_limiter_;
+    uint32_t bandwidth_weight_;
+    hl::BandwidthLimiter::Transfer::Pointer upload_transfer_;
+    hl::BandwidthLimiter::Transfer::Pointer download_transfer_;
+
     // Timeout timer
     boost::asio::steady_timer timer_;
     uint32_t timeout_seconds_;
@@ -682,6 +1058,34 @@ protected:
 
     std::shared_ptr<SocketWrapper> socket_wrapper_;
 
+    // Set while a pooled connection is in use and no response has been read
+    // from it yet.
+    bool connection_reused_;
+
+    // Set once any of the request may have reached the server on the
+    // current connection.
+    bool request_sent_;
+
+    // Set once the response has been fully read and the server allows the
+    // connection to be kept alive.
+    bool connection_reusable_;
+
+    // Cleared after a pooled connection turns out to be stale.
+    bool allow_connection_reuse_;
+
+    // HTTP/2 connection and stream the request is using.
+    Http2ConnectionInterface::Pointer http2_session_;
+    Http2StreamInterface::Pointer http2_stream_;
+
+    // Set while this request opens an HTTP/2 connection others may wait on.
+    bool http2_connecting_;
+    ConnectionPoolKey http2_connect_key_;
+
+    // Identify the current stream and wait, as events of earlier ones may
+    // still arrive.
+    uint32_t http2_stream_serial_;
+    uint32_t http2_wait_id_;
+
     const asio::ssl::verify_mode ssl_verify_mode_;
 
     // Send data.
@@ -26,6 +26,11 @@ public:
         socket_(wrapper->socket_)
     {}
 
+    /** For operations that do not use a socket of their own. */
+    RacePreventer() :
+        first_taken_(std::make_shared<bool>(false))
+    {}
+
     bool IsFirst()
     {
         auto is_first = ! *first_taken_;
@@ -0,0 +1,53 @@
+/**
+ * @file read_size_adapter.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "read_size_adapter.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace hl = mf::http::detail;
+
+hl::ReadSizeAdapter::ReadSizeAdapter(
+        uint64_t min_size,
+        uint64_t max_size
+    ) :
+    min_size_(min_size),
+    max_size_(max_size),
+    read_size_(min_size)
+{
+    assert(min_size_ > 0);
+    assert(min_size_ <= max_size_);
+}
+
+void hl::ReadSizeAdapter::Record(
+        uint64_t bytes,
+        Clock::duration elapsed
+    )
+{
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+
+    const uint64_t elapsed_us = std::max<uint64_t>(1,
+        duration_cast<microseconds>(elapsed).count());
+    const uint64_t target_us =
+        duration_cast<microseconds>(TargetInterval()).count();
+
+    // What would have arrived in the target interval at this rate.  Averaged
+    // with the current size so a single burst or stall is not followed
+    // blindly.
+    const double target = static_cast<double>(bytes) * target_us / elapsed_us;
+    const double averaged = (static_cast<double>(read_size_) + target) / 2;
+
+    read_size_ = static_cast<uint64_t>(std::min(averaged,
+        static_cast<double>(max_size_)));
+    read_size_ = std::max(read_size_, min_size_);
+}
+
+hl::ReadSizeAdapter::Clock::duration hl::ReadSizeAdapter::TargetInterval()
+{
+    return std::chrono::milliseconds(20);
+}
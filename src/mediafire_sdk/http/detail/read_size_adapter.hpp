@@ -0,0 +1,72 @@
+/**
+ * @file read_size_adapter.hpp
+ * @author Herbert Jones
+ * @brief Picks how much content to wait for per read.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class ReadSizeAdapter
+ * @brief Sizes content reads to the measured throughput.
+ *
+ * Small reads keep slow transfers responsive, while large reads keep fast
+ * transfers from spending their time on completion handlers and callbacks.
+ * The read size aims at a read completing about every TargetInterval(), and
+ * stays between the minimum and maximum.
+ */
+class ReadSizeAdapter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief CTOR
+     *
+     * @param[in] min_size Smallest read size, and the size of the first read.
+     * @param[in] max_size Largest read size.
+     */
+    ReadSizeAdapter(
+            uint64_t min_size,
+            uint64_t max_size
+        );
+
+    /**
+     * @return Bytes to wait for in the next read.
+     */
+    uint64_t ReadSize() const { return read_size_; }
+
+    /**
+     * @brief Adjust the read size after a read.
+     *
+     * @param[in] bytes Bytes received by the read.
+     * @param[in] elapsed Time from starting the read until it completed.
+     */
+    void Record(
+            uint64_t bytes,
+            Clock::duration elapsed
+        );
+
+    /**
+     * @return How often reads should complete.
+     */
+    static Clock::duration TargetInterval();
+
+private:
+    const uint64_t min_size_;
+    const uint64_t max_size_;
+
+    uint64_t read_size_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,282 @@
+/**
+ * @file resolver_cache.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "resolver_cache.hpp"
+
+#include "boost/asio.hpp"
+
+#include "mediafire_sdk/http/detail/timeouts.hpp"
+#include "mediafire_sdk/http/detail/types.hpp"
+
+namespace asio = boost::asio;
+
+namespace {
+const std::chrono::seconds kDefaultTimeout(60);
+const std::chrono::seconds kDefaultNegativeTimeout(5);
+
+// A lookup running longer than the resolve timeout has most likely stalled,
+// so new resolutions start a lookup of their own instead of waiting on it.
+const std::chrono::seconds kMaxCoalesceTime(kResolvingTimeout);
+
+void SystemLookup(
+        asio::io_service * io_service,
+        const std::string & host,
+        const std::string & port,
+        mf::http::detail::ResolverCache::LookupHandler handler
+    )
+{
+    auto resolver = std::make_shared<asio::ip::tcp::resolver>(*io_service);
+
+    asio::ip::tcp::resolver::query query(host, port);
+    resolver->async_resolve(
+        query,
+        [resolver, handler](
+                const boost::system::error_code & ec,
+                asio::ip::tcp::resolver::iterator iterator
+            )
+        {
+            mf::http::detail::ResolverCache::Endpoints endpoints;
+            for ( ; iterator != asio::ip::tcp::resolver::iterator();
+                ++iterator )
+            {
+                endpoints.push_back(iterator->endpoint());
+            }
+
+            handler(ec, std::move(endpoints));
+        });
+}
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+ResolverCache::Pointer ResolverCache::Create()
+{
+    return std::shared_ptr<ResolverCache>(new ResolverCache);
+}
+
+ResolverCache::ResolverCache() :
+    timeout_(kDefaultTimeout),
+    negative_timeout_(kDefaultNegativeTimeout),
+    lookup_(&SystemLookup),
+    next_lookup_id_(0),
+    statistics_{0, 0, 0}
+{
+}
+
+void ResolverCache::AsyncResolve(
+        asio::io_service * io_service,
+        const std::string & host,
+        const std::string & port,
+        ResolveHandler handler
+    )
+{
+    Waiter waiter{io_service, std::move(handler)};
+    uint64_t lookup_id = 0;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        const TimePoint now = sclock::now();
+
+        auto it = entries_.find(host + ':' + port);
+        if (it != entries_.end())
+        {
+            Entry & entry = it->second;
+
+            if ( ! entry.in_flight && entry.expires > now )
+            {
+                ++statistics_.hits;
+                Deliver(waiter, host, port, entry.error, entry.endpoints);
+                return;
+            }
+
+            if ( entry.in_flight
+                && entry.lookup_started + kMaxCoalesceTime > now )
+            {
+                ++statistics_.coalesced;
+                entry.waiters.push_back(std::move(waiter));
+                return;
+            }
+        }
+
+        ++statistics_.misses;
+        lookup_id = ++next_lookup_id_;
+
+        // Waiters on a stalled lookup are handed over to the new one.
+        Entry & entry = entries_[host + ':' + port];
+        entry.in_flight = true;
+        entry.flushed = false;
+        entry.lookup_id = lookup_id;
+        entry.lookup_started = now;
+        entry.waiters.push_back(std::move(waiter));
+    }
+
+    StartLookup(io_service, host, port, lookup_id);
+}
+
+void ResolverCache::StartLookup(
+        asio::io_service * io_service,
+        const std::string & host,
+        const std::string & port,
+        uint64_t lookup_id
+    )
+{
+    LookupFunction lookup;
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        lookup = lookup_;
+    }
+
+    auto self = shared_from_this();
+    lookup(io_service, host, port,
+        [self, host, port, lookup_id](
+                const boost::system::error_code & ec,
+                Endpoints endpoints
+            )
+        {
+            self->HandleLookup(host, port, lookup_id, ec,
+                std::move(endpoints));
+        });
+}
+
+void ResolverCache::HandleLookup(
+        const std::string & host,
+        const std::string & port,
+        uint64_t lookup_id,
+        const boost::system::error_code & ec,
+        Endpoints endpoints
+    )
+{
+    std::vector<Waiter> waiters;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        auto it = entries_.find(host + ':' + port);
+
+        // Superseded lookups have had their waiters taken over.
+        if ( it == entries_.end() || ! it->second.in_flight
+            || it->second.lookup_id != lookup_id )
+            return;
+
+        Entry & entry = it->second;
+        waiters.swap(entry.waiters);
+
+        const std::chrono::seconds timeout =
+            ec ? negative_timeout_ : timeout_;
+
+        if ( entry.flushed || timeout.count() <= 0
+            || ec == asio::error::operation_aborted )
+        {
+            entries_.erase(it);
+        }
+        else
+        {
+            entry.in_flight = false;
+            entry.error = ec;
+            entry.endpoints = endpoints;
+            entry.expires = sclock::now() + timeout;
+        }
+    }
+
+    for (const auto & waiter : waiters)
+        Deliver(waiter, host, port, ec, endpoints);
+}
+
+void ResolverCache::Deliver(
+        const Waiter & waiter,
+        const std::string & host,
+        const std::string & port,
+        const boost::system::error_code & ec,
+        const Endpoints & endpoints
+    )
+{
+    asio::ip::tcp::resolver::iterator iterator;
+    if ( ! ec )
+    {
+        iterator = asio::ip::tcp::resolver::iterator::create(
+            endpoints.begin(), endpoints.end(), host, port);
+    }
+
+    const ResolveHandler handler = waiter.handler;
+    waiter.io_service->post(
+        [handler, ec, iterator]()
+        {
+            handler(ec, iterator);
+        });
+}
+
+void ResolverCache::Flush()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    for (auto it = entries_.begin(); it != entries_.end(); )
+    {
+        if (it->second.in_flight)
+        {
+            it->second.flushed = true;
+            ++it;
+        }
+        else
+        {
+            it = entries_.erase(it);
+        }
+    }
+}
+
+void ResolverCache::SetTimeout(std::chrono::seconds timeout)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    timeout_ = timeout;
+}
+
+std::chrono::seconds ResolverCache::GetTimeout() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return timeout_;
+}
+
+void ResolverCache::SetNegativeTimeout(std::chrono::seconds timeout)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    negative_timeout_ = timeout;
+}
+
+std::chrono::seconds ResolverCache::GetNegativeTimeout() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return negative_timeout_;
+}
+
+void ResolverCache::SetLookupFunction(LookupFunction lookup)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    lookup_ = std::move(lookup);
+}
+
+ResolverCache::LookupFunction ResolverCache::GetLookupFunction() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return lookup_;
+}
+
+DnsCacheStatistics ResolverCache::GetStatistics() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return statistics_;
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
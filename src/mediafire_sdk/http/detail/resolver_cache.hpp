@@ -0,0 +1,185 @@
+/**
+ * @file resolver_cache.hpp
+ * @author Herbert Jones
+ * @brief Cache of host name resolutions shared between requests.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/asio/ip/tcp.hpp"
+#include "boost/system/error_code.hpp"
+
+#include "mediafire_sdk/utils/forward_declarations/asio.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @struct DnsCacheStatistics
+ * @brief Counters describing host name resolution.
+ */
+struct DnsCacheStatistics
+{
+    /** Resolutions answered from the cache, including cached failures. */
+    uint64_t hits;
+
+    /** Resolutions that started a lookup. */
+    uint64_t misses;
+
+    /** Resolutions that waited on a lookup already in progress. */
+    uint64_t coalesced;
+};
+
+namespace detail {
+
+/**
+ * @class ResolverCache
+ * @brief Resolves host names, remembering results for a limited time.
+ *
+ * Concurrent resolutions of the same host and port share a single lookup.
+ * Failed lookups are remembered for a shorter time so a missing host is not
+ * looked up again by every request.  Expired entries are replaced lazily, so
+ * the cache never keeps an io_service running.
+ */
+class ResolverCache :
+    public std::enable_shared_from_this<ResolverCache>
+{
+public:
+    using Pointer = std::shared_ptr<ResolverCache>;
+
+    using Endpoints = std::vector<boost::asio::ip::tcp::endpoint>;
+
+    using ResolveHandler = std::function<
+        void(
+            const boost::system::error_code &,
+            boost::asio::ip::tcp::resolver::iterator
+        )>;
+
+    using LookupHandler = std::function<
+        void(
+            const boost::system::error_code &,
+            Endpoints
+        )>;
+
+    /**
+     * Performs a single lookup, calling the handler from the io_service once
+     * done.  Replaceable so tests need not rely on the network.
+     */
+    using LookupFunction = std::function<
+        void(
+            boost::asio::io_service *,
+            const std::string & host,
+            const std::string & port,
+            LookupHandler
+        )>;
+
+    static Pointer Create();
+
+    /**
+     * @brief Resolve a host and port.
+     *
+     * The handler is always posted to the passed io_service, never called
+     * from within this function.
+     *
+     * @param[in] io_service Where the handler is called and the lookup runs.
+     * @param[in] host Host name to resolve.
+     * @param[in] port Port or service name.
+     * @param[in] handler Called with the result.
+     */
+    void AsyncResolve(
+            boost::asio::io_service * io_service,
+            const std::string & host,
+            const std::string & port,
+            ResolveHandler handler
+        );
+
+    /**
+     * @brief Forget all cached results.
+     *
+     * Lookups in progress still complete, but their results are not cached.
+     */
+    void Flush();
+
+    void SetTimeout(std::chrono::seconds timeout);
+    std::chrono::seconds GetTimeout() const;
+
+    void SetNegativeTimeout(std::chrono::seconds timeout);
+    std::chrono::seconds GetNegativeTimeout() const;
+
+    void SetLookupFunction(LookupFunction lookup);
+    LookupFunction GetLookupFunction() const;
+
+    DnsCacheStatistics GetStatistics() const;
+
+private:
+    ResolverCache();
+
+    struct Waiter
+    {
+        boost::asio::io_service * io_service;
+        ResolveHandler handler;
+    };
+
+    struct Entry
+    {
+        boost::system::error_code error;
+        Endpoints endpoints;
+        std::chrono::steady_clock::time_point expires;
+
+        bool in_flight;
+        bool flushed;
+        uint64_t lookup_id;
+        std::chrono::steady_clock::time_point lookup_started;
+        std::vector<Waiter> waiters;
+    };
+
+    void StartLookup(
+            boost::asio::io_service * io_service,
+            const std::string & host,
+            const std::string & port,
+            uint64_t lookup_id
+        );
+
+    void HandleLookup(
+            const std::string & host,
+            const std::string & port,
+            uint64_t lookup_id,
+            const boost::system::error_code & ec,
+            Endpoints endpoints
+        );
+
+    static void Deliver(
+            const Waiter & waiter,
+            const std::string & host,
+            const std::string & port,
+            const boost::system::error_code & ec,
+            const Endpoints & endpoints
+        );
+
+    mutable mf::utils::mutex mutex_;
+
+    // Keyed by host and port.
+    std::map<std::string, Entry> entries_;
+
+    std::chrono::seconds timeout_;
+    std::chrono::seconds negative_timeout_;
+
+    LookupFunction lookup_;
+
+    uint64_t next_lookup_id_;
+
+    DnsCacheStatistics statistics_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
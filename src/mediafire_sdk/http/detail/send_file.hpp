@@ -0,0 +1,167 @@
+/**
+ * @file send_file.hpp
+ * @author Herbert Jones
+ * @brief Asynchronous sendfile on a TCP socket.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+
+#include "boost/asio.hpp"
+
+#if defined(__linux__)
+#   include <sys/sendfile.h>
+#   include <sys/types.h>
+#endif
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @return True if AsyncSendFile can be used on this platform.
+ */
+inline bool SendFileSupported()
+{
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(__linux__)
+/**
+ * @class SendFileOperation
+ * @brief Sends a range of a file to a socket without copying it through user
+ * space.
+ *
+ * The socket is made non-blocking and sendfile is called until the range is
+ * sent, waiting for the socket to become writable whenever it would block.
+ */
+template <typename Handler>
+class SendFileOperation
+{
+public:
+    SendFileOperation(
+            boost::asio::ip::tcp::socket * socket,
+            int file_descriptor,
+            uint64_t offset,
+            std::size_t size,
+            Handler handler
+        ) :
+        socket_(socket),
+        file_descriptor_(file_descriptor),
+        offset_(offset),
+        size_(size),
+        total_bytes_sent_(0),
+        handler_(handler)
+    {}
+
+    void operator()(
+            boost::system::error_code ec,
+            std::size_t /* bytes_transferred */ = 0
+        )
+    {
+        while ( ! ec && total_bytes_sent_ < size_ )
+        {
+            if ( ! socket_->native_non_blocking() )
+                socket_->native_non_blocking(true, ec);
+
+            if (ec)
+                break;
+
+            off_t offset = static_cast<off_t>(offset_ + total_bytes_sent_);
+            const ssize_t bytes_sent = ::sendfile(socket_->native_handle(),
+                file_descriptor_, &offset, size_ - total_bytes_sent_);
+
+            if (bytes_sent < 0)
+            {
+                ec = boost::system::error_code(errno,
+                    boost::asio::error::get_system_category());
+
+                if (ec == boost::asio::error::interrupted)
+                {
+                    ec = boost::system::error_code();
+                    continue;
+                }
+
+                if (ec == boost::asio::error::would_block
+                    || ec == boost::asio::error::try_again)
+                {
+                    // Continue once the socket is writable again.
+                    socket_->async_write_some(boost::asio::null_buffers(),
+                        *this);
+                    return;
+                }
+            }
+            else if (bytes_sent == 0)
+            {
+                // The file is shorter than expected.
+                ec = boost::asio::error::eof;
+            }
+            else
+            {
+                total_bytes_sent_ += static_cast<std::size_t>(bytes_sent);
+            }
+        }
+
+        handler_(ec, total_bytes_sent_);
+    }
+
+private:
+    boost::asio::ip::tcp::socket * socket_;
+    int file_descriptor_;
+    uint64_t offset_;
+    std::size_t size_;
+    std::size_t total_bytes_sent_;
+    Handler handler_;
+};
+#endif
+
+/**
+ * @brief Send size bytes of a file starting at offset to a socket.
+ *
+ * The handler is called with the error and the number of bytes sent, like
+ * boost::asio::async_write.  It is always called through the socket's
+ * io_service.  Check SendFileSupported() first, elsewhere the handler receives
+ * operation_not_supported.
+ *
+ * @param[in] socket Connected socket.
+ * @param[in] file_descriptor Open file to send from.
+ * @param[in] offset Position of the first byte to send.
+ * @param[in] size Number of bytes to send.
+ * @param[in] handler Called once the bytes are sent or on error.
+ */
+template <typename Handler>
+void AsyncSendFile(
+        boost::asio::ip::tcp::socket * socket,
+        int file_descriptor,
+        uint64_t offset,
+        std::size_t size,
+        Handler handler
+    )
+{
+#if defined(__linux__)
+    SendFileOperation<Handler> operation(socket, file_descriptor, offset, size,
+        handler);
+
+    // Start once writable so the handler never runs inside this call.
+    socket->async_write_some(boost::asio::null_buffers(), operation);
+#else
+    (void)file_descriptor;
+    (void)offset;
+    (void)size;
+    socket->get_io_service().post(
+        [handler]() mutable
+        {
+            handler(boost::asio::error::operation_not_supported, 0);
+        });
+#endif
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -77,6 +77,19 @@ public:
         return socket_.get();
     }
 
+    /**
+     * @brief Access the underlying TCP socket of either socket type.
+     *
+     * @return Reference to the TCP socket
+     */
+    asio::ip::tcp::socket & LowestLayer()
+    {
+        if ( ssl_socket_ )
+            return ssl_socket_->next_layer();
+        else
+            return *socket_;
+    }
+
     /**
      * @brief Cancel asynchronous operations on socket.
      */
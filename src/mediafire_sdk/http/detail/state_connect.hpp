@@ -10,10 +10,12 @@
 #include "boost/asio.hpp"
 #include "boost/msm/front/state_machine_def.hpp"
 
+#include "mediafire_sdk/http/detail/connect_racer.hpp"
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
 #include "mediafire_sdk/http/detail/timeouts.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 
 namespace mf {
 namespace http {
@@ -27,6 +29,8 @@ public:
     {}
 
     bool cancelled;
+
+    ConnectRace::Pointer race;
 };
 
 using ConnectDataPointer = std::shared_ptr<ConnectData>;
@@ -74,6 +78,9 @@ public:
     template <typename FSM>
     void on_entry(ResolvedEvent const & evt, FSM & fsm)
     {
+        fsm.EndPhase(RequestPhase::Dns);
+        fsm.BeginPhase(RequestPhase::Connect);
+
         auto state_data = std::make_shared<ConnectData>();
         state_data_ = state_data;
 
@@ -83,46 +90,31 @@ public:
         auto socket_wrapper = fsm.get_socket_wrapper();
         auto fsmp = fsm.AsFrontShared();
 
-        if ( fsm.get_is_ssl() )
-        {
-            assert(socket_wrapper->SslSocket());
-
-            // Attempt a connection to each endpoint in the list until we
-            // successfully establish a connection.
-            boost::asio::async_connect(
-                socket_wrapper->SslSocket()->lowest_layer(),
-                evt.endpoint_iterator,
-                [fsmp, state_data, race_preventer](
-                        const boost::system::error_code& ec,
-                        boost::asio::ip::tcp::resolver::iterator iterator
-                    )
-                {
-                    HandleConnect(*fsmp, state_data, race_preventer, ec);
-                });
-        }
-        else
-        {
-            assert(socket_wrapper->Socket());
-
-            // Attempt a connection to each endpoint in the list until we
-            // successfully establish a connection.
-            boost::asio::async_connect(
-                *socket_wrapper->Socket(),
-                evt.endpoint_iterator,
-                [fsmp, state_data, race_preventer](
-                        const boost::system::error_code& ec,
-                        boost::asio::ip::tcp::resolver::iterator iterator
-                    )
-                {
-                    HandleConnect(*fsmp, state_data, race_preventer, ec);
-                });
-        }
+        assert(socket_wrapper->SslSocket() || socket_wrapper->Socket());
+
+        // Attempts to the endpoints are staggered so an unreachable address
+        // does not hold up the others.
+        state_data->race = fsm.get_connect_racer()->AsyncConnect(
+            &socket_wrapper->LowestLayer(),
+            evt.endpoint_iterator,
+            [fsmp, state_data, race_preventer](
+                    const boost::system::error_code& ec,
+                    boost::asio::ip::tcp::endpoint /* endpoint */
+                )
+            {
+                HandleConnect(*fsmp, state_data, race_preventer, ec);
+            });
     }
 
     template <typename Event, typename FSM>
     void on_exit(Event const&, FSM &)
     {
         state_data_->cancelled = true;
+        if (state_data_->race)
+        {
+            state_data_->race->Cancel();
+            state_data_->race.reset();
+        }
         state_data_.reset();
     }
 
@@ -31,11 +31,26 @@ struct Error : public boost::msm::front::state<>
         auto timeout = fsm.get_request_creation_time() +
             std::chrono::seconds(fsm.get_timeout_seconds());
 
+        // Once the request may have reached the server it may also have been
+        // acted on, so only send it again if that is harmless.
+        const bool stale_connection = fsm.get_connection_reused()
+            && ( evt.code == mf::http::http_error::WriteFailure
+                || evt.code == mf::http::http_error::ReadFailure )
+            && ( ! fsm.get_request_sent() || fsm.RequestIdempotent() );
+
         if (evt.code == mf::http::http_error::IoTimeout && sclock::now() < timeout)
         {
             // Restart everything
             fsm.ProcessEvent(RestartEvent{});
         }
+        else if (stale_connection)
+        {
+            // The server closed the pooled connection before it could be
+            // used. Retry once on a new connection.
+            fsm.set_connection_reused(false);
+            fsm.set_allow_connection_reuse(false);
+            fsm.ProcessEvent(RestartEvent{});
+        }
         else
         {
             // Pass error on
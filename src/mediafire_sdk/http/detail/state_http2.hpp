@@ -0,0 +1,428 @@
+/**
+ * @file state_http2.hpp
+ * @author Herbert Jones
+ * @brief Config state machine transitions
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/msm/front/state_machine_def.hpp"
+
+#include "mediafire_sdk/http/bandwidth_limiter.hpp"
+#include "mediafire_sdk/http/detail/http2_session_pool.hpp"
+#include "mediafire_sdk/http/detail/http_request_events.hpp"
+#include "mediafire_sdk/http/detail/state_read_content.hpp"
+#include "mediafire_sdk/http/detail/types.hpp"
+#include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+#include "mediafire_sdk/http/url.hpp"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class Http2StreamEvents
+ * @brief Passes what happens on a stream on to the state machine as events.
+ */
+template <typename FSM>
+class Http2StreamEvents : public Http2StreamHandlerInterface
+{
+public:
+    Http2StreamEvents(
+            std::weak_ptr<FSM> fsm,
+            uint32_t stream_serial,
+            SharedBufferPool::Pointer buffer_pool
+        ) :
+        fsm_(std::move(fsm)),
+        stream_serial_(stream_serial),
+        buffer_pool_(std::move(buffer_pool))
+    {}
+
+    virtual void Http2HeadersReceived(mf::http::Headers headers) override
+    {
+        Http2HeadersEvent evt;
+        evt.stream_serial = stream_serial_;
+        evt.http_version = "HTTP/2";
+        evt.read_buffer = std::make_shared<boost::asio::streambuf>();
+
+        if ( auto content_length = headers.Find("content-length") )
+        {
+            try {
+                evt.content_length = boost::lexical_cast<uint64_t>(
+                    std::string(content_length->begin(),
+                        content_length->end()));
+            }
+            catch(boost::bad_lexical_cast &)
+            {
+            }
+        }
+
+        evt.headers = std::move(headers);
+
+        if (auto fsm = fsm_.lock())
+            fsm->ProcessEvent(evt);
+    }
+
+    virtual void Http2DataReceived(
+            const uint8_t * data,
+            std::size_t size
+        ) override
+    {
+        auto fsm = fsm_.lock();
+        if ( ! fsm )
+            return;
+
+        // Copied out in pieces no larger than the pooled buffers.
+        while (size > 0)
+        {
+            const uint64_t piece_size = std::min<uint64_t>(size,
+                buffer_pool_->BufferSize());
+
+            auto buffer = buffer_pool_->Acquire(piece_size);
+            std::memcpy(buffer->Data(), data, piece_size);
+
+            fsm->ProcessEvent(Http2DataEvent{stream_serial_,
+                std::move(buffer)});
+
+            data += piece_size;
+            size -= piece_size;
+        }
+    }
+
+    virtual void Http2StreamClosed(
+            std::error_code error_code,
+            std::string description
+        ) override
+    {
+        if (auto fsm = fsm_.lock())
+        {
+            fsm->ProcessEvent(Http2StreamClosedEvent{stream_serial_,
+                error_code, std::move(description)});
+        }
+    }
+
+private:
+    std::weak_ptr<FSM> fsm_;
+    const uint32_t stream_serial_;
+    SharedBufferPool::Pointer buffer_pool_;
+};
+
+/**
+ * @brief Describe the request for an HTTP/2 stream.
+ */
+template <typename FSM>
+Http2StreamRequest MakeHttp2StreamRequest(FSM & fsm)
+{
+    const Url * url = fsm.get_parsed_url();
+
+    Http2StreamRequest request;
+    request.method = fsm.get_request_method();
+    request.scheme = url->scheme();
+    request.authority = url->host();
+    if ( ! url->port().empty() )
+        request.authority += ':' + url->port();
+    request.path = url->full_path();
+    request.post_data = fsm.get_post_data();
+    request.post_interface = fsm.get_post_interface();
+
+    for ( const auto & pair : fsm.get_headers() )
+    {
+        // Compression over SSL is not allowed as it is a vulnerability.
+        // See BREACH.
+        if ( boost::iequals(pair.first, "accept-encoding") )
+            continue;
+
+        request.headers.push_back(pair);
+    }
+
+    return request;
+}
+
+/**
+ * @class Http2Exchange
+ * @brief Send the request on an HTTP/2 connection and wait for the response
+ * headers.
+ */
+class Http2Exchange : public boost::msm::front::state<>
+{
+public:
+    template <typename Event, typename FSM>
+    void on_entry(Event const &, FSM & fsm)
+    {
+        // The request is sent on a stream as a whole, so there is no send
+        // phase.
+        fsm.EndPhase(RequestPhase::Tls);
+        fsm.BeginPhase(RequestPhase::TimeToFirstByte);
+
+        auto handler = std::make_shared<Http2StreamEvents<FSM>>(
+                fsm.AsFrontWeak(), fsm.NextHttp2StreamSerial(),
+                fsm.get_receive_buffer_pool());
+
+        fsm.SetAsyncTimeout("HTTP/2 response headers",
+            fsm.get_timeout_seconds());
+
+        // Whether the session wrote any of the stream before failing is not
+        // known, so count the request as sent.
+        fsm.set_request_sent(true);
+
+        fsm.set_http2_stream(fsm.get_http2_session()->StartStream(
+            MakeHttp2StreamRequest(fsm), handler));
+    }
+
+    template <typename Event, typename FSM>
+    void on_exit(Event const&, FSM & fsm)
+    {
+        fsm.ClearAsyncTimeout();
+    }
+
+    /** The stream ended before a response was received. */
+    template <typename FSM>
+    void HandleClosed(Http2StreamClosedEvent const & evt, FSM & fsm)
+    {
+        std::stringstream ss;
+        ss << "HTTP/2 request failed.";
+        ss << " Url: " << fsm.get_url();
+        ss << " Error: " << evt.description;
+        fsm.ProcessEvent(ErrorEvent{evt.code, ss.str()});
+    }
+};
+
+/**
+ * @brief Stream window withheld while downloads are over the bandwidth limit.
+ */
+struct Http2WindowHold
+{
+    Http2WindowHold() : cancelled(false), withheld(0) {}
+
+    bool cancelled;
+
+    /** Bytes passed on but not yet given back to the server. */
+    std::size_t withheld;
+
+    /** When the window may be opened again. */
+    TimePoint release;
+};
+using Http2WindowHoldPointer = std::shared_ptr<Http2WindowHold>;
+
+/**
+ * @class Http2ReadContent
+ * @brief Pass on the content received on the HTTP/2 stream.
+ */
+class Http2ReadContent : public boost::msm::front::state<>
+{
+public:
+    template <typename FSM>
+    void on_entry(HeadersParsedEvent const & evt, FSM & fsm)
+    {
+        using mf::http::http_error;
+
+        fsm.BeginPhase(RequestPhase::Transfer);
+
+        auto state_data = std::make_shared<ReadContentData>(
+            fsm.get_receive_buffer_pool());
+        state_data_ = state_data;
+
+        window_hold_ = std::make_shared<Http2WindowHold>();
+
+        received_ = 0;
+
+        fsm.SetAsyncTimeout("HTTP/2 response content",
+            fsm.get_timeout_seconds());
+
+        const int content_encoding = ParseContentEncoding(evt.headers);
+
+        if ( content_encoding != CE_None )
+        {
+            if ( ! ( content_encoding & CE_Unknown ) )
+            {
+                state_data->decoder = CreateContentDecoder(content_encoding,
+                    state_data->buffer_pool);
+            }
+
+            // Unknown, not built in, or more than one coding.
+            if ( ! state_data->decoder )
+            {
+                std::stringstream ss;
+                ss << "Unsupported content-encoding.";
+                if ( auto value = evt.headers.Find("content-encoding") )
+                    ss << " Content-Encoding: " << *value;
+                fsm.ProcessEvent(ErrorEvent{
+                        make_error_code(
+                            http_error::UnsupportedEncoding ),
+                        ss.str()
+                    });
+            }
+        }
+    }
+
+    template <typename Event, typename FSM>
+    void on_exit(Event const&, FSM & fsm)
+    {
+        fsm.ClearAsyncTimeout();
+        state_data_.reset();
+
+        window_hold_->cancelled = true;
+        window_hold_.reset();
+
+        if ( fsm.get_transmission_delay_timer_enabled() )
+        {
+            fsm.set_transmission_delay_timer_enabled(false);
+            fsm.get_transmission_delay_timer()->cancel();
+        }
+    }
+
+    template <typename FSM>
+    void HandleData(Http2DataEvent const & evt, FSM & fsm)
+    {
+        const std::size_t size = evt.buffer->Size();
+
+        if (fsm.get_bw_analyser())
+        {
+            const TimePoint now = sclock::now();
+            fsm.get_bw_analyser()->RecordIncomingBytes( size, now, now );
+        }
+
+        const uint64_t start_pos = received_;
+        received_ += size;
+
+        if ( ! PassContent(fsm, state_data_, start_pos, evt.buffer) )
+            return;
+
+        // The server may send more once the content has been passed on, and
+        // the request is within its share of the bandwidth limit.
+        auto & hold = *window_hold_;
+        hold.withheld += size;
+
+        if ( fsm.BandwidthLimited(BandwidthLimiter::Direction::Download) )
+        {
+            hold.release = std::max(hold.release, fsm.BandwidthTransfer(
+                    BandwidthLimiter::Direction::Download)->Consume(size));
+        }
+
+        // Already waiting to open the window.
+        if ( fsm.get_transmission_delay_timer_enabled() )
+            return;
+
+        if ( hold.release <= sclock::now() )
+        {
+            OpenWindow(fsm, window_hold_);
+        }
+        else
+        {
+            // Nothing arrives while the window is shut, so no timeout.
+            fsm.ClearAsyncTimeout();
+            WaitToOpenWindow(fsm, window_hold_);
+        }
+    }
+
+    template <typename FSM>
+    void HandleClosed(Http2StreamClosedEvent const & evt, FSM & fsm)
+    {
+        if (evt.code)
+        {
+            std::stringstream ss;
+            ss << "Failure while reading content.";
+            ss << " Url: " << fsm.get_url();
+            ss << " Error: " << evt.description;
+            fsm.ProcessEvent(ErrorEvent{evt.code, ss.str()});
+        }
+        else if ( ! state_data_->decoder || FinishDecode(fsm, state_data_) )
+        {
+            fsm.ProcessEvent(ContentReadEvent{});
+        }
+    }
+
+private:
+    template <typename FSM>
+    static void OpenWindow(FSM & fsm, Http2WindowHoldPointer hold)
+    {
+        fsm.get_http2_stream()->Consumed(hold->withheld);
+        hold->withheld = 0;
+
+        // Restart the timeout, as content is still arriving.
+        fsm.SetAsyncTimeout("HTTP/2 response content",
+            fsm.get_timeout_seconds());
+    }
+
+    template <typename FSM>
+    static void WaitToOpenWindow(FSM & fsm, Http2WindowHoldPointer hold)
+    {
+        auto fsmp = fsm.AsFrontShared();
+
+        fsm.set_transmission_delay_timer_enabled(true);
+        fsm.get_transmission_delay_timer()->expires_at(hold->release);
+        fsm.get_transmission_delay_timer()->async_wait(
+            fsm.get_event_strand()->wrap(
+                [fsmp, hold](const boost::system::error_code & ec)
+                {
+                    fsmp->SetTransactionDelayTimerWrapper(
+                        [fsmp, hold]()
+                        {
+                            WaitToOpenWindowCallback(*fsmp, hold);
+                        },
+                        ec);
+                }));
+    }
+
+    template <typename FSM>
+    static void WaitToOpenWindowCallback(
+            FSM & fsm,
+            Http2WindowHoldPointer hold
+        )
+    {
+        // Stop processing if actions cancelled.
+        if ( hold->cancelled )
+            return;
+
+        // Ensure a cancellation doesn't mess up the state due to async
+        // timer.
+        if ( fsm.get_transmission_delay_timer_enabled() )
+        {
+            fsm.set_transmission_delay_timer_enabled(false);
+
+            // More content may have pushed the release back.
+            if ( hold->release <= sclock::now() )
+                OpenWindow(fsm, hold);
+            else
+                WaitToOpenWindow(fsm, hold);
+        }
+    }
+
+    ReadContentDataPointer state_data_;
+    Http2WindowHoldPointer window_hold_;
+    uint64_t received_;
+};
+
+// Actions
+struct Http2StreamClosedAction
+{
+    template <class Fsm, class Evt, class SourceState, class TargetState>
+    void operator()(Evt const & evt, Fsm & fsm, SourceState & state,
+        TargetState &)
+    {
+        state.HandleClosed(evt, fsm);
+    }
+};
+struct Http2DataAction
+{
+    template <class Fsm, class Evt, class SourceState, class TargetState>
+    void operator()(Evt const & evt, Fsm & fsm, SourceState & state,
+        TargetState &)
+    {
+        state.HandleData(evt, fsm);
+    }
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
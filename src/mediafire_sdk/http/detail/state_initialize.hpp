@@ -11,6 +11,7 @@
 #include "boost/msm/front/state_machine_def.hpp"
 
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/url.hpp"
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 
@@ -62,17 +63,56 @@ struct Initializing : public boost::msm::front::state<>
         if ( fsm.get_parsed_url()->scheme() == "http" )
         {
             fsm.set_is_ssl(false);
-
-            // Create non-SSL socket and wrapper.
-            fsm.set_socket_wrapper( std::make_shared<SocketWrapper>(
-                new asio::ip::tcp::socket(*fsm.get_work_io_service()) ));
-
-            fsm.ProcessEvent(InitializedEvent());
         }
         else if ( fsm.get_parsed_url()->scheme() == "https" )
         {
             fsm.set_is_ssl(true);
+        }
+        else
+        {
+            std::stringstream ss;
+            ss << "Unsupported scheme. Url: " << fsm.get_url();
+            fsm.ProcessEvent(ErrorEvent{
+                    make_error_code( http_error::InvalidUrl ),
+                    ss.str()
+                });
+            return;
+        }
+
+        // Send the request on an HTTP/2 connection to the host if there is
+        // one.  If one is being opened, wait for it and check again.
+        bool opening_http2 = false;
+        if ( fsm.Http2Allowed() && ! fsm.Http1OnlyHost() )
+        {
+            if ( auto session = fsm.AcquireHttp2Session() )
+            {
+                fsm.set_http2_session(session);
+
+                fsm.ProcessEvent(Http2SessionEvent());
+                return;
+            }
+            else if ( ! fsm.BeginHttp2Connect() )
+            {
+                return;
+            }
 
+            opening_http2 = true;
+        }
+
+        // Skip straight to sending the request if an idle keep-alive
+        // connection to the same host is available.
+        std::shared_ptr<SocketWrapper> socket_wrapper;
+        if ( ! opening_http2 )
+            socket_wrapper = fsm.AcquirePooledConnection();
+
+        if ( socket_wrapper )
+        {
+            fsm.set_socket_wrapper(socket_wrapper);
+
+            fsm.ProcessEvent(ReusedConnectionEvent());
+        }
+        else if ( fsm.get_is_ssl() )
+        {
             // Create the SSL socket and wrapper
             fsm.set_socket_wrapper( std::make_shared<SocketWrapper>(
                 new asio::ssl::stream<asio::ip::tcp::socket>(
@@ -82,18 +122,25 @@ struct Initializing : public boost::msm::front::state<>
         }
         else
         {
-            std::stringstream ss;
-            ss << "Unsupported scheme. Url: " << fsm.get_url();
-            fsm.ProcessEvent(ErrorEvent{
-                    make_error_code( http_error::InvalidUrl ),
-                    ss.str()
-                });
+            // Create non-SSL socket and wrapper.
+            fsm.set_socket_wrapper( std::make_shared<SocketWrapper>(
+                new asio::ip::tcp::socket(*fsm.get_work_io_service()) ));
+
+            fsm.ProcessEvent(InitializedEvent());
         }
     }
 
+    template <typename FSM>
+    void on_entry(StartEvent const&, FSM & fsm)
+    {
+        fsm.BeginPhase(RequestPhase::Total);
+        DoInit(fsm);
+    }
+
     template <typename Event, typename FSM>
     void on_entry(Event const&, FSM & fsm)
     {
+        fsm.ResetPhases();
         DoInit(fsm);
     }
 };
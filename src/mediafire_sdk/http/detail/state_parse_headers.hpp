@@ -7,11 +7,14 @@
 #pragma once
 
 #include <sstream>
+#include <string>
 
+#include "boost/algorithm/string/predicate.hpp"
 #include "boost/msm/front/state_machine_def.hpp"
 
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/headers.hpp"
 #include "mediafire_sdk/http/url.hpp"
 
@@ -19,6 +22,53 @@ namespace mf {
 namespace http {
 namespace detail {
 
+inline bool HasConnectionToken(
+        HeaderValue connection_header,
+        const char * token
+    )
+{
+    for (const HeaderValue & value : SplitHeaderTokens(connection_header))
+    {
+        if ( boost::iequals(value, token) )
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if the connection may be kept alive after the response.
+ */
+template <typename FSM>
+bool KeepAliveAllowed(
+        FSM & fsm,
+        const HeadersReadEvent & evt
+    )
+{
+    for ( const auto & pair : fsm.get_headers() )
+    {
+        if ( boost::iequals(pair.first, "connection")
+            && HasConnectionToken(boost::make_iterator_range(
+                    pair.second.data(),
+                    pair.second.data() + pair.second.size()),
+                "close") )
+        {
+            return false;
+        }
+    }
+
+    if ( auto connection = evt.headers.Find("connection") )
+    {
+        if ( HasConnectionToken(*connection, "close") )
+            return false;
+        else if ( HasConnectionToken(*connection, "keep-alive") )
+            return true;
+    }
+
+    // HTTP/1.1 connections are persistent unless stated otherwise.
+    return evt.http_version == "HTTP/1.1";
+}
+
 class ParseHeaders : public boost::msm::front::state<>
 {
 public:
@@ -27,13 +77,17 @@ public:
     {
         using mf::http::http_error;
 
-        if (evt.status_code == 301 || evt.status_code == 302)
+        fsm.EndPhase(RequestPhase::TimeToFirstByte);
+
+        const mf::http::Headers & headers = evt.headers;
+
+        if (headers.status_code == 301 || headers.status_code == 302)
         {
-            auto it = evt.headers.find("location");
-            if ( it == evt.headers.end() )
+            const auto location = headers.Find("location");
+            if ( ! location )
             {
                 std::stringstream ss;
-                ss << "Bad " << evt.status_code << " redirect.";
+                ss << "Bad " << headers.status_code << " redirect.";
                 ss << " Source URL: " << fsm.get_url();
                 ss << " Missing \"Location\" header";
                 fsm.ProcessEvent(ErrorEvent{
@@ -44,12 +98,12 @@ public:
             }
             else
             {
+                const std::string redirect_url(location->begin(),
+                    location->end());
+
                 try {
                     auto iface = fsm.get_callback();
-                    auto url = mf::http::Url(it->second);
-
-                    mf::http::Headers headers = { evt.raw_headers,
-                        evt.status_code, evt.status_message, evt.headers };
+                    auto url = mf::http::Url(redirect_url);
 
                     if ( fsm.get_callback_io_service() ==
                         fsm.get_work_io_service())
@@ -68,15 +122,15 @@ public:
                     }
 
                     RedirectEvent redirect(evt);
-                    redirect.redirect_url = it->second;
+                    redirect.redirect_url = redirect_url;
                     fsm.ProcessEvent(redirect);
                 }
                 catch(mf::http::InvalidUrl & err)
                 {
                     std::stringstream ss;
-                    ss << "Bad " << evt.status_code << " redirect.";
+                    ss << "Bad " << headers.status_code << " redirect.";
                     ss << " Source URL: " << fsm.get_url();
-                    ss << " Invalid redirect url: " << it->second;
+                    ss << " Invalid redirect url: " << redirect_url;
                     fsm.ProcessEvent(ErrorEvent{
                             make_error_code(
                                 http_error::InvalidRedirectUrl ),
@@ -87,9 +141,6 @@ public:
         }
         else
         {
-            mf::http::Headers headers = { evt.raw_headers, evt.status_code,
-                evt.status_message, evt.headers };
-
             auto iface = fsm.get_callback();
             if ( fsm.get_callback_io_service() == fsm.get_work_io_service())
             {
@@ -106,8 +157,10 @@ public:
 
             fsm.ProcessEvent(HeadersParsedEvent{
                 evt.content_length,
-                evt.headers,
-                evt.read_buffer
+                headers,
+                evt.read_buffer,
+                headers.status_code,
+                KeepAliveAllowed(fsm, evt)
                 });
         }
     }
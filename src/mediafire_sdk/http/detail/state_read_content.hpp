@@ -6,32 +6,35 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <sstream>
 #include <vector>
 
 #include "boost/algorithm/string/predicate.hpp"
-#include "boost/algorithm/string/split.hpp"
-#include "boost/algorithm/string/trim.hpp"
 #include "boost/asio.hpp"
 #include "boost/asio/ssl.hpp"
-#include "boost/iostreams/copy.hpp"
-#include "boost/iostreams/filter/gzip.hpp"
-#include "boost/iostreams/restrict.hpp"
 #include "boost/msm/front/state_machine_def.hpp"
 
+#include "mediafire_sdk/http/bandwidth_limiter.hpp"
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
 #include "mediafire_sdk/http/detail/encoding.hpp"
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
+#include "mediafire_sdk/http/detail/read_size_adapter.hpp"
 #include "mediafire_sdk/http/detail/timeouts.hpp"
 #include "mediafire_sdk/http/detail/types.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
+#include "mediafire_sdk/http/shared_buffer.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
 
 #include "mediafire_sdk/utils/string.hpp"
 
 namespace {
-static const uint64_t kMaxUnknownReadLength = 1024 * 8;
+/** Smallest content read, and the size of the first one. */
+static const uint64_t kMinContentReadSize = 1024 * 8;
 
 bool IsSslShortRead(const boost::system::error_code & ec)
 {
@@ -44,7 +47,7 @@ bool IsSslShortRead(const boost::system::error_code & ec)
 }
 
 int ParseTransferEncoding(
-        const std::map<std::string, std::string> & headers
+        const mf::http::Headers & headers
     )
 {
     using namespace mf::http::detail;
@@ -53,25 +56,16 @@ int ParseTransferEncoding(
 
     int ret = static_cast<int>(TE_None);
 
-    auto it = headers.find("content-length");
-    if ( it != headers.end() )
+    if ( headers.Find("content-length") )
         ret |= static_cast<int>(TE_ContentLength);
 
-    it = headers.find("transfer-encoding");
-    if ( it != headers.end() )
+    if ( auto value = headers.Find("transfer-encoding") )
     {
-        std::vector<std::string> tokens;
-        boost::split(tokens, it->second, boost::is_any_of(","));
-        std::for_each(std::begin(tokens), std::end(tokens),
-                [](std::string & v){
-                    boost::trim(v);
-                } );
-
-        for (const std::string & token : tokens)
+        for (const auto & token : mf::http::SplitHeaderTokens(*value))
         {
-            if ( token == "chunked" )
+            if ( boost::iequals(token, "chunked") )
                 ret |= static_cast<int>(TE_Chunked);
-            else if ( token == "gzip" )
+            else if ( boost::iequals(token, "gzip") )
                 ret |= static_cast<int>(TE_Gzip);
             else
                 ret |= static_cast<int>(TE_Unknown);
@@ -82,28 +76,23 @@ int ParseTransferEncoding(
 }
 
 int ParseContentEncoding(
-        const std::map<std::string, std::string> & headers
+        const mf::http::Headers & headers
     )
 {
     using namespace mf::http::detail;
 
     int ret = static_cast<int>(CE_None);
 
-    auto it = headers.find("content-encoding");
-
-    if ( it != headers.end() )
+    if ( auto value = headers.Find("content-encoding") )
     {
-        std::vector<std::string> tokens;
-        boost::split(tokens, it->second, boost::is_any_of(","));
-        std::for_each(std::begin(tokens), std::end(tokens),
-                [](std::string & v){
-                    boost::trim(v);
-                } );
-
-        for (const std::string & token : tokens)
+        for (const auto & token : mf::http::SplitHeaderTokens(*value))
         {
-            if ( token == "gzip" )
+            if ( boost::iequals(token, "gzip") )
                 ret |= static_cast<int>(CE_Gzip);
+            else if ( boost::iequals(token, "br") )
+                ret |= static_cast<int>(CE_Brotli);
+            else if ( boost::iequals(token, "zstd") )
+                ret |= static_cast<int>(CE_Zstd);
             else
                 ret |= static_cast<int>(CE_Unknown);
         }
@@ -112,58 +101,6 @@ int ParseContentEncoding(
     return ret;
 }
 
-class HttpRequestBuffer : public mf::http::BufferInterface
-{
-public:
-    HttpRequestBuffer(std::unique_ptr<uint8_t[]> buffer, uint64_t size) :
-        buffer_(std::move(buffer)),
-        size_(size)
-    {}
-    virtual ~HttpRequestBuffer() {}
-
-    virtual uint64_t Size() const
-    {
-        return size_;
-    }
-
-    /**
-     * @brief Get buffer
-     *
-     * @return pointer that can be read with data size contained in Size().
-     */
-    virtual const uint8_t * Data() const
-    {
-        return buffer_.get();
-    }
-private:
-    std::unique_ptr<uint8_t[]> buffer_;
-    uint64_t size_;
-};
-
-class VectorBuffer : public mf::http::BufferInterface
-{
-public:
-    VectorBuffer() {}
-    virtual ~VectorBuffer() {}
-
-    virtual uint64_t Size() const
-    {
-        return buffer.size();
-    }
-
-    /**
-     * @brief Get buffer
-     *
-     * @return pointer that can be read with data size contained in Size().
-     */
-    virtual const uint8_t * Data() const
-    {
-        return buffer.data();
-    }
-
-    std::vector<uint8_t> buffer;
-private:
-};
 }  // namespace
 
 namespace mf {
@@ -176,12 +113,14 @@ namespace detail {
  */
 struct ReadContentData
 {
-    ReadContentData() :
+    explicit ReadContentData(SharedBufferPool::Pointer pool) :
         cancelled(false),
         content_length(0),
-        filter_buf_consumed(0),
-        using_gzip(false),
-        using_content_length(false)
+        buffer_pool(std::move(pool)),
+        read_size(kMinContentReadSize, buffer_pool->BufferSize()),
+        decoded_size(0),
+        using_content_length(false),
+        keep_alive(false)
     {}
 
     bool cancelled;
@@ -190,34 +129,55 @@ struct ReadContentData
 
     SharedStreamBuf read_buffer;
 
-    asio::streambuf gzipped_buffer;
-    std::size_t filter_buf_consumed;
+    /** Content is received and decoded into buffers from here. */
+    SharedBufferPool::Pointer buffer_pool;
+
+    /** How much to wait for when reading content that is not chunked. */
+    ReadSizeAdapter read_size;
+
+    /** Decodes compressed content as it is read, if it is compressed. */
+    std::unique_ptr<ContentDecoderInterface> decoder;
+    uint64_t decoded_size;
 
-    bool using_gzip;
     bool using_content_length;
 
-    boost::iostreams::filtering_streambuf<boost::iostreams::input> filter_buf;
+    /** Server permits reusing the connection after the content is read. */
+    bool keep_alive;
 };
 using ReadContentDataPointer = std::shared_ptr<ReadContentData>;
 
 // -- Forward declarations -----------------------------------------------------
 template <typename FSM>
+void ReadContentPiece(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        const uint64_t total_read
+    );
+template <typename FSM>
 void HandleContentRead(
         FSM & fsm,
         ReadContentDataPointer state_data,
         RacePreventer race_preventer,
-        const std::size_t total_previously_read,
+        const uint64_t total_previously_read,
         const TimePoint start_time,
-        const std::size_t bytes_previously_transferred,
+        SharedBuffer::Pointer buffer,
         const std::size_t bytes_transferred,
         const boost::system::error_code& err
     );
 template <typename FSM>
+void HandleContentProgress(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        const uint64_t total_read,
+        const uint64_t bytes_transferred,
+        const TimePoint start_time,
+        const bool eof
+    );
+template <typename FSM>
 void HandleContentReadDelayCallback(
         FSM & fsm,
         ReadContentDataPointer state_data,
-        const uint64_t max_read_size,
-        const std::size_t total_read
+        const uint64_t total_read
     );
 template <typename FSM>
 void HandleContentChunkRead(
@@ -265,15 +225,211 @@ void HandleContentChunkSizeRead(
     );
 // -- END Forward declarations -------------------------------------------------
 
+/**
+ * @brief Decode compressed content and pass it on.
+ *
+ * @return False if an error event was sent.
+ */
+template <typename FSM>
+bool DecodeContent(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        const uint8_t * data,
+        const uint64_t size
+    )
+{
+    using mf::http::http_error;
+
+    auto iface = fsm.get_callback();
+    auto callback_io_service = fsm.get_callback_io_service();
+
+    const bool success = state_data->decoder->Decode(data, size,
+        [&state_data, &iface, &callback_io_service](
+                std::shared_ptr<mf::http::BufferInterface> return_buffer
+            )
+        {
+            const uint64_t start_pos = state_data->decoded_size;
+            state_data->decoded_size += return_buffer->Size();
+
+            callback_io_service->dispatch(
+                [iface, return_buffer, start_pos]()
+                {
+                    iface->ResponseContentReceived(
+                        start_pos, return_buffer );
+                });
+        });
+
+    if ( ! success )
+    {
+        std::stringstream ss;
+        ss << "Compression failure.";
+        ss << " Url: " << fsm.get_url();
+        ss << " Error: " << state_data->decoder->ErrorString();
+        fsm.ProcessEvent(
+            ErrorEvent{
+                make_error_code(
+                    http_error::CompressionFailure ),
+                ss.str()
+            });
+    }
+
+    return success;
+}
+
+/**
+ * @brief Pass received content on, decoding it first if it is compressed.
+ *
+ * @return False if an error event was sent.
+ */
+template <typename FSM>
+bool PassContent(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        const uint64_t start_pos,
+        SharedBuffer::Pointer buffer
+    )
+{
+    if ( state_data->decoder )
+        return DecodeContent(fsm, state_data, buffer->Data(), buffer->Size());
+
+    auto iface = fsm.get_callback();
+
+    fsm.get_callback_io_service()->dispatch(
+            [iface, buffer, start_pos]()
+            {
+                iface->ResponseContentReceived( start_pos, buffer );
+            }
+        );
+
+    return true;
+}
+
+/**
+ * @brief Pass content from the read buffer on and remove it from there.
+ *
+ * @return False if an error event was sent.
+ */
+template <typename FSM>
+bool PassBufferedContent(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        uint64_t start_pos,
+        uint64_t size
+    )
+{
+    auto & read_buffer = *state_data->read_buffer;
+    assert( read_buffer.size() >= size );
+
+    if ( state_data->decoder )
+    {
+        const bool success = DecodeContent(fsm, state_data,
+            asio::buffer_cast<const uint8_t*>(read_buffer.data()), size);
+
+        read_buffer.consume(size);
+
+        return success;
+    }
+
+    // Copied out in pieces no larger than the pooled buffers.
+    while ( size > 0 )
+    {
+        const uint64_t piece_size = std::min(size,
+            state_data->buffer_pool->BufferSize());
+
+        auto buffer = state_data->buffer_pool->Acquire(piece_size);
+        asio::buffer_copy(asio::buffer(buffer->Data(), piece_size),
+            read_buffer.data());
+        read_buffer.consume(piece_size);
+
+        PassContent(fsm, state_data, start_pos, std::move(buffer));
+
+        start_pos += piece_size;
+        size -= piece_size;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check that the compressed content ended properly.
+ *
+ * @return False if an error event was sent.
+ */
+template <typename FSM>
+bool FinishDecode(
+        FSM & fsm,
+        ReadContentDataPointer state_data
+    )
+{
+    using mf::http::http_error;
+
+    if ( state_data->decoder->Finish() )
+        return true;
+
+    std::stringstream ss;
+    ss << "Compression failure.";
+    ss << " Url: " << fsm.get_url();
+    ss << " Error: " << state_data->decoder->ErrorString();
+    fsm.ProcessEvent(
+        ErrorEvent{
+            make_error_code(
+                http_error::CompressionFailure ),
+            ss.str()
+        });
+
+    return false;
+}
+
+
+template <typename FSM>
+void ReadContentPiece(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        const uint64_t total_read
+    )
+{
+    // Read straight into a pooled buffer, which is passed on as is.  Waits
+    // for about as much as arrives in a short while at the current rate, but
+    // takes more if it is there already.
+    uint64_t buffer_size = state_data->buffer_pool->BufferSize();
+    uint64_t wait_size = state_data->read_size.ReadSize();
+    if ( state_data->using_content_length )
+    {
+        // Reading past the content would wait on a kept alive connection.
+        const uint64_t remaining = state_data->content_length - total_read;
+        buffer_size = std::min( buffer_size, remaining );
+        wait_size = std::min( wait_size, remaining );
+    }
+
+    auto buffer = state_data->buffer_pool->Acquire(buffer_size);
+
+    // Must prime timeout for async actions.
+    auto race_preventer = fsm.SetAsyncTimeout("read response content 2",
+        fsm.get_timeout_seconds());
+    auto fsmp = fsm.AsFrontShared();
+    auto start_time = sclock::now();
+
+    asio::async_read(*fsm.get_socket_wrapper(),
+        asio::buffer(buffer->Data(), buffer_size),
+        asio::transfer_at_least(wait_size),
+        [fsmp, state_data, race_preventer, total_read, start_time, buffer](
+                const boost::system::error_code& ec,
+                std::size_t bytes_transferred
+            )
+        {
+            HandleContentRead(*fsmp, state_data, race_preventer, total_read,
+                start_time, buffer, bytes_transferred, ec);
+        });
+}
 
 template <typename FSM>
 void HandleContentRead(
         FSM & fsm,
         ReadContentDataPointer state_data,
         RacePreventer race_preventer,
-        const std::size_t total_previously_read,
+        const uint64_t total_previously_read,
         const TimePoint start_time,
-        const std::size_t bytes_previously_transferred,
+        SharedBuffer::Pointer buffer,
         const std::size_t bytes_transferred,
         const boost::system::error_code& err
     )
@@ -286,15 +442,14 @@ void HandleContentRead(
     // Skip if cancelled due to timeout.
     if ( ! race_preventer.IsFirst() ) return;
 
-    const std::size_t bytes_to_process =
-        bytes_previously_transferred + bytes_transferred;
-
     fsm.ClearAsyncTimeout();  // Must stop timeout timer.
 
+    const TimePoint now = sclock::now();
+
     if (fsm.get_bw_analyser())
     {
-        fsm.get_bw_analyser()->RecordIncomingBytes(
-            bytes_previously_transferred, start_time, sclock::now() );
+        fsm.get_bw_analyser()->RecordIncomingBytes( bytes_transferred,
+            start_time, now );
     }
 
     bool eof = false;
@@ -311,144 +466,20 @@ void HandleContentRead(
 
     if ( !err || eof )
     {
-        bool read_complete = false;
+        state_data->read_size.Record( bytes_transferred, now - start_time );
 
-        const std::size_t total_read =
-            total_previously_read + bytes_to_process;
-
-        if ( ! state_data->using_gzip )
+        if ( bytes_transferred > 0 )
         {
-            // Non gzip buffer passing.
-            std::istream post_data_stream(state_data->read_buffer.get());
-            std::unique_ptr<uint8_t[]> data(new uint8_t[bytes_to_process]);
-            post_data_stream.read( reinterpret_cast<char*>(data.get()),
-                bytes_to_process );
-            std::shared_ptr<mf::http::BufferInterface> return_buffer(
-                    new HttpRequestBuffer(
-                        std::move(data),
-                        bytes_to_process )
-                    );
-
-            auto iface = fsm.get_callback();
-
-            fsm.get_callback_io_service()->dispatch(
-                    [iface, return_buffer, total_previously_read]()
-                    {
-                        iface->ResponseContentReceived(
-                            total_previously_read, return_buffer );
-                    }
-                );
-        }
+            buffer->Shrink(bytes_transferred);
 
-        // Also handle content-length.
-        if ( state_data->using_content_length )
-        {
-            if ( state_data->content_length == total_read )
-            {
-                read_complete = true;
-            }
-            else if ( state_data->content_length < total_read )
-            {
-                std::stringstream ss;
-                ss << "Failure while reading content.";
-                ss << " Url: " << fsm.get_url();
-                ss << " Error: Exceeded content length.";
-                ss << " Total read: " << total_read;
-                ss << " Content length: "
-                   << state_data->content_length;
-
-                fsm.ProcessEvent(
-                    ErrorEvent{
-                        make_error_code(
-                            http_error::ReadFailure ),
-                        ss.str()
-                    });
+            if ( ! PassContent(fsm, state_data, total_previously_read,
+                    std::move(buffer)) )
                 return;
-            }
-        }
-        else if ( eof )
-            read_complete = true;
-
-        if ( read_complete )
-        {
-            if ( state_data->using_gzip )
-            {
-                auto & filter_buffer = state_data->filter_buf;
-
-                filter_buffer.push( *state_data->read_buffer );
-
-                std::shared_ptr<VectorBuffer> return_buffer(
-                        new VectorBuffer() );
-
-                try {
-                    boost::iostreams::copy(
-                            filter_buffer,
-                            std::back_inserter(return_buffer->buffer));
-                }
-                catch( std::exception & err )
-                {
-                    std::stringstream ss;
-                    ss << "Compression failure.";
-                    ss << " Error: " << err.what();
-                    fsm.ProcessEvent(
-                        ErrorEvent{
-                            make_error_code(
-                                http_error::ReadFailure ),
-                            ss.str()
-                        });
-                    //assert(!"GZip compression error from content");
-                    return;
-                }
-
-                auto iface = fsm.get_callback();
-                const uint64_t start_pos = state_data->filter_buf_consumed;
-
-                fsm.get_callback_io_service()->dispatch(
-                        [iface, return_buffer, start_pos]()
-                        {
-                            iface->ResponseContentReceived(
-                                start_pos, return_buffer );
-                        }
-                    );
-
-                // New byte counts
-                state_data->filter_buf_consumed += return_buffer->buffer.size();
-            }
-
-            fsm.ProcessEvent(ContentReadEvent{});
         }
-        else
-        {
-            uint64_t max_read_size = kMaxUnknownReadLength;
-            if ( state_data->using_content_length )
-            {
-                max_read_size = std::min(
-                        state_data->content_length - total_read,
-                        kMaxUnknownReadLength
-                    );
-            }
-
-            auto fsmp = fsm.AsFrontShared();
 
-            // Delay behavior:
-            fsm.SetTransactionDelayTimer( start_time, sclock::now() );
-
-            fsm.get_transmission_delay_timer()->async_wait(
-                fsm.get_event_strand()->wrap(
-                    [fsmp, state_data, max_read_size, total_read](
-                            const boost::system::error_code& ec
-                        )
-                    {
-                        fsmp->SetTransactionDelayTimerWrapper(
-                            [fsmp, state_data, max_read_size, total_read]()
-                            {
-                                HandleContentReadDelayCallback( *fsmp,
-                                    state_data, max_read_size, total_read);
-                            },
-                            ec
-                            );
-                    }));
-        }
+        HandleContentProgress(fsm, state_data,
+            total_previously_read + bytes_transferred, bytes_transferred,
+            start_time, eof);
     }
     else
     {
@@ -465,12 +496,109 @@ void HandleContentRead(
     }
 }
 
+template <typename FSM>
+void HandleContentProgress(
+        FSM & fsm,
+        ReadContentDataPointer state_data,
+        const uint64_t total_read,
+        const uint64_t bytes_transferred,
+        const TimePoint start_time,
+        const bool eof
+    )
+{
+    using mf::http::http_error;
+
+    bool read_complete = false;
+
+    // Also handle content-length.
+    if ( state_data->using_content_length )
+    {
+        if ( state_data->content_length == total_read )
+        {
+            read_complete = true;
+        }
+        else if ( state_data->content_length < total_read )
+        {
+            std::stringstream ss;
+            ss << "Failure while reading content.";
+            ss << " Url: " << fsm.get_url();
+            ss << " Error: Exceeded content length.";
+            ss << " Total read: " << total_read;
+            ss << " Content length: "
+               << state_data->content_length;
+
+            fsm.ProcessEvent(
+                ErrorEvent{
+                    make_error_code(
+                        http_error::ReadFailure ),
+                    ss.str()
+                });
+            return;
+        }
+        else if ( eof )
+        {
+            std::stringstream ss;
+            ss << "Failure while reading content.";
+            ss << " Url: " << fsm.get_url();
+            ss << " Error: Connection closed before end of content.";
+            ss << " Total read: " << total_read;
+            ss << " Content length: "
+               << state_data->content_length;
+
+            fsm.ProcessEvent(
+                ErrorEvent{
+                    make_error_code(
+                        http_error::ReadFailure ),
+                    ss.str()
+                });
+            return;
+        }
+    }
+    else if ( eof )
+        read_complete = true;
+
+    if ( read_complete )
+    {
+        if ( state_data->decoder && ! FinishDecode(fsm, state_data) )
+            return;
+
+        // Content delimited by closing the connection can not be reused.
+        fsm.set_connection_reusable( state_data->keep_alive
+            && state_data->using_content_length && ! eof );
+
+        fsm.ProcessEvent(ContentReadEvent{});
+    }
+    else
+    {
+        auto fsmp = fsm.AsFrontShared();
+
+        // Delay behavior:
+        fsm.SetTransactionDelayTimer( start_time, sclock::now(),
+            BandwidthLimiter::Direction::Download, bytes_transferred );
+
+        fsm.get_transmission_delay_timer()->async_wait(
+            fsm.get_event_strand()->wrap(
+                [fsmp, state_data, total_read](
+                        const boost::system::error_code& ec
+                    )
+                {
+                    fsmp->SetTransactionDelayTimerWrapper(
+                        [fsmp, state_data, total_read]()
+                        {
+                            HandleContentReadDelayCallback( *fsmp,
+                                state_data, total_read);
+                        },
+                        ec
+                        );
+                }));
+    }
+}
+
 template <typename FSM>
 void HandleContentReadDelayCallback(
         FSM & fsm,
         ReadContentDataPointer state_data,
-        const uint64_t max_read_size,
-        const std::size_t total_read
+        const uint64_t total_read
     )
 {
     // Stop processing if actions cancelled.
@@ -483,22 +611,7 @@ void HandleContentReadDelayCallback(
     {
         fsm.set_transmission_delay_timer_enabled(false);
 
-        // Must prime timeout for async actions.
-        auto race_preventer = fsm.SetAsyncTimeout("read response content 5",
-            fsm.get_timeout_seconds());
-        auto fsmp = fsm.AsFrontShared();
-        auto start_time = sclock::now();
-
-        asio::async_read(*fsm.get_socket_wrapper(), *state_data->read_buffer,
-            asio::transfer_exactly(max_read_size),
-            [fsmp, state_data, race_preventer, total_read, start_time](
-                    const boost::system::error_code& ec,
-                    std::size_t bytes_transferred
-                )
-            {
-                HandleContentRead(*fsmp, state_data, race_preventer, total_read,
-                    start_time, 0, bytes_transferred, ec);
-            });
+        ReadContentPiece(fsm, state_data, total_read);
     }
 }
 
@@ -547,41 +660,12 @@ void HandleContentChunkRead(
 
     if ( !err || eof )
     {
-        if ( state_data->using_gzip )
-        {
-            boost::iostreams::copy(
-                    boost::iostreams::restrict(
-                        *state_data->read_buffer, 0, chunk_size ),
-                    state_data->gzipped_buffer );
-
-            output_bytes_consumed += chunk_size;
-        }
-        else
-        {
-            // Non gzip buffer passing.
-            std::istream post_data_stream(state_data->read_buffer.get());
-            std::unique_ptr<uint8_t[]> data( new uint8_t[chunk_size] );
-            post_data_stream.read( reinterpret_cast<char*>(data.get()),
-                chunk_size );
-
-            std::shared_ptr<mf::http::BufferInterface> return_buffer(
-                    new HttpRequestBuffer(
-                        std::move(data),
-                        chunk_size )
-                    );
-            auto iface = fsm.get_callback();
-            const auto start_pos = output_bytes_consumed;
-            fsm.get_callback_io_service()->dispatch(
-                    [iface, return_buffer, start_pos]()
-                    {
-                        iface->ResponseContentReceived(
-                            start_pos, return_buffer );
-                    }
-                    );
+        if ( ! PassBufferedContent(fsm, state_data, output_bytes_consumed,
+                chunk_size) )
+            return;
 
-            // New byte counts
-            output_bytes_consumed += chunk_size;
-        }
+        // New byte counts
+        output_bytes_consumed += chunk_size;
 
         state_data->read_buffer->consume( 2 );  // +2 for \r\n after chunk.
 
@@ -684,10 +768,12 @@ void HandleNextChunk(
     else
         left_to_read -= state_data->read_buffer->size();
 
-    // Delay behavior:
+    // Delay behavior.  The chunk about to be read is counted against the
+    // bandwidth limit up front, as it is read in one go.
     auto total_duration = AsDuration(content_chunk_read_duration +
         (now - start_time));
-    fsm.SetTransactionDelayTimer( now, total_duration );
+    fsm.SetTransactionDelayTimer( now, total_duration,
+        BandwidthLimiter::Direction::Download, chunk_size + 2 );
 
     auto fsmp = fsm.AsFrontShared();
 
@@ -720,82 +806,19 @@ void HandleCompleteAllChunks(
     if (state_data->cancelled == true)
         return;
 
-    if ( state_data->using_gzip )
-    {
-        std::shared_ptr<VectorBuffer> return_buffer(
-            new VectorBuffer() );
-
-        auto & filter_buffer = state_data->filter_buf;
-
-        filter_buffer.push( state_data->gzipped_buffer );
-
-        try {
-            boost::iostreams::copy(
-                filter_buffer,
-                std::back_inserter(return_buffer->buffer));
-        }
-        catch( boost::iostreams::gzip_error & err )
-        {
-            std::stringstream ss;
-            ss << "Compression failure.";
-            ss << " Error: " << err.what();
-            switch (err.error())
-            {
-                case boost::iostreams::gzip::zlib_error:
-                    ss << " GZip error: zlib_error";
-                    break;
-                case boost::iostreams::gzip::bad_crc:
-                    ss << " GZip error: bad_crc";
-                    break;
-                case boost::iostreams::gzip::bad_length:
-                    ss << " GZip error: bad_length";
-                    break;
-                case boost::iostreams::gzip::bad_header:
-                    ss << " GZip error: bad_header";
-                    break;
-                case boost::iostreams::gzip::bad_footer:
-                    ss << " GZip error: bad_footer";
-                    break;
-                default:
-                    ss << " GZip error: " << err.error();
-                    break;
-            }
-            ss << " Zlib error: " << err.zlib_error_code();
-            fsm.ProcessEvent(ErrorEvent{
-                make_error_code(
-                    http_error::CompressionFailure ),
-                ss.str()
-                });
-            return;
-        }
-        catch( std::exception & err )
-        {
-            std::stringstream ss;
-            ss << "Compression failure.";
-            ss << " Error: " << err.what();
-            fsm.ProcessEvent(ErrorEvent{
-                make_error_code(
-                    http_error::CompressionFailure ),
-                ss.str()
-                });
-            //assert(!"GZip compression error from chunks");
-            return;
-        }
-
-        auto iface = fsm.get_callback();
-
-        const uint64_t start_pos = state_data->filter_buf_consumed;
-        fsm.get_callback_io_service()->dispatch(
-            [iface, return_buffer, start_pos]()
-            {
-                iface->ResponseContentReceived(
-                    start_pos, return_buffer );
-            }
-        );
+    if ( state_data->decoder && ! FinishDecode(fsm, state_data) )
+        return;
 
-        // New byte counts
-        state_data->filter_buf_consumed += return_buffer->buffer.size();
+    // The last chunk is followed by an empty line. Trailers are not parsed, so
+    // only reuse the connection if exactly that line remains.
+    bool reusable = false;
+    if ( state_data->keep_alive && state_data->read_buffer->size() == 2 )
+    {
+        auto bufs = state_data->read_buffer->data();
+        reusable = std::string(asio::buffers_begin(bufs),
+            asio::buffers_end(bufs)) == "\r\n";
     }
+    fsm.set_connection_reusable(reusable);
 
     fsm.ProcessEvent(ContentReadEvent{});
 }
@@ -902,18 +925,34 @@ public:
     {
         using mf::http::http_error;
 
-        auto state_data = std::make_shared<ReadContentData>();
+        fsm.BeginPhase(RequestPhase::Transfer);
+
+        auto state_data = std::make_shared<ReadContentData>(
+            fsm.get_receive_buffer_pool());
         state_data_ = state_data;
 
+        state_data->keep_alive = evt.keep_alive;
+
+        // Some responses never have a body, regardless of the headers.
+        if ( evt.status_code == 204 || evt.status_code == 304
+            || fsm.get_request_method() == "HEAD" )
+        {
+            fsm.set_connection_reusable( state_data->keep_alive
+                && evt.read_buffer->size() == 0 );
+
+            fsm.ProcessEvent(ContentReadEvent{});
+            return;
+        }
+
         const auto & headers = evt.headers;
 
         // Encodings!
         const int transfer_encoding = ParseTransferEncoding(headers);
-        const int content_encoding = ParseContentEncoding(headers);
+        int content_encoding = ParseContentEncoding(headers);
 
         // gzip can be in transfer-encoding or content-encoding...
-        if (transfer_encoding & TE_Gzip || content_encoding & CE_Gzip)
-            state_data->using_gzip = true;
+        if (transfer_encoding & TE_Gzip)
+            content_encoding |= static_cast<int>(CE_Gzip);
 
         if ( transfer_encoding & TE_ContentLength )
             state_data->using_content_length = true;
@@ -922,9 +961,8 @@ public:
         {
             std::stringstream ss;
             ss << "Unsupported transfer-encoding.";
-            auto it = headers.find("transfer-encoding");
-            if ( it != headers.end() )
-                ss << " Transfer-Encoding: " << it->second;
+            if ( auto value = headers.Find("transfer-encoding") )
+                ss << " Transfer-Encoding: " << *value;
             fsm.ProcessEvent(ErrorEvent{
                     make_error_code(
                         http_error::UnsupportedEncoding ),
@@ -937,9 +975,8 @@ public:
         {
             std::stringstream ss;
             ss << "Unsupported content-encoding.";
-            auto it = headers.find("content-encoding");
-            if ( it != headers.end() )
-                ss << " Content-Encoding: " << it->second;
+            if ( auto value = headers.Find("content-encoding") )
+                ss << " Content-Encoding: " << *value;
             fsm.ProcessEvent(ErrorEvent{
                     make_error_code(
                         http_error::UnsupportedEncoding ),
@@ -948,18 +985,39 @@ public:
             return;
         }
 
+        if ( content_encoding != CE_None )
+        {
+            state_data->decoder = CreateContentDecoder(content_encoding,
+                state_data->buffer_pool);
+
+            // Not built in, or more than one coding.
+            if ( ! state_data->decoder )
+            {
+                std::stringstream ss;
+                ss << "Unsupported content-encoding.";
+                if ( auto value = headers.Find("content-encoding") )
+                    ss << " Content-Encoding: " << *value;
+                if ( auto value = headers.Find("transfer-encoding") )
+                    ss << " Transfer-Encoding: " << *value;
+                fsm.ProcessEvent(ErrorEvent{
+                        make_error_code(
+                            http_error::UnsupportedEncoding ),
+                        ss.str()
+                    });
+                return;
+            }
+        }
+
         if ( transfer_encoding & TE_Chunked
             && state_data->using_content_length )
         {
             std::stringstream ss;
             ss << "Unable to handle chunked encoding and content length.";
             ss << " Violates RFC 2616, Section 4.4";
-            auto it = headers.find("content-encoding");
-            if ( it != headers.end() )
-                ss << " Content-Encoding: " << it->second;
-            it = headers.find("content-length");
-            if ( it != headers.end() )
-                ss << " Content-Length: " << it->second;
+            if ( auto value = headers.Find("content-encoding") )
+                ss << " Content-Encoding: " << *value;
+            if ( auto value = headers.Find("content-length") )
+                ss << " Content-Length: " << *value;
             fsm.ProcessEvent(ErrorEvent{
                     make_error_code(
                         http_error::UnsupportedEncoding ),
@@ -975,11 +1033,6 @@ public:
         // read buffer.
         state_data->read_buffer = evt.read_buffer;
 
-        if ( state_data->using_gzip )
-        {
-            state_data->filter_buf.push(boost::iostreams::gzip_decompressor());
-        }
-
         auto fsmp = fsm.AsFrontShared();
         auto start_time = sclock::now();
 
@@ -1003,33 +1056,17 @@ public:
         }
         else
         {
-            uint64_t max_read_size = kMaxUnknownReadLength;
-            if ( state_data->using_content_length )
-            {
-                max_read_size = std::min(
-                    state_data->content_length,
-                    kMaxUnknownReadLength );
-            }
+            // Content may have arrived with the headers.
+            const uint64_t previously_transferred =
+                state_data->read_buffer->size();
 
-            // Must prime timeout for async actions.
-            auto race_preventer = fsm.SetAsyncTimeout("read response content 2",
-                fsm.get_timeout_seconds());
-            const auto previously_transferred = state_data->read_buffer->size();
-
-            boost::asio::async_read(
-                *fsm.get_socket_wrapper(),
-                *state_data->read_buffer,
-                boost::asio::transfer_exactly(max_read_size),
-                [fsmp, state_data, race_preventer, start_time,
-                    previously_transferred](
-                        const boost::system::error_code& ec,
-                        std::size_t bytes_transferred
-                    )
-                {
-                    HandleContentRead(*fsmp, state_data, race_preventer, 0,
-                        start_time, previously_transferred, bytes_transferred,
-                        ec);
-                });
+            if ( previously_transferred > 0
+                && ! PassBufferedContent(fsm, state_data, 0,
+                    previously_transferred) )
+                return;
+
+            HandleContentProgress(fsm, state_data, previously_transferred,
+                previously_transferred, start_time, false);
         }
     }
 
@@ -7,14 +7,17 @@
 #pragma once
 
 #include <chrono>
+#include <string>
+#include <utility>
 
-#include "boost/algorithm/string/trim.hpp"
+#include "boost/lexical_cast.hpp"
 #include "boost/msm/front/state_machine_def.hpp"
 
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
 #include "mediafire_sdk/http/detail/types.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 
 namespace mf {
 namespace http {
@@ -61,30 +64,22 @@ void HandleHeaderRead(
 
     if (!err)
     {
-        HeadersReadEvent evt;
-        {
-            // Copy headers.
+        // The connection is known to be good once a response arrives.
+        fsm.set_connection_reused(false);
 
-            asio::streambuf::const_buffers_type bufs =
-                read_buffer->data();
+        HeadersReadEvent evt;
 
-            evt.raw_headers = std::string(
-                    asio::buffers_begin(bufs),
-                    ( asio::buffers_begin(bufs)
-                        + bytes_transferred )
-                );
-        }
+        // Take the headers out of the buffer in one piece.  The fields are
+        // parsed in place.
+        std::string raw_headers(bytes_transferred, '\0');
+        asio::buffer_copy(asio::buffer(&raw_headers[0], bytes_transferred),
+            read_buffer->data());
+        read_buffer->consume(bytes_transferred);
 
         // Pass the buffer incase it contains any unread data.
         evt.read_buffer = read_buffer;
 
-        std::istream response_stream(read_buffer.get());
-        response_stream >> evt.http_version;
-        response_stream >> evt.status_code;
-        std::getline(response_stream, evt.status_message);
-
-        if ( ! response_stream
-                || evt.http_version.substr(0, 5) != "HTTP/")
+        if ( ! evt.headers.Parse(std::move(raw_headers), &evt.http_version) )
         {
             std::stringstream ss;
             ss << "Protocol error while parsing headers("
@@ -98,86 +93,25 @@ void HandleHeaderRead(
             return;
         }
 
-        std::string line;
-        std::string last_header_name;
-        while (std::getline(response_stream, line) && line != "\r")
+        if ( auto content_length = evt.headers.Find("content-length") )
         {
-            boost::trim_right(line);
-
-            if ( line.empty() ) continue;
-
-            // HTTP headers can be split up inbetween lines.
-            // http://www.w3.org/Protocols/rfc2616/rfc2616-sec2.html#sec2.2
-            if ( line[0] == ' ' || line[0] == '\t' )
-            {
-                if ( last_header_name.empty() )
-                {
-                    std::stringstream ss;
-                    ss << "Failure while reading headers url("
-                        << fsm.get_url() << ").";
-                    ss << " Badly formatted headers.";
-                    fsm.ProcessEvent(
-                        ErrorEvent{
-                            make_error_code(
-                                http_error::UnparsableHeaders ),
-                            ss.str()
-                        });
-                    return;
-                }
-
-                // This is a continuation of previous line.
-                auto it = evt.headers.find(last_header_name);
-                it->second += " ";
-                boost::trim(line);
-                it->second += line;
-
-                continue;
-            }
-
-            boost::iterator_range<std::string::iterator> result =
-                boost::find_first(line, ":");
-
-            if ( ! result.empty() )
-            {
-                std::string header_name = std::string(
-                        line.begin(), result.begin());
-
-                std::string header_value = std::string(
-                        result.end(), line.end());
-
-                boost::trim(header_name);
-                boost::to_lower(header_name);
-
-                boost::trim(header_value);
-
-                evt.headers.emplace(header_name, header_value);
-
-                // Record the last header name in case the next line is
-                // extended.
-                last_header_name.swap(header_name);
-            }
-        }
-
-        {
-            auto it = evt.headers.find("content-length");
-            if ( it != evt.headers.end() )
-            {
-                try {
-                    evt.content_length = boost::lexical_cast<uint64_t>(
-                            it->second);
-                } catch(boost::bad_lexical_cast &) {
-                    std::stringstream ss;
-                    ss << "Failure while parsing headers url("
-                        << fsm.get_url() << ").";
-                    ss << " Invalid Content-Length: " << it->second;
-                    fsm.ProcessEvent(
-                        ErrorEvent{
-                            make_error_code(
-                                http_error::UnparsableHeaders ),
-                            ss.str()
-                        });
-                    return;
-                }
+            const std::string value(content_length->begin(),
+                content_length->end());
+
+            try {
+                evt.content_length = boost::lexical_cast<uint64_t>(value);
+            } catch(boost::bad_lexical_cast &) {
+                std::stringstream ss;
+                ss << "Failure while parsing headers url("
+                    << fsm.get_url() << ").";
+                ss << " Invalid Content-Length: " << value;
+                fsm.ProcessEvent(
+                    ErrorEvent{
+                        make_error_code(
+                            http_error::UnparsableHeaders ),
+                        ss.str()
+                    });
+                return;
             }
         }
 
@@ -203,6 +137,9 @@ public:
     template <typename Event, typename FSM>
     void on_entry(Event const &, FSM & fsm)
     {
+        fsm.EndPhase(RequestPhase::Send);
+        fsm.BeginPhase(RequestPhase::TimeToFirstByte);
+
         auto state_data = std::make_shared<ReadHeadersData>();
         state_data_ = state_data;
 
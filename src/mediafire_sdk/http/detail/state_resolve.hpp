@@ -16,6 +16,7 @@
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
 #include "mediafire_sdk/http/detail/timeouts.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/url.hpp"
 
 namespace mf {
@@ -25,15 +26,11 @@ namespace detail {
 class ResolveData
 {
 public:
-    ResolveData(
-            boost::asio::io_service * io_service
-        ) :
-        cancelled(false),
-        resolver(*io_service)
+    ResolveData() :
+        cancelled(false)
     {}
 
     bool cancelled;
-    asio::ip::tcp::resolver resolver;
 };
 using ResolveDataPointer = std::shared_ptr<ResolveData>;
 
@@ -88,7 +85,9 @@ public:
     template <typename Event, typename FSM>
     void on_entry(Event const&, FSM & fsm)
     {
-        auto state_data = std::make_shared<ResolveData>(fsm.get_work_io_service());
+        fsm.BeginPhase(RequestPhase::Dns);
+
+        auto state_data = std::make_shared<ResolveData>();
         state_data_ = state_data;
 
         const Url * url = fsm.get_parsed_url();
@@ -115,9 +114,12 @@ public:
         std::cout << "Attempting name resolution: " << host << std::endl;
 #endif
 
-        asio::ip::tcp::resolver::query query(host, port);
-        state_data->resolver.async_resolve(
-            query,
+        // Lookups are shared with other requests using the same
+        // configuration.
+        fsm.get_resolver_cache()->AsyncResolve(
+            fsm.get_work_io_service(),
+            host,
+            port,
             [fsmp, state_data, race_preventer](
                     const boost::system::error_code& ec,
                     boost::asio::ip::tcp::resolver::iterator iterator
@@ -16,6 +16,7 @@
 #include "boost/msm/front/state_machine_def.hpp"
 
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/url.hpp"
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
@@ -58,6 +59,10 @@ void HandleHeaderWrite(
 
     fsm.ClearAsyncTimeout();  // Must stop timeout timer.
 
+    // Even a failed write may have sent part of the request.
+    if (bytes_transferred > 0)
+        fsm.set_request_sent(true);
+
     if (fsm.get_bw_analyser())
     {
         fsm.get_bw_analyser()->RecordOutgoingBytes( bytes_transferred, start_time,
@@ -88,6 +93,11 @@ public:
     template <typename Event, typename FSM>
     void on_entry(Event const & evt, FSM & fsm)
     {
+        // Neither is underway if a pooled connection was reused.
+        fsm.EndPhase(RequestPhase::Connect);
+        fsm.EndPhase(RequestPhase::Tls);
+        fsm.BeginPhase(RequestPhase::Send);
+
         auto state_data = std::make_shared<SendHeaderData>();
         state_data_ = state_data;
 
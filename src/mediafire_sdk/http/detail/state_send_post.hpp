@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <sstream>
@@ -13,8 +14,10 @@
 #include "boost/asio.hpp"
 #include "boost/msm/front/state_machine_def.hpp"
 
+#include "mediafire_sdk/http/bandwidth_limiter.hpp"
 #include "mediafire_sdk/http/detail/http_request_events.hpp"
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
+#include "mediafire_sdk/http/detail/send_file.hpp"
 #include "mediafire_sdk/http/detail/types.hpp"
 #include "mediafire_sdk/http/error.hpp"
 
@@ -30,16 +33,36 @@ public:
         ) :
         cancelled(false),
         post_interface_size(post_interface_size),
-        bytes_read_from_interface(0)
+        bytes_read_from_interface(0),
+        send_file(false),
+        file_descriptor(-1),
+        file_offset(0),
+        post_buffer_sent(0)
     {}
 
     bool cancelled;
 
     const uint64_t post_interface_size;
     uint64_t bytes_read_from_interface;
+
+    // Set when the POST data is sent from a file with sendfile.
+    bool send_file;
+    int file_descriptor;
+    uint64_t file_offset;
+
+    // Set when POST data from a buffer is sent in pieces, so the bandwidth
+    // limit can be applied between them.
+    mf::http::SharedBuffer::Pointer post_buffer;
+    uint64_t post_buffer_sent;
 };
 using SendPostDataPointer = std::shared_ptr<SendPostData>;
 
+/** Most bytes sent by one sendfile write, so delays can be applied between. */
+const uint64_t kSendFileChunkSize = 256 * 1024;
+
+/** Most bytes of a POST buffer sent by one write while uploads are limited. */
+const uint64_t kLimitedPostPieceSize = 64 * 1024;
+
 template <typename FSM>
 void PostViaInterfaceDelayCallback(
         FSM & fsm,
@@ -83,7 +106,8 @@ void PostViaInterface(
         FSM & fsm,
         SendPostDataPointer state_data,
         TimePoint last_write_start,
-        TimePoint last_write_end
+        TimePoint last_write_end,
+        uint64_t last_write_size
     )
 {
     using mf::http::http_error;
@@ -142,7 +166,8 @@ void PostViaInterface(
         auto fsmp = fsm.AsFrontShared();
 
         // Delay behavior:
-        fsm.SetTransactionDelayTimer( last_write_start, last_write_end );
+        fsm.SetTransactionDelayTimer( last_write_start, last_write_end,
+            BandwidthLimiter::Direction::Upload, last_write_size );
         std::function<void()> strand_wrapped(
             [fsmp, state_data, post_data]()
             {
@@ -160,6 +185,182 @@ void PostViaInterface(
     }
 }
 
+template <typename FSM>
+void PostViaSendFileDelayCallback(
+        FSM & fsm,
+        SendPostDataPointer state_data,
+        std::size_t chunk_size
+    )
+{
+    // Stop processing if actions cancelled.
+    if (state_data->cancelled == true)
+        return;
+
+    // Ensure a cancellation doesn't mess up the state due to async
+    // timer.
+    if ( fsm.get_transmission_delay_timer_enabled() )
+    {
+        fsm.set_transmission_delay_timer_enabled(false);
+
+        // Must prime timeout for async actions.
+        auto race_preventer = fsm.SetAsyncTimeout("write request post",
+            fsm.get_timeout_seconds());
+        auto fsmp = fsm.AsFrontShared();
+        auto start_time = sclock::now();
+
+        AsyncSendFile(
+            fsm.get_socket_wrapper()->Socket(),
+            state_data->file_descriptor,
+            state_data->file_offset + state_data->bytes_read_from_interface,
+            chunk_size,
+            [fsmp, race_preventer, start_time, state_data, chunk_size](
+                   const boost::system::error_code& ec,
+                   std::size_t bytes_transferred
+                )
+            {
+                if ( ! ec )
+                    state_data->bytes_read_from_interface += chunk_size;
+
+                HandlePostWrite(*fsmp, state_data, race_preventer, start_time,
+                    bytes_transferred, ec);
+            });
+    }
+}
+
+template <typename FSM>
+void PostViaSendFile(
+        FSM & fsm,
+        SendPostDataPointer state_data,
+        TimePoint last_write_start,
+        TimePoint last_write_end,
+        uint64_t last_write_size
+    )
+{
+    // Stop processing if actions cancelled.
+    if (state_data->cancelled == true)
+        return;
+
+    const uint64_t remaining = state_data->post_interface_size
+        - state_data->bytes_read_from_interface;
+
+    if (remaining == 0)
+    {
+        fsm.ProcessEvent(PostSent{});
+        return;
+    }
+
+    const auto chunk_size = static_cast<std::size_t>(
+        std::min(remaining, kSendFileChunkSize));
+
+    auto fsmp = fsm.AsFrontShared();
+
+    // Delay behavior:
+    fsm.SetTransactionDelayTimer( last_write_start, last_write_end,
+        BandwidthLimiter::Direction::Upload, last_write_size );
+    std::function<void()> strand_wrapped(
+        [fsmp, state_data, chunk_size]()
+        {
+            PostViaSendFileDelayCallback(*fsmp, state_data, chunk_size);
+        });
+
+    fsm.get_transmission_delay_timer()->async_wait(
+        fsm.get_event_strand()->wrap(
+            [fsmp, strand_wrapped](
+                   const boost::system::error_code& ec
+                )
+            {
+                fsmp->SetTransactionDelayTimerWrapper(strand_wrapped, ec);
+            }));
+}
+
+template <typename FSM>
+void PostViaBufferDelayCallback(
+        FSM & fsm,
+        SendPostDataPointer state_data,
+        std::size_t piece_size
+    )
+{
+    // Stop processing if actions cancelled.
+    if (state_data->cancelled == true)
+        return;
+
+    // Ensure a cancellation doesn't mess up the state due to async
+    // timer.
+    if ( fsm.get_transmission_delay_timer_enabled() )
+    {
+        fsm.set_transmission_delay_timer_enabled(false);
+
+        // Must prime timeout for async actions.
+        auto race_preventer = fsm.SetAsyncTimeout("write request post",
+            fsm.get_timeout_seconds());
+        auto fsmp = fsm.AsFrontShared();
+        auto start_time = sclock::now();
+        auto post_buffer = state_data->post_buffer;
+
+        asio::async_write(
+            *fsm.get_socket_wrapper(),
+            asio::buffer(post_buffer->Data() + state_data->post_buffer_sent,
+                piece_size),
+            [fsmp, race_preventer, start_time, state_data, post_buffer](
+                   const boost::system::error_code& ec,
+                   std::size_t bytes_transferred
+                )
+            {
+                // post_buffer passed in to prevent it from being freed
+                state_data->post_buffer_sent += bytes_transferred;
+
+                HandlePostWrite(*fsmp, state_data, race_preventer, start_time,
+                    bytes_transferred, ec);
+            });
+    }
+}
+
+template <typename FSM>
+void PostViaBuffer(
+        FSM & fsm,
+        SendPostDataPointer state_data,
+        TimePoint last_write_start,
+        TimePoint last_write_end,
+        uint64_t last_write_size
+    )
+{
+    // Stop processing if actions cancelled.
+    if (state_data->cancelled == true)
+        return;
+
+    const uint64_t remaining = state_data->post_buffer->Size()
+        - state_data->post_buffer_sent;
+
+    if (remaining == 0)
+    {
+        fsm.ProcessEvent(PostSent{});
+        return;
+    }
+
+    const auto piece_size = static_cast<std::size_t>(
+        std::min(remaining, kLimitedPostPieceSize));
+
+    auto fsmp = fsm.AsFrontShared();
+
+    // Delay behavior:
+    fsm.SetTransactionDelayTimer( last_write_start, last_write_end,
+        BandwidthLimiter::Direction::Upload, last_write_size );
+    std::function<void()> strand_wrapped(
+        [fsmp, state_data, piece_size]()
+        {
+            PostViaBufferDelayCallback(*fsmp, state_data, piece_size);
+        });
+
+    fsm.get_transmission_delay_timer()->async_wait(
+        fsm.get_event_strand()->wrap(
+            [fsmp, strand_wrapped](
+                   const boost::system::error_code& ec
+                )
+            {
+                fsmp->SetTransactionDelayTimerWrapper(strand_wrapped, ec);
+            }));
+}
+
 template <typename FSM>
 void HandlePostWrite(
         FSM & fsm,
@@ -188,9 +389,20 @@ void HandlePostWrite(
 
     if (!err)
     {
-        if (fsm.get_post_interface())
+        if (state_data->send_file)
+        {
+            PostViaSendFile( fsm, state_data, start_time, sclock::now(),
+                bytes_transferred );
+        }
+        else if (state_data->post_buffer)
+        {
+            PostViaBuffer( fsm, state_data, start_time, sclock::now(),
+                bytes_transferred );
+        }
+        else if (fsm.get_post_interface())
         {
-            PostViaInterface( fsm, state_data, start_time, sclock::now());
+            PostViaInterface( fsm, state_data, start_time, sclock::now(),
+                bytes_transferred );
         }
         else
         {
@@ -231,7 +443,17 @@ public:
     void on_entry(Event const &, FSM & fsm)
     {
         auto post_data = fsm.get_post_data();
-        if ( post_data )
+        if ( post_data
+            && fsm.BandwidthLimited(BandwidthLimiter::Direction::Upload) )
+        {
+            auto state_data = std::make_shared<SendPostData>(0);
+            state_data_ = state_data;
+            state_data->post_buffer = post_data;
+
+            const auto now = std::chrono::steady_clock::now();
+            PostViaBuffer( fsm, state_data, now, now, 0 );
+        }
+        else if ( post_data )
         {
             // Must prime timeout for async actions.
             auto race_preventer = fsm.SetAsyncTimeout("write request post",
@@ -261,7 +483,24 @@ public:
                 post_interface_->PostDataSize());
             state_data_ = state_data;
             const auto now = std::chrono::steady_clock::now();
-            PostViaInterface( fsm, state_data, now, now );
+
+            // Files can go straight from the kernel to a plain socket.  TLS
+            // and proxies get the data copied through buffers.
+            if ( fsm.get_send_file_enabled()
+                && SendFileSupported()
+                && ! fsm.get_is_ssl()
+                && ! fsm.UsingProxy()
+                && fsm.get_socket_wrapper()->Socket()
+                && post_interface_->PostDataFile(
+                    &state_data->file_descriptor, &state_data->file_offset) )
+            {
+                state_data->send_file = true;
+                PostViaSendFile( fsm, state_data, now, now, 0 );
+            }
+            else
+            {
+                PostViaInterface( fsm, state_data, now, now, 0 );
+            }
         }
     }
 
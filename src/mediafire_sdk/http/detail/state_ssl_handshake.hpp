@@ -16,6 +16,7 @@
 #include "mediafire_sdk/http/detail/race_preventer.hpp"
 #include "mediafire_sdk/http/detail/timeouts.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/url.hpp"
 
 namespace mf {
@@ -203,6 +204,13 @@ void HandleHandshake(
 
     if (!err)
     {
+        fsm.get_tls_session_cache()->HandshakeComplete(
+            fsm.TlsSessionKey(),
+            fsm.get_socket_wrapper()->SslSocket()->native_handle());
+
+        // Hands the connection to an HTTP/2 session if that was negotiated.
+        fsm.Http2HandshakeComplete();
+
         fsm.ProcessEvent(HandshakeEvent{});
     }
     else
@@ -227,6 +235,10 @@ public:
     template <typename Event, typename FSM>
     void on_entry(Event const &, FSM & fsm)
     {
+        // Connecting includes any proxy CONNECT.
+        fsm.EndPhase(RequestPhase::Connect);
+        fsm.BeginPhase(RequestPhase::Tls);
+
         auto state_data = std::make_shared<SslConnectData>();
         state_data_ = state_data;
 
@@ -253,6 +265,13 @@ public:
                 )
             );
 
+        // Ask for HTTP/2 if the request is opening a connection for it.
+        fsm.OfferHttp2();
+
+        // Offer a previous session to allow an abbreviated handshake.
+        fsm.get_tls_session_cache()->ApplySession(
+            fsm.TlsSessionKey(), ssl_socket->native_handle());
+
         // Must prime timeout for async actions.
         auto race_preventer = fsm.SetAsyncTimeout("ssl handshake",
             kSslHandshakeTimeout);
@@ -0,0 +1,208 @@
+/**
+ * @file tls_session_cache.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "tls_session_cache.hpp"
+
+#include "openssl/ssl.h"
+
+#include "mediafire_sdk/http/detail/types.hpp"
+
+namespace {
+const std::chrono::seconds kDefaultLifetime(300);
+
+using SessionPointer = std::shared_ptr<SSL_SESSION>;
+
+/**
+ * Since OpenSSL 1.1.1 a session is marked as not resumable when a connection
+ * using it is freed without a TLS shutdown, which is how connections are
+ * closed here.  Connections are therefore only ever given copies of the
+ * cached sessions.
+ */
+SessionPointer CopySession(SSL_SESSION * session)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    return SessionPointer(SSL_SESSION_dup(session), &SSL_SESSION_free);
+#else
+    return SessionPointer(session, [](SSL_SESSION *){});
+#endif
+}
+
+SessionPointer TakeSession(SSL * ssl)
+{
+    // SSL_get1_session increments the reference count.
+    SessionPointer session(SSL_get1_session(ssl), &SSL_SESSION_free);
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    // A TLS 1.3 connection has a session object before any ticket arrives.
+    if (session && ! SSL_SESSION_is_resumable(session.get()))
+        return nullptr;
+
+    if (session)
+        session = CopySession(session.get());
+#endif
+
+    return session;
+}
+}  // namespace
+
+namespace mf {
+namespace http {
+namespace detail {
+
+TlsSessionCache::Pointer TlsSessionCache::Create()
+{
+    return std::shared_ptr<TlsSessionCache>(new TlsSessionCache);
+}
+
+TlsSessionCache::TlsSessionCache() :
+    max_entries_(0),
+    lifetime_(kDefaultLifetime),
+    statistics_{0, 0}
+{
+}
+
+bool TlsSessionCache::ApplySession(const std::string & key, SSL * ssl)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (max_entries_ == 0)
+        return false;
+
+    RemoveExpired(sclock::now());
+
+    auto it = sessions_.find(key);
+    if (it == sessions_.end())
+        return false;
+
+    // SSL_set_session takes its own reference to the copy.
+    auto session = CopySession(it->second.session.get());
+    return session && SSL_set_session(ssl, session.get()) == 1;
+}
+
+void TlsSessionCache::HandshakeComplete(const std::string & key, SSL * ssl)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (max_entries_ == 0)
+        return;
+
+    if (SSL_session_reused(ssl))
+        ++statistics_.hits;
+    else
+        ++statistics_.misses;
+
+    StoreSessionLocked(key, ssl);
+}
+
+void TlsSessionCache::StoreSession(const std::string & key, SSL * ssl)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    if (max_entries_ == 0)
+        return;
+
+    StoreSessionLocked(key, ssl);
+}
+
+void TlsSessionCache::StoreSessionLocked(const std::string & key, SSL * ssl)
+{
+    auto session = TakeSession(ssl);
+    if ( ! session )
+        return;
+
+    const TimePoint now = sclock::now();
+
+    RemoveExpired(now);
+
+    auto it = sessions_.find(key);
+    if (it != sessions_.end())
+    {
+        // A resumed session keeps the time it was first negotiated, so a
+        // session can not be kept alive forever by resuming it.
+        it->second.session = session;
+        if ( ! SSL_session_reused(ssl) )
+            it->second.stored = now;
+        return;
+    }
+
+    sessions_.emplace(key, Entry{session, now});
+
+    RemoveExcess();
+}
+
+void TlsSessionCache::Clear()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    sessions_.clear();
+}
+
+void TlsSessionCache::SetMaxEntries(std::size_t max_entries)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    max_entries_ = max_entries;
+
+    RemoveExcess();
+}
+
+std::size_t TlsSessionCache::GetMaxEntries() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return max_entries_;
+}
+
+void TlsSessionCache::SetLifetime(std::chrono::seconds lifetime)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    lifetime_ = lifetime;
+}
+
+std::chrono::seconds TlsSessionCache::GetLifetime() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return lifetime_;
+}
+
+TlsSessionCacheStatistics TlsSessionCache::GetStatistics() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return statistics_;
+}
+
+void TlsSessionCache::RemoveExpired(TimePoint now)
+{
+    for (auto it = sessions_.begin(); it != sessions_.end(); )
+    {
+        if (it->second.stored + lifetime_ <= now)
+            it = sessions_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void TlsSessionCache::RemoveExcess()
+{
+    // The cache is expected to hold a handful of hosts, so a linear search for
+    // the oldest entry is cheap enough.
+    while (sessions_.size() > max_entries_)
+    {
+        auto oldest = sessions_.begin();
+        for (auto it = sessions_.begin(); it != sessions_.end(); ++it)
+        {
+            if (it->second.stored < oldest->second.stored)
+                oldest = it;
+        }
+        sessions_.erase(oldest);
+    }
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,122 @@
+/**
+ * @file tls_session_cache.hpp
+ * @author Herbert Jones
+ * @brief Cache of TLS sessions used for abbreviated handshakes.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/utils/mutex.hpp"
+
+// OpenSSL types, so users of HttpConfig need not include OpenSSL.
+struct ssl_st;
+struct ssl_session_st;
+
+namespace mf {
+namespace http {
+
+/**
+ * @struct TlsSessionCacheStatistics
+ * @brief Counters describing TLS session resumption.
+ */
+struct TlsSessionCacheStatistics
+{
+    /** Handshakes that resumed a cached session. */
+    uint64_t hits;
+
+    /** Handshakes that required a full key exchange. */
+    uint64_t misses;
+};
+
+namespace detail {
+
+/**
+ * @class TlsSessionCache
+ * @brief Holds negotiated TLS sessions per host so later connections to the
+ * same host can skip the full handshake.
+ *
+ * The cache is disabled until a maximum entry count is set.  Entries older
+ * than the lifetime are removed lazily when the cache is accessed.
+ */
+class TlsSessionCache
+{
+public:
+    using Pointer = std::shared_ptr<TlsSessionCache>;
+
+    static Pointer Create();
+
+    /**
+     * @brief Offer a cached session to a connection about to handshake.
+     *
+     * @param[in] key Host identity.
+     * @param[in] ssl Connection that has not yet started its handshake.
+     *
+     * @return True if a cached session was offered.
+     */
+    bool ApplySession(const std::string & key, ssl_st * ssl);
+
+    /**
+     * @brief Count a finished handshake as resumed or not and keep its
+     * session.
+     *
+     * @param[in] key Host identity.
+     * @param[in] ssl Connection that completed its handshake.
+     */
+    void HandshakeComplete(const std::string & key, ssl_st * ssl);
+
+    /**
+     * @brief Keep the current session of a connection.
+     *
+     * With TLS 1.3 the server sends session tickets after the handshake, so
+     * this should also be called once a response has been read.
+     *
+     * @param[in] key Host identity.
+     * @param[in] ssl Connection to take the session from.
+     */
+    void StoreSession(const std::string & key, ssl_st * ssl);
+
+    /**
+     * @brief Remove all cached sessions.
+     */
+    void Clear();
+
+    void SetMaxEntries(std::size_t max_entries);
+    std::size_t GetMaxEntries() const;
+
+    void SetLifetime(std::chrono::seconds lifetime);
+    std::chrono::seconds GetLifetime() const;
+
+    TlsSessionCacheStatistics GetStatistics() const;
+
+private:
+    TlsSessionCache();
+
+    struct Entry
+    {
+        std::shared_ptr<ssl_session_st> session;
+        std::chrono::steady_clock::time_point stored;
+    };
+
+    void StoreSessionLocked(const std::string & key, ssl_st * ssl);
+    void RemoveExpired(std::chrono::steady_clock::time_point now);
+    void RemoveExcess();
+
+    mutable mf::utils::mutex mutex_;
+
+    std::map<std::string, Entry> sessions_;
+
+    std::size_t max_entries_;
+    std::chrono::seconds lifetime_;
+
+    TlsSessionCacheStatistics statistics_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -55,6 +55,11 @@ public:
         fsm_.set_timeout_seconds(cfg.timeout_seconds);
     }
 
+    void operator()( const ConfigEvent::ConfigBandwidthWeight & cfg) const
+    {
+        fsm_.set_bandwidth_weight(cfg.weight);
+    }
+
 private:
     FSM & fsm_;
 };
@@ -0,0 +1,102 @@
+/**
+ * @file zstd_decoder.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "zstd_decoder.hpp"
+
+#include <sstream>
+#include <utility>
+
+#include "zstd.h"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+struct ZstdDecoder::Stream
+{
+    Stream() : decoder(ZSTD_createDStream())
+    {}
+
+    ~Stream()
+    {
+        ZSTD_freeDStream(decoder);
+    }
+
+    ZSTD_DStream * decoder;
+};
+
+ZstdDecoder::ZstdDecoder(SharedBufferPool::Pointer buffer_pool) :
+    stream_(new Stream()),
+    output_(std::move(buffer_pool)),
+    frame_end_(false),
+    failed_(false)
+{
+    if ( ! stream_->decoder )
+    {
+        failed_ = true;
+        error_string_ = "Unable to initialize zstd.";
+    }
+}
+
+ZstdDecoder::~ZstdDecoder()
+{
+}
+
+bool ZstdDecoder::Decode(
+        const uint8_t * data,
+        uint64_t size,
+        const OutputCallback & output
+    )
+{
+    ZSTD_inBuffer in = {data, static_cast<std::size_t>(size), 0};
+
+    while ( ! failed_ )
+    {
+        ZSTD_outBuffer out = {output_.Space(),
+            static_cast<std::size_t>(output_.Available()), 0};
+
+        // Concatenated frames are decoded one after the other.
+        const std::size_t ret = ZSTD_decompressStream(stream_->decoder, &out,
+            &in);
+
+        output_.Produced(out.pos, output);
+
+        if ( ZSTD_isError(ret) )
+        {
+            std::stringstream ss;
+            ss << "Zstd decode failed. Error: " << ZSTD_getErrorName(ret);
+            error_string_ = ss.str();
+            failed_ = true;
+            break;
+        }
+
+        frame_end_ = (ret == 0);
+
+        // A full output buffer may leave decoded content to flush, unless
+        // the frame is complete.
+        if ( in.pos == in.size && (frame_end_ || out.pos < out.size) )
+            break;
+    }
+
+    // Pass on what the piece produced without waiting for more.
+    output_.Flush(output);
+
+    return ! failed_;
+}
+
+bool ZstdDecoder::Finish()
+{
+    if ( ! failed_ && ! frame_end_ )
+    {
+        failed_ = true;
+        error_string_ = "Content ended before the end of the zstd frame.";
+    }
+
+    return ! failed_;
+}
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,68 @@
+/**
+ * @file zstd_decoder.hpp
+ * @author Herbert Jones
+ * @brief Incremental zstd decompression of response content.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+
+namespace mf {
+namespace http {
+namespace detail {
+
+/**
+ * @class ZstdDecoder
+ * @brief Decompresses zstd content piece by piece as it is read.
+ *
+ * Only built when HTTP_USE_ZSTD is defined.
+ */
+class ZstdDecoder : public ContentDecoderInterface
+{
+public:
+    /**
+     * @brief CTOR
+     *
+     * @param[in] buffer_pool Pool of the output buffers.
+     */
+    explicit ZstdDecoder(SharedBufferPool::Pointer buffer_pool);
+
+    virtual ~ZstdDecoder();
+
+    virtual bool Decode(
+            const uint8_t * data,
+            uint64_t size,
+            const OutputCallback & output
+        ) override;
+
+    virtual bool Finish() override;
+
+    virtual const std::string & ErrorString() const override
+    {
+        return error_string_;
+    }
+
+private:
+    ZstdDecoder(const ZstdDecoder &) = delete;
+    ZstdDecoder & operator=(const ZstdDecoder &) = delete;
+
+    struct Stream;
+    std::unique_ptr<Stream> stream_;
+
+    DecoderOutput output_;
+
+    bool frame_end_;
+    bool failed_;
+    std::string error_string_;
+};
+
+}  // namespace detail
+}  // namespace http
+}  // namespace mf
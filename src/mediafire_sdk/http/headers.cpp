@@ -0,0 +1,276 @@
+/**
+ * @file headers.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "headers.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace hl = mf::http;
+
+namespace {
+
+bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+char ToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/** Narrow [*begin, *end) to exclude surrounding whitespace. */
+void Trim(const char ** begin, const char ** end)
+{
+    while (*begin != *end && IsSpace(**begin))
+        ++*begin;
+    while (*end != *begin && IsSpace(*(*end - 1)))
+        --*end;
+}
+
+/**
+ * Get the next line, without its line ending, and move pos past it.  Returns
+ * false if no line remains.
+ */
+bool NextLine(
+        const char ** pos,
+        const char * end,
+        const char ** line_begin,
+        const char ** line_end
+    )
+{
+    if (*pos == end)
+        return false;
+
+    *line_begin = *pos;
+
+    const void * newline = std::memchr(*pos, '\n', end - *pos);
+    if (newline)
+    {
+        *line_end = static_cast<const char*>(newline);
+        *pos = *line_end + 1;
+    }
+    else
+    {
+        *line_end = end;
+        *pos = end;
+    }
+
+    if (*line_end != *line_begin && *(*line_end - 1) == '\r')
+        --*line_end;
+
+    return true;
+}
+
+}  // namespace
+
+hl::Headers::Headers() :
+    status_code(0)
+{
+}
+
+bool hl::Headers::Parse(
+        std::string raw,
+        std::string * http_version
+    )
+{
+    raw_headers = std::move(raw);
+    status_code = 0;
+    status_message.clear();
+    fields_.clear();
+    folded_values_.clear();
+
+    const char * const begin = raw_headers.data();
+    const char * const end = begin + raw_headers.size();
+    const char * pos = begin;
+    const char * line_begin = nullptr;
+    const char * line_end = nullptr;
+
+    // Status line, such as "HTTP/1.1 200 OK".
+    if ( ! NextLine(&pos, end, &line_begin, &line_end) )
+        return false;
+
+    const char * version_end = line_begin;
+    while (version_end != line_end && ! IsSpace(*version_end))
+        ++version_end;
+
+    if ( version_end - line_begin < 5
+        || std::memcmp(line_begin, "HTTP/", 5) != 0 )
+        return false;
+
+    if (http_version)
+        http_version->assign(line_begin, version_end);
+
+    const char * it = version_end;
+    while (it != line_end && IsSpace(*it))
+        ++it;
+
+    uint32_t code = 0;
+    const char * const code_begin = it;
+    for (; it != line_end && *it >= '0' && *it <= '9'; ++it)
+    {
+        code = code * 10 + static_cast<uint32_t>(*it - '0');
+        if (code > 0xffff)
+            return false;
+    }
+
+    if (it == code_begin)
+        return false;
+
+    status_code = static_cast<uint16_t>(code);
+
+    Trim(&it, &line_end);
+    status_message.assign(it, line_end);
+
+    while (NextLine(&pos, end, &line_begin, &line_end))
+    {
+        while (line_end != line_begin && IsSpace(*(line_end - 1)))
+            --line_end;
+
+        // The empty line ending the headers.
+        if (line_begin == line_end)
+            break;
+
+        // HTTP headers can be split up inbetween lines.
+        // http://www.w3.org/Protocols/rfc2616/rfc2616-sec2.html#sec2.2
+        if (*line_begin == ' ' || *line_begin == '\t')
+        {
+            if (fields_.empty())
+                return false;
+
+            // This is a continuation of previous line.
+            Field & field = fields_.back();
+            if ( ! field.folded )
+            {
+                const uint32_t folded_begin =
+                    static_cast<uint32_t>(folded_values_.size());
+                folded_values_.append(begin + field.value_begin,
+                    field.value_size);
+                field.value_begin = folded_begin;
+                field.folded = true;
+            }
+
+            Trim(&line_begin, &line_end);
+            folded_values_.push_back(' ');
+            folded_values_.append(line_begin, line_end);
+            field.value_size = static_cast<uint32_t>(folded_values_.size())
+                - field.value_begin;
+
+            continue;
+        }
+
+        const char * colon = static_cast<const char*>(
+            std::memchr(line_begin, ':', line_end - line_begin));
+
+        if (colon)
+        {
+            const char * name_begin = line_begin;
+            const char * name_end = colon;
+            Trim(&name_begin, &name_end);
+
+            const char * value_begin = colon + 1;
+            const char * value_end = line_end;
+            Trim(&value_begin, &value_end);
+
+            Field field = {
+                static_cast<uint32_t>(name_begin - begin),
+                static_cast<uint32_t>(name_end - name_begin),
+                static_cast<uint32_t>(value_begin - begin),
+                static_cast<uint32_t>(value_end - value_begin),
+                false
+            };
+            fields_.push_back(field);
+        }
+    }
+
+    return true;
+}
+
+boost::optional<hl::HeaderValue> hl::Headers::Find(const char * name) const
+{
+    const std::size_t name_size = std::strlen(name);
+    const char * const begin = raw_headers.data();
+
+    for (std::size_t i = 0; i < fields_.size(); ++i)
+    {
+        const Field & field = fields_[i];
+        if (field.name_size != name_size)
+            continue;
+
+        const char * const field_name = begin + field.name_begin;
+
+        std::size_t j = 0;
+        while (j < name_size && ToLower(field_name[j]) == ToLower(name[j]))
+            ++j;
+
+        if (j == name_size)
+            return Value(i);
+    }
+
+    return boost::none;
+}
+
+hl::HeaderValue hl::Headers::Name(std::size_t index) const
+{
+    const Field & field = fields_[index];
+    const char * name = raw_headers.data() + field.name_begin;
+    return HeaderValue(name, name + field.name_size);
+}
+
+hl::HeaderValue hl::Headers::Value(std::size_t index) const
+{
+    const Field & field = fields_[index];
+    const char * value = (field.folded ? folded_values_.data()
+        : raw_headers.data()) + field.value_begin;
+    return HeaderValue(value, value + field.value_size);
+}
+
+std::map<std::string, std::string> hl::Headers::HeaderMap() const
+{
+    std::map<std::string, std::string> headers;
+
+    for (std::size_t i = 0; i < fields_.size(); ++i)
+    {
+        const HeaderValue name = Name(i);
+        const HeaderValue value = Value(i);
+
+        std::string key(name.begin(), name.end());
+        for (char & c : key)
+            c = ToLower(c);
+
+        headers.emplace(std::move(key), std::string(value.begin(),
+            value.end()));
+    }
+
+    return headers;
+}
+
+std::vector<hl::HeaderValue> hl::SplitHeaderTokens(HeaderValue value)
+{
+    std::vector<HeaderValue> tokens;
+
+    const char * it = value.begin();
+    const char * const end = value.end();
+
+    while (it != end)
+    {
+        const char * comma = static_cast<const char*>(
+            std::memchr(it, ',', end - it));
+        const char * token_end = comma ? comma : end;
+
+        const char * token_begin = it;
+        Trim(&token_begin, &token_end);
+
+        // Empty list elements are allowed and ignored.
+        if (token_begin != token_end)
+            tokens.emplace_back(token_begin, token_end);
+
+        it = comma ? comma + 1 : end;
+    }
+
+    return tokens;
+}
@@ -10,16 +10,28 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
+
+#include "boost/optional.hpp"
+#include "boost/range/iterator_range.hpp"
 
 namespace mf {
 namespace http {
 
+/** Text of a header, pointing into the Headers it was read from. */
+typedef boost::iterator_range<const char*> HeaderValue;
+
 /**
  * @class Headers
  * @brief Wrapper for header data.
+ *
+ * Header fields are kept as positions in raw_headers, so parsing and reading
+ * them copies nothing, and copying a Headers copies a single buffer.
  */
 struct Headers
 {
+    Headers();
+
     /** String containing header portion of HTTP response. */
     std::string raw_headers;
 
@@ -30,11 +42,75 @@ struct Headers
     std::string status_message;
 
     /**
-     * HTTP header names are case insensitive, so the key value here is
-     * converted to lowercase for ease of use.
+     * @brief Parse the header portion of an HTTP response.
+     *
+     * @param[in] raw The status line and headers, up to and including the
+     *                empty line ending them.
+     * @param[out] http_version Version from the status line, such as
+     *                          "HTTP/1.1".
+     *
+     * @return False if the headers can not be parsed.
+     */
+    bool Parse(
+            std::string raw,
+            std::string * http_version
+        );
+
+    /**
+     * @brief Find a header.
+     *
+     * HTTP header names are case insensitive, and so is the search.
+     *
+     * @param[in] name Name of the header.
+     *
+     * @return Value of the first header with the name.  Points into this
+     *         object, so only valid while it is unchanged.
+     */
+    boost::optional<HeaderValue> Find(const char * name) const;
+
+    /** Number of headers. */
+    std::size_t Size() const {return fields_.size();}
+
+    /** Name of the header at index, as sent. */
+    HeaderValue Name(std::size_t index) const;
+
+    /** Value of the header at index. */
+    HeaderValue Value(std::size_t index) const;
+
+    /**
+     * @brief Copy of the headers in a map.
+     *
+     * For callers of the former headers member.  The keys are converted to
+     * lowercase, and only the first of repeated headers is kept.
      */
-    std::map<std::string, std::string> headers;
+    std::map<std::string, std::string> HeaderMap() const;
+
+private:
+    struct Field
+    {
+        uint32_t name_begin;
+        uint32_t name_size;
+        uint32_t value_begin;
+        uint32_t value_size;
+
+        /** Value is in folded_values_ rather than raw_headers. */
+        bool folded;
+    };
+
+    std::vector<Field> fields_;
+
+    /** Values spread over several lines, joined by single spaces. */
+    std::string folded_values_;
 };
 
+/**
+ * @brief Split a comma separated header value into its tokens.
+ *
+ * @param[in] value The value, such as "gzip, chunked".
+ *
+ * @return The tokens, trimmed of whitespace, pointing into the value.
+ */
+std::vector<HeaderValue> SplitHeaderTokens(HeaderValue value);
+
 }  // namespace http
 }  // namespace mf
@@ -17,6 +17,12 @@ namespace asio = boost::asio;
 namespace ssl = boost::asio::ssl;
 
 namespace {
+/** Size of the buffers response content is received into. */
+const uint64_t kReceiveBufferSize = 1024 * 64;
+
+/** Most released receive buffers kept for reuse. */
+const std::size_t kReceiveIdleBuffers = 16;
+
 ssl::context DefaultSslContext()
 {
     using mf::http::detail::pem;
@@ -93,16 +99,61 @@ HttpConfig::Pointer HttpConfig::Create(
 HttpConfig::Pointer HttpConfig::Clone() const
 {
     Pointer new_ptr = std::shared_ptr<HttpConfig>(new HttpConfig(*this));
+
+    // Clones may change proxy or certificate settings, so idle connections
+    // are not shared with the original.
+    new_ptr->connection_pool_ = detail::ConnectionPool::Create();
+    new_ptr->connection_pool_->SetMaxIdlePerHost(
+        connection_pool_->GetMaxIdlePerHost());
+    new_ptr->connection_pool_->SetIdleTimeout(
+        connection_pool_->GetIdleTimeout());
+
+    new_ptr->http2_session_pool_ = detail::Http2SessionPool::Create();
+    new_ptr->http2_session_pool_->SetMaxConnectionsPerHost(
+        http2_session_pool_->GetMaxConnectionsPerHost());
+    new_ptr->http2_session_pool_->SetIdleTimeout(
+        http2_session_pool_->GetIdleTimeout());
+
+    new_ptr->tls_session_cache_ = detail::TlsSessionCache::Create();
+    new_ptr->tls_session_cache_->SetMaxEntries(
+        tls_session_cache_->GetMaxEntries());
+    new_ptr->tls_session_cache_->SetLifetime(
+        tls_session_cache_->GetLifetime());
+
+    new_ptr->resolver_cache_ = detail::ResolverCache::Create();
+    new_ptr->resolver_cache_->SetTimeout(resolver_cache_->GetTimeout());
+    new_ptr->resolver_cache_->SetNegativeTimeout(
+        resolver_cache_->GetNegativeTimeout());
+    new_ptr->resolver_cache_->SetLookupFunction(
+        resolver_cache_->GetLookupFunction());
+
+    new_ptr->connect_racer_ = detail::ConnectRacer::Create();
+    new_ptr->connect_racer_->SetAttemptDelay(
+        connect_racer_->GetAttemptDelay());
+    new_ptr->connect_racer_->SetWinnerTimeout(
+        connect_racer_->GetWinnerTimeout());
+
     return new_ptr;
 }
 
 HttpConfig::HttpConfig() :
     io_service_(nullptr),
     default_callback_io_service_(nullptr),
+    bandwidth_analyser_(BandwidthAnalyser::Create()),
+    bandwidth_limiter_(BandwidthLimiter::Create()),
     self_signed_certs_allowed_(SelfSigned::Denied),
     redirect_policy_(RedirectPolicy::Allow),
     default_headers_(DefaultHeaders()),
-    bandwidth_usage_percent_(100)
+    bandwidth_usage_percent_(100),
+    send_file_enabled_(true),
+    http2_enabled_(false),
+    connection_pool_(detail::ConnectionPool::Create()),
+    http2_session_pool_(detail::Http2SessionPool::Create()),
+    tls_session_cache_(detail::TlsSessionCache::Create()),
+    resolver_cache_(detail::ResolverCache::Create()),
+    connect_racer_(detail::ConnectRacer::Create()),
+    receive_buffer_pool_(SharedBufferPool::Create(kReceiveBufferSize,
+            kReceiveIdleBuffers))
 {
 }
 
@@ -168,6 +219,18 @@ BandwidthAnalyserInterface::Pointer HttpConfig::GetBandwidthAnalyser() const
     return bandwidth_analyser_;
 }
 
+void HttpConfig::SetBandwidthLimiter(BandwidthLimiter::Pointer limiter)
+{
+    assert(limiter);
+
+    bandwidth_limiter_ = limiter;
+}
+
+BandwidthLimiter::Pointer HttpConfig::GetBandwidthLimiter() const
+{
+    return bandwidth_limiter_;
+}
+
 ssl::context * HttpConfig::GetSslContext() const
 {
     if (!ssl_ctx_)
@@ -183,6 +246,126 @@ void HttpConfig::SetSslContext(std::shared_ptr<boost::asio::ssl::context> ctx)
     assert(ctx.get() != nullptr);
 
     ssl_ctx_ = ctx;
+
+    // Sessions negotiated with the previous context may not be valid for the
+    // new one.
+    tls_session_cache_->Clear();
+}
+
+void HttpConfig::SetMaxIdleConnectionsPerHost(std::size_t max_idle)
+{
+    connection_pool_->SetMaxIdlePerHost(max_idle);
+}
+
+std::size_t HttpConfig::GetMaxIdleConnectionsPerHost() const
+{
+    return connection_pool_->GetMaxIdlePerHost();
+}
+
+void HttpConfig::SetIdleConnectionTimeout(std::chrono::seconds timeout)
+{
+    connection_pool_->SetIdleTimeout(timeout);
+}
+
+std::chrono::seconds HttpConfig::GetIdleConnectionTimeout() const
+{
+    return connection_pool_->GetIdleTimeout();
+}
+
+void HttpConfig::CloseIdleConnections() const
+{
+    connection_pool_->Clear();
+}
+
+ConnectionPoolStatistics HttpConfig::GetConnectionPoolStatistics() const
+{
+    return connection_pool_->GetStatistics();
+}
+
+void HttpConfig::SetMaxHttp2ConnectionsPerHost(std::size_t max_connections)
+{
+    http2_session_pool_->SetMaxConnectionsPerHost(max_connections);
+}
+
+std::size_t HttpConfig::GetMaxHttp2ConnectionsPerHost() const
+{
+    return http2_session_pool_->GetMaxConnectionsPerHost();
+}
+
+void HttpConfig::CloseIdleHttp2Connections() const
+{
+    http2_session_pool_->Clear();
+}
+
+Http2SessionPoolStatistics HttpConfig::GetHttp2SessionPoolStatistics() const
+{
+    return http2_session_pool_->GetStatistics();
+}
+
+void HttpConfig::SetTlsSessionCacheSize(std::size_t max_entries)
+{
+    tls_session_cache_->SetMaxEntries(max_entries);
+}
+
+std::size_t HttpConfig::GetTlsSessionCacheSize() const
+{
+    return tls_session_cache_->GetMaxEntries();
+}
+
+void HttpConfig::SetTlsSessionLifetime(std::chrono::seconds lifetime)
+{
+    tls_session_cache_->SetLifetime(lifetime);
+}
+
+std::chrono::seconds HttpConfig::GetTlsSessionLifetime() const
+{
+    return tls_session_cache_->GetLifetime();
+}
+
+TlsSessionCacheStatistics HttpConfig::GetTlsSessionCacheStatistics() const
+{
+    return tls_session_cache_->GetStatistics();
+}
+
+void HttpConfig::SetDnsCacheTimeout(std::chrono::seconds timeout)
+{
+    resolver_cache_->SetTimeout(timeout);
+}
+
+std::chrono::seconds HttpConfig::GetDnsCacheTimeout() const
+{
+    return resolver_cache_->GetTimeout();
+}
+
+void HttpConfig::SetDnsCacheNegativeTimeout(std::chrono::seconds timeout)
+{
+    resolver_cache_->SetNegativeTimeout(timeout);
+}
+
+std::chrono::seconds HttpConfig::GetDnsCacheNegativeTimeout() const
+{
+    return resolver_cache_->GetNegativeTimeout();
+}
+
+void HttpConfig::FlushDnsCache() const
+{
+    resolver_cache_->Flush();
+    connect_racer_->Flush();
+}
+
+DnsCacheStatistics HttpConfig::GetDnsCacheStatistics() const
+{
+    return resolver_cache_->GetStatistics();
+}
+
+void HttpConfig::SetConnectAttemptDelay(std::chrono::milliseconds delay)
+{
+    connect_racer_->SetAttemptDelay(delay);
+}
+
+std::chrono::milliseconds HttpConfig::GetConnectAttemptDelay() const
+{
+    return connect_racer_->GetAttemptDelay();
 }
 
 void HttpConfig::AddDefaultHeader(
@@ -6,12 +6,21 @@
  */
 #pragma once
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 
 #include "boost/optional.hpp"
 
+#include "mediafire_sdk/http/bandwidth_analyser.hpp"
 #include "mediafire_sdk/http/bandwidth_analyser_interface.hpp"
+#include "mediafire_sdk/http/bandwidth_limiter.hpp"
+#include "mediafire_sdk/http/detail/connect_racer.hpp"
+#include "mediafire_sdk/http/detail/connection_pool.hpp"
+#include "mediafire_sdk/http/detail/http2_session_pool.hpp"
+#include "mediafire_sdk/http/detail/resolver_cache.hpp"
+#include "mediafire_sdk/http/detail/tls_session_cache.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
 #include "mediafire_sdk/utils/forward_declarations/asio.hpp"
 
 namespace mf {
@@ -55,7 +64,10 @@ struct Proxy
  * connection times out.  If you believe this may happen due to any long running
  * processes, then use a separate thread to run the io_service.
  *
- * Creates a default BandwidthAnalyser if none set.
+ * Creates a default BandwidthAnalyser if none set, shared with clones.
+ *
+ * Idle keep-alive connections are pooled here and reused by later requests.
+ * The HttpConfig must be destroyed before the work io_service.
  */
 class HttpConfig : public std::enable_shared_from_this<HttpConfig>
 {
@@ -155,7 +167,7 @@ public:
      * track bandwidth.
      *
      * If no BandwidthAnalyserInterface object has been passed in via
-     * SetBandwidthAnalyser, a default will be created.
+     * SetBandwidthAnalyser, a default BandwidthAnalyser is used.
      *
      * @return io_service where http requests will be made.
      */
@@ -311,6 +323,324 @@ public:
      */
     uint32_t GetBandwidthUsagePercent() const {return bandwidth_usage_percent_;}
 
+    /**
+     * @brief Set the limiter capping the combined rate of requests.
+     *
+     * Requests using this configuration, or clones of it, share the limiter,
+     * so its upload and download limits apply to all of them together.  Set
+     * the same limiter on unrelated configurations to cap them together too.
+     * Applies on top of SetBandwidthUsagePercent.
+     *
+     * @warning It is not safe to change this after operations have started.
+     *
+     * @param[in] bandwidth_limiter The limiter to use.
+     */
+    void SetBandwidthLimiter(BandwidthLimiter::Pointer bandwidth_limiter);
+
+    /**
+     * @brief Get the limiter capping the combined rate of requests.
+     *
+     * The default limiter does not limit until a rate is set on it with
+     * BandwidthLimiter::SetLimit.
+     *
+     * @return The bandwidth limiter.
+     */
+    BandwidthLimiter::Pointer GetBandwidthLimiter() const;
+
+    /**
+     * @brief Allow POST data from files to be sent with sendfile.
+     *
+     * Only requests without TLS or a proxy, whose PostDataPipeInterface
+     * provides a file, are sent this way, and only on platforms with
+     * sendfile.  Bandwidth usage limits still apply.  Enabled by default.
+     *
+     * @param[in] enabled False to always copy POST data through buffers.
+     */
+    void SetSendFileEnabled(bool enabled) {send_file_enabled_=enabled;}
+
+    /**
+     * @brief Get whether POST data from files may be sent with sendfile.
+     *
+     * @return True if sendfile may be used.
+     */
+    bool GetSendFileEnabled() const {return send_file_enabled_;}
+
+    /**
+     * @brief Set the maximum number of idle keep-alive connections kept per
+     * host.
+     *
+     * Connections are kept per scheme, host, port and proxy.  Setting this to
+     * 0 disables connection reuse.  The default is 4.
+     *
+     * @param[in] max_idle Maximum number of idle connections per host.
+     */
+    void SetMaxIdleConnectionsPerHost(std::size_t max_idle);
+
+    /**
+     * @brief Get the maximum number of idle keep-alive connections kept per
+     * host.
+     *
+     * @return Maximum number of idle connections per host.
+     */
+    std::size_t GetMaxIdleConnectionsPerHost() const;
+
+    /**
+     * @brief Set how long an idle keep-alive connection is kept for reuse.
+     *
+     * The default is 15 seconds, which is below the keep-alive timeout of most
+     * servers.
+     *
+     * @param[in] timeout Time after which idle connections are closed.
+     */
+    void SetIdleConnectionTimeout(std::chrono::seconds timeout);
+
+    /**
+     * @brief Get how long an idle keep-alive connection is kept for reuse.
+     *
+     * @return Time after which idle connections are closed.
+     */
+    std::chrono::seconds GetIdleConnectionTimeout() const;
+
+    /**
+     * @brief Close all idle keep-alive connections.
+     *
+     * Useful when the network changes and pooled connections are unlikely to
+     * be usable.
+     */
+    void CloseIdleConnections() const;
+
+    /**
+     * @brief Get hit and miss counts for the keep-alive connection pool.
+     *
+     * @return Connection pool counters.
+     */
+    ConnectionPoolStatistics GetConnectionPoolStatistics() const;
+
+    /**
+     * @brief Get the pool of idle connections shared by requests using this
+     * configuration.
+     *
+     * @return The connection pool.
+     */
+    detail::ConnectionPool::Pointer GetConnectionPool() const
+    {return connection_pool_;}
+
+    /**
+     * @brief Send HTTPS requests over HTTP/2 where the server supports it.
+     *
+     * HTTP/2 is offered in the TLS handshake, and if the server accepts,
+     * requests to the same host share the connection as concurrent streams.
+     * Servers that do not accept are sent HTTP/1.1 as before.  Only has an
+     * effect if the library was built with nghttp2.  Disabled by default.
+     *
+     * @param[in] enabled True to use HTTP/2 where possible.
+     */
+    void SetHttp2Enabled(bool enabled) {http2_enabled_=enabled;}
+
+    /**
+     * @brief Get whether HTTP/2 is used where the server supports it.
+     *
+     * @return True if HTTP/2 is enabled.
+     */
+    bool GetHttp2Enabled() const {return http2_enabled_;}
+
+    /**
+     * @brief Set the maximum number of HTTP/2 connections opened per host.
+     *
+     * A new connection is only opened once all streams the server permits on
+     * the others are in use.  The default is 1.
+     *
+     * @param[in] max_connections Maximum number of connections, at least 1.
+     */
+    void SetMaxHttp2ConnectionsPerHost(std::size_t max_connections);
+
+    /**
+     * @brief Get the maximum number of HTTP/2 connections opened per host.
+     *
+     * @return Maximum number of connections per host.
+     */
+    std::size_t GetMaxHttp2ConnectionsPerHost() const;
+
+    /**
+     * @brief Close HTTP/2 connections that have no requests in progress.
+     */
+    void CloseIdleHttp2Connections() const;
+
+    /**
+     * @brief Get opened connection and shared request counts for HTTP/2.
+     *
+     * @return HTTP/2 connection counters.
+     */
+    Http2SessionPoolStatistics GetHttp2SessionPoolStatistics() const;
+
+    /**
+     * @brief Get the HTTP/2 connections shared by requests using this
+     * configuration.
+     *
+     * @return The HTTP/2 session pool.
+     */
+    detail::Http2SessionPool::Pointer GetHttp2SessionPool() const
+    {return http2_session_pool_;}
+
+    /**
+     * @brief Enable resumption of TLS sessions for new connections.
+     *
+     * Sessions are kept per host, so repeated connections to the same host
+     * can skip the full handshake.  Setting this to 0 disables the
+     * cache, which is the default.
+     *
+     * @param[in] max_entries Maximum number of hosts to keep a session for.
+     */
+    void SetTlsSessionCacheSize(std::size_t max_entries);
+
+    /**
+     * @brief Get the maximum number of hosts a TLS session is kept for.
+     *
+     * @return Maximum number of cached sessions, 0 if disabled.
+     */
+    std::size_t GetTlsSessionCacheSize() const;
+
+    /**
+     * @brief Set how long a TLS session may be resumed after it was
+     * negotiated.
+     *
+     * The default is 5 minutes.  Servers may expire sessions sooner, in which
+     * case a full handshake is done.
+     *
+     * @param[in] lifetime Time after which a cached session is discarded.
+     */
+    void SetTlsSessionLifetime(std::chrono::seconds lifetime);
+
+    /**
+     * @brief Get how long a TLS session may be resumed after it was
+     * negotiated.
+     *
+     * @return Time after which a cached session is discarded.
+     */
+    std::chrono::seconds GetTlsSessionLifetime() const;
+
+    /**
+     * @brief Get resumed and full handshake counts for the TLS session cache.
+     *
+     * Handshakes are only counted while the cache is enabled.
+     *
+     * @return TLS session cache counters.
+     */
+    TlsSessionCacheStatistics GetTlsSessionCacheStatistics() const;
+
+    /**
+     * @brief Get the TLS session cache shared by requests using this
+     * configuration.
+     *
+     * @return The TLS session cache.
+     */
+    detail::TlsSessionCache::Pointer GetTlsSessionCache() const
+    {return tls_session_cache_;}
+
+    /**
+     * @brief Set how long resolved host names are remembered.
+     *
+     * Requests resolving the same host and port at the same time always share
+     * a single lookup.  Setting this to 0 disables caching of successful
+     * lookups.  The default is 60 seconds.
+     *
+     * @param[in] timeout Time after which a host is looked up again.
+     */
+    void SetDnsCacheTimeout(std::chrono::seconds timeout);
+
+    /**
+     * @brief Get how long resolved host names are remembered.
+     *
+     * @return Time after which a host is looked up again.
+     */
+    std::chrono::seconds GetDnsCacheTimeout() const;
+
+    /**
+     * @brief Set how long failed host name lookups are remembered.
+     *
+     * Setting this to 0 disables caching of failures.  The default is 5
+     * seconds.
+     *
+     * @param[in] timeout Time after which a failed host is looked up again.
+     */
+    void SetDnsCacheNegativeTimeout(std::chrono::seconds timeout);
+
+    /**
+     * @brief Get how long failed host name lookups are remembered.
+     *
+     * @return Time after which a failed host is looked up again.
+     */
+    std::chrono::seconds GetDnsCacheNegativeTimeout() const;
+
+    /**
+     * @brief Forget all resolved host names, and which address of each host
+     * connected first.
+     *
+     * Should be called when the network changes, as cached addresses may no
+     * longer be reachable and cached failures may no longer apply.
+     */
+    void FlushDnsCache() const;
+
+    /**
+     * @brief Get hit, miss and coalesced lookup counts for the DNS cache.
+     *
+     * @return DNS cache counters.
+     */
+    DnsCacheStatistics GetDnsCacheStatistics() const;
+
+    /**
+     * @brief Get the host name resolver shared by requests using this
+     * configuration.
+     *
+     * @return The resolver cache.
+     */
+    detail::ResolverCache::Pointer GetResolverCache() const
+    {return resolver_cache_;}
+
+    /**
+     * @brief Set how long a connection attempt to one address of a host is
+     * given before the next address is also attempted.
+     *
+     * Hosts resolving to several addresses are connected to as described by
+     * RFC 8305, so an unreachable address only delays the connection by this
+     * much.  An attempt that fails starts the next at once.  The address that
+     * connected first is tried first by later requests to the same host.  The
+     * default is 250 milliseconds.
+     *
+     * @param[in] delay Head start given to each attempt.
+     */
+    void SetConnectAttemptDelay(std::chrono::milliseconds delay);
+
+    /**
+     * @brief Get how long a connection attempt to one address of a host is
+     * given before the next address is also attempted.
+     *
+     * @return Head start given to each attempt.
+     */
+    std::chrono::milliseconds GetConnectAttemptDelay() const;
+
+    /**
+     * @brief Get the connection racer shared by requests using this
+     * configuration.
+     *
+     * @return The connection racer.
+     */
+    detail::ConnectRacer::Pointer GetConnectRacer() const
+    {return connect_racer_;}
+
+    /**
+     * @brief Get the pool that response content is received into, shared by
+     * requests using this configuration.
+     *
+     * Buffers handed to RequestResponseInterface::ResponseContentReceived
+     * come from this pool, and their storage is reused once the receiver
+     * releases them.
+     *
+     * @return The receive buffer pool.
+     */
+    SharedBufferPool::Pointer GetReceiveBufferPool() const
+    {return receive_buffer_pool_;}
+
 private:
     HttpConfig();
 
@@ -321,6 +651,8 @@ private:
 
     BandwidthAnalyserInterface::Pointer bandwidth_analyser_;
 
+    BandwidthLimiter::Pointer bandwidth_limiter_;
+
     mutable std::shared_ptr<boost::asio::ssl::context> ssl_ctx_;
 
     boost::optional<Proxy> http_proxy_;
@@ -333,6 +665,23 @@ private:
     HeaderContainer default_headers_;
 
     uint32_t bandwidth_usage_percent_;
+
+    bool send_file_enabled_;
+
+    bool http2_enabled_;
+
+    // Declared after the io_service so pooled sockets are destroyed first.
+    detail::ConnectionPool::Pointer connection_pool_;
+
+    detail::Http2SessionPool::Pointer http2_session_pool_;
+
+    detail::TlsSessionCache::Pointer tls_session_cache_;
+
+    detail::ResolverCache::Pointer resolver_cache_;
+
+    detail::ConnectRacer::Pointer connect_racer_;
+
+    SharedBufferPool::Pointer receive_buffer_pool_;
 };
 
 }  // namespace http
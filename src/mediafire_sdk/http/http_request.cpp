@@ -6,6 +6,9 @@
  */
 #include "http_request.hpp"
 
+#include <algorithm>
+
+#include "mediafire_sdk/http/content_accumulator.hpp"
 #include "mediafire_sdk/http/detail/http_request_state_machine.hpp"
 
 namespace hl = mf::http;
@@ -147,6 +150,7 @@ mf::http::HttpRequest::Pointer mf::http::HttpRequest::Create(
             ) override
         {
             response_.headers = headers;
+            content_.Start(headers);
         }
 
         /**
@@ -163,8 +167,20 @@ mf::http::HttpRequest::Pointer mf::http::HttpRequest::Create(
                 std::shared_ptr<mf::http::BufferInterface> buffer
             ) override
         {
-            response_.content.append(
-                reinterpret_cast<const char*>(buffer->Data()), buffer->Size() );
+            content_.Append(std::move(buffer));
+        }
+
+        /**
+         * @brief Called with the timings of the request just before it
+         * completes.
+         *
+         * @param[in] timings When each phase of the request began and ended.
+         */
+        virtual void RequestTimingsReceived(
+                const mf::http::RequestTimings & timings
+            ) override
+        {
+            response_.timings = timings;
         }
 
         /**
@@ -180,6 +196,7 @@ mf::http::HttpRequest::Pointer mf::http::HttpRequest::Create(
         {
             response_.error_code = error_code;
             response_.error_text = error_text;
+            response_.content = content_.Take();
 
             auto self = shared_from_this();
             callback_ios_->post([this, self]()
@@ -193,11 +210,13 @@ mf::http::HttpRequest::Pointer mf::http::HttpRequest::Create(
          */
         virtual void RequestResponseCompleteEvent() override
         {
+            response_.content = content_.Take();
             callback_(response_);
         }
 
     private:
         HttpRequest::CallbackResponse response_;
+        ContentAccumulator content_;
         std::function<void(HttpRequest::CallbackResponse)> callback_;
         asio::io_service * callback_ios_;
     };
@@ -298,3 +317,12 @@ void hl::HttpRequest::SetTimeout(uint32_t timeout)
                 detail::ConfigEvent::ConfigTimeout{timeout}
         });
 }
+
+void hl::HttpRequest::SetBandwidthWeight(uint32_t weight)
+{
+    impl_->ProcessEvent(
+            detail::ConfigEvent{
+                detail::ConfigEvent::ConfigBandwidthWeight{
+                    std::max<uint32_t>(1, weight)}
+        });
+}
@@ -17,6 +17,7 @@
 
 #include "mediafire_sdk/http/http_config.hpp"
 #include "mediafire_sdk/http/request_response_interface.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/shared_buffer.hpp"
 
 #include "mediafire_sdk/utils/forward_declarations/asio.hpp"
@@ -59,6 +60,9 @@ public:
 
         /** HTTP Response content */
         std::string content;
+
+        /** When each phase of the request began and ended. */
+        RequestTimings timings;
     };
 
     using FunctionCallback = std::function<void(CallbackResponse)>;
@@ -219,6 +223,17 @@ public:
      */
     void SetTimeout(uint32_t timeout);
 
+    /**
+     * @brief Set the share of limited bandwidth this request gets.
+     * @warning Must be called before Start().
+     *
+     * When the HttpConfig bandwidth limiter is limiting, requests share the
+     * rate in proportion to their weights.  The default weight is 1.
+     *
+     * @param[in] weight Relative share, at least 1.
+     */
+    void SetBandwidthWeight(uint32_t weight);
+
     /**
      * @brief Start the request.
      *
@@ -52,6 +52,28 @@ public:
      */
     virtual SharedBuffer::Pointer RetreivePostDataChunk() = 0;
 
+    /**
+     * @brief Returns the open file holding the POST data, if there is one.
+     *
+     * When the POST data is PostDataSize() bytes of a file starting at
+     * offset, implement this so requests without TLS or a proxy can have the
+     * kernel send the file with sendfile where supported.  In that case
+     * RetreivePostDataChunk() is not called.  The descriptor must stay open
+     * as long as the interface exists.
+     *
+     * @param[out] file_descriptor Descriptor of the file.
+     * @param[out] offset Position of the first byte to send.
+     *
+     * @return True if file_descriptor and offset were set.
+     */
+    virtual bool PostDataFile(
+            int * /* file_descriptor */,
+            uint64_t * /* offset */
+        )
+    {
+        return false;
+    }
+
 private:
 };
 
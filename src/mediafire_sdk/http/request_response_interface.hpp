@@ -14,6 +14,7 @@
 
 #include "buffer_interface.hpp"
 #include "mediafire_sdk/http/headers.hpp"
+#include "mediafire_sdk/http/request_timings.hpp"
 #include "mediafire_sdk/http/url.hpp"
 
 namespace mf {
@@ -67,6 +68,18 @@ public:
             std::shared_ptr<BufferInterface> buffer
         ) = 0;
 
+    /**
+     * @brief Called with the timings of the request just before it completes,
+     * with an error or otherwise.
+     *
+     * @param[in] timings When each phase of the request began and ended.
+     */
+    virtual void RequestTimingsReceived(
+            const RequestTimings & /* timings */
+        )
+    {
+    }
+
     /**
      * @brief Called when an error occurs. Completes the request.
      *
@@ -0,0 +1,216 @@
+/**
+ * @file request_timing_histogram.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "request_timing_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/** Each doubling of the duration is split into this many buckets. */
+const int kSubBucketBits = 4;
+const uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+
+const std::size_t kDefaultMaxPaths = 100;
+
+int HighestBit(uint64_t value)
+{
+    int bit = 0;
+    while (value >>= 1)
+        ++bit;
+    return bit;
+}
+
+std::size_t BucketIndex(uint64_t microseconds)
+{
+    // Small durations get a bucket each.
+    if (microseconds < kSubBuckets)
+        return static_cast<std::size_t>(microseconds);
+
+    const int shift = HighestBit(microseconds) - kSubBucketBits;
+    const uint64_t sub_bucket = (microseconds >> shift) & (kSubBuckets - 1);
+
+    return static_cast<std::size_t>(
+        kSubBuckets + shift * kSubBuckets + sub_bucket);
+}
+
+/** Longest duration counted in a bucket. */
+uint64_t BucketHighest(std::size_t index)
+{
+    if (index < kSubBuckets)
+        return index;
+
+    const uint64_t shift = (index - kSubBuckets) / kSubBuckets;
+    const uint64_t sub_bucket = (index - kSubBuckets) % kSubBuckets;
+
+    const uint64_t lowest = (kSubBuckets + sub_bucket) << shift;
+    return lowest + (uint64_t(1) << shift) - 1;
+}
+
+}  // namespace
+
+namespace mf {
+namespace http {
+
+RequestTimingHistogram::Pointer RequestTimingHistogram::Create()
+{
+    return Pointer(new RequestTimingHistogram);
+}
+
+RequestTimingHistogram::RequestTimingHistogram() :
+    max_paths_(kDefaultMaxPaths)
+{
+}
+
+void RequestTimingHistogram::RecordRequestTimings(
+        const std::string & path,
+        const RequestTimings & timings
+    )
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto it = paths_.find(path);
+    if (it == paths_.end())
+    {
+        const std::string & key = (paths_.size() < max_paths_)
+            ? path : OtherPath();
+        it = paths_.insert(std::make_pair(key, PhaseHistograms())).first;
+    }
+    PhaseHistograms & path_histograms = it->second;
+
+    for (std::size_t i = 0; i < kRequestPhaseCount; ++i)
+    {
+        const auto phase = static_cast<RequestPhase>(i);
+        if ( ! timings.Measured(phase) )
+            continue;
+
+        const uint64_t microseconds = std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                timings.Get(phase)).count());
+
+        Add(&all_[i], microseconds);
+        Add(&path_histograms[i], microseconds);
+    }
+}
+
+uint64_t RequestTimingHistogram::Count(
+        const std::string & path,
+        RequestPhase phase
+    ) const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    const Histogram * histogram = Find(path, phase);
+    return histogram ? histogram->count : 0;
+}
+
+RequestTimingHistogram::Duration RequestTimingHistogram::Percentile(
+        const std::string & path,
+        RequestPhase phase,
+        double percentile
+    ) const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    const Histogram * histogram = Find(path, phase);
+    if ( ! histogram || histogram->count == 0 )
+        return Duration::zero();
+
+    percentile = std::min(100.0, std::max(0.0, percentile));
+
+    // The request at this rank took as long as the percentile.
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(
+        std::ceil(percentile / 100.0 * histogram->count)));
+
+    uint64_t seen = 0;
+    uint64_t microseconds = histogram->max;
+    for (std::size_t i = 0; i < histogram->buckets.size(); ++i)
+    {
+        seen += histogram->buckets[i];
+        if (seen >= rank)
+        {
+            microseconds = std::min(BucketHighest(i), histogram->max);
+            break;
+        }
+    }
+
+    return std::chrono::duration_cast<Duration>(
+        std::chrono::microseconds(microseconds));
+}
+
+std::vector<std::string> RequestTimingHistogram::Paths() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    std::vector<std::string> paths;
+    paths.reserve(paths_.size());
+    for (const auto & pair : paths_)
+        paths.push_back(pair.first);
+    return paths;
+}
+
+void RequestTimingHistogram::SetMaxPaths(std::size_t max_paths)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    max_paths_ = max_paths;
+}
+
+std::size_t RequestTimingHistogram::MaxPaths() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return max_paths_;
+}
+
+const std::string & RequestTimingHistogram::OtherPath()
+{
+    // Url paths always begin with a slash, so this is never one of them.
+    static const std::string other_path("other");
+    return other_path;
+}
+
+void RequestTimingHistogram::Clear()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    all_ = PhaseHistograms();
+    paths_.clear();
+}
+
+void RequestTimingHistogram::Add(
+        Histogram * histogram,
+        uint64_t microseconds
+    )
+{
+    const std::size_t index = BucketIndex(microseconds);
+    if (index >= histogram->buckets.size())
+        histogram->buckets.resize(index + 1, 0);
+
+    ++histogram->buckets[index];
+    ++histogram->count;
+    histogram->max = std::max(histogram->max, microseconds);
+}
+
+const RequestTimingHistogram::Histogram * RequestTimingHistogram::Find(
+        const std::string & path,
+        RequestPhase phase
+    ) const
+{
+    const std::size_t index = static_cast<std::size_t>(phase);
+
+    if (path.empty())
+        return &all_[index];
+
+    auto it = paths_.find(path);
+    if (it == paths_.end())
+        return nullptr;
+
+    return &it->second[index];
+}
+
+}  // namespace http
+}  // namespace mf
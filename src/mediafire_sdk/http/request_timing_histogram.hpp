@@ -0,0 +1,136 @@
+/**
+ * @file request_timing_histogram.hpp
+ * @author Herbert Jones
+ * @brief Request timing sink keeping histograms of each phase.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mediafire_sdk/http/request_timings.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @class RequestTimingHistogram
+ * @brief Keeps a histogram of each phase, per url path and for all paths, to
+ * read percentiles from.
+ *
+ * Durations are kept to within about 6%, in buckets that grow with the
+ * duration.  Only the first MaxPaths() paths get histograms of their own, and
+ * later ones share the one under OtherPath(), as some paths such as download
+ * links are never requested twice.  So memory does not grow with the number
+ * of requests.
+ *
+ * Install for all requests with SetRequestTimingSink.
+ */
+class RequestTimingHistogram : public RequestTimingSinkInterface
+{
+public:
+    /** Shared pointer acts as handle. */
+    using Pointer = std::shared_ptr<RequestTimingHistogram>;
+
+    using Duration = RequestTimings::Duration;
+
+    /**
+     * @brief Create a histogram with nothing recorded.
+     *
+     * @return RequestTimingHistogram handle
+     */
+    static Pointer Create();
+
+    virtual void RecordRequestTimings(
+            const std::string & path,
+            const RequestTimings & timings
+        ) override;
+
+    /**
+     * @brief Get how many requests measured a phase.
+     *
+     * @param[in] path Url path, or empty for all paths.
+     * @param[in] phase The phase.
+     */
+    uint64_t Count(
+            const std::string & path,
+            RequestPhase phase
+        ) const;
+
+    /**
+     * @brief Get the duration a percentage of requests took no longer than.
+     *
+     * @param[in] path Url path, or empty for all paths.
+     * @param[in] phase The phase.
+     * @param[in] percentile From 0 to 100, such as 50 or 99.
+     *
+     * @return The duration, or zero if nothing was recorded.
+     */
+    Duration Percentile(
+            const std::string & path,
+            RequestPhase phase,
+            double percentile
+        ) const;
+
+    /**
+     * @brief Get the url paths recorded, including OtherPath() once paths
+     * were folded into it.
+     */
+    std::vector<std::string> Paths() const;
+
+    /**
+     * @brief Set how many paths get histograms of their own.  Paths already
+     * recorded are kept.
+     *
+     * @param[in] max_paths Path count.
+     */
+    void SetMaxPaths(std::size_t max_paths);
+    std::size_t MaxPaths() const;
+
+    /**
+     * @brief Path of the histogram shared by paths past MaxPaths().
+     */
+    static const std::string & OtherPath();
+
+    /**
+     * @brief Forget everything recorded.
+     */
+    void Clear();
+
+private:
+    RequestTimingHistogram();
+
+    struct Histogram
+    {
+        Histogram() : count(0), max(0) {}
+
+        /** Counts of durations in microseconds, by bucket. */
+        std::vector<uint64_t> buckets;
+        uint64_t count;
+        uint64_t max;
+    };
+    using PhaseHistograms = std::array<Histogram, kRequestPhaseCount>;
+
+    static void Add(Histogram * histogram, uint64_t microseconds);
+
+    const Histogram * Find(
+            const std::string & path,
+            RequestPhase phase
+        ) const;
+
+    mutable mf::utils::mutex mutex_;
+
+    PhaseHistograms all_;
+    std::map<std::string, PhaseHistograms> paths_;
+    std::size_t max_paths_;
+};
+
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,83 @@
+/**
+ * @file request_timings.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "request_timings.hpp"
+
+#include <cassert>
+
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace {
+
+mf::utils::mutex & SinkMutex()
+{
+    static mf::utils::mutex mutex;
+    return mutex;
+}
+
+mf::http::RequestTimingSinkInterface::Pointer & Sink()
+{
+    static mf::http::RequestTimingSinkInterface::Pointer sink;
+    return sink;
+}
+
+}  // namespace
+
+namespace mf {
+namespace http {
+
+const char * RequestPhaseName(RequestPhase phase)
+{
+    switch (phase)
+    {
+        case RequestPhase::Dns:
+            return "dns";
+        case RequestPhase::Connect:
+            return "connect";
+        case RequestPhase::Tls:
+            return "tls";
+        case RequestPhase::Send:
+            return "send";
+        case RequestPhase::TimeToFirstByte:
+            return "ttfb";
+        case RequestPhase::Transfer:
+            return "transfer";
+        case RequestPhase::Total:
+            return "total";
+        default:
+            assert(!"Unknown RequestPhase");
+            return "unknown";
+    }
+}
+
+bool RequestTimings::Measured(RequestPhase phase) const
+{
+    const Span & span = phases[static_cast<std::size_t>(phase)];
+    return span.begin != TimePoint() && span.end != TimePoint();
+}
+
+RequestTimings::Duration RequestTimings::Get(RequestPhase phase) const
+{
+    if ( ! Measured(phase) )
+        return Duration::zero();
+
+    const Span & span = phases[static_cast<std::size_t>(phase)];
+    return span.end - span.begin;
+}
+
+void SetRequestTimingSink(RequestTimingSinkInterface::Pointer sink)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(SinkMutex());
+    Sink() = std::move(sink);
+}
+
+RequestTimingSinkInterface::Pointer GetRequestTimingSink()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(SinkMutex());
+    return Sink();
+}
+
+}  // namespace http
+}  // namespace mf
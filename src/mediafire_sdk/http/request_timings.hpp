@@ -0,0 +1,134 @@
+/**
+ * @file request_timings.hpp
+ * @author Herbert Jones
+ * @brief Time spent in each phase of an HTTP request.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mf {
+namespace http {
+
+/**
+ * @brief Phases of a request, in the order they happen.
+ */
+enum class RequestPhase
+{
+    /** Looking up the host name. */
+    Dns,
+
+    /** Connecting to the host, and through any proxy. */
+    Connect,
+
+    /** The TLS handshake. */
+    Tls,
+
+    /** Writing the request headers and any POST data. */
+    Send,
+
+    /** From the request being sent until the response headers arrived. */
+    TimeToFirstByte,
+
+    /** Receiving the response content. */
+    Transfer,
+
+    /** The whole request, including any redirects. */
+    Total
+};
+
+/** Number of RequestPhase values. */
+const std::size_t kRequestPhaseCount = 7;
+
+/**
+ * @brief Get a name for a phase, for reports.
+ *
+ * @param[in] phase The phase.
+ *
+ * @return Name such as "dns" or "ttfb".
+ */
+const char * RequestPhaseName(RequestPhase phase);
+
+/**
+ * @struct RequestTimings
+ * @brief When each phase of a request began and ended.
+ *
+ * Times are from the steady clock.  Phases skipped have no times, such as DNS,
+ * connect and TLS when a pooled connection was reused.  After a redirect only
+ * the phases of the last request made are kept, while Total covers them all.
+ */
+struct RequestTimings
+{
+    using TimePoint = std::chrono::steady_clock::time_point;
+    using Duration = std::chrono::steady_clock::duration;
+
+    /** Default TimePoint where the phase did not begin or end. */
+    struct Span
+    {
+        TimePoint begin;
+        TimePoint end;
+    };
+
+    std::array<Span, kRequestPhaseCount> phases;
+
+    /**
+     * @brief Check if a phase began and ended.
+     */
+    bool Measured(RequestPhase phase) const;
+
+    /**
+     * @brief Get how long a phase took.
+     *
+     * @return The duration, or zero if the phase was not measured.
+     */
+    Duration Get(RequestPhase phase) const;
+};
+
+/**
+ * @interface RequestTimingSinkInterface
+ * @brief Receives the timings of every completed request.
+ */
+class RequestTimingSinkInterface
+{
+public:
+    using Pointer = std::shared_ptr<RequestTimingSinkInterface>;
+
+    virtual ~RequestTimingSinkInterface() = default;
+
+    /**
+     * @brief Record the timings of a request that completed successfully.
+     *
+     * Called from the work io_service of the request, so it must be quick and
+     * safe to call from several threads.
+     *
+     * @param[in] path Path of the url requested, without the query.
+     * @param[in] timings The timings.
+     */
+    virtual void RecordRequestTimings(
+            const std::string & path,
+            const RequestTimings & timings
+        ) = 0;
+};
+
+/**
+ * @brief Set where all requests in the process report their timings.
+ *
+ * @param[in] sink The sink, or null to stop reporting.
+ */
+void SetRequestTimingSink(RequestTimingSinkInterface::Pointer sink);
+
+/**
+ * @brief Get where all requests in the process report their timings.
+ *
+ * @return The sink, or null if none was set.
+ */
+RequestTimingSinkInterface::Pointer GetRequestTimingSink();
+
+}  // namespace http
+}  // namespace mf
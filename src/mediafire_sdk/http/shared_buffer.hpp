@@ -10,7 +10,10 @@
 #include <cassert>
 #include <cstring>
 
+#include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "boost/smart_ptr/shared_array.hpp"
 
@@ -19,6 +22,8 @@
 namespace mf {
 namespace http {
 
+class SharedBufferPool;
+
 /**
  * @class SharedBuffer
  * @brief Wrapper for efficiently pass raw bytes to and from HttpRequest.
@@ -101,7 +106,24 @@ public:
         return buffer_.get();
     }
 
+    /**
+     * @brief Make the buffer smaller, such as after reading less than it can
+     * hold.
+     *
+     * @param[in] size New size, no more than Size().
+     */
+    void Shrink(uint64_t size)
+    {
+        assert( size <= size_ );
+        size_ = size;
+
+        // Buffer has canary
+        buffer_[size_] = 0;
+    }
+
 private:
+    friend class SharedBufferPool;
+
     /**
      * @brief Create shared buffer.
      *
@@ -117,6 +139,22 @@ private:
         buffer_[size_] = 0;
     }
 
+    /**
+     * @brief Create shared buffer over existing storage.
+     *
+     * @param[in] storage Storage of at least size + 1 bytes.
+     * @param[in] size The size of the buffer.
+     */
+    SharedBuffer(boost::shared_array<uint8_t> storage, uint64_t size) :
+        size_(size),
+        buffer_(std::move(storage))
+    {
+        assert(buffer_);
+
+        // Buffer has canary
+        buffer_[size_] = 0;
+    }
+
     /** Size of buffer_ */
     uint64_t size_;
 
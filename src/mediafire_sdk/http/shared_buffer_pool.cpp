@@ -0,0 +1,91 @@
+/**
+ * @file shared_buffer_pool.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "shared_buffer_pool.hpp"
+
+#include <cassert>
+
+namespace mf {
+namespace http {
+
+SharedBufferPool::Pointer SharedBufferPool::Create(
+        uint64_t buffer_size,
+        std::size_t max_idle_buffers
+    )
+{
+    return Pointer(new SharedBufferPool(buffer_size, max_idle_buffers));
+}
+
+SharedBufferPool::SharedBufferPool(
+        uint64_t buffer_size,
+        std::size_t max_idle_buffers
+    ) :
+    buffer_size_(buffer_size),
+    max_idle_buffers_(max_idle_buffers)
+{
+    assert(buffer_size_ > 0);
+}
+
+SharedBufferPool::~SharedBufferPool()
+{
+    for (auto storage : idle_)
+        delete [] storage;
+}
+
+SharedBuffer::Pointer SharedBufferPool::Acquire(uint64_t size)
+{
+    assert(size <= buffer_size_);
+
+    uint8_t * storage = nullptr;
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if ( ! idle_.empty() )
+        {
+            storage = idle_.back();
+            idle_.pop_back();
+        }
+    }
+
+    if (storage == nullptr)
+        storage = new uint8_t[buffer_size_ + 1];
+
+    // Storage goes back to the pool when the last buffer using it is gone, or
+    // is freed if the pool went away first.
+    std::weak_ptr<SharedBufferPool> weak_pool = shared_from_this();
+    boost::shared_array<uint8_t> shared_storage(storage,
+        [weak_pool](uint8_t * released)
+        {
+            if (auto pool = weak_pool.lock())
+                pool->Release(released);
+            else
+                delete [] released;
+        });
+
+    return SharedBuffer::Pointer(
+        new SharedBuffer(std::move(shared_storage), size));
+}
+
+std::size_t SharedBufferPool::IdleBuffers()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+void SharedBufferPool::Release(uint8_t * storage)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (idle_.size() < max_idle_buffers_)
+        {
+            idle_.push_back(storage);
+            return;
+        }
+    }
+
+    delete [] storage;
+}
+
+}  // namespace http
+}  // namespace mf
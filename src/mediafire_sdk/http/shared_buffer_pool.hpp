@@ -0,0 +1,92 @@
+/**
+ * @file shared_buffer_pool.hpp
+ * @author Herbert Jones
+ * @brief Reusable storage for SharedBuffer.
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mediafire_sdk/http/shared_buffer.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace http {
+
+/**
+ * @class SharedBufferPool
+ * @brief Hands out SharedBuffers whose storage is reused once released.
+ *
+ * All storage is the same size, so buffers of any size up to BufferSize() can
+ * be acquired.  When the last handle to an acquired buffer goes away its
+ * storage is kept for the next Acquire, unless the pool already holds
+ * MaxIdleBuffers() or the pool itself is gone.  Safe to use from several
+ * threads.
+ */
+class SharedBufferPool :
+    public std::enable_shared_from_this<SharedBufferPool>
+{
+public:
+    /** Shared pointer acts as handle. */
+    using Pointer = std::shared_ptr<SharedBufferPool>;
+
+    /**
+     * @brief Create a pool.
+     *
+     * @param[in] buffer_size Size of the storage of every buffer.
+     * @param[in] max_idle_buffers Most unused buffers kept for reuse.
+     *
+     * @return SharedBufferPool handle
+     */
+    static Pointer Create(
+            uint64_t buffer_size,
+            std::size_t max_idle_buffers
+        );
+
+    ~SharedBufferPool();
+
+    /**
+     * @brief Get a buffer, reusing released storage when there is some.
+     *
+     * @param[in] size Size of the buffer, no more than BufferSize().
+     *
+     * @return SharedBuffer handle
+     */
+    SharedBuffer::Pointer Acquire(uint64_t size);
+
+    /**
+     * @return The size of the storage of every buffer.
+     */
+    uint64_t BufferSize() const { return buffer_size_; }
+
+    /**
+     * @return Most unused buffers kept for reuse.
+     */
+    std::size_t MaxIdleBuffers() const { return max_idle_buffers_; }
+
+    /**
+     * @return Number of unused buffers currently kept for reuse.
+     */
+    std::size_t IdleBuffers();
+
+private:
+    SharedBufferPool(
+            uint64_t buffer_size,
+            std::size_t max_idle_buffers
+        );
+
+    void Release(uint8_t * storage);
+
+    const uint64_t buffer_size_;
+    const std::size_t max_idle_buffers_;
+
+    mf::utils::mutex mutex_;
+    std::vector<uint8_t*> idle_;
+};
+
+}  // namespace http
+}  // namespace mf
@@ -0,0 +1,292 @@
+/**
+ * @file content_accumulator_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Counts the allocations, peak memory and time taken to collect a response
+ * body received in pieces into one string, either by appending each piece to
+ * a string, or with ContentAccumulator with and without a Content-Length
+ * header.  The received pieces themselves are not counted.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/http/content_accumulator.hpp"
+#include "mediafire_sdk/http/shared_buffer.hpp"
+
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+
+namespace {
+
+// Allocation tracking.  Each block carries its size in front of it so that
+// operator delete can account for it.
+std::atomic<int64_t> allocations(0);
+std::atomic<int64_t> current_bytes(0);
+std::atomic<int64_t> peak_bytes(0);
+
+const std::size_t kHeaderSize = alignof(std::max_align_t);
+
+void * TrackedAllocate(std::size_t size)
+{
+    void * block = std::malloc(size + kHeaderSize);
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *static_cast<std::size_t*>(block) = size;
+
+    ++allocations;
+
+    const int64_t now = current_bytes += static_cast<int64_t>(size);
+    int64_t peak = peak_bytes.load();
+    while (now > peak && ! peak_bytes.compare_exchange_weak(peak, now))
+        ;
+
+    return static_cast<char*>(block) + kHeaderSize;
+}
+
+void TrackedFree(void * memory)
+{
+    if (memory == nullptr)
+        return;
+
+    void * block = static_cast<char*>(memory) - kHeaderSize;
+    current_bytes -= static_cast<int64_t>(*static_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+}  // namespace
+
+void * operator new(std::size_t size) { return TrackedAllocate(size); }
+void * operator new[](std::size_t size) { return TrackedAllocate(size); }
+void operator delete(void * memory) noexcept { TrackedFree(memory); }
+void operator delete[](void * memory) noexcept { TrackedFree(memory); }
+void operator delete(void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+void operator delete[](void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+namespace {
+
+/** Size of the pieces the body is received in. */
+const std::size_t kPieceSize = 16 * 1024;
+
+using Pieces = std::vector<std::shared_ptr<mf::http::BufferInterface>>;
+
+Pieces CreatePieces(std::size_t size)
+{
+    Pieces pieces;
+
+    for (std::size_t pos = 0; pos < size; pos += kPieceSize)
+    {
+        const std::size_t piece_size = std::min(kPieceSize, size - pos);
+        pieces.push_back(mf::http::SharedBuffer::Create(
+            std::string(piece_size, 'x')));
+    }
+
+    return pieces;
+}
+
+mf::http::Headers CreateHeaders(const std::string & fields)
+{
+    mf::http::Headers headers;
+    headers.Parse("HTTP/1.1 200 OK\r\n" + fields + "\r\n", nullptr);
+    return headers;
+}
+
+struct Measurement
+{
+    double ms_per_body;
+    int64_t allocations;
+    int64_t peak_bytes;
+    bool failed;
+};
+
+/** Each piece appended to a string, as before. */
+std::string Append(
+        const mf::http::Headers &,
+        const Pieces & pieces
+    )
+{
+    std::string content;
+
+    for (const auto & piece : pieces)
+    {
+        content.append(reinterpret_cast<const char*>(piece->Data()),
+            piece->Size());
+    }
+
+    return content;
+}
+
+std::string Accumulate(
+        const mf::http::Headers & headers,
+        const Pieces & pieces
+    )
+{
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(headers);
+
+    for (const auto & piece : pieces)
+        accumulator.Append(piece);
+
+    return accumulator.Take();
+}
+
+template<typename Collect>
+Measurement Measure(
+        const mf::http::Headers & headers,
+        const Pieces & pieces,
+        std::size_t size,
+        uint32_t repeat,
+        Collect collect
+    )
+{
+    Measurement measurement = {0, 0, 0, false};
+
+    for (uint32_t i = 0; i < repeat; ++i)
+    {
+        const int64_t base = current_bytes.load();
+        const int64_t base_allocations = allocations.load();
+        peak_bytes = base;
+
+        const auto start = sclock::now();
+
+        {
+            const std::string content = collect(headers, pieces);
+            if (content.size() != size)
+                measurement.failed = true;
+        }
+
+        measurement.ms_per_body += std::chrono::duration<double,
+            std::milli>(sclock::now() - start).count();
+
+        measurement.allocations = std::max(measurement.allocations,
+            allocations.load() - base_allocations);
+        measurement.peak_bytes = std::max(measurement.peak_bytes,
+            peak_bytes.load() - base);
+    }
+
+    measurement.ms_per_body /= repeat;
+
+    return measurement;
+}
+
+bool Report(
+        std::size_t size,
+        uint32_t repeat
+    )
+{
+    const Pieces pieces = CreatePieces(size);
+
+    const mf::http::Headers no_length = CreateHeaders("");
+    const mf::http::Headers length = CreateHeaders("Content-Length: "
+        + std::to_string(size) + "\r\n");
+
+    struct Method
+    {
+        const char * name;
+        const mf::http::Headers * headers;
+        std::string (*collect)(const mf::http::Headers &, const Pieces &);
+    };
+
+    const Method methods[] = {
+        {"Append", &no_length, &Append},
+        {"Known length", &length, &Accumulate},
+        {"Unknown length", &no_length, &Accumulate},
+    };
+
+    std::cout << "\n" << size << " bytes in " << pieces.size() << " pieces\n"
+        << std::left << std::setw(16) << "Collect"
+        << std::right << std::setw(12) << "ms/body"
+        << std::setw(10) << "allocs"
+        << std::setw(14) << "peak KB"
+        << std::endl;
+
+    bool success = true;
+
+    for (const auto & method : methods)
+    {
+        const auto measurement = Measure(*method.headers, pieces, size,
+            repeat, method.collect);
+
+        std::cout << std::left << std::setw(16) << method.name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << measurement.ms_per_body
+            << std::setw(10) << measurement.allocations
+            << std::setprecision(1)
+            << std::setw(14) << measurement.peak_bytes / 1024.0
+            << std::endl;
+
+        if (measurement.failed)
+            success = false;
+    }
+
+    if ( ! success )
+        std::cerr << "Collected content does not match" << std::endl;
+
+    return success;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        std::vector<uint32_t> sizes_kb;
+        uint32_t repeat = 5;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("size", po::value<std::vector<uint32_t>>(&sizes_kb),
+                "Body size in KB, may be repeated. (1 1024 51200)")
+            ("repeat", po::value<uint32_t>(&repeat),
+                "Bodies collected per method. (5)");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        if (sizes_kb.empty())
+            sizes_kb = {1, 1024, 50 * 1024};
+
+        repeat = std::max(1u, repeat);
+
+        bool success = true;
+
+        for (const auto size_kb : sizes_kb)
+        {
+            success &= Report(size_kb * 1024, repeat);
+        }
+
+        return success ? 0 : 1;
+    }
+    catch (std::exception & err)
+    {
+        std::cerr << "Error: " << err.what() << std::endl;
+        return 1;
+    }
+}
@@ -161,6 +161,18 @@ void ExpectServerBase::RequestResponseErrorEvent(
     }
 }
 
+const mf::http::RequestTimings & ExpectServerBase::Timings() const
+{
+    return timings_;
+}
+
+void ExpectServerBase::RequestTimingsReceived(
+        const mf::http::RequestTimings & timings
+        )
+{
+    timings_ = timings;
+}
+
 void ExpectServerBase::RequestResponseCompleteEvent()
 {
     SetActionTimeout();
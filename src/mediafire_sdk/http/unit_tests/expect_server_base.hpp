@@ -92,6 +92,9 @@ public:
 
     std::error_code Error();
 
+    /** Timings of the request, once it completed. */
+    const mf::http::RequestTimings & Timings() const;
+
     void Push(ExpectNode node);
 
     // --- Overrides for mf::http::RequestResponseInterface ---
@@ -114,6 +117,10 @@ public:
             std::string error_text
             ) override;
 
+    virtual void RequestTimingsReceived(
+            const mf::http::RequestTimings & timings
+            ) override;
+
     virtual void RequestResponseCompleteEvent() override;
 
     // Apply visitors
@@ -147,6 +154,8 @@ protected:
 
     uint64_t total_read_;
 
+    mf::http::RequestTimings timings_;
+
     ExpectServerBase(
             boost::asio::io_service * io_service,
             std::shared_ptr<boost::asio::io_service::work> work,
@@ -55,9 +55,34 @@ ExpectServerSsl::Pointer ExpectServerSsl::Create(
         uint16_t port
     )
 {
-    std::unique_ptr<boost::asio::ssl::context> ssl_ctx(
-        new boost::asio::ssl::context(
-            boost::asio::ssl::context::sslv23_server ) );
+    return Create(io_service, work, port, CreateContext());
+}
+
+ExpectServerSsl::Pointer ExpectServerSsl::Create(
+        asio::io_service * io_service,
+        std::shared_ptr<asio::io_service::work> work,
+        uint16_t port,
+        std::shared_ptr<boost::asio::ssl::context> ssl_ctx
+    )
+{
+    std::shared_ptr<ExpectServerSsl> ptr(
+            new ExpectServerSsl(
+                io_service,
+                std::move(ssl_ctx),
+                work,
+                port
+                )
+            );
+
+    ptr->CreateInit();
+
+    return ptr;
+}
+
+std::shared_ptr<boost::asio::ssl::context> ExpectServerSsl::CreateContext()
+{
+    auto ssl_ctx = std::make_shared<boost::asio::ssl::context>(
+            boost::asio::ssl::context::sslv23_server );
 
     ssl_ctx->set_options(
         boost::asio::ssl::context::default_workarounds
@@ -72,23 +97,12 @@ ExpectServerSsl::Pointer ExpectServerSsl::Create(
             asio::const_buffer(kPemCertificate, strlen(kPemCertificate)),
             boost::asio::ssl::context::pem );
 
-    std::shared_ptr<ExpectServerSsl> ptr(
-            new ExpectServerSsl(
-                io_service,
-                std::move(ssl_ctx),
-                work,
-                port
-                )
-            );
-
-    ptr->CreateInit();
-
-    return ptr;
+    return ssl_ctx;
 }
 
 ExpectServerSsl::ExpectServerSsl(
         asio::io_service * io_service,
-        std::unique_ptr<boost::asio::ssl::context> ssl_ctx,
+        std::shared_ptr<boost::asio::ssl::context> ssl_ctx,
         std::shared_ptr<asio::io_service::work> work,
         uint16_t port
         ) :
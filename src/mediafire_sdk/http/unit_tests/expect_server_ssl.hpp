@@ -24,17 +24,29 @@ public:
             uint16_t port
             );
 
+    /**
+     * Servers sharing a context can resume each other's TLS sessions.
+     */
+    static Pointer Create(
+            boost::asio::io_service * io_service,
+            std::shared_ptr<boost::asio::io_service::work> work,
+            uint16_t port,
+            std::shared_ptr<boost::asio::ssl::context> ssl_ctx
+            );
+
+    static std::shared_ptr<boost::asio::ssl::context> CreateContext();
+
 private:
     boost::asio::ip::tcp::acceptor acceptor_;
 
-    std::unique_ptr<boost::asio::ssl::context> ssl_ctx_;
+    std::shared_ptr<boost::asio::ssl::context> ssl_ctx_;
     SslSocket ssl_socket_;
 
     bool ssl_started_;
 
     ExpectServerSsl(
             boost::asio::io_service * io_service,
-            std::unique_ptr<boost::asio::ssl::context> ssl_ctx,
+            std::shared_ptr<boost::asio::ssl::context> ssl_ctx,
             std::shared_ptr<boost::asio::io_service::work> work,
             uint16_t port
             );
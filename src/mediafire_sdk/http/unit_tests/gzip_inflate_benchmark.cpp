@@ -0,0 +1,347 @@
+/**
+ * @file gzip_inflate_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Measures the time and peak memory taken to decompress large gzip responses
+ * received in pieces, either held until complete and then decompressed with
+ * boost::iostreams, or decompressed piece by piece with GzipInflater.  The
+ * memory zlib allocates for its own state is not counted.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "boost/iostreams/copy.hpp"
+#include "boost/iostreams/device/array.hpp"
+#include "boost/iostreams/filter/gzip.hpp"
+#include "boost/iostreams/filtering_streambuf.hpp"
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/http/detail/gzip_inflater.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+
+namespace {
+
+// Allocation tracking.  Each block carries its size in front of it so that
+// operator delete can account for it.
+std::atomic<int64_t> current_bytes(0);
+std::atomic<int64_t> peak_bytes(0);
+
+const std::size_t kHeaderSize = alignof(std::max_align_t);
+
+void * TrackedAllocate(std::size_t size)
+{
+    void * block = std::malloc(size + kHeaderSize);
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *static_cast<std::size_t*>(block) = size;
+
+    const int64_t now = current_bytes += static_cast<int64_t>(size);
+    int64_t peak = peak_bytes.load();
+    while (now > peak && ! peak_bytes.compare_exchange_weak(peak, now))
+        ;
+
+    return static_cast<char*>(block) + kHeaderSize;
+}
+
+void TrackedFree(void * memory)
+{
+    if (memory == nullptr)
+        return;
+
+    void * block = static_cast<char*>(memory) - kHeaderSize;
+    current_bytes -= static_cast<int64_t>(*static_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+}  // namespace
+
+void * operator new(std::size_t size) { return TrackedAllocate(size); }
+void * operator new[](std::size_t size) { return TrackedAllocate(size); }
+void operator delete(void * memory) noexcept { TrackedFree(memory); }
+void operator delete[](void * memory) noexcept { TrackedFree(memory); }
+void operator delete(void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+void operator delete[](void * memory, std::size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+namespace {
+
+/** Size of the pieces the content is received in. */
+const std::size_t kPieceSize = 8 * 1024;
+
+/** As used by the response reader. */
+const uint64_t kInflateBufferSize = 1024 * 64;
+const std::size_t kInflateIdleBuffers = 4;
+
+/** A file listing, compressing about as well as API responses do. */
+std::string CreateContent(std::size_t size)
+{
+    std::ostringstream ss;
+    ss << "{\"response\":{\"folder_content\":{\"files\":[";
+
+    for (uint32_t i = 0; static_cast<std::size_t>(ss.tellp()) < size; ++i)
+    {
+        ss << "{\"quickkey\":\"q" << std::setw(14) << std::setfill('0')
+            << (i * 2654435761u) << "\",\"filename\":\"file " << i
+            << ".txt\",\"size\":\"" << (i * 977) << "\",\"revision\":\""
+            << i << "\"},";
+    }
+
+    ss << "{}]}}}";
+
+    return ss.str();
+}
+
+std::string Gzip(const std::string & content)
+{
+    std::string compressed;
+
+    boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(boost::iostreams::back_inserter(compressed));
+
+    boost::iostreams::array_source source(content.data(), content.size());
+    boost::iostreams::copy(source, out);
+
+    return compressed;
+}
+
+struct Measurement
+{
+    double ms_per_response;
+    double ms_to_first_output;
+    int64_t peak_bytes;
+    uint64_t output_bytes;
+    bool failed;
+};
+
+/** Everything held until complete, then decompressed at once. */
+void InflateWhole(
+        const std::string & compressed,
+        Measurement * measurement,
+        const sclock::time_point start
+    )
+{
+    std::vector<char> received;
+
+    for (std::size_t pos = 0; pos < compressed.size(); pos += kPieceSize)
+    {
+        const std::size_t size = std::min(kPieceSize,
+            compressed.size() - pos);
+        received.insert(received.end(), compressed.data() + pos,
+            compressed.data() + pos + size);
+    }
+
+    std::vector<uint8_t> output;
+
+    try {
+        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+        in.push(boost::iostreams::gzip_decompressor());
+        in.push(boost::iostreams::array_source(received.data(),
+            received.size()));
+        boost::iostreams::copy(in, std::back_inserter(output));
+    }
+    catch (std::exception & err)
+    {
+        std::cerr << "Inflate failed: " << err.what() << std::endl;
+        measurement->failed = true;
+    }
+
+    measurement->ms_to_first_output += std::chrono::duration<double,
+        std::milli>(sclock::now() - start).count();
+    measurement->output_bytes = output.size();
+}
+
+/** Each piece decompressed as it is received. */
+void InflateIncrementally(
+        const std::string & compressed,
+        Measurement * measurement,
+        const sclock::time_point start
+    )
+{
+    mf::http::detail::GzipInflater inflater(
+        mf::http::SharedBufferPool::Create(kInflateBufferSize,
+            kInflateIdleBuffers));
+
+    uint64_t output_bytes = 0;
+
+    auto output = [&](std::shared_ptr<mf::http::BufferInterface> buffer)
+        {
+            if (output_bytes == 0)
+            {
+                measurement->ms_to_first_output += std::chrono::duration<
+                    double, std::milli>(sclock::now() - start).count();
+            }
+            output_bytes += buffer->Size();
+        };
+
+    for (std::size_t pos = 0; pos < compressed.size(); pos += kPieceSize)
+    {
+        const std::size_t size = std::min(kPieceSize,
+            compressed.size() - pos);
+
+        if ( ! inflater.Decode(
+                reinterpret_cast<const uint8_t*>(compressed.data() + pos),
+                size, output) )
+            break;
+    }
+
+    if ( ! inflater.Finish() )
+    {
+        std::cerr << "Inflate failed: " << inflater.ErrorString()
+            << std::endl;
+        measurement->failed = true;
+    }
+
+    measurement->output_bytes = output_bytes;
+}
+
+template<typename Inflate>
+Measurement Measure(
+        const std::string & compressed,
+        uint32_t repeat,
+        Inflate inflate
+    )
+{
+    Measurement measurement = {0, 0, 0, 0, false};
+
+    for (uint32_t i = 0; i < repeat; ++i)
+    {
+        const int64_t base = current_bytes.load();
+        peak_bytes = base;
+
+        const auto start = sclock::now();
+
+        inflate(compressed, &measurement, start);
+
+        measurement.ms_per_response += std::chrono::duration<double,
+            std::milli>(sclock::now() - start).count();
+
+        measurement.peak_bytes = std::max(measurement.peak_bytes,
+            peak_bytes.load() - base);
+    }
+
+    measurement.ms_per_response /= repeat;
+    measurement.ms_to_first_output /= repeat;
+
+    return measurement;
+}
+
+bool Report(
+        const std::string & content,
+        uint32_t repeat
+    )
+{
+    const std::string compressed = Gzip(content);
+
+    struct Method
+    {
+        const char * name;
+        void (*inflate)(const std::string &, Measurement *,
+            const sclock::time_point);
+    };
+
+    const Method methods[] = {
+        {"Whole", &InflateWhole},
+        {"Incremental", &InflateIncrementally},
+    };
+
+    std::cout << "\n" << content.size() << " bytes, " << compressed.size()
+        << " compressed\n"
+        << std::left << std::setw(14) << "Inflate"
+        << std::right << std::setw(12) << "ms/resp"
+        << std::setw(12) << "ms/first"
+        << std::setw(14) << "peak KB"
+        << std::endl;
+
+    bool success = true;
+
+    for (const auto & method : methods)
+    {
+        const auto measurement = Measure(compressed, repeat, method.inflate);
+
+        std::cout << std::left << std::setw(14) << method.name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << measurement.ms_per_response
+            << std::setw(12) << measurement.ms_to_first_output
+            << std::setprecision(1)
+            << std::setw(14) << measurement.peak_bytes / 1024.0
+            << std::endl;
+
+        if (measurement.failed || measurement.output_bytes != content.size())
+            success = false;
+    }
+
+    if ( ! success )
+        std::cerr << "Decompressed content does not match" << std::endl;
+
+    return success;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        std::vector<uint32_t> sizes_mb;
+        uint32_t repeat = 5;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("size", po::value<std::vector<uint32_t>>(&sizes_mb),
+                "Decompressed size in MB, may be repeated. (1 8 32)")
+            ("repeat", po::value<uint32_t>(&repeat),
+                "Responses decompressed per method. (5)");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        if (sizes_mb.empty())
+            sizes_mb = {1, 8, 32};
+
+        repeat = std::max(1u, repeat);
+
+        bool success = true;
+
+        for (const auto size_mb : sizes_mb)
+        {
+            success &= Report(CreateContent(size_mb * 1024 * 1024), repeat);
+        }
+
+        return success ? 0 : 1;
+    }
+    catch (std::exception & err)
+    {
+        std::cerr << "Error: " << err.what() << std::endl;
+        return 1;
+    }
+}
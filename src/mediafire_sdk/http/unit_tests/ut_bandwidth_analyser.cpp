@@ -0,0 +1,130 @@
+/**
+ * @file ut_bandwidth_analyser.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "mediafire_sdk/http/bandwidth_analyser.hpp"
+
+#define BOOST_TEST_MODULE BandwidthAnalyserUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+using mf::http::BandwidthAnalyser;
+using sclock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(NothingRecorded)
+{
+    auto bwa = BandwidthAnalyser::Create();
+
+    const auto throughput = bwa->GetIncoming();
+    BOOST_CHECK_EQUAL(throughput.current, 0);
+    BOOST_CHECK_EQUAL(throughput.one_minute, 0);
+    BOOST_CHECK_EQUAL(throughput.fifteen_minutes, 0);
+    BOOST_CHECK_EQUAL(throughput.peak, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SteadyRate)
+{
+    auto bwa = BandwidthAnalyser::Create();
+    const auto start = sclock::now();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        const auto end = start + seconds(i) + milliseconds(500);
+        bwa->RecordIncomingBytes(1000000, end - milliseconds(100), end);
+    }
+
+    const auto throughput = bwa->GetIncoming(start + seconds(10));
+    BOOST_CHECK_CLOSE(static_cast<double>(throughput.current), 1000000, 1);
+    BOOST_CHECK_CLOSE(static_cast<double>(throughput.one_minute), 1000000, 1);
+    BOOST_CHECK_CLOSE(static_cast<double>(throughput.fifteen_minutes),
+        1000000, 1);
+    BOOST_CHECK_CLOSE(static_cast<double>(throughput.peak), 1000000, 1);
+}
+
+BOOST_AUTO_TEST_CASE(OldBytesLeaveWindows)
+{
+    auto bwa = BandwidthAnalyser::Create();
+    const auto start = sclock::now();
+
+    const auto end = start + milliseconds(500);
+    bwa->RecordOutgoingBytes(6000000, start, end);
+
+    const auto later = bwa->GetOutgoing(start + seconds(120));
+    BOOST_CHECK_EQUAL(later.current, 0);
+    BOOST_CHECK_EQUAL(later.one_minute, 0);
+    BOOST_CHECK_CLOSE(static_cast<double>(later.fifteen_minutes), 50000, 1);
+
+    // The busiest ten seconds is still remembered.
+    BOOST_CHECK_EQUAL(later.peak, 600000);
+
+    const auto much_later = bwa->GetOutgoing(start + seconds(20 * 60));
+    BOOST_CHECK_EQUAL(much_later.fifteen_minutes, 0);
+    BOOST_CHECK_EQUAL(much_later.peak, 0);
+}
+
+BOOST_AUTO_TEST_CASE(DirectionsAreSeparate)
+{
+    auto bwa = BandwidthAnalyser::Create();
+    const auto start = sclock::now();
+
+    const auto end = start + milliseconds(500);
+    bwa->RecordOutgoingBytes(5000, start, end);
+
+    BOOST_CHECK_EQUAL(bwa->GetIncoming(start + seconds(1)).one_minute, 0);
+    BOOST_CHECK_GT(bwa->GetOutgoing(start + seconds(1)).one_minute, 0);
+}
+
+BOOST_AUTO_TEST_CASE(LateRecordsDoNotOverwrite)
+{
+    auto bwa = BandwidthAnalyser::Create();
+    const auto start = sclock::now();
+
+    // Both land in the same slot, the second long after its window.
+    const auto recent = start + seconds(69) + milliseconds(500);
+    bwa->RecordIncomingBytes(590000, start, recent);
+    const auto stale = start + seconds(5) + milliseconds(500);
+    bwa->RecordIncomingBytes(100, start, stale);
+
+    // The window so far covers 59 seconds.
+    const auto throughput = bwa->GetIncoming(start + seconds(70));
+    BOOST_CHECK_CLOSE(static_cast<double>(throughput.one_minute), 10000, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentRecording)
+{
+    auto bwa = BandwidthAnalyser::Create();
+    const auto start = sclock::now();
+    const auto end = start + milliseconds(500);
+
+    const int thread_count = 8;
+    const int records = 10000;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&]()
+            {
+                for (int j = 0; j < records; ++j)
+                    bwa->RecordIncomingBytes(100, start, end);
+            });
+    }
+    for (auto & thread : threads)
+        thread.join();
+
+    // Nothing was lost between threads.
+    const auto throughput = bwa->GetIncoming(start + seconds(4));
+    BOOST_CHECK_CLOSE(static_cast<double>(throughput.one_minute),
+        thread_count * records * 100 / 4.0, 1);
+}
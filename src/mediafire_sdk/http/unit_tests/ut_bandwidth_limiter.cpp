@@ -0,0 +1,154 @@
+/**
+ * @file ut_bandwidth_limiter.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "mediafire_sdk/http/bandwidth_limiter.hpp"
+
+#define BOOST_TEST_MODULE BandwidthLimiterUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+using mf::http::BandwidthLimiter;
+using Direction = BandwidthLimiter::Direction;
+using sclock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+int64_t MillisecondsFromNow(sclock::time_point when)
+{
+    return std::chrono::duration_cast<milliseconds>(
+        when - sclock::now()).count();
+}
+
+/**
+ * Transfer pieces as fast as the limiter allows for a while.
+ *
+ * @return Bytes transferred by each transfer.
+ */
+std::vector<uint64_t> Saturate(
+        std::vector<BandwidthLimiter::Transfer::Pointer> transfers,
+        uint64_t piece_size,
+        milliseconds duration
+    )
+{
+    const auto end = sclock::now() + duration;
+
+    std::vector<uint64_t> transferred(transfers.size(), 0);
+    std::vector<sclock::time_point> release(transfers.size(), sclock::now());
+
+    for (;;)
+    {
+        // The transfer allowed to go next.
+        std::size_t next = 0;
+        for (std::size_t i = 1; i < transfers.size(); ++i)
+        {
+            if (release[i] < release[next])
+                next = i;
+        }
+
+        if (release[next] >= end)
+            break;
+
+        std::this_thread::sleep_until(release[next]);
+
+        transferred[next] += piece_size;
+        release[next] = transfers[next]->Consume(piece_size);
+    }
+
+    return transferred;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(NotLimitedByDefault)
+{
+    auto limiter = BandwidthLimiter::Create();
+    BOOST_CHECK( ! limiter->Limited(Direction::Upload) );
+    BOOST_CHECK( ! limiter->Limited(Direction::Download) );
+
+    auto transfer = limiter->StartTransfer(Direction::Download, 1);
+    BOOST_CHECK_LE(MillisecondsFromNow(transfer->Consume(1000000000)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(WaitsForRate)
+{
+    auto limiter = BandwidthLimiter::Create();
+    limiter->SetLimit(Direction::Download, 1000000, 0);
+    BOOST_CHECK_EQUAL(limiter->GetLimit(Direction::Download), 1000000);
+
+    auto transfer = limiter->StartTransfer(Direction::Download, 1);
+
+    const auto wait = MillisecondsFromNow(transfer->Consume(100000));
+    BOOST_CHECK_GE(wait, 90);
+    BOOST_CHECK_LE(wait, 100);
+}
+
+BOOST_AUTO_TEST_CASE(BurstIsNotWaitedOn)
+{
+    auto limiter = BandwidthLimiter::Create();
+    limiter->SetLimit(Direction::Upload, 1000000, 50000);
+    BOOST_CHECK_EQUAL(limiter->GetBurst(Direction::Upload), 50000);
+
+    auto transfer = limiter->StartTransfer(Direction::Upload, 1);
+
+    BOOST_CHECK_LE(MillisecondsFromNow(transfer->Consume(50000)), 0);
+
+    // The burst is used up.
+    const auto wait = MillisecondsFromNow(transfer->Consume(50000));
+    BOOST_CHECK_GE(wait, 45);
+    BOOST_CHECK_LE(wait, 50);
+}
+
+BOOST_AUTO_TEST_CASE(DirectionsAreSeparate)
+{
+    auto limiter = BandwidthLimiter::Create();
+    limiter->SetLimit(Direction::Upload, 1000, 0);
+
+    auto upload = limiter->StartTransfer(Direction::Upload, 1);
+    auto download = limiter->StartTransfer(Direction::Download, 1);
+
+    BOOST_CHECK_GT(MillisecondsFromNow(upload->Consume(1000)), 900);
+    BOOST_CHECK_LE(MillisecondsFromNow(download->Consume(1000)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SharesByWeight)
+{
+    auto limiter = BandwidthLimiter::Create();
+    limiter->SetLimit(Direction::Download, 1000000, 0);
+
+    const auto transferred = Saturate({
+            limiter->StartTransfer(Direction::Download, 1),
+            limiter->StartTransfer(Direction::Download, 3)
+        }, 5000, milliseconds(600));
+
+    const double total = transferred[0] + transferred[1];
+    BOOST_CHECK_GT(total, 600000 * 0.8);
+    BOOST_CHECK_LT(total, 600000 * 1.2);
+
+    const double ratio = static_cast<double>(transferred[1]) / transferred[0];
+    BOOST_CHECK_GT(ratio, 2.4);
+    BOOST_CHECK_LT(ratio, 3.6);
+}
+
+BOOST_AUTO_TEST_CASE(UnusedShareGoesToOthers)
+{
+    auto limiter = BandwidthLimiter::Create();
+    limiter->SetLimit(Direction::Download, 1000000, 0);
+
+    // Started, but transfers nothing.
+    auto idle = limiter->StartTransfer(Direction::Download, 1);
+
+    const auto transferred = Saturate({
+            limiter->StartTransfer(Direction::Download, 1)
+        }, 5000, milliseconds(300));
+
+    BOOST_CHECK_GT(transferred[0], 300000 * 0.8);
+    BOOST_CHECK_LT(transferred[0], 300000 * 1.2);
+}
@@ -0,0 +1,192 @@
+/**
+ * @file ut_content_accumulator.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "mediafire_sdk/http/content_accumulator.hpp"
+#include "mediafire_sdk/http/shared_buffer.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+
+#define BOOST_TEST_MODULE ContentAccumulatorUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+mf::http::Headers ParseHeaders(const std::string & fields)
+{
+    mf::http::Headers headers;
+    BOOST_REQUIRE( headers.Parse("HTTP/1.1 200 OK\r\n" + fields + "\r\n",
+            nullptr) );
+    return headers;
+}
+
+void AppendPieces(
+        mf::http::ContentAccumulator * accumulator,
+        const std::string & content,
+        std::size_t piece_size
+    )
+{
+    for (std::size_t pos = 0; pos < content.size(); pos += piece_size)
+    {
+        accumulator->Append(mf::http::SharedBuffer::Create(
+                content.substr(pos, piece_size)));
+    }
+}
+
+/** Append content in pieces from a pool, as the response is read. */
+void AppendPooledPieces(
+        mf::http::ContentAccumulator * accumulator,
+        mf::http::SharedBufferPool::Pointer pool,
+        const std::string & content,
+        std::size_t piece_size
+    )
+{
+    for (std::size_t pos = 0; pos < content.size(); pos += piece_size)
+    {
+        const std::size_t size = std::min(piece_size, content.size() - pos);
+        auto buffer = pool->Acquire(size);
+        std::memcpy(buffer->Data(), content.data() + pos, size);
+        accumulator->Append(std::move(buffer));
+    }
+}
+
+const uint64_t kPoolBufferSize = 1024 * 64;
+
+const std::string kContent =
+    "{\"response\":{\"action\":\"user/get_info\",\"result\":\"Success\"}}";
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(KnownLength)
+{
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(ParseHeaders("Content-Length: "
+            + std::to_string(kContent.size()) + "\r\n"));
+
+    AppendPieces(&accumulator, kContent, 7);
+    BOOST_CHECK_EQUAL( accumulator.Size(), kContent.size() );
+
+    const std::string content = accumulator.Take();
+    BOOST_CHECK_EQUAL( content, kContent );
+
+    // Sized once up front.
+    BOOST_CHECK_EQUAL( content.capacity(), kContent.size() );
+
+    BOOST_CHECK_EQUAL( accumulator.Size(), 0 );
+    BOOST_CHECK( accumulator.Take().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(UnknownLength)
+{
+    for (const std::string & fields : {std::string(),
+            std::string("Transfer-Encoding: chunked\r\n"),
+            std::string("Content-Length: 12\r\nContent-Encoding: gzip\r\n"),
+            std::string("Content-Length: twelve\r\n")})
+    {
+        mf::http::ContentAccumulator accumulator;
+        accumulator.Start(ParseHeaders(fields));
+
+        AppendPieces(&accumulator, kContent, 5);
+        BOOST_CHECK_EQUAL( accumulator.Size(), kContent.size() );
+        BOOST_CHECK_EQUAL( accumulator.Take(), kContent );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WrongLength)
+{
+    // The header is only a hint.
+    for (const std::size_t length : {std::size_t(0), std::size_t(10),
+            kContent.size() * 2})
+    {
+        mf::http::ContentAccumulator accumulator;
+        accumulator.Start(ParseHeaders("Content-Length: "
+                + std::to_string(length) + "\r\n"));
+
+        AppendPieces(&accumulator, kContent, 3);
+        BOOST_CHECK_EQUAL( accumulator.Take(), kContent );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(HugeLengthNotReserved)
+{
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(ParseHeaders("Content-Length: 1000000000000\r\n"));
+
+    AppendPieces(&accumulator, kContent, 11);
+    const std::string content = accumulator.Take();
+    BOOST_CHECK_EQUAL( content, kContent );
+    BOOST_CHECK( content.capacity() < mf::http::ContentAccumulator::MaxReserve() );
+}
+
+BOOST_AUTO_TEST_CASE(StartDiscards)
+{
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(ParseHeaders(""));
+    AppendPieces(&accumulator, "Moved", 2);
+
+    accumulator.Start(ParseHeaders(""));
+    AppendPieces(&accumulator, kContent, 9);
+    BOOST_CHECK_EQUAL( accumulator.Take(), kContent );
+}
+
+BOOST_AUTO_TEST_CASE(SmallPiecesHeldCompactly)
+{
+    // Like a decoded response, where the length is not known and pieces are
+    // much smaller than the pooled buffers they arrive in.
+    auto pool = mf::http::SharedBufferPool::Create(kPoolBufferSize, 1000);
+
+    std::string content;
+    while (content.size() < 1024 * 1024)
+        content += kContent;
+
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(ParseHeaders("Content-Encoding: gzip\r\n"));
+    AppendPooledPieces(&accumulator, pool, content, 1000);
+
+    // No pooled buffer is kept, and what is held is near the content size.
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 1u );
+    BOOST_CHECK_GE( accumulator.Held(), content.size() );
+    BOOST_CHECK_LE( accumulator.Held(), content.size() + kPoolBufferSize );
+
+    BOOST_CHECK_EQUAL( accumulator.Take(), content );
+}
+
+BOOST_AUTO_TEST_CASE(SmallContentHeldCompactly)
+{
+    auto pool = mf::http::SharedBufferPool::Create(kPoolBufferSize, 1000);
+
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(ParseHeaders("Transfer-Encoding: chunked\r\n"));
+    AppendPooledPieces(&accumulator, pool, kContent, 16);
+
+    // A small copy, rather than a pooled buffer for each piece.
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 1u );
+    BOOST_CHECK_LE( accumulator.Held(), 1024u );
+    BOOST_CHECK_EQUAL( accumulator.Take(), kContent );
+}
+
+BOOST_AUTO_TEST_CASE(FullBuffersKept)
+{
+    auto pool = mf::http::SharedBufferPool::Create(kPoolBufferSize, 1000);
+
+    std::string content;
+    while (content.size() < kPoolBufferSize * 4)
+        content += kContent;
+    content.resize(kPoolBufferSize * 4);
+
+    mf::http::ContentAccumulator accumulator;
+    accumulator.Start(ParseHeaders(""));
+    AppendPooledPieces(&accumulator, pool, content, kPoolBufferSize);
+
+    // Kept rather than copied, so the storage is still in use.
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 0u );
+    BOOST_CHECK_EQUAL( accumulator.Held(), content.size() );
+
+    BOOST_CHECK_EQUAL( accumulator.Take(), content );
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 4u );
+}
@@ -0,0 +1,192 @@
+/**
+ * @file ut_content_decoder.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
+#include "mediafire_sdk/http/detail/encoding.hpp"
+
+#if defined(HTTP_USE_BROTLI)
+#   include "brotli/encode.h"
+#endif
+#if defined(HTTP_USE_ZSTD)
+#   include "zstd.h"
+#endif
+
+#define BOOST_TEST_MODULE ContentDecoderUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+using mf::http::detail::ContentDecoderInterface;
+using mf::http::detail::CreateContentDecoder;
+
+std::unique_ptr<ContentDecoderInterface> CreateDecoder(int content_encoding)
+{
+    return CreateContentDecoder(content_encoding,
+        mf::http::SharedBufferPool::Create(4096, 2));
+}
+
+#if defined(HTTP_USE_BROTLI) || defined(HTTP_USE_ZSTD)
+std::string CreateContent(std::size_t size)
+{
+    std::string content;
+    content.reserve(size);
+
+    uint32_t seed = 1;
+    while (content.size() < size)
+    {
+        // Compressible, but not trivially.
+        seed = seed * 1103515245 + 12345;
+        content += "{\"quickkey\":\"" + std::to_string(seed % 100000) + "\"},";
+    }
+    content.resize(size);
+
+    return content;
+}
+
+/** Decode the encoded data in pieces of piece_size. */
+bool Decode(
+        ContentDecoderInterface * decoder,
+        const std::string & encoded,
+        std::size_t piece_size,
+        std::string * output
+    )
+{
+    for (std::size_t pos = 0; pos < encoded.size(); pos += piece_size)
+    {
+        const std::size_t size = std::min(piece_size, encoded.size() - pos);
+
+        const bool success = decoder->Decode(
+            reinterpret_cast<const uint8_t*>(encoded.data() + pos), size,
+            [output](std::shared_ptr<mf::http::BufferInterface> buffer)
+            {
+                BOOST_CHECK( buffer->Size() > 0 );
+                output->append(reinterpret_cast<const char*>(buffer->Data()),
+                    buffer->Size());
+            });
+
+        if ( ! success )
+            return false;
+    }
+
+    return true;
+}
+
+/** Check decoding of well formed, truncated and corrupt content. */
+void CheckDecoder(
+        int content_encoding,
+        const std::string & content,
+        const std::string & encoded
+    )
+{
+    for (std::size_t piece_size : {1, 7, 4096, 1024 * 1024})
+    {
+        auto decoder = CreateDecoder(content_encoding);
+        BOOST_REQUIRE( decoder );
+
+        std::string output;
+        BOOST_REQUIRE( Decode(decoder.get(), encoded, piece_size, &output) );
+        BOOST_CHECK( decoder->Finish() );
+        BOOST_CHECK( output == content );
+    }
+
+    // Cut short.
+    {
+        auto decoder = CreateDecoder(content_encoding);
+        std::string output;
+        BOOST_REQUIRE( Decode(decoder.get(),
+            encoded.substr(0, encoded.size() - 10), 100, &output) );
+        BOOST_CHECK( ! decoder->Finish() );
+        BOOST_CHECK( ! decoder->ErrorString().empty() );
+    }
+
+    // Not encoded at all.
+    {
+        auto decoder = CreateDecoder(content_encoding);
+        std::string output;
+        BOOST_CHECK( ! Decode(decoder.get(), "<html>Bad gateway</html>", 100,
+                &output)
+            || ! decoder->Finish() );
+        BOOST_CHECK( ! decoder->ErrorString().empty() );
+    }
+}
+
+#endif
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(CreatesSupportedDecoders)
+{
+    BOOST_CHECK( CreateDecoder(mf::http::detail::CE_Gzip) );
+
+#if defined(HTTP_USE_BROTLI)
+    BOOST_CHECK( CreateDecoder(mf::http::detail::CE_Brotli) );
+#else
+    BOOST_CHECK( ! CreateDecoder(mf::http::detail::CE_Brotli) );
+#endif
+
+#if defined(HTTP_USE_ZSTD)
+    BOOST_CHECK( CreateDecoder(mf::http::detail::CE_Zstd) );
+#else
+    BOOST_CHECK( ! CreateDecoder(mf::http::detail::CE_Zstd) );
+#endif
+
+    // Unknown and stacked codings are not decoded.
+    BOOST_CHECK( ! CreateDecoder(mf::http::detail::CE_Unknown) );
+    BOOST_CHECK( ! CreateDecoder(mf::http::detail::CE_Gzip
+        | mf::http::detail::CE_Brotli) );
+}
+
+#if defined(HTTP_USE_BROTLI)
+BOOST_AUTO_TEST_CASE(DecodesBrotli)
+{
+    // Ends exactly at the end of an output buffer.
+    const std::string content = CreateContent(4096 * 75);
+
+    std::string encoded(BrotliEncoderMaxCompressedSize(content.size()), '\0');
+    std::size_t encoded_size = encoded.size();
+    BOOST_REQUIRE( BrotliEncoderCompress(BROTLI_DEFAULT_QUALITY,
+        BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, content.size(),
+        reinterpret_cast<const uint8_t*>(content.data()), &encoded_size,
+        reinterpret_cast<uint8_t*>(&encoded[0])) );
+    encoded.resize(encoded_size);
+
+    CheckDecoder(mf::http::detail::CE_Brotli, content, encoded);
+
+    // Nothing may follow the end of the stream.
+    auto decoder = CreateDecoder(mf::http::detail::CE_Brotli);
+    std::string output;
+    BOOST_CHECK( ! Decode(decoder.get(), encoded + "garbage", 100, &output) );
+    BOOST_CHECK( ! decoder->ErrorString().empty() );
+}
+#endif
+
+#if defined(HTTP_USE_ZSTD)
+BOOST_AUTO_TEST_CASE(DecodesZstd)
+{
+    // Ends exactly at the end of an output buffer.
+    const std::string content = CreateContent(4096 * 75);
+
+    std::string encoded(ZSTD_compressBound(content.size()), '\0');
+    const std::size_t encoded_size = ZSTD_compress(&encoded[0],
+        encoded.size(), content.data(), content.size(), 3);
+    BOOST_REQUIRE( ! ZSTD_isError(encoded_size) );
+    encoded.resize(encoded_size);
+
+    CheckDecoder(mf::http::detail::CE_Zstd, content, encoded);
+
+    // Concatenated frames are decoded as one content.
+    auto decoder = CreateDecoder(mf::http::detail::CE_Zstd);
+    std::string output;
+    BOOST_REQUIRE( Decode(decoder.get(), encoded + encoded, 1000, &output) );
+    BOOST_CHECK( decoder->Finish() );
+    BOOST_CHECK( output == content + content );
+}
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file ut_gzip_inflater.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zlib.h"
+
+#include "mediafire_sdk/http/detail/gzip_inflater.hpp"
+#define BOOST_TEST_MODULE GzipInflaterUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+using mf::http::detail::GzipInflater;
+
+std::string Compress(const std::string & input, int window_bits)
+{
+    z_stream z = z_stream();
+    BOOST_REQUIRE_EQUAL( deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+        window_bits, 8, Z_DEFAULT_STRATEGY), Z_OK );
+
+    std::string output(deflateBound(&z, input.size()), '\0');
+
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    z.avail_in = static_cast<uInt>(input.size());
+    z.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    z.avail_out = static_cast<uInt>(output.size());
+
+    BOOST_REQUIRE_EQUAL( deflate(&z, Z_FINISH), Z_STREAM_END );
+    output.resize(z.total_out);
+    deflateEnd(&z);
+
+    return output;
+}
+
+std::string Gzip(const std::string & input)
+{
+    return Compress(input, MAX_WBITS + 16);
+}
+
+std::string CreateContent(std::size_t size)
+{
+    std::string content;
+    content.reserve(size);
+
+    uint32_t seed = 1;
+    while (content.size() < size)
+    {
+        // Compressible, but not trivially.
+        seed = seed * 1103515245 + 12345;
+        content += "{\"quickkey\":\"" + std::to_string(seed % 100000) + "\"},";
+    }
+    content.resize(size);
+
+    return content;
+}
+
+/** Inflate the compressed data in pieces of piece_size. */
+bool Inflate(
+        GzipInflater * inflater,
+        const std::string & compressed,
+        std::size_t piece_size,
+        std::string * output,
+        std::size_t * buffers = nullptr
+    )
+{
+    for (std::size_t pos = 0; pos < compressed.size(); pos += piece_size)
+    {
+        const std::size_t size = std::min(piece_size,
+            compressed.size() - pos);
+
+        const bool success = inflater->Decode(
+            reinterpret_cast<const uint8_t*>(compressed.data() + pos), size,
+            [output, buffers](std::shared_ptr<mf::http::BufferInterface> buffer)
+            {
+                BOOST_CHECK( buffer->Size() > 0 );
+                output->append(reinterpret_cast<const char*>(buffer->Data()),
+                    buffer->Size());
+                if (buffers)
+                    ++*buffers;
+            });
+
+        if ( ! success )
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(InflatesInAnyPieces)
+{
+    const std::string content = CreateContent(300000);
+    const std::string compressed = Gzip(content);
+
+    for (std::size_t piece_size : {1, 7, 4096, 1024 * 1024})
+    {
+        GzipInflater inflater(mf::http::SharedBufferPool::Create(16384, 2));
+        std::string output;
+
+        BOOST_REQUIRE( Inflate(&inflater, compressed, piece_size, &output) );
+        BOOST_CHECK( inflater.Finish() );
+        BOOST_CHECK( output == content );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(EmitsOutputPerPiece)
+{
+    const std::string content = CreateContent(200000);
+    const std::string compressed = Gzip(content);
+
+    auto pool = mf::http::SharedBufferPool::Create(4096, 2);
+    GzipInflater inflater(pool);
+
+    // The first piece produces output without waiting for the rest.
+    std::string output;
+    BOOST_REQUIRE( Inflate(&inflater, compressed.substr(0, 1024), 1024,
+        &output) );
+    BOOST_CHECK( ! output.empty() );
+    BOOST_CHECK( content.compare(0, output.size(), output) == 0 );
+
+    // Each buffer is released at once, so a single one is reused throughout.
+    std::size_t buffers = 0;
+    BOOST_REQUIRE( Inflate(&inflater, compressed.substr(1024), 1024, &output,
+        &buffers) );
+    BOOST_CHECK( inflater.Finish() );
+    BOOST_CHECK( output == content );
+    BOOST_CHECK( buffers > 2 );
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE(AcceptsZlibAndConcatenatedMembers)
+{
+    const std::string first = CreateContent(5000);
+    const std::string second = "second member";
+
+    {
+        GzipInflater inflater(mf::http::SharedBufferPool::Create(1024, 2));
+        std::string output;
+        BOOST_REQUIRE( Inflate(&inflater, Gzip(first) + Gzip(second), 100,
+            &output) );
+        BOOST_CHECK( inflater.Finish() );
+        BOOST_CHECK( output == first + second );
+    }
+
+    {
+        GzipInflater inflater(mf::http::SharedBufferPool::Create(1024, 2));
+        std::string output;
+        BOOST_REQUIRE( Inflate(&inflater, Compress(first, MAX_WBITS), 100,
+            &output) );
+        BOOST_CHECK( inflater.Finish() );
+        BOOST_CHECK( output == first );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RejectsBadContent)
+{
+    const std::string compressed = Gzip(CreateContent(5000));
+
+    // Cut short.
+    {
+        GzipInflater inflater(mf::http::SharedBufferPool::Create(1024, 2));
+        std::string output;
+        BOOST_REQUIRE( Inflate(&inflater,
+            compressed.substr(0, compressed.size() - 10), 100, &output) );
+        BOOST_CHECK( ! inflater.Finish() );
+        BOOST_CHECK( ! inflater.ErrorString().empty() );
+    }
+
+    // Corrupted.
+    {
+        std::string corrupted = compressed;
+        corrupted[corrupted.size() / 2] ^= 0x55;
+        corrupted[corrupted.size() - 6] ^= 0x55;
+
+        GzipInflater inflater(mf::http::SharedBufferPool::Create(1024, 2));
+        std::string output;
+        BOOST_CHECK( ! Inflate(&inflater, corrupted, 100, &output)
+            || ! inflater.Finish() );
+        BOOST_CHECK( ! inflater.ErrorString().empty() );
+    }
+
+    // Not compressed at all.
+    {
+        GzipInflater inflater(mf::http::SharedBufferPool::Create(1024, 2));
+        std::string output;
+        BOOST_CHECK( ! Inflate(&inflater, "<html>Bad gateway</html>", 100,
+            &output) );
+        BOOST_CHECK( ! inflater.ErrorString().empty() );
+    }
+}
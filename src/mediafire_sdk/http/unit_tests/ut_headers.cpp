@@ -0,0 +1,131 @@
+/**
+ * @file ut_headers.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <string>
+#include <vector>
+
+#include "mediafire_sdk/http/headers.hpp"
+
+#define BOOST_TEST_MODULE HeadersUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+std::string ToString(const mf::http::HeaderValue & value)
+{
+    return std::string(value.begin(), value.end());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ParsesStatusAndHeaders)
+{
+    mf::http::Headers headers;
+    std::string http_version;
+
+    BOOST_REQUIRE( headers.Parse(
+            "HTTP/1.1 404 Not Found\r\n"
+            "Content-Type: text/html\r\n"
+            "Content-Length:  24 \r\n"
+            "\r\n",
+            &http_version) );
+
+    BOOST_CHECK_EQUAL( http_version, "HTTP/1.1" );
+    BOOST_CHECK_EQUAL( headers.status_code, 404 );
+    BOOST_CHECK_EQUAL( headers.status_message, "Not Found" );
+    BOOST_REQUIRE_EQUAL( headers.Size(), 2 );
+    BOOST_CHECK_EQUAL( ToString(headers.Name(0)), "Content-Type" );
+    BOOST_CHECK_EQUAL( ToString(headers.Value(1)), "24" );
+}
+
+BOOST_AUTO_TEST_CASE(FindIsCaseInsensitive)
+{
+    mf::http::Headers headers;
+
+    BOOST_REQUIRE( headers.Parse(
+            "HTTP/1.0 200 OK\r\n"
+            "X-Repeated: first\r\n"
+            "CONTENT-ENCODING: gzip\r\n"
+            "x-repeated: second\r\n"
+            "\r\n",
+            nullptr) );
+
+    auto value = headers.Find("content-encoding");
+    BOOST_REQUIRE( value );
+    BOOST_CHECK_EQUAL( ToString(*value), "gzip" );
+
+    value = headers.Find("X-REPEATED");
+    BOOST_REQUIRE( value );
+    BOOST_CHECK_EQUAL( ToString(*value), "first" );
+
+    BOOST_CHECK( ! headers.Find("content-encodin") );
+    BOOST_CHECK( ! headers.Find("location") );
+}
+
+BOOST_AUTO_TEST_CASE(JoinsFoldedLines)
+{
+    mf::http::Headers headers;
+
+    BOOST_REQUIRE( headers.Parse(
+            "HTTP/1.1 200 OK\n"
+            "X-Folded: one\n"
+            "  two\n"
+            "\tthree\n"
+            "X-After: four\n"
+            "\n",
+            nullptr) );
+
+    BOOST_CHECK_EQUAL( ToString(*headers.Find("x-folded")), "one two three" );
+    BOOST_CHECK_EQUAL( ToString(*headers.Find("x-after")), "four" );
+
+    // Values stay valid in copies.
+    const mf::http::Headers copy = headers;
+    headers = mf::http::Headers();
+    BOOST_CHECK_EQUAL( ToString(*copy.Find("x-folded")), "one two three" );
+    BOOST_CHECK_EQUAL( ToString(*copy.Find("x-after")), "four" );
+}
+
+BOOST_AUTO_TEST_CASE(HeaderMapKeepsFirstOfRepeated)
+{
+    mf::http::Headers headers;
+
+    BOOST_REQUIRE( headers.Parse(
+            "HTTP/1.1 200 OK\r\n"
+            "Set-Cookie: a=1\r\n"
+            "Set-Cookie: b=2\r\n"
+            "Not a header\r\n"
+            "Location: http://www.mediafire.com/\r\n"
+            "\r\n",
+            nullptr) );
+
+    const auto map = headers.HeaderMap();
+    BOOST_REQUIRE_EQUAL( map.size(), 2 );
+    BOOST_CHECK_EQUAL( map.at("set-cookie"), "a=1" );
+    BOOST_CHECK_EQUAL( map.at("location"), "http://www.mediafire.com/" );
+}
+
+BOOST_AUTO_TEST_CASE(RejectsBadStatusLine)
+{
+    mf::http::Headers headers;
+
+    BOOST_CHECK( ! headers.Parse("", nullptr) );
+    BOOST_CHECK( ! headers.Parse("<html>\r\n\r\n", nullptr) );
+    BOOST_CHECK( ! headers.Parse("HTTP/1.1 OK\r\n\r\n", nullptr) );
+    BOOST_CHECK( ! headers.Parse("HTTP/1.1 200 OK\r\n continued\r\n\r\n",
+            nullptr) );
+}
+
+BOOST_AUTO_TEST_CASE(SplitsTokens)
+{
+    const std::string value = " gzip,, chunked ,br";
+    const auto tokens = mf::http::SplitHeaderTokens(
+        mf::http::HeaderValue(value.data(), value.data() + value.size()));
+
+    BOOST_REQUIRE_EQUAL( tokens.size(), 3 );
+    BOOST_CHECK_EQUAL( ToString(tokens[0]), "gzip" );
+    BOOST_CHECK_EQUAL( ToString(tokens[1]), "chunked" );
+    BOOST_CHECK_EQUAL( ToString(tokens[2]), "br" );
+}
@@ -0,0 +1,783 @@
+/**
+ * @file ut_http2.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/http_config.hpp"
+#include "mediafire_sdk/http/http_request.hpp"
+#include "mediafire_sdk/http/post_data_pipe_interface.hpp"
+
+#include "mediafire_sdk/http/unit_tests/expect_server_ssl.hpp"
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#include "boost/iostreams/device/back_inserter.hpp"
+#include "boost/iostreams/filter/gzip.hpp"
+#include "boost/iostreams/filtering_stream.hpp"
+
+#include "nghttp2/nghttp2.h"
+
+#define BOOST_TEST_MODULE Http2UnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace asio = boost::asio;
+
+namespace {
+
+const uint16_t kPort = 49993;
+const std::string kUrlBase = "https://127.0.0.1:49993";
+
+using mf::http::HttpConfig;
+using mf::http::HttpRequest;
+
+std::string CreateContent(std::size_t size)
+{
+    std::string content;
+    content.reserve(size);
+
+    uint32_t seed = 1;
+    while (content.size() < size)
+    {
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>('a' + (seed >> 16) % 26));
+    }
+
+    return content;
+}
+
+std::string Gzip(const std::string & content)
+{
+    std::string compressed;
+
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(boost::iostreams::back_inserter(compressed));
+    out << content;
+    out.reset();
+
+    return compressed;
+}
+
+const std::string kLargeContent = CreateContent(5 * 1024 * 1024);
+const std::string kPlainContent = "Plain content.";
+
+/**
+ * Test server speaking HTTP/2 when the client offers it, and HTTP/1.1
+ * otherwise, or when told not to offer HTTP/2.
+ *
+ * GET /large responds with kLargeContent, /gzip with kPlainContent gzipped,
+ * /stall never responds, and anything else with kPlainContent.  POST echoes
+ * the request content.
+ */
+class Http2Server : public std::enable_shared_from_this<Http2Server>
+{
+public:
+    using Pointer = std::shared_ptr<Http2Server>;
+
+    static Pointer Create(asio::io_service * io_service, bool offer_http2)
+    {
+        auto server = Pointer(new Http2Server(io_service, offer_http2));
+        server->Accept();
+        return server;
+    }
+
+    ~Http2Server()
+    {
+        for (auto & connection : connections_)
+            nghttp2_session_del(connection->session);
+    }
+
+    void Stop()
+    {
+        acceptor_.close();
+        for (auto & connection : connections_)
+            connection->socket.lowest_layer().close();
+    }
+
+    std::size_t Accepted() const { return accepted_; }
+    std::size_t Http2Accepted() const { return http2_accepted_; }
+
+private:
+    using SslStream = asio::ssl::stream<asio::ip::tcp::socket>;
+
+    struct Stream
+    {
+        std::string method;
+        std::string path;
+        std::string request_content;
+        std::string response_content;
+        std::size_t sent = 0;
+    };
+
+    struct Connection
+    {
+        Connection(asio::io_service * io_service, asio::ssl::context & ctx) :
+            socket(*io_service, ctx),
+            session(nullptr),
+            writing(false)
+        {}
+
+        SslStream socket;
+        nghttp2_session * session;
+        bool writing;
+        std::array<uint8_t, 16 * 1024> read_buffer;
+        std::string write_buffer;
+        asio::streambuf http1_buffer;
+        std::map<int32_t, Stream> streams;
+    };
+    using ConnectionPointer = std::shared_ptr<Connection>;
+
+    Http2Server(asio::io_service * io_service, bool offer_http2) :
+        io_service_(io_service),
+        ssl_ctx_(ExpectServerSsl::CreateContext()),
+        acceptor_(*io_service, asio::ip::tcp::endpoint(
+                asio::ip::address::from_string("127.0.0.1"), kPort)),
+        offer_http2_(offer_http2),
+        accepted_(0),
+        http2_accepted_(0)
+    {
+        SSL_CTX_set_alpn_select_cb(ssl_ctx_->native_handle(), &SelectProtocol,
+            this);
+    }
+
+    static int SelectProtocol(SSL *, const unsigned char ** out,
+        unsigned char * outlen, const unsigned char * in, unsigned int inlen,
+        void * arg)
+    {
+        auto server = static_cast<Http2Server*>(arg);
+        if ( server->offer_http2_ && nghttp2_select_next_protocol(
+                const_cast<unsigned char**>(out), outlen, in, inlen) == 1 )
+        {
+            return SSL_TLSEXT_ERR_OK;
+        }
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+
+    void Accept()
+    {
+        auto self = shared_from_this();
+        auto connection = std::make_shared<Connection>(io_service_, *ssl_ctx_);
+
+        acceptor_.async_accept(connection->socket.lowest_layer(),
+            [this, self, connection](const boost::system::error_code & err)
+            {
+                if (err)
+                    return;
+
+                ++accepted_;
+                connections_.push_back(connection);
+                Handshake(connection);
+                Accept();
+            });
+    }
+
+    void Handshake(ConnectionPointer connection)
+    {
+        auto self = shared_from_this();
+        connection->socket.async_handshake(SslStream::server,
+            [this, self, connection](const boost::system::error_code & err)
+            {
+                if (err)
+                    return;
+
+                const unsigned char * protocol = nullptr;
+                unsigned int length = 0;
+                SSL_get0_alpn_selected(connection->socket.native_handle(),
+                    &protocol, &length);
+
+                if (length == 2 && std::memcmp(protocol, "h2", 2) == 0)
+                {
+                    ++http2_accepted_;
+                    StartHttp2(connection);
+                }
+                else
+                {
+                    ReadHttp1(connection);
+                }
+            });
+    }
+
+    void ReadHttp1(ConnectionPointer connection)
+    {
+        auto self = shared_from_this();
+        asio::async_read_until(connection->socket, connection->http1_buffer,
+            "\r\n\r\n",
+            [this, self, connection](const boost::system::error_code & err,
+                std::size_t)
+            {
+                if (err)
+                    return;
+
+                auto response = std::make_shared<std::string>(
+                    "HTTP/1.1 200 OK\r\nConnection: close\r\n"
+                    "Content-Length: "
+                    + std::to_string(kPlainContent.size())
+                    + "\r\n\r\n" + kPlainContent);
+
+                asio::async_write(connection->socket, asio::buffer(*response),
+                    [self, connection, response](
+                        const boost::system::error_code &, std::size_t)
+                    {
+                        connection->socket.lowest_layer().close();
+                    });
+            });
+    }
+
+    void StartHttp2(ConnectionPointer connection)
+    {
+        nghttp2_session_callbacks * callbacks;
+        nghttp2_session_callbacks_new(&callbacks);
+        nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks,
+            &OnBeginHeaders);
+        nghttp2_session_callbacks_set_on_header_callback(callbacks,
+            &OnHeader);
+        nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks,
+            &OnDataChunk);
+        nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+            &OnFrame);
+        nghttp2_session_callbacks_set_on_stream_close_callback(callbacks,
+            &OnStreamClose);
+        nghttp2_session_server_new(&connection->session, callbacks,
+            connection.get());
+        nghttp2_session_callbacks_del(callbacks);
+
+        nghttp2_submit_settings(connection->session, NGHTTP2_FLAG_NONE,
+            nullptr, 0);
+
+        Flush(connection);
+        Read(connection);
+    }
+
+    void Read(ConnectionPointer connection)
+    {
+        auto self = shared_from_this();
+        connection->socket.async_read_some(
+            asio::buffer(connection->read_buffer),
+            [this, self, connection](const boost::system::error_code & err,
+                std::size_t bytes_transferred)
+            {
+                if (err)
+                    return;
+
+                if (nghttp2_session_mem_recv(connection->session,
+                        connection->read_buffer.data(), bytes_transferred) < 0)
+                {
+                    connection->socket.lowest_layer().close();
+                    return;
+                }
+
+                Flush(connection);
+                Read(connection);
+            });
+    }
+
+    void Flush(ConnectionPointer connection)
+    {
+        if (connection->writing)
+            return;
+
+        connection->write_buffer.clear();
+        const uint8_t * data;
+        ssize_t length;
+        while ((length = nghttp2_session_mem_send(connection->session, &data))
+            > 0)
+        {
+            connection->write_buffer.append(
+                reinterpret_cast<const char*>(data), length);
+        }
+
+        if (connection->write_buffer.empty())
+            return;
+
+        connection->writing = true;
+
+        auto self = shared_from_this();
+        asio::async_write(connection->socket,
+            asio::buffer(connection->write_buffer),
+            [this, self, connection](const boost::system::error_code & err,
+                std::size_t)
+            {
+                connection->writing = false;
+                if ( ! err )
+                    Flush(connection);
+            });
+    }
+
+    static int OnBeginHeaders(nghttp2_session *, const nghttp2_frame * frame,
+        void * user_data)
+    {
+        auto connection = static_cast<Connection*>(user_data);
+        connection->streams[frame->hd.stream_id] = Stream();
+        return 0;
+    }
+
+    static int OnHeader(nghttp2_session *, const nghttp2_frame * frame,
+        const uint8_t * name, size_t namelen, const uint8_t * value,
+        size_t valuelen, uint8_t, void * user_data)
+    {
+        auto connection = static_cast<Connection*>(user_data);
+        auto & stream = connection->streams[frame->hd.stream_id];
+
+        const std::string header_name(reinterpret_cast<const char*>(name),
+            namelen);
+        const std::string header_value(reinterpret_cast<const char*>(value),
+            valuelen);
+
+        if (header_name == ":method")
+            stream.method = header_value;
+        else if (header_name == ":path")
+            stream.path = header_value;
+
+        return 0;
+    }
+
+    static int OnDataChunk(nghttp2_session *, uint8_t, int32_t stream_id,
+        const uint8_t * data, size_t len, void * user_data)
+    {
+        auto connection = static_cast<Connection*>(user_data);
+        connection->streams[stream_id].request_content.append(
+            reinterpret_cast<const char*>(data), len);
+        return 0;
+    }
+
+    static int OnFrame(nghttp2_session * session, const nghttp2_frame * frame,
+        void * user_data)
+    {
+        if ( ! (frame->hd.flags & NGHTTP2_FLAG_END_STREAM)
+            || (frame->hd.type != NGHTTP2_HEADERS
+                && frame->hd.type != NGHTTP2_DATA) )
+        {
+            return 0;
+        }
+
+        auto connection = static_cast<Connection*>(user_data);
+        auto & stream = connection->streams[frame->hd.stream_id];
+
+        if (stream.path == "/stall")
+            return 0;
+
+        std::vector<nghttp2_nv> headers;
+        auto add_header = [&headers](const char * name, const char * value)
+        {
+            headers.push_back(nghttp2_nv{
+                reinterpret_cast<uint8_t*>(const_cast<char*>(name)),
+                reinterpret_cast<uint8_t*>(const_cast<char*>(value)),
+                std::strlen(name), std::strlen(value), NGHTTP2_NV_FLAG_NONE});
+        };
+
+        add_header(":status", "200");
+
+        if (stream.method == "POST")
+            stream.response_content = stream.request_content;
+        else if (stream.path == "/large")
+            stream.response_content = kLargeContent;
+        else if (stream.path == "/gzip")
+            stream.response_content = Gzip(kPlainContent);
+        else
+            stream.response_content = kPlainContent;
+
+        if (stream.path == "/gzip")
+            add_header("content-encoding", "gzip");
+
+        const std::string content_length =
+            std::to_string(stream.response_content.size());
+        add_header("content-length", content_length.c_str());
+
+        nghttp2_data_provider provider;
+        provider.source.ptr = &stream;
+        provider.read_callback = &ReadResponse;
+
+        nghttp2_submit_response(session, frame->hd.stream_id, headers.data(),
+            headers.size(), &provider);
+
+        return 0;
+    }
+
+    static ssize_t ReadResponse(nghttp2_session *, int32_t, uint8_t * buf,
+        size_t length, uint32_t * data_flags, nghttp2_data_source * source,
+        void *)
+    {
+        auto stream = static_cast<Stream*>(source->ptr);
+
+        const std::size_t size = std::min(length,
+            stream->response_content.size() - stream->sent);
+        std::memcpy(buf, stream->response_content.data() + stream->sent, size);
+        stream->sent += size;
+
+        if (stream->sent == stream->response_content.size())
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+        return static_cast<ssize_t>(size);
+    }
+
+    static int OnStreamClose(nghttp2_session *, int32_t stream_id, uint32_t,
+        void * user_data)
+    {
+        auto connection = static_cast<Connection*>(user_data);
+        connection->streams.erase(stream_id);
+        return 0;
+    }
+
+    asio::io_service * io_service_;
+    std::shared_ptr<asio::ssl::context> ssl_ctx_;
+    asio::ip::tcp::acceptor acceptor_;
+    const bool offer_http2_;
+
+    std::size_t accepted_;
+    std::size_t http2_accepted_;
+    std::vector<ConnectionPointer> connections_;
+};
+
+HttpConfig::Pointer CreateConfig(asio::io_service * io_service)
+{
+    auto http_config = HttpConfig::Create();
+    http_config->SetWorkIoService(io_service);
+
+    // Our certificate is self signed.
+    http_config->AllowSelfSignedCertificate();
+
+    http_config->SetHttp2Enabled(true);
+
+    return http_config;
+}
+
+/**
+ * Sends each of the requests at once, stopping the server once all are done.
+ */
+class Requests
+{
+public:
+    Requests(
+            asio::io_service * io_service,
+            HttpConfig::ConstPointer config,
+            Http2Server::Pointer server
+        ) :
+        io_service_(io_service),
+        config_(std::move(config)),
+        server_(std::move(server)),
+        outstanding_(0)
+    {}
+
+    HttpRequest::Pointer Add(const std::string & path)
+    {
+        const std::size_t index = responses_.size();
+        responses_.emplace_back();
+        ++outstanding_;
+
+        return HttpRequest::Create(config_,
+            [this, index](HttpRequest::CallbackResponse response)
+            {
+                responses_[index] = std::move(response);
+                if (--outstanding_ == 0)
+                    server_->Stop();
+            },
+            io_service_, kUrlBase + path);
+    }
+
+    const std::vector<HttpRequest::CallbackResponse> & Responses() const
+    {
+        return responses_;
+    }
+
+private:
+    asio::io_service * io_service_;
+    HttpConfig::ConstPointer config_;
+    Http2Server::Pointer server_;
+    std::size_t outstanding_;
+    std::vector<HttpRequest::CallbackResponse> responses_;
+};
+
+class PostDataPipe : public mf::http::PostDataPipeInterface
+{
+public:
+    explicit PostDataPipe(std::string content) :
+        content_(std::move(content)),
+        pos_(0)
+    {}
+
+    virtual uint64_t PostDataSize() const override
+    {
+        return content_.size();
+    }
+
+    virtual mf::http::SharedBuffer::Pointer RetreivePostDataChunk() override
+    {
+        const std::size_t size = std::min<std::size_t>(
+            content_.size() - pos_, 10000);
+        auto buffer = mf::http::SharedBuffer::Create(
+            content_.substr(pos_, size));
+        pos_ += size;
+        return buffer;
+    }
+
+private:
+    const std::string content_;
+    std::size_t pos_;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ConcurrentRequestsShareConnection)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    Requests requests(&io_service, http_config, server);
+    std::vector<HttpRequest::Pointer> started;
+    for (int i = 0; i < 10; ++i)
+        started.push_back(requests.Add("/item" + std::to_string(i)));
+    for (auto & request : started)
+        request->Start();
+
+    io_service.run();
+
+    for (const auto & response : requests.Responses())
+    {
+        BOOST_CHECK_MESSAGE( ! response.error_code,
+            response.error_code.message());
+        BOOST_CHECK_EQUAL(response.headers.status_code, 200);
+        BOOST_CHECK_EQUAL(response.content, kPlainContent);
+    }
+
+    BOOST_CHECK_EQUAL(server->Accepted(), 1);
+    BOOST_CHECK_EQUAL(server->Http2Accepted(), 1);
+
+    const auto statistics = http_config->GetHttp2SessionPoolStatistics();
+    BOOST_CHECK_EQUAL(statistics.sessions_opened, 1);
+    // The others waited for the first to open the connection.
+    BOOST_CHECK_EQUAL(statistics.streams_multiplexed, 9);
+}
+
+BOOST_AUTO_TEST_CASE(LaterRequestsReuseConnection)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    std::size_t completed = 0;
+    std::string content;
+
+    std::function<void(HttpRequest::CallbackResponse)> on_complete =
+        [&](HttpRequest::CallbackResponse response)
+        {
+            BOOST_CHECK_MESSAGE( ! response.error_code,
+                response.error_code.message());
+            content = response.content;
+
+            if (++completed < 3)
+                HttpRequest::Create(http_config, on_complete, &io_service,
+                    kUrlBase + "/next")->Start();
+            else
+                server->Stop();
+        };
+
+    HttpRequest::Create(http_config, on_complete, &io_service,
+        kUrlBase + "/first")->Start();
+
+    io_service.run();
+
+    BOOST_CHECK_EQUAL(completed, 3);
+    BOOST_CHECK_EQUAL(content, kPlainContent);
+    BOOST_CHECK_EQUAL(server->Accepted(), 1);
+
+    const auto statistics = http_config->GetHttp2SessionPoolStatistics();
+    BOOST_CHECK_EQUAL(statistics.sessions_opened, 1);
+    BOOST_CHECK_EQUAL(statistics.streams_multiplexed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(ContentLargerThanStreamWindow)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    Requests requests(&io_service, http_config, server);
+    auto large = requests.Add("/large");
+    auto small = requests.Add("/small");
+    large->Start();
+    small->Start();
+
+    io_service.run();
+
+    const auto & responses = requests.Responses();
+    BOOST_CHECK( ! responses[0].error_code );
+    BOOST_CHECK(responses[0].content == kLargeContent);
+    BOOST_CHECK( ! responses[1].error_code );
+    BOOST_CHECK_EQUAL(responses[1].content, kPlainContent);
+}
+
+BOOST_AUTO_TEST_CASE(DownloadBandwidthLimit)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    // 5 MiB at 10 MiB per second, with no burst.
+    http_config->GetBandwidthLimiter()->SetLimit(
+        mf::http::BandwidthLimiter::Direction::Download, 10 * 1024 * 1024, 0);
+
+    Requests requests(&io_service, http_config, server);
+    requests.Add("/large")->Start();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    io_service.run();
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_CHECK(elapsed >= std::chrono::milliseconds(400));
+
+    const auto & response = requests.Responses().front();
+    BOOST_CHECK_MESSAGE( ! response.error_code, response.error_code.message());
+    BOOST_CHECK(response.content == kLargeContent);
+}
+
+BOOST_AUTO_TEST_CASE(DecodesContent)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    Requests requests(&io_service, http_config, server);
+    requests.Add("/gzip")->Start();
+
+    io_service.run();
+
+    const auto & response = requests.Responses().front();
+    BOOST_CHECK_MESSAGE( ! response.error_code, response.error_code.message());
+    BOOST_CHECK_EQUAL(response.content, kPlainContent);
+}
+
+BOOST_AUTO_TEST_CASE(PostData)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    const std::string buffer_content = CreateContent(100000);
+    const std::string pipe_content = CreateContent(70000);
+
+    Requests requests(&io_service, http_config, server);
+
+    auto buffer_request = requests.Add("/post");
+    buffer_request->SetPostData(
+        mf::http::SharedBuffer::Create(buffer_content));
+
+    auto pipe_request = requests.Add("/post");
+    pipe_request->SetPostDataPipe(
+        std::make_shared<PostDataPipe>(pipe_content));
+
+    buffer_request->Start();
+    pipe_request->Start();
+
+    io_service.run();
+
+    const auto & responses = requests.Responses();
+    BOOST_CHECK_MESSAGE( ! responses[0].error_code,
+        responses[0].error_code.message());
+    BOOST_CHECK(responses[0].content == buffer_content);
+    BOOST_CHECK_MESSAGE( ! responses[1].error_code,
+        responses[1].error_code.message());
+    BOOST_CHECK(responses[1].content == pipe_content);
+    BOOST_CHECK_EQUAL(server->Http2Accepted(), server->Accepted());
+}
+
+BOOST_AUTO_TEST_CASE(CancelLeavesConnectionUsable)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+
+    std::error_code stalled_error;
+    std::string content;
+
+    auto stalled = HttpRequest::Create(http_config,
+        [&](HttpRequest::CallbackResponse response)
+        {
+            stalled_error = response.error_code;
+
+            HttpRequest::Create(http_config,
+                [&](HttpRequest::CallbackResponse response)
+                {
+                    BOOST_CHECK_MESSAGE( ! response.error_code,
+                        response.error_code.message());
+                    content = response.content;
+                    server->Stop();
+                },
+                &io_service, kUrlBase + "/after")->Start();
+        },
+        &io_service, kUrlBase + "/stall");
+    stalled->Start();
+
+    asio::deadline_timer timer(io_service);
+    timer.expires_from_now(boost::posix_time::milliseconds(200));
+    timer.async_wait([stalled](const boost::system::error_code &)
+        {
+            stalled->Cancel();
+        });
+
+    io_service.run();
+
+    BOOST_CHECK(stalled_error == mf::http::http_error::Cancelled);
+    BOOST_CHECK_EQUAL(content, kPlainContent);
+    BOOST_CHECK_EQUAL(server->Accepted(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FallsBackToHttp1)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, false);
+    auto http_config = CreateConfig(&io_service);
+
+    Requests requests(&io_service, http_config, server);
+    std::vector<HttpRequest::Pointer> started;
+    for (int i = 0; i < 3; ++i)
+        started.push_back(requests.Add("/item"));
+    for (auto & request : started)
+        request->Start();
+
+    io_service.run();
+
+    for (const auto & response : requests.Responses())
+    {
+        BOOST_CHECK_MESSAGE( ! response.error_code,
+            response.error_code.message());
+        BOOST_CHECK_EQUAL(response.content, kPlainContent);
+    }
+
+    BOOST_CHECK_EQUAL(server->Http2Accepted(), 0);
+    BOOST_CHECK_EQUAL(
+        http_config->GetHttp2SessionPoolStatistics().sessions_opened, 0);
+}
+
+BOOST_AUTO_TEST_CASE(DisabledByDefault)
+{
+    asio::io_service io_service;
+    auto server = Http2Server::Create(&io_service, true);
+    auto http_config = CreateConfig(&io_service);
+    http_config->SetHttp2Enabled(false);
+
+    Requests requests(&io_service, http_config, server);
+    requests.Add("/item")->Start();
+
+    io_service.run();
+
+    const auto & response = requests.Responses().front();
+    BOOST_CHECK_MESSAGE( ! response.error_code, response.error_code.message());
+    BOOST_CHECK_EQUAL(response.content, kPlainContent);
+    BOOST_CHECK_EQUAL(server->Http2Accepted(), 0);
+    BOOST_CHECK( ! HttpConfig::Create()->GetHttp2Enabled() );
+}
@@ -2,6 +2,9 @@
  * @copyright Copyright 2014 Mediafire
  */
 
+#include <chrono>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <list>
@@ -14,11 +17,15 @@
 #include "mediafire_sdk/http/http_request.hpp"
 #include "mediafire_sdk/http/post_data_pipe_interface.hpp"
 #include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/http/request_timing_histogram.hpp"
+#include "mediafire_sdk/http/detail/connect_racer.hpp"
+#include "mediafire_sdk/http/detail/content_decoder.hpp"
 
 #include "mediafire_sdk/http/unit_tests/expect_server.hpp"
 #include "mediafire_sdk/http/unit_tests/expect_server_ssl.hpp"
 
 #include "mediafire_sdk/utils/base64.hpp"
+#include "mediafire_sdk/utils/fileio.hpp"
 #include "mediafire_sdk/utils/string.hpp"
 
 #include "boost/asio.hpp"
@@ -27,6 +34,17 @@
 #  include "boost/asio/impl/src.hpp"  // Define once in program
 #  include "boost/asio/ssl/impl/src.hpp"  // Define once in program
 #endif
+#include "boost/filesystem.hpp"
+#include "boost/iostreams/device/back_inserter.hpp"
+#include "boost/iostreams/filter/gzip.hpp"
+#include "boost/iostreams/filtering_stream.hpp"
+
+#if defined(HTTP_USE_BROTLI)
+#   include "brotli/encode.h"
+#endif
+#if defined(HTTP_USE_ZSTD)
+#   include "zstd.h"
+#endif
 
 namespace asio = boost::asio;
 
@@ -104,6 +122,72 @@ namespace {
         server->Push(expect_server_test::SendMessage( std::move(data) ));
     }
 
+    /** Random compressible text. */
+    std::string RandomCompressibleContent(std::size_t content_size)
+    {
+        static const std::vector<std::string> words = {
+            "quickkey", "folderkey", "filename", "revision", "created",
+            "\"", ":", ",", "{", "}", " "};
+
+        static boost::random::random_device rng;
+        static boost::random::uniform_int_distribution<> index_dist(
+                0, words.size() - 1);
+
+        std::string data;
+        while (data.size() < content_size)
+            data += words[index_dist(rng)];
+        data.resize(content_size);
+
+        return data;
+    }
+
+    std::string Gzip(const std::string & data)
+    {
+        std::string compressed;
+        boost::iostreams::filtering_ostream out;
+        out.push(boost::iostreams::gzip_compressor());
+        out.push(boost::iostreams::back_inserter(compressed));
+        out << data;
+        out.reset();
+
+        return compressed;
+    }
+
+#if defined(HTTP_USE_BROTLI)
+    std::string Brotli(const std::string & data)
+    {
+        std::string compressed(BrotliEncoderMaxCompressedSize(data.size()),
+            '\0');
+        std::size_t compressed_size = compressed.size();
+        BrotliEncoderCompress(BROTLI_DEFAULT_QUALITY, BROTLI_DEFAULT_WINDOW,
+            BROTLI_MODE_TEXT, data.size(),
+            reinterpret_cast<const uint8_t*>(data.data()), &compressed_size,
+            reinterpret_cast<uint8_t*>(&compressed[0]));
+        compressed.resize(compressed_size);
+
+        return compressed;
+    }
+#endif
+
+#if defined(HTTP_USE_ZSTD)
+    std::string Zstd(const std::string & data)
+    {
+        std::string compressed(ZSTD_compressBound(data.size()), '\0');
+        compressed.resize(ZSTD_compress(&compressed[0], compressed.size(),
+            data.data(), data.size(), 3));
+
+        return compressed;
+    }
+#endif
+
+    void SendChunk(ExpectServerBase * server, const std::string & chunk)
+    {
+        std::stringstream ss;
+        ss << std::hex << chunk.size() << "\r\n" << chunk << "\r\n";
+
+        server->Push(expect_server_test::SendMessage( ss.str() ));
+    }
+
     enum Enc
     {
         Enc_None,
@@ -205,6 +289,330 @@ namespace {
     private:
         boost::tribool success_;
     };
+
+    // Passes events on to the server and calls a function when complete.
+    class ChainedResponse : public mf::http::RequestResponseInterface
+    {
+    public:
+        ChainedResponse(
+                std::shared_ptr<ExpectServerBase> server,
+                std::function<void()> on_complete
+            ) :
+            server_(server),
+            on_complete_(on_complete)
+        {}
+
+        virtual void RedirectHeaderReceived(
+                const mf::http::Headers & headers,
+                const mf::http::Url & new_url
+            ) override
+        {
+            server_->RedirectHeaderReceived(headers, new_url);
+        }
+
+        virtual void ResponseHeaderReceived(
+                const mf::http::Headers & headers
+            ) override
+        {
+            server_->ResponseHeaderReceived(headers);
+        }
+
+        virtual void ResponseContentReceived(
+                std::size_t start_pos,
+                std::shared_ptr<mf::http::BufferInterface> buffer
+            ) override
+        {
+            server_->ResponseContentReceived(start_pos, buffer);
+        }
+
+        virtual void RequestResponseErrorEvent(
+                std::error_code error_code,
+                std::string error_text
+            ) override
+        {
+            server_->RequestResponseErrorEvent(error_code, error_text);
+        }
+
+        virtual void RequestResponseCompleteEvent() override
+        {
+            server_->RequestResponseCompleteEvent();
+            on_complete_();
+        }
+
+    private:
+        std::shared_ptr<ExpectServerBase> server_;
+        std::function<void()> on_complete_;
+    };
+
+    // Stands in for the system resolver so the DNS cache can be tested
+    // without a network.  Answers asynchronously, like the real resolver.
+    class FakeDnsLookup
+    {
+    public:
+        explicit FakeDnsLookup(boost::system::error_code error) :
+            error_(error),
+            lookups_(std::make_shared<int>(0))
+        {}
+
+        void operator()(
+                asio::io_service * io_service,
+                const std::string & /* host */,
+                const std::string & port,
+                mf::http::detail::ResolverCache::LookupHandler handler
+            )
+        {
+            ++(*lookups_);
+
+            mf::http::detail::ResolverCache::Endpoints endpoints;
+            if ( ! error_ )
+            {
+                endpoints.emplace_back(
+                    asio::ip::address::from_string(kHost),
+                    static_cast<uint16_t>(std::stoi(port)) );
+            }
+
+            const boost::system::error_code error = error_;
+            io_service->post(
+                [handler, error, endpoints]()
+                {
+                    handler(error, endpoints);
+                });
+        }
+
+        int Lookups() const
+        {
+            return *lookups_;
+        }
+
+    private:
+        boost::system::error_code error_;
+        std::shared_ptr<int> lookups_;
+    };
+
+    // A local address that never answers a connection attempt, standing in
+    // for an unreachable host.  Once the listen queue is full, further
+    // connection requests are dropped without reply.
+    class BlackHole
+    {
+    public:
+        explicit BlackHole(asio::io_service * io_service) :
+            acceptor_(*io_service),
+            filler_(*io_service)
+        {
+            const asio::ip::tcp::endpoint endpoint(
+                asio::ip::address::from_string(kHost), 0);
+
+            acceptor_.open(endpoint.protocol());
+            acceptor_.bind(endpoint);
+            acceptor_.listen(0);
+
+            filler_.connect(acceptor_.local_endpoint());
+        }
+
+        asio::ip::tcp::endpoint Endpoint() const
+        {
+            return acceptor_.local_endpoint();
+        }
+
+    private:
+        asio::ip::tcp::acceptor acceptor_;
+        asio::ip::tcp::socket filler_;
+    };
+
+    // A local address refusing connections.
+    asio::ip::tcp::endpoint RefusingEndpoint(asio::io_service * io_service)
+    {
+        asio::ip::tcp::acceptor acceptor(*io_service,
+            asio::ip::tcp::endpoint(
+                asio::ip::address::from_string(kHost), 0));
+        return acceptor.local_endpoint();
+    }
+
+    // Answers every request on a kept alive connection, except that the first
+    // connection is closed once its second request has been read, as a server
+    // does with a connection it timed out.  Keeps the request lines read.
+    class DroppingServer : public std::enable_shared_from_this<DroppingServer>
+    {
+    public:
+        DroppingServer(asio::io_service * io_service, uint16_t port) :
+            io_service_(io_service),
+            acceptor_(*io_service, asio::ip::tcp::endpoint(
+                    asio::ip::address::from_string(kHost), port)),
+            connections_(0)
+        {}
+
+        void Start()
+        {
+            Accept();
+        }
+
+        void Stop()
+        {
+            acceptor_.close();
+
+            boost::system::error_code ec;
+            for ( const auto & socket : sockets_ )
+                socket->close(ec);
+        }
+
+        const std::vector<std::string> & RequestLines() const
+        {
+            return request_lines_;
+        }
+
+    private:
+        using SocketPointer = std::shared_ptr<asio::ip::tcp::socket>;
+        using BufferPointer = std::shared_ptr<asio::streambuf>;
+
+        void Accept()
+        {
+            auto self = shared_from_this();
+            auto socket = std::make_shared<asio::ip::tcp::socket>(
+                *io_service_);
+            acceptor_.async_accept(*socket,
+                [self, socket](const boost::system::error_code & err)
+                {
+                    if (err)
+                        return;
+
+                    self->sockets_.push_back(socket);
+
+                    const bool drop = (self->connections_++ == 0);
+                    self->ReadRequest(socket,
+                        std::make_shared<asio::streambuf>(), drop ? 2 : 0);
+                    self->Accept();
+                });
+        }
+
+        // Reads the next request.  drop_at counts down to the request the
+        // connection is closed after, if not zero.
+        void ReadRequest(
+                SocketPointer socket,
+                BufferPointer buffer,
+                int drop_at
+            )
+        {
+            auto self = shared_from_this();
+            asio::async_read_until(*socket, *buffer, "\r\n\r\n",
+                [self, socket, buffer, drop_at](
+                        const boost::system::error_code & err,
+                        std::size_t bytes_transferred
+                    )
+                {
+                    if (err)
+                        return;
+
+                    std::string headers(bytes_transferred, '\0');
+                    asio::buffer_copy(
+                        asio::buffer(&headers[0], bytes_transferred),
+                        buffer->data());
+                    buffer->consume(bytes_transferred);
+
+                    self->request_lines_.push_back(
+                        headers.substr(0, headers.find("\r\n")));
+
+                    std::size_t content_length = 0;
+                    boost::smatch match;
+                    if ( boost::regex_search(headers, match, boost::regex(
+                            "Content-Length: ([0-9]+)\r\n")) )
+                    {
+                        content_length = std::stoul(match[1]);
+                    }
+
+                    self->ReadContent(socket, buffer, drop_at,
+                        content_length);
+                });
+        }
+
+        void ReadContent(
+                SocketPointer socket,
+                BufferPointer buffer,
+                int drop_at,
+                std::size_t content_length
+            )
+        {
+            auto self = shared_from_this();
+            const std::size_t buffered = std::min(content_length,
+                buffer->size());
+            asio::async_read(*socket, *buffer,
+                asio::transfer_exactly(content_length - buffered),
+                [self, socket, buffer, drop_at, content_length](
+                        const boost::system::error_code & err,
+                        std::size_t
+                    )
+                {
+                    if (err)
+                        return;
+
+                    buffer->consume(content_length);
+
+                    if (drop_at == 1)
+                    {
+                        socket->close();
+                        return;
+                    }
+
+                    self->Respond(socket, buffer,
+                        drop_at > 1 ? drop_at - 1 : 0);
+                });
+        }
+
+        void Respond(
+                SocketPointer socket,
+                BufferPointer buffer,
+                int drop_at
+            )
+        {
+            auto self = shared_from_this();
+            auto response = std::make_shared<std::string>(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 5\r\n"
+                "\r\n"
+                "hello");
+            asio::async_write(*socket, asio::buffer(*response),
+                [self, socket, buffer, drop_at, response](
+                        const boost::system::error_code & err,
+                        std::size_t
+                    )
+                {
+                    if ( ! err )
+                        self->ReadRequest(socket, buffer, drop_at);
+                });
+        }
+
+        asio::io_service * io_service_;
+        asio::ip::tcp::acceptor acceptor_;
+        int connections_;
+        std::vector<SocketPointer> sockets_;
+        std::vector<std::string> request_lines_;
+    };
+
+    // Reads a response and calls a function once it ends, either way.
+    class NotifyingResponse : public ResponseReader
+    {
+    public:
+        explicit NotifyingResponse(std::function<void()> on_end) :
+            on_end_(on_end)
+        {}
+
+        virtual void RequestResponseErrorEvent(
+                std::error_code error_code,
+                std::string error_text
+            ) override
+        {
+            ResponseReader::RequestResponseErrorEvent(error_code, error_text);
+            on_end_();
+        }
+
+        virtual void RequestResponseCompleteEvent() override
+        {
+            ResponseReader::RequestResponseCompleteEvent();
+            on_end_();
+        }
+
+    private:
+        std::function<void()> on_end_;
+    };
 }  // namespace
 
 bool TestTimeout()
@@ -469,47 +877,1154 @@ bool TestContentLengthEmpty()
                 kPort1
             );
 
-    server->Push( ExpectRegex{ boost::regex(
-            "GET.*\r\n"
-            "\r\n"
-        )});
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Cache-control: no-cache, must-revalidate\r\n"
+            "Pragma: no-cache\r\n"
+            "Expires: 0\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 0\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    server->Push( ExpectDisconnect{static_cast<std::size_t>(0)} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+
+bool TestBigContentLength()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Cache-control: no-cache, must-revalidate\r\n"
+            "Pragma: no-cache\r\n"
+            "Expires: 0\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 200000\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        SendRandomContent( server.get(), 2000 );
+    }
+
+    server->Push( ExpectDisconnect{200000} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+
+bool TestBandwidthLimitDownload()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 200000\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        SendRandomContent( server.get(), 2000 );
+    }
+
+    server->Push( ExpectDisconnect{200000} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    // 200000 bytes at 400000 bytes per second, with no burst.
+    http_config->GetBandwidthLimiter()->SetLimit(
+        mf::http::BandwidthLimiter::Direction::Download, 400000, 0);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    // The last piece read is not waited on.
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if ( elapsed < std::chrono::milliseconds(300) )
+    {
+        std::cout << "Download was not limited." << std::endl;
+        return false;
+    }
+
+    return server->Success();
+}
+
+bool TestBigContentLength2()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Cache-control: no-cache, must-revalidate\r\n"
+            "Pragma: no-cache\r\n"
+            "Expires: 0\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 200000\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        SendRandomContent( server.get(), 20000 );
+    }
+
+    server->Push( ExpectDisconnect{200000} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+
+bool TestGzipChunked()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+                );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Encoding: gzip\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    // Several MB, so the content is decompressed into many buffers.
+    const std::size_t total_content = 1024 * 1024 * 3;
+    const std::string compressed = Gzip(
+        RandomCompressibleContent(total_content));
+
+    for (std::size_t pos = 0; pos < compressed.size(); pos += 7000)
+        SendChunk( server.get(), compressed.substr(pos, 7000) );
+    SendChunk( server.get(), "" );  // Terminates connection
+
+    server->Push( ExpectDisconnect{total_content} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+
+bool TestGzipContentLength()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    const std::size_t total_content = 200000;
+    const std::string compressed = Gzip(
+        RandomCompressibleContent(total_content));
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Content-Length: " + mf::utils::to_string(compressed.size())
+            + "\r\n"
+            "Content-Encoding: gzip\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    server->Push(expect_server_test::SendMessage( compressed ));
+
+    server->Push( ExpectDisconnect{total_content} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+
+#if defined(HTTP_USE_BROTLI)
+bool TestBrotliContentLength()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    // Only codings that can be decoded are advertised.
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "Accept-Encoding: " HTTP_ACCEPT_ENCODING "\r\n"
+            ".*\r\n"
+            "\r\n"
+        )});
+
+    const std::size_t total_content = 1024 * 1024;
+    const std::string compressed = Brotli(
+        RandomCompressibleContent(total_content));
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Content-Length: " + mf::utils::to_string(compressed.size())
+            + "\r\n"
+            "Content-Encoding: br\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    server->Push(expect_server_test::SendMessage( compressed ));
+
+    server->Push( ExpectDisconnect{total_content} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+#endif
+
+#if defined(HTTP_USE_ZSTD)
+bool TestZstdChunked()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+                );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "Accept-Encoding: " HTTP_ACCEPT_ENCODING "\r\n"
+            ".*\r\n"
+            "\r\n"
+        )});
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Encoding: zstd\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    const std::size_t total_content = 1024 * 1024 * 3;
+    const std::string compressed = Zstd(
+        RandomCompressibleContent(total_content));
+
+    for (std::size_t pos = 0; pos < compressed.size(); pos += 7000)
+        SendChunk( server.get(), compressed.substr(pos, 7000) );
+    SendChunk( server.get(), "" );  // Terminates connection
+
+    server->Push( ExpectDisconnect{total_content} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+#endif
+
+bool TestUnsupportedContentEncoding()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+
+    // Stacked codings are not decoded.
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 2000\r\n"
+            "Content-Encoding: gzip, br\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    SendRandomContent( server.get(), 2000 );
+
+    server->Push( ExpectError{mf::http::http_error::UnsupportedEncoding} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    return server->Success();
+}
+
+bool TestKeepAlive()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    // The server only accepts one connection, so the second request must
+    // reuse the first connection.
+    server->Push( ExpectRegex{ boost::regex(
+            "GET /first.*\r\n"
+            "\r\n"
+        )});
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Content-Length: 2000\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+    SendRandomContent( server.get(), 2000 );
+    server->Push( ExpectDisconnect{2000} );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET /second.*\r\n"
+            "\r\n"
+        )});
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    SendRandomChunk( server.get(), 100 );
+    SendRandomChunk( server.get(), 0 );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    auto second_response = std::make_shared<ResponseReader>();
+    mf::http::HttpRequest::Pointer second_request;
+
+    auto first_response = std::make_shared<ChainedResponse>(
+        server,
+        [&]()
+        {
+            second_request = mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(second_response),
+                MakeUrl(Enc_None, kPort1, "second") );
+            second_request->Start();
+        });
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(first_response),
+                MakeUrl(Enc_None, kPort1, "first")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    const auto statistics = http_config->GetConnectionPoolStatistics();
+
+    if ( statistics.hits != 1 || statistics.misses != 1 )
+    {
+        std::cout << "Pool hits: " << statistics.hits
+            << " Pool misses: " << statistics.misses << std::endl;
+        return false;
+    }
+
+    return server->Success() && second_response->Success();
+}
+
+bool TestKeepAliveOutlivesIoService()
+{
+    auto http_config = mf::http::HttpConfig::Create();
+
+    // Each io_service gets its own connection, and the one left in the pool is
+    // closed with the io_service that made it.
+    for (int i = 0; i < 2; ++i)
+    {
+        asio::io_service io_service;
+        http_config->SetWorkIoService(&io_service);
+
+        std::shared_ptr<ExpectServer> server =
+            ExpectServer::Create(
+                    &io_service,
+                    MakeWork(&io_service),
+                    kPort1
+                );
+
+        server->Push( ExpectRegex{ boost::regex(
+                "GET /keep.*\r\n"
+                "\r\n"
+            )});
+        server->Push(expect_server_test::SendMessage(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 5\r\n"
+                "\r\n"
+                "hello"
+            ));
+
+        auto response = std::make_shared<ResponseReader>();
+        mf::http::HttpRequest::Pointer request(
+                mf::http::HttpRequest::Create(
+                    http_config,
+                    std::static_pointer_cast<
+                        mf::http::RequestResponseInterface>(response),
+                    MakeUrl(Enc_None, kPort1, "keep")
+            ));
+
+        request->Start();
+
+        io_service.run();
+
+        if ( ! server->Success() || ! response->Success() )
+            return false;
+    }
+
+    const auto statistics = http_config->GetConnectionPoolStatistics();
+
+    if ( statistics.hits != 0 || statistics.misses != 2 )
+    {
+        std::cout << "Pool hits: " << statistics.hits
+            << " Pool misses: " << statistics.misses << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Sends a GET, then second_method on the connection the GET left in the pool,
+ * which the server closes after reading the second request.  Returns the
+ * request lines the server read, and whether the second request succeeded.
+ */
+std::vector<std::string> SendOnDroppedConnection(
+        const std::string & second_method,
+        bool * second_success
+    )
+{
+    asio::io_service io_service;
+
+    auto server = std::make_shared<DroppingServer>(&io_service, kPort1);
+    server->Start();
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    auto second_response = std::make_shared<NotifyingResponse>(
+        [server]()
+        {
+            server->Stop();
+        });
+    mf::http::HttpRequest::Pointer second_request;
+
+    auto first_response = std::make_shared<NotifyingResponse>(
+        [&]()
+        {
+            second_request = mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(second_response),
+                MakeUrl(Enc_None, kPort1, "second") );
+            if (second_method == "POST")
+            {
+                second_request->SetPostData(mf::http::SharedBuffer::Create(
+                        std::string("action=create")));
+            }
+            second_request->Start();
+        });
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(first_response),
+                MakeUrl(Enc_None, kPort1, "first")
+        ));
+
+    request->Start();
+
+    io_service.run();
+
+    *second_success = second_response->Success();
+    return server->RequestLines();
+}
+
+bool TestStaleConnectionGetResent()
+{
+    bool second_success = false;
+    const auto lines = SendOnDroppedConnection("GET", &second_success);
+
+    // Nothing is lost by asking again, so the GET is sent again on a new
+    // connection.
+    const std::vector<std::string> expected = {
+        "GET /first HTTP/1.1",
+        "GET /second HTTP/1.1",
+        "GET /second HTTP/1.1"};
+
+    if ( lines != expected )
+    {
+        for ( const auto & line : lines )
+            std::cout << "Server read: " << line << std::endl;
+        return false;
+    }
+
+    return second_success;
+}
+
+bool TestStaleConnectionPostNotResent()
+{
+    bool second_success = true;
+    const auto lines = SendOnDroppedConnection("POST", &second_success);
+
+    // The server may have acted on the POST before closing, so it must not
+    // be sent twice.
+    const std::vector<std::string> expected = {
+        "GET /first HTTP/1.1",
+        "POST /second HTTP/1.1"};
+
+    if ( lines != expected )
+    {
+        for ( const auto & line : lines )
+            std::cout << "Server read: " << line << std::endl;
+        return false;
+    }
+
+    return ! second_success;
+}
+
+bool TestDnsCacheCoalesce()
+{
+    asio::io_service io_service;
+
+    FakeDnsLookup lookup{boost::system::error_code()};
+
+    auto resolver_cache = mf::http::detail::ResolverCache::Create();
+    resolver_cache->SetLookupFunction(lookup);
+
+    const int kConcurrent = 50;
+    int resolved = 0;
+
+    auto handler = [&resolved](
+            const boost::system::error_code & ec,
+            asio::ip::tcp::resolver::iterator iterator
+        )
+    {
+        if ( ! ec && iterator != asio::ip::tcp::resolver::iterator()
+            && iterator->endpoint().port() == kPort1 )
+            ++resolved;
+    };
+
+    for (int i = 0; i < kConcurrent; ++i)
+        resolver_cache->AsyncResolve(&io_service, "dns-cache.test",
+            mf::utils::to_string(kPort1), handler);
+
+    io_service.run();
+
+    if ( resolved != kConcurrent || lookup.Lookups() != 1 )
+    {
+        std::cout << "Resolved: " << resolved << " Lookups: "
+            << lookup.Lookups() << std::endl;
+        return false;
+    }
+
+    // Cached.
+    io_service.reset();
+    resolver_cache->AsyncResolve(&io_service, "dns-cache.test",
+        mf::utils::to_string(kPort1), handler);
+    io_service.run();
+
+    // Looked up again after a flush.
+    resolver_cache->Flush();
+    io_service.reset();
+    resolver_cache->AsyncResolve(&io_service, "dns-cache.test",
+        mf::utils::to_string(kPort1), handler);
+    io_service.run();
+
+    const auto statistics = resolver_cache->GetStatistics();
+
+    if ( resolved != kConcurrent + 2 || lookup.Lookups() != 2
+        || statistics.hits != 1 || statistics.misses != 2
+        || statistics.coalesced != kConcurrent - 1 )
+    {
+        std::cout << "Resolved: " << resolved << " Lookups: "
+            << lookup.Lookups() << " Hits: " << statistics.hits
+            << " Misses: " << statistics.misses
+            << " Coalesced: " << statistics.coalesced << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestDnsCacheNegative()
+{
+    asio::io_service io_service;
+
+    FakeDnsLookup lookup{asio::error::host_not_found};
+
+    auto resolver_cache = mf::http::detail::ResolverCache::Create();
+    resolver_cache->SetLookupFunction(lookup);
+
+    int failed = 0;
+
+    auto handler = [&failed](
+            const boost::system::error_code & ec,
+            asio::ip::tcp::resolver::iterator
+        )
+    {
+        if ( ec == asio::error::host_not_found )
+            ++failed;
+    };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        io_service.reset();
+        resolver_cache->AsyncResolve(&io_service, "dns-cache.test",
+            mf::utils::to_string(kPort1), handler);
+        io_service.run();
+    }
+
+    // Failures are not remembered if negative caching is disabled.
+    resolver_cache->SetNegativeTimeout(std::chrono::seconds(0));
+    resolver_cache->Flush();
+
+    for (int i = 0; i < 2; ++i)
+    {
+        io_service.reset();
+        resolver_cache->AsyncResolve(&io_service, "dns-cache.test",
+            mf::utils::to_string(kPort1), handler);
+        io_service.run();
+    }
+
+    if ( failed != 4 || lookup.Lookups() != 3 )
+    {
+        std::cout << "Failed: " << failed << " Lookups: "
+            << lookup.Lookups() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestDnsCacheRequest()
+{
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "Host: dns-cache.test.*\r\n"
+            "\r\n"
+        )});
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 100\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+    SendRandomContent( server.get(), 100 );
+    server->Push( ExpectDisconnect{100} );
+
+    FakeDnsLookup lookup{boost::system::error_code()};
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+    http_config->GetResolverCache()->SetLookupFunction(lookup);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                "http://dns-cache.test:" + mf::utils::to_string(kPort1) + "/"
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    if ( lookup.Lookups() != 1 )
+    {
+        std::cout << "Lookups: " << lookup.Lookups() << std::endl;
+        return false;
+    }
+
+    return server->Success();
+}
+
+bool TestRequestTimings()
+{
+    using mf::http::RequestPhase;
+
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "GET.*\r\n"
+            "\r\n"
+        )});
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Content-Length: 2000\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+    SendRandomContent( server.get(), 2000 );
+    server->Push( ExpectDisconnect{2000} );
+
+    auto histogram = mf::http::RequestTimingHistogram::Create();
+    mf::http::SetRequestTimingSink(histogram);
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    mf::http::SetRequestTimingSink(nullptr);
+
+    if ( ! server->Success() )
+        return false;
+
+    const auto & timings = server->Timings();
+
+    for ( auto phase : {RequestPhase::Dns, RequestPhase::Connect,
+            RequestPhase::Send, RequestPhase::TimeToFirstByte,
+            RequestPhase::Transfer, RequestPhase::Total} )
+    {
+        if ( ! timings.Measured(phase) )
+        {
+            std::cout << "Not measured: " << mf::http::RequestPhaseName(phase)
+                << std::endl;
+            return false;
+        }
+    }
+
+    // Not an SSL connection.
+    if ( timings.Measured(RequestPhase::Tls) )
+    {
+        std::cout << "TLS measured without SSL." << std::endl;
+        return false;
+    }
+
+    // The phases happen one after another within the whole request.
+    const auto & total = timings.phases[
+        static_cast<std::size_t>(RequestPhase::Total)];
+    const auto & dns = timings.phases[
+        static_cast<std::size_t>(RequestPhase::Dns)];
+    const auto & transfer = timings.phases[
+        static_cast<std::size_t>(RequestPhase::Transfer)];
+    if ( dns.begin < total.begin || transfer.end > total.end
+        || transfer.begin < dns.end )
+    {
+        std::cout << "Phases out of order." << std::endl;
+        return false;
+    }
+
+    if ( histogram->Count("", RequestPhase::Total) != 1 )
+    {
+        std::cout << "Not recorded in the histogram." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestConnectRacerOrder()
+{
+    using Endpoint = asio::ip::tcp::endpoint;
+
+    const Endpoint v6a(asio::ip::address::from_string("2001:db8::1"), 80);
+    const Endpoint v6b(asio::ip::address::from_string("2001:db8::2"), 80);
+    const Endpoint v4a(asio::ip::address::from_string("192.0.2.1"), 80);
+    const Endpoint v4b(asio::ip::address::from_string("192.0.2.2"), 80);
+
+    auto racer = mf::http::detail::ConnectRacer::Create();
+
+    // Families alternate, starting with the family of the first endpoint.
+    const auto ordered = racer->OrderEndpoints("racer.test", "80",
+        {v6a, v6b, v4a, v4b});
+    const mf::http::detail::ConnectRacer::Endpoints expected =
+        {v6a, v4a, v6b, v4b};
+
+    if ( ordered != expected )
+    {
+        std::cout << "Unexpected order:";
+        for (const auto & endpoint : ordered)
+            std::cout << " " << endpoint;
+        std::cout << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestConnectRacerUnreachable()
+{
+    asio::io_service io_service;
+
+    BlackHole black_hole(&io_service);
+    const auto refusing = RefusingEndpoint(&io_service);
+
+    asio::ip::tcp::acceptor acceptor(io_service,
+        asio::ip::tcp::endpoint(asio::ip::address::from_string(kHost), 0));
+    const auto reachable = acceptor.local_endpoint();
+
+    const mf::http::detail::ConnectRacer::Endpoints endpoints =
+        {black_hole.Endpoint(), refusing, reachable};
+
+    auto racer = mf::http::detail::ConnectRacer::Create();
+    racer->SetAttemptDelay(std::chrono::milliseconds(100));
 
-    server->Push(expect_server_test::SendMessage(
-            "HTTP/1.1 200 OK\r\n"
-            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
-            "Server: Apache\r\n"
-            "Cache-control: no-cache, must-revalidate\r\n"
-            "Pragma: no-cache\r\n"
-            "Expires: 0\r\n"
-            "Connection: close\r\n"
-            "Content-Length: 0\r\n"
-            "Content-Type: text/html; charset=UTF-8\r\n"
-            "\r\n"
-        ));
-    server->Push( ExpectHeadersRead{} );
+    asio::ip::tcp::socket socket(io_service);
+    boost::system::error_code result = asio::error::would_block;
+    asio::ip::tcp::endpoint winner;
 
-    server->Push( ExpectDisconnect{static_cast<std::size_t>(0)} );
+    const auto start = std::chrono::steady_clock::now();
 
-    auto http_config = mf::http::HttpConfig::Create();
-    http_config->SetWorkIoService(&io_service);
+    auto race = racer->AsyncConnect(
+        &socket,
+        asio::ip::tcp::resolver::iterator::create(
+            endpoints.begin(), endpoints.end(), "racer.test", "80"),
+        [&result, &winner](
+                const boost::system::error_code & ec,
+                asio::ip::tcp::endpoint endpoint
+            )
+        {
+            result = ec;
+            winner = endpoint;
+        });
 
-    mf::http::HttpRequest::Pointer request(
-            mf::http::HttpRequest::Create(
-                http_config,
-                std::static_pointer_cast<
-                    mf::http::RequestResponseInterface>(server),
-                MakeUrl(Enc_None, kPort1, "")
-        ));
+    io_service.run();
 
-    // Start the request.
-    request->Start();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
 
+    // The refused attempt starts the next at once, so only the black hole
+    // delays the connection.
+    if ( result || winner != reachable || ! socket.is_open()
+        || elapsed > std::chrono::seconds(5) )
+    {
+        std::cout << "Result: " << result.message() << " Winner: " << winner
+            << " Elapsed ms: " << std::chrono::duration_cast<
+                std::chrono::milliseconds>(elapsed).count() << std::endl;
+        return false;
+    }
+
+    // The winner is tried first next time.
+    const auto ordered = racer->OrderEndpoints("racer.test", "80", endpoints);
+    if ( ordered.front() != reachable )
+    {
+        std::cout << "Winner not remembered." << std::endl;
+        return false;
+    }
+
+    racer->Flush();
+    if ( racer->OrderEndpoints("racer.test", "80", endpoints).front()
+        != black_hole.Endpoint() )
+    {
+        std::cout << "Winner not forgotten." << std::endl;
+        return false;
+    }
+
+    // Every address failing is reported.
+    const mf::http::detail::ConnectRacer::Endpoints unreachable =
+        {refusing, refusing};
+
+    asio::ip::tcp::socket failed_socket(io_service);
+    result = asio::error::would_block;
+
+    io_service.reset();
+    race = racer->AsyncConnect(
+        &failed_socket,
+        asio::ip::tcp::resolver::iterator::create(
+            unreachable.begin(), unreachable.end(), "racer.test", "80"),
+        [&result](
+                const boost::system::error_code & ec,
+                asio::ip::tcp::endpoint
+            )
+        {
+            result = ec;
+        });
     io_service.run();
 
-    return server->Success();
+    if ( result != asio::error::connection_refused )
+    {
+        std::cout << "Result: " << result.message() << std::endl;
+        return false;
+    }
+
+    return true;
 }
 
-bool TestBigContentLength()
+bool TestConnectRacerRequest()
 {
     asio::io_service io_service;
 
@@ -522,53 +2037,83 @@ bool TestBigContentLength()
 
     server->Push( ExpectRegex{ boost::regex(
             "GET.*\r\n"
+            "Host: racer.test.*\r\n"
             "\r\n"
         )});
-
     server->Push(expect_server_test::SendMessage(
             "HTTP/1.1 200 OK\r\n"
             "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
             "Server: Apache\r\n"
-            "Cache-control: no-cache, must-revalidate\r\n"
-            "Pragma: no-cache\r\n"
-            "Expires: 0\r\n"
             "Connection: close\r\n"
-            "Content-Length: 200000\r\n"
+            "Content-Length: 100\r\n"
             "Content-Type: text/html; charset=UTF-8\r\n"
             "\r\n"
         ));
     server->Push( ExpectHeadersRead{} );
-
-    for ( int i = 0; i < 100; ++i )
+    SendRandomContent( server.get(), 100 );
+    server->Push( ExpectDisconnect{100} );
+
+    BlackHole black_hole(&io_service);
+    const auto unreachable = black_hole.Endpoint();
+
+    // The host resolves to an unreachable address before the server.
+    auto lookup = [unreachable](
+            asio::io_service * io_service,
+            const std::string & /* host */,
+            const std::string & port,
+            mf::http::detail::ResolverCache::LookupHandler handler
+        )
     {
-        SendRandomContent( server.get(), 2000 );
-    }
-
-    server->Push( ExpectDisconnect{200000} );
+        mf::http::detail::ResolverCache::Endpoints endpoints;
+        endpoints.push_back(unreachable);
+        endpoints.emplace_back(
+            asio::ip::address::from_string(kHost),
+            static_cast<uint16_t>(std::stoi(port)) );
+
+        io_service->post(
+            [handler, endpoints]()
+            {
+                handler(boost::system::error_code(), endpoints);
+            });
+    };
 
     auto http_config = mf::http::HttpConfig::Create();
     http_config->SetWorkIoService(&io_service);
+    http_config->GetResolverCache()->SetLookupFunction(lookup);
+    http_config->SetConnectAttemptDelay(std::chrono::milliseconds(100));
 
     mf::http::HttpRequest::Pointer request(
             mf::http::HttpRequest::Create(
                 http_config,
                 std::static_pointer_cast<
                     mf::http::RequestResponseInterface>(server),
-                MakeUrl(Enc_None, kPort1, "")
+                "http://racer.test:" + mf::utils::to_string(kPort1) + "/"
         ));
 
-    // Start the request.
+    const auto start = std::chrono::steady_clock::now();
+
     request->Start();
 
     io_service.run();
 
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if ( elapsed > std::chrono::seconds(5) )
+    {
+        std::cout << "Waited on the unreachable address." << std::endl;
+        return false;
+    }
+
     return server->Success();
 }
 
-bool TestBigContentLength2()
+bool TestPost()
 {
     asio::io_service io_service;
 
+    mf::http::SharedBuffer::Pointer shared_buffer(
+        mf::http::SharedBuffer::Create(
+            std::string( "This is a simple POST data." )));
+
     std::shared_ptr<ExpectServer> server =
         ExpectServer::Create(
                 &io_service,
@@ -577,10 +2122,12 @@ bool TestBigContentLength2()
             );
 
     server->Push( ExpectRegex{ boost::regex(
-            "GET.*\r\n"
+            "POST.*\r\n"
             "\r\n"
         )});
 
+    server->Push( ExpectContentLength{shared_buffer->Size()} );
+
     server->Push(expect_server_test::SendMessage(
             "HTTP/1.1 200 OK\r\n"
             "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
@@ -589,18 +2136,19 @@ bool TestBigContentLength2()
             "Pragma: no-cache\r\n"
             "Expires: 0\r\n"
             "Connection: close\r\n"
-            "Content-Length: 200000\r\n"
+            "Transfer-Encoding: chunked\r\n"
             "Content-Type: text/html; charset=UTF-8\r\n"
             "\r\n"
         ));
     server->Push( ExpectHeadersRead{} );
 
-    for ( int i = 0; i < 10; ++i )
-    {
-        SendRandomContent( server.get(), 20000 );
-    }
+    std::size_t total_content = 0;
+#define ChunkSend(x) SendRandomChunk( server.get(), x ); total_content += x;
+    ChunkSend( 5 );
+    ChunkSend( 0 );  // Terminates connection
+#undef ChunkSend
 
-    server->Push( ExpectDisconnect{200000} );
+    server->Push( ExpectDisconnect{total_content} );
 
     auto http_config = mf::http::HttpConfig::Create();
     http_config->SetWorkIoService(&io_service);
@@ -613,6 +2161,9 @@ bool TestBigContentLength2()
                 MakeUrl(Enc_None, kPort1, "")
         ));
 
+    // Add data to send as POST.
+    request->SetPostData(shared_buffer);
+
     // Start the request.
     request->Start();
 
@@ -621,13 +2172,12 @@ bool TestBigContentLength2()
     return server->Success();
 }
 
-bool TestPost()
+bool TestBandwidthLimitPost()
 {
     asio::io_service io_service;
 
     mf::http::SharedBuffer::Pointer shared_buffer(
-        mf::http::SharedBuffer::Create(
-            std::string( "This is a simple POST data." )));
+        mf::http::SharedBuffer::Create( std::string(200000, 'p') ));
 
     std::shared_ptr<ExpectServer> server =
         ExpectServer::Create(
@@ -647,9 +2197,6 @@ bool TestPost()
             "HTTP/1.1 200 OK\r\n"
             "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
             "Server: Apache\r\n"
-            "Cache-control: no-cache, must-revalidate\r\n"
-            "Pragma: no-cache\r\n"
-            "Expires: 0\r\n"
             "Connection: close\r\n"
             "Transfer-Encoding: chunked\r\n"
             "Content-Type: text/html; charset=UTF-8\r\n"
@@ -668,6 +2215,10 @@ bool TestPost()
     auto http_config = mf::http::HttpConfig::Create();
     http_config->SetWorkIoService(&io_service);
 
+    // 200000 bytes at 400000 bytes per second, with no burst.
+    http_config->GetBandwidthLimiter()->SetLimit(
+        mf::http::BandwidthLimiter::Direction::Upload, 400000, 0);
+
     mf::http::HttpRequest::Pointer request(
             mf::http::HttpRequest::Create(
                 http_config,
@@ -679,11 +2230,21 @@ bool TestPost()
     // Add data to send as POST.
     request->SetPostData(shared_buffer);
 
+    const auto start = std::chrono::steady_clock::now();
+
     // Start the request.
     request->Start();
 
     io_service.run();
 
+    // The last piece written is not waited on.
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if ( elapsed < std::chrono::milliseconds(300) )
+    {
+        std::cout << "Upload was not limited." << std::endl;
+        return false;
+    }
+
     return server->Success();
 }
 
@@ -802,6 +2363,148 @@ bool TestPostPipe()
     return server->Success();
 }
 
+class FilePostDataPipe :
+    public mf::http::PostDataPipeInterface
+{
+public:
+    FilePostDataPipe(
+            mf::utils::FileIO::Pointer file,
+            uint64_t offset,
+            uint64_t size
+        ) :
+        file_(file),
+        offset_(offset),
+        size_(size),
+        chunks_retrieved_(0)
+    {}
+
+    virtual uint64_t PostDataSize() const { return size_; }
+
+    virtual mf::http::SharedBuffer::Pointer RetreivePostDataChunk()
+    {
+        if (chunks_retrieved_++ > 0)
+            return mf::http::SharedBuffer::Pointer();
+
+        auto buffer = mf::http::SharedBuffer::Create(size_);
+
+        std::error_code ec;
+        file_->Seek(mf::utils::SeekAnchor::Beginning, offset_, &ec);
+        if ( ! ec )
+            file_->Read(buffer->Data(), size_, &ec);
+
+        return ec ? mf::http::SharedBuffer::Pointer() : buffer;
+    }
+
+    virtual bool PostDataFile(int * file_descriptor, uint64_t * offset)
+    {
+        *file_descriptor = file_->FileDescriptor();
+        *offset = offset_;
+        return true;
+    }
+
+    int ChunksRetrieved() const { return chunks_retrieved_; }
+
+private:
+    mf::utils::FileIO::Pointer file_;
+    uint64_t offset_;
+    uint64_t size_;
+    int chunks_retrieved_;
+};
+
+bool TestPostFile()
+{
+    const std::string skipped = "Not sent.";
+    const std::string content = "This is POST data from a file.";
+
+    const auto path = boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path("post-file-%%%%-%%%%.txt");
+    {
+        std::ofstream out(path.string(), std::ios::binary);
+        out << skipped << content;
+    }
+
+    std::error_code ec;
+    auto file_io = mf::utils::FileIO::Open(path, "rb", &ec);
+    if (ec)
+    {
+        std::cout << "Unable to open " << path.string() << std::endl;
+        return false;
+    }
+
+    asio::io_service io_service;
+
+    std::shared_ptr<ExpectServer> server =
+        ExpectServer::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1
+            );
+
+    server->Push( ExpectRegex{ boost::regex(
+            "POST.*\r\n"
+            "\r\n"
+        )});
+
+    server->Push( ExpectContentLength{content.size()} );
+
+    server->Push(expect_server_test::SendMessage(
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+            "Server: Apache\r\n"
+            "Connection: close\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "\r\n"
+        ));
+    server->Push( ExpectHeadersRead{} );
+
+    std::size_t total_content = 0;
+#define ChunkSend(x) SendRandomChunk( server.get(), x ); total_content += x;
+    ChunkSend( 5 );
+    ChunkSend( 0 );  // Terminates connection
+#undef ChunkSend
+
+    server->Push( ExpectDisconnect{total_content} );
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+
+    // Delays must still apply.
+    http_config->SetBandwidthUsagePercent(50);
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(server),
+                MakeUrl(Enc_None, kPort1, "")
+        ));
+
+    auto pipe = std::make_shared<FilePostDataPipe>(file_io, skipped.size(),
+        content.size());
+
+    request->SetPostDataPipe(pipe);
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    file_io.reset();
+    boost::filesystem::remove(path);
+
+#if defined(__linux__)
+    // The file must have been sent without reading it through the pipe.
+    if (pipe->ChunksRetrieved() != 0)
+    {
+        std::cout << "POST data was not sent with sendfile." << std::endl;
+        return false;
+    }
+#endif
+
+    return server->Success();
+}
+
 bool TestHttpRedirectPermission()
 {
     asio::io_service io_service;
@@ -1247,6 +2950,96 @@ bool TestChunkedSsl()
     return server->Success();
 }
 
+bool TestSslSessionResumption()
+{
+    asio::io_service io_service;
+
+    // Both servers share a context so the second can resume sessions
+    // negotiated with the first.
+    auto server_ssl_ctx = ExpectServerSsl::CreateContext();
+
+    std::shared_ptr<ExpectServerSsl> servers[] = {
+        ExpectServerSsl::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort1,
+                server_ssl_ctx
+            ),
+        ExpectServerSsl::Create(
+                &io_service,
+                MakeWork(&io_service),
+                kPort2,
+                server_ssl_ctx
+            )
+    };
+
+    for (auto & server : servers)
+    {
+        server->Push( ExpectHandshake{} );
+        server->Push( ExpectRegex{ boost::regex(
+                "GET.*\r\n"
+                "\r\n"
+            )});
+        server->Push( expect_server_test::SendMessage(
+                "HTTP/1.1 200 OK\r\n"
+                "Date: Wed, 26 Mar 2014 12:47:29 GMT\r\n"
+                "Server: Apache\r\n"
+                "Connection: close\r\n"
+                "Content-Length: 100\r\n"
+                "Content-Type: text/html; charset=UTF-8\r\n"
+                "\r\n"
+            ));
+        server->Push( ExpectHeadersRead{} );
+        SendRandomContent( server.get(), 100 );
+        server->Push( ExpectDisconnect{100} );
+    }
+
+    auto http_config = mf::http::HttpConfig::Create();
+    http_config->SetWorkIoService(&io_service);
+    http_config->SetTlsSessionCacheSize(8);
+
+    // Our certificate is self signed.
+    http_config->AllowSelfSignedCertificate();
+
+    mf::http::HttpRequest::Pointer second_request;
+
+    auto first_response = std::make_shared<ChainedResponse>(
+        servers[0],
+        [&]()
+        {
+            second_request = mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(servers[1]),
+                MakeUrl(Enc_Ssl, kPort2, "") );
+            second_request->Start();
+        });
+
+    mf::http::HttpRequest::Pointer request(
+            mf::http::HttpRequest::Create(
+                http_config,
+                std::static_pointer_cast<
+                    mf::http::RequestResponseInterface>(first_response),
+                MakeUrl(Enc_Ssl, kPort1, "")
+        ));
+
+    // Start the request.
+    request->Start();
+
+    io_service.run();
+
+    const auto statistics = http_config->GetTlsSessionCacheStatistics();
+
+    if ( statistics.hits != 1 || statistics.misses != 1 )
+    {
+        std::cout << "Session hits: " << statistics.hits
+            << " Session misses: " << statistics.misses << std::endl;
+        return false;
+    }
+
+    return servers[0]->Success() && servers[1]->Success();
+}
+
 bool TestMediafireSsl()
 {
     asio::io_service io_service;
@@ -1664,9 +3457,37 @@ int main(int /* argc */, char* /* argv */[])
     TEST(TestContentLengthEmpty);
     TEST(TestBigContentLength);
     TEST(TestBigContentLength2);
+    TEST(TestBandwidthLimitDownload);
+
+    TEST(TestGzipChunked);
+    TEST(TestGzipContentLength);
+#if defined(HTTP_USE_BROTLI)
+    TEST(TestBrotliContentLength);
+#endif
+#if defined(HTTP_USE_ZSTD)
+    TEST(TestZstdChunked);
+#endif
+    TEST(TestUnsupportedContentEncoding);
+
+    TEST(TestKeepAlive);
+    TEST(TestKeepAliveOutlivesIoService);
+    TEST(TestStaleConnectionGetResent);
+    TEST(TestStaleConnectionPostNotResent);
+
+    TEST(TestDnsCacheCoalesce);
+    TEST(TestDnsCacheNegative);
+    TEST(TestDnsCacheRequest);
+
+    TEST(TestRequestTimings);
+
+    TEST(TestConnectRacerOrder);
+    TEST(TestConnectRacerUnreachable);
+    TEST(TestConnectRacerRequest);
 
     TEST(TestPost);
     TEST(TestPostPipe);
+    TEST(TestPostFile);
+    TEST(TestBandwidthLimitPost);
 
     TEST(TestHttpRedirectPermission);
     TEST(TestHttpRedirect301);
@@ -1674,6 +3495,7 @@ int main(int /* argc */, char* /* argv */[])
 
     TEST(TestFailSelfSignedSsl);
     TEST(TestChunkedSsl);
+    TEST(TestSslSessionResumption);
 
     TEST(TestHttpProxy);
     TEST(TestHttpProxyLogin);
@@ -0,0 +1,91 @@
+/**
+ * @file ut_read_size_adapter.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <chrono>
+
+#include "mediafire_sdk/http/detail/read_size_adapter.hpp"
+
+#define BOOST_TEST_MODULE ReadSizeAdapterUnitTest
+#include "boost/test/unit_test.hpp"
+
+using mf::http::detail::ReadSizeAdapter;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+namespace {
+
+const uint64_t kMin = 1024 * 8;
+const uint64_t kMax = 1024 * 64;
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(StartsAtMinimum)
+{
+    ReadSizeAdapter adapter(kMin, kMax);
+    BOOST_CHECK_EQUAL( adapter.ReadSize(), kMin );
+}
+
+BOOST_AUTO_TEST_CASE(GrowsWhenFast)
+{
+    ReadSizeAdapter adapter(kMin, kMax);
+
+    // Reads completing within the target interval.
+    uint64_t last = adapter.ReadSize();
+    for (int i = 0; i < 3; ++i)
+    {
+        adapter.Record(adapter.ReadSize(), milliseconds(10));
+        BOOST_CHECK( adapter.ReadSize() > last );
+        last = adapter.ReadSize();
+    }
+
+    for (int i = 0; i < 20; ++i)
+        adapter.Record(adapter.ReadSize(), milliseconds(1));
+
+    BOOST_CHECK_EQUAL( adapter.ReadSize(), kMax );
+
+    // Data already waiting takes no time at all.
+    adapter.Record(kMax, milliseconds(0));
+    BOOST_CHECK_EQUAL( adapter.ReadSize(), kMax );
+}
+
+BOOST_AUTO_TEST_CASE(ShrinksWhenSlow)
+{
+    ReadSizeAdapter adapter(kMin, kMax);
+
+    for (int i = 0; i < 20; ++i)
+        adapter.Record(adapter.ReadSize(), milliseconds(1));
+    BOOST_REQUIRE_EQUAL( adapter.ReadSize(), kMax );
+
+    // 64 KiB a second.
+    adapter.Record(kMax, seconds(1));
+    BOOST_CHECK( adapter.ReadSize() < kMax );
+
+    for (int i = 0; i < 20; ++i)
+        adapter.Record(1024, milliseconds(100));
+
+    BOOST_CHECK_EQUAL( adapter.ReadSize(), kMin );
+}
+
+BOOST_AUTO_TEST_CASE(SettlesOnTargetInterval)
+{
+    ReadSizeAdapter adapter(kMin, kMax);
+
+    // 1 MiB a second is about 20 KiB per 20 ms.
+    const double bytes_per_ms = 1024 * 1024 / 1000.0;
+    for (int i = 0; i < 20; ++i)
+    {
+        const uint64_t size = adapter.ReadSize();
+        adapter.Record(size, std::chrono::microseconds(
+            static_cast<int64_t>(size / bytes_per_ms * 1000)));
+    }
+
+    const uint64_t expected = static_cast<uint64_t>(bytes_per_ms
+        * std::chrono::duration_cast<milliseconds>(
+            ReadSizeAdapter::TargetInterval()).count());
+
+    BOOST_CHECK( adapter.ReadSize() > expected - 1024 );
+    BOOST_CHECK( adapter.ReadSize() < expected + 1024 );
+}
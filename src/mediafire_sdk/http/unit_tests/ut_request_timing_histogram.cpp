@@ -0,0 +1,178 @@
+/**
+ * @file ut_request_timing_histogram.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "mediafire_sdk/http/request_timing_histogram.hpp"
+
+#define BOOST_TEST_MODULE RequestTimingHistogramUnitTest
+#include "boost/test/unit_test.hpp"
+
+namespace {
+
+using mf::http::RequestPhase;
+using mf::http::RequestTimingHistogram;
+using mf::http::RequestTimings;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+/** Timings where only the phase given was measured. */
+RequestTimings PhaseTook(RequestPhase phase, microseconds duration)
+{
+    const auto begin = std::chrono::steady_clock::now();
+
+    RequestTimings timings;
+    auto & span = timings.phases[static_cast<std::size_t>(phase)];
+    span.begin = begin;
+    span.end = begin + duration;
+    return timings;
+}
+
+int64_t AsMicroseconds(RequestTimingHistogram::Duration duration)
+{
+    return std::chrono::duration_cast<microseconds>(duration).count();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(TimingsMeasured)
+{
+    auto timings = PhaseTook(RequestPhase::Connect, microseconds(1500));
+
+    BOOST_CHECK( timings.Measured(RequestPhase::Connect) );
+    BOOST_CHECK( ! timings.Measured(RequestPhase::Dns) );
+    BOOST_CHECK_EQUAL(AsMicroseconds(timings.Get(RequestPhase::Connect)),
+        1500);
+    BOOST_CHECK_EQUAL(AsMicroseconds(timings.Get(RequestPhase::Dns)), 0);
+
+    // Begun, but never ended.
+    timings.phases[static_cast<std::size_t>(RequestPhase::Tls)].begin =
+        std::chrono::steady_clock::now();
+    BOOST_CHECK( ! timings.Measured(RequestPhase::Tls) );
+}
+
+BOOST_AUTO_TEST_CASE(NothingRecorded)
+{
+    auto histogram = RequestTimingHistogram::Create();
+
+    BOOST_CHECK_EQUAL(histogram->Count("", RequestPhase::Total), 0);
+    BOOST_CHECK_EQUAL(AsMicroseconds(
+        histogram->Percentile("", RequestPhase::Total, 50)), 0);
+    BOOST_CHECK(histogram->Paths().empty());
+}
+
+BOOST_AUTO_TEST_CASE(Percentiles)
+{
+    auto histogram = RequestTimingHistogram::Create();
+
+    // 1ms to 100ms, one request each.
+    for (int i = 1; i <= 100; ++i)
+    {
+        histogram->RecordRequestTimings("/api/file/get_info.php",
+            PhaseTook(RequestPhase::TimeToFirstByte, milliseconds(i)));
+    }
+
+    BOOST_CHECK_EQUAL(
+        histogram->Count("/api/file/get_info.php",
+            RequestPhase::TimeToFirstByte), 100);
+
+    // Buckets are within about 6% of the durations in them.
+    const double p50 = AsMicroseconds(histogram->Percentile(
+            "/api/file/get_info.php", RequestPhase::TimeToFirstByte, 50));
+    BOOST_CHECK_GE(p50, 50000);
+    BOOST_CHECK_LE(p50, 50000 * 1.07);
+
+    const double p99 = AsMicroseconds(histogram->Percentile(
+            "/api/file/get_info.php", RequestPhase::TimeToFirstByte, 99));
+    BOOST_CHECK_GE(p99, 99000);
+    BOOST_CHECK_LE(p99, 100000);
+
+    // Never more than the longest recorded.
+    BOOST_CHECK_EQUAL(AsMicroseconds(histogram->Percentile(
+            "/api/file/get_info.php", RequestPhase::TimeToFirstByte, 100)),
+        100000);
+}
+
+BOOST_AUTO_TEST_CASE(SmallDurationsAreExact)
+{
+    auto histogram = RequestTimingHistogram::Create();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        histogram->RecordRequestTimings("/",
+            PhaseTook(RequestPhase::Dns, microseconds(i)));
+    }
+
+    BOOST_CHECK_EQUAL(AsMicroseconds(
+        histogram->Percentile("/", RequestPhase::Dns, 50)), 4);
+    BOOST_CHECK_EQUAL(AsMicroseconds(
+        histogram->Percentile("/", RequestPhase::Dns, 90)), 8);
+}
+
+BOOST_AUTO_TEST_CASE(PathsKeptApart)
+{
+    auto histogram = RequestTimingHistogram::Create();
+
+    histogram->RecordRequestTimings("/a",
+        PhaseTook(RequestPhase::Transfer, milliseconds(1)));
+    histogram->RecordRequestTimings("/b",
+        PhaseTook(RequestPhase::Transfer, milliseconds(10)));
+    histogram->RecordRequestTimings("/b",
+        PhaseTook(RequestPhase::Transfer, milliseconds(10)));
+
+    BOOST_CHECK_EQUAL(histogram->Count("/a", RequestPhase::Transfer), 1);
+    BOOST_CHECK_EQUAL(histogram->Count("/b", RequestPhase::Transfer), 2);
+    BOOST_CHECK_EQUAL(histogram->Count("", RequestPhase::Transfer), 3);
+    BOOST_CHECK_EQUAL(histogram->Count("/c", RequestPhase::Transfer), 0);
+
+    // Phases not measured are not counted.
+    BOOST_CHECK_EQUAL(histogram->Count("/a", RequestPhase::Dns), 0);
+
+    BOOST_CHECK_EQUAL(histogram->Paths().size(), 2u);
+
+    BOOST_CHECK_EQUAL(AsMicroseconds(
+        histogram->Percentile("/a", RequestPhase::Transfer, 99)), 1000);
+
+    histogram->Clear();
+    BOOST_CHECK_EQUAL(histogram->Count("", RequestPhase::Transfer), 0);
+    BOOST_CHECK(histogram->Paths().empty());
+}
+
+BOOST_AUTO_TEST_CASE(PathsCapped)
+{
+    auto histogram = RequestTimingHistogram::Create();
+    histogram->SetMaxPaths(3);
+    BOOST_CHECK_EQUAL(histogram->MaxPaths(), 3u);
+
+    // Like download links, each path only requested once.
+    for (int i = 0; i < 1000; ++i)
+    {
+        histogram->RecordRequestTimings("/download/" + std::to_string(i),
+            PhaseTook(RequestPhase::Transfer, milliseconds(1)));
+    }
+
+    // Paths seen before the limit still get their own.
+    histogram->RecordRequestTimings("/download/0",
+        PhaseTook(RequestPhase::Transfer, milliseconds(1)));
+
+    BOOST_CHECK_EQUAL(histogram->Paths().size(), 4u);
+    BOOST_CHECK_EQUAL(histogram->Count("/download/0",
+        RequestPhase::Transfer), 2);
+    BOOST_CHECK_EQUAL(histogram->Count("/download/999",
+        RequestPhase::Transfer), 0);
+    BOOST_CHECK_EQUAL(histogram->Count(RequestTimingHistogram::OtherPath(),
+        RequestPhase::Transfer), 997);
+
+    // Every request still counts toward all paths.
+    BOOST_CHECK_EQUAL(histogram->Count("", RequestPhase::Transfer), 1001);
+
+    histogram->Clear();
+    histogram->RecordRequestTimings("/after",
+        PhaseTook(RequestPhase::Transfer, milliseconds(1)));
+    BOOST_CHECK_EQUAL(histogram->Count("/after", RequestPhase::Transfer), 1);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file ut_shared_buffer_pool.cpp
+ * @author Herbert Jones
+ *
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <cstring>
+
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+#define BOOST_TEST_MODULE SharedBufferPoolUnitTest
+#include "boost/test/unit_test.hpp"
+
+BOOST_AUTO_TEST_CASE(ReusesReleasedStorage)
+{
+    auto pool = mf::http::SharedBufferPool::Create(1024, 2);
+
+    auto first = pool->Acquire(1024);
+    const uint8_t * storage = first->Data();
+    std::memset(first->Data(), 'a', first->Size());
+
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 0 );
+    first.reset();
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 1 );
+
+    // Smaller buffers use the same storage.
+    auto second = pool->Acquire(10);
+    BOOST_CHECK_EQUAL( second->Size(), 10 );
+    BOOST_CHECK( second->Data() == storage );
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(KeepsAtMostMaxIdle)
+{
+    auto pool = mf::http::SharedBufferPool::Create(64, 2);
+
+    {
+        auto a = pool->Acquire(64);
+        auto b = pool->Acquire(64);
+        auto c = pool->Acquire(64);
+    }
+
+    BOOST_CHECK_EQUAL( pool->IdleBuffers(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE(BuffersOutlivePool)
+{
+    auto pool = mf::http::SharedBufferPool::Create(64, 2);
+    auto buffer = pool->Acquire(64);
+
+    pool.reset();
+
+    std::memset(buffer->Data(), 'a', buffer->Size());
+    BOOST_CHECK_EQUAL( buffer->Data()[63], 'a' );
+}
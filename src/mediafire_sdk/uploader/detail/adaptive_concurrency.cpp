@@ -0,0 +1,89 @@
+/**
+ * @file adaptive_concurrency.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "adaptive_concurrency.hpp"
+
+#include <algorithm>
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+AdaptiveConcurrency::AdaptiveConcurrency() :
+    min_limit_(1),
+    max_limit_(1),
+    direction_(1),
+    previous_rate_(0)
+{
+}
+
+void AdaptiveConcurrency::SetRange(
+        uint32_t min_limit,
+        uint32_t max_limit
+    )
+{
+    min_limit_ = std::max<uint32_t>(1, min_limit);
+    max_limit_ = std::max(min_limit_, max_limit);
+
+    direction_ = 1;
+    previous_rate_ = 0;
+}
+
+uint32_t AdaptiveConcurrency::Clamp(uint32_t limit) const
+{
+    return std::min(std::max(limit, min_limit_), max_limit_);
+}
+
+void AdaptiveConcurrency::Reset()
+{
+    previous_rate_ = 0;
+}
+
+uint32_t AdaptiveConcurrency::Sample(
+        uint32_t limit,
+        uint64_t rate,
+        bool uploads_waiting
+    )
+{
+    bool step = true;
+    if (previous_rate_ != 0)
+    {
+        const uint64_t lower = previous_rate_ * (100 - TolerancePercent());
+        const uint64_t upper = previous_rate_ * (100 + TolerancePercent());
+
+        if (rate * 100 < lower)
+        {
+            // The last change made things worse, so undo it.
+            direction_ = -direction_;
+        }
+        else if (rate * 100 <= upper)
+        {
+            // No significant change, so stay put.
+            step = false;
+        }
+    }
+
+    // Growing only helps if uploads are waiting on the limit.
+    if (direction_ > 0 && ! uploads_waiting)
+        step = false;
+
+    if (step && direction_ > 0)
+        ++limit;
+    else if (step && direction_ < 0 && limit > 0)
+        --limit;
+
+    previous_rate_ = rate;
+
+    return Clamp(limit);
+}
+
+uint64_t AdaptiveConcurrency::TolerancePercent()
+{
+    return 5;
+}
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
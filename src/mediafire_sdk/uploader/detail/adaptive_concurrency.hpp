@@ -0,0 +1,83 @@
+/**
+ * @file adaptive_concurrency.hpp
+ * @author Herbert Jones
+ * @brief Steps a concurrency limit toward the best measured throughput.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+/**
+ * @class AdaptiveConcurrency
+ * @brief Decides the upload limit from the throughput of each sample.
+ *
+ * The limit keeps moving by one in the same direction while throughput
+ * improves, stays put while it changes little, and turns around once a step
+ * made it worse.  It only grows while uploads are waiting on it.
+ */
+class AdaptiveConcurrency
+{
+public:
+    AdaptiveConcurrency();
+
+    /**
+     * @brief Set the range the limit is kept in, and start measuring anew.
+     *
+     * @param[in] min_limit Smallest limit, at least 1.
+     * @param[in] max_limit Largest limit, at least min_limit.
+     */
+    void SetRange(
+            uint32_t min_limit,
+            uint32_t max_limit
+        );
+
+    uint32_t MinLimit() const { return min_limit_; }
+    uint32_t MaxLimit() const { return max_limit_; }
+
+    /**
+     * @return The limit moved into the range.
+     */
+    uint32_t Clamp(uint32_t limit) const;
+
+    /**
+     * @brief Forget the previous sample, as after being idle.
+     */
+    void Reset();
+
+    /**
+     * @brief Decide the limit after a sample.
+     *
+     * @param[in] limit Limit during the sample.
+     * @param[in] rate Bytes per second sent during the sample.
+     * @param[in] uploads_waiting Whether uploads are waiting on the limit.
+     *
+     * @return Limit for the next sample.
+     */
+    uint32_t Sample(
+            uint32_t limit,
+            uint64_t rate,
+            bool uploads_waiting
+        );
+
+    /**
+     * @brief How much the rate must change to count as better or worse.
+     *
+     * @return Percentage of the previous rate.
+     */
+    static uint64_t TolerancePercent();
+
+private:
+    uint32_t min_limit_;
+    uint32_t max_limit_;
+    int direction_;
+    uint64_t previous_rate_;
+};
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
@@ -0,0 +1,95 @@
+/**
+ * @file concurrency_limit.hpp
+ * @author Herbert Jones
+ * @brief Counts work running against a limit.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+/**
+ * @class ConcurrencyLimit
+ * @brief Counts the work running, and the work asked to start that has not
+ * yet, against a limit.
+ *
+ * Work asked to start holds a slot until it starts, or until it is abandoned
+ * because it ended before starting.  Not thread safe.
+ */
+template <typename Key>
+class ConcurrencyLimit
+{
+public:
+    /**
+     * @param[in] limit Most work at once, at least 1.
+     */
+    explicit ConcurrencyLimit(uint32_t limit) :
+        limit_(std::max<uint32_t>(1, limit)),
+        running_(0)
+    {
+    }
+
+    /**
+     * @brief Change the limit.  Work already running is not stopped.
+     *
+     * @param[in] limit Most work at once, at least 1.
+     */
+    void SetLimit(uint32_t limit) { limit_ = std::max<uint32_t>(1, limit); }
+
+    uint32_t Limit() const { return limit_; }
+
+    /**
+     * @return Whether more work may be asked to start.
+     */
+    bool CanStartMore() const
+    {
+        return running_ + starting_.size() < limit_;
+    }
+
+    /**
+     * @brief Take a slot for work asked to start.
+     */
+    void Starting(Key key) { starting_.insert(key); }
+
+    /**
+     * @brief Work asked to start, or started some other way, is running.
+     */
+    void Started(Key key)
+    {
+        ++running_;
+        starting_.erase(key);
+    }
+
+    /**
+     * @brief Running work ended, whether it succeeded or not.
+     */
+    void Stopped()
+    {
+        if (running_ > 0)
+            --running_;
+    }
+
+    /**
+     * @brief Work ended.  Releases its slot if it had not started yet.
+     */
+    void Abandoned(Key key) { starting_.erase(key); }
+
+    uint32_t Running() const { return running_; }
+
+    std::size_t StartingCount() const { return starting_.size(); }
+
+private:
+    uint32_t limit_;
+    uint32_t running_;
+    std::set<Key> starting_;
+};
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
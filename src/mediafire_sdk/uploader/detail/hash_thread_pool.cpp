@@ -0,0 +1,54 @@
+/**
+ * @file hash_thread_pool.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "hash_thread_pool.hpp"
+
+#include <algorithm>
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+HashThreadPool::Pointer HashThreadPool::Create(uint32_t thread_count)
+{
+    return Pointer(new HashThreadPool(thread_count));
+}
+
+HashThreadPool::HashThreadPool(uint32_t thread_count) :
+    work_(new boost::asio::io_service::work(io_service_))
+{
+    thread_count = std::max<uint32_t>(1, thread_count);
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        threads_.create_thread(
+            [this]()
+            {
+                io_service_.run();
+            });
+    }
+}
+
+HashThreadPool::~HashThreadPool()
+{
+    work_.reset();
+    io_service_.stop();
+
+    threads_.join_all();
+}
+
+boost::asio::io_service * HashThreadPool::IoService()
+{
+    return &io_service_;
+}
+
+uint32_t HashThreadPool::ThreadCount() const
+{
+    return static_cast<uint32_t>(threads_.size());
+}
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
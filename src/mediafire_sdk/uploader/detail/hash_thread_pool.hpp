@@ -0,0 +1,55 @@
+/**
+ * @file hash_thread_pool.hpp
+ * @author Herbert Jones
+ * @brief Threads dedicated to reading and hashing files.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/thread/thread.hpp"
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+/**
+ * @class HashThreadPool
+ * @brief Runs blocking file reads and hashing away from the io_service used
+ * for network operations.
+ *
+ * Work is posted to IoService().  Handlers still queued when the pool is
+ * destroyed are discarded, and the destructor waits for running handlers to
+ * return, so the pool must never be destroyed from one of its own handlers.
+ */
+class HashThreadPool
+{
+public:
+    using Pointer = std::shared_ptr<HashThreadPool>;
+
+    /**
+     * @param[in] thread_count Number of threads, at least 1.
+     */
+    static Pointer Create(uint32_t thread_count);
+
+    ~HashThreadPool();
+
+    boost::asio::io_service * IoService();
+
+    uint32_t ThreadCount() const;
+
+private:
+    explicit HashThreadPool(uint32_t thread_count);
+
+    boost::asio::io_service io_service_;
+    std::unique_ptr<boost::asio::io_service::work> work_;
+
+    boost::thread_group threads_;
+};
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
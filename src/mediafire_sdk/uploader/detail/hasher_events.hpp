@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <system_error>
 
 #include "boost/asio/io_service.hpp"
@@ -25,6 +26,15 @@ struct HasherStateData_
 {
     boost::asio::io_service * io_service;
 
+    /** Threads to read the file on, or null to read on io_service. */
+    boost::asio::io_service * hash_io_service = nullptr;
+
+    /** Threads hashing units in parallel on the hashing threads, or 0. */
+    uint32_t unit_hash_threads = 0;
+
+    /** Set to stop reading on the hashing threads. */
+    std::atomic<bool> cancelled{false};
+
     boost::filesystem::path filepath;
     uint64_t filesize;
     std::time_t mtime;
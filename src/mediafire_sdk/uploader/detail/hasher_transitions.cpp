@@ -5,11 +5,220 @@
  */
 #include "hasher_transitions.hpp"
 
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "mediafire_sdk/uploader/detail/parallel_unit_hasher.hpp"
+#include "mediafire_sdk/uploader/error.hpp"
+
+namespace {
+// Reads on the hashing threads are large and page aligned, as the threads do
+// nothing but wait on the disk and hash.
+const uint64_t kHashReadSize = 1024 * 1024;
+const uintptr_t kHashReadAlignment = 4096;
+
+// Buffers waiting for the unit hashing threads.
+const std::size_t kMaxQueuedUnitBuffers = 8;
+
+std::shared_ptr<char> CreateReadBuffer()
+{
+    auto storage = std::make_shared<std::vector<char>>(
+        kHashReadSize + kHashReadAlignment);
+
+    const uintptr_t address = reinterpret_cast<uintptr_t>(storage->data());
+    char * buffer = storage->data() + (kHashReadAlignment
+        - address % kHashReadAlignment) % kHashReadAlignment;
+
+    return std::shared_ptr<char>(storage, buffer);
+}
+}  // namespace
+
 namespace mf {
 namespace uploader {
 namespace detail {
 namespace hash_transition {
 
+std::error_code CheckFileUnchanged(
+        const hash_event::HasherStateData & state,
+        std::string * description
+    )
+{
+    using mf::utils::file_io_error;
+
+    const auto filepath = state->filepath;
+    const auto original_filesize = state->filesize;
+    const auto original_mtime = state->mtime;
+
+    boost::system::error_code bec;
+
+    // Check mtime
+    const std::time_t mtime = boost::filesystem::last_write_time(
+        state->filepath, bec);
+
+    if (bec)
+    {
+        *description = "Unable to get file mtime.";
+        return std::error_code(bec.value(), std::system_category());
+    }
+
+    if (mtime != original_mtime)
+    {
+        *description = "Mtime changed from expected value.";
+        return make_error_code(file_io_error::FileModified);
+    }
+
+    const uint64_t filesize = boost::filesystem::file_size(filepath, bec);
+
+    if (bec)
+    {
+        *description = "Unable to get filesize.";
+        return std::error_code(bec.value(), std::system_category());
+    }
+
+    if (filesize != original_filesize)
+    {
+        *description = "Filesize changed from expected value.";
+        return make_error_code(file_io_error::FileModified);
+    }
+
+    return std::error_code();
+}
+
+namespace {
+
+/**
+ * Read the file to the end, passing each read to consume.  Buffers are reused
+ * once consume no longer holds a reference to them.
+ */
+std::error_code ReadRemaining(
+        const hash_event::HasherStateData & state,
+        const mf::utils::FileIO::Pointer & file_io,
+        std::size_t buffer_count,
+        const std::function<void(std::shared_ptr<char>, uint64_t)> & consume,
+        std::string * description
+    )
+{
+    using mf::utils::file_io_error;
+
+    std::vector<std::shared_ptr<char>> buffers;
+
+    for (;;)
+    {
+        if (state->cancelled)
+        {
+            *description = "Call cancelled";
+            return make_error_code(mf::uploader::errc::Cancelled);
+        }
+
+        auto ec = CheckFileUnchanged(state, description);
+        if (ec)
+            return ec;
+
+        std::shared_ptr<char> buffer;
+        for (const auto & candidate : buffers)
+        {
+            if (candidate.use_count() == 1)
+            {
+                buffer = candidate;
+                break;
+            }
+        }
+        if ( ! buffer )
+        {
+            assert(buffers.size() < buffer_count);
+            buffer = CreateReadBuffer();
+            buffers.push_back(buffer);
+        }
+
+        const auto bytes_read = file_io->Read(buffer.get(), kHashReadSize,
+            &ec);
+
+        if (ec && ec != file_io_error::EndOfFile)
+        {
+            *description = "Error occured during file read.";
+            return ec;
+        }
+
+        consume(std::move(buffer), bytes_read);
+
+        if (ec)
+            return std::error_code();  // EndOfFile
+    }
+}
+
+/**
+ * Hash the whole file on this thread and its units on unit hashing threads,
+ * reading the file only once.
+ */
+std::error_code HashUnitsInParallel(
+        const hash_event::HasherStateData & state,
+        const mf::utils::FileIO::Pointer & file_io,
+        std::string * description
+    )
+{
+    ParallelUnitHasher unit_hasher(state->chunk_ranges,
+        state->unit_hash_threads, kMaxQueuedUnitBuffers);
+
+    auto & hasher = state->primary_hasher;
+
+    const auto ec = ReadRemaining(state, file_io, kMaxQueuedUnitBuffers + 1,
+        [&](std::shared_ptr<char> buffer, uint64_t bytes_read)
+        {
+            if (bytes_read == 0)
+                return;
+
+            hasher.Update(bytes_read, buffer.get());
+            unit_hasher.Add(std::move(buffer),
+                static_cast<std::size_t>(bytes_read));
+        },
+        description);
+
+    if ( ! ec )
+        state->chunk_hashes = unit_hasher.Finish();
+
+    return ec;
+}
+
+}  // namespace
+
+std::error_code HashRemaining(
+        const hash_event::HasherStateData & state,
+        const mf::utils::FileIO::Pointer & file_io,
+        uint64_t read_byte_pos,
+        std::string * sha256_hash,
+        std::string * description
+    )
+{
+    std::error_code ec;
+
+    if ( state->unit_hash_threads > 0 && read_byte_pos == 0
+        && state->chunk_ranges.size() > 1 )
+    {
+        ec = HashUnitsInParallel(state, file_io, description);
+    }
+    else
+    {
+        ec = ReadRemaining(state, file_io, 1,
+            [&](std::shared_ptr<char> buffer, uint64_t bytes_read)
+            {
+                read_byte_pos = ParseRead(state, read_byte_pos, bytes_read,
+                    buffer.get());
+            },
+            description);
+    }
+
+    if (ec)
+        return ec;
+
+    assert( state->chunk_ranges.size() == state->chunk_hashes.size() );
+
+    *sha256_hash = state->primary_hasher.Digest();
+
+    return CheckFileUnchanged(state, description);
+}
+
 uint64_t ParseRead(
         const hash_event::HasherStateData & state,
         const uint64_t previous_total_bytes_read,
@@ -6,6 +6,10 @@
  */
 #pragma once
 
+#include <memory>
+#include <string>
+#include <system_error>
+
 #include "boost/filesystem.hpp"
 
 #include "mediafire_sdk/utils/error.hpp"
@@ -23,64 +27,56 @@ uint64_t ParseRead(
         const char * const buffer
     );
 
+/**
+ * @brief Check the file still has the size and mtime it had when hashing
+ * started.
+ *
+ * @param[in] state Hasher state.
+ * @param[out] description Description of the failure.
+ *
+ * @return Error if the file changed or could not be checked.
+ */
+std::error_code CheckFileUnchanged(
+        const hash_event::HasherStateData & state,
+        std::string * description
+    );
+
+/**
+ * @brief Read and hash the rest of the file with large reads.
+ *
+ * Blocks until the whole file is read, so only call on the hashing threads.
+ *
+ * @param[in] state Hasher state.
+ * @param[in] file_io Open file.
+ * @param[in] read_byte_pos Bytes already read from file_io.
+ * @param[out] sha256_hash Hash of the whole file.
+ * @param[out] description Description of the failure.
+ *
+ * @return Error if reading failed, the file changed or hashing was cancelled.
+ */
+std::error_code HashRemaining(
+        const hash_event::HasherStateData & state,
+        const mf::utils::FileIO::Pointer & file_io,
+        uint64_t read_byte_pos,
+        std::string * sha256_hash,
+        std::string * description
+    );
+
 template <typename FSM>
 bool VerifyFileUnchanged(
         const hash_event::HasherStateData & state,
         FSM & fsm
     )
 {
-    using mf::utils::file_io_error;
-
-    const auto filepath = state->filepath;
-    const auto original_filesize = state->filesize;
-    const auto original_mtime = state->mtime;
-
-    boost::system::error_code bec;
-
-    // Check mtime
-    const std::time_t mtime = boost::filesystem::last_write_time(
-        state->filepath, bec);
+    std::string description;
+    const auto ec = CheckFileUnchanged(state, &description);
 
-    if (bec)
+    if (ec)
     {
-        std::error_code ec(bec.value(), std::system_category());
         fsm.process_event( hash_event::Error{
             state,
             ec,
-            "Unable to get file mtime."
-            } );
-        return false;
-    }
-
-    if (mtime != original_mtime)
-    {
-        fsm.process_event( hash_event::Error{
-            state,
-            make_error_code(file_io_error::FileModified),
-            "Mtime changed from expected value."
-            } );
-        return false;
-    }
-
-    const uint64_t filesize = boost::filesystem::file_size(filepath, bec);
-
-    if (bec)
-    {
-        std::error_code ec(bec.value(), std::system_category());
-        fsm.process_event( hash_event::Error{
-            state,
-            ec,
-            "Unable to get filesize."
-            } );
-        return false;
-    }
-
-    if (filesize != original_filesize)
-    {
-        fsm.process_event( hash_event::Error{
-            state,
-            make_error_code(file_io_error::FileModified),
-            "Filesize changed from expected value."
+            description
             } );
         return false;
     }
@@ -123,6 +119,65 @@ struct OpenFile
 
 struct ReadFile
 {
+    /**
+     * Hash the rest of the file on the hashing threads and only post the
+     * result back to the io_service of the state machine.
+     */
+    template <typename FSM>
+    void ReadOnHashThreads(
+            hash_event::ReadNext const & src_evt,
+            FSM & fsm
+        )
+    {
+        auto state = src_evt.state;
+        auto file_io = src_evt.file_io;
+        const auto read_byte_pos = src_evt.read_byte_pos;
+
+        // Only hold the machine weakly, as it must not be destroyed on the
+        // hashing threads.
+        auto shared_fsm = fsm.shared_from_this();
+        std::weak_ptr<typename decltype(shared_fsm)::element_type> weak_fsm(
+            shared_fsm);
+        FSM * fsm_ptr = &fsm;
+
+        state->hash_io_service->post(
+            [weak_fsm, fsm_ptr, state, file_io, read_byte_pos]()
+            {
+                std::string sha256_hash;
+                std::string description;
+
+                const auto ec = HashRemaining(state, file_io, read_byte_pos,
+                    &sha256_hash, &description);
+
+                if (state->cancelled)
+                    return;
+
+                state->io_service->post(
+                    [weak_fsm, fsm_ptr, state, ec, sha256_hash, description]()
+                    {
+                        auto shared_fsm = weak_fsm.lock();
+                        if ( ! shared_fsm || state->cancelled )
+                            return;
+
+                        if (ec)
+                        {
+                            fsm_ptr->process_event( hash_event::Error{
+                                state,
+                                ec,
+                                description
+                                } );
+                        }
+                        else
+                        {
+                            fsm_ptr->process_event( hash_event::HashSuccess{
+                                state,
+                                sha256_hash
+                                } );
+                        }
+                    });
+            });
+    }
+
     template <typename FSM,typename SourceState,typename TargetState>
     void operator()(
             hash_event::ReadNext const & src_evt,
@@ -139,6 +194,12 @@ struct ReadFile
         const auto & file_io = src_evt.file_io;
         const auto & previous_total_bytes_read = src_evt.read_byte_pos;
 
+        if (state->hash_io_service)
+        {
+            ReadOnHashThreads(src_evt, fsm);
+            return;
+        }
+
         if ( VerifyFileUnchanged(state, fsm) )
         {
             const int buf_size = 1024 * 8;
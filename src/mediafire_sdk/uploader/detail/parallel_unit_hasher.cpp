@@ -0,0 +1,165 @@
+/**
+ * @file parallel_unit_hasher.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "parallel_unit_hasher.hpp"
+
+#include <algorithm>
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+ParallelUnitHasher::ParallelUnitHasher(
+        std::vector<std::pair<uint64_t,uint64_t>> chunk_ranges,
+        uint32_t thread_count,
+        std::size_t max_queued
+    ) :
+    chunk_ranges_(std::move(chunk_ranges)),
+    max_queued_(std::max<std::size_t>(1, max_queued)),
+    position_(0),
+    current_unit_(0),
+    queued_(0),
+    finishing_(false),
+    stopping_(false),
+    unit_hashers_(chunk_ranges_.size()),
+    unit_hashes_(chunk_ranges_.size()),
+    joined_(false)
+{
+    // More workers than units would never have anything to do.
+    const std::size_t worker_count = std::max<std::size_t>(1,
+        std::min<std::size_t>(thread_count, chunk_ranges_.size()));
+
+    queues_.resize(worker_count);
+
+    for (std::size_t worker = 0; worker < worker_count; ++worker)
+    {
+        threads_.create_thread(
+            [this, worker]()
+            {
+                Run(worker);
+            });
+    }
+}
+
+ParallelUnitHasher::~ParallelUnitHasher()
+{
+    if (joined_)
+        return;
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+
+    work_ready_.notify_all();
+    threads_.join_all();
+}
+
+void ParallelUnitHasher::Add(
+        std::shared_ptr<const char> data,
+        std::size_t size
+    )
+{
+    std::vector<Slice> slices;
+
+    // Split the buffer at unit boundaries.
+    std::size_t offset = 0;
+    // Data past the last unit means the file grew, which the caller detects.
+    while (offset < size && current_unit_ < chunk_ranges_.size())
+    {
+        const auto unit_end = chunk_ranges_[current_unit_].second;
+        const auto slice_size = static_cast<std::size_t>(std::min<uint64_t>(
+            size - offset, unit_end - position_));
+
+        position_ += slice_size;
+        const bool unit_complete = (position_ == unit_end);
+
+        slices.push_back(Slice{
+            current_unit_,
+            std::shared_ptr<const char>(data, data.get() + offset),
+            slice_size,
+            unit_complete
+            });
+
+        offset += slice_size;
+        if (unit_complete)
+            ++current_unit_;
+    }
+
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    for (auto & slice : slices)
+    {
+        while (queued_ >= max_queued_ && ! stopping_)
+            space_ready_.wait(lock);
+
+        if (stopping_)
+            return;
+
+        ++queued_;
+        queues_[slice.unit % queues_.size()].push_back(std::move(slice));
+    }
+
+    lock.unlock();
+
+    work_ready_.notify_all();
+}
+
+std::vector<std::string> ParallelUnitHasher::Finish()
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        finishing_ = true;
+    }
+
+    work_ready_.notify_all();
+    threads_.join_all();
+    joined_ = true;
+
+    return unit_hashes_;
+}
+
+void ParallelUnitHasher::Run(std::size_t worker)
+{
+    auto & queue = queues_[worker];
+
+    for (;;)
+    {
+        Slice slice;
+
+        {
+            mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+            while ( queue.empty() && ! finishing_ && ! stopping_ )
+                work_ready_.wait(lock);
+
+            if ( stopping_ || queue.empty() )
+                return;
+
+            slice = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        auto & hasher = unit_hashers_[slice.unit];
+        hasher.Update(slice.size, slice.data.get());
+
+        if (slice.unit_complete)
+            unit_hashes_[slice.unit] = hasher.Digest();
+
+        // Release the buffer before making room for another.
+        slice.data.reset();
+
+        {
+            mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+            --queued_;
+        }
+
+        space_ready_.notify_one();
+    }
+}
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
@@ -0,0 +1,113 @@
+/**
+ * @file parallel_unit_hasher.hpp
+ * @author Herbert Jones
+ * @brief Hashes the units of a file on several threads.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/thread.hpp"
+
+#include "mediafire_sdk/utils/mutex.hpp"
+#include "mediafire_sdk/utils/sha256_hasher.hpp"
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+/**
+ * @class ParallelUnitHasher
+ * @brief Hashes the units of a file on worker threads while the caller reads
+ * the file and hashes it as a whole.
+ *
+ * The file is read once.  Each buffer is handed to the worker of the units it
+ * covers, and units are spread over the workers round robin, so one unit is
+ * hashed while the caller reads and hashes the following data.
+ */
+class ParallelUnitHasher
+{
+public:
+    /**
+     * @param[in] chunk_ranges Unit ranges of the file, as from ChunkRanges.
+     * @param[in] thread_count Number of worker threads, at least 1.
+     * @param[in] max_queued Buffers that may wait for a worker before Add
+     *                       blocks.
+     */
+    ParallelUnitHasher(
+            std::vector<std::pair<uint64_t,uint64_t>> chunk_ranges,
+            uint32_t thread_count,
+            std::size_t max_queued
+        );
+
+    /**
+     * Stops the workers.  Units not yet hashed are dropped.
+     */
+    ~ParallelUnitHasher();
+
+    /**
+     * @brief Hand the next bytes of the file to the workers.
+     *
+     * Blocks while too many buffers are waiting.  The buffer must not be
+     * modified while the hasher holds a reference to it.
+     *
+     * @param[in] data Next bytes of the file.
+     * @param[in] size Number of bytes.
+     */
+    void Add(
+            std::shared_ptr<const char> data,
+            std::size_t size
+        );
+
+    /**
+     * @brief Wait for all units to be hashed.
+     *
+     * @return Unit hashes in file order.
+     */
+    std::vector<std::string> Finish();
+
+private:
+    struct Slice
+    {
+        std::size_t unit;
+        std::shared_ptr<const char> data;
+        std::size_t size;
+        bool unit_complete;
+    };
+
+    void Run(std::size_t worker);
+
+    const std::vector<std::pair<uint64_t,uint64_t>> chunk_ranges_;
+    const std::size_t max_queued_;
+
+    // Only the reading thread uses these.
+    uint64_t position_;
+    std::size_t current_unit_;
+
+    mf::utils::mutex mutex_;
+    boost::condition_variable_any work_ready_;
+    boost::condition_variable_any space_ready_;
+
+    std::vector<std::deque<Slice>> queues_;
+    std::size_t queued_;
+    bool finishing_;
+    bool stopping_;
+
+    // Each unit is only touched by its worker.
+    std::vector<mf::utils::Sha256Hasher> unit_hashers_;
+    std::vector<std::string> unit_hashes_;
+
+    boost::thread_group threads_;
+    bool joined_;
+};
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
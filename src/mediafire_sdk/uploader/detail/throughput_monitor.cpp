@@ -0,0 +1,56 @@
+/**
+ * @file throughput_monitor.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "throughput_monitor.hpp"
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+ThroughputMonitor::ThroughputMonitor(
+        mf::http::BandwidthAnalyserInterface::Pointer forward_to
+    ) :
+    forward_to_(forward_to),
+    outgoing_bytes_(0)
+{
+}
+
+void ThroughputMonitor::RecordIncomingBytes(
+        size_t bytes,
+        std::chrono::steady_clock::time_point start_time,
+        std::chrono::steady_clock::time_point end_time
+    )
+{
+    if (forward_to_)
+        forward_to_->RecordIncomingBytes(bytes, start_time, end_time);
+}
+
+void ThroughputMonitor::RecordOutgoingBytes(
+        size_t bytes,
+        std::chrono::steady_clock::time_point start_time,
+        std::chrono::steady_clock::time_point end_time
+    )
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        outgoing_bytes_ += bytes;
+    }
+
+    if (forward_to_)
+        forward_to_->RecordOutgoingBytes(bytes, start_time, end_time);
+}
+
+uint64_t ThroughputMonitor::TakeOutgoingBytes()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    const uint64_t bytes = outgoing_bytes_;
+    outgoing_bytes_ = 0;
+    return bytes;
+}
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
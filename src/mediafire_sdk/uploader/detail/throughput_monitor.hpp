@@ -0,0 +1,62 @@
+/**
+ * @file throughput_monitor.hpp
+ * @author Herbert Jones
+ * @brief Bandwidth analyser measuring upload throughput.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "mediafire_sdk/http/bandwidth_analyser_interface.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+/**
+ * @class ThroughputMonitor
+ * @brief Counts outgoing bytes and passes all records on to another analyser.
+ */
+class ThroughputMonitor : public mf::http::BandwidthAnalyserInterface
+{
+public:
+    /**
+     * @param[in] forward_to Analyser to pass records on to, may be null.
+     */
+    explicit ThroughputMonitor(
+            mf::http::BandwidthAnalyserInterface::Pointer forward_to
+        );
+
+    virtual void RecordIncomingBytes(
+            size_t bytes,
+            std::chrono::steady_clock::time_point start_time,
+            std::chrono::steady_clock::time_point end_time
+        ) override;
+
+    virtual void RecordOutgoingBytes(
+            size_t bytes,
+            std::chrono::steady_clock::time_point start_time,
+            std::chrono::steady_clock::time_point end_time
+        ) override;
+
+    /**
+     * @brief Get the bytes sent since the previous call.
+     *
+     * @return Outgoing byte count.
+     */
+    uint64_t TakeOutgoingBytes();
+
+private:
+    mf::http::BandwidthAnalyserInterface::Pointer forward_to_;
+
+    mf::utils::mutex mutex_;
+    uint64_t outgoing_bytes_;
+};
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
@@ -5,6 +5,12 @@
  */
 #include "transition_upload.hpp"
 
+#include <chrono>
+#include <random>
+
+#include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
 namespace mf {
 namespace uploader {
 namespace detail {
@@ -16,6 +22,55 @@ std::string AsDateTime(std::time_t datetime)
     return boost::posix_time::to_iso_extended_string(ptime_) + "Z";
 }
 
+bool IsTransientUnitError(const std::error_code & error_code,
+                          unsigned int status_code)
+{
+    using mf::http::http_error;
+
+    // The server failed rather than rejected the unit.
+    if (status_code >= 500)
+        return true;
+
+    if (error_code.category() != mf::http::http_category())
+        return false;
+
+    switch (static_cast<http_error>(error_code.value()))
+    {
+        case http_error::UnableToResolve:
+        case http_error::UnableToConnect:
+        case http_error::UnableToConnectToProxy:
+        case http_error::SslHandshakeFailure:
+        case http_error::WriteFailure:
+        case http_error::ReadFailure:
+        case http_error::IoTimeout:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::chrono::milliseconds UnitRetryDelay(uint32_t failures)
+{
+    std::chrono::milliseconds delay = unit_retry_initial_delay;
+    for (uint32_t i = 1; i < failures && delay < unit_retry_max_delay; ++i)
+        delay *= 2;
+    delay = std::min(delay, unit_retry_max_delay);
+
+    // Spread out units that failed together, such as when a connection drops.
+    // Seeded once from the clock, as a random_device may be slow to open or
+    // missing altogether.
+    static std::minstd_rand generator(
+        static_cast<std::minstd_rand::result_type>(
+            std::chrono::system_clock::now().time_since_epoch().count()));
+    static mf::utils::mutex mutex;
+
+    std::uniform_int_distribution<int64_t> dist(delay.count() / 2,
+                                                delay.count());
+
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex);
+    return std::chrono::milliseconds(dist(generator));
+}
+
 std::string AssembleQuery(
         const std::map< std::string, std::string > & query_map
     )
@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <iostream>
 #include <map>
 
@@ -24,9 +25,11 @@
 #include "mediafire_sdk/uploader/detail/hasher_events.hpp"
 #include "mediafire_sdk/uploader/detail/types.hpp"
 #include "mediafire_sdk/uploader/detail/upload_events.hpp"
+#include "mediafire_sdk/uploader/detail/upload_post_data_pipe.hpp"
 #include "mediafire_sdk/uploader/detail/upload_target.hpp"
 #include "mediafire_sdk/uploader/error.hpp"
 #include "mediafire_sdk/uploader/upload_request.hpp"
+#include "mediafire_sdk/uploader/upload_status.hpp"
 
 #include "mediafire_sdk/utils/string.hpp"
 #include "mediafire_sdk/utils/url_encode.hpp"
@@ -40,8 +43,30 @@ namespace detail
 namespace upload_transition
 {
 
+/** Times a single unit is sent again before the upload fails. */
+const uint32_t max_unit_retries = 5;
+
+/** Units of one upload sent again before the upload fails. */
+const uint32_t max_upload_retries = 50;
+
+/** Wait before sending a failed unit again, doubled for each failure. */
+const std::chrono::milliseconds unit_retry_initial_delay(500);
+const std::chrono::milliseconds unit_retry_max_delay(30000);
+
 std::string AsDateTime(std::time_t datetime);
 
+/**
+ * @brief Whether a failed unit request may succeed if sent again.
+ *
+ * @param[in] error_code Error of the request.
+ * @param[in] status_code HTTP status of the response, or 0 if none.
+ */
+bool IsTransientUnitError(const std::error_code & error_code,
+                          unsigned int status_code);
+
+/** Wait before sending a unit again after its failure number failures. */
+std::chrono::milliseconds UnitRetryDelay(uint32_t failures);
+
 std::string AssembleQuery(const std::map<std::string, std::string> & query_map);
 
 class TargetUrlVisitor : public boost::static_visitor<>
@@ -67,88 +92,6 @@ private:
     std::map<std::string, std::string> & query_map_;
 };
 
-class UploadPostDataPipe : public mf::http::PostDataPipeInterface
-{
-public:
-    UploadPostDataPipe(mf::utils::FileIO::Pointer file,
-                       const uint64_t start_byte,
-                       const uint64_t end_byte)
-            : file_(file),
-              start_byte_(start_byte),
-              end_byte_(end_byte),
-              current_read_pos_(start_byte_)
-    {
-        assert(file_);
-
-        // Range should be correct and never empty
-        assert(PostDataSize() > 0);
-        assert(start_byte < end_byte);
-    }
-
-    virtual uint64_t PostDataSize() const { return end_byte_ - start_byte_; }
-
-    virtual mf::http::SharedBuffer::Pointer RetreivePostDataChunk()
-    {
-        assert(file_->Tell() == current_read_pos_);
-
-        if (file_->Tell() != current_read_pos_)
-        {
-            std::error_code ec;
-            file_->Seek(mf::utils::SeekAnchor::Beginning, current_read_pos_,
-                        &ec);
-
-            if (ec)
-            {
-                /** @todo hjones: Emit error */
-                return mf::http::SharedBuffer::Pointer();
-            }
-        }
-
-        const uint64_t max_buffer_size = 1024 * 8;
-        const uint64_t remaining_bytes = end_byte_ - current_read_pos_;
-
-        if (remaining_bytes == 0)
-        {
-            // Done
-            return mf::http::SharedBuffer::Pointer();
-        }
-
-        const uint64_t buffer_size = std::min(max_buffer_size, remaining_bytes);
-
-        auto buffer = mf::http::SharedBuffer::Create(buffer_size);
-        assert(buffer->Size() == buffer_size);
-
-        std::error_code ec;
-        const auto bytes_read = file_->Read(buffer->Data(), buffer_size, &ec);
-
-        if (ec)
-        {
-            /** @todo hjones: Emit error */
-            return mf::http::SharedBuffer::Pointer();
-        }
-
-        if (bytes_read != buffer_size)
-        {
-            /** @todo hjones: Emit error */
-            return mf::http::SharedBuffer::Pointer();
-        }
-
-        current_read_pos_ += bytes_read;
-
-        assert(current_read_pos_ <= end_byte_);
-        return buffer;
-    }
-
-private:
-    mf::utils::FileIO::Pointer file_;
-
-    const uint64_t start_byte_;
-    const uint64_t end_byte_;
-    uint64_t current_read_pos_;
-
-    mf::http::SharedBuffer::Pointer buffer_;
-};
-
 template <typename FSM>
 void HandleUploadResponse(FSM & fsm,
                           const std::string & url,
@@ -298,12 +241,12 @@ struct DoSimpleUpload
 
         // Add data to send as POST.
         auto pipe = std::make_shared<UploadPostDataPipe>(file_io, 0,
-                                                         fsm.filesize());
+            fsm.filesize(), fsm.PostBufferPool(), fsm.ReadAheadIoService());
         auto url = BuildUrl(fsm);
 
         auto fsmp = fsm.AsFrontShared();
         auto request = mf::http::HttpRequest::Create(
-                fsm.GetSessionMaintainer()->HttpConfig(),
+                fsm.UploadHttpConfig(),
                 [fsmp, url](mf::http::HttpRequest::CallbackResponse response)
                 {
                     if (response.error_code)
@@ -358,6 +301,14 @@ void HandleChunkResponse(uint32_t chunk_id,
                     std::error_code(error, upload_response_category()),
                     "Upload rejected"});
         }
+        else if (IsTransientUnitError(response.error_code,
+                                      headers.status_code))
+        {
+            fsm.ProcessEvent(event::ChunkFailure{
+                    chunk_id, response.error_code,
+                    (response.error_string ? *response.error_string
+                                           : "Upload rejected")});
+        }
         else
         {
             // Upload has unique negative values.
@@ -374,7 +325,23 @@ void HandleChunkResponse(uint32_t chunk_id,
         if (mf::api::GetIfExists(response.pt, "response.doupload.key",
                                  &upload_key))
         {
-            fsm.ProcessEvent(event::ChunkSuccess{chunk_id, upload_key});
+            // The server reports every unit it has, which includes units
+            // sent by other requests in flight.
+            std::vector<uint16_t> bitmap;
+            const auto words = response.pt.get_child_optional(
+                    L"response.resumable_upload.bitmap.words");
+            if (words)
+            {
+                for (const auto & it : *words)
+                {
+                    uint16_t word;
+                    if (mf::api::GetValueIfExists(it.second, &word))
+                        bitmap.push_back(word);
+                }
+            }
+
+            fsm.ProcessEvent(
+                    event::ChunkSuccess{chunk_id, upload_key, bitmap});
         }
         else
         {
@@ -396,26 +363,76 @@ void HandleChunkResponse(uint32_t chunk_id,
     }
 }
 
+/**
+ * @brief Start units until as many are in flight as permitted, then complete
+ * the upload once the last unit has landed.
+ *
+ * @param[in] send_unit Starts sending the unit with the id passed, and returns
+ *                      false if the upload failed instead.
+ */
+template <typename FSM, typename SendUnit>
+void KeepUnitsInFlight(FSM & fsm, SendUnit send_unit)
+{
+    while (fsm.ChunksInFlight() < fsm.MaxConcurrentUnits())
+    {
+        const boost::optional<uint32_t> next_chunk = fsm.NextChunkToUpload();
+        if (!next_chunk)
+            break;
+
+        if (!send_unit(*next_chunk))
+            return;
+    }
+
+    // Only complete once the last unit in flight has landed and no failed
+    // units are waiting to be sent again.
+    if (fsm.ChunksInFlight() == 0 && fsm.ChunksWaitingToRetry() == 0)
+    {
+        // Should only get here after getting upload key from previous
+        // iterations.
+        assert(!fsm.UploadKey().empty());
+        fsm.ProcessEvent(event::ChunkUploadComplete{fsm.UploadKey()});
+    }
+}
+
 struct DoChunkUpload
 {
+    template <typename FSM, typename SourceState, typename TargetState>
+    void operator()(event::ChunkSuccess const & evt,
+                    FSM & fsm,
+                    SourceState &,
+                    TargetState &)
+    {
+        fsm.ChunkUploaded(evt);
+        UploadChunks(fsm);
+    }
+
+    template <typename FSM, typename SourceState, typename TargetState>
+    void operator()(event::ChunkRetryDue const & evt,
+                    FSM & fsm,
+                    SourceState &,
+                    TargetState &)
+    {
+        fsm.ChunkRetryDue(evt.chunk_id);
+        UploadChunks(fsm);
+    }
+
     template <typename Event,
               typename FSM,
               typename SourceState,
               typename TargetState>
     void operator()(Event const &, FSM & fsm, SourceState &, TargetState &)
     {
-        const boost::optional<uint32_t> next_chunk = fsm.NextChunkToUpload();
-        if (next_chunk)
-        {
-            UploadNextChunk(*next_chunk, fsm);
-        }
-        else
-        {
-            // Should only get here after getting upload key from previous
-            // iterations.
-            assert(!fsm.UploadKey().empty());
-            fsm.ProcessEvent(event::ChunkUploadComplete{fsm.UploadKey()});
-        }
+        UploadChunks(fsm);
+    }
+
+    template <typename FSM>
+    void UploadChunks(FSM & fsm)
+    {
+        KeepUnitsInFlight(fsm,
+                [this, &fsm](uint32_t chunk_id)
+                {
+                    return UploadNextChunk(chunk_id, fsm);
+                });
     }
 
     template <typename FSM>
@@ -502,14 +519,14 @@ struct DoChunkUpload
     }
 
     template <typename FSM>
-    void UploadNextChunk(const uint32_t chunk_id, FSM & fsm)
+    bool UploadNextChunk(const uint32_t chunk_id, FSM & fsm)
     {
         auto ec = std::error_code();
         auto file_io = mf::utils::FileIO::Open(fsm.Path(), "rb", &ec);
         if (ec)
         {
             fsm.ProcessEvent(event::Error{ec, "Unable to open file."});
-            return;
+            return false;
         }
 
         int begin, end;
@@ -522,20 +539,29 @@ struct DoChunkUpload
         if (ec)
         {
             fsm.ProcessEvent(event::Error{ec, "Seek file failed."});
-            return;
+            return false;
         }
 
         // Add data to send as POST.
-        auto pipe = std::make_shared<UploadPostDataPipe>(file_io, begin, end);
+        auto pipe = std::make_shared<UploadPostDataPipe>(file_io, begin, end,
+            fsm.PostBufferPool(), fsm.ReadAheadIoService());
         auto url = BuildUrl(chunk_id, fsm);
 
         auto fsmp = fsm.AsFrontShared();
         auto request = mf::http::HttpRequest::Create(
-                fsm.GetSessionMaintainer()->HttpConfig(),
+                fsm.UploadHttpConfig(),
                 [fsmp, chunk_id, url](
                         mf::http::HttpRequest::CallbackResponse response)
                 {
-                    if (response.error_code)
+                    if (response.error_code
+                        && IsTransientUnitError(response.error_code, 0))
+                    {
+                        fsmp->ProcessEvent(event::ChunkFailure{
+                                chunk_id, response.error_code,
+                                (response.error_text ? *response.error_text
+                                                     : "Unknown error")});
+                    }
+                    else if (response.error_code)
                     {
                         if (response.error_text)
                         {
@@ -564,7 +590,49 @@ struct DoChunkUpload
 
         request->Start();
 
-        fsm.SetUploadRequest(request);
+        fsm.AddChunkRequest(chunk_id, request);
+
+        return true;
+    }
+};
+
+/**
+ * Send a failed unit again after a delay, while the other units keep going.
+ * The upload fails once the unit or the upload runs out of retries.
+ */
+struct RetryChunk
+{
+    template <typename FSM, typename SourceState, typename TargetState>
+    void operator()(event::ChunkFailure const & evt,
+                    FSM & fsm,
+                    SourceState &,
+                    TargetState &)
+    {
+        const uint32_t failures = fsm.ChunkFailed(evt.chunk_id);
+
+        if (failures > max_unit_retries
+            || fsm.UnitRetries() > max_upload_retries)
+        {
+            fsm.ProcessEvent(event::Error{evt.error_code, evt.description});
+            return;
+        }
+
+        auto timer = fsm.AddChunkRetryTimer(evt.chunk_id);
+        timer->expires_from_now(UnitRetryDelay(failures));
+
+        const uint32_t chunk_id = evt.chunk_id;
+        auto fsmp = fsm.AsFrontShared();
+        timer->async_wait(
+                [fsmp, chunk_id](const boost::system::error_code & ec)
+                {
+                    if (ec != boost::asio::error::operation_aborted)
+                        fsmp->ProcessEvent(event::ChunkRetryDue{chunk_id});
+                });
+
+        fsm.SendStatus(upload_state::Uploading{});
+
+        // The slot of the failed unit can go to another.
+        DoChunkUpload().UploadChunks(fsm);
     }
 };
 
@@ -31,6 +31,20 @@ struct SaveHash
     }
 };
 
+struct SaveCachedHash
+{
+    template <typename FSM, typename SourceState, typename TargetState>
+    void operator()(
+            event::HashFromCache const & evt,
+            FSM & fsm,
+            SourceState&,
+            TargetState&
+        )
+    {
+        fsm.SetCompleteHashData(evt.hashes);
+    }
+};
+
 }  // namespace upload_transition
 }  // namespace detail
 }  // namespace uploader
@@ -21,6 +21,7 @@ enum class ChunkState
 {
     NeedsUpload,
     Uploading,
+    RetryPending,
     Uploaded
 };
 
@@ -7,11 +7,14 @@
 #pragma once
 
 #include <system_error>
+#include <vector>
 
 #include "boost/asio/io_service.hpp"
 #include "boost/filesystem/path.hpp"
 #include "boost/date_time/posix_time/ptime.hpp"
 
+#include "mediafire_sdk/uploader/hasher.hpp"
+
 namespace mf {
 namespace uploader {
 namespace detail {
@@ -27,7 +30,20 @@ struct Start {};
 struct Restart {};
 
 // Control
-struct StartHash {};
+struct StartHash
+{
+    /** Threads to hash on, or null to hash on the work io_service. */
+    boost::asio::io_service * hash_io_service;
+
+    /** Threads hashing the units of a file in parallel, or 0. */
+    uint32_t unit_hash_threads;
+};
+/** Hashes of an unchanged file found in the hash cache. */
+struct HashFromCache
+{
+    FileHashes hashes;
+};
+
 struct StartUpload
 {
     std::string upload_action_token;
@@ -57,6 +73,21 @@ struct ChunkSuccess
 {
     uint32_t chunk_id;
     std::string upload_key;
+
+    /** Units the server has received, empty if not sent. */
+    std::vector<uint16_t> bitmap;
+};
+/** A unit failed in a way that may succeed if sent again. */
+struct ChunkFailure
+{
+    uint32_t chunk_id;
+    std::error_code error_code;
+    std::string description;
+};
+/** The backoff of a failed unit has passed. */
+struct ChunkRetryDue
+{
+    uint32_t chunk_id;
 };
 struct SimpleUploadComplete
 {
@@ -21,6 +21,16 @@ const std::chrono::seconds kActionTokenRetry(15);
 // before it expires.
 const std::chrono::minutes kActionTokenLife(1440/4*3);
 
+// How often upload throughput is measured in adaptive mode.
+const std::chrono::seconds kAdaptiveSampleInterval(5);
+
+// Size of the buffers holding file data for upload requests, and how many
+// unused ones are kept.
+const uint32_t kDefaultUploadBufferSize = 64 * 1024;
+const uint32_t kMinUploadBufferSize = 4 * 1024;
+const uint32_t kMaxUploadBufferSize = 1024 * 1024;
+const std::size_t kMaxIdleUploadBuffers = 16;
+
 mf::uploader::detail::UploadHandle NextUploadHandle()
 {
     static mf::uploader::detail::UploadHandle upload_handle = {0};
@@ -43,10 +53,16 @@ UploadManagerImpl::UploadManagerImpl(
     io_service_(session_maintainer->HttpConfig()->GetWorkIoService()),
     action_token_state_(ActionTokenState::Invalid),
     action_token_retry_timer_(*io_service_),
-    max_concurrent_hashings_(2),
-    max_concurrent_uploads_(2),
-    current_hashings_(0),
-    current_uploads_(0),
+    hashings_(2),
+    hashing_threads_(2),
+    unit_hashing_threads_(0),
+    uploads_(2),
+    max_concurrent_units_per_upload_(1),
+    adaptive_uploads_(false),
+    adaptive_timer_running_(false),
+    adaptive_timer_(*io_service_),
+    post_buffer_pool_(mf::http::SharedBufferPool::Create(
+            kDefaultUploadBufferSize, kMaxIdleUploadBuffers)),
     disable_enqueue_(false)
 {
 }
@@ -91,6 +107,19 @@ UploadHandle UploadManagerImpl::Add(
     config.cloud_file_name = upload_request.utf8_target_name_;
     config.target_folder = upload_request.upload_target_folder_;
 
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        config.max_concurrent_units = upload_request.max_concurrent_units_
+            ? *upload_request.max_concurrent_units_
+            : max_concurrent_units_per_upload_;
+        config.upload_http_config = upload_http_config_;
+        config.post_buffer_pool = post_buffer_pool_;
+
+        if ( ! read_ahead_thread_ )
+            read_ahead_thread_ = HashThreadPool::Create(1);
+        config.read_ahead_thread = read_ahead_thread_;
+    }
+
     auto request = std::make_shared<UploadStateMachine>(std::move(config));
 
     {
@@ -163,6 +192,198 @@ void UploadManagerImpl::ModifyUpload(
     boost::apply_visitor(Visitor(this, upload_handle), upload_modification);
 }
 
+void UploadManagerImpl::SetMaxConcurrentUnitsPerUpload(uint32_t max_units)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    max_concurrent_units_per_upload_ = std::max<uint32_t>(1, max_units);
+}
+
+void UploadManagerImpl::SetMaxConcurrentHashings(uint32_t max_hashings)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        hashings_.SetLimit(max_hashings);
+    }
+
+    EnqueueTick();
+}
+
+uint32_t UploadManagerImpl::GetMaxConcurrentHashings()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return hashings_.Limit();
+}
+
+void UploadManagerImpl::SetHashingThreads(uint32_t threads)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        hashing_threads_ = threads;
+    }
+
+    EnqueueTick();
+}
+
+uint32_t UploadManagerImpl::GetHashingThreads()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return hashing_threads_;
+}
+
+void UploadManagerImpl::SetUnitHashingThreads(uint32_t threads)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    unit_hashing_threads_ = threads;
+}
+
+uint32_t UploadManagerImpl::GetUnitHashingThreads()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return unit_hashing_threads_;
+}
+
+void UploadManagerImpl::SetHashCache(HashCache::Pointer hash_cache)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    hash_cache_ = hash_cache;
+}
+
+void UploadManagerImpl::SetMaxConcurrentUploads(uint32_t max_uploads)
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (adaptive_uploads_)
+            max_uploads = adaptive_.Clamp(max_uploads);
+
+        uploads_.SetLimit(max_uploads);
+    }
+
+    EnqueueTick();
+}
+
+uint32_t UploadManagerImpl::GetMaxConcurrentUploads()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return uploads_.Limit();
+}
+
+void UploadManagerImpl::EnableAdaptiveUploadConcurrency(
+        uint32_t min_uploads,
+        uint32_t max_uploads
+    )
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+        adaptive_.SetRange(min_uploads, max_uploads);
+
+        if ( ! throughput_monitor_ )
+        {
+            // Upload requests get their own configuration so only their
+            // traffic is measured.  Records still reach the analyser set by the
+            // user.
+            auto session_config = session_maintainer_->HttpConfig();
+
+            throughput_monitor_ = std::make_shared<ThroughputMonitor>(
+                session_config->GetBandwidthAnalyser());
+
+            auto http_config = session_config->Clone();
+            http_config->SetBandwidthAnalyser(throughput_monitor_);
+            upload_http_config_ = http_config;
+        }
+
+        adaptive_uploads_ = true;
+        uploads_.SetLimit(adaptive_.Clamp(uploads_.Limit()));
+
+        if (uploads_.Running() > 0 && ! adaptive_timer_running_)
+            ScheduleAdaptiveSample();
+    }
+
+    EnqueueTick();
+}
+
+void UploadManagerImpl::DisableAdaptiveUploadConcurrency()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    adaptive_uploads_ = false;
+    adaptive_timer_running_ = false;
+    adaptive_timer_.cancel();
+}
+
+void UploadManagerImpl::SetUploadBufferSize(uint32_t bytes)
+{
+    bytes = std::min(std::max(bytes, kMinUploadBufferSize),
+        kMaxUploadBufferSize);
+
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    // Uploads already added keep using the previous pool.
+    if (bytes != post_buffer_pool_->BufferSize())
+    {
+        post_buffer_pool_ = mf::http::SharedBufferPool::Create(bytes,
+            kMaxIdleUploadBuffers);
+    }
+}
+
+uint32_t UploadManagerImpl::GetUploadBufferSize()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+    return static_cast<uint32_t>(post_buffer_pool_->BufferSize());
+}
+
+void UploadManagerImpl::ScheduleAdaptiveSample()
+{
+    // Must be called with the mutex held.
+    adaptive_timer_running_ = true;
+
+    // Discard bytes sent while no sample was being taken.
+    throughput_monitor_->TakeOutgoingBytes();
+
+    std::weak_ptr<UploadManagerImpl> weak_self = shared_from_this();
+
+    adaptive_timer_.expires_from_now(kAdaptiveSampleInterval);
+    adaptive_timer_.async_wait(
+        [weak_self](const boost::system::error_code & err)
+        {
+            // The timer must not keep the manager alive.
+            if (auto self = weak_self.lock())
+                self->HandleAdaptiveSample(err);
+        });
+}
+
+void UploadManagerImpl::HandleAdaptiveSample(
+        const boost::system::error_code & err
+    )
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    if (err || ! adaptive_uploads_ || ! adaptive_timer_running_)
+        return;
+
+    adaptive_timer_running_ = false;
+
+    if (uploads_.Running() == 0)
+    {
+        // Idle, so measure anew once uploads resume.
+        adaptive_.Reset();
+        return;
+    }
+
+    const uint64_t rate = throughput_monitor_->TakeOutgoingBytes()
+        / kAdaptiveSampleInterval.count();
+
+    uploads_.SetLimit(adaptive_.Sample(uploads_.Limit(), rate,
+        ! to_upload_.empty()));
+
+    ScheduleAdaptiveSample();
+
+    // Unlock before calling external
+    lock.unlock();
+
+    EnqueueTick();
+}
+
 void UploadManagerImpl::Tick()
 {
     Tick_StartUploads();
@@ -185,21 +406,37 @@ void UploadManagerImpl::Tick_StartHashings()
 {
     mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
 
-    while ( ! to_hash_.empty() && (current_hashings_ +
-            enqueued_to_start_hashings_.size()) < max_concurrent_hashings_ )
+    // The hashing threads can only be replaced while nothing is using them.
+    if ( hash_thread_pool_ && hashings_.Running() == 0
+        && hashings_.StartingCount() == 0
+        && hash_thread_pool_->ThreadCount() != hashing_threads_ )
+    {
+        hash_thread_pool_.reset();
+    }
+
+    while ( ! to_hash_.empty() && hashings_.CanStartMore() )
     {
         auto request = to_hash_.front();
         to_hash_.pop_front();
 
-        enqueued_to_start_hashings_.insert(request.get());
+        hashings_.Starting(request.get());
+
+        if ( ! hash_thread_pool_ && hashing_threads_ > 0 )
+            hash_thread_pool_ = HashThreadPool::Create(hashing_threads_);
+
+        boost::asio::io_service * hash_io_service = hash_thread_pool_
+            ? hash_thread_pool_->IoService() : nullptr;
+
+        const event::StartHash start_event{hash_io_service,
+            unit_hashing_threads_};
 
         auto self = shared_from_this();
 
         // Enqueue start
         io_service_->post(
-            [this, self, request]()
+            [this, self, request, start_event]()
             {
-                request->process_event(event::StartHash{});
+                request->process_event(start_event);
             });
     }
 }
@@ -215,14 +452,6 @@ void UploadManagerImpl::Tick_StartUploads()
     recursing = true;
 #endif
 
-    auto CanUploadMore = [this]()
-    {
-        auto size = current_uploads_ + enqueued_to_start_uploads_.size();
-        auto result = ( size < max_concurrent_uploads_ );
-
-        return result;
-    };
-
     if ( ! to_upload_.empty() )
     {
         const auto now = sclock::now();
@@ -254,14 +483,14 @@ void UploadManagerImpl::Tick_StartUploads()
             }
             // If retrieving or error and not reached retry timeout, skip.
         }
-        else if ( CanUploadMore() )
+        else if ( uploads_.CanStartMore() )
         {
             assert( ! action_token_.empty() );
 
             const auto token = action_token_;
 
             for (auto it = to_upload_.begin();
-                it != to_upload_.end() && CanUploadMore();)
+                it != to_upload_.end() && uploads_.CanStartMore();)
             {
                 // Skip duplicate hashes
                 auto request = *it;
@@ -273,7 +502,7 @@ void UploadManagerImpl::Tick_StartUploads()
 
                     uploading_hashes_.insert(request->hash());
 
-                    enqueued_to_start_uploads_.insert(request.get());
+                    uploads_.Starting(request.get());
 
                     auto self = shared_from_this();
                     io_service_->post(
@@ -281,9 +510,6 @@ void UploadManagerImpl::Tick_StartUploads()
                         {
                             request->process_event(event::StartUpload{token});
                         });
-
-                    // Only do one
-                    break;
                 }
                 else
                 {
@@ -360,6 +586,26 @@ void UploadManagerImpl::HandleAddToHash(StateMachinePointer request)
 {
     mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
 
+    if (hash_cache_)
+    {
+        auto hashes = hash_cache_->Lookup(request->Path(), request->filesize(),
+            request->mtime());
+
+        if (hashes)
+        {
+            // Unchanged since last hashed, so skip hashing.
+            const event::HashFromCache evt{std::move(*hashes)};
+            auto self = shared_from_this();
+
+            io_service_->post(
+                [this, self, request, evt]()
+                {
+                    request->process_event(evt);
+                });
+            return;
+        }
+    }
+
     to_hash_.push_back(request);
 
     // Unlock before calling external
@@ -387,9 +633,26 @@ void UploadManagerImpl::HandleAddToUpload(StateMachinePointer request)
 
     to_upload_.push_back(request);
 
+    auto hash_cache = hash_cache_;
+
     // Unlock before calling external
     lock.unlock();
 
+    if (hash_cache)
+    {
+        const auto chunk_data = request->GetChunkData();
+
+        FileHashes hashes;
+        hashes.path = request->Path();
+        hashes.file_size = request->filesize();
+        hashes.mtime = request->mtime();
+        hashes.hash = chunk_data.hash;
+        hashes.chunk_ranges = chunk_data.chunk_ranges;
+        hashes.chunk_hashes = chunk_data.chunk_hashes;
+
+        hash_cache->Store(hashes);
+    }
+
     EnqueueTick();
 }
 void UploadManagerImpl::HandleRemoveToUpload(StateMachinePointer request)
@@ -412,8 +675,8 @@ void UploadManagerImpl::HandleComplete(StateMachinePointer request)
     mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
 
     // Clear 
-    enqueued_to_start_hashings_.erase(request.get());
-    enqueued_to_start_uploads_.erase(request.get());
+    hashings_.Abandoned(request.get());
+    uploads_.Abandoned(request.get());
 
     requests_.erase(request);
 
@@ -434,8 +697,7 @@ void UploadManagerImpl::HandleComplete(StateMachinePointer request)
 void UploadManagerImpl::IncrementHashingCount(StateMachinePointer request)
 {
     mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
-    ++current_hashings_;
-    enqueued_to_start_hashings_.erase(request.get());
+    hashings_.Started(request.get());
 }
 
 void UploadManagerImpl::DecrementHashingCount(StateMachinePointer)
@@ -443,14 +705,16 @@ void UploadManagerImpl::DecrementHashingCount(StateMachinePointer)
     EnqueueTick();
 
     mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
-    --current_hashings_;
+    hashings_.Stopped();
 }
 
 void UploadManagerImpl::IncrementUploadingCount(StateMachinePointer request)
 {
     mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
-    ++current_uploads_;
-    enqueued_to_start_uploads_.erase(request.get());
+    uploads_.Started(request.get());
+
+    if (adaptive_uploads_ && ! adaptive_timer_running_)
+        ScheduleAdaptiveSample();
 }
 
 void UploadManagerImpl::DecrementUploadingCount(StateMachinePointer)
@@ -458,7 +722,7 @@ void UploadManagerImpl::DecrementUploadingCount(StateMachinePointer)
     EnqueueTick();
 
     mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
-    --current_uploads_;
+    uploads_.Stopped();
 }
 
 // -- END UploadStateMachineCallbackInterface ----------------------------------
@@ -13,10 +13,15 @@
 #include <string>
 #include <deque>
 
+#include "../hash_cache.hpp"
 #include "../upload_modification.hpp"
 #include "../upload_request.hpp"
 #include "../upload_status.hpp"
 
+#include "adaptive_concurrency.hpp"
+#include "concurrency_limit.hpp"
+#include "hash_thread_pool.hpp"
+#include "throughput_monitor.hpp"
 #include "upload_state_machine.hpp"
 
 #include "mediafire_sdk/api/user/get_action_token.hpp"
@@ -56,6 +61,31 @@ public:
             ::mf::uploader::UploadModification modification
         );
 
+    void SetMaxConcurrentUnitsPerUpload(uint32_t max_units);
+
+    void SetMaxConcurrentHashings(uint32_t max_hashings);
+    uint32_t GetMaxConcurrentHashings();
+
+    void SetHashingThreads(uint32_t threads);
+    uint32_t GetHashingThreads();
+
+    void SetUnitHashingThreads(uint32_t threads);
+    uint32_t GetUnitHashingThreads();
+
+    void SetHashCache(HashCache::Pointer hash_cache);
+
+    void SetMaxConcurrentUploads(uint32_t max_uploads);
+    uint32_t GetMaxConcurrentUploads();
+
+    void EnableAdaptiveUploadConcurrency(
+            uint32_t min_uploads,
+            uint32_t max_uploads
+        );
+    void DisableAdaptiveUploadConcurrency();
+
+    void SetUploadBufferSize(uint32_t bytes);
+    uint32_t GetUploadBufferSize();
+
 private:
     ::mf::api::SessionMaintainer * session_maintainer_;
     boost::asio::io_service * io_service_;
@@ -82,13 +112,30 @@ private:
             const boost::system::error_code & err
         );
 
-    uint32_t max_concurrent_hashings_;
-    uint32_t max_concurrent_uploads_;
-
-    std::set<UploadStateMachine*> enqueued_to_start_hashings_;
-    std::set<UploadStateMachine*> enqueued_to_start_uploads_;
-    uint32_t current_hashings_;
-    uint32_t current_uploads_;
+    ConcurrencyLimit<UploadStateMachine*> hashings_;
+    uint32_t hashing_threads_;
+    uint32_t unit_hashing_threads_;
+    HashCache::Pointer hash_cache_;
+    std::shared_ptr<HashThreadPool> hash_thread_pool_;
+    ConcurrencyLimit<UploadStateMachine*> uploads_;
+    uint32_t max_concurrent_units_per_upload_;
+
+    // Adaptive upload concurrency
+    bool adaptive_uploads_;
+    AdaptiveConcurrency adaptive_;
+    bool adaptive_timer_running_;
+    std::shared_ptr<ThroughputMonitor> throughput_monitor_;
+    mf::http::HttpConfig::ConstPointer upload_http_config_;
+    boost::asio::steady_timer adaptive_timer_;
+
+    void ScheduleAdaptiveSample();
+    void HandleAdaptiveSample(const boost::system::error_code & err);
+
+    mf::http::SharedBufferPool::Pointer post_buffer_pool_;
+
+    // One thread reads the file data of every upload, so the reads do not
+    // contend for the disk.
+    std::shared_ptr<HashThreadPool> read_ahead_thread_;
 
     bool disable_enqueue_;
 
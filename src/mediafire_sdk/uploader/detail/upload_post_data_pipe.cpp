@@ -0,0 +1,167 @@
+/**
+ * @file upload_post_data_pipe.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "upload_post_data_pipe.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+UploadPostDataPipe::UploadPostDataPipe(
+        mf::utils::FileIO::Pointer file,
+        const uint64_t start_byte,
+        const uint64_t end_byte,
+        mf::http::SharedBufferPool::Pointer buffer_pool,
+        boost::asio::io_service * read_ahead_io_service
+    ) :
+    file_(file),
+    start_byte_(start_byte),
+    end_byte_(end_byte),
+    current_read_pos_(start_byte_),
+    buffer_pool_(buffer_pool),
+    read_ahead_io_service_(read_ahead_io_service),
+    read_ahead_state_(ReadAhead::None)
+{
+    assert(file_);
+
+    // Range should be correct and never empty
+    assert(PostDataSize() > 0);
+    assert(start_byte < end_byte);
+}
+
+mf::http::SharedBuffer::Pointer UploadPostDataPipe::RetreivePostDataChunk()
+{
+    mf::utils::unique_lock<mf::utils::mutex> lock(mutex_);
+
+    // A read ahead that has started is running on another thread, so waiting
+    // for it can not block the thread it needs.
+    while (read_ahead_state_ == ReadAhead::Reading)
+        read_ahead_done_.wait(lock);
+
+    mf::http::SharedBuffer::Pointer buffer;
+
+    if (read_ahead_state_ == ReadAhead::Ready)
+    {
+        buffer = std::move(read_ahead_buffer_);
+        read_ahead_buffer_.reset();
+        read_ahead_state_ = ReadAhead::None;
+    }
+    else
+    {
+        // A queued read ahead that has not started yet is taken over here.
+        read_ahead_state_ = ReadAhead::None;
+
+        lock.unlock();
+        buffer = ReadChunk();
+        lock.lock();
+    }
+
+    if (buffer && read_ahead_io_service_ && current_read_pos_ < end_byte_)
+    {
+        read_ahead_state_ = ReadAhead::Queued;
+
+        std::weak_ptr<UploadPostDataPipe> weak_self = shared_from_this();
+        read_ahead_io_service_->post(
+            [weak_self]()
+            {
+                if (auto self = weak_self.lock())
+                    self->HandleReadAhead();
+            });
+    }
+
+    return buffer;
+}
+
+bool UploadPostDataPipe::PostDataFile(
+        int * file_descriptor,
+        uint64_t * offset
+    )
+{
+    *file_descriptor = file_->FileDescriptor();
+    *offset = start_byte_;
+    return *file_descriptor >= 0;
+}
+
+void UploadPostDataPipe::HandleReadAhead()
+{
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        if (read_ahead_state_ != ReadAhead::Queued)
+            return;
+        read_ahead_state_ = ReadAhead::Reading;
+    }
+
+    auto buffer = ReadChunk();
+
+    {
+        mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+        read_ahead_buffer_ = std::move(buffer);
+        read_ahead_state_ = ReadAhead::Ready;
+    }
+
+    read_ahead_done_.notify_all();
+}
+
+mf::http::SharedBuffer::Pointer UploadPostDataPipe::ReadChunk()
+{
+    assert(file_->Tell() == current_read_pos_);
+
+    if (file_->Tell() != current_read_pos_)
+    {
+        std::error_code ec;
+        file_->Seek(mf::utils::SeekAnchor::Beginning, current_read_pos_,
+                    &ec);
+
+        if (ec)
+        {
+            /** @todo hjones: Emit error */
+            return mf::http::SharedBuffer::Pointer();
+        }
+    }
+
+    const uint64_t max_buffer_size = buffer_pool_
+        ? buffer_pool_->BufferSize() : kDefaultPostChunkSize;
+    const uint64_t remaining_bytes = end_byte_ - current_read_pos_;
+
+    if (remaining_bytes == 0)
+    {
+        // Done
+        return mf::http::SharedBuffer::Pointer();
+    }
+
+    const uint64_t buffer_size = std::min(max_buffer_size, remaining_bytes);
+
+    auto buffer = buffer_pool_
+        ? buffer_pool_->Acquire(buffer_size)
+        : mf::http::SharedBuffer::Create(buffer_size);
+    assert(buffer->Size() == buffer_size);
+
+    std::error_code ec;
+    const auto bytes_read = file_->Read(buffer->Data(), buffer_size, &ec);
+
+    if (ec)
+    {
+        /** @todo hjones: Emit error */
+        return mf::http::SharedBuffer::Pointer();
+    }
+
+    if (bytes_read != buffer_size)
+    {
+        /** @todo hjones: Emit error */
+        return mf::http::SharedBuffer::Pointer();
+    }
+
+    current_read_pos_ += bytes_read;
+
+    assert(current_read_pos_ <= end_byte_);
+    return buffer;
+}
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
@@ -0,0 +1,89 @@
+/**
+ * @file upload_post_data_pipe.hpp
+ * @author Herbert Jones
+ * @brief Supplies a range of a file as POST data.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+#include "mediafire_sdk/http/post_data_pipe_interface.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+#include "mediafire_sdk/utils/fileio.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace uploader {
+namespace detail {
+
+/** Chunk size used when the pipe has no buffer pool. */
+const uint64_t kDefaultPostChunkSize = 1024 * 8;
+
+/**
+ * @class UploadPostDataPipe
+ * @brief Reads the bytes [start_byte, end_byte) of a file for an HttpRequest.
+ *
+ * With a buffer pool, chunks are the pool's buffer size and their storage is
+ * reused.  With a read ahead io_service, the next chunk is read there while the
+ * previous one is being written to the socket.  Where the request can use
+ * sendfile, the file is handed over instead and no chunks are read.
+ */
+class UploadPostDataPipe :
+    public mf::http::PostDataPipeInterface,
+    public std::enable_shared_from_this<UploadPostDataPipe>
+{
+public:
+    UploadPostDataPipe(
+            mf::utils::FileIO::Pointer file,
+            const uint64_t start_byte,
+            const uint64_t end_byte,
+            mf::http::SharedBufferPool::Pointer buffer_pool = nullptr,
+            boost::asio::io_service * read_ahead_io_service = nullptr
+        );
+
+    virtual uint64_t PostDataSize() const override
+    {
+        return end_byte_ - start_byte_;
+    }
+
+    virtual mf::http::SharedBuffer::Pointer RetreivePostDataChunk() override;
+
+    virtual bool PostDataFile(
+            int * file_descriptor,
+            uint64_t * offset
+        ) override;
+
+private:
+    mf::http::SharedBuffer::Pointer ReadChunk();
+    void HandleReadAhead();
+
+    mf::utils::FileIO::Pointer file_;
+
+    const uint64_t start_byte_;
+    const uint64_t end_byte_;
+    uint64_t current_read_pos_;
+
+    mf::http::SharedBufferPool::Pointer buffer_pool_;
+    boost::asio::io_service * read_ahead_io_service_;
+
+    enum class ReadAhead
+    {
+        None,
+        Queued,
+        Reading,
+        Ready
+    } read_ahead_state_;
+    mf::http::SharedBuffer::Pointer read_ahead_buffer_;
+
+    mf::utils::mutex mutex_;
+    boost::condition_variable_any read_ahead_done_;
+};
+
+}  // namespace detail
+}  // namespace uploader
+}  // namespace mf
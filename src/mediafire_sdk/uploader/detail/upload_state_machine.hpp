@@ -6,6 +6,8 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <random>
 #include <vector>
@@ -13,6 +15,7 @@
 #include "upload_events.hpp"
 
 #include "mediafire_sdk/http/bandwidth_analyser_interface.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
 
 #include "boost/msm/back/state_machine.hpp"
 #include "boost/msm/front/state_machine_def.hpp"
@@ -27,6 +30,7 @@
 #include "mediafire_sdk/api/session_maintainer.hpp"
 #include "mediafire_sdk/uploader/upload_status.hpp"
 
+#include "mediafire_sdk/uploader/detail/hash_thread_pool.hpp"
 #include "mediafire_sdk/uploader/detail/hasher_events.hpp"
 #include "mediafire_sdk/uploader/detail/hasher_transitions.hpp"
 #include "mediafire_sdk/uploader/detail/stepping.hpp"
@@ -76,6 +80,16 @@ struct UploadConfig
     StatusCallback status_callback;
     boost::optional<std::string> cloud_file_name;
     boost::optional<UploadTarget> target_folder;
+    uint32_t max_concurrent_units;
+
+    /** Configuration for the upload requests themselves, may be null. */
+    mf::http::HttpConfig::ConstPointer upload_http_config;
+
+    /** Storage for the file data sent by upload requests, may be null. */
+    mf::http::SharedBufferPool::Pointer post_buffer_pool;
+
+    /** Thread reading file data ahead of upload requests, may be null. */
+    HashThreadPool::Pointer read_ahead_thread;
 };
 
 struct ChunkData
@@ -154,6 +168,10 @@ public:
         ) :
         session_maintainer_(config.session_maintainer),
         http_config_(session_maintainer_->HttpConfig()),
+        upload_http_config_(config.upload_http_config
+                ? config.upload_http_config : http_config_),
+        post_buffer_pool_(config.post_buffer_pool),
+        read_ahead_thread_(config.read_ahead_thread),
         work_io_service_(http_config_->GetWorkIoService()),
         callback_io_service_(http_config_->GetDefaultCallbackIoService()),
         event_strand_(*http_config_->GetWorkIoService()),
@@ -165,9 +183,12 @@ public:
         status_callback_(config.status_callback),
         cloud_file_name_(config.cloud_file_name),
         target_folder_(config.target_folder),
+        max_concurrent_units_(std::max<uint32_t>(1,
+                config.max_concurrent_units)),
         filesize_(0),
         mtime_(0),
-        count_state_(CountState::None)
+        count_state_(CountState::None),
+        unit_retries_(0)
     {
         assert(work_io_service_);
         assert(callback_io_service_);
@@ -298,13 +319,15 @@ public:
 
     struct SetupHasher : public msm::front::state<>
     {
-        template <typename Event, typename FSM>
-        void on_entry(Event const &, FSM& fsm)
+        template <typename FSM>
+        void on_entry(event::StartHash const & evt, FSM& fsm)
         {
             fsm.SetCountState(CountState::Hashing);
 
             auto state = std::make_shared<he::HasherStateData_>();
             state->io_service = fsm.work_io_service_;
+            state->hash_io_service = evt.hash_io_service;
+            state->unit_hash_threads = evt.unit_hash_threads;
             state->filepath = fsm.filepath_;
 
             state->filesize = fsm.filesize_;
@@ -313,6 +336,8 @@ public:
             state->chunk_ranges = mf::uploader::detail::ChunkRanges(
                 state->filesize);
 
+            fsm.hash_state_ = state;
+
             fsm.ProcessEvent(he::StartHash{std::move(state)});
         }
     };
@@ -328,6 +353,18 @@ public:
         void on_entry(Event const &, FSM&)
         {
         }
+
+        template <typename FSM>
+        void on_exit(he::ReadNext const &, FSM&)
+        {
+        }
+        template <typename Event, typename FSM>
+        void on_exit(Event const &, FSM& fsm)
+        {
+            // Stop any read in progress on the hashing threads.
+            if (fsm.hash_state_)
+                fsm.hash_state_->cancelled = true;
+        }
     };
 
     struct WaitForUploadSignal : public msm::front::state<>
@@ -371,32 +408,17 @@ public:
 
     struct UploadChunk : public msm::front::state<>
     {
-        template <typename FSM>
-        void on_entry(event::ChunkSuccess const & evt, FSM& fsm)
-        {
-            // On chunk success, set the chunk state.
-            assert( fsm.GetChunkState(evt.chunk_id) == ChunkState::Uploading);
-            assert( ! evt.upload_key.empty() );
-
-            if (fsm.upload_key_.empty())
-                fsm.upload_key_ = evt.upload_key;
-            fsm.SetChunkState(evt.chunk_id, ChunkState::Uploaded);
-        }
-
-        template <typename Event, typename FSM>
-        void on_entry(Event const &, FSM&)
-        {
-        }
-
         template <typename Event, typename FSM>
         void on_exit(Event const &, FSM& fsm)
         {
             // On exit, clean up ongoing uploads.
-            if (fsm.upload_request_)
-            {
-                fsm.upload_request_->Cancel();
-                fsm.upload_request_.reset();
-            }
+            for (auto & pair : fsm.chunk_requests_)
+                pair.second->Cancel();
+            fsm.chunk_requests_.clear();
+
+            for (auto & pair : fsm.chunk_retry_timers_)
+                pair.second->cancel();
+            fsm.chunk_retry_timers_.clear();
         }
     };
 
@@ -494,6 +516,7 @@ public:
         Row < Initial             , event::Error                , CompleteWithError   , none                , none               >,
         // ---------------------- , --------------------------- , ------------------- , ------------------  , ------------------
         Row < WaitForHashSignal   , event::StartHash            , SetupHasher         , none                , none               >,
+        Row < WaitForHashSignal   , event::HashFromCache        , WaitForUploadSignal , ut::SaveCachedHash  , none               >,
         Row < WaitForHashSignal   , event::Error                , CompleteWithError   , none                , none               >,
         // ---------------------- , --------------------------- , ------------------- , ------------------  , ------------------
         Row < SetupHasher         , he::StartHash               , Hashing             , ht::OpenFile        , none               >,
@@ -515,7 +538,9 @@ public:
         Row < InstantUpload       , event::InstantSuccess       , CompleteWithSuccess , none                , none               >,
         Row < InstantUpload       , event::Error                , CompleteWithError   , none                , none               >,
         // ---------------------- , --------------------------- , ------------------- , ------------------  , ------------------
-        Row < UploadChunk         , event::ChunkSuccess         , UploadChunk         , ut::DoChunkUpload   , none               >,
+        Row < UploadChunk         , event::ChunkSuccess         , none                , ut::DoChunkUpload   , none               >,
+        Row < UploadChunk         , event::ChunkFailure         , none                , ut::RetryChunk      , none               >,
+        Row < UploadChunk         , event::ChunkRetryDue        , none                , ut::DoChunkUpload   , none               >,
         Row < UploadChunk         , event::ChunkUploadComplete  , PollUpload          , ut::PollUpload      , none               >,
         Row < UploadChunk         , event::Error                , CompleteWithError   , none                , none               >,
         // ---------------------- , --------------------------- , ------------------- , ------------------  , ------------------
@@ -575,12 +600,34 @@ public:
         chunk_hashes_ = hash_data->chunk_hashes;
     }
 
+    void SetCompleteHashData(const FileHashes & hashes)
+    {
+        hash_ = hashes.hash;
+        chunk_ranges_ = hashes.chunk_ranges;
+        chunk_hashes_ = hashes.chunk_hashes;
+    }
+
     ::mf::api::SessionMaintainer * GetSessionMaintainer() const
     {
         assert(session_maintainer_);
         return session_maintainer_;
     }
 
+    mf::http::HttpConfig::ConstPointer UploadHttpConfig() const
+    {
+        return upload_http_config_;
+    }
+
+    mf::http::SharedBufferPool::Pointer PostBufferPool() const
+    {
+        return post_buffer_pool_;
+    }
+
+    asio::io_service * ReadAheadIoService() const
+    {
+        return read_ahead_thread_ ? read_ahead_thread_->IoService() : nullptr;
+    }
+
     std::string hash() const
     {
         assert( ! hash_.empty() );
@@ -648,7 +695,18 @@ public:
         assert(chunk_states_.size() == chunk_ranges_.size());
     }
 
-    // Only updates existing with completed chunks
+    void CancelChunkRetry(uint32_t chunk_id)
+    {
+        auto it = chunk_retry_timers_.find(chunk_id);
+        if (it != chunk_retry_timers_.end())
+        {
+            it->second->cancel();
+            chunk_retry_timers_.erase(it);
+        }
+    }
+
+    // Only updates existing with completed chunks.  Chunks in flight are left
+    // alone as their responses are still expected.
     void UpdateBitmap(const std::vector<uint16_t> & bitmap)
     {
         assert( ! chunk_states_.empty() );
@@ -659,21 +717,43 @@ public:
             uint16_t mask = 1;
             for (int i = 0; i < 16; ++i)
             {
-                assert( pos < chunk_states_.size() );
                 // Stop if we are in the last word and have all the expected
                 // bits.
-                if (pos == chunk_ranges_.size())
-                    break;
+                if (pos == chunk_states_.size())
+                    return;
 
                 if (mask & word && chunk_states_.at(pos) == ChunkState::NeedsUpload)
                     chunk_states_.at(pos) = ChunkState::Uploaded;
 
+                // No need to send again a unit the server has after all.
+                if (mask & word
+                    && chunk_states_.at(pos) == ChunkState::RetryPending)
+                {
+                    chunk_states_.at(pos) = ChunkState::Uploaded;
+                    CancelChunkRetry(pos);
+                }
+
                 mask <<= 1;
                 ++pos;
             }
         }
     }
 
+    void ChunkUploaded(const event::ChunkSuccess & evt)
+    {
+        assert( GetChunkState(evt.chunk_id) == ChunkState::Uploading);
+        assert( ! evt.upload_key.empty() );
+
+        if (upload_key_.empty())
+            upload_key_ = evt.upload_key;
+
+        SetChunkState(evt.chunk_id, ChunkState::Uploaded);
+        chunk_requests_.erase(evt.chunk_id);
+
+        if ( ! evt.bitmap.empty() )
+            UpdateBitmap(evt.bitmap);
+    }
+
     void SetChunkState(uint32_t chunk_id, ChunkState chunk_state)
     {
         assert(chunk_id < chunk_states_.size());
@@ -734,6 +814,54 @@ public:
 
     void SetUploadRequest(mf::http::HttpRequest::Pointer v) {upload_request_=v;}
 
+    void AddChunkRequest(uint32_t chunk_id, mf::http::HttpRequest::Pointer v)
+    {
+        chunk_requests_[chunk_id] = v;
+    }
+
+    std::size_t ChunksInFlight() const {return chunk_requests_.size();}
+
+    /**
+     * @brief Record the failure of a unit, to be sent again later.
+     *
+     * @return Times the unit has failed.
+     */
+    uint32_t ChunkFailed(uint32_t chunk_id)
+    {
+        chunk_requests_.erase(chunk_id);
+        SetChunkState(chunk_id, ChunkState::RetryPending);
+
+        ++unit_retries_;
+        return ++chunk_failures_[chunk_id];
+    }
+
+    /** Timer counting down until the failed unit is sent again. */
+    std::shared_ptr<asio::steady_timer> AddChunkRetryTimer(uint32_t chunk_id)
+    {
+        auto timer = std::make_shared<asio::steady_timer>(*work_io_service_);
+        chunk_retry_timers_[chunk_id] = timer;
+        return timer;
+    }
+
+    /** Make the failed unit available to send again. */
+    void ChunkRetryDue(uint32_t chunk_id)
+    {
+        chunk_retry_timers_.erase(chunk_id);
+
+        // The unit may have been reported as received since.
+        if (GetChunkState(chunk_id) == ChunkState::RetryPending)
+            SetChunkState(chunk_id, ChunkState::NeedsUpload);
+    }
+
+    std::size_t ChunksWaitingToRetry() const
+    {
+        return chunk_retry_timers_.size();
+    }
+
+    uint32_t UnitRetries() const {return unit_retries_;}
+
+    uint32_t MaxConcurrentUnits() const {return max_concurrent_units_;}
+
     std::string ActionToken() const {return action_token_;}
 
     std::string UploadKey() const {return upload_key_;}
@@ -743,7 +871,8 @@ public:
     void SendStatus(const UploadState & state)
     {
         callback_io_service_->dispatch( boost::bind( status_callback_,
-                UploadStatus{ upload_handle_, filepath_, state }));
+                UploadStatus{ upload_handle_, filepath_, state,
+                unit_retries_ }));
     }
 
     ChunkData GetChunkData() const
@@ -756,6 +885,16 @@ protected:
 
     mf::http::HttpConfig::ConstPointer http_config_;
 
+    // Used by the requests sending file data.
+    mf::http::HttpConfig::ConstPointer upload_http_config_;
+
+    // Storage for the file data sent by upload requests.
+    mf::http::SharedBufferPool::Pointer post_buffer_pool_;
+
+    // Reads file data ahead of upload requests, as a blocking read on the
+    // work io_service would hold up every other request.
+    HashThreadPool::Pointer read_ahead_thread_;
+
     // IOService for work.
     asio::io_service * work_io_service_;
     asio::io_service * callback_io_service_;
@@ -783,6 +922,9 @@ protected:
 
     boost::optional<UploadTarget> target_folder_;
 
+    // Units of a resumable upload sent at the same time.
+    const uint32_t max_concurrent_units_;
+
     uint64_t filesize_;
     std::time_t mtime_;
 
@@ -790,13 +932,29 @@ protected:
     std::vector<std::pair<uint64_t,uint64_t>> chunk_ranges_;
     std::vector<std::string> chunk_hashes_;
 
+    // Hasher state while hashing, so the hashing threads can be stopped.
+    he::HasherStateData hash_state_;
+
     CountState count_state_;
 
     std::vector<ChunkState> chunk_states_;
 
     mf::http::HttpRequest::Pointer upload_request_;
 
+    // Resumable upload requests in flight, by chunk id.
+    std::map<uint32_t, mf::http::HttpRequest::Pointer> chunk_requests_;
+
     std::string upload_key_;
+
+    // Failed units waiting to be sent again, by chunk id.
+    std::map<uint32_t, std::shared_ptr<asio::steady_timer>>
+        chunk_retry_timers_;
+
+    // Failures of each unit sent again.
+    std::map<uint32_t, uint32_t> chunk_failures_;
+
+    // Total units sent again.
+    uint32_t unit_retries_;
 };
 
 }  // namespace detail
@@ -0,0 +1,261 @@
+/**
+ * @file hash_cache.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include "hash_cache.hpp"
+
+#include <sstream>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "mediafire_sdk/utils/string.hpp"
+#include "mediafire_sdk/utils/url_encode.hpp"
+
+namespace percent = mf::utils::url::percent;
+
+namespace {
+
+// Rewrite the log when it has this many lines per entry, and at least
+// kMinCompactLines lines.
+const std::size_t kCompactRatio = 4;
+const std::size_t kMinCompactLines = 1024;
+
+const char kVersion[] = "v1";
+
+boost::filesystem::path Utf8ToPath(const std::string & utf8)
+{
+#ifdef _WIN32
+    return boost::filesystem::path(mf::utils::bytes_to_wide(utf8));
+#else
+    return boost::filesystem::path(utf8);
+#endif
+}
+
+/**
+ * Line format, space separated:
+ *   v1 PATH SIZE MTIME HASH COUNT START-END:HASH...
+ * PATH is percent encoded UTF-8, so contains no spaces.
+ */
+std::string FormatLine(const mf::uploader::FileHashes & hashes)
+{
+    std::ostringstream line;
+
+    line << kVersion
+        << ' ' << percent::Encode(mf::utils::path_to_utf8(hashes.path))
+        << ' ' << hashes.file_size
+        << ' ' << static_cast<int64_t>(hashes.mtime)
+        << ' ' << hashes.hash
+        << ' ' << hashes.chunk_hashes.size();
+
+    for (std::size_t i = 0; i < hashes.chunk_hashes.size(); ++i)
+    {
+        line << ' ' << hashes.chunk_ranges[i].first
+            << '-' << hashes.chunk_ranges[i].second
+            << ':' << hashes.chunk_hashes[i];
+    }
+
+    line << '\n';
+
+    return line.str();
+}
+
+boost::optional<mf::uploader::FileHashes> ParseLine(const std::string & text)
+{
+    std::istringstream line(text);
+
+    std::string version;
+    std::string encoded_path;
+    int64_t mtime = 0;
+    std::size_t count = 0;
+    mf::uploader::FileHashes hashes;
+
+    if ( ! (line >> version >> encoded_path >> hashes.file_size >> mtime
+            >> hashes.hash >> count) || version != kVersion )
+    {
+        return boost::none;
+    }
+
+    const auto path = percent::Decode(encoded_path);
+    if ( ! path )
+        return boost::none;
+
+    hashes.path = Utf8ToPath(*path);
+    hashes.mtime = static_cast<std::time_t>(mtime);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        uint64_t start = 0;
+        uint64_t end = 0;
+        char dash = 0;
+        char colon = 0;
+        std::string chunk_hash;
+
+        if ( ! (line >> start >> dash >> end >> colon >> chunk_hash)
+            || dash != '-' || colon != ':' )
+        {
+            return boost::none;
+        }
+
+        hashes.chunk_ranges.emplace_back(start, end);
+        hashes.chunk_hashes.push_back(std::move(chunk_hash));
+    }
+
+    return hashes;
+}
+
+}  // namespace
+
+namespace mf {
+namespace uploader {
+
+HashCache::Pointer HashCache::Create(
+        const boost::filesystem::path & cache_file,
+        std::error_code * error
+    )
+{
+    Pointer cache(new HashCache(cache_file));
+
+    mf::utils::lock_guard<mf::utils::mutex> lock(cache->mutex_);
+
+    cache->Load();
+
+    cache->log_.open(cache_file.string(),
+        std::ios::out | std::ios::app | std::ios::binary);
+
+    if (error)
+    {
+        if (cache->log_.is_open())
+            *error = std::error_code();
+        else
+            *error = std::make_error_code(std::errc::io_error);
+    }
+
+    return cache;
+}
+
+HashCache::HashCache(const boost::filesystem::path & cache_file) :
+    cache_file_(cache_file),
+    log_lines_(0)
+{
+}
+
+boost::optional<FileHashes> HashCache::Lookup(
+        const boost::filesystem::path & path,
+        uint64_t file_size,
+        std::time_t mtime
+    ) const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    auto it = entries_.find(mf::utils::path_to_utf8(path));
+    if ( it == entries_.end()
+        || it->second.file_size != file_size
+        || it->second.mtime != mtime )
+    {
+        return boost::none;
+    }
+
+    return it->second;
+}
+
+void HashCache::Store(const FileHashes & hashes)
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    const auto key = mf::utils::path_to_utf8(hashes.path);
+
+    // Already stored, as when the hashes came from this cache.
+    auto it = entries_.find(key);
+    if ( it != entries_.end()
+        && it->second.file_size == hashes.file_size
+        && it->second.mtime == hashes.mtime
+        && it->second.hash == hashes.hash
+        && it->second.chunk_hashes == hashes.chunk_hashes )
+    {
+        return;
+    }
+
+    entries_[key] = hashes;
+
+    if (log_.is_open())
+    {
+        log_ << FormatLine(hashes);
+        log_.flush();
+        ++log_lines_;
+
+        if ( log_lines_ >= kMinCompactLines
+            && log_lines_ >= entries_.size() * kCompactRatio )
+        {
+            Compact();
+        }
+    }
+}
+
+void HashCache::Clear()
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    entries_.clear();
+    log_lines_ = 0;
+
+    log_.close();
+    log_.open(cache_file_.string(),
+        std::ios::out | std::ios::trunc | std::ios::binary);
+}
+
+std::size_t HashCache::Size() const
+{
+    mf::utils::lock_guard<mf::utils::mutex> lock(mutex_);
+
+    return entries_.size();
+}
+
+void HashCache::Load()
+{
+    std::ifstream in(cache_file_.string(), std::ios::in | std::ios::binary);
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        ++log_lines_;
+
+        auto hashes = ParseLine(line);
+        if (hashes)
+            entries_[mf::utils::path_to_utf8(hashes->path)] = *hashes;
+    }
+}
+
+void HashCache::Compact()
+{
+    // Write the live entries to a new file and swap it in, so a crash leaves
+    // either the old or the new log.
+    auto temporary = cache_file_;
+    temporary += ".tmp";
+
+    {
+        std::ofstream out(temporary.string(),
+            std::ios::out | std::ios::trunc | std::ios::binary);
+
+        for (const auto & pair : entries_)
+            out << FormatLine(pair.second);
+
+        if ( ! out )
+            return;
+    }
+
+    log_.close();
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, cache_file_, ec);
+
+    if ( ! ec )
+        log_lines_ = entries_.size();
+
+    log_.open(cache_file_.string(),
+        std::ios::out | std::ios::app | std::ios::binary);
+}
+
+}  // namespace uploader
+}  // namespace mf
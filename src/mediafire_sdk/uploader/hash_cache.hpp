@@ -0,0 +1,104 @@
+/**
+ * @file hash_cache.hpp
+ * @author Herbert Jones
+ * @brief Persistent cache of file hashes.
+ * @copyright Copyright 2014 Mediafire
+ */
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
+
+#include "mediafire_sdk/uploader/hasher.hpp"
+#include "mediafire_sdk/utils/mutex.hpp"
+
+namespace mf {
+namespace uploader {
+
+/**
+ * @class HashCache
+ * @brief Remembers file hashes between runs so unchanged files need not be
+ * hashed again.
+ *
+ * Entries are kept in memory and appended to a log file, one line per entry.
+ * When a file is stored again, its newest line wins.  The log is rewritten
+ * once most of its lines are outdated.
+ */
+class HashCache
+{
+public:
+    using Pointer = std::shared_ptr<HashCache>;
+
+    /**
+     * @brief Open the cache, creating the file if it does not exist.
+     *
+     * Unreadable lines, such as one cut short by a crash, are skipped.
+     *
+     * @param[in] cache_file Path of the log file.
+     * @param[out] error Set if the file could not be opened for writing.  The
+     *                   cache still works in memory.
+     *
+     * @return The cache.
+     */
+    static Pointer Create(
+            const boost::filesystem::path & cache_file,
+            std::error_code * error
+        );
+
+    /**
+     * @brief Get the stored hashes of a file.
+     *
+     * @param[in] path Path of the file.
+     * @param[in] file_size Current size of the file.
+     * @param[in] mtime Current modification time of the file.
+     *
+     * @return The hashes if stored with the same size and mtime.
+     */
+    boost::optional<FileHashes> Lookup(
+            const boost::filesystem::path & path,
+            uint64_t file_size,
+            std::time_t mtime
+        ) const;
+
+    /**
+     * @brief Store the hashes of a file, replacing any older entry.
+     *
+     * @param[in] hashes Hashes with path, size and mtime filled in.
+     */
+    void Store(const FileHashes & hashes);
+
+    /**
+     * @brief Forget all entries and truncate the file.
+     */
+    void Clear();
+
+    /**
+     * @brief Number of files in the cache.
+     */
+    std::size_t Size() const;
+
+private:
+    explicit HashCache(const boost::filesystem::path & cache_file);
+
+    void Load();
+    void Compact();
+
+    const boost::filesystem::path cache_file_;
+
+    mutable mf::utils::mutex mutex_;
+
+    std::map<std::string, FileHashes> entries_;
+    std::ofstream log_;
+    std::size_t log_lines_;
+};
+
+}  // namespace uploader
+}  // namespace mf
@@ -127,6 +127,7 @@ struct HasherImpl
 
 Hasher::Hasher(
         boost::asio::io_service * io_service,
+        boost::asio::io_service * hash_io_service,
         boost::filesystem::path filepath,
         uint64_t filesize,
         std::time_t mtime,
@@ -139,6 +140,7 @@ Hasher::Hasher(
 
     auto state = std::make_shared<detail::hash_event::HasherStateData_>();
     state->io_service = io_service;
+    state->hash_io_service = hash_io_service;
     state->filepath = filepath;
     state->filesize = filesize;
     state->mtime = mtime;
@@ -161,8 +163,26 @@ Hasher::Pointer Hasher::Create(
         Callback callback
     )
 {
-    return Pointer(new Hasher( fileread_io_service, filepath, filesize, mtime,
-            callback));
+    return Pointer(new Hasher( fileread_io_service, nullptr, filepath,
+            filesize, mtime, callback));
+}
+
+Hasher::Pointer Hasher::Create(
+        boost::asio::io_service * callback_io_service,
+        boost::asio::io_service * hash_io_service,
+        boost::filesystem::path filepath,
+        uint64_t filesize,
+        std::time_t mtime,
+        Callback callback
+    )
+{
+    return Pointer(new Hasher( callback_io_service, hash_io_service, filepath,
+            filesize, mtime, callback));
+}
+
+void Hasher::SetUnitHashThreads(uint32_t threads)
+{
+    impl_->state->unit_hash_threads = threads;
 }
 
 void Hasher::Start()
@@ -174,6 +194,8 @@ void Hasher::Start()
 
 void Hasher::Cancel()
 {
+    impl_->state->cancelled = true;
+
     impl_->sm->process_event( detail::hash_event::Error{
         impl_->state,
         make_error_code(mf::uploader::errc::Cancelled),
@@ -61,8 +61,39 @@ public:
             std::time_t mtime,
             Callback callback
         );
+
+    /**
+     * @brief Create a hasher that reads the file on other threads.
+     *
+     * @param[in] callback_io_service Where the callback is called.
+     * @param[in] hash_io_service Run by the threads that read and hash the
+     *                            file.
+     * @param[in] filepath File to hash.
+     * @param[in] filesize Expected size of the file.
+     * @param[in] mtime Expected modification time of the file.
+     * @param[in] callback Called with the result.
+     */
+    static Pointer Create(
+            boost::asio::io_service * callback_io_service,
+            boost::asio::io_service * hash_io_service,
+            boost::filesystem::path filepath,
+            uint64_t filesize,
+            std::time_t mtime,
+            Callback callback
+        );
     ~Hasher();
 
+    /**
+     * @brief Hash the units of the file on additional threads.
+     *
+     * Only used when created with a hashing io_service.  Must be called
+     * before Start.
+     *
+     * @param[in] threads Number of unit hashing threads, or 0 to hash the
+     *                    units on the hashing thread.
+     */
+    void SetUnitHashThreads(uint32_t threads);
+
     /**
      * @brief Start hashing
      */
@@ -76,6 +107,7 @@ public:
 private:
     Hasher(
             boost::asio::io_service * fileread_io_service,
+            boost::asio::io_service * hash_io_service,
             boost::filesystem::path filepath,
             uint64_t filesize,
             std::time_t mtime,
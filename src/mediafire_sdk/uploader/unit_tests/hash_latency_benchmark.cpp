@@ -0,0 +1,391 @@
+/**
+ * @file hash_latency_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Measures how long simulated API calls take on the work io_service while files
+ * are being hashed.  Runs once without
+ * hashing, once hashing on the work io_service and once hashing on dedicated
+ * hashing threads.  Then measures the same while the files are uploaded in
+ * 1 MB chunks, once reading ahead on the work io_service and once on a
+ * dedicated read thread.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#ifdef BOOST_ASIO_SEPARATE_COMPILATION
+#  include "boost/asio/impl/src.hpp"  // Define once in program
+#  include "boost/asio/ssl/impl/src.hpp"  // Define once in program
+#endif
+#include "boost/asio/steady_timer.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/optional.hpp"
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+#include "mediafire_sdk/uploader/hasher.hpp"
+#include "mediafire_sdk/uploader/detail/hash_thread_pool.hpp"
+#include "mediafire_sdk/uploader/detail/upload_post_data_pipe.hpp"
+#include "mediafire_sdk/utils/fileio.hpp"
+
+namespace asio = boost::asio;
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+
+namespace {
+
+const std::chrono::milliseconds kProbeInterval(10);
+const int kProbeSteps = 20;
+
+// Largest buffer the upload manager sends file data in.
+const uint64_t kUploadChunkSize = 1024 * 1024;
+
+enum class Mode
+{
+    None,
+    WorkIoService,
+    HashThreads,
+    ReadAheadWorkIoService,
+    ReadAheadThread
+};
+
+struct Result
+{
+    std::vector<double> latencies_ms;
+    double elapsed_s;
+};
+
+void CreateTestFile(const boost::filesystem::path & path, uint64_t size)
+{
+    std::ofstream out(path.string(), std::ios::binary);
+
+    std::mt19937 generator(static_cast<uint32_t>(size));
+    std::vector<char> buffer(1024 * 1024);
+
+    while (size > 0)
+    {
+        for (auto & c : buffer)
+            c = static_cast<char>(generator());
+
+        const auto to_write = static_cast<std::streamsize>(
+            std::min<uint64_t>(size, buffer.size()));
+        out.write(buffer.data(), to_write);
+        size -= to_write;
+    }
+}
+
+Result Run(
+        Mode mode,
+        const std::vector<boost::filesystem::path> & files,
+        uint32_t hash_threads,
+        uint64_t upload_rate,
+        std::chrono::milliseconds idle_duration
+    )
+{
+    using mf::uploader::detail::UploadPostDataPipe;
+
+    asio::io_service work_io_service;
+    mf::uploader::detail::HashThreadPool::Pointer pool;
+
+    const bool hashing = (mode == Mode::WorkIoService
+        || mode == Mode::HashThreads);
+
+    if (mode == Mode::HashThreads)
+        pool = mf::uploader::detail::HashThreadPool::Create(hash_threads);
+    else if (mode == Mode::ReadAheadThread)
+        pool = mf::uploader::detail::HashThreadPool::Create(1);
+
+    Result result;
+    std::size_t remaining = (mode == Mode::None) ? 0 : files.size();
+    bool done = false;
+
+    std::vector<mf::uploader::Hasher::Pointer> hashers;
+
+    auto callback = [&](
+            std::error_code ec,
+            boost::optional<mf::uploader::FileHashes>
+        )
+    {
+        if (ec)
+            std::cerr << "Hash failed: " << ec.message() << std::endl;
+
+        if (--remaining == 0)
+            done = true;
+    };
+
+    for (const auto & path : files)
+    {
+        if ( ! hashing )
+            break;
+
+        const std::time_t mtime = boost::filesystem::last_write_time(path);
+        const uint64_t filesize = boost::filesystem::file_size(path);
+
+        if (mode == Mode::HashThreads)
+        {
+            hashers.push_back(mf::uploader::Hasher::Create(&work_io_service,
+                pool->IoService(), path, filesize, mtime, callback));
+        }
+        else
+        {
+            hashers.push_back(mf::uploader::Hasher::Create(&work_io_service,
+                path, filesize, mtime, callback));
+        }
+    }
+
+    // The probe stands in for an API call: after waiting on a timer it takes
+    // several handler steps, like resolving, connecting, writing and reading,
+    // each queued behind whatever else is on the work io_service.
+    asio::steady_timer probe(work_io_service);
+    std::function<void()> schedule_probe;
+    std::function<void(sclock::time_point, int)> probe_step;
+    probe_step = [&](sclock::time_point started, int steps_left)
+    {
+        if (steps_left > 0)
+        {
+            work_io_service.post(
+                [&, started, steps_left]()
+                {
+                    probe_step(started, steps_left - 1);
+                });
+            return;
+        }
+
+        result.latencies_ms.push_back(std::chrono::duration<double,
+            std::milli>(sclock::now() - started).count());
+
+        if ( ! done )
+            schedule_probe();
+    };
+    schedule_probe = [&]()
+    {
+        const auto expected = sclock::now() + kProbeInterval;
+        probe.expires_at(expected);
+        probe.async_wait(
+            [&, expected](const boost::system::error_code & err)
+            {
+                if ( ! err )
+                    probe_step(expected, kProbeSteps);
+            });
+    };
+
+    // Each upload takes a chunk from its pipe, as the request does, and waits
+    // as long as the socket would take to send it before taking the next.
+    asio::io_service * read_ahead_io_service = (mode == Mode::ReadAheadThread)
+        ? pool->IoService() : &work_io_service;
+    auto buffer_pool = mf::http::SharedBufferPool::Create(kUploadChunkSize,
+        files.size() * 2);
+
+    std::vector<std::shared_ptr<UploadPostDataPipe>> pipes;
+    std::vector<std::unique_ptr<asio::steady_timer>> send_timers;
+    std::function<void(std::size_t)> send_chunk;
+    send_chunk = [&](std::size_t index)
+    {
+        auto chunk = pipes[index]->RetreivePostDataChunk();
+        if ( ! chunk )
+        {
+            if (--remaining == 0)
+                done = true;
+            return;
+        }
+
+        auto & timer = *send_timers[index];
+        timer.expires_from_now(std::chrono::microseconds(
+            chunk->Size() * 1000000 / upload_rate));
+        timer.async_wait(
+            [&, index](const boost::system::error_code & err)
+            {
+                if ( ! err )
+                    send_chunk(index);
+            });
+    };
+
+    for (const auto & path : files)
+    {
+        if (mode != Mode::ReadAheadWorkIoService
+            && mode != Mode::ReadAheadThread)
+        {
+            break;
+        }
+
+        std::error_code ec;
+        auto file = mf::utils::FileIO::Open(path, "rb", &ec);
+        if (ec)
+            throw std::runtime_error("Unable to open " + path.string());
+
+        pipes.push_back(std::make_shared<UploadPostDataPipe>(file, 0,
+            boost::filesystem::file_size(path), buffer_pool,
+            read_ahead_io_service));
+        send_timers.emplace_back(new asio::steady_timer(work_io_service));
+    }
+
+    asio::steady_timer idle_timer(work_io_service);
+    if (mode == Mode::None)
+    {
+        idle_timer.expires_from_now(idle_duration);
+        idle_timer.async_wait(
+            [&](const boost::system::error_code &)
+            {
+                done = true;
+            });
+    }
+
+    const auto start = sclock::now();
+
+    schedule_probe();
+    for (auto & hasher : hashers)
+        hasher->Start();
+    for (std::size_t i = 0; i < pipes.size(); ++i)
+    {
+        work_io_service.post(
+            [&, i]()
+            {
+                send_chunk(i);
+            });
+    }
+
+    work_io_service.run();
+
+    result.elapsed_s = std::chrono::duration<double>(
+        sclock::now() - start).count();
+
+    return result;
+}
+
+void Report(const std::string & name, Result result)
+{
+    auto & latencies = result.latencies_ms;
+    std::sort(latencies.begin(), latencies.end());
+
+    double total = 0;
+    for (auto latency : latencies)
+        total += latency;
+
+    const auto Percentile = [&](double p)
+    {
+        if (latencies.empty())
+            return 0.0;
+        return latencies[static_cast<std::size_t>(
+            p * (latencies.size() - 1))];
+    };
+
+    std::cout << std::left << std::setw(22) << name << std::right
+        << std::fixed << std::setprecision(2)
+        << std::setw(10) << result.elapsed_s
+        << std::setw(10) << latencies.size()
+        << std::setw(12) << (latencies.empty() ? 0 : total / latencies.size())
+        << std::setw(12) << Percentile(0.99)
+        << std::setw(12) << Percentile(1.0)
+        << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        uint64_t file_size_mb = 256;
+        uint32_t file_count = 2;
+        uint32_t hash_threads = 2;
+        uint64_t upload_rate_mb = 100;
+        std::string directory;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("size", po::value<uint64_t>(&file_size_mb),
+                "Size of each test file in MB. (256)")
+            ("files", po::value<uint32_t>(&file_count),
+                "Number of files hashed at the same time. (2)")
+            ("threads", po::value<uint32_t>(&hash_threads),
+                "Number of hashing threads. (2)")
+            ("rate", po::value<uint64_t>(&upload_rate_mb),
+                "Upload rate of each file in MB/s. (100)")
+            ("dir", po::value<std::string>(&directory),
+                "Directory for the test files. (temp directory)");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        boost::filesystem::path dir = directory.empty()
+            ? boost::filesystem::temp_directory_path()
+            : boost::filesystem::path(directory);
+
+        std::vector<boost::filesystem::path> files;
+        for (uint32_t i = 0; i < file_count; ++i)
+        {
+            auto path = dir / boost::filesystem::unique_path(
+                "hash-latency-%%%%-%%%%.bin");
+            std::cout << "Creating " << path.string() << std::endl;
+            CreateTestFile(path, file_size_mb * 1024 * 1024);
+            files.push_back(path);
+        }
+
+        const uint64_t upload_rate = std::max<uint64_t>(1, upload_rate_mb)
+            * 1024 * 1024;
+
+        const auto work_result = Run(Mode::WorkIoService, files,
+            hash_threads, upload_rate, std::chrono::milliseconds(0));
+        const auto threads_result = Run(Mode::HashThreads, files,
+            hash_threads, upload_rate, std::chrono::milliseconds(0));
+        const auto idle_result = Run(Mode::None, files, hash_threads,
+            upload_rate,
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::duration<double>(threads_result.elapsed_s)));
+        const auto upload_work_result = Run(Mode::ReadAheadWorkIoService,
+            files, hash_threads, upload_rate, std::chrono::milliseconds(0));
+        const auto upload_thread_result = Run(Mode::ReadAheadThread,
+            files, hash_threads, upload_rate, std::chrono::milliseconds(0));
+
+        std::cout << "\nLatency of simulated API calls in ms\n"
+            << std::left << std::setw(22) << "Mode" << std::right
+            << std::setw(10) << "Time(s)"
+            << std::setw(10) << "Probes"
+            << std::setw(12) << "Mean"
+            << std::setw(12) << "p99"
+            << std::setw(12) << "Max"
+            << std::endl;
+
+        Report("No hashing", idle_result);
+        Report("Work io_service", work_result);
+        Report("Hashing threads", threads_result);
+        Report("Upload, work reads", upload_work_result);
+        Report("Upload, read thread", upload_thread_result);
+
+        for (const auto & path : files)
+            boost::filesystem::remove(path);
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "Uncaught exception: " << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        std::cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+
+    return 0;
+}
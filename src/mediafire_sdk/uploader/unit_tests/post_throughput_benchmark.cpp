@@ -0,0 +1,372 @@
+/**
+ * @file post_throughput_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Measures how fast a file is sent as POST data to a local HTTP server that
+ * discards it.  Compares the previous 8 KB unpooled buffers against pooled
+ * buffers of several sizes that are read ahead, and against sendfile.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#ifdef BOOST_ASIO_SEPARATE_COMPILATION
+#  include "boost/asio/impl/src.hpp"  // Define once in program
+#  include "boost/asio/ssl/impl/src.hpp"  // Define once in program
+#endif
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/http/http_config.hpp"
+#include "mediafire_sdk/http/http_request.hpp"
+#include "mediafire_sdk/http/shared_buffer_pool.hpp"
+#include "mediafire_sdk/uploader/detail/upload_post_data_pipe.hpp"
+#include "mediafire_sdk/utils/fileio.hpp"
+
+namespace asio = boost::asio;
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+using asio::ip::tcp;
+
+namespace {
+
+void CreateTestFile(const boost::filesystem::path & path, uint64_t size)
+{
+    std::ofstream out(path.string(), std::ios::binary);
+
+    std::mt19937 generator(static_cast<uint32_t>(size));
+    std::vector<char> buffer(1024 * 1024);
+
+    while (size > 0)
+    {
+        for (auto & c : buffer)
+            c = static_cast<char>(generator());
+
+        const auto to_write = static_cast<std::streamsize>(
+            std::min<uint64_t>(size, buffer.size()));
+        out.write(buffer.data(), to_write);
+        size -= to_write;
+    }
+}
+
+/**
+ * Accepts one request per connection, discards its body and answers with an
+ * empty 200.
+ */
+class SinkConnection : public std::enable_shared_from_this<SinkConnection>
+{
+public:
+    explicit SinkConnection(asio::io_service * io_service) :
+        socket_(*io_service),
+        remaining_(0),
+        buffer_(256 * 1024)
+    {
+    }
+
+    tcp::socket & Socket() { return socket_; }
+
+    void Start()
+    {
+        auto self = shared_from_this();
+        asio::async_read_until(socket_, header_, "\r\n\r\n",
+            [this, self](const boost::system::error_code & err,
+                std::size_t header_size)
+            {
+                if (err)
+                    return;
+
+                std::string header(asio::buffers_begin(header_.data()),
+                    asio::buffers_begin(header_.data()) + header_size);
+                header_.consume(header_size);
+
+                std::istringstream lines(header);
+                std::string line;
+                while (std::getline(lines, line))
+                {
+                    const std::string name = "Content-Length:";
+                    if (boost::algorithm::istarts_with(line, name))
+                        remaining_ = std::stoull(line.substr(name.size()));
+                }
+
+                // Part of the body may have been read with the header.
+                const auto buffered = std::min<uint64_t>(remaining_,
+                    header_.size());
+                header_.consume(buffered);
+                remaining_ -= buffered;
+
+                ReadBody();
+            });
+    }
+
+private:
+    void ReadBody()
+    {
+        if (remaining_ == 0)
+        {
+            Respond();
+            return;
+        }
+
+        auto self = shared_from_this();
+        socket_.async_read_some(asio::buffer(buffer_.data(),
+                std::min<uint64_t>(remaining_, buffer_.size())),
+            [this, self](const boost::system::error_code & err,
+                std::size_t bytes_read)
+            {
+                if (err)
+                    return;
+
+                remaining_ -= bytes_read;
+                ReadBody();
+            });
+    }
+
+    void Respond()
+    {
+        static const std::string response = "HTTP/1.1 200 OK\r\n"
+            "Content-Length: 0\r\n"
+            "Connection: close\r\n"
+            "\r\n";
+
+        auto self = shared_from_this();
+        asio::async_write(socket_, asio::buffer(response),
+            [this, self](const boost::system::error_code &, std::size_t)
+            {
+                boost::system::error_code ignored;
+                socket_.shutdown(tcp::socket::shutdown_both, ignored);
+            });
+    }
+
+    tcp::socket socket_;
+    asio::streambuf header_;
+    uint64_t remaining_;
+    std::vector<char> buffer_;
+};
+
+class Sink
+{
+public:
+    Sink() :
+        work_(io_service_),
+        acceptor_(io_service_, tcp::endpoint(
+            asio::ip::address_v4::loopback(), 0))
+    {
+        Accept();
+        thread_ = std::thread([this]() { io_service_.run(); });
+    }
+
+    ~Sink()
+    {
+        io_service_.stop();
+        thread_.join();
+    }
+
+    uint16_t Port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    void Accept()
+    {
+        auto connection = std::make_shared<SinkConnection>(&io_service_);
+        acceptor_.async_accept(connection->Socket(),
+            [this, connection](const boost::system::error_code & err)
+            {
+                if ( ! err )
+                    connection->Start();
+                Accept();
+            });
+    }
+
+    asio::io_service io_service_;
+    asio::io_service::work work_;
+    tcp::acceptor acceptor_;
+    std::thread thread_;
+};
+
+struct Mode
+{
+    std::string name;
+    uint64_t buffer_size;
+    bool pooled;
+    bool send_file;
+};
+
+bool Post(
+        const boost::filesystem::path & path,
+        const std::string & url,
+        const Mode & mode,
+        double * elapsed_s
+    )
+{
+    asio::io_service io_service;
+    auto http_config = mf::http::HttpConfig::Create(&io_service);
+    http_config->SetSendFileEnabled(mode.send_file);
+
+    std::error_code ec;
+    auto file_io = mf::utils::FileIO::Open(path, "rb", &ec);
+    if (ec)
+    {
+        std::cerr << "Unable to open " << path.string() << std::endl;
+        return false;
+    }
+
+    const uint64_t filesize = boost::filesystem::file_size(path);
+
+    std::shared_ptr<mf::uploader::detail::UploadPostDataPipe> pipe;
+    if (mode.pooled)
+    {
+        pipe = std::make_shared<mf::uploader::detail::UploadPostDataPipe>(
+            file_io, 0, filesize,
+            mf::http::SharedBufferPool::Create(mode.buffer_size, 4),
+            &io_service);
+    }
+    else
+    {
+        pipe = std::make_shared<mf::uploader::detail::UploadPostDataPipe>(
+            file_io, 0, filesize);
+    }
+
+    bool success = false;
+    auto request = mf::http::HttpRequest::Create(http_config,
+        [&](mf::http::HttpRequest::CallbackResponse response)
+        {
+            if (response.error_code)
+            {
+                std::cerr << "POST failed: " << response.error_code.message()
+                    << std::endl;
+            }
+            success = ! response.error_code;
+            io_service.stop();
+        },
+        &io_service,
+        url);
+
+    request->SetRequestMethod("POST");
+    request->SetHeader("Content-Type", "application/octet-stream");
+    request->SetPostDataPipe(pipe);
+
+    asio::io_service::work work(io_service);
+
+    const auto start = sclock::now();
+
+    request->Start();
+    io_service.run();
+
+    *elapsed_s = std::chrono::duration<double>(sclock::now() - start).count();
+
+    return success;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        uint64_t file_size_mb = 512;
+        uint32_t repeat = 3;
+        std::string filepath;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("size", po::value<uint64_t>(&file_size_mb),
+                "Size of the generated test file in MB. (512)")
+            ("repeat", po::value<uint32_t>(&repeat),
+                "Runs of each mode, the fastest is reported. (3)")
+            ("file", po::value<std::string>(&filepath),
+                "Send this file instead of a generated one.");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        const bool generated = filepath.empty();
+        boost::filesystem::path path(filepath);
+
+        if (generated)
+        {
+            path = boost::filesystem::temp_directory_path()
+                / boost::filesystem::unique_path("post-sink-%%%%-%%%%.bin");
+            std::cout << "Creating " << path.string() << std::endl;
+            CreateTestFile(path, file_size_mb * 1024 * 1024);
+        }
+
+        Sink sink;
+        const std::string url = "http://127.0.0.1:"
+            + std::to_string(sink.Port()) + "/upload";
+
+        const std::vector<Mode> modes = {
+            {"8 KB unpooled", 8 * 1024, false, false},
+            {"8 KB pooled", 8 * 1024, true, false},
+            {"64 KB pooled", 64 * 1024, true, false},
+            {"256 KB pooled", 256 * 1024, true, false},
+            {"1 MB pooled", 1024 * 1024, true, false},
+            {"sendfile", 64 * 1024, true, true},
+        };
+
+        const double size_mb = static_cast<double>(
+            boost::filesystem::file_size(path)) / (1024 * 1024);
+
+        int exit_code = 0;
+
+        std::cout << "\n" << std::left << std::setw(18) << "Buffers"
+            << std::right << std::setw(10) << "Time(s)"
+            << std::setw(10) << "MB/s"
+            << std::endl;
+
+        for (const auto & mode : modes)
+        {
+            double best = 0;
+
+            for (uint32_t i = 0; i < std::max(1u, repeat); ++i)
+            {
+                double elapsed_s = 0;
+                if ( ! Post(path, url, mode, &elapsed_s) )
+                    exit_code = 1;
+                if (i == 0 || elapsed_s < best)
+                    best = elapsed_s;
+            }
+
+            std::cout << std::left << std::setw(18) << mode.name
+                << std::right << std::fixed << std::setprecision(2)
+                << std::setw(10) << best
+                << std::setw(10) << size_mb / best
+                << std::endl;
+        }
+
+        if (generated)
+            boost::filesystem::remove(path);
+
+        return exit_code;
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "Uncaught exception: " << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        std::cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+}
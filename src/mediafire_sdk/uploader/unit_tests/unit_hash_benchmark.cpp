@@ -0,0 +1,210 @@
+/**
+ * @file unit_hash_benchmark.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ *
+ * Compares hashing a file with its units hashed on the hashing thread against
+ * hashing the units on additional threads, and checks both give the same
+ * hashes.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#ifdef BOOST_ASIO_SEPARATE_COMPILATION
+#  include "boost/asio/impl/src.hpp"  // Define once in program
+#  include "boost/asio/ssl/impl/src.hpp"  // Define once in program
+#endif
+#include "boost/filesystem.hpp"
+#include "boost/optional.hpp"
+#include "boost/program_options.hpp"
+
+#include "mediafire_sdk/uploader/hasher.hpp"
+#include "mediafire_sdk/uploader/detail/hash_thread_pool.hpp"
+
+namespace asio = boost::asio;
+namespace po = boost::program_options;
+
+using sclock = std::chrono::steady_clock;
+
+namespace {
+
+void CreateTestFile(const boost::filesystem::path & path, uint64_t size)
+{
+    std::ofstream out(path.string(), std::ios::binary);
+
+    std::mt19937 generator(static_cast<uint32_t>(size));
+    std::vector<char> buffer(1024 * 1024);
+
+    while (size > 0)
+    {
+        for (auto & c : buffer)
+            c = static_cast<char>(generator());
+
+        const auto to_write = static_cast<std::streamsize>(
+            std::min<uint64_t>(size, buffer.size()));
+        out.write(buffer.data(), to_write);
+        size -= to_write;
+    }
+}
+
+boost::optional<mf::uploader::FileHashes> HashFile(
+        const boost::filesystem::path & path,
+        uint32_t unit_hash_threads,
+        double * elapsed_s
+    )
+{
+    asio::io_service io_service;
+    auto pool = mf::uploader::detail::HashThreadPool::Create(1);
+
+    boost::optional<mf::uploader::FileHashes> result;
+
+    auto callback = [&](
+            std::error_code ec,
+            boost::optional<mf::uploader::FileHashes> file_hashes
+        )
+    {
+        if (ec)
+            std::cerr << "Hash failed: " << ec.message() << std::endl;
+
+        result = file_hashes;
+        io_service.stop();
+    };
+
+    const std::time_t mtime = boost::filesystem::last_write_time(path);
+    const uint64_t filesize = boost::filesystem::file_size(path);
+
+    auto hasher = mf::uploader::Hasher::Create(&io_service, pool->IoService(),
+        path, filesize, mtime, callback);
+    hasher->SetUnitHashThreads(unit_hash_threads);
+
+    asio::io_service::work work(io_service);
+
+    const auto start = sclock::now();
+
+    hasher->Start();
+    io_service.run();
+
+    *elapsed_s = std::chrono::duration<double>(sclock::now() - start).count();
+
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        uint64_t file_size_mb = 1024;
+        uint32_t repeat = 3;
+        std::string filepath;
+
+        po::options_description visible("Allowed options");
+        visible.add_options()
+            ("help,h", "Show this message.")
+            ("size", po::value<uint64_t>(&file_size_mb),
+                "Size of the generated test file in MB. (1024)")
+            ("repeat", po::value<uint32_t>(&repeat),
+                "Runs of each mode, the fastest is reported. (3)")
+            ("file", po::value<std::string>(&filepath),
+                "Hash this file instead of a generated one.");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, visible), vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << visible << "\n";
+            return 0;
+        }
+
+        const bool generated = filepath.empty();
+        boost::filesystem::path path(filepath);
+
+        if (generated)
+        {
+            path = boost::filesystem::temp_directory_path()
+                / boost::filesystem::unique_path("unit-hash-%%%%-%%%%.bin");
+            std::cout << "Creating " << path.string() << std::endl;
+            CreateTestFile(path, file_size_mb * 1024 * 1024);
+        }
+
+        const uint32_t cores = std::max(1u,
+            std::thread::hardware_concurrency());
+
+        std::vector<uint32_t> modes = {0};
+        for (uint32_t threads = 1; threads <= cores; threads *= 2)
+            modes.push_back(threads);
+
+        const double size_mb = static_cast<double>(
+            boost::filesystem::file_size(path)) / (1024 * 1024);
+
+        boost::optional<mf::uploader::FileHashes> sequential;
+        int exit_code = 0;
+
+        std::cout << "\n" << std::left << std::setw(16) << "Unit threads"
+            << std::right << std::setw(10) << "Time(s)"
+            << std::setw(10) << "MB/s"
+            << std::setw(10) << "Same"
+            << std::endl;
+
+        for (auto threads : modes)
+        {
+            double best = 0;
+            boost::optional<mf::uploader::FileHashes> hashes;
+
+            for (uint32_t i = 0; i < std::max(1u, repeat); ++i)
+            {
+                double elapsed_s = 0;
+                hashes = HashFile(path, threads, &elapsed_s);
+                if (i == 0 || elapsed_s < best)
+                    best = elapsed_s;
+            }
+
+            if (threads == 0)
+                sequential = hashes;
+
+            const bool same = sequential && hashes
+                && sequential->hash == hashes->hash
+                && sequential->chunk_hashes == hashes->chunk_hashes;
+
+            if ( ! same )
+                exit_code = 1;
+
+            std::cout << std::left << std::setw(16)
+                << (threads == 0 ? std::string("0 (sequential)")
+                    : std::to_string(threads))
+                << std::right << std::fixed << std::setprecision(2)
+                << std::setw(10) << best
+                << std::setw(10) << size_mb / best
+                << std::setw(10) << (same ? "yes" : "NO")
+                << std::endl;
+        }
+
+        if (generated)
+            boost::filesystem::remove(path);
+
+        return exit_code;
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "Uncaught exception: " << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        std::cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+}
@@ -41,12 +41,14 @@ public:
                   int id,
                   const int files_expected,
                   int * files_complete,
-                  std::map<int, std::string> * summary_map)
+                  std::map<int, std::string> * summary_map,
+                  uint32_t unit_retries)
             : io_service_(io_service),
               files_expected_(files_expected),
               files_complete_(files_complete),
               summary_map_(summary_map),
-              id_(id)
+              id_(id),
+              unit_retries_(unit_retries)
     {
         if (files_expected > 0)
         {
@@ -67,7 +69,11 @@ public:
 
     void operator()(us::Uploading &) const
     {
-        std::cout << id_str_ << "Upload started." << std::endl;
+        if (unit_retries_ == 0)
+            std::cout << id_str_ << "Upload started." << std::endl;
+        else
+            std::cout << id_str_ << "Sending failed unit again. Retries: "
+                      << unit_retries_ << std::endl;
     }
 
     void operator()(us::Polling &) const
@@ -111,6 +117,7 @@ private:
 
     int id_;
     std::string id_str_;
+    uint32_t unit_retries_;
 };
 
 void ShowUsage(const char * filename, const po::options_description & visible)
@@ -252,7 +259,8 @@ int main(int argc, char * argv[])
                            boost::apply_visitor(
                                    StatusVisitor(io_service, file_id,
                                                  files_to_upload,
-                                                 &files_uploaded, &summary_map),
+                                                 &files_uploaded, &summary_map,
+                                                 status.unit_retries),
                                    status.state);
                        });
             }
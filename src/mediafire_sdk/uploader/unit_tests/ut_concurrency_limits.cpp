@@ -0,0 +1,250 @@
+/**
+ * @file ut_concurrency_limits.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#define BOOST_TEST_MODULE UtConcurrencyLimits
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/uploader/detail/adaptive_concurrency.hpp"
+#include "mediafire_sdk/uploader/detail/concurrency_limit.hpp"
+#include "mediafire_sdk/uploader/detail/throughput_monitor.hpp"
+
+using mf::uploader::detail::AdaptiveConcurrency;
+using mf::uploader::detail::ThroughputMonitor;
+
+namespace {
+
+using Limit = mf::uploader::detail::ConcurrencyLimit<int>;
+
+/** Stands in for the analyser set by the user. */
+class StubAnalyser : public mf::http::BandwidthAnalyserInterface
+{
+public:
+    StubAnalyser() : incoming(0), outgoing(0) {}
+
+    virtual void RecordIncomingBytes(
+            size_t bytes,
+            std::chrono::steady_clock::time_point,
+            std::chrono::steady_clock::time_point
+        ) override
+    {
+        incoming += bytes;
+    }
+
+    virtual void RecordOutgoingBytes(
+            size_t bytes,
+            std::chrono::steady_clock::time_point,
+            std::chrono::steady_clock::time_point
+        ) override
+    {
+        outgoing += bytes;
+    }
+
+    uint64_t incoming;
+    uint64_t outgoing;
+};
+
+/** Uploads sending bytes through the monitor for one five second sample. */
+uint64_t SampleRate(ThroughputMonitor * monitor, uint64_t bytes_per_second)
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i)
+        monitor->RecordOutgoingBytes(bytes_per_second, now, now);
+
+    return monitor->TakeOutgoingBytes() / 5;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(LimitEnforced)
+{
+    Limit limit(2);
+
+    BOOST_CHECK( limit.CanStartMore() );
+    limit.Starting(1);
+    BOOST_CHECK( limit.CanStartMore() );
+    limit.Starting(2);
+
+    // Work asked to start holds its slot until it starts.
+    BOOST_CHECK( ! limit.CanStartMore() );
+    limit.Started(1);
+    limit.Started(2);
+    BOOST_CHECK( ! limit.CanStartMore() );
+    BOOST_CHECK_EQUAL( limit.Running(), 2u );
+    BOOST_CHECK_EQUAL( limit.StartingCount(), 0u );
+
+    limit.Stopped();
+    BOOST_CHECK( limit.CanStartMore() );
+}
+
+BOOST_AUTO_TEST_CASE(LimitChanged)
+{
+    Limit limit(0);
+    BOOST_CHECK_EQUAL( limit.Limit(), 1u );
+
+    limit.SetLimit(3);
+    for (int i = 0; i < 3; ++i)
+        limit.Started(i);
+    BOOST_CHECK( ! limit.CanStartMore() );
+
+    // Lowering it lets running work finish, but starts nothing more until
+    // enough has stopped.
+    limit.SetLimit(1);
+    limit.Stopped();
+    BOOST_CHECK( ! limit.CanStartMore() );
+    limit.Stopped();
+    BOOST_CHECK( ! limit.CanStartMore() );
+    limit.Stopped();
+    BOOST_CHECK( limit.CanStartMore() );
+
+    limit.SetLimit(0);
+    BOOST_CHECK_EQUAL( limit.Limit(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE(SlotReleasedOnError)
+{
+    Limit limit(1);
+
+    limit.Starting(1);
+    limit.Started(1);
+    BOOST_CHECK( ! limit.CanStartMore() );
+
+    // Failed while running.
+    limit.Stopped();
+    limit.Abandoned(1);
+    BOOST_CHECK( limit.CanStartMore() );
+    BOOST_CHECK_EQUAL( limit.Running(), 0u );
+
+    // Stopping more than was started does not free slots never taken.
+    limit.Stopped();
+    limit.Starting(2);
+    BOOST_CHECK( ! limit.CanStartMore() );
+}
+
+BOOST_AUTO_TEST_CASE(SlotReleasedOnCancel)
+{
+    Limit limit(2);
+
+    limit.Starting(1);
+    limit.Starting(2);
+    BOOST_CHECK( ! limit.CanStartMore() );
+
+    // Cancelled before it started.
+    limit.Abandoned(2);
+    BOOST_CHECK( limit.CanStartMore() );
+    BOOST_CHECK_EQUAL( limit.StartingCount(), 1u );
+
+    // Work that was never asked to start changes nothing.
+    limit.Abandoned(3);
+    BOOST_CHECK_EQUAL( limit.StartingCount(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE(MonitorForwards)
+{
+    auto stub = std::make_shared<StubAnalyser>();
+    ThroughputMonitor monitor(stub);
+
+    const auto now = std::chrono::steady_clock::now();
+    monitor.RecordIncomingBytes(100, now, now);
+    monitor.RecordOutgoingBytes(200, now, now);
+    monitor.RecordOutgoingBytes(300, now, now);
+
+    BOOST_CHECK_EQUAL( stub->incoming, 100u );
+    BOOST_CHECK_EQUAL( stub->outgoing, 500u );
+
+    // Only outgoing bytes count, each only once.
+    BOOST_CHECK_EQUAL( monitor.TakeOutgoingBytes(), 500u );
+    BOOST_CHECK_EQUAL( monitor.TakeOutgoingBytes(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveGrowsWhileBetter)
+{
+    ThroughputMonitor monitor(std::make_shared<StubAnalyser>());
+    AdaptiveConcurrency adaptive;
+    adaptive.SetRange(1, 5);
+
+    uint32_t limit = 1;
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 1000), true);
+    BOOST_CHECK_EQUAL( limit, 2u );
+
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 2000), true);
+    BOOST_CHECK_EQUAL( limit, 3u );
+
+    // Within tolerance, so stays put.
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 2020), true);
+    BOOST_CHECK_EQUAL( limit, 3u );
+
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 4000), true);
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 8000), true);
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 16000), true);
+
+    // Never past the range.
+    BOOST_CHECK_EQUAL( limit, 5u );
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveShrinksWhenWorse)
+{
+    ThroughputMonitor monitor(std::make_shared<StubAnalyser>());
+    AdaptiveConcurrency adaptive;
+    adaptive.SetRange(1, 10);
+
+    uint32_t limit = 4;
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 4000), true);
+    BOOST_CHECK_EQUAL( limit, 5u );
+
+    // The step up made it worse, so back down.
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 3000), true);
+    BOOST_CHECK_EQUAL( limit, 4u );
+
+    // Keeps shrinking while that helps.
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 3500), true);
+    BOOST_CHECK_EQUAL( limit, 3u );
+
+    // Worse again, so turns around.
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 2000), true);
+    BOOST_CHECK_EQUAL( limit, 4u );
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveGrowsOnlyWhenWaiting)
+{
+    ThroughputMonitor monitor(std::make_shared<StubAnalyser>());
+    AdaptiveConcurrency adaptive;
+    adaptive.SetRange(2, 10);
+
+    uint32_t limit = 3;
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 1000), false);
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 5000), false);
+    BOOST_CHECK_EQUAL( limit, 3u );
+
+    // Shrinking does not need anything waiting.
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 1000), false);
+    BOOST_CHECK_EQUAL( limit, 2u );
+
+    // Never below the range.
+    limit = adaptive.Sample(limit, SampleRate(&monitor, 1200), false);
+    BOOST_CHECK_EQUAL( limit, 2u );
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveReset)
+{
+    AdaptiveConcurrency adaptive;
+    adaptive.SetRange(0, 0);
+    BOOST_CHECK_EQUAL( adaptive.MinLimit(), 1u );
+    BOOST_CHECK_EQUAL( adaptive.MaxLimit(), 1u );
+
+    adaptive.SetRange(1, 10);
+    BOOST_CHECK_EQUAL( adaptive.Clamp(20), 10u );
+
+    uint32_t limit = adaptive.Sample(3, 10000, true);
+    BOOST_CHECK_EQUAL( limit, 4u );
+
+    // After being idle a much lower rate is not taken as worse.
+    adaptive.Reset();
+    limit = adaptive.Sample(limit, 100, true);
+    BOOST_CHECK_EQUAL( limit, 5u );
+}
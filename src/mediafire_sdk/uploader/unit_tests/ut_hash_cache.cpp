@@ -0,0 +1,113 @@
+/**
+ * @file ut_hash_cache.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <fstream>
+#include <string>
+
+#include "boost/filesystem.hpp"
+
+#define BOOST_TEST_MODULE UtHashCache
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/uploader/hash_cache.hpp"
+
+namespace {
+
+/** Cache file removed when the test ends. */
+class TemporaryCacheFile
+{
+public:
+    TemporaryCacheFile() :
+        path_(boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("ut-hash-cache-%%%%-%%%%.log"))
+    {
+    }
+
+    ~TemporaryCacheFile()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+    const boost::filesystem::path & Path() const {return path_;}
+
+private:
+    boost::filesystem::path path_;
+};
+
+mf::uploader::FileHashes MakeHashes(
+        const std::string & path,
+        uint64_t file_size,
+        std::time_t mtime
+    )
+{
+    mf::uploader::FileHashes hashes;
+    hashes.path = path;
+    hashes.file_size = file_size;
+    hashes.mtime = mtime;
+    hashes.hash = std::string(64, 'a');
+    hashes.chunk_ranges = {{0, file_size / 2}, {file_size / 2, file_size}};
+    hashes.chunk_hashes = {std::string(64, 'b'), std::string(64, 'c')};
+    return hashes;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(LookupRequiresSizeAndMtime)
+{
+    TemporaryCacheFile file;
+    std::error_code ec;
+    auto cache = mf::uploader::HashCache::Create(file.Path(), &ec);
+    BOOST_CHECK( ! ec );
+
+    cache->Store(MakeHashes("/tmp/some file.bin", 1000, 1234));
+
+    BOOST_CHECK( cache->Lookup("/tmp/some file.bin", 1000, 1234) );
+    BOOST_CHECK( ! cache->Lookup("/tmp/some file.bin", 1001, 1234) );
+    BOOST_CHECK( ! cache->Lookup("/tmp/some file.bin", 1000, 1235) );
+    BOOST_CHECK( ! cache->Lookup("/tmp/other.bin", 1000, 1234) );
+}
+
+BOOST_AUTO_TEST_CASE(EntriesSurviveReopen)
+{
+    TemporaryCacheFile file;
+    const auto expected = MakeHashes("/tmp/some file.bin", 1000, 1234);
+
+    {
+        auto cache = mf::uploader::HashCache::Create(file.Path(), nullptr);
+        cache->Store(MakeHashes("/tmp/some file.bin", 900, 1000));
+        cache->Store(expected);
+    }
+
+    // A line cut short by a crash is skipped.
+    {
+        std::ofstream out(file.Path().string(), std::ios::app);
+        out << "v1 %2Ftmp%2Fbroken 10";
+    }
+
+    auto cache = mf::uploader::HashCache::Create(file.Path(), nullptr);
+    BOOST_CHECK_EQUAL( cache->Size(), 1u );
+
+    const auto actual = cache->Lookup("/tmp/some file.bin", 1000, 1234);
+    BOOST_REQUIRE( actual );
+    BOOST_CHECK_EQUAL( actual->hash, expected.hash );
+    BOOST_CHECK( actual->chunk_ranges == expected.chunk_ranges );
+    BOOST_CHECK( actual->chunk_hashes == expected.chunk_hashes );
+}
+
+BOOST_AUTO_TEST_CASE(ClearEmptiesFile)
+{
+    TemporaryCacheFile file;
+
+    {
+        auto cache = mf::uploader::HashCache::Create(file.Path(), nullptr);
+        cache->Store(MakeHashes("/tmp/some file.bin", 1000, 1234));
+        cache->Clear();
+        BOOST_CHECK_EQUAL( cache->Size(), 0u );
+    }
+
+    auto cache = mf::uploader::HashCache::Create(file.Path(), nullptr);
+    BOOST_CHECK_EQUAL( cache->Size(), 0u );
+}
@@ -4,11 +4,99 @@
  * @copyright Copyright 2014 Mediafire
  */
 
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "boost/asio/ssl.hpp"
+#ifdef BOOST_ASIO_SEPARATE_COMPILATION
+#  include "boost/asio/impl/src.hpp"  // Define once in program
+#  include "boost/asio/ssl/impl/src.hpp"  // Define once in program
+#endif
+#include "boost/filesystem.hpp"
+#include "boost/optional.hpp"
+
 #define BOOST_TEST_MODULE UtHasher
 #include "boost/test/unit_test.hpp"
 
+#include "mediafire_sdk/uploader/hasher.hpp"
+#include "mediafire_sdk/uploader/detail/hash_thread_pool.hpp"
 #include "mediafire_sdk/uploader/detail/stepping.hpp"
 
+namespace {
+
+/** File removed when the test ends. */
+class TemporaryFile
+{
+public:
+    explicit TemporaryFile(uint64_t size) :
+        path_(boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("ut-hasher-%%%%-%%%%.bin"))
+    {
+        std::ofstream out(path_.string(), std::ios::binary);
+        for (uint64_t i = 0; i < size; ++i)
+            out.put(static_cast<char>((i * 7 + i / 4096) & 0xff));
+    }
+
+    ~TemporaryFile()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+    const boost::filesystem::path & Path() const {return path_;}
+
+private:
+    boost::filesystem::path path_;
+};
+
+boost::optional<mf::uploader::FileHashes> HashFile(
+        const boost::filesystem::path & path,
+        boost::asio::io_service * hash_io_service,
+        uint32_t unit_hash_threads = 0
+    )
+{
+    boost::asio::io_service io_service;
+    boost::optional<mf::uploader::FileHashes> result;
+
+    auto callback = [&io_service, &result](
+            std::error_code ec,
+            boost::optional<mf::uploader::FileHashes> file_hashes
+        )
+    {
+        BOOST_CHECK( ! ec );
+        result = file_hashes;
+        io_service.stop();
+    };
+
+    const std::time_t mtime = boost::filesystem::last_write_time(path);
+    const uint64_t filesize = boost::filesystem::file_size(path);
+
+    mf::uploader::Hasher::Pointer hasher;
+    if (hash_io_service)
+    {
+        hasher = mf::uploader::Hasher::Create(&io_service, hash_io_service,
+            path, filesize, mtime, callback);
+        hasher->SetUnitHashThreads(unit_hash_threads);
+    }
+    else
+    {
+        hasher = mf::uploader::Hasher::Create(&io_service, path, filesize,
+            mtime, callback);
+    }
+
+    // Keep io_service running while the hashing threads work.
+    boost::asio::io_service::work work(io_service);
+
+    hasher->Start();
+    io_service.run();
+
+    return result;
+}
+
+}  // namespace
+
 BOOST_AUTO_TEST_CASE(MinimumSizes)
 {
     using namespace mf::uploader::detail;
@@ -56,3 +144,49 @@ BOOST_AUTO_TEST_CASE(CalculatedStepping)
     BOOST_CHECK_EQUAL( 7, ThresholdStepping(TB(1)) );
     BOOST_CHECK_EQUAL( 7, ThresholdStepping(TB(2)) );
 }
+
+BOOST_AUTO_TEST_CASE(HashThreadsMatchWorkIoService)
+{
+    using namespace mf::uploader::detail;
+
+    // Several units, with the last one partial.
+    TemporaryFile file(MB(9) + 123);
+
+    auto pool = HashThreadPool::Create(2);
+
+    const auto expected = HashFile(file.Path(), nullptr);
+    const auto actual = HashFile(file.Path(), pool->IoService());
+
+    BOOST_REQUIRE( expected );
+    BOOST_REQUIRE( actual );
+
+    BOOST_CHECK_EQUAL( expected->hash, actual->hash );
+    BOOST_CHECK( expected->chunk_hashes == actual->chunk_hashes );
+    BOOST_CHECK( expected->chunk_ranges == actual->chunk_ranges );
+    BOOST_CHECK_GT( actual->chunk_hashes.size(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE(ParallelUnitsMatchSequential)
+{
+    using namespace mf::uploader::detail;
+
+    // Units of 2 MB, with the last one partial.
+    TemporaryFile file(MB(18) + MB(1) / 2);
+
+    auto pool = HashThreadPool::Create(1);
+
+    const auto expected = HashFile(file.Path(), pool->IoService());
+
+    BOOST_REQUIRE( expected );
+    BOOST_CHECK_GT( expected->chunk_hashes.size(), 1u );
+
+    for (uint32_t threads = 1; threads <= 4; ++threads)
+    {
+        const auto actual = HashFile(file.Path(), pool->IoService(), threads);
+
+        BOOST_REQUIRE( actual );
+        BOOST_CHECK_EQUAL( expected->hash, actual->hash );
+        BOOST_CHECK( expected->chunk_hashes == actual->chunk_hashes );
+        BOOST_CHECK( expected->chunk_ranges == actual->chunk_ranges );
+    }
+}
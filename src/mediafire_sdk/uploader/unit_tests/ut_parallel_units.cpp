@@ -0,0 +1,223 @@
+/**
+ * @file ut_parallel_units.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#define BOOST_TEST_MODULE UtParallelUnits
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/uploader/detail/transition_upload.hpp"
+
+namespace ut = mf::uploader::detail::upload_transition;
+namespace event = mf::uploader::detail::event;
+
+namespace {
+
+/**
+ * Stands in for the upload state machine, keeping track of the units of one
+ * resumable upload without sending anything.
+ */
+class UnitsFsm
+{
+public:
+    UnitsFsm(uint32_t units, uint32_t max_concurrent_units) :
+        max_concurrent_units_(max_concurrent_units),
+        most_in_flight_(0),
+        completions_(0)
+    {
+        for (uint32_t i = 0; i < units; ++i)
+            needs_upload_.insert(i);
+    }
+
+    /** Start as many units as permitted. */
+    void UploadUnits()
+    {
+        ut::KeepUnitsInFlight(*this,
+                [this](uint32_t chunk_id)
+                {
+                    needs_upload_.erase(chunk_id);
+                    in_flight_.insert(chunk_id);
+                    sent_.push_back(chunk_id);
+                    most_in_flight_ = std::max(most_in_flight_,
+                        in_flight_.size());
+                    return true;
+                });
+    }
+
+    /** A unit landed, so start the next. */
+    void UnitUploaded(uint32_t chunk_id)
+    {
+        BOOST_REQUIRE( in_flight_.erase(chunk_id) == 1 );
+        upload_key_ = "uploadkey";
+        UploadUnits();
+    }
+
+    /** A unit failed and waits to be sent again. */
+    void UnitFailed(uint32_t chunk_id)
+    {
+        BOOST_REQUIRE( in_flight_.erase(chunk_id) == 1 );
+        retry_pending_.insert(chunk_id);
+        UploadUnits();
+    }
+
+    void UnitRetryDue(uint32_t chunk_id)
+    {
+        BOOST_REQUIRE( retry_pending_.erase(chunk_id) == 1 );
+        needs_upload_.insert(chunk_id);
+        UploadUnits();
+    }
+
+    // Used by KeepUnitsInFlight.
+    std::size_t ChunksInFlight() const {return in_flight_.size();}
+    uint32_t MaxConcurrentUnits() const {return max_concurrent_units_;}
+    std::size_t ChunksWaitingToRetry() const {return retry_pending_.size();}
+    std::string UploadKey() const {return upload_key_;}
+
+    boost::optional<uint32_t> NextChunkToUpload()
+    {
+        if (needs_upload_.empty())
+            return boost::none;
+        return *needs_upload_.begin();
+    }
+
+    void ProcessEvent(const event::ChunkUploadComplete & evt)
+    {
+        BOOST_CHECK_EQUAL( evt.upload_key, upload_key_ );
+        ++completions_;
+    }
+
+    std::set<uint32_t> needs_upload_;
+    std::set<uint32_t> in_flight_;
+    std::set<uint32_t> retry_pending_;
+    std::vector<uint32_t> sent_;
+
+    const uint32_t max_concurrent_units_;
+    std::size_t most_in_flight_;
+    std::string upload_key_;
+    uint32_t completions_;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(FillsUpToLimit)
+{
+    UnitsFsm fsm(10, 4);
+    fsm.UploadUnits();
+
+    BOOST_CHECK_EQUAL( fsm.in_flight_.size(), 4u );
+    BOOST_CHECK_EQUAL( fsm.sent_.size(), 4u );
+    BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+
+    // Nothing more starts until a unit lands.
+    fsm.UploadUnits();
+    BOOST_CHECK_EQUAL( fsm.sent_.size(), 4u );
+}
+
+BOOST_AUTO_TEST_CASE(FewerUnitsThanLimit)
+{
+    UnitsFsm fsm(2, 4);
+    fsm.UploadUnits();
+
+    BOOST_CHECK_EQUAL( fsm.in_flight_.size(), 2u );
+    BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+}
+
+BOOST_AUTO_TEST_CASE(OneAtATimeByDefault)
+{
+    UnitsFsm fsm(3, 1);
+    fsm.UploadUnits();
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK_EQUAL( fsm.in_flight_.size(), 1u );
+        fsm.UnitUploaded(*fsm.in_flight_.begin());
+    }
+
+    BOOST_CHECK_EQUAL( fsm.most_in_flight_, 1u );
+    BOOST_CHECK_EQUAL( fsm.completions_, 1u );
+}
+
+BOOST_AUTO_TEST_CASE(LandsOutOfOrder)
+{
+    UnitsFsm fsm(8, 3);
+    fsm.UploadUnits();
+
+    // Always the last started lands first, and the slot goes to the next.
+    while (fsm.sent_.size() < 8)
+    {
+        const std::size_t sent = fsm.sent_.size();
+        fsm.UnitUploaded(*fsm.in_flight_.rbegin());
+
+        BOOST_CHECK_EQUAL( fsm.sent_.size(), sent + 1 );
+        BOOST_CHECK_EQUAL( fsm.in_flight_.size(), 3u );
+        BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+    }
+
+    // The earliest units are still in flight.
+    BOOST_CHECK( fsm.in_flight_.count(0) == 1 );
+    BOOST_CHECK( fsm.in_flight_.count(1) == 1 );
+
+    // Every unit sent once, none more than the limit at a time.
+    std::vector<uint32_t> sent = fsm.sent_;
+    std::sort(sent.begin(), sent.end());
+    BOOST_CHECK( std::unique(sent.begin(), sent.end()) == sent.end() );
+    BOOST_CHECK_EQUAL( fsm.most_in_flight_, 3u );
+}
+
+BOOST_AUTO_TEST_CASE(CompletesAfterLastUnit)
+{
+    UnitsFsm fsm(5, 3);
+    fsm.UploadUnits();
+
+    fsm.UnitUploaded(2);
+    fsm.UnitUploaded(0);
+    BOOST_CHECK( fsm.needs_upload_.empty() );
+
+    fsm.UnitUploaded(4);
+    fsm.UnitUploaded(3);
+    BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+
+    fsm.UnitUploaded(1);
+    BOOST_CHECK_EQUAL( fsm.completions_, 1u );
+}
+
+BOOST_AUTO_TEST_CASE(WaitsForRetry)
+{
+    UnitsFsm fsm(3, 3);
+    fsm.UploadUnits();
+
+    fsm.UnitFailed(1);
+    fsm.UnitUploaded(0);
+    fsm.UnitUploaded(2);
+
+    // A failed unit still has to be sent again.
+    BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+
+    fsm.UnitRetryDue(1);
+    BOOST_CHECK_EQUAL( fsm.in_flight_.size(), 1u );
+    BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+
+    fsm.UnitUploaded(1);
+    BOOST_CHECK_EQUAL( fsm.completions_, 1u );
+}
+
+BOOST_AUTO_TEST_CASE(StopsWhenSendFails)
+{
+    UnitsFsm fsm(5, 3);
+
+    uint32_t attempts = 0;
+    ut::KeepUnitsInFlight(fsm,
+            [&attempts](uint32_t)
+            {
+                ++attempts;
+                return false;
+            });
+
+    // The failure already ended the upload.
+    BOOST_CHECK_EQUAL( attempts, 1u );
+    BOOST_CHECK_EQUAL( fsm.completions_, 0u );
+}
@@ -0,0 +1,68 @@
+/**
+ * @file ut_unit_retry.cpp
+ * @author Herbert Jones
+ * @copyright Copyright 2014 Mediafire
+ */
+#include <chrono>
+
+#define BOOST_TEST_MODULE UtUnitRetry
+#include "boost/test/unit_test.hpp"
+
+#include "mediafire_sdk/api/error.hpp"
+#include "mediafire_sdk/http/error.hpp"
+#include "mediafire_sdk/uploader/detail/transition_upload.hpp"
+
+namespace ut = mf::uploader::detail::upload_transition;
+using mf::http::http_error;
+
+BOOST_AUTO_TEST_CASE(RetriesConnectionFailures)
+{
+    BOOST_CHECK( ut::IsTransientUnitError(
+            make_error_code(http_error::ReadFailure), 0) );
+    BOOST_CHECK( ut::IsTransientUnitError(
+            make_error_code(http_error::WriteFailure), 0) );
+    BOOST_CHECK( ut::IsTransientUnitError(
+            make_error_code(http_error::UnableToConnect), 0) );
+    BOOST_CHECK( ut::IsTransientUnitError(
+            make_error_code(http_error::IoTimeout), 0) );
+
+    // Server errors without a reason the unit was rejected.
+    BOOST_CHECK( ut::IsTransientUnitError(
+            make_error_code(mf::api::api_code::ContentInvalidFormat), 503) );
+}
+
+BOOST_AUTO_TEST_CASE(FailsOnOtherErrors)
+{
+    // Cancelled by a pause or cancel of the upload.
+    BOOST_CHECK( ! ut::IsTransientUnitError(
+            make_error_code(http_error::Cancelled), 0) );
+    BOOST_CHECK( ! ut::IsTransientUnitError(
+            make_error_code(http_error::InvalidUrl), 0) );
+    BOOST_CHECK( ! ut::IsTransientUnitError(
+            make_error_code(http_error::PostInterfaceReadFailure), 0) );
+
+    // Rejected by the API.
+    BOOST_CHECK( ! ut::IsTransientUnitError(
+            make_error_code(mf::api::api_code::ContentInvalidData), 200) );
+}
+
+BOOST_AUTO_TEST_CASE(BacksOffExponentially)
+{
+    const auto initial = ut::unit_retry_initial_delay;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        const auto first = ut::UnitRetryDelay(1);
+        BOOST_CHECK( first >= initial / 2 );
+        BOOST_CHECK( first <= initial );
+
+        const auto third = ut::UnitRetryDelay(3);
+        BOOST_CHECK( third >= initial * 2 );
+        BOOST_CHECK( third <= initial * 4 );
+
+        // Capped however many times the unit failed.
+        const auto many = ut::UnitRetryDelay(100);
+        BOOST_CHECK( many >= ut::unit_retry_max_delay / 2 );
+        BOOST_CHECK( many <= ut::unit_retry_max_delay );
+    }
+}
@@ -41,5 +41,78 @@ void UploadManager::ModifyUpload(
     impl_->ModifyUpload(upload_handle, modification);
 }
 
+void UploadManager::SetMaxConcurrentUnitsPerUpload(uint32_t max_units)
+{
+    impl_->SetMaxConcurrentUnitsPerUpload(max_units);
+}
+
+void UploadManager::SetMaxConcurrentHashings(uint32_t max_hashings)
+{
+    impl_->SetMaxConcurrentHashings(max_hashings);
+}
+
+uint32_t UploadManager::GetMaxConcurrentHashings() const
+{
+    return impl_->GetMaxConcurrentHashings();
+}
+
+void UploadManager::SetHashingThreads(uint32_t threads)
+{
+    impl_->SetHashingThreads(threads);
+}
+
+uint32_t UploadManager::GetHashingThreads() const
+{
+    return impl_->GetHashingThreads();
+}
+
+void UploadManager::SetUnitHashingThreads(uint32_t threads)
+{
+    impl_->SetUnitHashingThreads(threads);
+}
+
+uint32_t UploadManager::GetUnitHashingThreads() const
+{
+    return impl_->GetUnitHashingThreads();
+}
+
+void UploadManager::SetHashCache(HashCache::Pointer hash_cache)
+{
+    impl_->SetHashCache(hash_cache);
+}
+
+void UploadManager::SetMaxConcurrentUploads(uint32_t max_uploads)
+{
+    impl_->SetMaxConcurrentUploads(max_uploads);
+}
+
+uint32_t UploadManager::GetMaxConcurrentUploads() const
+{
+    return impl_->GetMaxConcurrentUploads();
+}
+
+void UploadManager::EnableAdaptiveUploadConcurrency(
+        uint32_t min_uploads,
+        uint32_t max_uploads
+    )
+{
+    impl_->EnableAdaptiveUploadConcurrency(min_uploads, max_uploads);
+}
+
+void UploadManager::DisableAdaptiveUploadConcurrency()
+{
+    impl_->DisableAdaptiveUploadConcurrency();
+}
+
+void UploadManager::SetUploadBufferSize(uint32_t bytes)
+{
+    impl_->SetUploadBufferSize(bytes);
+}
+
+uint32_t UploadManager::GetUploadBufferSize() const
+{
+    return impl_->GetUploadBufferSize();
+}
+
 }  // namespace uploader
 }  // namespace mf
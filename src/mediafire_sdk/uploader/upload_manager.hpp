@@ -12,6 +12,7 @@
 #include "boost/filesystem/path.hpp"
 
 #include "detail/types.hpp"
+#include "hash_cache.hpp"
 #include "upload_modification.hpp"
 #include "upload_status.hpp"
 #include "upload_request.hpp"
@@ -70,6 +71,148 @@ public:
             UploadModification modification
         );
 
+    /**
+     * @brief Set how many units of a single file are uploaded at the same
+     * time.
+     *
+     * Large files are uploaded in units.  Sending several at once makes better
+     * use of the available bandwidth on high latency connections.  Applies to
+     * uploads added after this call that do not set their own limit with
+     * UploadRequest::SetMaxConcurrentUnits.  The default is 1.
+     *
+     * @param[in] max_units Maximum units in flight per upload, at least 1.
+     */
+    void SetMaxConcurrentUnitsPerUpload(uint32_t max_units);
+
+    /**
+     * @brief Set how many files may be hashed at the same time.
+     *
+     * Takes effect immediately.  The default is 2.
+     *
+     * @param[in] max_hashings Maximum concurrent hashings, at least 1.
+     */
+    void SetMaxConcurrentHashings(uint32_t max_hashings);
+
+    /**
+     * @brief Get how many files may be hashed at the same time.
+     *
+     * @return Maximum concurrent hashings.
+     */
+    uint32_t GetMaxConcurrentHashings() const;
+
+    /**
+     * @brief Set how many threads read and hash files.
+     *
+     * Hashing reads the whole file, so it is kept off the io_service used for
+     * API calls, and only the result is posted back to it.  Setting 0 hashes on
+     * the work io_service of the HttpConfig instead.  A new thread count is
+     * applied once no file is being hashed.  The default is 2.
+     *
+     * @param[in] threads Number of hashing threads.
+     */
+    void SetHashingThreads(uint32_t threads);
+
+    /**
+     * @brief Get how many threads read and hash files.
+     *
+     * @return Number of hashing threads.
+     */
+    uint32_t GetHashingThreads() const;
+
+    /**
+     * @brief Set how many threads hash the units of a single file.
+     *
+     * When set, a file of more than one unit is still read once, and hashed
+     * as a whole by a hashing thread, while its units are hashed by this many
+     * additional threads.  The hashes are the same either way.  Only used with
+     * hashing threads.  Applies to files that start hashing after this call.
+     * The default is 0, where the hashing thread hashes the units itself.
+     *
+     * @param[in] threads Number of unit hashing threads per file.
+     */
+    void SetUnitHashingThreads(uint32_t threads);
+
+    /**
+     * @brief Get how many threads hash the units of a single file.
+     *
+     * @return Number of unit hashing threads per file.
+     */
+    uint32_t GetUnitHashingThreads() const;
+
+    /**
+     * @brief Reuse the hashes of files that have not changed.
+     *
+     * Before a file is hashed, the cache is checked for an entry with the same
+     * path, size and mtime.  If found, the file goes straight to uploading.
+     * Hashes of files that were hashed are stored in the cache.  Applies to
+     * files that reach hashing after this call.
+     *
+     * @param[in] hash_cache Cache to use, or null to always hash.
+     */
+    void SetHashCache(HashCache::Pointer hash_cache);
+
+    /**
+     * @brief Set how many files may be uploaded at the same time.
+     *
+     * Takes effect immediately.  While adaptive concurrency is enabled the
+     * value is kept within the adaptive range.  The default is 2.
+     *
+     * @param[in] max_uploads Maximum concurrent uploads, at least 1.
+     */
+    void SetMaxConcurrentUploads(uint32_t max_uploads);
+
+    /**
+     * @brief Get how many files may be uploaded at the same time.
+     *
+     * With adaptive concurrency enabled this is the current adapted limit.
+     *
+     * @return Maximum concurrent uploads.
+     */
+    uint32_t GetMaxConcurrentUploads() const;
+
+    /**
+     * @brief Adjust the upload limit automatically from measured throughput.
+     *
+     * While uploads are waiting, the limit is raised one step at a time as
+     * long as throughput improves, and lowered again once it gets worse.
+     * Throughput is measured on upload requests only, and is still reported to
+     * the bandwidth analyser set on the HttpConfig.  Applies to uploads added
+     * after this call.
+     *
+     * @param[in] min_uploads Lowest limit to use, at least 1.
+     * @param[in] max_uploads Highest limit to use.
+     */
+    void EnableAdaptiveUploadConcurrency(
+            uint32_t min_uploads,
+            uint32_t max_uploads
+        );
+
+    /**
+     * @brief Stop adjusting the upload limit.
+     *
+     * The current limit is kept.
+     */
+    void DisableAdaptiveUploadConcurrency();
+
+    /**
+     * @brief Set how much file data each write of an upload request sends.
+     *
+     * Buffers of this size are reused between writes and uploads, and the
+     * next one is read from the file while the previous one is being sent.
+     * Larger buffers mean fewer reads and writes per upload.  Applies to
+     * uploads added after this call.  The default is 64 KB.
+     *
+     * @param[in] bytes Buffer size, kept between 4 KB and 1 MB.
+     */
+    void SetUploadBufferSize(uint32_t bytes);
+
+    /**
+     * @brief Get how much file data each write of an upload request sends.
+     *
+     * @return Buffer size in bytes.
+     */
+    uint32_t GetUploadBufferSize() const;
+
 private:
     std::shared_ptr<detail::UploadManagerImpl> impl_;
 };
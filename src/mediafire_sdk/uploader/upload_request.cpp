@@ -75,5 +75,10 @@ void UploadRequest::SetOnDuplicateAction( OnDuplicateAction on_duplicate )
     on_duplicate_action_ = on_duplicate;
 }
 
+void UploadRequest::SetMaxConcurrentUnits( uint32_t max_units )
+{
+    max_concurrent_units_ = max_units;
+}
+
 }  // namespace uploader
 }  // namespace mf
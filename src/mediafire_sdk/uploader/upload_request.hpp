@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "boost/filesystem/path.hpp"
@@ -103,6 +104,17 @@ public:
      */
     void SetOnDuplicateAction( OnDuplicateAction on_duplicate );
 
+    /**
+     * @brief Set how many units of the file are uploaded at the same time.
+     *
+     * Only applies to files large enough to be uploaded in units.  Overrides
+     * the upload manager default set with
+     * UploadManager::SetMaxConcurrentUnitsPerUpload.
+     *
+     * @param[in] max_units Maximum units in flight, at least 1.
+     */
+    void SetMaxConcurrentUnits( uint32_t max_units );
+
 private:
     friend class detail::UploadManagerImpl;
 
@@ -117,6 +129,9 @@ private:
 
     /** What should happen if filename already exists in folder? */
     OnDuplicateAction on_duplicate_action_;
+
+    /** Units to upload at once if different from the manager default. */
+    boost::optional<uint32_t> max_concurrent_units_;
 };
 
 }  // namespace uploader
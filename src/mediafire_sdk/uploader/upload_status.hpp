@@ -53,6 +53,9 @@ struct UploadStatus
     detail::UploadHandle upload_handle;
     boost::filesystem::path path;
     UploadState state;
+
+    /** Units of a resumable upload sent again after failing. */
+    uint32_t unit_retries;
 };
 
 }  // namespace uploader
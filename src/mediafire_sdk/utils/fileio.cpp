@@ -347,9 +347,26 @@ uint64_t FileIO::Tell()
     return position;
 }
 
-void FileIO::Flush()
+void FileIO::Flush(std::error_code * error)
 {
-    fflush(file_handle_);
+    if (error)
+        error->clear();
+
+    // The stream drops what it could not write, so a later fflush succeeds
+    // even though the data never reached the file.
+    const bool failed = fflush(file_handle_) != 0 || ferror(file_handle_);
+
+    if ( failed && error != nullptr )
+        *error = make_error_code(file_io_error::StreamError);
+}
+
+int FileIO::FileDescriptor()
+{
+#if defined(_WIN32)
+    return _fileno(file_handle_);
+#else
+    return fileno(file_handle_);
+#endif
 }
 
 }  // namespace utils
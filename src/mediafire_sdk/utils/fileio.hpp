@@ -195,8 +195,17 @@ public:
 
     /**
      * Flushes data to the disk.
+     *
+     * @param[out] error (Optional) Any error that occurred while writing the
+     *                   buffered data.  Once a write has failed, data written
+     *                   before it may be lost, so every later flush fails too.
+     */
+    void Flush(std::error_code * error = nullptr);
+
+    /**
+     * Returns the descriptor of the open file, for system calls that take one.
      */
-    void Flush();
+    int FileDescriptor();
 
 private:
     FileIO(